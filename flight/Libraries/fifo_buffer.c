@@ -257,6 +257,37 @@ uint16_t fifoBuf_putData(t_fifo_buffer *buf, const void *data, uint16_t len)
     return i;                   // return number of bytes copied
 }
 
+uint16_t fifoBuf_getWritePtr(t_fifo_buffer *buf, uint8_t **data)
+{       // return the contiguous free space at the write position, data can be
+        // written there directly and then added with fifoBuf_commitData()
+
+    uint16_t rd = buf->rd;
+    uint16_t wr = buf->wr;
+    uint16_t buf_size = buf->buf_size;
+
+    uint16_t num_bytes;
+    if (rd > wr)
+        num_bytes = rd - wr - 1;
+    else if (rd == 0)
+        num_bytes = buf_size - wr - 1;
+    else
+        num_bytes = buf_size - wr;
+
+    *data = buf->buf_ptr + wr;
+
+    return num_bytes;
+}
+
+void fifoBuf_commitData(t_fifo_buffer *buf, uint16_t len)
+{       // add data written in place at the pointer from fifoBuf_getWritePtr()
+
+    uint16_t wr = buf->wr + len;
+    if (wr >= buf->buf_size)
+        wr -= buf->buf_size;
+
+    buf->wr = wr;
+}
+
 void fifoBuf_init(t_fifo_buffer *buf, const void *buffer, const uint16_t buffer_size)
 {
     buf->buf_ptr = (uint8_t *)buffer;
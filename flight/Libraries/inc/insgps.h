@@ -91,7 +91,7 @@ void MagVelBaroCorrection(const float mag_data[3], const float Vel[3], float Bar
 void FullCorrection(const float mag_data[3], const float Pos[3], const float Vel[3],
 		    float BaroAlt);
 void GpsBaroCorrection(const float Pos[3], const float Vel[3], float BaroAlt);
-void GpsMagCorrection(const float mag_data[3], const float Pos[3], const float Vel[2]);
+void GpsMagCorrection(const float mag_data[3], const float Pos[3], const float Vel[3]);
 void VelBaroCorrection(const float Vel[3], float BaroAlt);
 
 uint16_t ins_get_num_states();
@@ -37,32 +37,56 @@
 #define NUMW 9			// number of plant noise inputs, w is disturbance noise vector
 #define NUMV 10			// number of measurements, v is the measurement noise vector
 #define NUMU 6			// number of deterministic inputs, U is the input vector
+#define NUMP (NUMX * (NUMX + 1) / 2)	// number of stored elements of the symmetric P
+
+// P is stored packed, only the upper triangle row by row.  PIDX needs i <= j,
+// PSYM works for either order.
+#define PIDX(i, j) ((i) * NUMX - ((i) * ((i) - 1)) / 2 + (j) - (i))
+#define PSYM(i, j) ((i) <= (j) ? PIDX(i, j) : PIDX(j, i))
+
+// Of F and G only the blocks LinearizeFG computes from the state are stored.
+// Apart from them F only has the Pdot = V ones and G the ones of the gyro bias
+// random walk, constants CovariancePrediction folds in.  These give the stored
+// elements by their row and column in the full matrices.
+#define FV(i, j) Fv[(i) - 3][(j) - 6]	// dVdot/dq, F[3..5][6..9]
+#define FQ(i, j) Fq[(i) - 6][(j) - 6]	// dqdot/dq and dqdot/dwbias, F[6..9][6..12]
+#define GV(i, j) Gv[(i) - 3][(j) - 3]	// dVdot/dna, G[3..5][3..5]
+#define GQ(i, j) Gq[(i) - 6][(j)]	// dqdot/dnw, G[6..9][0..2]
 
 #if defined(GENERAL_COV)
-// This might trick people so I have a note here.  There is a slower but bigger version of the 
-// code here but won't fit when debugging disabled (requires -Os)
+// The dense prediction that expands F and G to the full matrices, kept as the
+// reference the packed one is tested against.  It needs over 1 KB of stack,
+// more than the flight tasks have, so no target builds it.
 #define COVARIANCE_PREDICTION_GENERAL
 #endif
 
+#if defined(GENERAL_UPDATE)
+// The dense measurement update that ignores the structure of H, kept as the
+// reference the sparse one is tested against
+#define SERIAL_UPDATE_GENERAL
+#endif
+
 // Private functions
-static void CovariancePrediction(float F[NUMX][NUMX], float G[NUMX][NUMW],
-			  float Q[NUMW], float dT, float P[NUMX][NUMX]);
-static void SerialUpdate(float H[NUMV][NUMX], float R[NUMV], float Z[NUMV],
-		  float Y[NUMV], float P[NUMX][NUMX], float X[NUMX],
+static void CovariancePrediction(float Fv[3][4], float Fq[4][7],
+			  float Gv[3][3], float Gq[4][3],
+			  float Q[NUMW], float dT, float P[NUMP]);
+static void SerialUpdate(float H[NUMV][4], float R[NUMV], float Z[NUMV],
+		  float Y[NUMV], float P[NUMP], float X[NUMX],
 		  uint16_t SensorsUsed);
 static void RungeKutta(float X[NUMX], float U[NUMU], float dT);
 static void StateEq(float X[NUMX], float U[NUMU], float Xdot[NUMX]);
-static void LinearizeFG(float X[NUMX], float U[NUMU], float F[NUMX][NUMX],
-		 float G[NUMX][NUMW]);
+static void LinearizeFG(float X[NUMX], float U[NUMU], float Fv[3][4],
+		 float Fq[4][7], float Gv[3][3], float Gq[4][3]);
 static void MeasurementEq(float X[NUMX], float Be[3], float Y[NUMV]);
-static void LinearizeH(float X[NUMX], float Be[3], float H[NUMV][NUMX]);
+static void LinearizeH(float X[NUMX], float Be[3], float H[NUMV][4]);
 
 // Private variables
-static float F[NUMX][NUMX], G[NUMX][NUMW], H[NUMV][NUMX];	// linearized system matrices
+static float Fv[3][4], Fq[4][7];	// linearized system matrices, see FV and FQ
+static float Gv[3][3], Gq[4][3];	// see GV and GQ
+static float H[NUMV][4];		// non-zero elements of each row of H, see HCols
 static float Be[3];	                    // local magnetic unit vector in NED frame
-static float P[NUMX][NUMX], X[NUMX];	// covariance matrix and state vector
+static float P[NUMP], X[NUMX];	// packed covariance matrix and state vector
 static float Q[NUMW], R[NUMV];   // input noise and measurement noise variances
-static float K[NUMX][NUMV];	     // feedback gain matrix
 
 //  *************  Exposed Functions ****************
 //  *************************************************
@@ -78,32 +102,38 @@ void INSGPSInit()		//pretty much just a place holder for now
 	Be[1] = 0.0f;
 	Be[2] = 0.0f;		// local magnetic unit vector
 
-	for (int i = 0; i < NUMX; i++) {
-		for (int j = 0; j < NUMX; j++) {
-			P[i][j] = 0.0f; // zero all terms
-			F[i][j] = 0.0f;
-		}
-		
-		for (int j = 0; j < NUMW; j++)
-			G[i][j] = 0.0f;
-			
-		for (int j = 0; j < NUMV; j++) {
-			H[j][i] = 0.0f;
-			K[i][j] = 0.0f;
-		}
-			
-		X[i] = 0.0f;
+	for (int i = 0; i < NUMP; i++)
+		P[i] = 0.0f; // zero all terms
+
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 4; j++)
+			Fv[i][j] = 0.0f;
+		for (int j = 0; j < 3; j++)
+			Gv[i][j] = 0.0f;
+	}
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 7; j++)
+			Fq[i][j] = 0.0f;
+		for (int j = 0; j < 3; j++)
+			Gq[i][j] = 0.0f;
 	}
+
+	for (int i = 0; i < NUMV; i++)
+		for (int j = 0; j < 4; j++)
+			H[i][j] = 0.0f;
+
+	for (int i = 0; i < NUMX; i++)
+		X[i] = 0.0f;
 	for (int i = 0; i < NUMW; i++)
 		Q[i] = 0.0f;
 	for (int i = 0; i < NUMV; i++) 
 		R[i] = 0.0f;
 
 	
-	P[0][0] = P[1][1] = P[2][2] = 25.0f;            // initial position variance (m^2)
-	P[3][3] = P[4][4] = P[5][5] = 5.0f;             // initial velocity variance (m/s)^2
-	P[6][6] = P[7][7] = P[8][8] = P[9][9] = 1e-5f;  // initial quaternion variance
-	P[10][10] = P[11][11] = P[12][12] = 1e-9f;      // initial gyro bias variance (rad/s)^2
+	P[PIDX(0, 0)] = P[PIDX(1, 1)] = P[PIDX(2, 2)] = 25.0f;    // initial position variance (m^2)
+	P[PIDX(3, 3)] = P[PIDX(4, 4)] = P[PIDX(5, 5)] = 5.0f;     // initial velocity variance (m/s)^2
+	P[PIDX(6, 6)] = P[PIDX(7, 7)] = P[PIDX(8, 8)] = P[PIDX(9, 9)] = 1e-5f;  // initial quaternion variance
+	P[PIDX(10, 10)] = P[PIDX(11, 11)] = P[PIDX(12, 12)] = 1e-9f;  // initial gyro bias variance (rad/s)^2
 
 	X[0] = X[1] = X[2] = X[3] = X[4] = X[5] = 0.0f;	// initial pos and vel (m)
 	X[6] = 1.0f;
@@ -164,7 +194,7 @@ void INSGetState(float *pos, float *vel, float *attitude, float *gyro_bias)
 void INSGetVariance(float *var_out)
 {
 	for (uint32_t i = 0; i < NUMX; i++)
-		var_out[i] = P[i][i];
+		var_out[i] = P[PIDX(i, i)];
 }
 
 void INSResetP(const float PDiag[NUMX])
@@ -175,8 +205,8 @@ void INSResetP(const float PDiag[NUMX])
 	for (i=0;i<NUMX;i++){
 		if (PDiag != 0){
 			for (j=0;j<NUMX;j++)
-				P[i][j]=P[j][i]=0.0f;
-			P[i][i]=PDiag[i];
+				P[PSYM(i,j)]=0.0f;
+			P[PIDX(i,i)]=PDiag[i];
 		}
 	}
 }
@@ -203,13 +233,12 @@ void INSPosVelReset(const float pos[3], const float vel[3])
 {
 	for (int i = 0; i < 6; i++) {
 		for(int j = i; j < NUMX; j++) {
-			P[i][j] = 0;  // zero the first 6 rows and columns
-			P[j][i] = 0; 
+			P[PIDX(i, j)] = 0;  // zero the first 6 rows and columns
 		}
 	}
 	
-	P[0][0] = P[1][1] = P[2][2] = 25;	// initial position variance (m^2)
-	P[3][3] = P[4][4] = P[5][5] = 5;	// initial velocity variance (m/s)^2
+	P[PIDX(0, 0)] = P[PIDX(1, 1)] = P[PIDX(2, 2)] = 25;	// initial position variance (m^2)
+	P[PIDX(3, 3)] = P[PIDX(4, 4)] = P[PIDX(5, 5)] = 5;	// initial velocity variance (m/s)^2
 	
 	X[0] = pos[0];
 	X[1] = pos[1];
@@ -286,7 +315,7 @@ void INSStatePrediction(const float gyro_data[3], const float accel_data[3], flo
 	U[5] = accel_data[2];
 
 	// EKF prediction step
-	LinearizeFG(X, U, F, G);
+	LinearizeFG(X, U, Fv, Fq, Gv, Gq);
 	RungeKutta(X, U, dT);
 	qmag = sqrtf(X[6] * X[6] + X[7] * X[7] + X[8] * X[8] + X[9] * X[9]);
 	X[6] /= qmag;
@@ -298,7 +327,7 @@ void INSStatePrediction(const float gyro_data[3], const float accel_data[3], flo
 
 void INSCovariancePrediction(float dT)
 {
-	CovariancePrediction(F, G, Q, dT, P);
+	CovariancePrediction(Fv, Fq, Gv, Gq, Q, dT, P);
 }
 
 float zeros[3] = { 0, 0, 0 };
@@ -386,972 +415,997 @@ void INSCorrection(const float mag_data[3], const float Pos[3], const float Vel[
 //    dimensions equal to the number of disturbance noise variables
 //  The General Method is very inefficient,not taking advantage of the sparse F and G
 //  The first Method is very specific to this implementation
+//  Both work on the packed P, see PIDX
 //  ************************************************
 
 #ifdef COVARIANCE_PREDICTION_GENERAL
 
-static void CovariancePrediction(float F[NUMX][NUMX], float G[NUMX][NUMW],
-			  float Q[NUMW], float dT, float P[NUMX][NUMX])
+static void CovariancePrediction(float Fv[3][4], float Fq[4][7],
+			  float Gv[3][3], float Gq[4][3],
+			  float Q[NUMW], float dT, float P[NUMP])
 {
+	float F[NUMX][NUMX], G[NUMX][NUMW];
 	float Dummy[NUMX][NUMX], dTsq;
 	uint8_t i, j, k;
 
+	// Expand F and G to the full matrices
+	for (i = 0; i < NUMX; i++) {
+		for (j = 0; j < NUMX; j++)
+			F[i][j] = 0.0f;
+		for (j = 0; j < NUMW; j++)
+			G[i][j] = 0.0f;
+	}
+	F[0][3] = F[1][4] = F[2][5] = 1.0f;
+	G[10][6] = G[11][7] = G[12][8] = 1.0f;
+	for (i = 3; i < 6; i++) {
+		for (j = 6; j < 10; j++)
+			F[i][j] = FV(i, j);
+		for (j = 3; j < 6; j++)
+			G[i][j] = GV(i, j);
+	}
+	for (i = 6; i < 10; i++) {
+		for (j = 6; j < NUMX; j++)
+			F[i][j] = FQ(i, j);
+		for (j = 0; j < 3; j++)
+			G[i][j] = GQ(i, j);
+	}
+
 	//  Pnew = (I+F*T)*P*(I+F*T)' + T^2*G*Q*G' = T^2[(P/T + F*P)*(I/T + F') + G*Q*G')]
 
 	dTsq = dT * dT;
 
 	for (i = 0; i < NUMX; i++)	// Calculate Dummy = (P/T +F*P)
 		for (j = 0; j < NUMX; j++) {
-			Dummy[i][j] = P[i][j] / dT;
+			Dummy[i][j] = P[PSYM(i, j)] / dT;
 			for (k = 0; k < NUMX; k++)
-				Dummy[i][j] += F[i][k] * P[k][j];
+				Dummy[i][j] += F[i][k] * P[PSYM(k, j)];
 		}
 	for (i = 0; i < NUMX; i++)	// Calculate Pnew = Dummy/T + Dummy*F' + G*Qw*G'
 		for (j = i; j < NUMX; j++) {	// Use symmetry, ie only find upper triangular
-			P[i][j] = Dummy[i][j] / dT;
+			float Pij = Dummy[i][j] / dT;
 			for (k = 0; k < NUMX; k++)
-				P[i][j] += Dummy[i][k] * F[j][k];	// P = Dummy/T + Dummy*F'
+				Pij += Dummy[i][k] * F[j][k];	// P = Dummy/T + Dummy*F'
 			for (k = 0; k < NUMW; k++)
-				P[i][j] += Q[k] * G[i][k] * G[j][k];	// P = Dummy/T + Dummy*F' + G*Q*G'
-			P[j][i] = P[i][j] = P[i][j] * dTsq;	// Pnew = T^2*P and fill in lower triangular;
+				Pij += Q[k] * G[i][k] * G[j][k];	// P = Dummy/T + Dummy*F' + G*Q*G'
+			P[PIDX(i, j)] = Pij * dTsq;	// Pnew = T^2*P
 		}
 }
 
 #else
 
-static void CovariancePrediction(float F[NUMX][NUMX], float G[NUMX][NUMW],
-			  float Q[NUMW], float dT, float P[NUMX][NUMX])
+static void CovariancePrediction(float Fv[3][4], float Fq[4][7],
+			  float Gv[3][3], float Gq[4][3],
+			  float Q[NUMW], float dT, float P[NUMP])
 {
-	float D[NUMX][NUMX], T, Tsq;
-	uint8_t i, j;
+	float D[NUMP], T, Tsq;
+	uint8_t i;
 
 	//  Pnew = (I+F*T)*P*(I+F*T)' + T^2*G*Q*G' = scalar expansion from symbolic manipulator
 
 	T = dT;
 	Tsq = dT * dT;
 
-	for (i = 0; i < NUMX; i++)	// Create a copy of the upper triangular of P
-		for (j = i; j < NUMX; j++)
-			D[i][j] = P[i][j];
+	for (i = 0; i < NUMP; i++)	// Create a copy of P
+		D[i] = P[i];
 
 	// Brute force calculation of the elements of P
-	P[0][0] = D[3][3] * Tsq + (2 * D[0][3]) * T + D[0][0];
-	P[0][1] = P[1][0] =
-	    D[3][4] * Tsq + (D[0][4] + D[1][3]) * T + D[0][1];
-	P[0][2] = P[2][0] =
-	    D[3][5] * Tsq + (D[0][5] + D[2][3]) * T + D[0][2];
-	P[0][3] = P[3][0] =
-	    (F[3][6] * D[3][6] + F[3][7] * D[3][7] + F[3][8] * D[3][8] +
-	     F[3][9] * D[3][9]) * Tsq + (D[3][3] + F[3][6] * D[0][6] +
-					 F[3][7] * D[0][7] +
-					 F[3][8] * D[0][8] +
-					 F[3][9] * D[0][9]) * T + D[0][3];
-	P[0][4] = P[4][0] =
-	    (F[4][6] * D[3][6] + F[4][7] * D[3][7] + F[4][8] * D[3][8] +
-	     F[4][9] * D[3][9]) * Tsq + (D[3][4] + F[4][6] * D[0][6] +
-					 F[4][7] * D[0][7] +
-					 F[4][8] * D[0][8] +
-					 F[4][9] * D[0][9]) * T + D[0][4];
-	P[0][5] = P[5][0] =
-	    (F[5][6] * D[3][6] + F[5][7] * D[3][7] + F[5][8] * D[3][8] +
-	     F[5][9] * D[3][9]) * Tsq + (D[3][5] + F[5][6] * D[0][6] +
-					 F[5][7] * D[0][7] +
-					 F[5][8] * D[0][8] +
-					 F[5][9] * D[0][9]) * T + D[0][5];
-	P[0][6] = P[6][0] =
-	    (F[6][7] * D[3][7] + F[6][8] * D[3][8] + F[6][9] * D[3][9] +
-	     F[6][10] * D[3][10] + F[6][11] * D[3][11] +
-	     F[6][12] * D[3][12]) * Tsq + (D[3][6] + F[6][7] * D[0][7] +
-					   F[6][8] * D[0][8] +
-					   F[6][9] * D[0][9] +
-					   F[6][10] * D[0][10] +
-					   F[6][11] * D[0][11] +
-					   F[6][12] * D[0][12]) * T +
-	    D[0][6];
-	P[0][7] = P[7][0] =
-	    (F[7][6] * D[3][6] + F[7][8] * D[3][8] + F[7][9] * D[3][9] +
-	     F[7][10] * D[3][10] + F[7][11] * D[3][11] +
-	     F[7][12] * D[3][12]) * Tsq + (D[3][7] + F[7][6] * D[0][6] +
-					   F[7][8] * D[0][8] +
-					   F[7][9] * D[0][9] +
-					   F[7][10] * D[0][10] +
-					   F[7][11] * D[0][11] +
-					   F[7][12] * D[0][12]) * T +
-	    D[0][7];
-	P[0][8] = P[8][0] =
-	    (F[8][6] * D[3][6] + F[8][7] * D[3][7] + F[8][9] * D[3][9] +
-	     F[8][10] * D[3][10] + F[8][11] * D[3][11] +
-	     F[8][12] * D[3][12]) * Tsq + (D[3][8] + F[8][6] * D[0][6] +
-					   F[8][7] * D[0][7] +
-					   F[8][9] * D[0][9] +
-					   F[8][10] * D[0][10] +
-					   F[8][11] * D[0][11] +
-					   F[8][12] * D[0][12]) * T +
-	    D[0][8];
-	P[0][9] = P[9][0] =
-	    (F[9][6] * D[3][6] + F[9][7] * D[3][7] + F[9][8] * D[3][8] +
-	     F[9][10] * D[3][10] + F[9][11] * D[3][11] +
-	     F[9][12] * D[3][12]) * Tsq + (D[3][9] + F[9][6] * D[0][6] +
-					   F[9][7] * D[0][7] +
-					   F[9][8] * D[0][8] +
-					   F[9][10] * D[0][10] +
-					   F[9][11] * D[0][11] +
-					   F[9][12] * D[0][12]) * T +
-	    D[0][9];
-	P[0][10] = P[10][0] = D[3][10] * T + D[0][10];
-	P[0][11] = P[11][0] = D[3][11] * T + D[0][11];
-	P[0][12] = P[12][0] = D[3][12] * T + D[0][12];
-	P[1][1] = D[4][4] * Tsq + (2 * D[1][4]) * T + D[1][1];
-	P[1][2] = P[2][1] =
-	    D[4][5] * Tsq + (D[1][5] + D[2][4]) * T + D[1][2];
-	P[1][3] = P[3][1] =
-	    (F[3][6] * D[4][6] + F[3][7] * D[4][7] + F[3][8] * D[4][8] +
-	     F[3][9] * D[4][9]) * Tsq + (D[3][4] + F[3][6] * D[1][6] +
-					 F[3][7] * D[1][7] +
-					 F[3][8] * D[1][8] +
-					 F[3][9] * D[1][9]) * T + D[1][3];
-	P[1][4] = P[4][1] =
-	    (F[4][6] * D[4][6] + F[4][7] * D[4][7] + F[4][8] * D[4][8] +
-	     F[4][9] * D[4][9]) * Tsq + (D[4][4] + F[4][6] * D[1][6] +
-					 F[4][7] * D[1][7] +
-					 F[4][8] * D[1][8] +
-					 F[4][9] * D[1][9]) * T + D[1][4];
-	P[1][5] = P[5][1] =
-	    (F[5][6] * D[4][6] + F[5][7] * D[4][7] + F[5][8] * D[4][8] +
-	     F[5][9] * D[4][9]) * Tsq + (D[4][5] + F[5][6] * D[1][6] +
-					 F[5][7] * D[1][7] +
-					 F[5][8] * D[1][8] +
-					 F[5][9] * D[1][9]) * T + D[1][5];
-	P[1][6] = P[6][1] =
-	    (F[6][7] * D[4][7] + F[6][8] * D[4][8] + F[6][9] * D[4][9] +
-	     F[6][10] * D[4][10] + F[6][11] * D[4][11] +
-	     F[6][12] * D[4][12]) * Tsq + (D[4][6] + F[6][7] * D[1][7] +
-					   F[6][8] * D[1][8] +
-					   F[6][9] * D[1][9] +
-					   F[6][10] * D[1][10] +
-					   F[6][11] * D[1][11] +
-					   F[6][12] * D[1][12]) * T +
-	    D[1][6];
-	P[1][7] = P[7][1] =
-	    (F[7][6] * D[4][6] + F[7][8] * D[4][8] + F[7][9] * D[4][9] +
-	     F[7][10] * D[4][10] + F[7][11] * D[4][11] +
-	     F[7][12] * D[4][12]) * Tsq + (D[4][7] + F[7][6] * D[1][6] +
-					   F[7][8] * D[1][8] +
-					   F[7][9] * D[1][9] +
-					   F[7][10] * D[1][10] +
-					   F[7][11] * D[1][11] +
-					   F[7][12] * D[1][12]) * T +
-	    D[1][7];
-	P[1][8] = P[8][1] =
-	    (F[8][6] * D[4][6] + F[8][7] * D[4][7] + F[8][9] * D[4][9] +
-	     F[8][10] * D[4][10] + F[8][11] * D[4][11] +
-	     F[8][12] * D[4][12]) * Tsq + (D[4][8] + F[8][6] * D[1][6] +
-					   F[8][7] * D[1][7] +
-					   F[8][9] * D[1][9] +
-					   F[8][10] * D[1][10] +
-					   F[8][11] * D[1][11] +
-					   F[8][12] * D[1][12]) * T +
-	    D[1][8];
-	P[1][9] = P[9][1] =
-	    (F[9][6] * D[4][6] + F[9][7] * D[4][7] + F[9][8] * D[4][8] +
-	     F[9][10] * D[4][10] + F[9][11] * D[4][11] +
-	     F[9][12] * D[4][12]) * Tsq + (D[4][9] + F[9][6] * D[1][6] +
-					   F[9][7] * D[1][7] +
-					   F[9][8] * D[1][8] +
-					   F[9][10] * D[1][10] +
-					   F[9][11] * D[1][11] +
-					   F[9][12] * D[1][12]) * T +
-	    D[1][9];
-	P[1][10] = P[10][1] = D[4][10] * T + D[1][10];
-	P[1][11] = P[11][1] = D[4][11] * T + D[1][11];
-	P[1][12] = P[12][1] = D[4][12] * T + D[1][12];
-	P[2][2] = D[5][5] * Tsq + (2 * D[2][5]) * T + D[2][2];
-	P[2][3] = P[3][2] =
-	    (F[3][6] * D[5][6] + F[3][7] * D[5][7] + F[3][8] * D[5][8] +
-	     F[3][9] * D[5][9]) * Tsq + (D[3][5] + F[3][6] * D[2][6] +
-					 F[3][7] * D[2][7] +
-					 F[3][8] * D[2][8] +
-					 F[3][9] * D[2][9]) * T + D[2][3];
-	P[2][4] = P[4][2] =
-	    (F[4][6] * D[5][6] + F[4][7] * D[5][7] + F[4][8] * D[5][8] +
-	     F[4][9] * D[5][9]) * Tsq + (D[4][5] + F[4][6] * D[2][6] +
-					 F[4][7] * D[2][7] +
-					 F[4][8] * D[2][8] +
-					 F[4][9] * D[2][9]) * T + D[2][4];
-	P[2][5] = P[5][2] =
-	    (F[5][6] * D[5][6] + F[5][7] * D[5][7] + F[5][8] * D[5][8] +
-	     F[5][9] * D[5][9]) * Tsq + (D[5][5] + F[5][6] * D[2][6] +
-					 F[5][7] * D[2][7] +
-					 F[5][8] * D[2][8] +
-					 F[5][9] * D[2][9]) * T + D[2][5];
-	P[2][6] = P[6][2] =
-	    (F[6][7] * D[5][7] + F[6][8] * D[5][8] + F[6][9] * D[5][9] +
-	     F[6][10] * D[5][10] + F[6][11] * D[5][11] +
-	     F[6][12] * D[5][12]) * Tsq + (D[5][6] + F[6][7] * D[2][7] +
-					   F[6][8] * D[2][8] +
-					   F[6][9] * D[2][9] +
-					   F[6][10] * D[2][10] +
-					   F[6][11] * D[2][11] +
-					   F[6][12] * D[2][12]) * T +
-	    D[2][6];
-	P[2][7] = P[7][2] =
-	    (F[7][6] * D[5][6] + F[7][8] * D[5][8] + F[7][9] * D[5][9] +
-	     F[7][10] * D[5][10] + F[7][11] * D[5][11] +
-	     F[7][12] * D[5][12]) * Tsq + (D[5][7] + F[7][6] * D[2][6] +
-					   F[7][8] * D[2][8] +
-					   F[7][9] * D[2][9] +
-					   F[7][10] * D[2][10] +
-					   F[7][11] * D[2][11] +
-					   F[7][12] * D[2][12]) * T +
-	    D[2][7];
-	P[2][8] = P[8][2] =
-	    (F[8][6] * D[5][6] + F[8][7] * D[5][7] + F[8][9] * D[5][9] +
-	     F[8][10] * D[5][10] + F[8][11] * D[5][11] +
-	     F[8][12] * D[5][12]) * Tsq + (D[5][8] + F[8][6] * D[2][6] +
-					   F[8][7] * D[2][7] +
-					   F[8][9] * D[2][9] +
-					   F[8][10] * D[2][10] +
-					   F[8][11] * D[2][11] +
-					   F[8][12] * D[2][12]) * T +
-	    D[2][8];
-	P[2][9] = P[9][2] =
-	    (F[9][6] * D[5][6] + F[9][7] * D[5][7] + F[9][8] * D[5][8] +
-	     F[9][10] * D[5][10] + F[9][11] * D[5][11] +
-	     F[9][12] * D[5][12]) * Tsq + (D[5][9] + F[9][6] * D[2][6] +
-					   F[9][7] * D[2][7] +
-					   F[9][8] * D[2][8] +
-					   F[9][10] * D[2][10] +
-					   F[9][11] * D[2][11] +
-					   F[9][12] * D[2][12]) * T +
-	    D[2][9];
-	P[2][10] = P[10][2] = D[5][10] * T + D[2][10];
-	P[2][11] = P[11][2] = D[5][11] * T + D[2][11];
-	P[2][12] = P[12][2] = D[5][12] * T + D[2][12];
-	P[3][3] =
-	    (Q[3] * G[3][3] * G[3][3] + Q[4] * G[3][4] * G[3][4] +
-	     Q[5] * G[3][5] * G[3][5] + F[3][9] * (F[3][9] * D[9][9] +
-						   F[3][6] * D[6][9] +
-						   F[3][7] * D[7][9] +
-						   F[3][8] * D[8][9]) +
-	     F[3][6] * (F[3][6] * D[6][6] + F[3][7] * D[6][7] +
-			F[3][8] * D[6][8] + F[3][9] * D[6][9]) +
-	     F[3][7] * (F[3][6] * D[6][7] + F[3][7] * D[7][7] +
-			F[3][8] * D[7][8] + F[3][9] * D[7][9]) +
-	     F[3][8] * (F[3][6] * D[6][8] + F[3][7] * D[7][8] +
-			F[3][8] * D[8][8] + F[3][9] * D[8][9])) * Tsq +
-	    (2 * F[3][6] * D[3][6] + 2 * F[3][7] * D[3][7] +
-	     2 * F[3][8] * D[3][8] + 2 * F[3][9] * D[3][9]) * T + D[3][3];
-	P[3][4] = P[4][3] =
-	    (F[4][9] *
-	     (F[3][9] * D[9][9] + F[3][6] * D[6][9] + F[3][7] * D[7][9] +
-	      F[3][8] * D[8][9]) + F[4][6] * (F[3][6] * D[6][6] +
-					      F[3][7] * D[6][7] +
-					      F[3][8] * D[6][8] +
-					      F[3][9] * D[6][9]) +
-	     F[4][7] * (F[3][6] * D[6][7] + F[3][7] * D[7][7] +
-			F[3][8] * D[7][8] + F[3][9] * D[7][9]) +
-	     F[4][8] * (F[3][6] * D[6][8] + F[3][7] * D[7][8] +
-			F[3][8] * D[8][8] + F[3][9] * D[8][9]) +
-	     G[3][3] * G[4][3] * Q[3] + G[3][4] * G[4][4] * Q[4] +
-	     G[3][5] * G[4][5] * Q[5]) * Tsq + (F[3][6] * D[4][6] +
-						F[4][6] * D[3][6] +
-						F[3][7] * D[4][7] +
-						F[4][7] * D[3][7] +
-						F[3][8] * D[4][8] +
-						F[4][8] * D[3][8] +
-						F[3][9] * D[4][9] +
-						F[4][9] * D[3][9]) * T +
-	    D[3][4];
-	P[3][5] = P[5][3] =
-	    (F[5][9] *
-	     (F[3][9] * D[9][9] + F[3][6] * D[6][9] + F[3][7] * D[7][9] +
-	      F[3][8] * D[8][9]) + F[5][6] * (F[3][6] * D[6][6] +
-					      F[3][7] * D[6][7] +
-					      F[3][8] * D[6][8] +
-					      F[3][9] * D[6][9]) +
-	     F[5][7] * (F[3][6] * D[6][7] + F[3][7] * D[7][7] +
-			F[3][8] * D[7][8] + F[3][9] * D[7][9]) +
-	     F[5][8] * (F[3][6] * D[6][8] + F[3][7] * D[7][8] +
-			F[3][8] * D[8][8] + F[3][9] * D[8][9]) +
-	     G[3][3] * G[5][3] * Q[3] + G[3][4] * G[5][4] * Q[4] +
-	     G[3][5] * G[5][5] * Q[5]) * Tsq + (F[3][6] * D[5][6] +
-						F[5][6] * D[3][6] +
-						F[3][7] * D[5][7] +
-						F[5][7] * D[3][7] +
-						F[3][8] * D[5][8] +
-						F[5][8] * D[3][8] +
-						F[3][9] * D[5][9] +
-						F[5][9] * D[3][9]) * T +
-	    D[3][5];
-	P[3][6] = P[6][3] =
-	    (F[6][9] *
-	     (F[3][9] * D[9][9] + F[3][6] * D[6][9] + F[3][7] * D[7][9] +
-	      F[3][8] * D[8][9]) + F[6][10] * (F[3][9] * D[9][10] +
-					       F[3][6] * D[6][10] +
-					       F[3][7] * D[7][10] +
-					       F[3][8] * D[8][10]) +
-	     F[6][11] * (F[3][9] * D[9][11] + F[3][6] * D[6][11] +
-			 F[3][7] * D[7][11] + F[3][8] * D[8][11]) +
-	     F[6][12] * (F[3][9] * D[9][12] + F[3][6] * D[6][12] +
-			 F[3][7] * D[7][12] + F[3][8] * D[8][12]) +
-	     F[6][7] * (F[3][6] * D[6][7] + F[3][7] * D[7][7] +
-			F[3][8] * D[7][8] + F[3][9] * D[7][9]) +
-	     F[6][8] * (F[3][6] * D[6][8] + F[3][7] * D[7][8] +
-			F[3][8] * D[8][8] + F[3][9] * D[8][9])) * Tsq +
-	    (F[3][6] * D[6][6] + F[3][7] * D[6][7] + F[6][7] * D[3][7] +
-	     F[3][8] * D[6][8] + F[6][8] * D[3][8] + F[3][9] * D[6][9] +
-	     F[6][9] * D[3][9] + F[6][10] * D[3][10] +
-	     F[6][11] * D[3][11] + F[6][12] * D[3][12]) * T + D[3][6];
-	P[3][7] = P[7][3] =
-	    (F[7][9] *
-	     (F[3][9] * D[9][9] + F[3][6] * D[6][9] + F[3][7] * D[7][9] +
-	      F[3][8] * D[8][9]) + F[7][10] * (F[3][9] * D[9][10] +
-					       F[3][6] * D[6][10] +
-					       F[3][7] * D[7][10] +
-					       F[3][8] * D[8][10]) +
-	     F[7][11] * (F[3][9] * D[9][11] + F[3][6] * D[6][11] +
-			 F[3][7] * D[7][11] + F[3][8] * D[8][11]) +
-	     F[7][12] * (F[3][9] * D[9][12] + F[3][6] * D[6][12] +
-			 F[3][7] * D[7][12] + F[3][8] * D[8][12]) +
-	     F[7][6] * (F[3][6] * D[6][6] + F[3][7] * D[6][7] +
-			F[3][8] * D[6][8] + F[3][9] * D[6][9]) +
-	     F[7][8] * (F[3][6] * D[6][8] + F[3][7] * D[7][8] +
-			F[3][8] * D[8][8] + F[3][9] * D[8][9])) * Tsq +
-	    (F[3][6] * D[6][7] + F[7][6] * D[3][6] + F[3][7] * D[7][7] +
-	     F[3][8] * D[7][8] + F[7][8] * D[3][8] + F[3][9] * D[7][9] +
-	     F[7][9] * D[3][9] + F[7][10] * D[3][10] +
-	     F[7][11] * D[3][11] + F[7][12] * D[3][12]) * T + D[3][7];
-	P[3][8] = P[8][3] =
-	    (F[8][9] *
-	     (F[3][9] * D[9][9] + F[3][6] * D[6][9] + F[3][7] * D[7][9] +
-	      F[3][8] * D[8][9]) + F[8][10] * (F[3][9] * D[9][10] +
-					       F[3][6] * D[6][10] +
-					       F[3][7] * D[7][10] +
-					       F[3][8] * D[8][10]) +
-	     F[8][11] * (F[3][9] * D[9][11] + F[3][6] * D[6][11] +
-			 F[3][7] * D[7][11] + F[3][8] * D[8][11]) +
-	     F[8][12] * (F[3][9] * D[9][12] + F[3][6] * D[6][12] +
-			 F[3][7] * D[7][12] + F[3][8] * D[8][12]) +
-	     F[8][6] * (F[3][6] * D[6][6] + F[3][7] * D[6][7] +
-			F[3][8] * D[6][8] + F[3][9] * D[6][9]) +
-	     F[8][7] * (F[3][6] * D[6][7] + F[3][7] * D[7][7] +
-			F[3][8] * D[7][8] + F[3][9] * D[7][9])) * Tsq +
-	    (F[3][6] * D[6][8] + F[3][7] * D[7][8] + F[8][6] * D[3][6] +
-	     F[8][7] * D[3][7] + F[3][8] * D[8][8] + F[3][9] * D[8][9] +
-	     F[8][9] * D[3][9] + F[8][10] * D[3][10] +
-	     F[8][11] * D[3][11] + F[8][12] * D[3][12]) * T + D[3][8];
-	P[3][9] = P[9][3] =
-	    (F[9][10] *
-	     (F[3][9] * D[9][10] + F[3][6] * D[6][10] +
-	      F[3][7] * D[7][10] + F[3][8] * D[8][10]) +
-	     F[9][11] * (F[3][9] * D[9][11] + F[3][6] * D[6][11] +
-			 F[3][7] * D[7][11] + F[3][8] * D[8][11]) +
-	     F[9][12] * (F[3][9] * D[9][12] + F[3][6] * D[6][12] +
-			 F[3][7] * D[7][12] + F[3][8] * D[8][12]) +
-	     F[9][6] * (F[3][6] * D[6][6] + F[3][7] * D[6][7] +
-			F[3][8] * D[6][8] + F[3][9] * D[6][9]) +
-	     F[9][7] * (F[3][6] * D[6][7] + F[3][7] * D[7][7] +
-			F[3][8] * D[7][8] + F[3][9] * D[7][9]) +
-	     F[9][8] * (F[3][6] * D[6][8] + F[3][7] * D[7][8] +
-			F[3][8] * D[8][8] + F[3][9] * D[8][9])) * Tsq +
-	    (F[9][6] * D[3][6] + F[9][7] * D[3][7] + F[9][8] * D[3][8] +
-	     F[3][9] * D[9][9] + F[9][10] * D[3][10] +
-	     F[9][11] * D[3][11] + F[9][12] * D[3][12] +
-	     F[3][6] * D[6][9] + F[3][7] * D[7][9] +
-	     F[3][8] * D[8][9]) * T + D[3][9];
-	P[3][10] = P[10][3] =
-	    (F[3][9] * D[9][10] + F[3][6] * D[6][10] + F[3][7] * D[7][10] +
-	     F[3][8] * D[8][10]) * T + D[3][10];
-	P[3][11] = P[11][3] =
-	    (F[3][9] * D[9][11] + F[3][6] * D[6][11] + F[3][7] * D[7][11] +
-	     F[3][8] * D[8][11]) * T + D[3][11];
-	P[3][12] = P[12][3] =
-	    (F[3][9] * D[9][12] + F[3][6] * D[6][12] + F[3][7] * D[7][12] +
-	     F[3][8] * D[8][12]) * T + D[3][12];
-	P[4][4] =
-	    (Q[3] * G[4][3] * G[4][3] + Q[4] * G[4][4] * G[4][4] +
-	     Q[5] * G[4][5] * G[4][5] + F[4][9] * (F[4][9] * D[9][9] +
-						   F[4][6] * D[6][9] +
-						   F[4][7] * D[7][9] +
-						   F[4][8] * D[8][9]) +
-	     F[4][6] * (F[4][6] * D[6][6] + F[4][7] * D[6][7] +
-			F[4][8] * D[6][8] + F[4][9] * D[6][9]) +
-	     F[4][7] * (F[4][6] * D[6][7] + F[4][7] * D[7][7] +
-			F[4][8] * D[7][8] + F[4][9] * D[7][9]) +
-	     F[4][8] * (F[4][6] * D[6][8] + F[4][7] * D[7][8] +
-			F[4][8] * D[8][8] + F[4][9] * D[8][9])) * Tsq +
-	    (2 * F[4][6] * D[4][6] + 2 * F[4][7] * D[4][7] +
-	     2 * F[4][8] * D[4][8] + 2 * F[4][9] * D[4][9]) * T + D[4][4];
-	P[4][5] = P[5][4] =
-	    (F[5][9] *
-	     (F[4][9] * D[9][9] + F[4][6] * D[6][9] + F[4][7] * D[7][9] +
-	      F[4][8] * D[8][9]) + F[5][6] * (F[4][6] * D[6][6] +
-					      F[4][7] * D[6][7] +
-					      F[4][8] * D[6][8] +
-					      F[4][9] * D[6][9]) +
-	     F[5][7] * (F[4][6] * D[6][7] + F[4][7] * D[7][7] +
-			F[4][8] * D[7][8] + F[4][9] * D[7][9]) +
-	     F[5][8] * (F[4][6] * D[6][8] + F[4][7] * D[7][8] +
-			F[4][8] * D[8][8] + F[4][9] * D[8][9]) +
-	     G[4][3] * G[5][3] * Q[3] + G[4][4] * G[5][4] * Q[4] +
-	     G[4][5] * G[5][5] * Q[5]) * Tsq + (F[4][6] * D[5][6] +
-						F[5][6] * D[4][6] +
-						F[4][7] * D[5][7] +
-						F[5][7] * D[4][7] +
-						F[4][8] * D[5][8] +
-						F[5][8] * D[4][8] +
-						F[4][9] * D[5][9] +
-						F[5][9] * D[4][9]) * T +
-	    D[4][5];
-	P[4][6] = P[6][4] =
-	    (F[6][9] *
-	     (F[4][9] * D[9][9] + F[4][6] * D[6][9] + F[4][7] * D[7][9] +
-	      F[4][8] * D[8][9]) + F[6][10] * (F[4][9] * D[9][10] +
-					       F[4][6] * D[6][10] +
-					       F[4][7] * D[7][10] +
-					       F[4][8] * D[8][10]) +
-	     F[6][11] * (F[4][9] * D[9][11] + F[4][6] * D[6][11] +
-			 F[4][7] * D[7][11] + F[4][8] * D[8][11]) +
-	     F[6][12] * (F[4][9] * D[9][12] + F[4][6] * D[6][12] +
-			 F[4][7] * D[7][12] + F[4][8] * D[8][12]) +
-	     F[6][7] * (F[4][6] * D[6][7] + F[4][7] * D[7][7] +
-			F[4][8] * D[7][8] + F[4][9] * D[7][9]) +
-	     F[6][8] * (F[4][6] * D[6][8] + F[4][7] * D[7][8] +
-			F[4][8] * D[8][8] + F[4][9] * D[8][9])) * Tsq +
-	    (F[4][6] * D[6][6] + F[4][7] * D[6][7] + F[6][7] * D[4][7] +
-	     F[4][8] * D[6][8] + F[6][8] * D[4][8] + F[4][9] * D[6][9] +
-	     F[6][9] * D[4][9] + F[6][10] * D[4][10] +
-	     F[6][11] * D[4][11] + F[6][12] * D[4][12]) * T + D[4][6];
-	P[4][7] = P[7][4] =
-	    (F[7][9] *
-	     (F[4][9] * D[9][9] + F[4][6] * D[6][9] + F[4][7] * D[7][9] +
-	      F[4][8] * D[8][9]) + F[7][10] * (F[4][9] * D[9][10] +
-					       F[4][6] * D[6][10] +
-					       F[4][7] * D[7][10] +
-					       F[4][8] * D[8][10]) +
-	     F[7][11] * (F[4][9] * D[9][11] + F[4][6] * D[6][11] +
-			 F[4][7] * D[7][11] + F[4][8] * D[8][11]) +
-	     F[7][12] * (F[4][9] * D[9][12] + F[4][6] * D[6][12] +
-			 F[4][7] * D[7][12] + F[4][8] * D[8][12]) +
-	     F[7][6] * (F[4][6] * D[6][6] + F[4][7] * D[6][7] +
-			F[4][8] * D[6][8] + F[4][9] * D[6][9]) +
-	     F[7][8] * (F[4][6] * D[6][8] + F[4][7] * D[7][8] +
-			F[4][8] * D[8][8] + F[4][9] * D[8][9])) * Tsq +
-	    (F[4][6] * D[6][7] + F[7][6] * D[4][6] + F[4][7] * D[7][7] +
-	     F[4][8] * D[7][8] + F[7][8] * D[4][8] + F[4][9] * D[7][9] +
-	     F[7][9] * D[4][9] + F[7][10] * D[4][10] +
-	     F[7][11] * D[4][11] + F[7][12] * D[4][12]) * T + D[4][7];
-	P[4][8] = P[8][4] =
-	    (F[8][9] *
-	     (F[4][9] * D[9][9] + F[4][6] * D[6][9] + F[4][7] * D[7][9] +
-	      F[4][8] * D[8][9]) + F[8][10] * (F[4][9] * D[9][10] +
-					       F[4][6] * D[6][10] +
-					       F[4][7] * D[7][10] +
-					       F[4][8] * D[8][10]) +
-	     F[8][11] * (F[4][9] * D[9][11] + F[4][6] * D[6][11] +
-			 F[4][7] * D[7][11] + F[4][8] * D[8][11]) +
-	     F[8][12] * (F[4][9] * D[9][12] + F[4][6] * D[6][12] +
-			 F[4][7] * D[7][12] + F[4][8] * D[8][12]) +
-	     F[8][6] * (F[4][6] * D[6][6] + F[4][7] * D[6][7] +
-			F[4][8] * D[6][8] + F[4][9] * D[6][9]) +
-	     F[8][7] * (F[4][6] * D[6][7] + F[4][7] * D[7][7] +
-			F[4][8] * D[7][8] + F[4][9] * D[7][9])) * Tsq +
-	    (F[4][6] * D[6][8] + F[4][7] * D[7][8] + F[8][6] * D[4][6] +
-	     F[8][7] * D[4][7] + F[4][8] * D[8][8] + F[4][9] * D[8][9] +
-	     F[8][9] * D[4][9] + F[8][10] * D[4][10] +
-	     F[8][11] * D[4][11] + F[8][12] * D[4][12]) * T + D[4][8];
-	P[4][9] = P[9][4] =
-	    (F[9][10] *
-	     (F[4][9] * D[9][10] + F[4][6] * D[6][10] +
-	      F[4][7] * D[7][10] + F[4][8] * D[8][10]) +
-	     F[9][11] * (F[4][9] * D[9][11] + F[4][6] * D[6][11] +
-			 F[4][7] * D[7][11] + F[4][8] * D[8][11]) +
-	     F[9][12] * (F[4][9] * D[9][12] + F[4][6] * D[6][12] +
-			 F[4][7] * D[7][12] + F[4][8] * D[8][12]) +
-	     F[9][6] * (F[4][6] * D[6][6] + F[4][7] * D[6][7] +
-			F[4][8] * D[6][8] + F[4][9] * D[6][9]) +
-	     F[9][7] * (F[4][6] * D[6][7] + F[4][7] * D[7][7] +
-			F[4][8] * D[7][8] + F[4][9] * D[7][9]) +
-	     F[9][8] * (F[4][6] * D[6][8] + F[4][7] * D[7][8] +
-			F[4][8] * D[8][8] + F[4][9] * D[8][9])) * Tsq +
-	    (F[9][6] * D[4][6] + F[9][7] * D[4][7] + F[9][8] * D[4][8] +
-	     F[4][9] * D[9][9] + F[9][10] * D[4][10] +
-	     F[9][11] * D[4][11] + F[9][12] * D[4][12] +
-	     F[4][6] * D[6][9] + F[4][7] * D[7][9] +
-	     F[4][8] * D[8][9]) * T + D[4][9];
-	P[4][10] = P[10][4] =
-	    (F[4][9] * D[9][10] + F[4][6] * D[6][10] + F[4][7] * D[7][10] +
-	     F[4][8] * D[8][10]) * T + D[4][10];
-	P[4][11] = P[11][4] =
-	    (F[4][9] * D[9][11] + F[4][6] * D[6][11] + F[4][7] * D[7][11] +
-	     F[4][8] * D[8][11]) * T + D[4][11];
-	P[4][12] = P[12][4] =
-	    (F[4][9] * D[9][12] + F[4][6] * D[6][12] + F[4][7] * D[7][12] +
-	     F[4][8] * D[8][12]) * T + D[4][12];
-	P[5][5] =
-	    (Q[3] * G[5][3] * G[5][3] + Q[4] * G[5][4] * G[5][4] +
-	     Q[5] * G[5][5] * G[5][5] + F[5][9] * (F[5][9] * D[9][9] +
-						   F[5][6] * D[6][9] +
-						   F[5][7] * D[7][9] +
-						   F[5][8] * D[8][9]) +
-	     F[5][6] * (F[5][6] * D[6][6] + F[5][7] * D[6][7] +
-			F[5][8] * D[6][8] + F[5][9] * D[6][9]) +
-	     F[5][7] * (F[5][6] * D[6][7] + F[5][7] * D[7][7] +
-			F[5][8] * D[7][8] + F[5][9] * D[7][9]) +
-	     F[5][8] * (F[5][6] * D[6][8] + F[5][7] * D[7][8] +
-			F[5][8] * D[8][8] + F[5][9] * D[8][9])) * Tsq +
-	    (2 * F[5][6] * D[5][6] + 2 * F[5][7] * D[5][7] +
-	     2 * F[5][8] * D[5][8] + 2 * F[5][9] * D[5][9]) * T + D[5][5];
-	P[5][6] = P[6][5] =
-	    (F[6][9] *
-	     (F[5][9] * D[9][9] + F[5][6] * D[6][9] + F[5][7] * D[7][9] +
-	      F[5][8] * D[8][9]) + F[6][10] * (F[5][9] * D[9][10] +
-					       F[5][6] * D[6][10] +
-					       F[5][7] * D[7][10] +
-					       F[5][8] * D[8][10]) +
-	     F[6][11] * (F[5][9] * D[9][11] + F[5][6] * D[6][11] +
-			 F[5][7] * D[7][11] + F[5][8] * D[8][11]) +
-	     F[6][12] * (F[5][9] * D[9][12] + F[5][6] * D[6][12] +
-			 F[5][7] * D[7][12] + F[5][8] * D[8][12]) +
-	     F[6][7] * (F[5][6] * D[6][7] + F[5][7] * D[7][7] +
-			F[5][8] * D[7][8] + F[5][9] * D[7][9]) +
-	     F[6][8] * (F[5][6] * D[6][8] + F[5][7] * D[7][8] +
-			F[5][8] * D[8][8] + F[5][9] * D[8][9])) * Tsq +
-	    (F[5][6] * D[6][6] + F[5][7] * D[6][7] + F[6][7] * D[5][7] +
-	     F[5][8] * D[6][8] + F[6][8] * D[5][8] + F[5][9] * D[6][9] +
-	     F[6][9] * D[5][9] + F[6][10] * D[5][10] +
-	     F[6][11] * D[5][11] + F[6][12] * D[5][12]) * T + D[5][6];
-	P[5][7] = P[7][5] =
-	    (F[7][9] *
-	     (F[5][9] * D[9][9] + F[5][6] * D[6][9] + F[5][7] * D[7][9] +
-	      F[5][8] * D[8][9]) + F[7][10] * (F[5][9] * D[9][10] +
-					       F[5][6] * D[6][10] +
-					       F[5][7] * D[7][10] +
-					       F[5][8] * D[8][10]) +
-	     F[7][11] * (F[5][9] * D[9][11] + F[5][6] * D[6][11] +
-			 F[5][7] * D[7][11] + F[5][8] * D[8][11]) +
-	     F[7][12] * (F[5][9] * D[9][12] + F[5][6] * D[6][12] +
-			 F[5][7] * D[7][12] + F[5][8] * D[8][12]) +
-	     F[7][6] * (F[5][6] * D[6][6] + F[5][7] * D[6][7] +
-			F[5][8] * D[6][8] + F[5][9] * D[6][9]) +
-	     F[7][8] * (F[5][6] * D[6][8] + F[5][7] * D[7][8] +
-			F[5][8] * D[8][8] + F[5][9] * D[8][9])) * Tsq +
-	    (F[5][6] * D[6][7] + F[7][6] * D[5][6] + F[5][7] * D[7][7] +
-	     F[5][8] * D[7][8] + F[7][8] * D[5][8] + F[5][9] * D[7][9] +
-	     F[7][9] * D[5][9] + F[7][10] * D[5][10] +
-	     F[7][11] * D[5][11] + F[7][12] * D[5][12]) * T + D[5][7];
-	P[5][8] = P[8][5] =
-	    (F[8][9] *
-	     (F[5][9] * D[9][9] + F[5][6] * D[6][9] + F[5][7] * D[7][9] +
-	      F[5][8] * D[8][9]) + F[8][10] * (F[5][9] * D[9][10] +
-					       F[5][6] * D[6][10] +
-					       F[5][7] * D[7][10] +
-					       F[5][8] * D[8][10]) +
-	     F[8][11] * (F[5][9] * D[9][11] + F[5][6] * D[6][11] +
-			 F[5][7] * D[7][11] + F[5][8] * D[8][11]) +
-	     F[8][12] * (F[5][9] * D[9][12] + F[5][6] * D[6][12] +
-			 F[5][7] * D[7][12] + F[5][8] * D[8][12]) +
-	     F[8][6] * (F[5][6] * D[6][6] + F[5][7] * D[6][7] +
-			F[5][8] * D[6][8] + F[5][9] * D[6][9]) +
-	     F[8][7] * (F[5][6] * D[6][7] + F[5][7] * D[7][7] +
-			F[5][8] * D[7][8] + F[5][9] * D[7][9])) * Tsq +
-	    (F[5][6] * D[6][8] + F[5][7] * D[7][8] + F[8][6] * D[5][6] +
-	     F[8][7] * D[5][7] + F[5][8] * D[8][8] + F[5][9] * D[8][9] +
-	     F[8][9] * D[5][9] + F[8][10] * D[5][10] +
-	     F[8][11] * D[5][11] + F[8][12] * D[5][12]) * T + D[5][8];
-	P[5][9] = P[9][5] =
-	    (F[9][10] *
-	     (F[5][9] * D[9][10] + F[5][6] * D[6][10] +
-	      F[5][7] * D[7][10] + F[5][8] * D[8][10]) +
-	     F[9][11] * (F[5][9] * D[9][11] + F[5][6] * D[6][11] +
-			 F[5][7] * D[7][11] + F[5][8] * D[8][11]) +
-	     F[9][12] * (F[5][9] * D[9][12] + F[5][6] * D[6][12] +
-			 F[5][7] * D[7][12] + F[5][8] * D[8][12]) +
-	     F[9][6] * (F[5][6] * D[6][6] + F[5][7] * D[6][7] +
-			F[5][8] * D[6][8] + F[5][9] * D[6][9]) +
-	     F[9][7] * (F[5][6] * D[6][7] + F[5][7] * D[7][7] +
-			F[5][8] * D[7][8] + F[5][9] * D[7][9]) +
-	     F[9][8] * (F[5][6] * D[6][8] + F[5][7] * D[7][8] +
-			F[5][8] * D[8][8] + F[5][9] * D[8][9])) * Tsq +
-	    (F[9][6] * D[5][6] + F[9][7] * D[5][7] + F[9][8] * D[5][8] +
-	     F[5][9] * D[9][9] + F[9][10] * D[5][10] +
-	     F[9][11] * D[5][11] + F[9][12] * D[5][12] +
-	     F[5][6] * D[6][9] + F[5][7] * D[7][9] +
-	     F[5][8] * D[8][9]) * T + D[5][9];
-	P[5][10] = P[10][5] =
-	    (F[5][9] * D[9][10] + F[5][6] * D[6][10] + F[5][7] * D[7][10] +
-	     F[5][8] * D[8][10]) * T + D[5][10];
-	P[5][11] = P[11][5] =
-	    (F[5][9] * D[9][11] + F[5][6] * D[6][11] + F[5][7] * D[7][11] +
-	     F[5][8] * D[8][11]) * T + D[5][11];
-	P[5][12] = P[12][5] =
-	    (F[5][9] * D[9][12] + F[5][6] * D[6][12] + F[5][7] * D[7][12] +
-	     F[5][8] * D[8][12]) * T + D[5][12];
-	P[6][6] =
-	    (Q[0] * G[6][0] * G[6][0] + Q[1] * G[6][1] * G[6][1] +
-	     Q[2] * G[6][2] * G[6][2] + F[6][9] * (F[6][9] * D[9][9] +
-						   F[6][10] * D[9][10] +
-						   F[6][11] * D[9][11] +
-						   F[6][12] * D[9][12] +
-						   F[6][7] * D[7][9] +
-						   F[6][8] * D[8][9]) +
-	     F[6][10] * (F[6][9] * D[9][10] + F[6][10] * D[10][10] +
-			 F[6][11] * D[10][11] + F[6][12] * D[10][12] +
-			 F[6][7] * D[7][10] + F[6][8] * D[8][10]) +
-	     F[6][11] * (F[6][9] * D[9][11] + F[6][10] * D[10][11] +
-			 F[6][11] * D[11][11] + F[6][12] * D[11][12] +
-			 F[6][7] * D[7][11] + F[6][8] * D[8][11]) +
-	     F[6][12] * (F[6][9] * D[9][12] + F[6][10] * D[10][12] +
-			 F[6][11] * D[11][12] + F[6][12] * D[12][12] +
-			 F[6][7] * D[7][12] + F[6][8] * D[8][12]) +
-	     F[6][7] * (F[6][7] * D[7][7] + F[6][8] * D[7][8] +
-			F[6][9] * D[7][9] + F[6][10] * D[7][10] +
-			F[6][11] * D[7][11] + F[6][12] * D[7][12]) +
-	     F[6][8] * (F[6][7] * D[7][8] + F[6][8] * D[8][8] +
-			F[6][9] * D[8][9] + F[6][10] * D[8][10] +
-			F[6][11] * D[8][11] + F[6][12] * D[8][12])) * Tsq +
-	    (2 * F[6][7] * D[6][7] + 2 * F[6][8] * D[6][8] +
-	     2 * F[6][9] * D[6][9] + 2 * F[6][10] * D[6][10] +
-	     2 * F[6][11] * D[6][11] + 2 * F[6][12] * D[6][12]) * T +
-	    D[6][6];
-	P[6][7] = P[7][6] =
-	    (F[7][9] *
-	     (F[6][9] * D[9][9] + F[6][10] * D[9][10] +
-	      F[6][11] * D[9][11] + F[6][12] * D[9][12] +
-	      F[6][7] * D[7][9] + F[6][8] * D[8][9]) +
-	     F[7][10] * (F[6][9] * D[9][10] + F[6][10] * D[10][10] +
-			 F[6][11] * D[10][11] + F[6][12] * D[10][12] +
-			 F[6][7] * D[7][10] + F[6][8] * D[8][10]) +
-	     F[7][11] * (F[6][9] * D[9][11] + F[6][10] * D[10][11] +
-			 F[6][11] * D[11][11] + F[6][12] * D[11][12] +
-			 F[6][7] * D[7][11] + F[6][8] * D[8][11]) +
-	     F[7][12] * (F[6][9] * D[9][12] + F[6][10] * D[10][12] +
-			 F[6][11] * D[11][12] + F[6][12] * D[12][12] +
-			 F[6][7] * D[7][12] + F[6][8] * D[8][12]) +
-	     F[7][6] * (F[6][7] * D[6][7] + F[6][8] * D[6][8] +
-			F[6][9] * D[6][9] + F[6][10] * D[6][10] +
-			F[6][11] * D[6][11] + F[6][12] * D[6][12]) +
-	     F[7][8] * (F[6][7] * D[7][8] + F[6][8] * D[8][8] +
-			F[6][9] * D[8][9] + F[6][10] * D[8][10] +
-			F[6][11] * D[8][11] + F[6][12] * D[8][12]) +
-	     G[6][0] * G[7][0] * Q[0] + G[6][1] * G[7][1] * Q[1] +
-	     G[6][2] * G[7][2] * Q[2]) * Tsq + (F[7][6] * D[6][6] +
-						F[6][7] * D[7][7] +
-						F[6][8] * D[7][8] +
-						F[7][8] * D[6][8] +
-						F[6][9] * D[7][9] +
-						F[7][9] * D[6][9] +
-						F[6][10] * D[7][10] +
-						F[7][10] * D[6][10] +
-						F[6][11] * D[7][11] +
-						F[7][11] * D[6][11] +
-						F[6][12] * D[7][12] +
-						F[7][12] * D[6][12]) * T +
-	    D[6][7];
-	P[6][8] = P[8][6] =
-	    (F[8][9] *
-	     (F[6][9] * D[9][9] + F[6][10] * D[9][10] +
-	      F[6][11] * D[9][11] + F[6][12] * D[9][12] +
-	      F[6][7] * D[7][9] + F[6][8] * D[8][9]) +
-	     F[8][10] * (F[6][9] * D[9][10] + F[6][10] * D[10][10] +
-			 F[6][11] * D[10][11] + F[6][12] * D[10][12] +
-			 F[6][7] * D[7][10] + F[6][8] * D[8][10]) +
-	     F[8][11] * (F[6][9] * D[9][11] + F[6][10] * D[10][11] +
-			 F[6][11] * D[11][11] + F[6][12] * D[11][12] +
-			 F[6][7] * D[7][11] + F[6][8] * D[8][11]) +
-	     F[8][12] * (F[6][9] * D[9][12] + F[6][10] * D[10][12] +
-			 F[6][11] * D[11][12] + F[6][12] * D[12][12] +
-			 F[6][7] * D[7][12] + F[6][8] * D[8][12]) +
-	     F[8][6] * (F[6][7] * D[6][7] + F[6][8] * D[6][8] +
-			F[6][9] * D[6][9] + F[6][10] * D[6][10] +
-			F[6][11] * D[6][11] + F[6][12] * D[6][12]) +
-	     F[8][7] * (F[6][7] * D[7][7] + F[6][8] * D[7][8] +
-			F[6][9] * D[7][9] + F[6][10] * D[7][10] +
-			F[6][11] * D[7][11] + F[6][12] * D[7][12]) +
-	     G[6][0] * G[8][0] * Q[0] + G[6][1] * G[8][1] * Q[1] +
-	     G[6][2] * G[8][2] * Q[2]) * Tsq + (F[6][7] * D[7][8] +
-						F[8][6] * D[6][6] +
-						F[8][7] * D[6][7] +
-						F[6][8] * D[8][8] +
-						F[6][9] * D[8][9] +
-						F[8][9] * D[6][9] +
-						F[6][10] * D[8][10] +
-						F[8][10] * D[6][10] +
-						F[6][11] * D[8][11] +
-						F[8][11] * D[6][11] +
-						F[6][12] * D[8][12] +
-						F[8][12] * D[6][12]) * T +
-	    D[6][8];
-	P[6][9] = P[9][6] =
-	    (F[9][10] *
-	     (F[6][9] * D[9][10] + F[6][10] * D[10][10] +
-	      F[6][11] * D[10][11] + F[6][12] * D[10][12] +
-	      F[6][7] * D[7][10] + F[6][8] * D[8][10]) +
-	     F[9][11] * (F[6][9] * D[9][11] + F[6][10] * D[10][11] +
-			 F[6][11] * D[11][11] + F[6][12] * D[11][12] +
-			 F[6][7] * D[7][11] + F[6][8] * D[8][11]) +
-	     F[9][12] * (F[6][9] * D[9][12] + F[6][10] * D[10][12] +
-			 F[6][11] * D[11][12] + F[6][12] * D[12][12] +
-			 F[6][7] * D[7][12] + F[6][8] * D[8][12]) +
-	     F[9][6] * (F[6][7] * D[6][7] + F[6][8] * D[6][8] +
-			F[6][9] * D[6][9] + F[6][10] * D[6][10] +
-			F[6][11] * D[6][11] + F[6][12] * D[6][12]) +
-	     F[9][7] * (F[6][7] * D[7][7] + F[6][8] * D[7][8] +
-			F[6][9] * D[7][9] + F[6][10] * D[7][10] +
-			F[6][11] * D[7][11] + F[6][12] * D[7][12]) +
-	     F[9][8] * (F[6][7] * D[7][8] + F[6][8] * D[8][8] +
-			F[6][9] * D[8][9] + F[6][10] * D[8][10] +
-			F[6][11] * D[8][11] + F[6][12] * D[8][12]) +
-	     G[9][0] * G[6][0] * Q[0] + G[9][1] * G[6][1] * Q[1] +
-	     G[9][2] * G[6][2] * Q[2]) * Tsq + (F[9][6] * D[6][6] +
-						F[9][7] * D[6][7] +
-						F[9][8] * D[6][8] +
-						F[6][9] * D[9][9] +
-						F[9][10] * D[6][10] +
-						F[6][10] * D[9][10] +
-						F[9][11] * D[6][11] +
-						F[6][11] * D[9][11] +
-						F[9][12] * D[6][12] +
-						F[6][12] * D[9][12] +
-						F[6][7] * D[7][9] +
-						F[6][8] * D[8][9]) * T +
-	    D[6][9];
-	P[6][10] = P[10][6] =
-	    (F[6][9] * D[9][10] + F[6][10] * D[10][10] +
-	     F[6][11] * D[10][11] + F[6][12] * D[10][12] +
-	     F[6][7] * D[7][10] + F[6][8] * D[8][10]) * T + D[6][10];
-	P[6][11] = P[11][6] =
-	    (F[6][9] * D[9][11] + F[6][10] * D[10][11] +
-	     F[6][11] * D[11][11] + F[6][12] * D[11][12] +
-	     F[6][7] * D[7][11] + F[6][8] * D[8][11]) * T + D[6][11];
-	P[6][12] = P[12][6] =
-	    (F[6][9] * D[9][12] + F[6][10] * D[10][12] +
-	     F[6][11] * D[11][12] + F[6][12] * D[12][12] +
-	     F[6][7] * D[7][12] + F[6][8] * D[8][12]) * T + D[6][12];
-	P[7][7] =
-	    (Q[0] * G[7][0] * G[7][0] + Q[1] * G[7][1] * G[7][1] +
-	     Q[2] * G[7][2] * G[7][2] + F[7][9] * (F[7][9] * D[9][9] +
-						   F[7][10] * D[9][10] +
-						   F[7][11] * D[9][11] +
-						   F[7][12] * D[9][12] +
-						   F[7][6] * D[6][9] +
-						   F[7][8] * D[8][9]) +
-	     F[7][10] * (F[7][9] * D[9][10] + F[7][10] * D[10][10] +
-			 F[7][11] * D[10][11] + F[7][12] * D[10][12] +
-			 F[7][6] * D[6][10] + F[7][8] * D[8][10]) +
-	     F[7][11] * (F[7][9] * D[9][11] + F[7][10] * D[10][11] +
-			 F[7][11] * D[11][11] + F[7][12] * D[11][12] +
-			 F[7][6] * D[6][11] + F[7][8] * D[8][11]) +
-	     F[7][12] * (F[7][9] * D[9][12] + F[7][10] * D[10][12] +
-			 F[7][11] * D[11][12] + F[7][12] * D[12][12] +
-			 F[7][6] * D[6][12] + F[7][8] * D[8][12]) +
-	     F[7][6] * (F[7][6] * D[6][6] + F[7][8] * D[6][8] +
-			F[7][9] * D[6][9] + F[7][10] * D[6][10] +
-			F[7][11] * D[6][11] + F[7][12] * D[6][12]) +
-	     F[7][8] * (F[7][6] * D[6][8] + F[7][8] * D[8][8] +
-			F[7][9] * D[8][9] + F[7][10] * D[8][10] +
-			F[7][11] * D[8][11] + F[7][12] * D[8][12])) * Tsq +
-	    (2 * F[7][6] * D[6][7] + 2 * F[7][8] * D[7][8] +
-	     2 * F[7][9] * D[7][9] + 2 * F[7][10] * D[7][10] +
-	     2 * F[7][11] * D[7][11] + 2 * F[7][12] * D[7][12]) * T +
-	    D[7][7];
-	P[7][8] = P[8][7] =
-	    (F[8][9] *
-	     (F[7][9] * D[9][9] + F[7][10] * D[9][10] +
-	      F[7][11] * D[9][11] + F[7][12] * D[9][12] +
-	      F[7][6] * D[6][9] + F[7][8] * D[8][9]) +
-	     F[8][10] * (F[7][9] * D[9][10] + F[7][10] * D[10][10] +
-			 F[7][11] * D[10][11] + F[7][12] * D[10][12] +
-			 F[7][6] * D[6][10] + F[7][8] * D[8][10]) +
-	     F[8][11] * (F[7][9] * D[9][11] + F[7][10] * D[10][11] +
-			 F[7][11] * D[11][11] + F[7][12] * D[11][12] +
-			 F[7][6] * D[6][11] + F[7][8] * D[8][11]) +
-	     F[8][12] * (F[7][9] * D[9][12] + F[7][10] * D[10][12] +
-			 F[7][11] * D[11][12] + F[7][12] * D[12][12] +
-			 F[7][6] * D[6][12] + F[7][8] * D[8][12]) +
-	     F[8][6] * (F[7][6] * D[6][6] + F[7][8] * D[6][8] +
-			F[7][9] * D[6][9] + F[7][10] * D[6][10] +
-			F[7][11] * D[6][11] + F[7][12] * D[6][12]) +
-	     F[8][7] * (F[7][6] * D[6][7] + F[7][8] * D[7][8] +
-			F[7][9] * D[7][9] + F[7][10] * D[7][10] +
-			F[7][11] * D[7][11] + F[7][12] * D[7][12]) +
-	     G[7][0] * G[8][0] * Q[0] + G[7][1] * G[8][1] * Q[1] +
-	     G[7][2] * G[8][2] * Q[2]) * Tsq + (F[7][6] * D[6][8] +
-						F[8][6] * D[6][7] +
-						F[8][7] * D[7][7] +
-						F[7][8] * D[8][8] +
-						F[7][9] * D[8][9] +
-						F[8][9] * D[7][9] +
-						F[7][10] * D[8][10] +
-						F[8][10] * D[7][10] +
-						F[7][11] * D[8][11] +
-						F[8][11] * D[7][11] +
-						F[7][12] * D[8][12] +
-						F[8][12] * D[7][12]) * T +
-	    D[7][8];
-	P[7][9] = P[9][7] =
-	    (F[9][10] *
-	     (F[7][9] * D[9][10] + F[7][10] * D[10][10] +
-	      F[7][11] * D[10][11] + F[7][12] * D[10][12] +
-	      F[7][6] * D[6][10] + F[7][8] * D[8][10]) +
-	     F[9][11] * (F[7][9] * D[9][11] + F[7][10] * D[10][11] +
-			 F[7][11] * D[11][11] + F[7][12] * D[11][12] +
-			 F[7][6] * D[6][11] + F[7][8] * D[8][11]) +
-	     F[9][12] * (F[7][9] * D[9][12] + F[7][10] * D[10][12] +
-			 F[7][11] * D[11][12] + F[7][12] * D[12][12] +
-			 F[7][6] * D[6][12] + F[7][8] * D[8][12]) +
-	     F[9][6] * (F[7][6] * D[6][6] + F[7][8] * D[6][8] +
-			F[7][9] * D[6][9] + F[7][10] * D[6][10] +
-			F[7][11] * D[6][11] + F[7][12] * D[6][12]) +
-	     F[9][7] * (F[7][6] * D[6][7] + F[7][8] * D[7][8] +
-			F[7][9] * D[7][9] + F[7][10] * D[7][10] +
-			F[7][11] * D[7][11] + F[7][12] * D[7][12]) +
-	     F[9][8] * (F[7][6] * D[6][8] + F[7][8] * D[8][8] +
-			F[7][9] * D[8][9] + F[7][10] * D[8][10] +
-			F[7][11] * D[8][11] + F[7][12] * D[8][12]) +
-	     G[9][0] * G[7][0] * Q[0] + G[9][1] * G[7][1] * Q[1] +
-	     G[9][2] * G[7][2] * Q[2]) * Tsq + (F[9][6] * D[6][7] +
-						F[9][7] * D[7][7] +
-						F[9][8] * D[7][8] +
-						F[7][9] * D[9][9] +
-						F[9][10] * D[7][10] +
-						F[7][10] * D[9][10] +
-						F[9][11] * D[7][11] +
-						F[7][11] * D[9][11] +
-						F[9][12] * D[7][12] +
-						F[7][12] * D[9][12] +
-						F[7][6] * D[6][9] +
-						F[7][8] * D[8][9]) * T +
-	    D[7][9];
-	P[7][10] = P[10][7] =
-	    (F[7][9] * D[9][10] + F[7][10] * D[10][10] +
-	     F[7][11] * D[10][11] + F[7][12] * D[10][12] +
-	     F[7][6] * D[6][10] + F[7][8] * D[8][10]) * T + D[7][10];
-	P[7][11] = P[11][7] =
-	    (F[7][9] * D[9][11] + F[7][10] * D[10][11] +
-	     F[7][11] * D[11][11] + F[7][12] * D[11][12] +
-	     F[7][6] * D[6][11] + F[7][8] * D[8][11]) * T + D[7][11];
-	P[7][12] = P[12][7] =
-	    (F[7][9] * D[9][12] + F[7][10] * D[10][12] +
-	     F[7][11] * D[11][12] + F[7][12] * D[12][12] +
-	     F[7][6] * D[6][12] + F[7][8] * D[8][12]) * T + D[7][12];
-	P[8][8] =
-	    (Q[0] * G[8][0] * G[8][0] + Q[1] * G[8][1] * G[8][1] +
-	     Q[2] * G[8][2] * G[8][2] + F[8][9] * (F[8][9] * D[9][9] +
-						   F[8][10] * D[9][10] +
-						   F[8][11] * D[9][11] +
-						   F[8][12] * D[9][12] +
-						   F[8][6] * D[6][9] +
-						   F[8][7] * D[7][9]) +
-	     F[8][10] * (F[8][9] * D[9][10] + F[8][10] * D[10][10] +
-			 F[8][11] * D[10][11] + F[8][12] * D[10][12] +
-			 F[8][6] * D[6][10] + F[8][7] * D[7][10]) +
-	     F[8][11] * (F[8][9] * D[9][11] + F[8][10] * D[10][11] +
-			 F[8][11] * D[11][11] + F[8][12] * D[11][12] +
-			 F[8][6] * D[6][11] + F[8][7] * D[7][11]) +
-	     F[8][12] * (F[8][9] * D[9][12] + F[8][10] * D[10][12] +
-			 F[8][11] * D[11][12] + F[8][12] * D[12][12] +
-			 F[8][6] * D[6][12] + F[8][7] * D[7][12]) +
-	     F[8][6] * (F[8][6] * D[6][6] + F[8][7] * D[6][7] +
-			F[8][9] * D[6][9] + F[8][10] * D[6][10] +
-			F[8][11] * D[6][11] + F[8][12] * D[6][12]) +
-	     F[8][7] * (F[8][6] * D[6][7] + F[8][7] * D[7][7] +
-			F[8][9] * D[7][9] + F[8][10] * D[7][10] +
-			F[8][11] * D[7][11] + F[8][12] * D[7][12])) * Tsq +
-	    (2 * F[8][6] * D[6][8] + 2 * F[8][7] * D[7][8] +
-	     2 * F[8][9] * D[8][9] + 2 * F[8][10] * D[8][10] +
-	     2 * F[8][11] * D[8][11] + 2 * F[8][12] * D[8][12]) * T +
-	    D[8][8];
-	P[8][9] = P[9][8] =
-	    (F[9][10] *
-	     (F[8][9] * D[9][10] + F[8][10] * D[10][10] +
-	      F[8][11] * D[10][11] + F[8][12] * D[10][12] +
-	      F[8][6] * D[6][10] + F[8][7] * D[7][10]) +
-	     F[9][11] * (F[8][9] * D[9][11] + F[8][10] * D[10][11] +
-			 F[8][11] * D[11][11] + F[8][12] * D[11][12] +
-			 F[8][6] * D[6][11] + F[8][7] * D[7][11]) +
-	     F[9][12] * (F[8][9] * D[9][12] + F[8][10] * D[10][12] +
-			 F[8][11] * D[11][12] + F[8][12] * D[12][12] +
-			 F[8][6] * D[6][12] + F[8][7] * D[7][12]) +
-	     F[9][6] * (F[8][6] * D[6][6] + F[8][7] * D[6][7] +
-			F[8][9] * D[6][9] + F[8][10] * D[6][10] +
-			F[8][11] * D[6][11] + F[8][12] * D[6][12]) +
-	     F[9][7] * (F[8][6] * D[6][7] + F[8][7] * D[7][7] +
-			F[8][9] * D[7][9] + F[8][10] * D[7][10] +
-			F[8][11] * D[7][11] + F[8][12] * D[7][12]) +
-	     F[9][8] * (F[8][6] * D[6][8] + F[8][7] * D[7][8] +
-			F[8][9] * D[8][9] + F[8][10] * D[8][10] +
-			F[8][11] * D[8][11] + F[8][12] * D[8][12]) +
-	     G[9][0] * G[8][0] * Q[0] + G[9][1] * G[8][1] * Q[1] +
-	     G[9][2] * G[8][2] * Q[2]) * Tsq + (F[9][6] * D[6][8] +
-						F[9][7] * D[7][8] +
-						F[9][8] * D[8][8] +
-						F[8][9] * D[9][9] +
-						F[9][10] * D[8][10] +
-						F[8][10] * D[9][10] +
-						F[9][11] * D[8][11] +
-						F[8][11] * D[9][11] +
-						F[9][12] * D[8][12] +
-						F[8][12] * D[9][12] +
-						F[8][6] * D[6][9] +
-						F[8][7] * D[7][9]) * T +
-	    D[8][9];
-	P[8][10] = P[10][8] =
-	    (F[8][9] * D[9][10] + F[8][10] * D[10][10] +
-	     F[8][11] * D[10][11] + F[8][12] * D[10][12] +
-	     F[8][6] * D[6][10] + F[8][7] * D[7][10]) * T + D[8][10];
-	P[8][11] = P[11][8] =
-	    (F[8][9] * D[9][11] + F[8][10] * D[10][11] +
-	     F[8][11] * D[11][11] + F[8][12] * D[11][12] +
-	     F[8][6] * D[6][11] + F[8][7] * D[7][11]) * T + D[8][11];
-	P[8][12] = P[12][8] =
-	    (F[8][9] * D[9][12] + F[8][10] * D[10][12] +
-	     F[8][11] * D[11][12] + F[8][12] * D[12][12] +
-	     F[8][6] * D[6][12] + F[8][7] * D[7][12]) * T + D[8][12];
-	P[9][9] =
-	    (Q[0] * G[9][0] * G[9][0] + Q[1] * G[9][1] * G[9][1] +
-	     Q[2] * G[9][2] * G[9][2] + F[9][10] * (F[9][10] * D[10][10] +
-						    F[9][11] * D[10][11] +
-						    F[9][12] * D[10][12] +
-						    F[9][6] * D[6][10] +
-						    F[9][7] * D[7][10] +
-						    F[9][8] * D[8][10]) +
-	     F[9][11] * (F[9][10] * D[10][11] + F[9][11] * D[11][11] +
-			 F[9][12] * D[11][12] + F[9][6] * D[6][11] +
-			 F[9][7] * D[7][11] + F[9][8] * D[8][11]) +
-	     F[9][12] * (F[9][10] * D[10][12] + F[9][11] * D[11][12] +
-			 F[9][12] * D[12][12] + F[9][6] * D[6][12] +
-			 F[9][7] * D[7][12] + F[9][8] * D[8][12]) +
-	     F[9][6] * (F[9][6] * D[6][6] + F[9][7] * D[6][7] +
-			F[9][8] * D[6][8] + F[9][10] * D[6][10] +
-			F[9][11] * D[6][11] + F[9][12] * D[6][12]) +
-	     F[9][7] * (F[9][6] * D[6][7] + F[9][7] * D[7][7] +
-			F[9][8] * D[7][8] + F[9][10] * D[7][10] +
-			F[9][11] * D[7][11] + F[9][12] * D[7][12]) +
-	     F[9][8] * (F[9][6] * D[6][8] + F[9][7] * D[7][8] +
-			F[9][8] * D[8][8] + F[9][10] * D[8][10] +
-			F[9][11] * D[8][11] + F[9][12] * D[8][12])) * Tsq +
-	    (2 * F[9][10] * D[9][10] + 2 * F[9][11] * D[9][11] +
-	     2 * F[9][12] * D[9][12] + 2 * F[9][6] * D[6][9] +
-	     2 * F[9][7] * D[7][9] + 2 * F[9][8] * D[8][9]) * T + D[9][9];
-	P[9][10] = P[10][9] =
-	    (F[9][10] * D[10][10] + F[9][11] * D[10][11] +
-	     F[9][12] * D[10][12] + F[9][6] * D[6][10] +
-	     F[9][7] * D[7][10] + F[9][8] * D[8][10]) * T + D[9][10];
-	P[9][11] = P[11][9] =
-	    (F[9][10] * D[10][11] + F[9][11] * D[11][11] +
-	     F[9][12] * D[11][12] + F[9][6] * D[6][11] +
-	     F[9][7] * D[7][11] + F[9][8] * D[8][11]) * T + D[9][11];
-	P[9][12] = P[12][9] =
-	    (F[9][10] * D[10][12] + F[9][11] * D[11][12] +
-	     F[9][12] * D[12][12] + F[9][6] * D[6][12] +
-	     F[9][7] * D[7][12] + F[9][8] * D[8][12]) * T + D[9][12];
-	P[10][10] = Q[6] * Tsq + D[10][10];
-	P[10][11] = P[11][10] = D[10][11];
-	P[10][12] = P[12][10] = D[10][12];
-	P[11][11] = Q[7] * Tsq + D[11][11];
-	P[11][12] = P[12][11] = D[11][12];
-	P[12][12] = Q[8] * Tsq + D[12][12];
+	P[PIDX(0, 0)] = D[PIDX(3, 3)] * Tsq + (2 * D[PIDX(0, 3)]) * T + D[PIDX(0, 0)];
+	P[PIDX(0, 1)] =
+	    D[PIDX(3, 4)] * Tsq + (D[PIDX(0, 4)] + D[PIDX(1, 3)]) * T + D[PIDX(0, 1)];
+	P[PIDX(0, 2)] =
+	    D[PIDX(3, 5)] * Tsq + (D[PIDX(0, 5)] + D[PIDX(2, 3)]) * T + D[PIDX(0, 2)];
+	P[PIDX(0, 3)] =
+	    (FV(3, 6) * D[PIDX(3, 6)] + FV(3, 7) * D[PIDX(3, 7)] + FV(3, 8) * D[PIDX(3, 8)] +
+	     FV(3, 9) * D[PIDX(3, 9)]) * Tsq + (D[PIDX(3, 3)] + FV(3, 6) * D[PIDX(0, 6)] +
+					 FV(3, 7) * D[PIDX(0, 7)] +
+					 FV(3, 8) * D[PIDX(0, 8)] +
+					 FV(3, 9) * D[PIDX(0, 9)]) * T + D[PIDX(0, 3)];
+	P[PIDX(0, 4)] =
+	    (FV(4, 6) * D[PIDX(3, 6)] + FV(4, 7) * D[PIDX(3, 7)] + FV(4, 8) * D[PIDX(3, 8)] +
+	     FV(4, 9) * D[PIDX(3, 9)]) * Tsq + (D[PIDX(3, 4)] + FV(4, 6) * D[PIDX(0, 6)] +
+					 FV(4, 7) * D[PIDX(0, 7)] +
+					 FV(4, 8) * D[PIDX(0, 8)] +
+					 FV(4, 9) * D[PIDX(0, 9)]) * T + D[PIDX(0, 4)];
+	P[PIDX(0, 5)] =
+	    (FV(5, 6) * D[PIDX(3, 6)] + FV(5, 7) * D[PIDX(3, 7)] + FV(5, 8) * D[PIDX(3, 8)] +
+	     FV(5, 9) * D[PIDX(3, 9)]) * Tsq + (D[PIDX(3, 5)] + FV(5, 6) * D[PIDX(0, 6)] +
+					 FV(5, 7) * D[PIDX(0, 7)] +
+					 FV(5, 8) * D[PIDX(0, 8)] +
+					 FV(5, 9) * D[PIDX(0, 9)]) * T + D[PIDX(0, 5)];
+	P[PIDX(0, 6)] =
+	    (FQ(6, 7) * D[PIDX(3, 7)] + FQ(6, 8) * D[PIDX(3, 8)] + FQ(6, 9) * D[PIDX(3, 9)] +
+	     FQ(6, 10) * D[PIDX(3, 10)] + FQ(6, 11) * D[PIDX(3, 11)] +
+	     FQ(6, 12) * D[PIDX(3, 12)]) * Tsq + (D[PIDX(3, 6)] + FQ(6, 7) * D[PIDX(0, 7)] +
+					   FQ(6, 8) * D[PIDX(0, 8)] +
+					   FQ(6, 9) * D[PIDX(0, 9)] +
+					   FQ(6, 10) * D[PIDX(0, 10)] +
+					   FQ(6, 11) * D[PIDX(0, 11)] +
+					   FQ(6, 12) * D[PIDX(0, 12)]) * T +
+	    D[PIDX(0, 6)];
+	P[PIDX(0, 7)] =
+	    (FQ(7, 6) * D[PIDX(3, 6)] + FQ(7, 8) * D[PIDX(3, 8)] + FQ(7, 9) * D[PIDX(3, 9)] +
+	     FQ(7, 10) * D[PIDX(3, 10)] + FQ(7, 11) * D[PIDX(3, 11)] +
+	     FQ(7, 12) * D[PIDX(3, 12)]) * Tsq + (D[PIDX(3, 7)] + FQ(7, 6) * D[PIDX(0, 6)] +
+					   FQ(7, 8) * D[PIDX(0, 8)] +
+					   FQ(7, 9) * D[PIDX(0, 9)] +
+					   FQ(7, 10) * D[PIDX(0, 10)] +
+					   FQ(7, 11) * D[PIDX(0, 11)] +
+					   FQ(7, 12) * D[PIDX(0, 12)]) * T +
+	    D[PIDX(0, 7)];
+	P[PIDX(0, 8)] =
+	    (FQ(8, 6) * D[PIDX(3, 6)] + FQ(8, 7) * D[PIDX(3, 7)] + FQ(8, 9) * D[PIDX(3, 9)] +
+	     FQ(8, 10) * D[PIDX(3, 10)] + FQ(8, 11) * D[PIDX(3, 11)] +
+	     FQ(8, 12) * D[PIDX(3, 12)]) * Tsq + (D[PIDX(3, 8)] + FQ(8, 6) * D[PIDX(0, 6)] +
+					   FQ(8, 7) * D[PIDX(0, 7)] +
+					   FQ(8, 9) * D[PIDX(0, 9)] +
+					   FQ(8, 10) * D[PIDX(0, 10)] +
+					   FQ(8, 11) * D[PIDX(0, 11)] +
+					   FQ(8, 12) * D[PIDX(0, 12)]) * T +
+	    D[PIDX(0, 8)];
+	P[PIDX(0, 9)] =
+	    (FQ(9, 6) * D[PIDX(3, 6)] + FQ(9, 7) * D[PIDX(3, 7)] + FQ(9, 8) * D[PIDX(3, 8)] +
+	     FQ(9, 10) * D[PIDX(3, 10)] + FQ(9, 11) * D[PIDX(3, 11)] +
+	     FQ(9, 12) * D[PIDX(3, 12)]) * Tsq + (D[PIDX(3, 9)] + FQ(9, 6) * D[PIDX(0, 6)] +
+					   FQ(9, 7) * D[PIDX(0, 7)] +
+					   FQ(9, 8) * D[PIDX(0, 8)] +
+					   FQ(9, 10) * D[PIDX(0, 10)] +
+					   FQ(9, 11) * D[PIDX(0, 11)] +
+					   FQ(9, 12) * D[PIDX(0, 12)]) * T +
+	    D[PIDX(0, 9)];
+	P[PIDX(0, 10)] = D[PIDX(3, 10)] * T + D[PIDX(0, 10)];
+	P[PIDX(0, 11)] = D[PIDX(3, 11)] * T + D[PIDX(0, 11)];
+	P[PIDX(0, 12)] = D[PIDX(3, 12)] * T + D[PIDX(0, 12)];
+	P[PIDX(1, 1)] = D[PIDX(4, 4)] * Tsq + (2 * D[PIDX(1, 4)]) * T + D[PIDX(1, 1)];
+	P[PIDX(1, 2)] =
+	    D[PIDX(4, 5)] * Tsq + (D[PIDX(1, 5)] + D[PIDX(2, 4)]) * T + D[PIDX(1, 2)];
+	P[PIDX(1, 3)] =
+	    (FV(3, 6) * D[PIDX(4, 6)] + FV(3, 7) * D[PIDX(4, 7)] + FV(3, 8) * D[PIDX(4, 8)] +
+	     FV(3, 9) * D[PIDX(4, 9)]) * Tsq + (D[PIDX(3, 4)] + FV(3, 6) * D[PIDX(1, 6)] +
+					 FV(3, 7) * D[PIDX(1, 7)] +
+					 FV(3, 8) * D[PIDX(1, 8)] +
+					 FV(3, 9) * D[PIDX(1, 9)]) * T + D[PIDX(1, 3)];
+	P[PIDX(1, 4)] =
+	    (FV(4, 6) * D[PIDX(4, 6)] + FV(4, 7) * D[PIDX(4, 7)] + FV(4, 8) * D[PIDX(4, 8)] +
+	     FV(4, 9) * D[PIDX(4, 9)]) * Tsq + (D[PIDX(4, 4)] + FV(4, 6) * D[PIDX(1, 6)] +
+					 FV(4, 7) * D[PIDX(1, 7)] +
+					 FV(4, 8) * D[PIDX(1, 8)] +
+					 FV(4, 9) * D[PIDX(1, 9)]) * T + D[PIDX(1, 4)];
+	P[PIDX(1, 5)] =
+	    (FV(5, 6) * D[PIDX(4, 6)] + FV(5, 7) * D[PIDX(4, 7)] + FV(5, 8) * D[PIDX(4, 8)] +
+	     FV(5, 9) * D[PIDX(4, 9)]) * Tsq + (D[PIDX(4, 5)] + FV(5, 6) * D[PIDX(1, 6)] +
+					 FV(5, 7) * D[PIDX(1, 7)] +
+					 FV(5, 8) * D[PIDX(1, 8)] +
+					 FV(5, 9) * D[PIDX(1, 9)]) * T + D[PIDX(1, 5)];
+	P[PIDX(1, 6)] =
+	    (FQ(6, 7) * D[PIDX(4, 7)] + FQ(6, 8) * D[PIDX(4, 8)] + FQ(6, 9) * D[PIDX(4, 9)] +
+	     FQ(6, 10) * D[PIDX(4, 10)] + FQ(6, 11) * D[PIDX(4, 11)] +
+	     FQ(6, 12) * D[PIDX(4, 12)]) * Tsq + (D[PIDX(4, 6)] + FQ(6, 7) * D[PIDX(1, 7)] +
+					   FQ(6, 8) * D[PIDX(1, 8)] +
+					   FQ(6, 9) * D[PIDX(1, 9)] +
+					   FQ(6, 10) * D[PIDX(1, 10)] +
+					   FQ(6, 11) * D[PIDX(1, 11)] +
+					   FQ(6, 12) * D[PIDX(1, 12)]) * T +
+	    D[PIDX(1, 6)];
+	P[PIDX(1, 7)] =
+	    (FQ(7, 6) * D[PIDX(4, 6)] + FQ(7, 8) * D[PIDX(4, 8)] + FQ(7, 9) * D[PIDX(4, 9)] +
+	     FQ(7, 10) * D[PIDX(4, 10)] + FQ(7, 11) * D[PIDX(4, 11)] +
+	     FQ(7, 12) * D[PIDX(4, 12)]) * Tsq + (D[PIDX(4, 7)] + FQ(7, 6) * D[PIDX(1, 6)] +
+					   FQ(7, 8) * D[PIDX(1, 8)] +
+					   FQ(7, 9) * D[PIDX(1, 9)] +
+					   FQ(7, 10) * D[PIDX(1, 10)] +
+					   FQ(7, 11) * D[PIDX(1, 11)] +
+					   FQ(7, 12) * D[PIDX(1, 12)]) * T +
+	    D[PIDX(1, 7)];
+	P[PIDX(1, 8)] =
+	    (FQ(8, 6) * D[PIDX(4, 6)] + FQ(8, 7) * D[PIDX(4, 7)] + FQ(8, 9) * D[PIDX(4, 9)] +
+	     FQ(8, 10) * D[PIDX(4, 10)] + FQ(8, 11) * D[PIDX(4, 11)] +
+	     FQ(8, 12) * D[PIDX(4, 12)]) * Tsq + (D[PIDX(4, 8)] + FQ(8, 6) * D[PIDX(1, 6)] +
+					   FQ(8, 7) * D[PIDX(1, 7)] +
+					   FQ(8, 9) * D[PIDX(1, 9)] +
+					   FQ(8, 10) * D[PIDX(1, 10)] +
+					   FQ(8, 11) * D[PIDX(1, 11)] +
+					   FQ(8, 12) * D[PIDX(1, 12)]) * T +
+	    D[PIDX(1, 8)];
+	P[PIDX(1, 9)] =
+	    (FQ(9, 6) * D[PIDX(4, 6)] + FQ(9, 7) * D[PIDX(4, 7)] + FQ(9, 8) * D[PIDX(4, 8)] +
+	     FQ(9, 10) * D[PIDX(4, 10)] + FQ(9, 11) * D[PIDX(4, 11)] +
+	     FQ(9, 12) * D[PIDX(4, 12)]) * Tsq + (D[PIDX(4, 9)] + FQ(9, 6) * D[PIDX(1, 6)] +
+					   FQ(9, 7) * D[PIDX(1, 7)] +
+					   FQ(9, 8) * D[PIDX(1, 8)] +
+					   FQ(9, 10) * D[PIDX(1, 10)] +
+					   FQ(9, 11) * D[PIDX(1, 11)] +
+					   FQ(9, 12) * D[PIDX(1, 12)]) * T +
+	    D[PIDX(1, 9)];
+	P[PIDX(1, 10)] = D[PIDX(4, 10)] * T + D[PIDX(1, 10)];
+	P[PIDX(1, 11)] = D[PIDX(4, 11)] * T + D[PIDX(1, 11)];
+	P[PIDX(1, 12)] = D[PIDX(4, 12)] * T + D[PIDX(1, 12)];
+	P[PIDX(2, 2)] = D[PIDX(5, 5)] * Tsq + (2 * D[PIDX(2, 5)]) * T + D[PIDX(2, 2)];
+	P[PIDX(2, 3)] =
+	    (FV(3, 6) * D[PIDX(5, 6)] + FV(3, 7) * D[PIDX(5, 7)] + FV(3, 8) * D[PIDX(5, 8)] +
+	     FV(3, 9) * D[PIDX(5, 9)]) * Tsq + (D[PIDX(3, 5)] + FV(3, 6) * D[PIDX(2, 6)] +
+					 FV(3, 7) * D[PIDX(2, 7)] +
+					 FV(3, 8) * D[PIDX(2, 8)] +
+					 FV(3, 9) * D[PIDX(2, 9)]) * T + D[PIDX(2, 3)];
+	P[PIDX(2, 4)] =
+	    (FV(4, 6) * D[PIDX(5, 6)] + FV(4, 7) * D[PIDX(5, 7)] + FV(4, 8) * D[PIDX(5, 8)] +
+	     FV(4, 9) * D[PIDX(5, 9)]) * Tsq + (D[PIDX(4, 5)] + FV(4, 6) * D[PIDX(2, 6)] +
+					 FV(4, 7) * D[PIDX(2, 7)] +
+					 FV(4, 8) * D[PIDX(2, 8)] +
+					 FV(4, 9) * D[PIDX(2, 9)]) * T + D[PIDX(2, 4)];
+	P[PIDX(2, 5)] =
+	    (FV(5, 6) * D[PIDX(5, 6)] + FV(5, 7) * D[PIDX(5, 7)] + FV(5, 8) * D[PIDX(5, 8)] +
+	     FV(5, 9) * D[PIDX(5, 9)]) * Tsq + (D[PIDX(5, 5)] + FV(5, 6) * D[PIDX(2, 6)] +
+					 FV(5, 7) * D[PIDX(2, 7)] +
+					 FV(5, 8) * D[PIDX(2, 8)] +
+					 FV(5, 9) * D[PIDX(2, 9)]) * T + D[PIDX(2, 5)];
+	P[PIDX(2, 6)] =
+	    (FQ(6, 7) * D[PIDX(5, 7)] + FQ(6, 8) * D[PIDX(5, 8)] + FQ(6, 9) * D[PIDX(5, 9)] +
+	     FQ(6, 10) * D[PIDX(5, 10)] + FQ(6, 11) * D[PIDX(5, 11)] +
+	     FQ(6, 12) * D[PIDX(5, 12)]) * Tsq + (D[PIDX(5, 6)] + FQ(6, 7) * D[PIDX(2, 7)] +
+					   FQ(6, 8) * D[PIDX(2, 8)] +
+					   FQ(6, 9) * D[PIDX(2, 9)] +
+					   FQ(6, 10) * D[PIDX(2, 10)] +
+					   FQ(6, 11) * D[PIDX(2, 11)] +
+					   FQ(6, 12) * D[PIDX(2, 12)]) * T +
+	    D[PIDX(2, 6)];
+	P[PIDX(2, 7)] =
+	    (FQ(7, 6) * D[PIDX(5, 6)] + FQ(7, 8) * D[PIDX(5, 8)] + FQ(7, 9) * D[PIDX(5, 9)] +
+	     FQ(7, 10) * D[PIDX(5, 10)] + FQ(7, 11) * D[PIDX(5, 11)] +
+	     FQ(7, 12) * D[PIDX(5, 12)]) * Tsq + (D[PIDX(5, 7)] + FQ(7, 6) * D[PIDX(2, 6)] +
+					   FQ(7, 8) * D[PIDX(2, 8)] +
+					   FQ(7, 9) * D[PIDX(2, 9)] +
+					   FQ(7, 10) * D[PIDX(2, 10)] +
+					   FQ(7, 11) * D[PIDX(2, 11)] +
+					   FQ(7, 12) * D[PIDX(2, 12)]) * T +
+	    D[PIDX(2, 7)];
+	P[PIDX(2, 8)] =
+	    (FQ(8, 6) * D[PIDX(5, 6)] + FQ(8, 7) * D[PIDX(5, 7)] + FQ(8, 9) * D[PIDX(5, 9)] +
+	     FQ(8, 10) * D[PIDX(5, 10)] + FQ(8, 11) * D[PIDX(5, 11)] +
+	     FQ(8, 12) * D[PIDX(5, 12)]) * Tsq + (D[PIDX(5, 8)] + FQ(8, 6) * D[PIDX(2, 6)] +
+					   FQ(8, 7) * D[PIDX(2, 7)] +
+					   FQ(8, 9) * D[PIDX(2, 9)] +
+					   FQ(8, 10) * D[PIDX(2, 10)] +
+					   FQ(8, 11) * D[PIDX(2, 11)] +
+					   FQ(8, 12) * D[PIDX(2, 12)]) * T +
+	    D[PIDX(2, 8)];
+	P[PIDX(2, 9)] =
+	    (FQ(9, 6) * D[PIDX(5, 6)] + FQ(9, 7) * D[PIDX(5, 7)] + FQ(9, 8) * D[PIDX(5, 8)] +
+	     FQ(9, 10) * D[PIDX(5, 10)] + FQ(9, 11) * D[PIDX(5, 11)] +
+	     FQ(9, 12) * D[PIDX(5, 12)]) * Tsq + (D[PIDX(5, 9)] + FQ(9, 6) * D[PIDX(2, 6)] +
+					   FQ(9, 7) * D[PIDX(2, 7)] +
+					   FQ(9, 8) * D[PIDX(2, 8)] +
+					   FQ(9, 10) * D[PIDX(2, 10)] +
+					   FQ(9, 11) * D[PIDX(2, 11)] +
+					   FQ(9, 12) * D[PIDX(2, 12)]) * T +
+	    D[PIDX(2, 9)];
+	P[PIDX(2, 10)] = D[PIDX(5, 10)] * T + D[PIDX(2, 10)];
+	P[PIDX(2, 11)] = D[PIDX(5, 11)] * T + D[PIDX(2, 11)];
+	P[PIDX(2, 12)] = D[PIDX(5, 12)] * T + D[PIDX(2, 12)];
+	P[PIDX(3, 3)] =
+	    (Q[3] * GV(3, 3) * GV(3, 3) + Q[4] * GV(3, 4) * GV(3, 4) +
+	     Q[5] * GV(3, 5) * GV(3, 5) + FV(3, 9) * (FV(3, 9) * D[PIDX(9, 9)] +
+						   FV(3, 6) * D[PIDX(6, 9)] +
+						   FV(3, 7) * D[PIDX(7, 9)] +
+						   FV(3, 8) * D[PIDX(8, 9)]) +
+	     FV(3, 6) * (FV(3, 6) * D[PIDX(6, 6)] + FV(3, 7) * D[PIDX(6, 7)] +
+			FV(3, 8) * D[PIDX(6, 8)] + FV(3, 9) * D[PIDX(6, 9)]) +
+	     FV(3, 7) * (FV(3, 6) * D[PIDX(6, 7)] + FV(3, 7) * D[PIDX(7, 7)] +
+			FV(3, 8) * D[PIDX(7, 8)] + FV(3, 9) * D[PIDX(7, 9)]) +
+	     FV(3, 8) * (FV(3, 6) * D[PIDX(6, 8)] + FV(3, 7) * D[PIDX(7, 8)] +
+			FV(3, 8) * D[PIDX(8, 8)] + FV(3, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (2 * FV(3, 6) * D[PIDX(3, 6)] + 2 * FV(3, 7) * D[PIDX(3, 7)] +
+	     2 * FV(3, 8) * D[PIDX(3, 8)] + 2 * FV(3, 9) * D[PIDX(3, 9)]) * T + D[PIDX(3, 3)];
+	P[PIDX(3, 4)] =
+	    (FV(4, 9) *
+	     (FV(3, 9) * D[PIDX(9, 9)] + FV(3, 6) * D[PIDX(6, 9)] + FV(3, 7) * D[PIDX(7, 9)] +
+	      FV(3, 8) * D[PIDX(8, 9)]) + FV(4, 6) * (FV(3, 6) * D[PIDX(6, 6)] +
+					      FV(3, 7) * D[PIDX(6, 7)] +
+					      FV(3, 8) * D[PIDX(6, 8)] +
+					      FV(3, 9) * D[PIDX(6, 9)]) +
+	     FV(4, 7) * (FV(3, 6) * D[PIDX(6, 7)] + FV(3, 7) * D[PIDX(7, 7)] +
+			FV(3, 8) * D[PIDX(7, 8)] + FV(3, 9) * D[PIDX(7, 9)]) +
+	     FV(4, 8) * (FV(3, 6) * D[PIDX(6, 8)] + FV(3, 7) * D[PIDX(7, 8)] +
+			FV(3, 8) * D[PIDX(8, 8)] + FV(3, 9) * D[PIDX(8, 9)]) +
+	     GV(3, 3) * GV(4, 3) * Q[3] + GV(3, 4) * GV(4, 4) * Q[4] +
+	     GV(3, 5) * GV(4, 5) * Q[5]) * Tsq + (FV(3, 6) * D[PIDX(4, 6)] +
+						FV(4, 6) * D[PIDX(3, 6)] +
+						FV(3, 7) * D[PIDX(4, 7)] +
+						FV(4, 7) * D[PIDX(3, 7)] +
+						FV(3, 8) * D[PIDX(4, 8)] +
+						FV(4, 8) * D[PIDX(3, 8)] +
+						FV(3, 9) * D[PIDX(4, 9)] +
+						FV(4, 9) * D[PIDX(3, 9)]) * T +
+	    D[PIDX(3, 4)];
+	P[PIDX(3, 5)] =
+	    (FV(5, 9) *
+	     (FV(3, 9) * D[PIDX(9, 9)] + FV(3, 6) * D[PIDX(6, 9)] + FV(3, 7) * D[PIDX(7, 9)] +
+	      FV(3, 8) * D[PIDX(8, 9)]) + FV(5, 6) * (FV(3, 6) * D[PIDX(6, 6)] +
+					      FV(3, 7) * D[PIDX(6, 7)] +
+					      FV(3, 8) * D[PIDX(6, 8)] +
+					      FV(3, 9) * D[PIDX(6, 9)]) +
+	     FV(5, 7) * (FV(3, 6) * D[PIDX(6, 7)] + FV(3, 7) * D[PIDX(7, 7)] +
+			FV(3, 8) * D[PIDX(7, 8)] + FV(3, 9) * D[PIDX(7, 9)]) +
+	     FV(5, 8) * (FV(3, 6) * D[PIDX(6, 8)] + FV(3, 7) * D[PIDX(7, 8)] +
+			FV(3, 8) * D[PIDX(8, 8)] + FV(3, 9) * D[PIDX(8, 9)]) +
+	     GV(3, 3) * GV(5, 3) * Q[3] + GV(3, 4) * GV(5, 4) * Q[4] +
+	     GV(3, 5) * GV(5, 5) * Q[5]) * Tsq + (FV(3, 6) * D[PIDX(5, 6)] +
+						FV(5, 6) * D[PIDX(3, 6)] +
+						FV(3, 7) * D[PIDX(5, 7)] +
+						FV(5, 7) * D[PIDX(3, 7)] +
+						FV(3, 8) * D[PIDX(5, 8)] +
+						FV(5, 8) * D[PIDX(3, 8)] +
+						FV(3, 9) * D[PIDX(5, 9)] +
+						FV(5, 9) * D[PIDX(3, 9)]) * T +
+	    D[PIDX(3, 5)];
+	P[PIDX(3, 6)] =
+	    (FQ(6, 9) *
+	     (FV(3, 9) * D[PIDX(9, 9)] + FV(3, 6) * D[PIDX(6, 9)] + FV(3, 7) * D[PIDX(7, 9)] +
+	      FV(3, 8) * D[PIDX(8, 9)]) + FQ(6, 10) * (FV(3, 9) * D[PIDX(9, 10)] +
+					       FV(3, 6) * D[PIDX(6, 10)] +
+					       FV(3, 7) * D[PIDX(7, 10)] +
+					       FV(3, 8) * D[PIDX(8, 10)]) +
+	     FQ(6, 11) * (FV(3, 9) * D[PIDX(9, 11)] + FV(3, 6) * D[PIDX(6, 11)] +
+			 FV(3, 7) * D[PIDX(7, 11)] + FV(3, 8) * D[PIDX(8, 11)]) +
+	     FQ(6, 12) * (FV(3, 9) * D[PIDX(9, 12)] + FV(3, 6) * D[PIDX(6, 12)] +
+			 FV(3, 7) * D[PIDX(7, 12)] + FV(3, 8) * D[PIDX(8, 12)]) +
+	     FQ(6, 7) * (FV(3, 6) * D[PIDX(6, 7)] + FV(3, 7) * D[PIDX(7, 7)] +
+			FV(3, 8) * D[PIDX(7, 8)] + FV(3, 9) * D[PIDX(7, 9)]) +
+	     FQ(6, 8) * (FV(3, 6) * D[PIDX(6, 8)] + FV(3, 7) * D[PIDX(7, 8)] +
+			FV(3, 8) * D[PIDX(8, 8)] + FV(3, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (FV(3, 6) * D[PIDX(6, 6)] + FV(3, 7) * D[PIDX(6, 7)] + FQ(6, 7) * D[PIDX(3, 7)] +
+	     FV(3, 8) * D[PIDX(6, 8)] + FQ(6, 8) * D[PIDX(3, 8)] + FV(3, 9) * D[PIDX(6, 9)] +
+	     FQ(6, 9) * D[PIDX(3, 9)] + FQ(6, 10) * D[PIDX(3, 10)] +
+	     FQ(6, 11) * D[PIDX(3, 11)] + FQ(6, 12) * D[PIDX(3, 12)]) * T + D[PIDX(3, 6)];
+	P[PIDX(3, 7)] =
+	    (FQ(7, 9) *
+	     (FV(3, 9) * D[PIDX(9, 9)] + FV(3, 6) * D[PIDX(6, 9)] + FV(3, 7) * D[PIDX(7, 9)] +
+	      FV(3, 8) * D[PIDX(8, 9)]) + FQ(7, 10) * (FV(3, 9) * D[PIDX(9, 10)] +
+					       FV(3, 6) * D[PIDX(6, 10)] +
+					       FV(3, 7) * D[PIDX(7, 10)] +
+					       FV(3, 8) * D[PIDX(8, 10)]) +
+	     FQ(7, 11) * (FV(3, 9) * D[PIDX(9, 11)] + FV(3, 6) * D[PIDX(6, 11)] +
+			 FV(3, 7) * D[PIDX(7, 11)] + FV(3, 8) * D[PIDX(8, 11)]) +
+	     FQ(7, 12) * (FV(3, 9) * D[PIDX(9, 12)] + FV(3, 6) * D[PIDX(6, 12)] +
+			 FV(3, 7) * D[PIDX(7, 12)] + FV(3, 8) * D[PIDX(8, 12)]) +
+	     FQ(7, 6) * (FV(3, 6) * D[PIDX(6, 6)] + FV(3, 7) * D[PIDX(6, 7)] +
+			FV(3, 8) * D[PIDX(6, 8)] + FV(3, 9) * D[PIDX(6, 9)]) +
+	     FQ(7, 8) * (FV(3, 6) * D[PIDX(6, 8)] + FV(3, 7) * D[PIDX(7, 8)] +
+			FV(3, 8) * D[PIDX(8, 8)] + FV(3, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (FV(3, 6) * D[PIDX(6, 7)] + FQ(7, 6) * D[PIDX(3, 6)] + FV(3, 7) * D[PIDX(7, 7)] +
+	     FV(3, 8) * D[PIDX(7, 8)] + FQ(7, 8) * D[PIDX(3, 8)] + FV(3, 9) * D[PIDX(7, 9)] +
+	     FQ(7, 9) * D[PIDX(3, 9)] + FQ(7, 10) * D[PIDX(3, 10)] +
+	     FQ(7, 11) * D[PIDX(3, 11)] + FQ(7, 12) * D[PIDX(3, 12)]) * T + D[PIDX(3, 7)];
+	P[PIDX(3, 8)] =
+	    (FQ(8, 9) *
+	     (FV(3, 9) * D[PIDX(9, 9)] + FV(3, 6) * D[PIDX(6, 9)] + FV(3, 7) * D[PIDX(7, 9)] +
+	      FV(3, 8) * D[PIDX(8, 9)]) + FQ(8, 10) * (FV(3, 9) * D[PIDX(9, 10)] +
+					       FV(3, 6) * D[PIDX(6, 10)] +
+					       FV(3, 7) * D[PIDX(7, 10)] +
+					       FV(3, 8) * D[PIDX(8, 10)]) +
+	     FQ(8, 11) * (FV(3, 9) * D[PIDX(9, 11)] + FV(3, 6) * D[PIDX(6, 11)] +
+			 FV(3, 7) * D[PIDX(7, 11)] + FV(3, 8) * D[PIDX(8, 11)]) +
+	     FQ(8, 12) * (FV(3, 9) * D[PIDX(9, 12)] + FV(3, 6) * D[PIDX(6, 12)] +
+			 FV(3, 7) * D[PIDX(7, 12)] + FV(3, 8) * D[PIDX(8, 12)]) +
+	     FQ(8, 6) * (FV(3, 6) * D[PIDX(6, 6)] + FV(3, 7) * D[PIDX(6, 7)] +
+			FV(3, 8) * D[PIDX(6, 8)] + FV(3, 9) * D[PIDX(6, 9)]) +
+	     FQ(8, 7) * (FV(3, 6) * D[PIDX(6, 7)] + FV(3, 7) * D[PIDX(7, 7)] +
+			FV(3, 8) * D[PIDX(7, 8)] + FV(3, 9) * D[PIDX(7, 9)])) * Tsq +
+	    (FV(3, 6) * D[PIDX(6, 8)] + FV(3, 7) * D[PIDX(7, 8)] + FQ(8, 6) * D[PIDX(3, 6)] +
+	     FQ(8, 7) * D[PIDX(3, 7)] + FV(3, 8) * D[PIDX(8, 8)] + FV(3, 9) * D[PIDX(8, 9)] +
+	     FQ(8, 9) * D[PIDX(3, 9)] + FQ(8, 10) * D[PIDX(3, 10)] +
+	     FQ(8, 11) * D[PIDX(3, 11)] + FQ(8, 12) * D[PIDX(3, 12)]) * T + D[PIDX(3, 8)];
+	P[PIDX(3, 9)] =
+	    (FQ(9, 10) *
+	     (FV(3, 9) * D[PIDX(9, 10)] + FV(3, 6) * D[PIDX(6, 10)] +
+	      FV(3, 7) * D[PIDX(7, 10)] + FV(3, 8) * D[PIDX(8, 10)]) +
+	     FQ(9, 11) * (FV(3, 9) * D[PIDX(9, 11)] + FV(3, 6) * D[PIDX(6, 11)] +
+			 FV(3, 7) * D[PIDX(7, 11)] + FV(3, 8) * D[PIDX(8, 11)]) +
+	     FQ(9, 12) * (FV(3, 9) * D[PIDX(9, 12)] + FV(3, 6) * D[PIDX(6, 12)] +
+			 FV(3, 7) * D[PIDX(7, 12)] + FV(3, 8) * D[PIDX(8, 12)]) +
+	     FQ(9, 6) * (FV(3, 6) * D[PIDX(6, 6)] + FV(3, 7) * D[PIDX(6, 7)] +
+			FV(3, 8) * D[PIDX(6, 8)] + FV(3, 9) * D[PIDX(6, 9)]) +
+	     FQ(9, 7) * (FV(3, 6) * D[PIDX(6, 7)] + FV(3, 7) * D[PIDX(7, 7)] +
+			FV(3, 8) * D[PIDX(7, 8)] + FV(3, 9) * D[PIDX(7, 9)]) +
+	     FQ(9, 8) * (FV(3, 6) * D[PIDX(6, 8)] + FV(3, 7) * D[PIDX(7, 8)] +
+			FV(3, 8) * D[PIDX(8, 8)] + FV(3, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (FQ(9, 6) * D[PIDX(3, 6)] + FQ(9, 7) * D[PIDX(3, 7)] + FQ(9, 8) * D[PIDX(3, 8)] +
+	     FV(3, 9) * D[PIDX(9, 9)] + FQ(9, 10) * D[PIDX(3, 10)] +
+	     FQ(9, 11) * D[PIDX(3, 11)] + FQ(9, 12) * D[PIDX(3, 12)] +
+	     FV(3, 6) * D[PIDX(6, 9)] + FV(3, 7) * D[PIDX(7, 9)] +
+	     FV(3, 8) * D[PIDX(8, 9)]) * T + D[PIDX(3, 9)];
+	P[PIDX(3, 10)] =
+	    (FV(3, 9) * D[PIDX(9, 10)] + FV(3, 6) * D[PIDX(6, 10)] + FV(3, 7) * D[PIDX(7, 10)] +
+	     FV(3, 8) * D[PIDX(8, 10)]) * T + D[PIDX(3, 10)];
+	P[PIDX(3, 11)] =
+	    (FV(3, 9) * D[PIDX(9, 11)] + FV(3, 6) * D[PIDX(6, 11)] + FV(3, 7) * D[PIDX(7, 11)] +
+	     FV(3, 8) * D[PIDX(8, 11)]) * T + D[PIDX(3, 11)];
+	P[PIDX(3, 12)] =
+	    (FV(3, 9) * D[PIDX(9, 12)] + FV(3, 6) * D[PIDX(6, 12)] + FV(3, 7) * D[PIDX(7, 12)] +
+	     FV(3, 8) * D[PIDX(8, 12)]) * T + D[PIDX(3, 12)];
+	P[PIDX(4, 4)] =
+	    (Q[3] * GV(4, 3) * GV(4, 3) + Q[4] * GV(4, 4) * GV(4, 4) +
+	     Q[5] * GV(4, 5) * GV(4, 5) + FV(4, 9) * (FV(4, 9) * D[PIDX(9, 9)] +
+						   FV(4, 6) * D[PIDX(6, 9)] +
+						   FV(4, 7) * D[PIDX(7, 9)] +
+						   FV(4, 8) * D[PIDX(8, 9)]) +
+	     FV(4, 6) * (FV(4, 6) * D[PIDX(6, 6)] + FV(4, 7) * D[PIDX(6, 7)] +
+			FV(4, 8) * D[PIDX(6, 8)] + FV(4, 9) * D[PIDX(6, 9)]) +
+	     FV(4, 7) * (FV(4, 6) * D[PIDX(6, 7)] + FV(4, 7) * D[PIDX(7, 7)] +
+			FV(4, 8) * D[PIDX(7, 8)] + FV(4, 9) * D[PIDX(7, 9)]) +
+	     FV(4, 8) * (FV(4, 6) * D[PIDX(6, 8)] + FV(4, 7) * D[PIDX(7, 8)] +
+			FV(4, 8) * D[PIDX(8, 8)] + FV(4, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (2 * FV(4, 6) * D[PIDX(4, 6)] + 2 * FV(4, 7) * D[PIDX(4, 7)] +
+	     2 * FV(4, 8) * D[PIDX(4, 8)] + 2 * FV(4, 9) * D[PIDX(4, 9)]) * T + D[PIDX(4, 4)];
+	P[PIDX(4, 5)] =
+	    (FV(5, 9) *
+	     (FV(4, 9) * D[PIDX(9, 9)] + FV(4, 6) * D[PIDX(6, 9)] + FV(4, 7) * D[PIDX(7, 9)] +
+	      FV(4, 8) * D[PIDX(8, 9)]) + FV(5, 6) * (FV(4, 6) * D[PIDX(6, 6)] +
+					      FV(4, 7) * D[PIDX(6, 7)] +
+					      FV(4, 8) * D[PIDX(6, 8)] +
+					      FV(4, 9) * D[PIDX(6, 9)]) +
+	     FV(5, 7) * (FV(4, 6) * D[PIDX(6, 7)] + FV(4, 7) * D[PIDX(7, 7)] +
+			FV(4, 8) * D[PIDX(7, 8)] + FV(4, 9) * D[PIDX(7, 9)]) +
+	     FV(5, 8) * (FV(4, 6) * D[PIDX(6, 8)] + FV(4, 7) * D[PIDX(7, 8)] +
+			FV(4, 8) * D[PIDX(8, 8)] + FV(4, 9) * D[PIDX(8, 9)]) +
+	     GV(4, 3) * GV(5, 3) * Q[3] + GV(4, 4) * GV(5, 4) * Q[4] +
+	     GV(4, 5) * GV(5, 5) * Q[5]) * Tsq + (FV(4, 6) * D[PIDX(5, 6)] +
+						FV(5, 6) * D[PIDX(4, 6)] +
+						FV(4, 7) * D[PIDX(5, 7)] +
+						FV(5, 7) * D[PIDX(4, 7)] +
+						FV(4, 8) * D[PIDX(5, 8)] +
+						FV(5, 8) * D[PIDX(4, 8)] +
+						FV(4, 9) * D[PIDX(5, 9)] +
+						FV(5, 9) * D[PIDX(4, 9)]) * T +
+	    D[PIDX(4, 5)];
+	P[PIDX(4, 6)] =
+	    (FQ(6, 9) *
+	     (FV(4, 9) * D[PIDX(9, 9)] + FV(4, 6) * D[PIDX(6, 9)] + FV(4, 7) * D[PIDX(7, 9)] +
+	      FV(4, 8) * D[PIDX(8, 9)]) + FQ(6, 10) * (FV(4, 9) * D[PIDX(9, 10)] +
+					       FV(4, 6) * D[PIDX(6, 10)] +
+					       FV(4, 7) * D[PIDX(7, 10)] +
+					       FV(4, 8) * D[PIDX(8, 10)]) +
+	     FQ(6, 11) * (FV(4, 9) * D[PIDX(9, 11)] + FV(4, 6) * D[PIDX(6, 11)] +
+			 FV(4, 7) * D[PIDX(7, 11)] + FV(4, 8) * D[PIDX(8, 11)]) +
+	     FQ(6, 12) * (FV(4, 9) * D[PIDX(9, 12)] + FV(4, 6) * D[PIDX(6, 12)] +
+			 FV(4, 7) * D[PIDX(7, 12)] + FV(4, 8) * D[PIDX(8, 12)]) +
+	     FQ(6, 7) * (FV(4, 6) * D[PIDX(6, 7)] + FV(4, 7) * D[PIDX(7, 7)] +
+			FV(4, 8) * D[PIDX(7, 8)] + FV(4, 9) * D[PIDX(7, 9)]) +
+	     FQ(6, 8) * (FV(4, 6) * D[PIDX(6, 8)] + FV(4, 7) * D[PIDX(7, 8)] +
+			FV(4, 8) * D[PIDX(8, 8)] + FV(4, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (FV(4, 6) * D[PIDX(6, 6)] + FV(4, 7) * D[PIDX(6, 7)] + FQ(6, 7) * D[PIDX(4, 7)] +
+	     FV(4, 8) * D[PIDX(6, 8)] + FQ(6, 8) * D[PIDX(4, 8)] + FV(4, 9) * D[PIDX(6, 9)] +
+	     FQ(6, 9) * D[PIDX(4, 9)] + FQ(6, 10) * D[PIDX(4, 10)] +
+	     FQ(6, 11) * D[PIDX(4, 11)] + FQ(6, 12) * D[PIDX(4, 12)]) * T + D[PIDX(4, 6)];
+	P[PIDX(4, 7)] =
+	    (FQ(7, 9) *
+	     (FV(4, 9) * D[PIDX(9, 9)] + FV(4, 6) * D[PIDX(6, 9)] + FV(4, 7) * D[PIDX(7, 9)] +
+	      FV(4, 8) * D[PIDX(8, 9)]) + FQ(7, 10) * (FV(4, 9) * D[PIDX(9, 10)] +
+					       FV(4, 6) * D[PIDX(6, 10)] +
+					       FV(4, 7) * D[PIDX(7, 10)] +
+					       FV(4, 8) * D[PIDX(8, 10)]) +
+	     FQ(7, 11) * (FV(4, 9) * D[PIDX(9, 11)] + FV(4, 6) * D[PIDX(6, 11)] +
+			 FV(4, 7) * D[PIDX(7, 11)] + FV(4, 8) * D[PIDX(8, 11)]) +
+	     FQ(7, 12) * (FV(4, 9) * D[PIDX(9, 12)] + FV(4, 6) * D[PIDX(6, 12)] +
+			 FV(4, 7) * D[PIDX(7, 12)] + FV(4, 8) * D[PIDX(8, 12)]) +
+	     FQ(7, 6) * (FV(4, 6) * D[PIDX(6, 6)] + FV(4, 7) * D[PIDX(6, 7)] +
+			FV(4, 8) * D[PIDX(6, 8)] + FV(4, 9) * D[PIDX(6, 9)]) +
+	     FQ(7, 8) * (FV(4, 6) * D[PIDX(6, 8)] + FV(4, 7) * D[PIDX(7, 8)] +
+			FV(4, 8) * D[PIDX(8, 8)] + FV(4, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (FV(4, 6) * D[PIDX(6, 7)] + FQ(7, 6) * D[PIDX(4, 6)] + FV(4, 7) * D[PIDX(7, 7)] +
+	     FV(4, 8) * D[PIDX(7, 8)] + FQ(7, 8) * D[PIDX(4, 8)] + FV(4, 9) * D[PIDX(7, 9)] +
+	     FQ(7, 9) * D[PIDX(4, 9)] + FQ(7, 10) * D[PIDX(4, 10)] +
+	     FQ(7, 11) * D[PIDX(4, 11)] + FQ(7, 12) * D[PIDX(4, 12)]) * T + D[PIDX(4, 7)];
+	P[PIDX(4, 8)] =
+	    (FQ(8, 9) *
+	     (FV(4, 9) * D[PIDX(9, 9)] + FV(4, 6) * D[PIDX(6, 9)] + FV(4, 7) * D[PIDX(7, 9)] +
+	      FV(4, 8) * D[PIDX(8, 9)]) + FQ(8, 10) * (FV(4, 9) * D[PIDX(9, 10)] +
+					       FV(4, 6) * D[PIDX(6, 10)] +
+					       FV(4, 7) * D[PIDX(7, 10)] +
+					       FV(4, 8) * D[PIDX(8, 10)]) +
+	     FQ(8, 11) * (FV(4, 9) * D[PIDX(9, 11)] + FV(4, 6) * D[PIDX(6, 11)] +
+			 FV(4, 7) * D[PIDX(7, 11)] + FV(4, 8) * D[PIDX(8, 11)]) +
+	     FQ(8, 12) * (FV(4, 9) * D[PIDX(9, 12)] + FV(4, 6) * D[PIDX(6, 12)] +
+			 FV(4, 7) * D[PIDX(7, 12)] + FV(4, 8) * D[PIDX(8, 12)]) +
+	     FQ(8, 6) * (FV(4, 6) * D[PIDX(6, 6)] + FV(4, 7) * D[PIDX(6, 7)] +
+			FV(4, 8) * D[PIDX(6, 8)] + FV(4, 9) * D[PIDX(6, 9)]) +
+	     FQ(8, 7) * (FV(4, 6) * D[PIDX(6, 7)] + FV(4, 7) * D[PIDX(7, 7)] +
+			FV(4, 8) * D[PIDX(7, 8)] + FV(4, 9) * D[PIDX(7, 9)])) * Tsq +
+	    (FV(4, 6) * D[PIDX(6, 8)] + FV(4, 7) * D[PIDX(7, 8)] + FQ(8, 6) * D[PIDX(4, 6)] +
+	     FQ(8, 7) * D[PIDX(4, 7)] + FV(4, 8) * D[PIDX(8, 8)] + FV(4, 9) * D[PIDX(8, 9)] +
+	     FQ(8, 9) * D[PIDX(4, 9)] + FQ(8, 10) * D[PIDX(4, 10)] +
+	     FQ(8, 11) * D[PIDX(4, 11)] + FQ(8, 12) * D[PIDX(4, 12)]) * T + D[PIDX(4, 8)];
+	P[PIDX(4, 9)] =
+	    (FQ(9, 10) *
+	     (FV(4, 9) * D[PIDX(9, 10)] + FV(4, 6) * D[PIDX(6, 10)] +
+	      FV(4, 7) * D[PIDX(7, 10)] + FV(4, 8) * D[PIDX(8, 10)]) +
+	     FQ(9, 11) * (FV(4, 9) * D[PIDX(9, 11)] + FV(4, 6) * D[PIDX(6, 11)] +
+			 FV(4, 7) * D[PIDX(7, 11)] + FV(4, 8) * D[PIDX(8, 11)]) +
+	     FQ(9, 12) * (FV(4, 9) * D[PIDX(9, 12)] + FV(4, 6) * D[PIDX(6, 12)] +
+			 FV(4, 7) * D[PIDX(7, 12)] + FV(4, 8) * D[PIDX(8, 12)]) +
+	     FQ(9, 6) * (FV(4, 6) * D[PIDX(6, 6)] + FV(4, 7) * D[PIDX(6, 7)] +
+			FV(4, 8) * D[PIDX(6, 8)] + FV(4, 9) * D[PIDX(6, 9)]) +
+	     FQ(9, 7) * (FV(4, 6) * D[PIDX(6, 7)] + FV(4, 7) * D[PIDX(7, 7)] +
+			FV(4, 8) * D[PIDX(7, 8)] + FV(4, 9) * D[PIDX(7, 9)]) +
+	     FQ(9, 8) * (FV(4, 6) * D[PIDX(6, 8)] + FV(4, 7) * D[PIDX(7, 8)] +
+			FV(4, 8) * D[PIDX(8, 8)] + FV(4, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (FQ(9, 6) * D[PIDX(4, 6)] + FQ(9, 7) * D[PIDX(4, 7)] + FQ(9, 8) * D[PIDX(4, 8)] +
+	     FV(4, 9) * D[PIDX(9, 9)] + FQ(9, 10) * D[PIDX(4, 10)] +
+	     FQ(9, 11) * D[PIDX(4, 11)] + FQ(9, 12) * D[PIDX(4, 12)] +
+	     FV(4, 6) * D[PIDX(6, 9)] + FV(4, 7) * D[PIDX(7, 9)] +
+	     FV(4, 8) * D[PIDX(8, 9)]) * T + D[PIDX(4, 9)];
+	P[PIDX(4, 10)] =
+	    (FV(4, 9) * D[PIDX(9, 10)] + FV(4, 6) * D[PIDX(6, 10)] + FV(4, 7) * D[PIDX(7, 10)] +
+	     FV(4, 8) * D[PIDX(8, 10)]) * T + D[PIDX(4, 10)];
+	P[PIDX(4, 11)] =
+	    (FV(4, 9) * D[PIDX(9, 11)] + FV(4, 6) * D[PIDX(6, 11)] + FV(4, 7) * D[PIDX(7, 11)] +
+	     FV(4, 8) * D[PIDX(8, 11)]) * T + D[PIDX(4, 11)];
+	P[PIDX(4, 12)] =
+	    (FV(4, 9) * D[PIDX(9, 12)] + FV(4, 6) * D[PIDX(6, 12)] + FV(4, 7) * D[PIDX(7, 12)] +
+	     FV(4, 8) * D[PIDX(8, 12)]) * T + D[PIDX(4, 12)];
+	P[PIDX(5, 5)] =
+	    (Q[3] * GV(5, 3) * GV(5, 3) + Q[4] * GV(5, 4) * GV(5, 4) +
+	     Q[5] * GV(5, 5) * GV(5, 5) + FV(5, 9) * (FV(5, 9) * D[PIDX(9, 9)] +
+						   FV(5, 6) * D[PIDX(6, 9)] +
+						   FV(5, 7) * D[PIDX(7, 9)] +
+						   FV(5, 8) * D[PIDX(8, 9)]) +
+	     FV(5, 6) * (FV(5, 6) * D[PIDX(6, 6)] + FV(5, 7) * D[PIDX(6, 7)] +
+			FV(5, 8) * D[PIDX(6, 8)] + FV(5, 9) * D[PIDX(6, 9)]) +
+	     FV(5, 7) * (FV(5, 6) * D[PIDX(6, 7)] + FV(5, 7) * D[PIDX(7, 7)] +
+			FV(5, 8) * D[PIDX(7, 8)] + FV(5, 9) * D[PIDX(7, 9)]) +
+	     FV(5, 8) * (FV(5, 6) * D[PIDX(6, 8)] + FV(5, 7) * D[PIDX(7, 8)] +
+			FV(5, 8) * D[PIDX(8, 8)] + FV(5, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (2 * FV(5, 6) * D[PIDX(5, 6)] + 2 * FV(5, 7) * D[PIDX(5, 7)] +
+	     2 * FV(5, 8) * D[PIDX(5, 8)] + 2 * FV(5, 9) * D[PIDX(5, 9)]) * T + D[PIDX(5, 5)];
+	P[PIDX(5, 6)] =
+	    (FQ(6, 9) *
+	     (FV(5, 9) * D[PIDX(9, 9)] + FV(5, 6) * D[PIDX(6, 9)] + FV(5, 7) * D[PIDX(7, 9)] +
+	      FV(5, 8) * D[PIDX(8, 9)]) + FQ(6, 10) * (FV(5, 9) * D[PIDX(9, 10)] +
+					       FV(5, 6) * D[PIDX(6, 10)] +
+					       FV(5, 7) * D[PIDX(7, 10)] +
+					       FV(5, 8) * D[PIDX(8, 10)]) +
+	     FQ(6, 11) * (FV(5, 9) * D[PIDX(9, 11)] + FV(5, 6) * D[PIDX(6, 11)] +
+			 FV(5, 7) * D[PIDX(7, 11)] + FV(5, 8) * D[PIDX(8, 11)]) +
+	     FQ(6, 12) * (FV(5, 9) * D[PIDX(9, 12)] + FV(5, 6) * D[PIDX(6, 12)] +
+			 FV(5, 7) * D[PIDX(7, 12)] + FV(5, 8) * D[PIDX(8, 12)]) +
+	     FQ(6, 7) * (FV(5, 6) * D[PIDX(6, 7)] + FV(5, 7) * D[PIDX(7, 7)] +
+			FV(5, 8) * D[PIDX(7, 8)] + FV(5, 9) * D[PIDX(7, 9)]) +
+	     FQ(6, 8) * (FV(5, 6) * D[PIDX(6, 8)] + FV(5, 7) * D[PIDX(7, 8)] +
+			FV(5, 8) * D[PIDX(8, 8)] + FV(5, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (FV(5, 6) * D[PIDX(6, 6)] + FV(5, 7) * D[PIDX(6, 7)] + FQ(6, 7) * D[PIDX(5, 7)] +
+	     FV(5, 8) * D[PIDX(6, 8)] + FQ(6, 8) * D[PIDX(5, 8)] + FV(5, 9) * D[PIDX(6, 9)] +
+	     FQ(6, 9) * D[PIDX(5, 9)] + FQ(6, 10) * D[PIDX(5, 10)] +
+	     FQ(6, 11) * D[PIDX(5, 11)] + FQ(6, 12) * D[PIDX(5, 12)]) * T + D[PIDX(5, 6)];
+	P[PIDX(5, 7)] =
+	    (FQ(7, 9) *
+	     (FV(5, 9) * D[PIDX(9, 9)] + FV(5, 6) * D[PIDX(6, 9)] + FV(5, 7) * D[PIDX(7, 9)] +
+	      FV(5, 8) * D[PIDX(8, 9)]) + FQ(7, 10) * (FV(5, 9) * D[PIDX(9, 10)] +
+					       FV(5, 6) * D[PIDX(6, 10)] +
+					       FV(5, 7) * D[PIDX(7, 10)] +
+					       FV(5, 8) * D[PIDX(8, 10)]) +
+	     FQ(7, 11) * (FV(5, 9) * D[PIDX(9, 11)] + FV(5, 6) * D[PIDX(6, 11)] +
+			 FV(5, 7) * D[PIDX(7, 11)] + FV(5, 8) * D[PIDX(8, 11)]) +
+	     FQ(7, 12) * (FV(5, 9) * D[PIDX(9, 12)] + FV(5, 6) * D[PIDX(6, 12)] +
+			 FV(5, 7) * D[PIDX(7, 12)] + FV(5, 8) * D[PIDX(8, 12)]) +
+	     FQ(7, 6) * (FV(5, 6) * D[PIDX(6, 6)] + FV(5, 7) * D[PIDX(6, 7)] +
+			FV(5, 8) * D[PIDX(6, 8)] + FV(5, 9) * D[PIDX(6, 9)]) +
+	     FQ(7, 8) * (FV(5, 6) * D[PIDX(6, 8)] + FV(5, 7) * D[PIDX(7, 8)] +
+			FV(5, 8) * D[PIDX(8, 8)] + FV(5, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (FV(5, 6) * D[PIDX(6, 7)] + FQ(7, 6) * D[PIDX(5, 6)] + FV(5, 7) * D[PIDX(7, 7)] +
+	     FV(5, 8) * D[PIDX(7, 8)] + FQ(7, 8) * D[PIDX(5, 8)] + FV(5, 9) * D[PIDX(7, 9)] +
+	     FQ(7, 9) * D[PIDX(5, 9)] + FQ(7, 10) * D[PIDX(5, 10)] +
+	     FQ(7, 11) * D[PIDX(5, 11)] + FQ(7, 12) * D[PIDX(5, 12)]) * T + D[PIDX(5, 7)];
+	P[PIDX(5, 8)] =
+	    (FQ(8, 9) *
+	     (FV(5, 9) * D[PIDX(9, 9)] + FV(5, 6) * D[PIDX(6, 9)] + FV(5, 7) * D[PIDX(7, 9)] +
+	      FV(5, 8) * D[PIDX(8, 9)]) + FQ(8, 10) * (FV(5, 9) * D[PIDX(9, 10)] +
+					       FV(5, 6) * D[PIDX(6, 10)] +
+					       FV(5, 7) * D[PIDX(7, 10)] +
+					       FV(5, 8) * D[PIDX(8, 10)]) +
+	     FQ(8, 11) * (FV(5, 9) * D[PIDX(9, 11)] + FV(5, 6) * D[PIDX(6, 11)] +
+			 FV(5, 7) * D[PIDX(7, 11)] + FV(5, 8) * D[PIDX(8, 11)]) +
+	     FQ(8, 12) * (FV(5, 9) * D[PIDX(9, 12)] + FV(5, 6) * D[PIDX(6, 12)] +
+			 FV(5, 7) * D[PIDX(7, 12)] + FV(5, 8) * D[PIDX(8, 12)]) +
+	     FQ(8, 6) * (FV(5, 6) * D[PIDX(6, 6)] + FV(5, 7) * D[PIDX(6, 7)] +
+			FV(5, 8) * D[PIDX(6, 8)] + FV(5, 9) * D[PIDX(6, 9)]) +
+	     FQ(8, 7) * (FV(5, 6) * D[PIDX(6, 7)] + FV(5, 7) * D[PIDX(7, 7)] +
+			FV(5, 8) * D[PIDX(7, 8)] + FV(5, 9) * D[PIDX(7, 9)])) * Tsq +
+	    (FV(5, 6) * D[PIDX(6, 8)] + FV(5, 7) * D[PIDX(7, 8)] + FQ(8, 6) * D[PIDX(5, 6)] +
+	     FQ(8, 7) * D[PIDX(5, 7)] + FV(5, 8) * D[PIDX(8, 8)] + FV(5, 9) * D[PIDX(8, 9)] +
+	     FQ(8, 9) * D[PIDX(5, 9)] + FQ(8, 10) * D[PIDX(5, 10)] +
+	     FQ(8, 11) * D[PIDX(5, 11)] + FQ(8, 12) * D[PIDX(5, 12)]) * T + D[PIDX(5, 8)];
+	P[PIDX(5, 9)] =
+	    (FQ(9, 10) *
+	     (FV(5, 9) * D[PIDX(9, 10)] + FV(5, 6) * D[PIDX(6, 10)] +
+	      FV(5, 7) * D[PIDX(7, 10)] + FV(5, 8) * D[PIDX(8, 10)]) +
+	     FQ(9, 11) * (FV(5, 9) * D[PIDX(9, 11)] + FV(5, 6) * D[PIDX(6, 11)] +
+			 FV(5, 7) * D[PIDX(7, 11)] + FV(5, 8) * D[PIDX(8, 11)]) +
+	     FQ(9, 12) * (FV(5, 9) * D[PIDX(9, 12)] + FV(5, 6) * D[PIDX(6, 12)] +
+			 FV(5, 7) * D[PIDX(7, 12)] + FV(5, 8) * D[PIDX(8, 12)]) +
+	     FQ(9, 6) * (FV(5, 6) * D[PIDX(6, 6)] + FV(5, 7) * D[PIDX(6, 7)] +
+			FV(5, 8) * D[PIDX(6, 8)] + FV(5, 9) * D[PIDX(6, 9)]) +
+	     FQ(9, 7) * (FV(5, 6) * D[PIDX(6, 7)] + FV(5, 7) * D[PIDX(7, 7)] +
+			FV(5, 8) * D[PIDX(7, 8)] + FV(5, 9) * D[PIDX(7, 9)]) +
+	     FQ(9, 8) * (FV(5, 6) * D[PIDX(6, 8)] + FV(5, 7) * D[PIDX(7, 8)] +
+			FV(5, 8) * D[PIDX(8, 8)] + FV(5, 9) * D[PIDX(8, 9)])) * Tsq +
+	    (FQ(9, 6) * D[PIDX(5, 6)] + FQ(9, 7) * D[PIDX(5, 7)] + FQ(9, 8) * D[PIDX(5, 8)] +
+	     FV(5, 9) * D[PIDX(9, 9)] + FQ(9, 10) * D[PIDX(5, 10)] +
+	     FQ(9, 11) * D[PIDX(5, 11)] + FQ(9, 12) * D[PIDX(5, 12)] +
+	     FV(5, 6) * D[PIDX(6, 9)] + FV(5, 7) * D[PIDX(7, 9)] +
+	     FV(5, 8) * D[PIDX(8, 9)]) * T + D[PIDX(5, 9)];
+	P[PIDX(5, 10)] =
+	    (FV(5, 9) * D[PIDX(9, 10)] + FV(5, 6) * D[PIDX(6, 10)] + FV(5, 7) * D[PIDX(7, 10)] +
+	     FV(5, 8) * D[PIDX(8, 10)]) * T + D[PIDX(5, 10)];
+	P[PIDX(5, 11)] =
+	    (FV(5, 9) * D[PIDX(9, 11)] + FV(5, 6) * D[PIDX(6, 11)] + FV(5, 7) * D[PIDX(7, 11)] +
+	     FV(5, 8) * D[PIDX(8, 11)]) * T + D[PIDX(5, 11)];
+	P[PIDX(5, 12)] =
+	    (FV(5, 9) * D[PIDX(9, 12)] + FV(5, 6) * D[PIDX(6, 12)] + FV(5, 7) * D[PIDX(7, 12)] +
+	     FV(5, 8) * D[PIDX(8, 12)]) * T + D[PIDX(5, 12)];
+	P[PIDX(6, 6)] =
+	    (Q[0] * GQ(6, 0) * GQ(6, 0) + Q[1] * GQ(6, 1) * GQ(6, 1) +
+	     Q[2] * GQ(6, 2) * GQ(6, 2) + FQ(6, 9) * (FQ(6, 9) * D[PIDX(9, 9)] +
+						   FQ(6, 10) * D[PIDX(9, 10)] +
+						   FQ(6, 11) * D[PIDX(9, 11)] +
+						   FQ(6, 12) * D[PIDX(9, 12)] +
+						   FQ(6, 7) * D[PIDX(7, 9)] +
+						   FQ(6, 8) * D[PIDX(8, 9)]) +
+	     FQ(6, 10) * (FQ(6, 9) * D[PIDX(9, 10)] + FQ(6, 10) * D[PIDX(10, 10)] +
+			 FQ(6, 11) * D[PIDX(10, 11)] + FQ(6, 12) * D[PIDX(10, 12)] +
+			 FQ(6, 7) * D[PIDX(7, 10)] + FQ(6, 8) * D[PIDX(8, 10)]) +
+	     FQ(6, 11) * (FQ(6, 9) * D[PIDX(9, 11)] + FQ(6, 10) * D[PIDX(10, 11)] +
+			 FQ(6, 11) * D[PIDX(11, 11)] + FQ(6, 12) * D[PIDX(11, 12)] +
+			 FQ(6, 7) * D[PIDX(7, 11)] + FQ(6, 8) * D[PIDX(8, 11)]) +
+	     FQ(6, 12) * (FQ(6, 9) * D[PIDX(9, 12)] + FQ(6, 10) * D[PIDX(10, 12)] +
+			 FQ(6, 11) * D[PIDX(11, 12)] + FQ(6, 12) * D[PIDX(12, 12)] +
+			 FQ(6, 7) * D[PIDX(7, 12)] + FQ(6, 8) * D[PIDX(8, 12)]) +
+	     FQ(6, 7) * (FQ(6, 7) * D[PIDX(7, 7)] + FQ(6, 8) * D[PIDX(7, 8)] +
+			FQ(6, 9) * D[PIDX(7, 9)] + FQ(6, 10) * D[PIDX(7, 10)] +
+			FQ(6, 11) * D[PIDX(7, 11)] + FQ(6, 12) * D[PIDX(7, 12)]) +
+	     FQ(6, 8) * (FQ(6, 7) * D[PIDX(7, 8)] + FQ(6, 8) * D[PIDX(8, 8)] +
+			FQ(6, 9) * D[PIDX(8, 9)] + FQ(6, 10) * D[PIDX(8, 10)] +
+			FQ(6, 11) * D[PIDX(8, 11)] + FQ(6, 12) * D[PIDX(8, 12)])) * Tsq +
+	    (2 * FQ(6, 7) * D[PIDX(6, 7)] + 2 * FQ(6, 8) * D[PIDX(6, 8)] +
+	     2 * FQ(6, 9) * D[PIDX(6, 9)] + 2 * FQ(6, 10) * D[PIDX(6, 10)] +
+	     2 * FQ(6, 11) * D[PIDX(6, 11)] + 2 * FQ(6, 12) * D[PIDX(6, 12)]) * T +
+	    D[PIDX(6, 6)];
+	P[PIDX(6, 7)] =
+	    (FQ(7, 9) *
+	     (FQ(6, 9) * D[PIDX(9, 9)] + FQ(6, 10) * D[PIDX(9, 10)] +
+	      FQ(6, 11) * D[PIDX(9, 11)] + FQ(6, 12) * D[PIDX(9, 12)] +
+	      FQ(6, 7) * D[PIDX(7, 9)] + FQ(6, 8) * D[PIDX(8, 9)]) +
+	     FQ(7, 10) * (FQ(6, 9) * D[PIDX(9, 10)] + FQ(6, 10) * D[PIDX(10, 10)] +
+			 FQ(6, 11) * D[PIDX(10, 11)] + FQ(6, 12) * D[PIDX(10, 12)] +
+			 FQ(6, 7) * D[PIDX(7, 10)] + FQ(6, 8) * D[PIDX(8, 10)]) +
+	     FQ(7, 11) * (FQ(6, 9) * D[PIDX(9, 11)] + FQ(6, 10) * D[PIDX(10, 11)] +
+			 FQ(6, 11) * D[PIDX(11, 11)] + FQ(6, 12) * D[PIDX(11, 12)] +
+			 FQ(6, 7) * D[PIDX(7, 11)] + FQ(6, 8) * D[PIDX(8, 11)]) +
+	     FQ(7, 12) * (FQ(6, 9) * D[PIDX(9, 12)] + FQ(6, 10) * D[PIDX(10, 12)] +
+			 FQ(6, 11) * D[PIDX(11, 12)] + FQ(6, 12) * D[PIDX(12, 12)] +
+			 FQ(6, 7) * D[PIDX(7, 12)] + FQ(6, 8) * D[PIDX(8, 12)]) +
+	     FQ(7, 6) * (FQ(6, 7) * D[PIDX(6, 7)] + FQ(6, 8) * D[PIDX(6, 8)] +
+			FQ(6, 9) * D[PIDX(6, 9)] + FQ(6, 10) * D[PIDX(6, 10)] +
+			FQ(6, 11) * D[PIDX(6, 11)] + FQ(6, 12) * D[PIDX(6, 12)]) +
+	     FQ(7, 8) * (FQ(6, 7) * D[PIDX(7, 8)] + FQ(6, 8) * D[PIDX(8, 8)] +
+			FQ(6, 9) * D[PIDX(8, 9)] + FQ(6, 10) * D[PIDX(8, 10)] +
+			FQ(6, 11) * D[PIDX(8, 11)] + FQ(6, 12) * D[PIDX(8, 12)]) +
+	     GQ(6, 0) * GQ(7, 0) * Q[0] + GQ(6, 1) * GQ(7, 1) * Q[1] +
+	     GQ(6, 2) * GQ(7, 2) * Q[2]) * Tsq + (FQ(7, 6) * D[PIDX(6, 6)] +
+						FQ(6, 7) * D[PIDX(7, 7)] +
+						FQ(6, 8) * D[PIDX(7, 8)] +
+						FQ(7, 8) * D[PIDX(6, 8)] +
+						FQ(6, 9) * D[PIDX(7, 9)] +
+						FQ(7, 9) * D[PIDX(6, 9)] +
+						FQ(6, 10) * D[PIDX(7, 10)] +
+						FQ(7, 10) * D[PIDX(6, 10)] +
+						FQ(6, 11) * D[PIDX(7, 11)] +
+						FQ(7, 11) * D[PIDX(6, 11)] +
+						FQ(6, 12) * D[PIDX(7, 12)] +
+						FQ(7, 12) * D[PIDX(6, 12)]) * T +
+	    D[PIDX(6, 7)];
+	P[PIDX(6, 8)] =
+	    (FQ(8, 9) *
+	     (FQ(6, 9) * D[PIDX(9, 9)] + FQ(6, 10) * D[PIDX(9, 10)] +
+	      FQ(6, 11) * D[PIDX(9, 11)] + FQ(6, 12) * D[PIDX(9, 12)] +
+	      FQ(6, 7) * D[PIDX(7, 9)] + FQ(6, 8) * D[PIDX(8, 9)]) +
+	     FQ(8, 10) * (FQ(6, 9) * D[PIDX(9, 10)] + FQ(6, 10) * D[PIDX(10, 10)] +
+			 FQ(6, 11) * D[PIDX(10, 11)] + FQ(6, 12) * D[PIDX(10, 12)] +
+			 FQ(6, 7) * D[PIDX(7, 10)] + FQ(6, 8) * D[PIDX(8, 10)]) +
+	     FQ(8, 11) * (FQ(6, 9) * D[PIDX(9, 11)] + FQ(6, 10) * D[PIDX(10, 11)] +
+			 FQ(6, 11) * D[PIDX(11, 11)] + FQ(6, 12) * D[PIDX(11, 12)] +
+			 FQ(6, 7) * D[PIDX(7, 11)] + FQ(6, 8) * D[PIDX(8, 11)]) +
+	     FQ(8, 12) * (FQ(6, 9) * D[PIDX(9, 12)] + FQ(6, 10) * D[PIDX(10, 12)] +
+			 FQ(6, 11) * D[PIDX(11, 12)] + FQ(6, 12) * D[PIDX(12, 12)] +
+			 FQ(6, 7) * D[PIDX(7, 12)] + FQ(6, 8) * D[PIDX(8, 12)]) +
+	     FQ(8, 6) * (FQ(6, 7) * D[PIDX(6, 7)] + FQ(6, 8) * D[PIDX(6, 8)] +
+			FQ(6, 9) * D[PIDX(6, 9)] + FQ(6, 10) * D[PIDX(6, 10)] +
+			FQ(6, 11) * D[PIDX(6, 11)] + FQ(6, 12) * D[PIDX(6, 12)]) +
+	     FQ(8, 7) * (FQ(6, 7) * D[PIDX(7, 7)] + FQ(6, 8) * D[PIDX(7, 8)] +
+			FQ(6, 9) * D[PIDX(7, 9)] + FQ(6, 10) * D[PIDX(7, 10)] +
+			FQ(6, 11) * D[PIDX(7, 11)] + FQ(6, 12) * D[PIDX(7, 12)]) +
+	     GQ(6, 0) * GQ(8, 0) * Q[0] + GQ(6, 1) * GQ(8, 1) * Q[1] +
+	     GQ(6, 2) * GQ(8, 2) * Q[2]) * Tsq + (FQ(6, 7) * D[PIDX(7, 8)] +
+						FQ(8, 6) * D[PIDX(6, 6)] +
+						FQ(8, 7) * D[PIDX(6, 7)] +
+						FQ(6, 8) * D[PIDX(8, 8)] +
+						FQ(6, 9) * D[PIDX(8, 9)] +
+						FQ(8, 9) * D[PIDX(6, 9)] +
+						FQ(6, 10) * D[PIDX(8, 10)] +
+						FQ(8, 10) * D[PIDX(6, 10)] +
+						FQ(6, 11) * D[PIDX(8, 11)] +
+						FQ(8, 11) * D[PIDX(6, 11)] +
+						FQ(6, 12) * D[PIDX(8, 12)] +
+						FQ(8, 12) * D[PIDX(6, 12)]) * T +
+	    D[PIDX(6, 8)];
+	P[PIDX(6, 9)] =
+	    (FQ(9, 10) *
+	     (FQ(6, 9) * D[PIDX(9, 10)] + FQ(6, 10) * D[PIDX(10, 10)] +
+	      FQ(6, 11) * D[PIDX(10, 11)] + FQ(6, 12) * D[PIDX(10, 12)] +
+	      FQ(6, 7) * D[PIDX(7, 10)] + FQ(6, 8) * D[PIDX(8, 10)]) +
+	     FQ(9, 11) * (FQ(6, 9) * D[PIDX(9, 11)] + FQ(6, 10) * D[PIDX(10, 11)] +
+			 FQ(6, 11) * D[PIDX(11, 11)] + FQ(6, 12) * D[PIDX(11, 12)] +
+			 FQ(6, 7) * D[PIDX(7, 11)] + FQ(6, 8) * D[PIDX(8, 11)]) +
+	     FQ(9, 12) * (FQ(6, 9) * D[PIDX(9, 12)] + FQ(6, 10) * D[PIDX(10, 12)] +
+			 FQ(6, 11) * D[PIDX(11, 12)] + FQ(6, 12) * D[PIDX(12, 12)] +
+			 FQ(6, 7) * D[PIDX(7, 12)] + FQ(6, 8) * D[PIDX(8, 12)]) +
+	     FQ(9, 6) * (FQ(6, 7) * D[PIDX(6, 7)] + FQ(6, 8) * D[PIDX(6, 8)] +
+			FQ(6, 9) * D[PIDX(6, 9)] + FQ(6, 10) * D[PIDX(6, 10)] +
+			FQ(6, 11) * D[PIDX(6, 11)] + FQ(6, 12) * D[PIDX(6, 12)]) +
+	     FQ(9, 7) * (FQ(6, 7) * D[PIDX(7, 7)] + FQ(6, 8) * D[PIDX(7, 8)] +
+			FQ(6, 9) * D[PIDX(7, 9)] + FQ(6, 10) * D[PIDX(7, 10)] +
+			FQ(6, 11) * D[PIDX(7, 11)] + FQ(6, 12) * D[PIDX(7, 12)]) +
+	     FQ(9, 8) * (FQ(6, 7) * D[PIDX(7, 8)] + FQ(6, 8) * D[PIDX(8, 8)] +
+			FQ(6, 9) * D[PIDX(8, 9)] + FQ(6, 10) * D[PIDX(8, 10)] +
+			FQ(6, 11) * D[PIDX(8, 11)] + FQ(6, 12) * D[PIDX(8, 12)]) +
+	     GQ(9, 0) * GQ(6, 0) * Q[0] + GQ(9, 1) * GQ(6, 1) * Q[1] +
+	     GQ(9, 2) * GQ(6, 2) * Q[2]) * Tsq + (FQ(9, 6) * D[PIDX(6, 6)] +
+						FQ(9, 7) * D[PIDX(6, 7)] +
+						FQ(9, 8) * D[PIDX(6, 8)] +
+						FQ(6, 9) * D[PIDX(9, 9)] +
+						FQ(9, 10) * D[PIDX(6, 10)] +
+						FQ(6, 10) * D[PIDX(9, 10)] +
+						FQ(9, 11) * D[PIDX(6, 11)] +
+						FQ(6, 11) * D[PIDX(9, 11)] +
+						FQ(9, 12) * D[PIDX(6, 12)] +
+						FQ(6, 12) * D[PIDX(9, 12)] +
+						FQ(6, 7) * D[PIDX(7, 9)] +
+						FQ(6, 8) * D[PIDX(8, 9)]) * T +
+	    D[PIDX(6, 9)];
+	P[PIDX(6, 10)] =
+	    (FQ(6, 9) * D[PIDX(9, 10)] + FQ(6, 10) * D[PIDX(10, 10)] +
+	     FQ(6, 11) * D[PIDX(10, 11)] + FQ(6, 12) * D[PIDX(10, 12)] +
+	     FQ(6, 7) * D[PIDX(7, 10)] + FQ(6, 8) * D[PIDX(8, 10)]) * T + D[PIDX(6, 10)];
+	P[PIDX(6, 11)] =
+	    (FQ(6, 9) * D[PIDX(9, 11)] + FQ(6, 10) * D[PIDX(10, 11)] +
+	     FQ(6, 11) * D[PIDX(11, 11)] + FQ(6, 12) * D[PIDX(11, 12)] +
+	     FQ(6, 7) * D[PIDX(7, 11)] + FQ(6, 8) * D[PIDX(8, 11)]) * T + D[PIDX(6, 11)];
+	P[PIDX(6, 12)] =
+	    (FQ(6, 9) * D[PIDX(9, 12)] + FQ(6, 10) * D[PIDX(10, 12)] +
+	     FQ(6, 11) * D[PIDX(11, 12)] + FQ(6, 12) * D[PIDX(12, 12)] +
+	     FQ(6, 7) * D[PIDX(7, 12)] + FQ(6, 8) * D[PIDX(8, 12)]) * T + D[PIDX(6, 12)];
+	P[PIDX(7, 7)] =
+	    (Q[0] * GQ(7, 0) * GQ(7, 0) + Q[1] * GQ(7, 1) * GQ(7, 1) +
+	     Q[2] * GQ(7, 2) * GQ(7, 2) + FQ(7, 9) * (FQ(7, 9) * D[PIDX(9, 9)] +
+						   FQ(7, 10) * D[PIDX(9, 10)] +
+						   FQ(7, 11) * D[PIDX(9, 11)] +
+						   FQ(7, 12) * D[PIDX(9, 12)] +
+						   FQ(7, 6) * D[PIDX(6, 9)] +
+						   FQ(7, 8) * D[PIDX(8, 9)]) +
+	     FQ(7, 10) * (FQ(7, 9) * D[PIDX(9, 10)] + FQ(7, 10) * D[PIDX(10, 10)] +
+			 FQ(7, 11) * D[PIDX(10, 11)] + FQ(7, 12) * D[PIDX(10, 12)] +
+			 FQ(7, 6) * D[PIDX(6, 10)] + FQ(7, 8) * D[PIDX(8, 10)]) +
+	     FQ(7, 11) * (FQ(7, 9) * D[PIDX(9, 11)] + FQ(7, 10) * D[PIDX(10, 11)] +
+			 FQ(7, 11) * D[PIDX(11, 11)] + FQ(7, 12) * D[PIDX(11, 12)] +
+			 FQ(7, 6) * D[PIDX(6, 11)] + FQ(7, 8) * D[PIDX(8, 11)]) +
+	     FQ(7, 12) * (FQ(7, 9) * D[PIDX(9, 12)] + FQ(7, 10) * D[PIDX(10, 12)] +
+			 FQ(7, 11) * D[PIDX(11, 12)] + FQ(7, 12) * D[PIDX(12, 12)] +
+			 FQ(7, 6) * D[PIDX(6, 12)] + FQ(7, 8) * D[PIDX(8, 12)]) +
+	     FQ(7, 6) * (FQ(7, 6) * D[PIDX(6, 6)] + FQ(7, 8) * D[PIDX(6, 8)] +
+			FQ(7, 9) * D[PIDX(6, 9)] + FQ(7, 10) * D[PIDX(6, 10)] +
+			FQ(7, 11) * D[PIDX(6, 11)] + FQ(7, 12) * D[PIDX(6, 12)]) +
+	     FQ(7, 8) * (FQ(7, 6) * D[PIDX(6, 8)] + FQ(7, 8) * D[PIDX(8, 8)] +
+			FQ(7, 9) * D[PIDX(8, 9)] + FQ(7, 10) * D[PIDX(8, 10)] +
+			FQ(7, 11) * D[PIDX(8, 11)] + FQ(7, 12) * D[PIDX(8, 12)])) * Tsq +
+	    (2 * FQ(7, 6) * D[PIDX(6, 7)] + 2 * FQ(7, 8) * D[PIDX(7, 8)] +
+	     2 * FQ(7, 9) * D[PIDX(7, 9)] + 2 * FQ(7, 10) * D[PIDX(7, 10)] +
+	     2 * FQ(7, 11) * D[PIDX(7, 11)] + 2 * FQ(7, 12) * D[PIDX(7, 12)]) * T +
+	    D[PIDX(7, 7)];
+	P[PIDX(7, 8)] =
+	    (FQ(8, 9) *
+	     (FQ(7, 9) * D[PIDX(9, 9)] + FQ(7, 10) * D[PIDX(9, 10)] +
+	      FQ(7, 11) * D[PIDX(9, 11)] + FQ(7, 12) * D[PIDX(9, 12)] +
+	      FQ(7, 6) * D[PIDX(6, 9)] + FQ(7, 8) * D[PIDX(8, 9)]) +
+	     FQ(8, 10) * (FQ(7, 9) * D[PIDX(9, 10)] + FQ(7, 10) * D[PIDX(10, 10)] +
+			 FQ(7, 11) * D[PIDX(10, 11)] + FQ(7, 12) * D[PIDX(10, 12)] +
+			 FQ(7, 6) * D[PIDX(6, 10)] + FQ(7, 8) * D[PIDX(8, 10)]) +
+	     FQ(8, 11) * (FQ(7, 9) * D[PIDX(9, 11)] + FQ(7, 10) * D[PIDX(10, 11)] +
+			 FQ(7, 11) * D[PIDX(11, 11)] + FQ(7, 12) * D[PIDX(11, 12)] +
+			 FQ(7, 6) * D[PIDX(6, 11)] + FQ(7, 8) * D[PIDX(8, 11)]) +
+	     FQ(8, 12) * (FQ(7, 9) * D[PIDX(9, 12)] + FQ(7, 10) * D[PIDX(10, 12)] +
+			 FQ(7, 11) * D[PIDX(11, 12)] + FQ(7, 12) * D[PIDX(12, 12)] +
+			 FQ(7, 6) * D[PIDX(6, 12)] + FQ(7, 8) * D[PIDX(8, 12)]) +
+	     FQ(8, 6) * (FQ(7, 6) * D[PIDX(6, 6)] + FQ(7, 8) * D[PIDX(6, 8)] +
+			FQ(7, 9) * D[PIDX(6, 9)] + FQ(7, 10) * D[PIDX(6, 10)] +
+			FQ(7, 11) * D[PIDX(6, 11)] + FQ(7, 12) * D[PIDX(6, 12)]) +
+	     FQ(8, 7) * (FQ(7, 6) * D[PIDX(6, 7)] + FQ(7, 8) * D[PIDX(7, 8)] +
+			FQ(7, 9) * D[PIDX(7, 9)] + FQ(7, 10) * D[PIDX(7, 10)] +
+			FQ(7, 11) * D[PIDX(7, 11)] + FQ(7, 12) * D[PIDX(7, 12)]) +
+	     GQ(7, 0) * GQ(8, 0) * Q[0] + GQ(7, 1) * GQ(8, 1) * Q[1] +
+	     GQ(7, 2) * GQ(8, 2) * Q[2]) * Tsq + (FQ(7, 6) * D[PIDX(6, 8)] +
+						FQ(8, 6) * D[PIDX(6, 7)] +
+						FQ(8, 7) * D[PIDX(7, 7)] +
+						FQ(7, 8) * D[PIDX(8, 8)] +
+						FQ(7, 9) * D[PIDX(8, 9)] +
+						FQ(8, 9) * D[PIDX(7, 9)] +
+						FQ(7, 10) * D[PIDX(8, 10)] +
+						FQ(8, 10) * D[PIDX(7, 10)] +
+						FQ(7, 11) * D[PIDX(8, 11)] +
+						FQ(8, 11) * D[PIDX(7, 11)] +
+						FQ(7, 12) * D[PIDX(8, 12)] +
+						FQ(8, 12) * D[PIDX(7, 12)]) * T +
+	    D[PIDX(7, 8)];
+	P[PIDX(7, 9)] =
+	    (FQ(9, 10) *
+	     (FQ(7, 9) * D[PIDX(9, 10)] + FQ(7, 10) * D[PIDX(10, 10)] +
+	      FQ(7, 11) * D[PIDX(10, 11)] + FQ(7, 12) * D[PIDX(10, 12)] +
+	      FQ(7, 6) * D[PIDX(6, 10)] + FQ(7, 8) * D[PIDX(8, 10)]) +
+	     FQ(9, 11) * (FQ(7, 9) * D[PIDX(9, 11)] + FQ(7, 10) * D[PIDX(10, 11)] +
+			 FQ(7, 11) * D[PIDX(11, 11)] + FQ(7, 12) * D[PIDX(11, 12)] +
+			 FQ(7, 6) * D[PIDX(6, 11)] + FQ(7, 8) * D[PIDX(8, 11)]) +
+	     FQ(9, 12) * (FQ(7, 9) * D[PIDX(9, 12)] + FQ(7, 10) * D[PIDX(10, 12)] +
+			 FQ(7, 11) * D[PIDX(11, 12)] + FQ(7, 12) * D[PIDX(12, 12)] +
+			 FQ(7, 6) * D[PIDX(6, 12)] + FQ(7, 8) * D[PIDX(8, 12)]) +
+	     FQ(9, 6) * (FQ(7, 6) * D[PIDX(6, 6)] + FQ(7, 8) * D[PIDX(6, 8)] +
+			FQ(7, 9) * D[PIDX(6, 9)] + FQ(7, 10) * D[PIDX(6, 10)] +
+			FQ(7, 11) * D[PIDX(6, 11)] + FQ(7, 12) * D[PIDX(6, 12)]) +
+	     FQ(9, 7) * (FQ(7, 6) * D[PIDX(6, 7)] + FQ(7, 8) * D[PIDX(7, 8)] +
+			FQ(7, 9) * D[PIDX(7, 9)] + FQ(7, 10) * D[PIDX(7, 10)] +
+			FQ(7, 11) * D[PIDX(7, 11)] + FQ(7, 12) * D[PIDX(7, 12)]) +
+	     FQ(9, 8) * (FQ(7, 6) * D[PIDX(6, 8)] + FQ(7, 8) * D[PIDX(8, 8)] +
+			FQ(7, 9) * D[PIDX(8, 9)] + FQ(7, 10) * D[PIDX(8, 10)] +
+			FQ(7, 11) * D[PIDX(8, 11)] + FQ(7, 12) * D[PIDX(8, 12)]) +
+	     GQ(9, 0) * GQ(7, 0) * Q[0] + GQ(9, 1) * GQ(7, 1) * Q[1] +
+	     GQ(9, 2) * GQ(7, 2) * Q[2]) * Tsq + (FQ(9, 6) * D[PIDX(6, 7)] +
+						FQ(9, 7) * D[PIDX(7, 7)] +
+						FQ(9, 8) * D[PIDX(7, 8)] +
+						FQ(7, 9) * D[PIDX(9, 9)] +
+						FQ(9, 10) * D[PIDX(7, 10)] +
+						FQ(7, 10) * D[PIDX(9, 10)] +
+						FQ(9, 11) * D[PIDX(7, 11)] +
+						FQ(7, 11) * D[PIDX(9, 11)] +
+						FQ(9, 12) * D[PIDX(7, 12)] +
+						FQ(7, 12) * D[PIDX(9, 12)] +
+						FQ(7, 6) * D[PIDX(6, 9)] +
+						FQ(7, 8) * D[PIDX(8, 9)]) * T +
+	    D[PIDX(7, 9)];
+	P[PIDX(7, 10)] =
+	    (FQ(7, 9) * D[PIDX(9, 10)] + FQ(7, 10) * D[PIDX(10, 10)] +
+	     FQ(7, 11) * D[PIDX(10, 11)] + FQ(7, 12) * D[PIDX(10, 12)] +
+	     FQ(7, 6) * D[PIDX(6, 10)] + FQ(7, 8) * D[PIDX(8, 10)]) * T + D[PIDX(7, 10)];
+	P[PIDX(7, 11)] =
+	    (FQ(7, 9) * D[PIDX(9, 11)] + FQ(7, 10) * D[PIDX(10, 11)] +
+	     FQ(7, 11) * D[PIDX(11, 11)] + FQ(7, 12) * D[PIDX(11, 12)] +
+	     FQ(7, 6) * D[PIDX(6, 11)] + FQ(7, 8) * D[PIDX(8, 11)]) * T + D[PIDX(7, 11)];
+	P[PIDX(7, 12)] =
+	    (FQ(7, 9) * D[PIDX(9, 12)] + FQ(7, 10) * D[PIDX(10, 12)] +
+	     FQ(7, 11) * D[PIDX(11, 12)] + FQ(7, 12) * D[PIDX(12, 12)] +
+	     FQ(7, 6) * D[PIDX(6, 12)] + FQ(7, 8) * D[PIDX(8, 12)]) * T + D[PIDX(7, 12)];
+	P[PIDX(8, 8)] =
+	    (Q[0] * GQ(8, 0) * GQ(8, 0) + Q[1] * GQ(8, 1) * GQ(8, 1) +
+	     Q[2] * GQ(8, 2) * GQ(8, 2) + FQ(8, 9) * (FQ(8, 9) * D[PIDX(9, 9)] +
+						   FQ(8, 10) * D[PIDX(9, 10)] +
+						   FQ(8, 11) * D[PIDX(9, 11)] +
+						   FQ(8, 12) * D[PIDX(9, 12)] +
+						   FQ(8, 6) * D[PIDX(6, 9)] +
+						   FQ(8, 7) * D[PIDX(7, 9)]) +
+	     FQ(8, 10) * (FQ(8, 9) * D[PIDX(9, 10)] + FQ(8, 10) * D[PIDX(10, 10)] +
+			 FQ(8, 11) * D[PIDX(10, 11)] + FQ(8, 12) * D[PIDX(10, 12)] +
+			 FQ(8, 6) * D[PIDX(6, 10)] + FQ(8, 7) * D[PIDX(7, 10)]) +
+	     FQ(8, 11) * (FQ(8, 9) * D[PIDX(9, 11)] + FQ(8, 10) * D[PIDX(10, 11)] +
+			 FQ(8, 11) * D[PIDX(11, 11)] + FQ(8, 12) * D[PIDX(11, 12)] +
+			 FQ(8, 6) * D[PIDX(6, 11)] + FQ(8, 7) * D[PIDX(7, 11)]) +
+	     FQ(8, 12) * (FQ(8, 9) * D[PIDX(9, 12)] + FQ(8, 10) * D[PIDX(10, 12)] +
+			 FQ(8, 11) * D[PIDX(11, 12)] + FQ(8, 12) * D[PIDX(12, 12)] +
+			 FQ(8, 6) * D[PIDX(6, 12)] + FQ(8, 7) * D[PIDX(7, 12)]) +
+	     FQ(8, 6) * (FQ(8, 6) * D[PIDX(6, 6)] + FQ(8, 7) * D[PIDX(6, 7)] +
+			FQ(8, 9) * D[PIDX(6, 9)] + FQ(8, 10) * D[PIDX(6, 10)] +
+			FQ(8, 11) * D[PIDX(6, 11)] + FQ(8, 12) * D[PIDX(6, 12)]) +
+	     FQ(8, 7) * (FQ(8, 6) * D[PIDX(6, 7)] + FQ(8, 7) * D[PIDX(7, 7)] +
+			FQ(8, 9) * D[PIDX(7, 9)] + FQ(8, 10) * D[PIDX(7, 10)] +
+			FQ(8, 11) * D[PIDX(7, 11)] + FQ(8, 12) * D[PIDX(7, 12)])) * Tsq +
+	    (2 * FQ(8, 6) * D[PIDX(6, 8)] + 2 * FQ(8, 7) * D[PIDX(7, 8)] +
+	     2 * FQ(8, 9) * D[PIDX(8, 9)] + 2 * FQ(8, 10) * D[PIDX(8, 10)] +
+	     2 * FQ(8, 11) * D[PIDX(8, 11)] + 2 * FQ(8, 12) * D[PIDX(8, 12)]) * T +
+	    D[PIDX(8, 8)];
+	P[PIDX(8, 9)] =
+	    (FQ(9, 10) *
+	     (FQ(8, 9) * D[PIDX(9, 10)] + FQ(8, 10) * D[PIDX(10, 10)] +
+	      FQ(8, 11) * D[PIDX(10, 11)] + FQ(8, 12) * D[PIDX(10, 12)] +
+	      FQ(8, 6) * D[PIDX(6, 10)] + FQ(8, 7) * D[PIDX(7, 10)]) +
+	     FQ(9, 11) * (FQ(8, 9) * D[PIDX(9, 11)] + FQ(8, 10) * D[PIDX(10, 11)] +
+			 FQ(8, 11) * D[PIDX(11, 11)] + FQ(8, 12) * D[PIDX(11, 12)] +
+			 FQ(8, 6) * D[PIDX(6, 11)] + FQ(8, 7) * D[PIDX(7, 11)]) +
+	     FQ(9, 12) * (FQ(8, 9) * D[PIDX(9, 12)] + FQ(8, 10) * D[PIDX(10, 12)] +
+			 FQ(8, 11) * D[PIDX(11, 12)] + FQ(8, 12) * D[PIDX(12, 12)] +
+			 FQ(8, 6) * D[PIDX(6, 12)] + FQ(8, 7) * D[PIDX(7, 12)]) +
+	     FQ(9, 6) * (FQ(8, 6) * D[PIDX(6, 6)] + FQ(8, 7) * D[PIDX(6, 7)] +
+			FQ(8, 9) * D[PIDX(6, 9)] + FQ(8, 10) * D[PIDX(6, 10)] +
+			FQ(8, 11) * D[PIDX(6, 11)] + FQ(8, 12) * D[PIDX(6, 12)]) +
+	     FQ(9, 7) * (FQ(8, 6) * D[PIDX(6, 7)] + FQ(8, 7) * D[PIDX(7, 7)] +
+			FQ(8, 9) * D[PIDX(7, 9)] + FQ(8, 10) * D[PIDX(7, 10)] +
+			FQ(8, 11) * D[PIDX(7, 11)] + FQ(8, 12) * D[PIDX(7, 12)]) +
+	     FQ(9, 8) * (FQ(8, 6) * D[PIDX(6, 8)] + FQ(8, 7) * D[PIDX(7, 8)] +
+			FQ(8, 9) * D[PIDX(8, 9)] + FQ(8, 10) * D[PIDX(8, 10)] +
+			FQ(8, 11) * D[PIDX(8, 11)] + FQ(8, 12) * D[PIDX(8, 12)]) +
+	     GQ(9, 0) * GQ(8, 0) * Q[0] + GQ(9, 1) * GQ(8, 1) * Q[1] +
+	     GQ(9, 2) * GQ(8, 2) * Q[2]) * Tsq + (FQ(9, 6) * D[PIDX(6, 8)] +
+						FQ(9, 7) * D[PIDX(7, 8)] +
+						FQ(9, 8) * D[PIDX(8, 8)] +
+						FQ(8, 9) * D[PIDX(9, 9)] +
+						FQ(9, 10) * D[PIDX(8, 10)] +
+						FQ(8, 10) * D[PIDX(9, 10)] +
+						FQ(9, 11) * D[PIDX(8, 11)] +
+						FQ(8, 11) * D[PIDX(9, 11)] +
+						FQ(9, 12) * D[PIDX(8, 12)] +
+						FQ(8, 12) * D[PIDX(9, 12)] +
+						FQ(8, 6) * D[PIDX(6, 9)] +
+						FQ(8, 7) * D[PIDX(7, 9)]) * T +
+	    D[PIDX(8, 9)];
+	P[PIDX(8, 10)] =
+	    (FQ(8, 9) * D[PIDX(9, 10)] + FQ(8, 10) * D[PIDX(10, 10)] +
+	     FQ(8, 11) * D[PIDX(10, 11)] + FQ(8, 12) * D[PIDX(10, 12)] +
+	     FQ(8, 6) * D[PIDX(6, 10)] + FQ(8, 7) * D[PIDX(7, 10)]) * T + D[PIDX(8, 10)];
+	P[PIDX(8, 11)] =
+	    (FQ(8, 9) * D[PIDX(9, 11)] + FQ(8, 10) * D[PIDX(10, 11)] +
+	     FQ(8, 11) * D[PIDX(11, 11)] + FQ(8, 12) * D[PIDX(11, 12)] +
+	     FQ(8, 6) * D[PIDX(6, 11)] + FQ(8, 7) * D[PIDX(7, 11)]) * T + D[PIDX(8, 11)];
+	P[PIDX(8, 12)] =
+	    (FQ(8, 9) * D[PIDX(9, 12)] + FQ(8, 10) * D[PIDX(10, 12)] +
+	     FQ(8, 11) * D[PIDX(11, 12)] + FQ(8, 12) * D[PIDX(12, 12)] +
+	     FQ(8, 6) * D[PIDX(6, 12)] + FQ(8, 7) * D[PIDX(7, 12)]) * T + D[PIDX(8, 12)];
+	P[PIDX(9, 9)] =
+	    (Q[0] * GQ(9, 0) * GQ(9, 0) + Q[1] * GQ(9, 1) * GQ(9, 1) +
+	     Q[2] * GQ(9, 2) * GQ(9, 2) + FQ(9, 10) * (FQ(9, 10) * D[PIDX(10, 10)] +
+						    FQ(9, 11) * D[PIDX(10, 11)] +
+						    FQ(9, 12) * D[PIDX(10, 12)] +
+						    FQ(9, 6) * D[PIDX(6, 10)] +
+						    FQ(9, 7) * D[PIDX(7, 10)] +
+						    FQ(9, 8) * D[PIDX(8, 10)]) +
+	     FQ(9, 11) * (FQ(9, 10) * D[PIDX(10, 11)] + FQ(9, 11) * D[PIDX(11, 11)] +
+			 FQ(9, 12) * D[PIDX(11, 12)] + FQ(9, 6) * D[PIDX(6, 11)] +
+			 FQ(9, 7) * D[PIDX(7, 11)] + FQ(9, 8) * D[PIDX(8, 11)]) +
+	     FQ(9, 12) * (FQ(9, 10) * D[PIDX(10, 12)] + FQ(9, 11) * D[PIDX(11, 12)] +
+			 FQ(9, 12) * D[PIDX(12, 12)] + FQ(9, 6) * D[PIDX(6, 12)] +
+			 FQ(9, 7) * D[PIDX(7, 12)] + FQ(9, 8) * D[PIDX(8, 12)]) +
+	     FQ(9, 6) * (FQ(9, 6) * D[PIDX(6, 6)] + FQ(9, 7) * D[PIDX(6, 7)] +
+			FQ(9, 8) * D[PIDX(6, 8)] + FQ(9, 10) * D[PIDX(6, 10)] +
+			FQ(9, 11) * D[PIDX(6, 11)] + FQ(9, 12) * D[PIDX(6, 12)]) +
+	     FQ(9, 7) * (FQ(9, 6) * D[PIDX(6, 7)] + FQ(9, 7) * D[PIDX(7, 7)] +
+			FQ(9, 8) * D[PIDX(7, 8)] + FQ(9, 10) * D[PIDX(7, 10)] +
+			FQ(9, 11) * D[PIDX(7, 11)] + FQ(9, 12) * D[PIDX(7, 12)]) +
+	     FQ(9, 8) * (FQ(9, 6) * D[PIDX(6, 8)] + FQ(9, 7) * D[PIDX(7, 8)] +
+			FQ(9, 8) * D[PIDX(8, 8)] + FQ(9, 10) * D[PIDX(8, 10)] +
+			FQ(9, 11) * D[PIDX(8, 11)] + FQ(9, 12) * D[PIDX(8, 12)])) * Tsq +
+	    (2 * FQ(9, 10) * D[PIDX(9, 10)] + 2 * FQ(9, 11) * D[PIDX(9, 11)] +
+	     2 * FQ(9, 12) * D[PIDX(9, 12)] + 2 * FQ(9, 6) * D[PIDX(6, 9)] +
+	     2 * FQ(9, 7) * D[PIDX(7, 9)] + 2 * FQ(9, 8) * D[PIDX(8, 9)]) * T + D[PIDX(9, 9)];
+	P[PIDX(9, 10)] =
+	    (FQ(9, 10) * D[PIDX(10, 10)] + FQ(9, 11) * D[PIDX(10, 11)] +
+	     FQ(9, 12) * D[PIDX(10, 12)] + FQ(9, 6) * D[PIDX(6, 10)] +
+	     FQ(9, 7) * D[PIDX(7, 10)] + FQ(9, 8) * D[PIDX(8, 10)]) * T + D[PIDX(9, 10)];
+	P[PIDX(9, 11)] =
+	    (FQ(9, 10) * D[PIDX(10, 11)] + FQ(9, 11) * D[PIDX(11, 11)] +
+	     FQ(9, 12) * D[PIDX(11, 12)] + FQ(9, 6) * D[PIDX(6, 11)] +
+	     FQ(9, 7) * D[PIDX(7, 11)] + FQ(9, 8) * D[PIDX(8, 11)]) * T + D[PIDX(9, 11)];
+	P[PIDX(9, 12)] =
+	    (FQ(9, 10) * D[PIDX(10, 12)] + FQ(9, 11) * D[PIDX(11, 12)] +
+	     FQ(9, 12) * D[PIDX(12, 12)] + FQ(9, 6) * D[PIDX(6, 12)] +
+	     FQ(9, 7) * D[PIDX(7, 12)] + FQ(9, 8) * D[PIDX(8, 12)]) * T + D[PIDX(9, 12)];
+	P[PIDX(10, 10)] = Q[6] * Tsq + D[PIDX(10, 10)];
+	P[PIDX(10, 11)] = D[PIDX(10, 11)];
+	P[PIDX(10, 12)] = D[PIDX(10, 12)];
+	P[PIDX(11, 11)] = Q[7] * Tsq + D[PIDX(11, 11)];
+	P[PIDX(11, 12)] = D[PIDX(11, 12)];
+	P[PIDX(12, 12)] = Q[8] * Tsq + D[PIDX(12, 12)];
 }
 #endif
 
@@ -1369,45 +1423,110 @@ static void CovariancePrediction(float F[NUMX][NUMX], float G[NUMX][NUMW],
 //            - or see Simon, "Optimal State Estimation," 1st Ed, p.150
 //  The SensorsUsed variable is a bitwise mask indicating which sensors
 //     should be used in the update.
+//  The General Method multiplies by all of H, the sparse method only by the
+//    few elements of each row LinearizeH can make non-zero.  Both add the
+//    non-zero terms in the same order so the results are identical.
+//  H only stores those elements, row m holds the columns HCols[m].
 //  ************************************************
 
-static void SerialUpdate(float H[NUMV][NUMX], float R[NUMV], float Z[NUMV],
-		  float Y[NUMV], float P[NUMX][NUMX], float X[NUMX],
+// Columns of each row of H that LinearizeH sets, everything else is zero.
+// Position, velocity and baro measure one state, the magnetometer the attitude.
+static const uint8_t HCols[NUMV][4] = {
+	{0}, {1}, {2},
+	{3}, {4}, {5},
+	{6, 7, 8, 9}, {6, 7, 8, 9}, {6, 7, 8, 9},
+	{2}
+};
+static const uint8_t HNumCols[NUMV] = { 1, 1, 1, 1, 1, 1, 4, 4, 4, 1 };
+
+#ifdef SERIAL_UPDATE_GENERAL
+
+static void SerialUpdate(float H[NUMV][4], float R[NUMV], float Z[NUMV],
+		  float Y[NUMV], float P[NUMP], float X[NUMX],
 		  uint16_t SensorsUsed)
 {
-	float HP[NUMX], HPHR, Error;
+	float Hm[NUMX], HP[NUMX], K[NUMX], HPHR, Error;
 	uint8_t i, j, k, m;
 
 	for (m = 0; m < NUMV; m++) {
 
 		if (SensorsUsed & (0x01 << m)) {	// use this sensor for update
 
+			for (k = 0; k < NUMX; k++)	// Expand row m of H
+				Hm[k] = 0;
+			for (k = 0; k < HNumCols[m]; k++)
+				Hm[HCols[m][k]] = H[m][k];
+
 			for (j = 0; j < NUMX; j++) {	// Find Hp = H*P
 				HP[j] = 0;
 				for (k = 0; k < NUMX; k++)
-					HP[j] += H[m][k] * P[k][j];
+					HP[j] += Hm[k] * P[PSYM(k, j)];
 			}
 			HPHR = R[m];	// Find  HPHR = H*P*H' + R
 			for (k = 0; k < NUMX; k++)
-				HPHR += HP[k] * H[m][k];
+				HPHR += HP[k] * Hm[k];
 
 			for (k = 0; k < NUMX; k++)
-				K[k][m] = HP[k] / HPHR;	// find K = HP/HPHR
+				K[k] = HP[k] / HPHR;	// find K = HP/HPHR
 
 			for (i = 0; i < NUMX; i++) {	// Find P(m)= P(m-1) + K*HP
 				for (j = i; j < NUMX; j++)
-					P[i][j] = P[j][i] =
-					    P[i][j] - K[i][m] * HP[j];
+					P[PIDX(i, j)] =
+					    P[PIDX(i, j)] - K[i] * HP[j];
+			}
+
+			Error = Z[m] - Y[m];
+			for (i = 0; i < NUMX; i++)	// Find X(m)= X(m-1) + K*Error
+				X[i] = X[i] + K[i] * Error;
+
+		}
+	}
+}
+
+#else
+
+static void SerialUpdate(float H[NUMV][4], float R[NUMV], float Z[NUMV],
+		  float Y[NUMV], float P[NUMP], float X[NUMX],
+		  uint16_t SensorsUsed)
+{
+	float HP[NUMX], K[NUMX], HPHR, Error;
+	uint8_t i, j, k, m, n;
+
+	for (m = 0; m < NUMV; m++) {
+
+		if (SensorsUsed & (0x01 << m)) {	// use this sensor for update
+
+			const uint8_t *cols = HCols[m];
+			const uint8_t numCols = HNumCols[m];
+
+			for (j = 0; j < NUMX; j++) {	// Find Hp = H*P, only rows of P with a non-zero H
+				HP[j] = 0;
+				for (k = 0; k < numCols; k++)
+					HP[j] += H[m][k] * P[PSYM(cols[k], j)];
+			}
+			HPHR = R[m];	// Find  HPHR = H*P*H' + R
+			for (k = 0; k < numCols; k++)
+				HPHR += HP[cols[k]] * H[m][k];
+
+			for (k = 0; k < NUMX; k++)
+				K[k] = HP[k] / HPHR;	// find K = HP/HPHR
+
+			n = 0;	// walk the packed P in storage order
+			for (i = 0; i < NUMX; i++) {	// Find P(m)= P(m-1) + K*HP
+				for (j = i; j < NUMX; j++, n++)
+					P[n] = P[n] - K[i] * HP[j];
 			}
 
 			Error = Z[m] - Y[m];
 			for (i = 0; i < NUMX; i++)	// Find X(m)= X(m-1) + K*Error
-				X[i] = X[i] + K[i][m] * Error;
+				X[i] = X[i] + K[i] * Error;
 
 		}
 	}
 }
 
+#endif /* SERIAL_UPDATE_GENERAL */
+
 //  *************  RungeKutta **********************
 //  Does a 4th order Runge Kutta numerical integration step
 //  Output, Xnew, is written over X
@@ -1457,9 +1576,9 @@ static void RungeKutta(float X[NUMX], float U[NUMU], float dT)
 //  AngularVel and Accel in body frame
 //  MagFields are unit vectors
 //  Xdot is output of StateEq()
-//  F and G are outputs of LinearizeFG(), all elements not set should be zero
+//  F and G are outputs of LinearizeFG(), only their non-constant blocks are stored
 //  y is output of OutputEq()
-//  H is output of LinearizeH(), all elements not set should be zero
+//  H is output of LinearizeH(), only the elements in HCols are stored
 //  ************************************************
 
 static void StateEq(float X[NUMX], float U[NUMU], float Xdot[NUMX])
@@ -1507,8 +1626,8 @@ static void StateEq(float X[NUMX], float U[NUMU], float Xdot[NUMX])
 	Xdot[10] = Xdot[11] = Xdot[12] = 0;
 }
 
-static void LinearizeFG(float X[NUMX], float U[NUMU], float F[NUMX][NUMX],
-		 float G[NUMX][NUMW])
+static void LinearizeFG(float X[NUMX], float U[NUMU], float Fv[3][4],
+		 float Fq[4][7], float Gv[3][3], float Gq[4][3])
 {
 	float ax, ay, az, wx, wy, wz, q0, q1, q2, q3;
 
@@ -1524,22 +1643,21 @@ static void LinearizeFG(float X[NUMX], float U[NUMU], float F[NUMX][NUMX],
 	q2 = X[8];
 	q3 = X[9];
 
-	// Pdot = V
-	F[0][3] = F[1][4] = F[2][5] = 1.0f;
+	// Pdot = V, F[0][3] = F[1][4] = F[2][5] = 1 folded into CovariancePrediction
 
 	// dVdot/dq
-	F[3][6] = 2.0f * (q0 * ax - q3 * ay + q2 * az);
-	F[3][7] = 2.0f * (q1 * ax + q2 * ay + q3 * az);
-	F[3][8] = 2.0f * (-q2 * ax + q1 * ay + q0 * az);
-	F[3][9] = 2.0f * (-q3 * ax - q0 * ay + q1 * az);
-	F[4][6] = 2.0f * (q3 * ax + q0 * ay - q1 * az);
-	F[4][7] = 2.0f * (q2 * ax - q1 * ay - q0 * az);
-	F[4][8] = 2.0f * (q1 * ax + q2 * ay + q3 * az);
-	F[4][9] = 2.0f * (q0 * ax - q3 * ay + q2 * az);
-	F[5][6] = 2.0f * (-q2 * ax + q1 * ay + q0 * az);
-	F[5][7] = 2.0f * (q3 * ax + q0 * ay - q1 * az);
-	F[5][8] = 2.0f * (-q0 * ax + q3 * ay - q2 * az);
-	F[5][9] = 2.0f * (q1 * ax + q2 * ay + q3 * az);
+	FV(3, 6) = 2.0f * (q0 * ax - q3 * ay + q2 * az);
+	FV(3, 7) = 2.0f * (q1 * ax + q2 * ay + q3 * az);
+	FV(3, 8) = 2.0f * (-q2 * ax + q1 * ay + q0 * az);
+	FV(3, 9) = 2.0f * (-q3 * ax - q0 * ay + q1 * az);
+	FV(4, 6) = 2.0f * (q3 * ax + q0 * ay - q1 * az);
+	FV(4, 7) = 2.0f * (q2 * ax - q1 * ay - q0 * az);
+	FV(4, 8) = 2.0f * (q1 * ax + q2 * ay + q3 * az);
+	FV(4, 9) = 2.0f * (q0 * ax - q3 * ay + q2 * az);
+	FV(5, 6) = 2.0f * (-q2 * ax + q1 * ay + q0 * az);
+	FV(5, 7) = 2.0f * (q3 * ax + q0 * ay - q1 * az);
+	FV(5, 8) = 2.0f * (-q0 * ax + q3 * ay - q2 * az);
+	FV(5, 9) = 2.0f * (q1 * ax + q2 * ay + q3 * az);
 
 	// dVdot/dabias & dVdot/dna  - NO BIAS STATES ON ACCELS - S0 REPEAT FOR G BELOW
 	// F[3][13]=G[3][3]=-q0*q0-q1*q1+q2*q2+q3*q3; F[3][14]=G[3][4]=2*(-q1*q2+q0*q3);         F[3][15]=G[3][5]=-2*(q1*q3+q0*q2);
@@ -1547,64 +1665,63 @@ static void LinearizeFG(float X[NUMX], float U[NUMU], float F[NUMX][NUMX],
 	// F[5][13]=G[5][3]=2*(-q1*q3+q0*q2);         F[5][14]=G[5][4]=-2*(q2*q3+q0*q1);         F[5][15]=G[5][5]=-q0*q0+q1*q1+q2*q2-q3*q3;
 
 	// dqdot/dq
-	F[6][6] = 0;
-	F[6][7] = -wx / 2.0f;
-	F[6][8] = -wy / 2.0f;
-	F[6][9] = -wz / 2.0f;
-	F[7][6] = wx / 2.0f;
-	F[7][7] = 0;
-	F[7][8] = wz / 2.0f;
-	F[7][9] = -wy / 2.0f;
-	F[8][6] = wy / 2.0f;
-	F[8][7] = -wz / 2.0f;
-	F[8][8] = 0;
-	F[8][9] = wx / 2.0f;
-	F[9][6] = wz / 2.0f;
-	F[9][7] = wy / 2.0f;
-	F[9][8] = -wx / 2.0f;
-	F[9][9] = 0;
+	FQ(6, 6) = 0;
+	FQ(6, 7) = -wx / 2.0f;
+	FQ(6, 8) = -wy / 2.0f;
+	FQ(6, 9) = -wz / 2.0f;
+	FQ(7, 6) = wx / 2.0f;
+	FQ(7, 7) = 0;
+	FQ(7, 8) = wz / 2.0f;
+	FQ(7, 9) = -wy / 2.0f;
+	FQ(8, 6) = wy / 2.0f;
+	FQ(8, 7) = -wz / 2.0f;
+	FQ(8, 8) = 0;
+	FQ(8, 9) = wx / 2.0f;
+	FQ(9, 6) = wz / 2.0f;
+	FQ(9, 7) = wy / 2.0f;
+	FQ(9, 8) = -wx / 2.0f;
+	FQ(9, 9) = 0;
 
 	// dqdot/dwbias
-	F[6][10] = q1 / 2.0f;
-	F[6][11] = q2 / 2.0f;
-	F[6][12] = q3 / 2.0f;
-	F[7][10] = -q0 / 2.0f;
-	F[7][11] = q3 / 2.0f;
-	F[7][12] = -q2 / 2.0f;
-	F[8][10] = -q3 / 2.0f;
-	F[8][11] = -q0 / 2.0f;
-	F[8][12] = q1 / 2.0f;
-	F[9][10] = q2 / 2.0f;
-	F[9][11] = -q1 / 2.0f;
-	F[9][12] = -q0 / 2.0f;
+	FQ(6, 10) = q1 / 2.0f;
+	FQ(6, 11) = q2 / 2.0f;
+	FQ(6, 12) = q3 / 2.0f;
+	FQ(7, 10) = -q0 / 2.0f;
+	FQ(7, 11) = q3 / 2.0f;
+	FQ(7, 12) = -q2 / 2.0f;
+	FQ(8, 10) = -q3 / 2.0f;
+	FQ(8, 11) = -q0 / 2.0f;
+	FQ(8, 12) = q1 / 2.0f;
+	FQ(9, 10) = q2 / 2.0f;
+	FQ(9, 11) = -q1 / 2.0f;
+	FQ(9, 12) = -q0 / 2.0f;
 
 	// dVdot/dna  - NO BIAS STATES ON ACCELS - S0 REPEAT FOR G HERE
-	G[3][3] = -q0 * q0 - q1 * q1 + q2 * q2 + q3 * q3;
-	G[3][4] = 2.0f * (-q1 * q2 + q0 * q3);
-	G[3][5] = -2.0f * (q1 * q3 + q0 * q2);
-	G[4][3] = -2.0f * (q1 * q2 + q0 * q3);
-	G[4][4] = -q0 * q0 + q1 * q1 - q2 * q2 + q3 * q3;
-	G[4][5] = 2.0f * (-q2 * q3 + q0 * q1);
-	G[5][3] = 2.0f * (-q1 * q3 + q0 * q2);
-	G[5][4] = -2.0f * (q2 * q3 + q0 * q1);
-	G[5][5] = -q0 * q0 + q1 * q1 + q2 * q2 - q3 * q3;
+	GV(3, 3) = -q0 * q0 - q1 * q1 + q2 * q2 + q3 * q3;
+	GV(3, 4) = 2.0f * (-q1 * q2 + q0 * q3);
+	GV(3, 5) = -2.0f * (q1 * q3 + q0 * q2);
+	GV(4, 3) = -2.0f * (q1 * q2 + q0 * q3);
+	GV(4, 4) = -q0 * q0 + q1 * q1 - q2 * q2 + q3 * q3;
+	GV(4, 5) = 2.0f * (-q2 * q3 + q0 * q1);
+	GV(5, 3) = 2.0f * (-q1 * q3 + q0 * q2);
+	GV(5, 4) = -2.0f * (q2 * q3 + q0 * q1);
+	GV(5, 5) = -q0 * q0 + q1 * q1 + q2 * q2 - q3 * q3;
 
 	// dqdot/dnw
-	G[6][0] = q1 / 2.0f;
-	G[6][1] = q2 / 2.0f;
-	G[6][2] = q3 / 2.0f;
-	G[7][0] = -q0 / 2.0f;
-	G[7][1] = q3 / 2.0f;
-	G[7][2] = -q2 / 2.0f;
-	G[8][0] = -q3 / 2.0f;
-	G[8][1] = -q0 / 2.0f;
-	G[8][2] = q1 / 2.0f;
-	G[9][0] = q2 / 2.0f;
-	G[9][1] = -q1 / 2.0f;
-	G[9][2] = -q0 / 2.0f;
-
-	// dwbias = random walk noise
-	G[10][6] = G[11][7] = G[12][8] = 1.0f;
+	GQ(6, 0) = q1 / 2.0f;
+	GQ(6, 1) = q2 / 2.0f;
+	GQ(6, 2) = q3 / 2.0f;
+	GQ(7, 0) = -q0 / 2.0f;
+	GQ(7, 1) = q3 / 2.0f;
+	GQ(7, 2) = -q2 / 2.0f;
+	GQ(8, 0) = -q3 / 2.0f;
+	GQ(8, 1) = -q0 / 2.0f;
+	GQ(8, 2) = q1 / 2.0f;
+	GQ(9, 0) = q2 / 2.0f;
+	GQ(9, 1) = -q1 / 2.0f;
+	GQ(9, 2) = -q0 / 2.0f;
+
+	// dwbias = random walk noise, G[10][6] = G[11][7] = G[12][8] = 1 folded into CovariancePrediction
 	// dabias = random walk noise
 	// G[13][9]=G[14][10]=G[15][11]=1;  // NO BIAS STATES ON ACCELS
 }
@@ -1644,7 +1761,8 @@ static void MeasurementEq(float X[NUMX], float Be[3], float Y[NUMV])
 	Y[9] = -1.0f * X[2];
 }
 
-static void LinearizeH(float X[NUMX], float Be[3], float H[NUMV][NUMX])
+// Only sets the elements listed in HCols, SerialUpdate relies on the rest being zero
+static void LinearizeH(float X[NUMX], float Be[3], float H[NUMV][4])
 {
 	float q0, q1, q2, q3;
 
@@ -1654,26 +1772,26 @@ static void LinearizeH(float X[NUMX], float Be[3], float H[NUMV][NUMX])
 	q3 = X[9];
 
 	// dP/dP=I;
-	H[0][0] = H[1][1] = H[2][2] = 1.0f;
+	H[0][0] = H[1][0] = H[2][0] = 1.0f;
 	// dV/dV=I;
-	H[3][3] = H[4][4] = H[5][5] = 1.0f;
-
-	// dBb/dq
-	H[6][6] = 2.0f * (q0 * Be[0] + q3 * Be[1] - q2 * Be[2]);
-	H[6][7] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
-	H[6][8] = 2.0f * (-q2 * Be[0] + q1 * Be[1] - q0 * Be[2]);
-	H[6][9] = 2.0f * (-q3 * Be[0] + q0 * Be[1] + q1 * Be[2]);
-	H[7][6] = 2.0f * (-q3 * Be[0] + q0 * Be[1] + q1 * Be[2]);
-	H[7][7] = 2.0f * (q2 * Be[0] - q1 * Be[1] + q0 * Be[2]);
-	H[7][8] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
-	H[7][9] = 2.0f * (-q0 * Be[0] - q3 * Be[1] + q2 * Be[2]);
-	H[8][6] = 2.0f * (q2 * Be[0] - q1 * Be[1] + q0 * Be[2]);
-	H[8][7] = 2.0f * (q3 * Be[0] - q0 * Be[1] - q1 * Be[2]);
-	H[8][8] = 2.0f * (q0 * Be[0] + q3 * Be[1] - q2 * Be[2]);
-	H[8][9] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
+	H[3][0] = H[4][0] = H[5][0] = 1.0f;
+
+	// dBb/dq, columns 6 to 9
+	H[6][0] = 2.0f * (q0 * Be[0] + q3 * Be[1] - q2 * Be[2]);
+	H[6][1] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
+	H[6][2] = 2.0f * (-q2 * Be[0] + q1 * Be[1] - q0 * Be[2]);
+	H[6][3] = 2.0f * (-q3 * Be[0] + q0 * Be[1] + q1 * Be[2]);
+	H[7][0] = 2.0f * (-q3 * Be[0] + q0 * Be[1] + q1 * Be[2]);
+	H[7][1] = 2.0f * (q2 * Be[0] - q1 * Be[1] + q0 * Be[2]);
+	H[7][2] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
+	H[7][3] = 2.0f * (-q0 * Be[0] - q3 * Be[1] + q2 * Be[2]);
+	H[8][0] = 2.0f * (q2 * Be[0] - q1 * Be[1] + q0 * Be[2]);
+	H[8][1] = 2.0f * (q3 * Be[0] - q0 * Be[1] - q1 * Be[2]);
+	H[8][2] = 2.0f * (q0 * Be[0] + q3 * Be[1] - q2 * Be[2]);
+	H[8][3] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
 
 	// dAlt/dPz = -1
-	H[9][2] = -1.0f;
+	H[9][0] = -1.0f;
 }
 
 /**
@@ -0,0 +1,102 @@
+/**
+ ******************************************************************************
+ * @addtogroup TauLabsLibraries Tau Labs Libraries
+ * @{
+ * @addtogroup TauLabsMath Tau Labs math support libraries
+ * @{
+ *
+ * @file       biquad.c
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2013
+ * @brief      Second order IIR (biquad) filter sections
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <math.h>
+#include "biquad.h"
+#include "physical_constants.h"
+
+/**
+ * Configure a biquad as a notch filter (RBJ audio EQ cookbook)
+ *
+ * Only the coefficients are changed and the filter state is kept, so the
+ * center frequency can be moved while the filter is running. The direct
+ * form I structure tolerates this without large transients.
+ *
+ * If the center frequency is not strictly between zero and the Nyquist
+ * frequency, or q is not positive, the section becomes a passthrough.
+ *
+ * @param[in] bq The biquad section to configure
+ * @param[in] center_hz The frequency to reject
+ * @param[in] q The quality factor, center frequency divided by the -3dB bandwidth
+ * @param[in] sample_rate_hz The rate at which @ref biquad_apply is called
+ */
+void biquad_configure_notch(struct biquad *bq, float center_hz, float q, float sample_rate_hz)
+{
+	if (!(center_hz > 0) || !(q > 0) || !(center_hz < sample_rate_hz * 0.5f)) {
+		biquad_configure_passthrough(bq);
+		return;
+	}
+
+	const float omega = 2 * PI * center_hz / sample_rate_hz;
+	const float cs = cosf(omega);
+	const float alpha = sinf(omega) / (2 * q);
+	const float a0_inv = 1.0f / (1 + alpha);
+
+	bq->b0 = a0_inv;
+	bq->b1 = -2 * cs * a0_inv;
+	bq->b2 = a0_inv;
+	bq->a1 = bq->b1;
+	bq->a2 = (1 - alpha) * a0_inv;
+}
+
+/**
+ * Configure a biquad to pass the input through unchanged
+ * @param[in] bq The biquad section to configure
+ */
+void biquad_configure_passthrough(struct biquad *bq)
+{
+	bq->b0 = 1;
+	bq->b1 = 0;
+	bq->b2 = 0;
+	bq->a1 = 0;
+	bq->a2 = 0;
+}
+
+/**
+ * Reset the filter state as if the input had been constant for ever
+ *
+ * This is only exact for sections with unity DC gain, which includes
+ * notches and the passthrough.
+ *
+ * @param[in] bq The biquad section to reset
+ * @param[in] value The constant input to settle on
+ */
+void biquad_reset(struct biquad *bq, float value)
+{
+	bq->x1 = value;
+	bq->x2 = value;
+	bq->y1 = value;
+	bq->y2 = value;
+}
+
+/**
+ * @}
+ * @}
+ */
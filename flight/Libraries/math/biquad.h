@@ -0,0 +1,76 @@
+/**
+ ******************************************************************************
+ * @addtogroup TauLabsLibraries Tau Labs Libraries
+ * @{
+ * @addtogroup TauLabsMath Tau Labs math support libraries
+ * @{
+ *
+ * @file       biquad.h
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2013
+ * @brief      Second order IIR (biquad) filter sections
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef BIQUAD_H
+#define BIQUAD_H
+
+//! A direct form I biquad section, coefficients normalized so that a0 = 1
+struct biquad {
+	float b0;
+	float b1;
+	float b2;
+	float a1;
+	float a2;
+	float x1;
+	float x2;
+	float y1;
+	float y2;
+};
+
+//! Methods to use the biquad structures
+void biquad_configure_notch(struct biquad *bq, float center_hz, float q, float sample_rate_hz);
+void biquad_configure_passthrough(struct biquad *bq);
+void biquad_reset(struct biquad *bq, float value);
+
+/**
+ * Filter one sample
+ * @param[in] bq The biquad section and its state
+ * @param[in] x  The input sample
+ * @returns The filtered sample
+ */
+static inline float biquad_apply(struct biquad *bq, float x)
+{
+	float y = bq->b0 * x + bq->b1 * bq->x1 + bq->b2 * bq->x2
+	        - bq->a1 * bq->y1 - bq->a2 * bq->y2;
+
+	bq->x2 = bq->x1;
+	bq->x1 = x;
+	bq->y2 = bq->y1;
+	bq->y1 = y;
+
+	return y;
+}
+
+#endif /* BIQUAD_H */
+
+/**
+ * @}
+ * @}
+ */
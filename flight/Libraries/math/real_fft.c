@@ -0,0 +1,116 @@
+/**
+ ******************************************************************************
+ * @addtogroup TauLabsLibraries Tau Labs Libraries
+ * @{
+ * @addtogroup TauLabsMath Tau Labs math support libraries
+ * @{
+ *
+ * @file       real_fft.c
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @brief      Power spectrum of real signals with a radix 2 FFT
+ *
+ * The twiddles are computed into RAM by the caller, as arm_rfft_f32 would
+ * link about 88 KB of coefficient tables into the flash.
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <math.h>
+#include "real_fft.h"
+#include "physical_constants.h"
+
+/**
+ * Compute the twiddles of an FFT of n real points
+ * @param[out] twiddle The n values cos and sin of 2*pi*k/n for k < n/2
+ * @param[in] n The number of real points, a power of two of at least 4
+ */
+void real_fft_init_twiddle(float *twiddle, uint16_t n)
+{
+	for (uint16_t k = 0; k < (n >> 1); k++) {
+		twiddle[2*k] = cosf(2.0f * PI * k / n);
+		twiddle[2*k+1] = sinf(2.0f * PI * k / n);
+	}
+}
+
+/**
+ * Add the power of the first n/2 bins of the FFT of a real segment to a
+ * sum.  The segment is transformed as n/2 complex values with an iterative
+ * radix 2 FFT and the spectrum of the real input is split out of the result.
+ * @param[in] in The n real samples, left unchanged
+ * @param[out] power The n/2 sums to add the power of each bin to
+ * @param[out] buf Scratch space of n values
+ * @param[in] twiddle The twiddles from @ref real_fft_init_twiddle
+ * @param[in] n The number of real points, a power of two of at least 4
+ */
+void real_fft_power(const float *in, float *power, float *buf, const float *twiddle, uint16_t n)
+{
+	const uint16_t half = n >> 1;
+
+	// Pairs of samples in bit reversed order
+	uint8_t bits = 0;
+	while ((1 << bits) < half)
+		bits++;
+	for (uint16_t k = 0; k < half; k++) {
+		uint16_t j = 0;
+		for (uint8_t b = 0; b < bits; b++)
+			if (k & (1 << b))
+				j |= 1 << (bits - 1 - b);
+		buf[2*j] = in[2*k];
+		buf[2*j+1] = in[2*k+1];
+	}
+
+	// The twiddle of a butterfly span len is every n/len-th one of the table
+	for (uint16_t len = 2; len <= half; len <<= 1) {
+		const uint16_t step = n / len;
+		for (uint16_t i = 0; i < half; i += len) {
+			for (uint16_t j = 0; j < (len >> 1); j++) {
+				const float c = twiddle[2*j*step];
+				const float s = twiddle[2*j*step+1];
+				float *a = &buf[2*(i+j)];
+				float *b = &buf[2*(i+j+(len>>1))];
+				const float tr = b[0] * c + b[1] * s;
+				const float ti = b[1] * c - b[0] * s;
+				b[0] = a[0] - tr;
+				b[1] = a[1] - ti;
+				a[0] += tr;
+				a[1] += ti;
+			}
+		}
+	}
+
+	// Split the transforms of the even and odd samples and combine them
+	for (uint16_t k = 0; k < half; k++) {
+		const float *z = &buf[2*k];
+		const float *m = &buf[2*((half - k) & (half - 1))];
+		const float even_re = 0.5f * (z[0] + m[0]);
+		const float even_im = 0.5f * (z[1] - m[1]);
+		const float odd_re = 0.5f * (z[1] + m[1]);
+		const float odd_im = -0.5f * (z[0] - m[0]);
+		const float c = twiddle[2*k];
+		const float s = twiddle[2*k+1];
+		const float re = even_re + odd_re * c + odd_im * s;
+		const float im = even_im + odd_im * c - odd_re * s;
+		power[k] += re * re + im * im;
+	}
+}
+
+/**
+ * @}
+ * @}
+ */
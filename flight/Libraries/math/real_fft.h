@@ -0,0 +1,45 @@
+/**
+ ******************************************************************************
+ * @addtogroup TauLabsLibraries Tau Labs Libraries
+ * @{
+ * @addtogroup TauLabsMath Tau Labs math support libraries
+ * @{
+ *
+ * @file       real_fft.h
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @brief      Power spectrum of real signals with a radix 2 FFT
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef REAL_FFT_H
+#define REAL_FFT_H
+
+#include <stdint.h>
+
+//! Methods to compute the power spectrum of a real signal
+void real_fft_init_twiddle(float *twiddle, uint16_t n);
+void real_fft_power(const float *in, float *power, float *buf, const float *twiddle, uint16_t n);
+
+#endif /* REAL_FFT_H */
+
+/**
+ * @}
+ * @}
+ */
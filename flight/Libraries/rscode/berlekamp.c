@@ -33,154 +33,125 @@
  *
  * Error correction is done using the error-evaluator equation  on pp 207.
  *
+ * Everything here runs in bounded time: the polynomials are at most
+ * MAXDEG long, the Chien search only walks the positions inside the
+ * codeword unless the locator has roots left unaccounted for, and the
+ * Forney evaluation steps its exponents instead of multiplying them.
+ *
  */
 
 #include <stdio.h>
+#include <string.h>
 #include "ecc.h"
 
 /* The Error Locator Polynomial, also known as Lambda or Sigma. Lambda[0] == 1 */
-static int Lambda[MAXDEG];
+static uint8_t Lambda[MAXDEG];
 
 /* The Error Evaluator Polynomial */
-static int Omega[MAXDEG];
+static uint8_t Omega[MAXDEG];
 
 /* local ANSI declarations */
-static int compute_discrepancy(int lambda[], int S[], int L, int n);
-static void init_gamma(int gamma[]);
-static void compute_modified_omega (void);
-static void mul_z_poly (int src[]);
-
-/* error locations found using Chien's search*/
-static int ErrorLocs[256];
+static int compute_discrepancy(const uint8_t lambda[], const uint8_t S[], int L, int n);
+static void init_gamma(uint8_t gamma[]);
+static void compute_modified_omega (const uint8_t S[]);
+static void mul_z_poly (uint8_t src[]);
+
+/* error locations found using Chien's search. Lambda has degree of at
+ * most RS_ECC_NPARITY so it can not have more roots than that. */
+static int ErrorLocs[RS_ECC_NPARITY];
 static int NErrors;
 
 /* erasure flags */
-static int ErasureLocs[256];
+static const int *ErasureLocs;
 static int NErasures;
 
 /* From  Cain, Clark, "Error-Correction Coding For Digital Communications", pp. 216. */
-void
-Modified_Berlekamp_Massey (void)
+static void
+Modified_Berlekamp_Massey (const uint8_t S[])
 {	
   int n, L, L2, k, d, i;
-  int psi[MAXDEG], psi2[MAXDEG], D[MAXDEG];
-  int gamma[MAXDEG];
+  uint8_t psi[MAXDEG], D[MAXDEG];
+  uint8_t gamma[MAXDEG];
 	
   /* initialize Gamma, the erasure locator polynomial */
   init_gamma(gamma);
 
   /* initialize to z */
-  copy_poly(D, gamma);
+  memcpy(D, gamma, sizeof(D));
   mul_z_poly(D);
 	
-  copy_poly(psi, gamma);	
+  memcpy(psi, gamma, sizeof(psi));
   k = -1; L = NErasures;
 	
   for (n = NErasures; n < RS_ECC_NPARITY; n++) {
 	
-    d = compute_discrepancy(psi, synBytes, L, n);
+    d = compute_discrepancy(psi, S, L, n);
 		
     if (d != 0) {
-		
-      /* psi2 = psi - d*D */
-      for (i = 0; i < MAXDEG; i++) psi2[i] = psi[i] ^ gmult(d, D[i]);
-		
+      const uint8_t dlog = glog[d];
 		
       if (L < (n-k)) {
+	/* psi = psi - d*D, D = psi / d */
 	L2 = n-k;
 	k = n-L;
-	/* D = scale_poly(ginv(d), psi); */
-	for (i = 0; i < MAXDEG; i++) D[i] = gmult(psi[i], ginv(d));
+	for (i = 0; i < MAXDEG; i++) {
+	  const uint8_t p = psi[i];
+	  psi[i] = p ^ (D[i] ? gexp[glog[D[i]] + dlog] : 0);
+	  D[i] = p ? gexp[glog[p] + 255 - dlog] : 0;
+	}
 	L = L2;
+      } else {
+	/* psi = psi - d*D */
+	for (i = 0; i < MAXDEG; i++)
+	  if (D[i]) psi[i] ^= gexp[glog[D[i]] + dlog];
       }
-			
-      /* psi = psi2 */
-      for (i = 0; i < MAXDEG; i++) psi[i] = psi2[i];
     }
 		
     mul_z_poly(D);
   }
 	
-  for(i = 0; i < MAXDEG; i++) Lambda[i] = psi[i];
-  compute_modified_omega();
-
-	
+  memcpy(Lambda, psi, sizeof(Lambda));
+  compute_modified_omega(S);
 }
 
 /* given Psi (called Lambda in Modified_Berlekamp_Massey) and synBytes,
    compute the combined erasure/error evaluator polynomial as 
-   Psi*S mod z^4
+   Psi*S mod z^4. Only the truncated terms of the product are formed.
   */
-void
-compute_modified_omega ()
+static void
+compute_modified_omega (const uint8_t S[])
 {
-  int i;
-  int product[MAXDEG*2];
-	
-  mult_polys(product, Lambda, synBytes);	
-  zero_poly(Omega);
-  for(i = 0; i < RS_ECC_NPARITY; i++) Omega[i] = product[i];
-
-}
-
-/* polynomial multiplication */
-void
-mult_polys (int dst[], int p1[], int p2[])
-{
-  int i, j;
-  int tmp1[MAXDEG*2];
-	
-  for (i=0; i < (MAXDEG*2); i++) dst[i] = 0;
-	
-  for (i = 0; i < MAXDEG; i++) {
-    for(j=MAXDEG; j<(MAXDEG*2); j++) tmp1[j]=0;
-		
-    /* scale tmp1 by p1[i] */
-    for(j=0; j<MAXDEG; j++) tmp1[j]=gmult(p2[j], p1[i]);
-    /* and mult (shift) tmp1 right by i */
-    for (j = (MAXDEG*2)-1; j >= i; j--) tmp1[j] = tmp1[j-i];
-    for (j = 0; j < i; j++) tmp1[j] = 0;
-		
-    /* add into partial product */
-    for(j=0; j < (MAXDEG*2); j++) dst[j] ^= tmp1[j];
+  int i, k;
+
+  memset(Omega, 0, sizeof(Omega));
+  for (i = 0; i < RS_ECC_NPARITY; i++) {
+    int sum = 0;
+    for (k = 0; k <= i; k++)
+      sum ^= gmult(Lambda[k], S[i-k]);
+    Omega[i] = sum;
   }
 }
 
-
-	
 /* gamma = product (1-z*a^Ij) for erasure locs Ij */
-void
-init_gamma (int gamma[])
+static void
+init_gamma (uint8_t gamma[])
 {
-  int e, tmp[MAXDEG];
+  int e, i;
+  uint8_t tmp[MAXDEG];
 	
-  zero_poly(gamma);
-  zero_poly(tmp);
+  memset(gamma, 0, MAXDEG);
   gamma[0] = 1;
 	
   for (e = 0; e < NErasures; e++) {
-    copy_poly(tmp, gamma);
-    scale_poly(gexp[ErasureLocs[e]], tmp);
+    const int a = gexp[ErasureLocs[e]];
+    for (i = 0; i < MAXDEG; i++) tmp[i] = gmult(a, gamma[i]);
     mul_z_poly(tmp);
-    add_polys(gamma, tmp);
+    for (i = 0; i < MAXDEG; i++) gamma[i] ^= tmp[i];
   }
 }
 	
-	
-	
-void 
-compute_next_omega (int d, int A[], int dst[], int src[])
-{
-  int i;
-  for ( i = 0; i < MAXDEG;  i++) {
-    dst[i] = src[i] ^ gmult(d, A[i]);
-  }
-}
-	
-
-
-int
-compute_discrepancy (int lambda[], int S[], int L, int n)
+static int
+compute_discrepancy (const uint8_t lambda[], const uint8_t S[], int L, int n)
 {
   int i, sum=0;
 	
@@ -189,68 +160,88 @@ compute_discrepancy (int lambda[], int S[], int L, int n)
   return (sum);
 }
 
-/********** polynomial arithmetic *******************/
-
-void add_polys (int dst[], int src[]) 
+/* multiply by z, i.e., shift right by 1 */
+static void mul_z_poly (uint8_t src[])
 {
   int i;
-  for (i = 0; i < MAXDEG; i++) dst[i] ^= src[i];
+  for (i = MAXDEG-1; i > 0; i--) src[i] = src[i-1];
+  src[0] = 0;
 }
 
-void copy_poly (int dst[], int src[]) 
-{
-  int i;
-  for (i = 0; i < MAXDEG; i++) dst[i] = src[i];
-}
 
-void scale_poly (int k, int poly[]) 
-{	
-  int i;
-  for (i = 0; i < MAXDEG; i++) poly[i] = gmult(k, poly[i]);
-}
+/* Evaluates Lambda at a^r for r = r_first to r_last using Chien's
+ * search. Rather than computing Lambda[k]*a^(k*r) from scratch for each
+ * r, the exponent of every term is stepped by k. Any roots found are
+ * appended to ErrorLocs unless stop_on_root is set, in which case the
+ * search only reports whether a root exists.
+ *
+ * Returns the number of roots found.
+ */
+static int
+chien_search (int r_first, int r_last, int stop_on_root)
+{
+  int expo[RS_ECC_NPARITY+1];
+  int nterms = 0, found = 0;
+  uint8_t step[RS_ECC_NPARITY+1];
+  int r, k;
+
+  for (k = 0; k < RS_ECC_NPARITY+1; k++) {
+    if (Lambda[k] == 0)
+      continue;
+    step[nterms] = k;
+    expo[nterms] = (glog[Lambda[k]] + k * r_first) % 255;
+    nterms++;
+  }
 
+  for (r = r_first; r <= r_last; r++) {
+    int sum = 0;
+    for (k = 0; k < nterms; k++) {
+      sum ^= gexp[expo[k]];
+      expo[k] += step[k];
+      if (expo[k] >= 255) expo[k] -= 255;
+    }
+    if (sum == 0) {
+      if (stop_on_root)
+	return 1;
+      ErrorLocs[NErrors] = (255-r); NErrors++;
+      found++;
+    }
+  }
 
-void zero_poly (int poly[]) 
-{
-  int i;
-  for (i = 0; i < MAXDEG; i++) poly[i] = 0;
+  return found;
 }
 
-
-/* multiply by z, i.e., shift right by 1 */
-static void mul_z_poly (int src[])
+/* Finds the roots of the error-locator polynomial that lie inside a
+ * codeword of csize bytes, i.e. error locations 0 to csize-1 which
+ * correspond to r = 255-loc.
+ *
+ * Returns 0 if a root also exists outside the codeword. Such a root
+ * is only searched for when the in-range roots do not account for
+ * the whole degree of Lambda, so clean and correctable packets never
+ * pay for scanning the unused part of the field.
+ */
+static int
+Find_Roots (int csize)
 {
-  int i;
-  for (i = MAXDEG-1; i > 0; i--) src[i] = src[i-1];
-  src[0] = 0;
-}
+  int r_first = 256 - csize;
+  int degree = 0, k;
 
+  NErrors = 0;
 
-/* Finds all the roots of an error-locator polynomial with coefficients
- * Lambda[j] by evaluating Lambda at successive values of alpha. 
- * 
- * This can be tested with the decoder's equations case.
- */
+  if (r_first < 1) r_first = 1;
+  if (r_first > 255) return 0;
 
+  for (k = 0; k < RS_ECC_NPARITY+1; k++)
+    if (Lambda[k] != 0) degree = k;
 
-void 
-Find_Roots (void)
-{
-  int sum, r, k;	
-  NErrors = 0;
-  
-  for (r = 1; r < 256; r++) {
-    sum = 0;
-    /* evaluate lambda at r */
-    for (k = 0; k < RS_ECC_NPARITY+1; k++) {
-      sum ^= gmult(gexp[(k*r)%255], Lambda[k]);
-    }
-    if (sum == 0) 
-      { 
-	ErrorLocs[NErrors] = (255-r); NErrors++; 
-	//if (DEBUG) fprintf(stderr, "Root found at r = %d, (255-r) = %d\n", r, (255-r));
-      }
+  chien_search(r_first, 255, FALSE);
+
+  if (NErrors > 0 && NErrors < degree && r_first > 1) {
+    if (chien_search(1, r_first-1, TRUE) != 0)
+      return 0;
   }
+
+  return 1;
 }
 
 /* Combined Erasure And Error Magnitude Computation 
@@ -272,53 +263,54 @@ correct_errors_erasures (unsigned char codeword[],
 			 int nerasures,
 			 int erasures[])
 {
+  uint8_t S[MAXDEG];
   int r, i, j, err;
 
+  /* Nothing to do for a clean codeword */
+  if (nerasures == 0 && check_syndrome() == 0)
+    return(0);
+
   /* If you want to take advantage of erasure correction, be sure to
      set NErasures and ErasureLocs[] with the locations of erasures. 
      */
   NErasures = nerasures;
-  for (i = 0; i < NErasures; i++) ErasureLocs[i] = erasures[i];
+  ErasureLocs = erasures;
 
-  Modified_Berlekamp_Massey();
-  Find_Roots();
-  
+  for (i = 0; i < MAXDEG; i++) S[i] = synBytes[i];
 
-  if ((NErrors <= RS_ECC_NPARITY) && NErrors > 0) { 
+  Modified_Berlekamp_Massey(S);
 
-    /* first check for illegal error locs */
-    for (r = 0; r < NErrors; r++) {
-      if (ErrorLocs[r] >= csize) {
-				//if (DEBUG) fprintf(stderr, "Error loc i=%d outside of codeword length %d\n", i, csize);
-	return(0);
-      }
-    }
+  if (Find_Roots(csize) && NErrors > 0) {
 
     for (r = 0; r < NErrors; r++) {
-      int num, denom;
+      int num, denom, e, step;
       i = ErrorLocs[r];
-      /* evaluate Omega at alpha^(-i) */
+      step = (255 - i) % 255;
 
+      /* evaluate Omega at alpha^(-i) */
       num = 0;
-      for (j = 0; j < MAXDEG; j++) 
-	num ^= gmult(Omega[j], gexp[((255-i)*j)%255]);
+      for (j = 0, e = 0; j < MAXDEG; j++) {
+	if (Omega[j]) num ^= gexp[glog[Omega[j]] + e];
+	e += step;
+	if (e >= 255) e -= 255;
+      }
       
       /* evaluate Lambda' (derivative) at alpha^(-i) ; all odd powers disappear */
       denom = 0;
-      for (j = 1; j < MAXDEG; j += 2) {
-	denom ^= gmult(Lambda[j], gexp[((255-i)*(j-1)) % 255]);
+      step = (2 * step) % 255;
+      for (j = 1, e = 0; j < MAXDEG; j += 2) {
+	if (Lambda[j]) denom ^= gexp[glog[Lambda[j]] + e];
+	e += step;
+	if (e >= 255) e -= 255;
       }
       
       err = gmult(num, ginv(denom));
-      //if (DEBUG) fprintf(stderr, "Error magnitude %#x at loc %d\n", err, csize-i);
       
       codeword[csize-i-1] ^= err;
     }
     return(1);
   }
   else {
-    //if (DEBUG && NErrors) fprintf(stderr, "Uncorrectable codeword\n");
     return(0);
   }
 }
-
@@ -46,6 +46,7 @@
 
 
 #include <openpilot.h>
+#include <stdint.h>
 
 #define TRUE 1
 #define FALSE 0
@@ -77,22 +78,25 @@ void encode_data (unsigned char msg[], int nbytes, unsigned char dst[]);
 /* CRC-CCITT checksum generator */
 BIT16 crc_ccitt(unsigned char *msg, int len);
 
-/* galois arithmetic tables */
-extern const int gexp[];
-extern const int glog[];
+/* galois arithmetic tables. gexp[] is doubled so that the sum of
+ * two logs can index it without a modulo. */
+extern const uint8_t gexp[512];
+extern const uint8_t glog[256];
 
 void init_galois_tables (void);
-int ginv(int elt); 
-int gmult(int a, int b);
 
+/* multiplication using logarithms */
+static inline int gmult(int a, int b)
+{
+  if (a == 0 || b == 0) return (0);
+  return (gexp[glog[a] + glog[b]]);
+}
 
-/* Error location routines */
-int correct_errors_erasures (unsigned char codeword[], int csize,int nerasures, int erasures[]);
+static inline int ginv(int elt)
+{
+  return (gexp[255 - glog[elt]]);
+}
 
-/* polynomial arithmetic */
-void add_polys(int dst[], int src[]) ;
-void scale_poly(int k, int poly[]);
-void mult_polys(int dst[], int p1[], int p2[]);
 
-void copy_poly(int dst[], int src[]);
-void zero_poly(int poly[]);
+/* Error location routines */
+int correct_errors_erasures (unsigned char codeword[], int csize,int nerasures, int erasures[]);
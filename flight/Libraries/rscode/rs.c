@@ -27,6 +27,7 @@
 
 #include <stdio.h>
 #include <ctype.h>
+#include <string.h>
 #include "ecc.h"
 
 /* Encoder parity bytes */
@@ -36,7 +37,13 @@ int pBytes[MAXDEG];
 int synBytes[MAXDEG];
 
 /* generator polynomial */
-int genPoly[MAXDEG*2];
+static int genPoly[MAXDEG*2];
+
+/* Logs of the generator polynomial coefficients, used by the encoder so
+ * that each tap costs a single table lookup. genZero flags coefficients
+ * which are zero and have no log. */
+static uint8_t genLog[RS_ECC_NPARITY];
+static uint8_t genZero[RS_ECC_NPARITY];
 
 int DEBUG = FALSE;
 
@@ -47,54 +54,29 @@ compute_genpoly (int nbytes, int genpoly[]);
 void
 initialize_ecc ()
 {
+  int i;
+
   /* Initialize the galois field arithmetic tables */
     init_galois_tables();
 
     /* Compute the encoder generator polynomial */
     compute_genpoly(RS_ECC_NPARITY, genPoly);
-}
-
-void
-zero_fill_from (unsigned char buf[], int from, int to)
-{
-  int i;
-  for (i = from; i < to; i++) buf[i] = 0;
-}
-
-/* debugging routines */
-void
-print_parity (void)
-{
-#ifdef NEVER
-  int i;
-  printf("Parity Bytes: ");
-  for (i = 0; i < RS_ECC_NPARITY; i++) 
-    printf("[%d]:%x, ",i,pBytes[i]);
-  printf("\n");
-#endif
-}
-
 
-void
-print_syndrome (void)
-{
-#ifdef NEVER
-  int i;
-  printf("Syndrome Bytes: ");
-  for (i = 0; i < RS_ECC_NPARITY; i++) 
-    printf("[%d]:%x, ",i,synBytes[i]);
-  printf("\n");
-#endif
+    for (i = 0; i < RS_ECC_NPARITY; i++) {
+      genZero[i] = (genPoly[i] == 0);
+      genLog[i] = glog[genPoly[i]];
+    }
 }
 
 /* Append the parity bytes onto the end of the message */
-void
+static void
 build_codeword (unsigned char msg[], int nbytes, unsigned char dst[])
 {
   int i;
-	
-  for (i = 0; i < nbytes; i++) dst[i] = msg[i];
-	
+
+  if (dst != msg)
+    memmove(dst, msg, nbytes);
+
   for (i = 0; i < RS_ECC_NPARITY; i++) {
     dst[i+nbytes] = pBytes[RS_ECC_NPARITY-1-i];
   }
@@ -105,19 +87,29 @@ build_codeword (unsigned char msg[], int nbytes, unsigned char dst[])
  *
  * Computes the syndrome of a codeword. Puts the results
  * into the synBytes[] array.
+ *
+ * All syndromes are accumulated in one pass over the data with
+ * Horner's rule, S[j] = S[j]*a^(j+1) + data[i], done in the log domain.
  */
  
 void
 decode_data(unsigned char data[], int nbytes)
 {
-  int i, j, sum;
-  for (j = 0; j < RS_ECC_NPARITY;  j++) {
-    sum	= 0;
-    for (i = 0; i < nbytes; i++) {
-      sum = data[i] ^ gmult(gexp[j+1], sum);
+  uint8_t syn[RS_ECC_NPARITY];
+  int i, j;
+
+  memset(syn, 0, sizeof(syn));
+
+  for (i = 0; i < nbytes; i++) {
+    const uint8_t d = data[i];
+    for (j = 0; j < RS_ECC_NPARITY; j++) {
+      const uint8_t s = syn[j];
+      syn[j] = s ? (d ^ gexp[glog[s] + j + 1]) : d;
     }
-    synBytes[j]  = sum;
   }
+
+  for (j = 0; j < RS_ECC_NPARITY; j++)
+    synBytes[j] = syn[j];
 }
 
 
@@ -136,20 +128,6 @@ check_syndrome (void)
 }
 
 
-void
-debug_check_syndrome (void)
-{	
-#ifdef NEVER
-  int i;
-	
-  for (i = 0; i < 3; i++) {
-    printf(" inv log S[%d]/S[%d] = %d\n", i, i+1, 
-	   glog[gmult(synBytes[i], ginv(synBytes[i+1]))]);
-  }
-#endif
-}
-
-
 /* Create a generator polynomial for an n byte RS code. 
  * The coefficients are returned in the genPoly arg.
  * Make sure that the genPoly array which is passed in is 
@@ -159,20 +137,17 @@ debug_check_syndrome (void)
 static void
 compute_genpoly (int nbytes, int genpoly[])
 {
-  int i, tp[MAXDEG], tp1[MAXDEG];
+  int i, j;
 	
   /* multiply (x + a^n) for n = 1 to nbytes */
 
-  zero_poly(tp1);
-  tp1[0] = 1;
+  for (j = 0; j < MAXDEG*2; j++) genpoly[j] = 0;
+  genpoly[0] = 1;
 
   for (i = 1; i <= nbytes; i++) {
-    zero_poly(tp);
-    tp[0] = gexp[i];		/* set up x+a^n */
-    tp[1] = 1;
-	  
-    mult_polys(genpoly, tp, tp1);
-    copy_poly(tp1, genpoly);
+    for (j = i; j > 0; j--)
+      genpoly[j] = genpoly[j-1] ^ gmult(genpoly[j], gexp[i]);
+    genpoly[0] = gmult(genpoly[0], gexp[i]);
   }
 }
 
@@ -187,16 +162,27 @@ compute_genpoly (int nbytes, int genpoly[])
 void
 encode_data (unsigned char msg[], int nbytes, unsigned char dst[])
 {
-  int i, LFSR[RS_ECC_NPARITY+1],dbyte, j;
-	
-  for(i=0; i < RS_ECC_NPARITY+1; i++) LFSR[i]=0;
+  uint8_t LFSR[RS_ECC_NPARITY];
+  int i, j;
+
+  memset(LFSR, 0, sizeof(LFSR));
 
   for (i = 0; i < nbytes; i++) {
-    dbyte = msg[i] ^ LFSR[RS_ECC_NPARITY-1];
+    const uint8_t dbyte = msg[i] ^ LFSR[RS_ECC_NPARITY-1];
+
+    if (dbyte == 0) {
+      /* feedback is zero, the register just shifts */
+      for (j = RS_ECC_NPARITY-1; j > 0; j--)
+	LFSR[j] = LFSR[j-1];
+      LFSR[0] = 0;
+      continue;
+    }
+
+    const uint8_t dlog = glog[dbyte];
     for (j = RS_ECC_NPARITY-1; j > 0; j--) {
-      LFSR[j] = LFSR[j-1] ^ gmult(genPoly[j], dbyte);
+      LFSR[j] = LFSR[j-1] ^ (genZero[j] ? 0 : gexp[dlog + genLog[j]]);
     }
-    LFSR[0] = gmult(genPoly[0], dbyte);
+    LFSR[0] = genZero[0] ? 0 : gexp[dlog + genLog[0]];
   }
 
   for (i = 0; i < RS_ECC_NPARITY; i++) 
@@ -204,4 +190,3 @@ encode_data (unsigned char msg[], int nbytes, unsigned char dst[])
 	
   build_codeword(msg, nbytes, dst);
 }
-
@@ -382,23 +382,26 @@ static int32_t updateSensors(AccelsData * accelsData, GyrosData * gyrosData)
  */
 static int32_t updateSensorsCC3D(AccelsData * accelsData, GyrosData * gyrosData)
 {
-	struct pios_sensor_gyro_data gyros;
-	struct pios_sensor_accel_data accels;
-	xQueueHandle queue;
+	struct pios_sensor_gyro_data gyros = {0, 0, 0, 0};
+	struct pios_sensor_accel_data accels = {0, 0, 0, 0};
+	struct pios_sensors_ring *gyro_ring = PIOS_SENSORS_GetRing(PIOS_SENSOR_GYRO);
+	struct pios_sensors_ring *accel_ring = PIOS_SENSORS_GetRing(PIOS_SENSOR_ACCEL);
 
-	queue = PIOS_SENSORS_GetQueue(PIOS_SENSOR_GYRO);
-	if(queue == NULL || xQueueReceive(queue, (void *) &gyros, 4) == errQUEUE_EMPTY) {
+	if (gyro_ring == NULL || !PIOS_SENSORS_WaitRing(gyro_ring, 4)) {
 		return-1;
 	}
 
 	// As it says below, because the rest of the code expects the accel to be ready when
 	// the gyro is we must block here too
-	queue = PIOS_SENSORS_GetQueue(PIOS_SENSOR_ACCEL);
-	if(queue == NULL || xQueueReceive(queue, (void *) &accels, 1) == errQUEUE_EMPTY) {
+	if (accel_ring == NULL || !PIOS_SENSORS_WaitRing(accel_ring, 1)) {
 		return -1;
 	}
-	else
-		update_accels(&accels, accelsData);
+
+	// Average every sample that arrived since the last update
+	PIOS_SENSORS_PopAverage(PIOS_SENSOR_GYRO, &gyros);
+	PIOS_SENSORS_PopAverage(PIOS_SENSOR_ACCEL, &accels);
+
+	update_accels(&accels, accelsData);
 
 	// Update gyros after the accels since the rest of the code expects
 	// the accels to be available first
@@ -81,8 +81,21 @@
 // exp(-(1/f) / tau ) ~=~ 0.9997
 #define BARO_OFFSET_LOWPASS_ALPHA 0.9997f 
 
+// Past INSGPS position and velocity kept to fuse the GPS at the time it was
+// measured, covering INS_HISTORY_LEN * INS_HISTORY_PERIOD_MS
+#define INS_HISTORY_LEN 32
+#define INS_HISTORY_PERIOD_MS 10
+#define INS_HISTORY_MAX_DELAY_MS ((INS_HISTORY_LEN - 1) * INS_HISTORY_PERIOD_MS)
+
 // Private types
 
+//! The INSGPS position and velocity estimate at one time
+struct ins_history_entry {
+	uint32_t time_ms;
+	float pos[3];
+	float vel[3];
+};
+
 
 // Track the initialization state of the complementary filter
 enum complementary_filter_status {
@@ -139,6 +152,10 @@ static const float zeros[3] = {0.0f, 0.0f, 0.0f};
 
 static struct complementary_filter_state complementary_filter_state;
 
+static struct ins_history_entry *ins_history;
+static uint8_t ins_history_head;
+static uint8_t ins_history_count;
+
 // Private functions
 static void AttitudeTask(void *parameters);
 
@@ -200,6 +217,11 @@ int32_t AttitudeInitialize(void)
 	StateEstimationInitialize();
 	VelocityActualInitialize();
 
+	// The history used to fuse delayed GPS measurements
+	ins_history = pvPortMalloc(INS_HISTORY_LEN * sizeof(*ins_history));
+	if (ins_history == NULL)
+		return -1;
+
 	// Initialize this here while we aren't setting the homelocation in GPS
 	HomeLocationInitialize();
 
@@ -762,6 +784,66 @@ static void accumulate_gyro(GyrosData *gyrosData)
 
 #include "insgps.h"
 static bool home_location_updated;
+
+/**
+ * Store the current INSGPS position and velocity estimate in the history,
+ * at most once every INS_HISTORY_PERIOD_MS
+ * @param[in] now_ms The current time
+ */
+static void ins_history_record(uint32_t now_ms)
+{
+	if (ins_history_count > 0 && (now_ms - ins_history[ins_history_head].time_ms) < INS_HISTORY_PERIOD_MS)
+		return;
+
+	if (ins_history_count > 0)
+		ins_history_head = (ins_history_head + 1) % INS_HISTORY_LEN;
+	if (ins_history_count < INS_HISTORY_LEN)
+		ins_history_count++;
+
+	struct ins_history_entry *entry = &ins_history[ins_history_head];
+	entry->time_ms = now_ms;
+	INSGetState(entry->pos, entry->vel, NULL, NULL);
+}
+
+/**
+ * Get the position and velocity estimate at a past time
+ * @param[in] time_ms The time to look up
+ * @param[out] pos The position at that time
+ * @param[out] vel The velocity at that time
+ * @return true if found, false if the time is not covered by the history
+ */
+static bool ins_history_get(uint32_t time_ms, float pos[3], float vel[3])
+{
+	// Walk back from the newest entry to the first one not after time_ms
+	for (uint8_t i = 0; i < ins_history_count; i++) {
+		struct ins_history_entry *entry = &ins_history[(ins_history_head + INS_HISTORY_LEN - i) % INS_HISTORY_LEN];
+		if ((int32_t)(time_ms - entry->time_ms) >= 0) {
+			for (uint8_t j = 0; j < 3; j++) {
+				pos[j] = entry->pos[j];
+				vel[j] = entry->vel[j];
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Apply a correction of the current estimate to the whole history so the
+ * next delayed measurement is not compared against the uncorrected past
+ * @param[in] dpos The change of the position estimate
+ * @param[in] dvel The change of the velocity estimate
+ */
+static void ins_history_correct(const float dpos[3], const float dvel[3])
+{
+	for (uint8_t i = 0; i < ins_history_count; i++) {
+		for (uint8_t j = 0; j < 3; j++) {
+			ins_history[i].pos[j] += dpos[j];
+			ins_history[i].vel[j] += dvel[j];
+		}
+	}
+}
 /**
  * @brief Use the INSGPS fusion algorithm in either indoor or outdoor mode (use GPS)
  * @params[in] first_run This is the first run so trigger reinitialization
@@ -811,6 +893,8 @@ static int32_t updateAttitudeINSGPS(bool first_run, bool outdoor_mode)
 
 		home_location_updated = false;
 
+		ins_history_count = 0;
+
 		ins_last_time = PIOS_DELAY_GetRaw();
 
 		return 0;
@@ -935,6 +1019,9 @@ static int32_t updateAttitudeINSGPS(bool first_run, bool outdoor_mode)
 			INSSetState(NED, zeros, q, zeros, zeros);
 		} 
 
+		// Estimates from before the reset are meaningless now
+		ins_history_count = 0;
+
 		inited = true;
 
 		ins_last_time = PIOS_DELAY_GetRaw();	
@@ -983,6 +1070,27 @@ static int32_t updateAttitudeINSGPS(bool first_run, bool outdoor_mode)
 	// Advance the covariance estimate
 	INSCovariancePrediction(dT);
 
+	// The GPS reports where the vehicle was GPSDelay ago.  Rather than comparing
+	// it to the current estimate, compare it to the estimate from that time by
+	// shifting it by how much the estimate has moved since.
+	bool use_history = insSettings.GPSDelay > 0;
+	uint32_t now_ms = TICKS2MS(xTaskGetTickCount());
+	float prior_pos[3], prior_vel[3];
+	float gps_pos_shift[3] = {0.0f, 0.0f, 0.0f};
+	float gps_vel_shift[3] = {0.0f, 0.0f, 0.0f};
+	if (use_history) {
+		INSGetState(prior_pos, prior_vel, NULL, NULL);
+
+		float past_pos[3], past_vel[3];
+		if ((gps_updated || gps_vel_updated) &&
+		    ins_history_get(now_ms - insSettings.GPSDelay, past_pos, past_vel)) {
+			for (uint8_t i = 0; i < 3; i++) {
+				gps_pos_shift[i] = prior_pos[i] - past_pos[i];
+				gps_vel_shift[i] = prior_vel[i] - past_vel[i];
+			}
+		}
+	}
+
 	if(mag_updated) {
 		sensors |= MAG_SENSORS;
 		mag_updated = false;
@@ -1015,6 +1123,10 @@ static int32_t updateAttitudeINSGPS(bool first_run, bool outdoor_mode)
 		nedPos.Down = NED[2];
 		NEDPositionSet(&nedPos);
 
+		NED[0] += gps_pos_shift[0];
+		NED[1] += gps_pos_shift[1];
+		NED[2] += gps_pos_shift[2];
+
 		gps_updated = false;
 	}
 
@@ -1022,9 +1134,9 @@ static int32_t updateAttitudeINSGPS(bool first_run, bool outdoor_mode)
 	if (gps_vel_updated && outdoor_mode) {
 		sensors |= HORIZ_SENSORS | VERT_SENSORS;
 		GPSVelocityGet(&gpsVelData);
-		vel[0] = gpsVelData.North;
-		vel[1] = gpsVelData.East;
-		vel[2] = gpsVelData.Down;
+		vel[0] = gpsVelData.North + gps_vel_shift[0];
+		vel[1] = gpsVelData.East + gps_vel_shift[1];
+		vel[2] = gpsVelData.Down + gps_vel_shift[2];
 
 		gps_vel_updated = false;
 	}
@@ -1047,6 +1159,22 @@ static int32_t updateAttitudeINSGPS(bool first_run, bool outdoor_mode)
 	if (sensors)
 		INSCorrection(&magData.x, NED, vel, ( baroData.Altitude + baro_offset ), sensors);
 
+	if (use_history) {
+		// Move the history by the correction so the next GPS update is
+		// compared to what is now believed about the past
+		if (sensors) {
+			float dpos[3], dvel[3];
+			INSGetState(dpos, dvel, NULL, NULL);
+			for (uint8_t i = 0; i < 3; i++) {
+				dpos[i] -= prior_pos[i];
+				dvel[i] -= prior_vel[i];
+			}
+			ins_history_correct(dpos, dvel);
+		}
+
+		ins_history_record(now_ms);
+	}
+
 	// Export the state and variance for monitoring the EKF
 	INSStateData state;
 	INSGetVariance(state.Var);
@@ -1151,6 +1279,9 @@ static void settingsUpdatedCb(UAVObjEvent * ev)
 	}
 	if (ev == NULL || ev->obj == INSSettingsHandle()) {
 		INSSettingsGet(&insSettings);
+		// The history only reaches back this far
+		if (insSettings.GPSDelay > INS_HISTORY_MAX_DELAY_MS)
+			insSettings.GPSDelay = INS_HISTORY_MAX_DELAY_MS;
 		// In case INS currently running
 		INSSetMagVar(insSettings.mag_var);
 		INSSetAccelVar(insSettings.accel_var);
@@ -0,0 +1,613 @@
+/**
+ ******************************************************************************
+ * @addtogroup TauLabsModules Tau Labs Modules
+ * @{ 
+ * @addtogroup Logging Logging Module
+ * @{ 
+ *
+ * @file       logging.c
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @brief      Records flight data to onboard flash
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/**
+ * Selected objects are packed as UAVTalk frames from the event callback of
+ * every update.  Each frame is stored with a timestamp and its size, the
+ * record format of the GCS log files, so a file read back from flash can be
+ * replayed directly by the GCS.  Every log starts with the same text header
+ * the GCS writes, naming the firmware commit and the UAVO hash.  Records are
+ * appended to one of two RAM buffers; whenever one fills up the logging task
+ * writes it to flash in whole pages while the other one keeps collecting
+ * data.  When neither has room the record is dropped and counted.
+ *
+ * While not logging, files are read back through LoggingStats: the GCS
+ * requests a sector of a file by setting Operation to Download and the
+ * logging task answers with the data and Operation set to Complete.
+ */
+
+#include "openpilot.h"
+#include "modulesettings.h"
+#include "flightstatus.h"
+#include "loggingsettings.h"
+#include "loggingstats.h"
+
+#include "accels.h"
+#include "actuatorcommand.h"
+#include "actuatordesired.h"
+#include "attitudeactual.h"
+#include "baroaltitude.h"
+#include "gpsposition.h"
+#include "gyros.h"
+#include "magnetometer.h"
+#include "manualcontrolcommand.h"
+#include "positionactual.h"
+#include "stabilizationdesired.h"
+#include "velocityactual.h"
+
+// Private constants
+#define STACK_SIZE_BYTES 1024
+#define TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#define LOG_BUFFER_SIZE 4096
+#define LOG_CHECK_PERIOD_MS 100
+#define STATS_UPDATE_PERIOD_MS 1000
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+// Layout of the firmware description, see make/templates/firmwareinfotemplate.c
+#define FW_DESC_SIZE            100
+#define FW_DESC_COMMIT_OFFSET   4
+#define FW_DESC_TAG_OFFSET      14
+#define FW_DESC_TAG_SIZE        26
+#define FW_DESC_UAVOSHA1_OFFSET 60
+#define FW_DESC_SHA1_SIZE       20
+
+// Private types
+
+//! Header of every record, as expected by the GCS LogFile
+struct log_record_header {
+	uint32_t timestamp;
+	uint64_t size;
+} __attribute__((packed));
+
+//! Double buffer between the event callbacks and the logging task
+struct log_buffers {
+	uint8_t *data[2];
+	volatile bool full[2];
+	uint8_t active;      //!< Buffer records are appended to
+	uint8_t flush_next;  //!< Oldest buffer, written to flash first
+	uint16_t fill;       //!< Bytes used in the active buffer
+};
+
+// Private variables
+static UAVTalkConnection uavTalkCon;
+static xTaskHandle loggingTaskHandle;
+static xSemaphoreHandle buffer_lock;
+static xSemaphoreHandle flush_sem;
+static bool module_enabled;
+static volatile bool logging;
+static struct log_buffers buffers;
+static uint32_t logged_mask;
+static uint32_t bytes_logged;
+static uint32_t dropped_bytes;
+static int32_t file_id = -1;
+static bool download_open;
+static uint16_t download_file;
+static uint16_t download_sector;
+static uint16_t settings_index;
+static uint16_t settings_cursor;
+static bool settings_sent;
+
+//! Objects that can be logged, in the order of LoggingSettings.LoggedObjects
+static UAVObjHandle (* const logged_objects[LOGGINGSETTINGS_LOGGEDOBJECTS_NUMELEM])(void) = {
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_GYROS]                = GyrosHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_ACCELS]               = AccelsHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_MAGNETOMETER]         = MagnetometerHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_BAROALTITUDE]         = BaroAltitudeHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_ATTITUDEACTUAL]       = AttitudeActualHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_STABILIZATIONDESIRED] = StabilizationDesiredHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_ACTUATORDESIRED]      = ActuatorDesiredHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_ACTUATORCOMMAND]      = ActuatorCommandHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_MANUALCONTROLCOMMAND] = ManualControlCommandHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_FLIGHTSTATUS]         = FlightStatusHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_GPSPOSITION]          = GPSPositionHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_POSITIONACTUAL]       = PositionActualHandle,
+	[LOGGINGSETTINGS_LOGGEDOBJECTS_VELOCITYACTUAL]       = VelocityActualHandle,
+};
+
+// Private functions
+static void    loggingTask(void *parameters);
+static int32_t log_record(uint8_t *data, int32_t length);
+static void    log_copy(const uint8_t *data, uint32_t length);
+static void    log_header(void);
+static void    object_updated(UAVObjEvent *ev);
+static void    settings_updated(UAVObjEvent *ev);
+static void    stats_updated(UAVObjEvent *ev);
+static void    log_settings(UAVObjHandle obj);
+static void    flush_buffers(void);
+static int32_t start_log(void);
+static void    stop_log(void);
+static void    send_sector(void);
+static void    update_stats(bool error);
+
+// External variables
+extern uintptr_t pios_streamfs_id;
+
+/**
+ * Initialise the logging module
+ * \return -1 if initialisation failed
+ * \return 0 on success
+ */
+int32_t LoggingInitialize(void)
+{
+#ifdef MODULE_Logging_BUILTIN
+	module_enabled = true;
+#else
+	uint8_t module_state[MODULESETTINGS_ADMINSTATE_NUMELEM];
+	ModuleSettingsAdminStateGet(module_state);
+	if (module_state[MODULESETTINGS_ADMINSTATE_LOGGING] == MODULESETTINGS_ADMINSTATE_ENABLED) {
+		module_enabled = true;
+	} else {
+		module_enabled = false;
+	}
+#endif
+
+	// Boards without a log partition can not run the logger
+	if (!pios_streamfs_id)
+		module_enabled = false;
+
+	if (!module_enabled)
+		return -1;
+
+	buffers.data[0] = PIOS_malloc(LOG_BUFFER_SIZE);
+	buffers.data[1] = PIOS_malloc(LOG_BUFFER_SIZE);
+	if (buffers.data[0] == NULL || buffers.data[1] == NULL) {
+		module_enabled = false;
+		return -1;
+	}
+
+	buffer_lock = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(flush_sem);
+
+	LoggingSettingsInitialize();
+	LoggingStatsInitialize();
+
+	// Initialise UAVTalk
+	uavTalkCon = UAVTalkInitialize(&log_record);
+
+	return 0;
+}
+
+/**
+ * Start the logging module
+ * \return -1 if initialisation failed
+ * \return 0 on success
+ */
+int32_t LoggingStart(void)
+{
+	//Check if module is enabled or not
+	if (module_enabled == false) {
+		return -1;
+	}
+
+	LoggingSettingsConnectCallback(settings_updated);
+	settings_updated(NULL);
+
+	// Download requests from the GCS wake up the logging task
+	LoggingStatsConnectCallback(stats_updated);
+
+	// Every update of the loggable objects is recorded while logging
+	for (uint8_t i = 0; i < NELEMENTS(logged_objects); i++) {
+		UAVObjHandle obj = logged_objects[i]();
+		if (obj)
+			UAVObjConnectCallback(obj, object_updated, EV_UPDATED | EV_UPDATED_MANUAL | EV_UNPACKED);
+	}
+
+	// Start logging task
+	xTaskCreate(loggingTask, (signed char *)"Logging", STACK_SIZE_BYTES/4, NULL, TASK_PRIORITY, &loggingTaskHandle);
+
+	TaskMonitorAdd(TASKINFO_RUNNING_LOGGING, loggingTaskHandle);
+
+	return 0;
+}
+
+MODULE_INITCALL(LoggingInitialize, LoggingStart)
+;
+/**
+ * Update the set of logged objects from the settings
+ */
+static void settings_updated(UAVObjEvent *ev)
+{
+	uint8_t logged[LOGGINGSETTINGS_LOGGEDOBJECTS_NUMELEM];
+	LoggingSettingsLoggedObjectsGet(logged);
+
+	uint32_t mask = 0;
+	for (uint8_t i = 0; i < LOGGINGSETTINGS_LOGGEDOBJECTS_NUMELEM; i++) {
+		if (logged[i] == LOGGINGSETTINGS_LOGGEDOBJECTS_TRUE)
+			mask |= 1 << i;
+	}
+	logged_mask = mask;
+}
+
+/**
+ * Wake up the logging task to answer a download request
+ */
+static void stats_updated(UAVObjEvent *ev)
+{
+	xSemaphoreGive(flush_sem);
+}
+
+/**
+ * Record an update of one of the loggable objects.  This runs in the
+ * event dispatcher, so it only packs the object into the RAM buffer.
+ */
+static void object_updated(UAVObjEvent *ev)
+{
+	if (!logging)
+		return;
+
+	for (uint8_t i = 0; i < NELEMENTS(logged_objects); i++) {
+		if (logged_objects[i]() == ev->obj) {
+			if (logged_mask & (1 << i))
+				UAVTalkSendObject(uavTalkCon, ev->obj, ev->instId, false, 0);
+			return;
+		}
+	}
+}
+
+/**
+ * Record the settings object selected by settings_index.  The object
+ * manager is locked while iterating, so only one object is recorded per
+ * iteration and the buffers are written out in between.
+ */
+static void log_settings(UAVObjHandle obj)
+{
+	if (UAVObjIsSettings(obj) && settings_cursor++ == settings_index) {
+		UAVTalkSendObject(uavTalkCon, obj, 0, false, 0);
+		settings_sent = true;
+	}
+}
+
+/**
+ * Logging task.  Starts and stops logs and writes full buffers to flash.
+ */
+static void loggingTask(void *parameters)
+{
+	portTickType lastStatsTime = xTaskGetTickCount();
+	bool error = false;
+
+	// Loop forever
+	while (1) {
+		xSemaphoreTake(flush_sem, MS2TICKS(LOG_CHECK_PERIOD_MS));
+
+		uint8_t behavior;
+		LoggingSettingsLogBehaviorGet(&behavior);
+
+		bool should_log;
+		switch (behavior) {
+		case LOGGINGSETTINGS_LOGBEHAVIOR_LOGONSTART:
+			should_log = true;
+			break;
+		case LOGGINGSETTINGS_LOGBEHAVIOR_LOGONARM:
+		{
+			uint8_t armed;
+			FlightStatusArmedGet(&armed);
+			should_log = (armed == FLIGHTSTATUS_ARMED_ARMED);
+			break;
+		}
+		default:
+			should_log = false;
+			break;
+		}
+
+		if (should_log && !logging && !error) {
+			if (start_log() != 0)
+				error = true;
+		} else if (!should_log && logging) {
+			stop_log();
+		} else if (logging) {
+			flush_buffers();
+
+			// Erase ahead while the buffers are empty, so writes never wait for it
+			PIOS_STREAMFS_EraseNextArena(pios_streamfs_id);
+		} else {
+			send_sector();
+		}
+
+		// Allow another attempt once logging is switched off
+		if (!should_log)
+			error = false;
+
+		portTickType now = xTaskGetTickCount();
+		if (now - lastStatsTime >= MS2TICKS(STATS_UPDATE_PERIOD_MS)) {
+			update_stats(error);
+			lastStatsTime = now;
+		}
+	}
+}
+
+/**
+ * Open a new log file and record all settings to it
+ * \return 0 on success, -1 on failure
+ */
+static int32_t start_log(void)
+{
+	// Logging takes priority over a download in progress
+	if (download_open) {
+		PIOS_STREAMFS_Close(pios_streamfs_id);
+		download_open = false;
+	}
+
+	file_id = PIOS_STREAMFS_OpenWrite(pios_streamfs_id);
+	if (file_id < 0)
+		return -1;
+
+	xSemaphoreTake(buffer_lock, portMAX_DELAY);
+	buffers.full[0] = false;
+	buffers.full[1] = false;
+	buffers.active = 0;
+	buffers.flush_next = 0;
+	buffers.fill = 0;
+	bytes_logged = 0;
+	dropped_bytes = 0;
+	log_header();
+	logging = true;
+	xSemaphoreGive(buffer_lock);
+
+	// Store the configuration at the start of every log
+	for (settings_index = 0; ; settings_index++) {
+		settings_cursor = 0;
+		settings_sent = false;
+		UAVObjIterate(&log_settings);
+		if (!settings_sent)
+			break;
+
+		flush_buffers();
+	}
+
+	return 0;
+}
+
+/**
+ * Stop recording and write what is left in the buffers to the log file
+ */
+static void stop_log(void)
+{
+	xSemaphoreTake(buffer_lock, portMAX_DELAY);
+	logging = false;
+	xSemaphoreGive(buffer_lock);
+
+	// Nothing writes to the buffers any more
+	flush_buffers();
+	if (buffers.fill > 0) {
+		if (PIOS_STREAMFS_Write(pios_streamfs_id, buffers.data[buffers.active], buffers.fill) == 0)
+			bytes_logged += buffers.fill;
+		else
+			dropped_bytes += buffers.fill;
+		buffers.fill = 0;
+	}
+
+	PIOS_STREAMFS_Close(pios_streamfs_id);
+}
+
+/**
+ * Write the full buffers to flash, oldest first
+ */
+static void flush_buffers(void)
+{
+	while (buffers.full[buffers.flush_next]) {
+		uint8_t flush = buffers.flush_next;
+
+		bool written = PIOS_STREAMFS_Write(pios_streamfs_id, buffers.data[flush], LOG_BUFFER_SIZE) == 0;
+
+		xSemaphoreTake(buffer_lock, portMAX_DELAY);
+		if (written)
+			bytes_logged += LOG_BUFFER_SIZE;
+		else
+			dropped_bytes += LOG_BUFFER_SIZE;
+		buffers.flush_next = !flush;
+		buffers.full[flush] = false;
+		xSemaphoreGive(buffer_lock);
+	}
+}
+
+/**
+ * Answer a download request from the GCS with the requested sector of a
+ * file.  Sectors are read sequentially, the file is only reopened when an
+ * earlier sector or another file is requested.
+ */
+static void send_sector(void)
+{
+	LoggingStatsData stats;
+	LoggingStatsGet(&stats);
+
+	if (stats.Operation != LOGGINGSTATS_OPERATION_DOWNLOAD)
+		return;
+
+	if (!download_open || stats.FileRequest != download_file || stats.FileSectorNum < download_sector) {
+		if (download_open)
+			PIOS_STREAMFS_Close(pios_streamfs_id);
+
+		download_open = (PIOS_STREAMFS_OpenRead(pios_streamfs_id, stats.FileRequest) == 0);
+		download_file = stats.FileRequest;
+		download_sector = 0;
+	}
+
+	int32_t bytes = -1;
+	while (download_open) {
+		bytes = PIOS_STREAMFS_Read(pios_streamfs_id, stats.FileSector, LOGGINGSTATS_FILESECTOR_NUMELEM);
+		if (bytes < 0 || download_sector++ == stats.FileSectorNum || bytes < LOGGINGSTATS_FILESECTOR_NUMELEM)
+			break;
+	}
+
+	if (bytes < 0 || download_sector != stats.FileSectorNum + 1) {
+		// Missing file, read error or a sector past the end of the file
+		if (download_open)
+			PIOS_STREAMFS_Close(pios_streamfs_id);
+		download_open = false;
+		stats.Operation = LOGGINGSTATS_OPERATION_ERROR;
+	} else {
+		stats.FileSectorBytes = bytes;
+		stats.Operation = LOGGINGSTATS_OPERATION_COMPLETE;
+	}
+
+	LoggingStatsSet(&stats);
+}
+
+/**
+ * Append bytes to the buffers, moving to the other buffer when the active
+ * one is full.  Must be called with the buffer lock held and after checking
+ * there is room.
+ */
+static void log_copy(const uint8_t *data, uint32_t length)
+{
+	while (length > 0) {
+		uint32_t copy = MIN((uint32_t)(LOG_BUFFER_SIZE - buffers.fill), length);
+		memcpy(&buffers.data[buffers.active][buffers.fill], data, copy);
+		buffers.fill += copy;
+		data += copy;
+		length -= copy;
+
+		if (buffers.fill == LOG_BUFFER_SIZE) {
+			buffers.full[buffers.active] = true;
+			buffers.active = !buffers.active;
+			buffers.fill = 0;
+			xSemaphoreGive(flush_sem);
+		}
+	}
+}
+
+/**
+ * Append the text header of the GCS LogFile: the tag and commit the firmware
+ * was built from and the hash of its UAVO definitions.  Must be called with
+ * the buffer lock held and the buffers empty.
+ */
+static void log_header(void)
+{
+	static const char hex[] = "0123456789abcdef";
+	static const char title[] = "Tau Labs git hash:\n";
+	static const char separator[] = "##\n";
+	uint8_t desc[FW_DESC_SIZE];
+	uint8_t line[2 * FW_DESC_SHA1_SIZE + 1];
+
+#if defined(PIOS_INCLUDE_BL_HELPER)
+	PIOS_BL_HELPER_FLASH_Read_Description(desc, sizeof(desc));
+#else
+	memset(desc, 0, sizeof(desc));
+#endif
+
+	log_copy((const uint8_t *) title, sizeof(title) - 1);
+
+	// Same form as the GCS revision, <tag or branch>:<commit>
+	uint8_t tag_len = 0;
+	while (tag_len < FW_DESC_TAG_SIZE && desc[FW_DESC_TAG_OFFSET + tag_len] != 0)
+		tag_len++;
+	log_copy(&desc[FW_DESC_TAG_OFFSET], tag_len);
+
+	uint32_t commit;
+	memcpy(&commit, &desc[FW_DESC_COMMIT_OFFSET], sizeof(commit));
+	line[0] = ':';
+	for (uint8_t i = 0; i < 8; i++)
+		line[1 + i] = hex[(commit >> (28 - 4 * i)) & 0xF];
+	line[9] = '\n';
+	log_copy(line, 10);
+
+	for (uint8_t i = 0; i < FW_DESC_SHA1_SIZE; i++) {
+		line[2 * i] = hex[desc[FW_DESC_UAVOSHA1_OFFSET + i] >> 4];
+		line[2 * i + 1] = hex[desc[FW_DESC_UAVOSHA1_OFFSET + i] & 0xF];
+	}
+	line[2 * FW_DESC_SHA1_SIZE] = '\n';
+	log_copy(line, sizeof(line));
+
+	log_copy((const uint8_t *) separator, sizeof(separator) - 1);
+}
+
+/**
+ * Add a UAVTalk frame to the log as one timestamped record
+ * \param[in] data Data buffer to send
+ * \param[in] length Length of buffer
+ * \return -1 on failure
+ * \return number of bytes logged on success
+ */
+static int32_t log_record(uint8_t *data, int32_t length)
+{
+	struct log_record_header header = {
+		.timestamp = TICKS2MS(xTaskGetTickCount()),
+		.size      = length,
+	};
+
+	xSemaphoreTake(buffer_lock, portMAX_DELAY);
+
+	uint32_t space = 0;
+	if (!buffers.full[buffers.active]) {
+		space = LOG_BUFFER_SIZE - buffers.fill;
+		if (!buffers.full[!buffers.active])
+			space += LOG_BUFFER_SIZE;
+	}
+
+	if (!logging || sizeof(header) + length > space) {
+		if (logging)
+			dropped_bytes += sizeof(header) + length;
+		xSemaphoreGive(buffer_lock);
+		return -1;
+	}
+
+	log_copy((const uint8_t *) &header, sizeof(header));
+	log_copy(data, length);
+
+	xSemaphoreGive(buffer_lock);
+
+	return length;
+}
+
+/**
+ * Publish the state of the logger
+ */
+static void update_stats(bool error)
+{
+	LoggingStatsData stats;
+	LoggingStatsGet(&stats);
+
+	if (error)
+		stats.Operation = LOGGINGSTATS_OPERATION_ERROR;
+	else if (logging)
+		stats.Operation = LOGGINGSTATS_OPERATION_LOGGING;
+	else if (stats.Operation != LOGGINGSTATS_OPERATION_DOWNLOAD &&
+			stats.Operation != LOGGINGSTATS_OPERATION_COMPLETE)
+		stats.Operation = LOGGINGSTATS_OPERATION_IDLE;
+
+	// The files only change while logging, avoid scanning the flash then
+	if (!logging) {
+		int32_t min_id = PIOS_STREAMFS_MinFileId(pios_streamfs_id);
+		int32_t max_id = PIOS_STREAMFS_MaxFileId(pios_streamfs_id);
+		stats.MinFileID = min_id < 0 ? 0 : min_id;
+		stats.MaxFileID = max_id < 0 ? 0 : max_id;
+	}
+
+	stats.FileID = file_id < 0 ? 0 : file_id;
+	stats.BytesLogged = bytes_logged;
+	stats.DroppedBytes = dropped_bytes;
+
+	LoggingStatsSet(&stats);
+}
+
+/**
+  * @}
+  * @}
+  */
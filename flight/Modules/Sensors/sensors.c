@@ -181,25 +181,30 @@ static void SensorsTask(void *parameters)
 		uint32_t timeval = PIOS_DELAY_GetRaw();
 
 		//Block on gyro data but nothing else
-		xQueueHandle queue;
-		queue = PIOS_SENSORS_GetQueue(PIOS_SENSOR_GYRO);
-		if(queue == NULL || xQueueReceive(queue, (void *) &gyros, SENSOR_PERIOD) == errQUEUE_EMPTY) {
+		struct pios_sensors_ring *ring;
+		ring = PIOS_SENSORS_GetRing(PIOS_SENSOR_GYRO);
+		if (ring == NULL || !PIOS_SENSORS_WaitRing(ring, SENSOR_PERIOD)) {
 			good_runs = 0;
 			continue;
 		}
 
-		queue = PIOS_SENSORS_GetQueue(PIOS_SENSOR_ACCEL);
-		if(queue == NULL || xQueueReceive(queue, (void *) &accels, 0) == errQUEUE_EMPTY) {
+		// Average every sample that arrived since the last run, so
+		// nothing is lost when this task falls behind the sensor
+		PIOS_SENSORS_PopAverage(PIOS_SENSOR_GYRO, &gyros);
+
+		if (PIOS_SENSORS_PopAverage(PIOS_SENSOR_ACCEL, &accels) == 0) {
 			//If no new accels data is ready, reuse the latest sample
 			AccelsSet(&accelsData);
 		}
-		else
+		else {
 			update_accels(&accels);
+		}
 
 		// Update gyros after the accels since the rest of the code expects
 		// the accels to be available first
 		update_gyros(&gyros);
 
+		xQueueHandle queue;
 		queue = PIOS_SENSORS_GetQueue(PIOS_SENSOR_MAG);
 		if(queue != NULL && xQueueReceive(queue, (void *) &mags, 0) != errQUEUE_EMPTY) {
 			update_mags(&mags);
@@ -59,6 +59,14 @@
 #define TASK_PRIORITY (tskIDLE_PRIORITY+3)
 #define SENSOR_PERIOD 2
 
+// Latency of the simulated GPS, real receivers report solutions 100-200 ms
+// late.  Build with e.g. -DSIM_GPS_DELAY_MS=150 to test how the state
+// estimation copes with that.
+#if !defined(SIM_GPS_DELAY_MS)
+#define SIM_GPS_DELAY_MS 0
+#endif
+#define SIM_GPS_HISTORY_LEN (SIM_GPS_DELAY_MS / SENSOR_PERIOD + 1)
+
 // Private types
 
 // Private variables
@@ -77,6 +85,9 @@ static void magOffsetEstimation(MagnetometerData *mag);
 static float accel_bias[3];
 
 static float rand_gauss();
+static void publish_gyros(GyrosData *gyrosData);
+static void publish_accels(AccelsData *accelsData);
+static void gps_delay(const double pos[3], const double vel[3], double gps_pos[3], double gps_vel[3]);
 
 enum sensor_sim_type {CONSTANT, MODEL_AGNOSTIC, MODEL_QUADCOPTER, MODEL_AIRPLANE, MODEL_CAR} sensor_sim_type;
 
@@ -206,7 +217,7 @@ static void simulateConstant()
 	accelsData.y = 0;
 	accelsData.z = -GRAVITY;
 	accelsData.temperature = 0;
-	AccelsSet(&accelsData);
+	publish_accels(&accelsData);
 
 	GyrosData gyrosData; // Skip get as we set all the fields
 	gyrosData.x = 0;
@@ -220,7 +231,7 @@ static void simulateConstant()
 	gyrosData.y += gyrosBias.y;
 	gyrosData.z += gyrosBias.z;
 
-	GyrosSet(&gyrosData);
+	publish_gyros(&gyrosData);
 
 	BaroAltitudeData baroAltitude;
 	BaroAltitudeGet(&baroAltitude);
@@ -262,7 +273,7 @@ static void simulateModelAgnostic()
 	accelsData.y = -GRAVITY * Rbe[1][2];
 	accelsData.z = -GRAVITY * Rbe[2][2];
 	accelsData.temperature = 30;
-	AccelsSet(&accelsData);
+	publish_accels(&accelsData);
 
 	RateDesiredData rateDesired;
 	RateDesiredGet(&rateDesired);
@@ -279,7 +290,7 @@ static void simulateModelAgnostic()
 	gyrosData.y += gyrosBias.y;
 	gyrosData.z += gyrosBias.z;
 
-	GyrosSet(&gyrosData);
+	publish_gyros(&gyrosData);
 
 	BaroAltitudeData baroAltitude;
 	BaroAltitudeGet(&baroAltitude);
@@ -366,7 +377,7 @@ static void simulateModelQuadcopter()
 	gyrosData.y = rpy[1] + rand_gauss() + (temperature - 20) * 1 + powf(temperature - 20,2) * 0.11;;
 	gyrosData.z = rpy[2] + rand_gauss() + (temperature - 20) * 1 + powf(temperature - 20,2) * 0.11;;
 	gyrosData.temperature = temperature;
-	GyrosSet(&gyrosData);
+	publish_gyros(&gyrosData);
 	
 	// Predict the attitude forward in time
 	float qdot[4];
@@ -440,7 +451,7 @@ static void simulateModelQuadcopter()
 	accelsData.y = ned_accel[0] * Rbe[1][0] + ned_accel[1] * Rbe[1][1] + ned_accel[2] * Rbe[1][2] + accel_bias[1];
 	accelsData.z = ned_accel[0] * Rbe[2][0] + ned_accel[1] * Rbe[2][1] + ned_accel[2] * Rbe[2][2] + accel_bias[2];
 	accelsData.temperature = 30;
-	AccelsSet(&accelsData);
+	publish_accels(&accelsData);
 
 	if(baro_offset == 0) {
 		// Hacky initialization
@@ -467,6 +478,10 @@ static void simulateModelQuadcopter()
 	gps_vel_drift[1] = gps_vel_drift[1] * 0.65 + rand_gauss() / 5.0;
 	gps_vel_drift[2] = gps_vel_drift[2] * 0.65 + rand_gauss() / 5.0;
 
+	// The receiver reports the vehicle as it was a while ago
+	double gps_pos[3], gps_vel[3];
+	gps_delay(pos, vel, gps_pos, gps_vel);
+
 	// Update GPS periodically	
 	static uint32_t last_gps_time = 0;
 	if(PIOS_DELAY_DiffuS(last_gps_time) / 1.0e6 > GPS_PERIOD) {
@@ -483,11 +498,11 @@ static void simulateModelQuadcopter()
 
 		GPSPositionData gpsPosition;
 		GPSPositionGet(&gpsPosition);
-		gpsPosition.Latitude = homeLocation.Latitude + ((pos[0] + gps_drift[0]) / T[0] * 10.0e6);
-		gpsPosition.Longitude = homeLocation.Longitude + ((pos[1] + gps_drift[1])/ T[1] * 10.0e6);
-		gpsPosition.Altitude = homeLocation.Altitude + ((pos[2] + gps_drift[2]) / T[2]);
-		gpsPosition.Groundspeed = sqrtf(pow(vel[0] + gps_vel_drift[0],2) + pow(vel[1] + gps_vel_drift[1],2));
-		gpsPosition.Heading = 180 / M_PI * atan2f(vel[1] + gps_vel_drift[1],vel[0] + gps_vel_drift[0]);
+		gpsPosition.Latitude = homeLocation.Latitude + ((gps_pos[0] + gps_drift[0]) / T[0] * 10.0e6);
+		gpsPosition.Longitude = homeLocation.Longitude + ((gps_pos[1] + gps_drift[1])/ T[1] * 10.0e6);
+		gpsPosition.Altitude = homeLocation.Altitude + ((gps_pos[2] + gps_drift[2]) / T[2]);
+		gpsPosition.Groundspeed = sqrtf(pow(gps_vel[0] + gps_vel_drift[0],2) + pow(gps_vel[1] + gps_vel_drift[1],2));
+		gpsPosition.Heading = 180 / M_PI * atan2f(gps_vel[1] + gps_vel_drift[1],gps_vel[0] + gps_vel_drift[0]);
 		gpsPosition.Satellites = 7;
 		gpsPosition.PDOP = 1;
 		gpsPosition.Status = GPSPOSITION_STATUS_FIX3D;
@@ -500,9 +515,9 @@ static void simulateModelQuadcopter()
 	if(PIOS_DELAY_DiffuS(last_gps_vel_time) / 1.0e6 > GPS_PERIOD) {
 		GPSVelocityData gpsVelocity;
 		GPSVelocityGet(&gpsVelocity);
-		gpsVelocity.North = vel[0] + gps_vel_drift[0];
-		gpsVelocity.East = vel[1] + gps_vel_drift[1];
-		gpsVelocity.Down = vel[2] + gps_vel_drift[2];
+		gpsVelocity.North = gps_vel[0] + gps_vel_drift[0];
+		gpsVelocity.East = gps_vel[1] + gps_vel_drift[1];
+		gpsVelocity.Down = gps_vel[2] + gps_vel_drift[2];
 		GPSVelocitySet(&gpsVelocity);
 		last_gps_vel_time = PIOS_DELAY_GetRaw();
 	}
@@ -618,7 +633,7 @@ static void simulateModelAirplane()
 	gyrosData.x = rpy[0] + rand_gauss();
 	gyrosData.y = rpy[1] + rand_gauss();
 	gyrosData.z = rpy[2] + rand_gauss();
-	GyrosSet(&gyrosData);
+	publish_gyros(&gyrosData);
 	
 	// Predict the attitude forward in time
 	float qdot[4];
@@ -721,7 +736,7 @@ static void simulateModelAirplane()
 	accelsData.y = ned_accel[0] * Rbe[1][0] + ned_accel[1] * Rbe[1][1] + ned_accel[2] * Rbe[1][2] + accel_bias[1];
 	accelsData.z = ned_accel[0] * Rbe[2][0] + ned_accel[1] * Rbe[2][1] + ned_accel[2] * Rbe[2][2] + accel_bias[2];
 	accelsData.temperature = 30;
-	AccelsSet(&accelsData);
+	publish_accels(&accelsData);
 	
 	if(baro_offset == 0) {
 		// Hacky initialization
@@ -760,6 +775,10 @@ static void simulateModelAirplane()
 	gps_vel_drift[1] = gps_vel_drift[1] * 0.65 + rand_gauss() / 5.0;
 	gps_vel_drift[2] = gps_vel_drift[2] * 0.65 + rand_gauss() / 5.0;
 	
+	// The receiver reports the vehicle as it was a while ago
+	double gps_pos[3], gps_vel[3];
+	gps_delay(pos, vel, gps_pos, gps_vel);
+
 	// Update GPS periodically	
 	static uint32_t last_gps_time = 0;
 	if(PIOS_DELAY_DiffuS(last_gps_time) / 1.0e6 > GPS_PERIOD) {
@@ -776,11 +795,11 @@ static void simulateModelAirplane()
 		
 		GPSPositionData gpsPosition;
 		GPSPositionGet(&gpsPosition);
-		gpsPosition.Latitude = homeLocation.Latitude + ((pos[0] + gps_drift[0]) / T[0] * 10.0e6);
-		gpsPosition.Longitude = homeLocation.Longitude + ((pos[1] + gps_drift[1])/ T[1] * 10.0e6);
-		gpsPosition.Altitude = homeLocation.Altitude + ((pos[2] + gps_drift[2]) / T[2]);
-		gpsPosition.Groundspeed = sqrtf(pow(vel[0] + gps_vel_drift[0],2) + pow(vel[1] + gps_vel_drift[1],2));
-		gpsPosition.Heading = 180 / M_PI * atan2f(vel[1] + gps_vel_drift[1],vel[0] + gps_vel_drift[0]);
+		gpsPosition.Latitude = homeLocation.Latitude + ((gps_pos[0] + gps_drift[0]) / T[0] * 10.0e6);
+		gpsPosition.Longitude = homeLocation.Longitude + ((gps_pos[1] + gps_drift[1])/ T[1] * 10.0e6);
+		gpsPosition.Altitude = homeLocation.Altitude + ((gps_pos[2] + gps_drift[2]) / T[2]);
+		gpsPosition.Groundspeed = sqrtf(pow(gps_vel[0] + gps_vel_drift[0],2) + pow(gps_vel[1] + gps_vel_drift[1],2));
+		gpsPosition.Heading = 180 / M_PI * atan2f(gps_vel[1] + gps_vel_drift[1],gps_vel[0] + gps_vel_drift[0]);
 		gpsPosition.Satellites = 7;
 		gpsPosition.PDOP = 1;
 		GPSPositionSet(&gpsPosition);
@@ -792,9 +811,9 @@ static void simulateModelAirplane()
 	if(PIOS_DELAY_DiffuS(last_gps_vel_time) / 1.0e6 > GPS_PERIOD) {
 		GPSVelocityData gpsVelocity;
 		GPSVelocityGet(&gpsVelocity);
-		gpsVelocity.North = vel[0] + gps_vel_drift[0];
-		gpsVelocity.East = vel[1] + gps_vel_drift[1];
-		gpsVelocity.Down = vel[2] + gps_vel_drift[2];
+		gpsVelocity.North = gps_vel[0] + gps_vel_drift[0];
+		gpsVelocity.East = gps_vel[1] + gps_vel_drift[1];
+		gpsVelocity.Down = gps_vel[2] + gps_vel_drift[2];
 		GPSVelocitySet(&gpsVelocity);
 		last_gps_vel_time = PIOS_DELAY_GetRaw();
 	}
@@ -901,7 +920,7 @@ static void simulateModelCar()
 	gyrosData.x = rpy[0] + rand_gauss();
 	gyrosData.y = rpy[1] + rand_gauss();
 	gyrosData.z = rpy[2] + rand_gauss();
-	GyrosSet(&gyrosData);
+	publish_gyros(&gyrosData);
 	
 	// Predict the attitude forward in time
 	float qdot[4];
@@ -984,7 +1003,7 @@ static void simulateModelCar()
 	accelsData.y = ned_accel[0] * Rbe[1][0] + ned_accel[1] * Rbe[1][1] + ned_accel[2] * Rbe[1][2] + accel_bias[1];
 	accelsData.z = ned_accel[0] * Rbe[2][0] + ned_accel[1] * Rbe[2][1] + ned_accel[2] * Rbe[2][2] + accel_bias[2];
 	accelsData.temperature = 30;
-	AccelsSet(&accelsData);
+	publish_accels(&accelsData);
 	
 	if(baro_offset == 0) {
 		// Hacky initialization
@@ -1011,6 +1030,10 @@ static void simulateModelCar()
 	gps_vel_drift[1] = gps_vel_drift[1] * 0.65 + rand_gauss() / 5.0;
 	gps_vel_drift[2] = gps_vel_drift[2] * 0.65 + rand_gauss() / 5.0;
 	
+	// The receiver reports the vehicle as it was a while ago
+	double gps_pos[3], gps_vel[3];
+	gps_delay(pos, vel, gps_pos, gps_vel);
+
 	// Update GPS periodically	
 	static uint32_t last_gps_time = 0;
 	if(PIOS_DELAY_DiffuS(last_gps_time) / 1.0e6 > GPS_PERIOD) {
@@ -1027,11 +1050,11 @@ static void simulateModelCar()
 		
 		GPSPositionData gpsPosition;
 		GPSPositionGet(&gpsPosition);
-		gpsPosition.Latitude = homeLocation.Latitude + ((pos[0] + gps_drift[0]) / T[0] * 10.0e6);
-		gpsPosition.Longitude = homeLocation.Longitude + ((pos[1] + gps_drift[1])/ T[1] * 10.0e6);
-		gpsPosition.Altitude = homeLocation.Altitude + ((pos[2] + gps_drift[2]) / T[2]);
-		gpsPosition.Groundspeed = sqrtf(pow(vel[0] + gps_vel_drift[0],2) + pow(vel[1] + gps_vel_drift[1],2));
-		gpsPosition.Heading = 180 / M_PI * atan2f(vel[1] + gps_vel_drift[1],vel[0] + gps_vel_drift[0]);
+		gpsPosition.Latitude = homeLocation.Latitude + ((gps_pos[0] + gps_drift[0]) / T[0] * 10.0e6);
+		gpsPosition.Longitude = homeLocation.Longitude + ((gps_pos[1] + gps_drift[1])/ T[1] * 10.0e6);
+		gpsPosition.Altitude = homeLocation.Altitude + ((gps_pos[2] + gps_drift[2]) / T[2]);
+		gpsPosition.Groundspeed = sqrtf(pow(gps_vel[0] + gps_vel_drift[0],2) + pow(gps_vel[1] + gps_vel_drift[1],2));
+		gpsPosition.Heading = 180 / M_PI * atan2f(gps_vel[1] + gps_vel_drift[1],gps_vel[0] + gps_vel_drift[0]);
 		gpsPosition.Satellites = 7;
 		gpsPosition.PDOP = 1;
 		GPSPositionSet(&gpsPosition);
@@ -1043,9 +1066,9 @@ static void simulateModelCar()
 	if(PIOS_DELAY_DiffuS(last_gps_vel_time) / 1.0e6 > GPS_PERIOD) {
 		GPSVelocityData gpsVelocity;
 		GPSVelocityGet(&gpsVelocity);
-		gpsVelocity.North = vel[0] + gps_vel_drift[0];
-		gpsVelocity.East = vel[1] + gps_vel_drift[1];
-		gpsVelocity.Down = vel[2] + gps_vel_drift[2];
+		gpsVelocity.North = gps_vel[0] + gps_vel_drift[0];
+		gpsVelocity.East = gps_vel[1] + gps_vel_drift[1];
+		gpsVelocity.Down = gps_vel[2] + gps_vel_drift[2];
 		GPSVelocitySet(&gpsVelocity);
 		last_gps_vel_time = PIOS_DELAY_GetRaw();
 	}
@@ -1079,6 +1102,81 @@ static void simulateModelCar()
 }
 
 
+/**
+ * Delay the true position and velocity by SIM_GPS_DELAY_MS for the GPS.
+ * Called once per sensor period.
+ * @param[in] pos The current position
+ * @param[in] vel The current velocity
+ * @param[out] gps_pos The position SIM_GPS_DELAY_MS ago
+ * @param[out] gps_vel The velocity SIM_GPS_DELAY_MS ago
+ */
+/**
+ * Pass a simulated gyro sample through the gyro ring like a driver would, so
+ * the ring and the taps on it are used on the simulator too, then publish it
+ */
+static void publish_gyros(GyrosData *gyrosData)
+{
+	struct pios_sensor_gyro_data sample = {
+		gyrosData->x, gyrosData->y, gyrosData->z, gyrosData->temperature
+	};
+	struct pios_sensors_ring *ring = PIOS_SENSORS_GetRing(PIOS_SENSOR_GYRO);
+
+	if (ring != NULL) {
+		PIOS_SENSORS_Push(ring, &sample);
+		if (PIOS_SENSORS_PopAverage(PIOS_SENSOR_GYRO, &sample) > 0) {
+			gyrosData->x = sample.x;
+			gyrosData->y = sample.y;
+			gyrosData->z = sample.z;
+			gyrosData->temperature = sample.temperature;
+		}
+	}
+
+	GyrosSet(gyrosData);
+}
+
+/**
+ * Pass a simulated accel sample through the accel ring, see @ref publish_gyros
+ */
+static void publish_accels(AccelsData *accelsData)
+{
+	struct pios_sensor_accel_data sample = {
+		accelsData->x, accelsData->y, accelsData->z, accelsData->temperature
+	};
+	struct pios_sensors_ring *ring = PIOS_SENSORS_GetRing(PIOS_SENSOR_ACCEL);
+
+	if (ring != NULL) {
+		PIOS_SENSORS_Push(ring, &sample);
+		if (PIOS_SENSORS_PopAverage(PIOS_SENSOR_ACCEL, &sample) > 0) {
+			accelsData->x = sample.x;
+			accelsData->y = sample.y;
+			accelsData->z = sample.z;
+			accelsData->temperature = sample.temperature;
+		}
+	}
+
+	AccelsSet(accelsData);
+}
+
+static void gps_delay(const double pos[3], const double vel[3], double gps_pos[3], double gps_vel[3])
+{
+	static double pos_history[SIM_GPS_HISTORY_LEN][3];
+	static double vel_history[SIM_GPS_HISTORY_LEN][3];
+	static uint32_t head;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		pos_history[head][i] = pos[i];
+		vel_history[head][i] = vel[i];
+	}
+
+	// The oldest sample is the one overwritten next
+	head = (head + 1) % SIM_GPS_HISTORY_LEN;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		gps_pos[i] = pos_history[head][i];
+		gps_vel[i] = vel_history[head][i];
+	}
+}
+
 static float rand_gauss (void) {
 	float v1,v2,s;
 	
@@ -45,13 +45,17 @@
 #include "cameradesired.h"
 #include "flightstatus.h"
 #include "gyros.h"
+#include "notchfiltersettings.h"
+#include "notchfilterstatus.h"
 #include "ratedesired.h"
 #include "stabilizationdesired.h"
 #include "stabilizationsettings.h"
 #include "trimangles.h"
 #include "trimanglessettings.h"
+#include "vibrationanalysispeak.h"
 
 // Math libraries
+#include "biquad.h"
 #include "coordinate_conversions.h"
 #include "pid.h"
 #include "sin_lookup.h"
@@ -75,6 +79,13 @@
 #define COORDINATED_FLIGHT_MIN_ROLL_THRESHOLD 3.0f
 #define COORDINATED_FLIGHT_MAX_YAW_THRESHOLD 0.05f
 
+// Notch filter bank on the gyro input
+#define NOTCH_MAX 3
+#define NOTCH_RETUNE_HZ 1.0f         // Move in the tracked peak before recomputing the coefficients
+#define NOTCH_RETUNE_RATE 0.02f      // Relative change in the loop rate before recomputing them
+#define NOTCH_RATE_ALPHA 0.99f       // Smoothing of the loop period the coefficients are computed for
+#define NOTCH_STATUS_PERIOD 1.0f     // Seconds between NotchFilterStatus updates
+
 enum {
 	PID_RATE_ROLL,   // Rate controller settings
 	PID_RATE_PITCH,
@@ -105,10 +116,20 @@ bool lowThrottleZeroIntegral;
 float vbar_decay = 0.991f;
 struct pid pids[PID_MAX];
 
+static NotchFilterSettingsData notchSettings;
+static struct biquad notches[MAX_AXES][NOTCH_MAX];
+static float notch_target[MAX_AXES];      // Requested center of the first notch, 0 when off
+static float notch_center[MAX_AXES];      // Center the coefficients were computed for
+static float notch_sample_rate;           // Loop rate the coefficients were computed for
+static volatile bool notch_reconfigure;
+static UAVObjHandle vibration_peak_handle;
+
 // Private functions
 static void stabilizationTask(void* parameters);
 static void ZeroPids(void);
 static void SettingsUpdatedCb(UAVObjEvent * ev);
+static void VibrationPeakUpdatedCb(UAVObjEvent * ev);
+static void notch_filter_apply(float gyro[MAX_AXES], float dT);
 
 /**
  * Module initialization
@@ -126,6 +147,13 @@ int32_t StabilizationStart()
 	// Connect settings callback
 	StabilizationSettingsConnectCallback(SettingsUpdatedCb);
 	TrimAnglesSettingsConnectCallback(SettingsUpdatedCb);
+	NotchFilterSettingsConnectCallback(SettingsUpdatedCb);
+
+	// Follow the vibration peaks when the spectrum analyzer is running. Look
+	// the object up by id as it is not built into every target.
+	vibration_peak_handle = UAVObjGetByID(VIBRATIONANALYSISPEAK_OBJID);
+	if (vibration_peak_handle)
+		UAVObjConnectCallback(vibration_peak_handle, VibrationPeakUpdatedCb, EV_MASK_ALL_UPDATES);
 
 	// Start main task
 	xTaskCreate(stabilizationTask, (signed char*)"Stabilization", STACK_SIZE_BYTES/4, NULL, TASK_PRIORITY, &taskHandle);
@@ -144,6 +172,8 @@ int32_t StabilizationInitialize()
 	ActuatorDesiredInitialize();
 	TrimAnglesInitialize();
 	TrimAnglesSettingsInitialize();
+	NotchFilterSettingsInitialize();
+	NotchFilterStatusInitialize();
 #if defined(RATEDESIRED_DIAGNOSTICS)
 	RateDesiredInitialize();
 #endif
@@ -280,10 +310,14 @@ static void stabilizationTask(void* parameters)
 		local_attitude_error[2] = circular_modulus_deg(local_attitude_error[2]);
 #endif
 
+		// Remove the resonances with the notches before the low pass filter
+		float gyro_notched[MAX_AXES] = {gyrosData.x, gyrosData.y, gyrosData.z};
+		notch_filter_apply(gyro_notched, dT);
+
 		static float gyro_filtered[3];
-		gyro_filtered[0] = gyro_filtered[0] * gyro_alpha + gyrosData.x * (1 - gyro_alpha);
-		gyro_filtered[1] = gyro_filtered[1] * gyro_alpha + gyrosData.y * (1 - gyro_alpha);
-		gyro_filtered[2] = gyro_filtered[2] * gyro_alpha + gyrosData.z * (1 - gyro_alpha);
+		gyro_filtered[0] = gyro_filtered[0] * gyro_alpha + gyro_notched[0] * (1 - gyro_alpha);
+		gyro_filtered[1] = gyro_filtered[1] * gyro_alpha + gyro_notched[1] * (1 - gyro_alpha);
+		gyro_filtered[2] = gyro_filtered[2] * gyro_alpha + gyro_notched[2] * (1 - gyro_alpha);
 
 		// A flag to track which stabilization mode each axis is in
 		static uint8_t previous_mode[MAX_AXES] = {255,255,255};
@@ -564,6 +598,117 @@ static void ZeroPids(void)
 		axis_lock_accum[i] = 0.0f;
 }
 
+/**
+ * Run the gyro rates through the notch filter bank. The coefficients are
+ * only recomputed when the requested centers or the loop rate have moved.
+ * @param[in,out] gyro The gyro rates for each axis, filtered in place
+ * @param[in] dT The time since the last call
+ */
+static void notch_filter_apply(float gyro[MAX_AXES], float dT)
+{
+	static float notch_dT;
+	static float cycles_average;
+	static uint32_t cycles_max;
+	static float status_time;
+
+	if (notchSettings.Mode == NOTCHFILTERSETTINGS_MODE_DISABLED) {
+		// Restart the filters from the current rates when enabled again
+		for (uint8_t i = 0; i < MAX_AXES; i++)
+			notch_center[i] = 0;
+		return;
+	}
+
+	uint32_t start = PIOS_DELAY_GetRaw();
+
+	if (dT > 0)
+		notch_dT = (notch_dT > 0) ? notch_dT * NOTCH_RATE_ALPHA + dT * (1 - NOTCH_RATE_ALPHA) : dT;
+	if (!(notch_dT > 0))
+		return;
+
+	const float sample_rate = 1.0f / notch_dT;
+	bool reconfigure = notch_reconfigure ||
+	        fabsf(sample_rate - notch_sample_rate) > NOTCH_RETUNE_RATE * notch_sample_rate;
+	notch_reconfigure = false;
+	if (reconfigure)
+		notch_sample_rate = sample_rate;
+
+	const uint8_t num_notches = bound_min_max(notchSettings.Notches, 1, NOTCH_MAX);
+	const float q = notchSettings.Q;
+
+	for (uint8_t i = 0; i < MAX_AXES; i++) {
+		const float target = notch_target[i];
+
+		if (reconfigure || fabsf(target - notch_center[i]) > NOTCH_RETUNE_HZ) {
+			for (uint8_t j = 0; j < NOTCH_MAX; j++) {
+				if (j < num_notches && target > 0)
+					biquad_configure_notch(&notches[i][j], target * (j + 1), q, notch_sample_rate);
+				else
+					biquad_configure_passthrough(&notches[i][j]);
+
+				// Start from the current rate instead of stale history
+				if (notch_center[i] == 0)
+					biquad_reset(&notches[i][j], gyro[i]);
+			}
+			notch_center[i] = target;
+		}
+
+		if (notch_center[i] > 0)
+			for (uint8_t j = 0; j < num_notches; j++)
+				gyro[i] = biquad_apply(&notches[i][j], gyro[i]);
+	}
+
+	uint32_t cycles = PIOS_DELAY_GetRaw() - start;
+	cycles_average = cycles_average * 0.99f + cycles * 0.01f;
+	if (cycles > cycles_max)
+		cycles_max = cycles;
+
+	status_time += dT;
+	if (status_time > NOTCH_STATUS_PERIOD) {
+		NotchFilterStatusData notchStatus;
+		notchStatus.Frequency[NOTCHFILTERSTATUS_FREQUENCY_ROLL] = notch_center[ROLL];
+		notchStatus.Frequency[NOTCHFILTERSTATUS_FREQUENCY_PITCH] = notch_center[PITCH];
+		notchStatus.Frequency[NOTCHFILTERSTATUS_FREQUENCY_YAW] = notch_center[YAW];
+		notchStatus.SampleRate = notch_sample_rate;
+		notchStatus.FilterCycles[NOTCHFILTERSTATUS_FILTERCYCLES_AVERAGE] = cycles_average;
+		notchStatus.FilterCycles[NOTCHFILTERSTATUS_FILTERCYCLES_MAX] = cycles_max;
+		NotchFilterStatusSet(&notchStatus);
+
+		status_time = 0;
+		cycles_max = 0;
+	}
+}
+
+/**
+ * Move the notches onto the strongest gyro vibration.  The peaks are found on
+ * the axes of the sensor, which only match the body axes without a board
+ * rotation, so the strongest one of them is used for all axes.
+ */
+static void VibrationPeakUpdatedCb(UAVObjEvent * ev)
+{
+	if (notchSettings.Mode != NOTCHFILTERSETTINGS_MODE_DYNAMIC)
+		return;
+
+	VibrationAnalysisPeakData peak;
+	UAVObjGetData(vibration_peak_handle, &peak);
+
+	// Accel vibration is not what the notches remove from the gyros
+	if (peak.Source != VIBRATIONANALYSISPEAK_SOURCE_RAWGYROS)
+		return;
+
+	uint8_t strongest = 0;
+	for (uint8_t i = 1; i < MAX_AXES; i++)
+		if (peak.Amplitude[i] > peak.Amplitude[strongest])
+			strongest = i;
+
+	// No peak was found, keep the last one
+	if (!(peak.Frequency[strongest] > 0))
+		return;
+
+	const float target = bound_min_max(peak.Frequency[strongest], notchSettings.MinFrequency, notchSettings.MaxFrequency);
+	for (uint8_t i = 0; i < MAX_AXES; i++)
+		notch_target[i] = target;
+}
+
 
 static void SettingsUpdatedCb(UAVObjEvent * ev)
 {
@@ -581,6 +726,31 @@ static void SettingsUpdatedCb(UAVObjEvent * ev)
 		TrimAnglesSet(&trimAngles);
 	}
 
+	if (ev == NULL || ev->obj == NotchFilterSettingsHandle())
+	{
+		NotchFilterSettingsGet(&notchSettings);
+
+		// Start dynamic tracking from the static frequencies until a peak is found
+		for (uint8_t i = 0; i < MAX_AXES; i++) {
+			switch (notchSettings.Mode) {
+			case NOTCHFILTERSETTINGS_MODE_STATIC:
+				notch_target[i] = notchSettings.Frequency[i];
+				break;
+			case NOTCHFILTERSETTINGS_MODE_DYNAMIC:
+				notch_target[i] = bound_min_max(notchSettings.Frequency[i], notchSettings.MinFrequency, notchSettings.MaxFrequency);
+				break;
+			default:
+				notch_target[i] = 0;
+				break;
+			}
+		}
+
+		notch_reconfigure = true;
+
+		if (notchSettings.Mode == NOTCHFILTERSETTINGS_MODE_DYNAMIC && vibration_peak_handle)
+			VibrationPeakUpdatedCb(NULL);
+	}
+
 	if (ev == NULL || ev->obj == StabilizationSettingsHandle())
 	{
 		StabilizationSettingsGet(&settings);
@@ -52,6 +52,7 @@
 // Private constants
 #define SYSTEM_UPDATE_PERIOD_MS 1000
 #define LED_BLINK_RATE_HZ 5
+#define SETTINGS_GC_SLOTS_PER_STEP 16
 
 #ifndef IDLE_COUNTS_PER_SEC_AT_NO_LOAD
 #define IDLE_COUNTS_PER_SEC_AT_NO_LOAD 995998	// calibrated by running tests/test_cpuload.c
@@ -189,6 +190,13 @@ static void systemTask(void *parameters)
 		TaskMonitorUpdateAll();
 #endif
 
+#if defined(PIOS_INCLUDE_LOGFS_SETTINGS)
+		// Collect the settings log a little at a time so that saves
+		// don't have to stall while the whole log is compacted
+		extern uintptr_t pios_uavo_settings_fs_id;
+		PIOS_FLASHFS_GarbageCollect(pios_uavo_settings_fs_id, SETTINGS_GC_SLOTS_PER_STEP);
+#endif
+
 		// Flash the heartbeat LED
 #if defined(PIOS_LED_HEARTBEAT)
 		PIOS_LED_Toggle(PIOS_LED_HEARTBEAT);
@@ -425,6 +433,11 @@ static void updateStats()
 	const float STM32_TEMP_AVG_SLOPE = 4.3; /* mV/C */
 	stats.CPUTemp = (temp_voltage-STM32_TEMP_V25) * 1000 / STM32_TEMP_AVG_SLOPE + 25;
 #endif
+
+	// Samples the sensor drivers dropped because nothing drained their rings
+	stats.SensorOverruns[SYSTEMSTATS_SENSOROVERRUNS_GYRO] = PIOS_SENSORS_GetOverruns(PIOS_SENSOR_GYRO);
+	stats.SensorOverruns[SYSTEMSTATS_SENSOROVERRUNS_ACCEL] = PIOS_SENSORS_GetOverruns(PIOS_SENSOR_ACCEL);
+
 	SystemStatsSet(&stats);
 }
 
@@ -484,14 +497,24 @@ static void updateSystemAlarms()
 		AlarmsClear(SYSTEMALARMS_ALARM_EVENTSYSTEM);
 	}
 	
+	SystemStatsData sysStats;
+	SystemStatsGet(&sysStats);
 	if (objStats.lastCallbackErrorID || objStats.lastQueueErrorID || evStats.lastErrorID) {
-		SystemStatsData sysStats;
-		SystemStatsGet(&sysStats);
 		sysStats.EventSystemWarningID = evStats.lastErrorID;
 		sysStats.ObjectManagerCallbackID = objStats.lastCallbackErrorID;
 		sysStats.ObjectManagerQueueID = objStats.lastQueueErrorID;
-		SystemStatsSet(&sysStats);
 	}
+
+	// Periodic event and object manager lock statistics for the last period
+	sysStats.EventSystemMaxLatency = evStats.periodicMaxLatencyMs;
+	sysStats.ObjectManagerLockContentions = objStats.lockContentions;
+	sysStats.ObjectManagerMaxLockHold = objStats.lockMaxHoldUs;
+	sysStats.ObjectManagerReadRetries = objStats.seqReadRetries;
+
+	// Saves are rare, keep the worst case seen since boot
+	if (objStats.saveMaxUs > sysStats.ObjectManagerMaxSaveTime)
+		sysStats.ObjectManagerMaxSaveTime = objStats.saveMaxUs;
+	SystemStatsSet(&sysStats);
 		
 }
 
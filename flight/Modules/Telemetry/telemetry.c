@@ -43,6 +43,8 @@
 #define MAX_RETRIES 2
 #define STATS_UPDATE_PERIOD_MS 4000
 #define CONNECTION_TIMEOUT_MS 8000
+#define RX_CHUNK_SIZE 64
+#define TX_BATCH_SIZE 8
 
 // Private types
 
@@ -64,15 +66,20 @@ static uint32_t txErrors;
 static uint32_t txRetries;
 static uint32_t timeOfLastObjectUpdate;
 static UAVTalkConnection uavTalkCon;
+static uintptr_t txReservedPort;
 
 // Private functions
 static void telemetryTxTask(void *parameters);
 static void telemetryRxTask(void *parameters);
 static int32_t transmitData(uint8_t * data, int32_t length);
+static uint8_t *reserveTransmitData(uint16_t length);
+static int32_t commitTransmitData(uint16_t length, bool flush);
 static void registerObject(UAVObjHandle obj);
 static void updateObject(UAVObjHandle obj, int32_t eventType);
 static int32_t setUpdatePeriod(UAVObjHandle obj, int32_t updatePeriodMs);
 static void processObjEvent(UAVObjEvent * ev);
+static void sendObject(UAVObjHandle obj, uint16_t instId, UAVObjMetadata *metadata);
+static void transactionCompleted(UAVObjHandle obj, uint16_t instId, bool success, uint8_t retries);
 static void updateTelemetryStats();
 static void gcsTelemetryStatsUpdated();
 static void updateSettings();
@@ -130,6 +137,7 @@ int32_t TelemetryInitialize(void)
     
 	// Initialise UAVTalk
 	uavTalkCon = UAVTalkInitialize(&transmitData);
+	UAVTalkSetZeroCopyStream(uavTalkCon, &reserveTransmitData, &commitTransmitData);
     
 	// Create periodic event that will be used to update the telemetry stats
 	txErrors = 0;
@@ -248,6 +256,36 @@ static void updateObject(UAVObjHandle obj, int32_t eventType)
 	}
 }
 
+/**
+ * Send an object to the GCS.  Acked objects are pipelined so that several
+ * can wait for their ACK at once, the result is counted by transactionCompleted().
+ */
+static void sendObject(UAVObjHandle obj, uint16_t instId, UAVObjMetadata *metadata)
+{
+	int32_t success;
+
+	if (UAVObjGetTelemetryAcked(metadata))
+		success = UAVTalkSendObjectPipelined(uavTalkCon, obj, instId, MAX_RETRIES - 1, REQ_TIMEOUT_MS, &transactionCompleted);
+	else
+		success = UAVTalkSendObject(uavTalkCon, obj, instId, 0, 0);
+
+	if (success == -1) {
+		__sync_fetch_and_add(&txErrors, 1);
+	}
+}
+
+/**
+ * Called by UAVTalk when a pipelined transaction is acknowledged or fails
+ */
+static void transactionCompleted(UAVObjHandle obj, uint16_t instId, bool success, uint8_t retries)
+{
+	// Update stats, this runs in the RX and TX tasks alike
+	__sync_fetch_and_add(&txRetries, retries);
+	if (!success) {
+		__sync_fetch_and_add(&txErrors, 1);
+	}
+}
+
 /**
  * Processes queue events
  */
@@ -256,8 +294,6 @@ static void processObjEvent(UAVObjEvent * ev)
 	UAVObjMetadata metadata;
 	UAVObjUpdateMode updateMode;
 	FlightTelemetryStatsData flightStats;
-	int32_t retries;
-	int32_t success;
 
 	if (ev->obj == 0) {
 		updateTelemetryStats();
@@ -270,45 +306,21 @@ static void processObjEvent(UAVObjEvent * ev)
 		updateMode = UAVObjGetTelemetryUpdateMode(&metadata);
 
 		// Act on event
-		retries = 0;
-		success = -1;
 		if (ev->event == EV_UPDATED || ev->event == EV_UPDATED_MANUAL || ((ev->event == EV_UPDATED_PERIODIC) && (updateMode != UPDATEMODE_THROTTLED))) {
-			// Send update to GCS (with retries)
-			while (retries < MAX_RETRIES && success == -1) {
-				success = UAVTalkSendObject(uavTalkCon, ev->obj, ev->instId, UAVObjGetTelemetryAcked(&metadata), REQ_TIMEOUT_MS);	// call blocks until ack is received or timeout
-				++retries;
-			}
-			// Update stats
-			txRetries += (retries - 1);
-			if (success == -1) {
-				++txErrors;
-			}
+			// Send update to GCS
+			sendObject(ev->obj, ev->instId, &metadata);
 		} else if (ev->event == EV_UPDATE_REQ) {
-			// Request object update from GCS (with retries)
-			while (retries < MAX_RETRIES && success == -1) {
-				success = UAVTalkSendObjectRequest(uavTalkCon, ev->obj, ev->instId, REQ_TIMEOUT_MS);	// call blocks until update is received or timeout
-				++retries;
-			}
-			// Update stats
-			txRetries += (retries - 1);
-			if (success == -1) {
-				++txErrors;
+			// Request object update from GCS, the transaction completes in the background
+			if (UAVTalkSendObjectRequestPipelined(uavTalkCon, ev->obj, ev->instId, MAX_RETRIES - 1, REQ_TIMEOUT_MS, &transactionCompleted) < 0) {
+				__sync_fetch_and_add(&txErrors, 1);
 			}
 		} else if (ev->event == EV_UPDATED_PERIODIC && updateMode == UPDATEMODE_THROTTLED) {
 			// Get the event mask
 			int32_t eventMask = getEventMask(ev->obj, priorityQueue);
 
 			if (eventMask & EV_UPDATED_THROTTLED_DIRTY) { // If EV_UPDATED_THROTTLED_DIRTY flag is set then send the data like normal.
-				// Send update to GCS (with retries)
-				while (retries < MAX_RETRIES && success == -1) {
-					success = UAVTalkSendObject(uavTalkCon, ev->obj, ev->instId, UAVObjGetTelemetryAcked(&metadata), REQ_TIMEOUT_MS);	// call blocks until ack is received or timeout
-					++retries;
-				}
-				// Update stats
-				txRetries += (retries - 1);
-				if (success == -1) {
-					++txErrors;
-				}
+				// Send update to GCS
+				sendObject(ev->obj, ev->instId, &metadata);
 			}
 		}
 		// If this is a metaobject then make necessary telemetry updates
@@ -332,10 +344,16 @@ static void telemetryTxTask(void *parameters)
 
 	// Loop forever
 	while (1) {
-		// Wait for queue message
-		if (xQueueReceive(queue, &ev, portMAX_DELAY) == pdTRUE) {
-			// Process event
-			processObjEvent(&ev);
+		// Wait for queue message, waking up in time to retry lost transactions
+		if (xQueueReceive(queue, &ev, UAVTalkProcessTransactions(uavTalkCon)) == pdTRUE) {
+			// Process the event and whatever else is already queued as
+			// one batch so the objects go to the port together
+			UAVTalkBeginBatch(uavTalkCon);
+			uint8_t processed = 0;
+			do {
+				processObjEvent(&ev);
+			} while (++processed < TX_BATCH_SIZE && xQueueReceive(queue, &ev, 0) == pdTRUE);
+			UAVTalkEndBatch(uavTalkCon);
 		}
 	}
 }
@@ -350,8 +368,8 @@ static void telemetryTxPriTask(void *parameters)
 
 	// Loop forever
 	while (1) {
-		// Wait for queue message
-		if (xQueueReceive(priorityQueue, &ev, portMAX_DELAY) == pdTRUE) {
+		// Wait for queue message, waking up in time to retry lost transactions
+		if (xQueueReceive(priorityQueue, &ev, UAVTalkProcessTransactions(uavTalkCon)) == pdTRUE) {
 			// Process event
 			processObjEvent(&ev);
 		}
@@ -370,15 +388,13 @@ static void telemetryRxTask(void *parameters)
 		uintptr_t inputPort = getComPort();
 
 		if (inputPort) {
-			// Block until data are available
-			uint8_t serial_data[1];
+			// Block until data are available, then drain as much as fits
+			uint8_t serial_data[RX_CHUNK_SIZE];
 			uint16_t bytes_to_process;
 
 			bytes_to_process = PIOS_COM_ReceiveBuffer(inputPort, serial_data, sizeof(serial_data), 500);
 			if (bytes_to_process > 0) {
-				for (uint8_t i = 0; i < bytes_to_process; i++) {
-					UAVTalkProcessInputStream(uavTalkCon,serial_data[i]);
-				}
+				UAVTalkProcessInputBuffer(uavTalkCon, serial_data, bytes_to_process);
 			}
 		} else {
 			vTaskDelay(5);
@@ -403,6 +419,38 @@ static int32_t transmitData(uint8_t * data, int32_t length)
 	return -1;
 }
 
+/**
+ * Reserve space for a packet directly in the transmit buffer of the modem
+ * or USB port.
+ * \param[in] length Length of the packet
+ * \return NULL if there is no port or not enough contiguous space
+ * \return pointer to write the packet to on success
+ */
+static uint8_t *reserveTransmitData(uint16_t length)
+{
+	txReservedPort = getComPort();
+
+	if (txReservedPort)
+		return PIOS_COM_ReserveTxBuffer(txReservedPort, length);
+
+	return NULL;
+}
+
+/**
+ * Commit a packet written to the space from reserveTransmitData()
+ * \param[in] length Length of the packet
+ * \param[in] flush Start transmitting now
+ * \return -1 on failure
+ * \return number of bytes committed on success
+ */
+static int32_t commitTransmitData(uint16_t length, bool flush)
+{
+	if (txReservedPort)
+		return PIOS_COM_CommitTxBuffer(txReservedPort, length, flush);
+
+	return -1;
+}
+
 /**
  * Set update period of object (it must be already setup for periodic updates)
  * \param[in] obj The object to update
@@ -462,18 +510,16 @@ static void updateTelemetryStats()
 		flightStats.RxDataRate = (float)utalkStats.rxBytes / ((float)STATS_UPDATE_PERIOD_MS / 1000.0f);
 		flightStats.TxDataRate = (float)utalkStats.txBytes / ((float)STATS_UPDATE_PERIOD_MS / 1000.0f);
 		flightStats.RxFailures += utalkStats.rxErrors;
-		flightStats.TxFailures += txErrors;
-		flightStats.TxRetries += txRetries;
-		txErrors = 0;
-		txRetries = 0;
+		flightStats.TxFailures += __sync_lock_test_and_set(&txErrors, 0);
+		flightStats.TxRetries += __sync_lock_test_and_set(&txRetries, 0);
 	} else {
 		flightStats.RxDataRate = 0;
 		flightStats.TxDataRate = 0;
 		flightStats.RxFailures = 0;
 		flightStats.TxFailures = 0;
 		flightStats.TxRetries = 0;
-		txErrors = 0;
-		txRetries = 0;
+		__sync_lock_test_and_set(&txErrors, 0);
+		__sync_lock_test_and_set(&txRetries, 0);
 	}
 
 	// Check for connection timeout
@@ -511,6 +557,10 @@ static void updateTelemetryStats()
 		flightStats.Status = FLIGHTTELEMETRYSTATS_STATUS_DISCONNECTED;
 	}
 
+	// Delta frames are only sent once the GCS has said it can decode them
+	UAVTalkSetDeltaCompression(uavTalkCon, flightStats.Status == FLIGHTTELEMETRYSTATS_STATUS_CONNECTED &&
+			gcsStats.DeltaCompression == GCSTELEMETRYSTATS_DELTACOMPRESSION_TRUE);
+
 	// Update the telemetry alarm
 	if (flightStats.Status == FLIGHTTELEMETRYSTATS_STATUS_CONNECTED) {
 		AlarmsClear(SYSTEMALARMS_ALARM_TELEMETRY);
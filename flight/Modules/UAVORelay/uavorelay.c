@@ -30,24 +30,45 @@
 #include "openpilot.h"
 #include "modulesettings.h"
 #include "cameradesired.h"
+#include "uavorelaystats.h"
 
 // Private constants
-#define MAX_QUEUE_SIZE   5
 #define STACK_SIZE_BYTES 512
+#define RX_STACK_SIZE_BYTES 512
 #define TASK_PRIORITY (tskIDLE_PRIORITY + 0)
+#define RX_CHUNK_SIZE 64
+#define RX_TIMEOUT_MS 500
+#define STATS_UPDATE_PERIOD_MS 1000
+#define MAX_RELAYED_OBJECTS 4
 
 // Private types
 
+//! An object forwarded by the relay
+struct relay_object {
+	UAVObjHandle obj;
+	uint16_t min_period_ms;  //!< Never forward this object more often than this
+	uint16_t inst_id;        //!< Instance of the latest update
+	volatile bool pending;   //!< Updated since it was last forwarded
+	portTickType last_sent;
+};
+
 // Private variables
-static xQueueHandle queue;
+static xSemaphoreHandle relay_sem;
 static UAVTalkConnection uavTalkCon;
 static xTaskHandle uavoRelayTaskHandle;
+static xTaskHandle uavoRelayRxTaskHandle;
 static bool module_enabled;
+static struct relay_object relay_objects[MAX_RELAYED_OBJECTS];
+static uint8_t num_relay_objects;
+static volatile uint32_t rate_limited;
 
 // Private functions
 static void    uavoRelayTask(void *parameters);
+static void    uavoRelayRxTask(void *parameters);
 static int32_t send_data(uint8_t *data, int32_t length);
-static void    register_object(UAVObjHandle obj);
+static void    register_object(UAVObjHandle obj, uint16_t min_period_ms);
+static void    object_updated(UAVObjEvent *ev);
+static void    update_stats(uint32_t dT_ms);
 
 // Local variables
 static uintptr_t uavorelay_com_id;
@@ -83,13 +104,14 @@ int32_t UAVORelayInitialize(void)
 	if (!module_enabled)
 		return -1;
 
-	// Create object queues
-	queue = xQueueCreate(MAX_QUEUE_SIZE, sizeof(UAVObjEvent));
+	// Woken whenever a relayed object is updated
+	vSemaphoreCreateBinary(relay_sem);
 	
 	// Initialise UAVTalk
 	uavTalkCon = UAVTalkInitialize(&send_data);
 
 	CameraDesiredInitialize();
+	UAVORelayStatsInitialize();
 
 	return 0;
 }
@@ -108,13 +130,16 @@ int32_t UAVORelayStart(void)
 	
 	// Register objects to relay
 	if (CameraDesiredHandle())
-		register_object(CameraDesiredHandle());
+		register_object(CameraDesiredHandle(), 10);
 	
-	// Start relay task
+	// Start relay tasks
 	xTaskCreate(uavoRelayTask, (signed char *)"UAVORelay", STACK_SIZE_BYTES/4,
 	            NULL, TASK_PRIORITY, &uavoRelayTaskHandle);
+	xTaskCreate(uavoRelayRxTask, (signed char *)"UAVORelayRx", RX_STACK_SIZE_BYTES/4,
+	            NULL, TASK_PRIORITY, &uavoRelayRxTaskHandle);
 
 	TaskMonitorAdd(TASKINFO_RUNNING_UAVORELAY, uavoRelayTaskHandle);
+	TaskMonitorAdd(TASKINFO_RUNNING_UAVORELAYRX, uavoRelayRxTaskHandle);
 	
 	return 0;
 }
@@ -122,44 +147,133 @@ int32_t UAVORelayStart(void)
 MODULE_INITCALL(UAVORelayInitialize, UAVORelayStart)
 ;
 /**
- * Register a new object, adds object to local list and connects the queue depending on the object's
- * telemetry settings.
+ * Register a new object, adds object to local list and connects a callback
+ * that flags it for forwarding whenever it is updated.
  * \param[in] obj Object to connect
+ * \param[in] min_period_ms Minimum time between two forwarded updates
  */
-static void register_object(UAVObjHandle obj)
+static void register_object(UAVObjHandle obj, uint16_t min_period_ms)
 {
+	if (num_relay_objects >= MAX_RELAYED_OBJECTS)
+		return;
+
+	struct relay_object *relay = &relay_objects[num_relay_objects++];
+	relay->obj = obj;
+	relay->min_period_ms = min_period_ms;
+	relay->inst_id = 0;
+	relay->pending = false;
+	relay->last_sent = xTaskGetTickCount() - MS2TICKS(min_period_ms);
+
 	int32_t eventMask;
 	eventMask = EV_UPDATED | EV_UPDATED_MANUAL | EV_UPDATE_REQ | EV_UNPACKED;
-	UAVObjConnectQueue(obj, queue, eventMask);
+	UAVObjConnectCallback(obj, object_updated, eventMask);
+}
+
+/**
+ * Called by the event system when a relayed object changes. Only flags
+ * the object, the relay task always forwards its most recent data.
+ */
+static void object_updated(UAVObjEvent *ev)
+{
+	for (uint8_t i = 0; i < num_relay_objects; i++) {
+		struct relay_object *relay = &relay_objects[i];
+		if (relay->obj != ev->obj)
+			continue;
+
+		// Previous update has not been forwarded yet and is superseded
+		if (relay->pending)
+			rate_limited++;
+
+		relay->inst_id = ev->instId;
+		relay->pending = true;
+		xSemaphoreGive(relay_sem);
+		return;
+	}
 }
 
+/**
+ * Forwards updated objects as soon as their rate limit allows it
+ */
 static void uavoRelayTask(void *parameters)
 {
-	UAVObjEvent ev;
+	portTickType last_stats = xTaskGetTickCount();
 
 	// Loop forever
 	while (1) {
+		portTickType now = xTaskGetTickCount();
+		portTickType wait = MS2TICKS(STATS_UPDATE_PERIOD_MS);
+
+		// Forward everything that is due in one go
+		UAVTalkBeginBatch(uavTalkCon);
+		for (uint8_t i = 0; i < num_relay_objects; i++) {
+			struct relay_object *relay = &relay_objects[i];
+			if (!relay->pending)
+				continue;
 
-		vTaskDelay(50);
+			portTickType since = now - relay->last_sent;
+			portTickType period = MS2TICKS(relay->min_period_ms);
+			if (since < period) {
+				// Come back when this object may be sent again
+				if (period - since < wait)
+					wait = period - since;
+				continue;
+			}
+
+			// Clear first so an update arriving while sending is not lost
+			relay->pending = false;
+			relay->last_sent = now;
+			UAVTalkSendObject(uavTalkCon, relay->obj, relay->inst_id, false, 0);
+		}
+		UAVTalkEndBatch(uavTalkCon);
 
-		// Wait for queue message
-		if (xQueueReceive(queue, &ev, 2) == pdTRUE) {
-			// Process event.  This calls transmitData
-			UAVTalkSendObject(uavTalkCon, ev.obj, ev.instId, false, 0);
+		if (now - last_stats >= MS2TICKS(STATS_UPDATE_PERIOD_MS)) {
+			update_stats(TICKS2MS(now - last_stats));
+			last_stats = now;
 		}
 
-		// Process incoming data in sufficient chunks that we keep up
-		uint8_t serial_data[8];
-		uint16_t bytes_to_process;
+		xSemaphoreTake(relay_sem, wait);
+	}
+}
+
+/**
+ * Processes incoming data as soon as it arrives
+ */
+static void uavoRelayRxTask(void *parameters)
+{
+	uint8_t serial_data[RX_CHUNK_SIZE];
+
+	// Loop forever
+	while (1) {
+		uint16_t bytes_to_process = PIOS_COM_ReceiveBuffer(uavorelay_com_id, serial_data, sizeof(serial_data), RX_TIMEOUT_MS);
+		if (bytes_to_process > 0)
+			UAVTalkProcessInputBuffer(uavTalkCon, serial_data, bytes_to_process);
+	}
+}
+
+/**
+ * Publish the relay throughput and error counters
+ * \param[in] dT_ms Time since the last update
+ */
+static void update_stats(uint32_t dT_ms)
+{
+	UAVTalkStats utalkStats;
+	UAVORelayStatsData stats;
 
-		bytes_to_process = PIOS_COM_ReceiveBuffer(uavorelay_com_id, serial_data, sizeof(serial_data), 0);
-		do {
-			bytes_to_process = PIOS_COM_ReceiveBuffer(uavorelay_com_id, serial_data, sizeof(serial_data), 0);
-			for (uint8_t i = 0; i < bytes_to_process; i++)
-				UAVTalkProcessInputStream(uavTalkCon,serial_data[i]);
-		} while (bytes_to_process > 0);
+	UAVTalkGetStats(uavTalkCon, &utalkStats);
+	UAVTalkResetStats(uavTalkCon);
+	UAVORelayStatsGet(&stats);
 
+	if (dT_ms > 0) {
+		stats.TxDataRate = utalkStats.txBytes * 1000 / dT_ms;
+		stats.RxDataRate = utalkStats.rxBytes * 1000 / dT_ms;
+		stats.TxObjectRate = utalkStats.txObjects * 1000 / dT_ms;
+		stats.RxObjectRate = utalkStats.rxObjects * 1000 / dT_ms;
 	}
+	stats.TxFailures += utalkStats.txErrors;
+	stats.RxFailures += utalkStats.rxErrors;
+	stats.RateLimited = rate_limited;
+
+	UAVORelayStatsSet(&stats);
 }
 
 /**
@@ -30,11 +30,19 @@
 
 /**
  * Input objects: @ref Accels, @ref VibrationAnalysisSettings
- * Output object: @ref VibrationAnalysisOutput
+ * Output object: @ref VibrationAnalysisOutput, @ref VibrationAnalysisPeak
  *
  * This module executes on a timer trigger. When the module is
  * triggered it will update the data of VibrationAnalysiOutput, based on
  * the output of an FFT running on the accelerometer samples. 
+ *
+ * With one of the raw sources selected it instead taps the accel or gyro
+ * samples PIOS_SENSORS delivers, at the full sensor rate, and estimates their
+ * spectrum with Welch's method: real FFTs of Hann windowed segments that
+ * overlap by half, with the power of several segments averaged.  Next to the
+ * spectrum the strongest frequency on each axis goes to VibrationAnalysisPeak.
+ * The real FFT comes from the math library with twiddles computed into RAM
+ * at startup, as arm_rfft_f32 would link large coefficient tables into flash.
  */
 
 #include "openpilot.h"
@@ -44,7 +52,10 @@
 #include "accels.h"
 #include "modulesettings.h"
 #include "vibrationanalysisoutput.h"
+#include "vibrationanalysispeak.h"
 #include "vibrationanalysissettings.h"
+#include "pios_sensors.h"
+#include "real_fft.h"
 
 
 // Private constants
@@ -63,6 +74,10 @@
 #define MAX_ACCEL_RANGE 16                          // Maximum accelerometer resolution in [g]
 #define FLOAT_TO_Q15 (32768/(MAX_ACCEL_RANGE*GRAVITY)) // This is the scaling constant that scales all input floats to +-
 
+#define RAW_STACK_SIZE_BYTES 700  // The buffers are on the heap here as well
+#define RAW_QUEUE_SIZE 32         // Raw samples buffered between runs of the task
+#define WELCH_SEGMENTS 8          // Segments averaged into each published spectrum
+
 // Private variables
 static xTaskHandle taskHandle;
 static xQueueHandle queue;
@@ -88,9 +103,38 @@ static struct VibrationAnalysis_data {
 	int16_t *fft_output;
 } *vtd;
 
+//! Sample as it comes from the tapped sensor queue
+union raw_sample {
+	struct pios_sensor_accel_data accel;
+	struct pios_sensor_gyro_data gyro;
+};
+
+static struct VibrationAnalysisRaw_data {
+	uint8_t source;             // VIBRATIONANALYSISSETTINGS_SOURCE_RAWACCELS or _RAWGYROS
+	uint16_t fft_length;
+	uint16_t write_idx;         // Where the next sample goes in the sample rings
+	uint16_t num_samples;       // Samples in the rings, at most fft_length
+	uint16_t new_samples;       // Samples since the last segment
+	uint8_t num_segments;       // Segments summed into the power spectra
+	uint32_t last_segment_time; // Raw time of the last segment, 0 if none since the rings were reset
+	float sample_rate;          // Estimated rate of the sensor [Hz], 0 until known
+	uint32_t tap_overruns;      // Samples the tap had dropped when the current window started
+
+	xQueueHandle queue;
+
+	float *samples[3];          // Ring of the last fft_length samples of each axis
+	float *window;              // Hann window of fft_length points
+	float *twiddle;             // cos and sin of 2*pi*k/fft_length for k < fft_length/2
+	float *fft_in;              // Windowed segment
+	float *fft_out;             // FFT of the segment taken as fft_length/2 complex values
+	float *power[3];            // Summed power of fft_length/2 bins of each axis
+} *vrd;
+
 
 // Private functions
 static void VibrationAnalysisTask(void *parameters);
+static void VibrationAnalysisRawTask(void *parameters);
+static int32_t VibrationAnalysisRawStart(uint8_t source);
 
 /**
  * Start the module, called on startup
@@ -101,6 +145,11 @@ static int32_t VibrationAnalysisStart(void)
 	if (!module_enabled)
 		return -1;
 
+	uint8_t source;
+	VibrationAnalysisSettingsSourceGet(&source);
+	if (source != VIBRATIONANALYSISSETTINGS_SOURCE_ACCELS)
+		return VibrationAnalysisRawStart(source);
+
 	//Get the FFT window size
 	uint16_t fft_window_size; // Make a local copy in order to check settings before allocating memory
 	uint8_t num_upscale_bits;
@@ -197,6 +246,87 @@ static int32_t VibrationAnalysisStart(void)
 	return 0;
 }
 
+/**
+ * Start the analysis of the raw sensor samples
+ * \param[in] source The raw sensor selected in the settings
+ * \return 0 on success, -1 if the settings are invalid or out of memory
+ */
+static int32_t VibrationAnalysisRawStart(uint8_t source)
+{
+	uint16_t fft_length;
+	uint8_t fft_length_enum;
+	VibrationAnalysisSettingsRawFFTLengthGet(&fft_length_enum);
+	switch (fft_length_enum) {
+		case VIBRATIONANALYSISSETTINGS_RAWFFTLENGTH_128:
+			fft_length = 128;
+			break;
+		case VIBRATIONANALYSISSETTINGS_RAWFFTLENGTH_512:
+			fft_length = 512;
+			break;
+		default:
+			module_enabled = false;
+			return -1;
+	}
+
+	if (source != VIBRATIONANALYSISSETTINGS_SOURCE_RAWACCELS &&
+			source != VIBRATIONANALYSISSETTINGS_SOURCE_RAWGYROS) {
+		module_enabled = false;
+		return -1;
+	}
+
+	// One instance per frequency bin of the real FFT, the first exists already
+	for (int i=1; i < (fft_length>>1); i++)
+		VibrationAnalysisOutputCreateInstance();
+
+	if (VibrationAnalysisOutputGetNumInstances() != (fft_length>>1)) {
+		module_enabled = false;
+		return -1;
+	}
+
+	vrd = (struct VibrationAnalysisRaw_data *) pvPortMalloc(sizeof(struct VibrationAnalysisRaw_data));
+	if (vrd == NULL) {
+		module_enabled = false;
+		return -1;
+	}
+	memset(vrd, 0, sizeof(struct VibrationAnalysisRaw_data));
+	vrd->source = source;
+	vrd->fft_length = fft_length;
+
+	for (int i = 0; i < 3; i++) {
+		vrd->samples[i] = (float *) pvPortMalloc(fft_length * sizeof(float));
+		vrd->power[i] = (float *) pvPortMalloc((fft_length>>1) * sizeof(float));
+		if (vrd->samples[i] == NULL || vrd->power[i] == NULL) {
+			module_enabled = false;
+			return -1;
+		}
+	}
+	vrd->window = (float *) pvPortMalloc(fft_length * sizeof(float));
+	vrd->twiddle = (float *) pvPortMalloc(fft_length * sizeof(float));
+	vrd->fft_in = (float *) pvPortMalloc(fft_length * sizeof(float));
+	vrd->fft_out = (float *) pvPortMalloc(fft_length * sizeof(float));
+	if (vrd->window == NULL || vrd->twiddle == NULL || vrd->fft_in == NULL || vrd->fft_out == NULL) {
+		module_enabled = false;
+		return -1;
+	}
+
+	// Hann window, it keeps the leakage of the gravity and other strong
+	// low frequencies away from the motor noise
+	for (int i = 0; i < fft_length; i++)
+		vrd->window[i] = 0.5f - 0.5f * cosf(2.0f * PI * i / fft_length);
+
+	real_fft_init_twiddle(vrd->twiddle, fft_length);
+
+	vrd->queue = xQueueCreate(RAW_QUEUE_SIZE, sizeof(union raw_sample));
+	if (vrd->queue == NULL) {
+		module_enabled = false;
+		return -1;
+	}
+
+	xTaskCreate(VibrationAnalysisRawTask, (signed char *)"VibrationAnalysis", RAW_STACK_SIZE_BYTES/4, NULL, TASK_PRIORITY, &taskHandle);
+	TaskMonitorAdd(TASKINFO_RUNNING_VIBRATIONANALYSIS, taskHandle);
+	return 0;
+}
+
 
 /**
  * Initialise the module, called on startup
@@ -223,6 +353,7 @@ static int32_t VibrationAnalysisInitialize(void)
 	// Initialize UAVOs
 	VibrationAnalysisSettingsInitialize();
 	VibrationAnalysisOutputInitialize();
+	VibrationAnalysisPeakInitialize();
 		
 	// Create object queue
 	queue = xQueueCreate(MAX_QUEUE_SIZE, sizeof(UAVObjEvent));
@@ -420,6 +551,210 @@ static void VibrationAnalysisTask(void *parameters)
 	}
 }
 
+/**
+ * Forget the buffered samples and the partial averages, e.g. after a gap
+ */
+static void raw_reset(void)
+{
+	vrd->write_idx = 0;
+	vrd->num_samples = 0;
+	vrd->new_samples = 0;
+	vrd->num_segments = 0;
+	vrd->last_segment_time = 0;
+
+	for (int i = 0; i < 3; i++)
+		memset(vrd->power[i], 0, (vrd->fft_length>>1) * sizeof(float));
+}
+
+/**
+ * Start filling the sample rings from scratch after the tap dropped samples.
+ * The segments already summed are kept, they were taken from unbroken data.
+ */
+static void raw_restart_window(void)
+{
+	vrd->write_idx = 0;
+	vrd->num_samples = 0;
+	vrd->new_samples = 0;
+	vrd->last_segment_time = 0;
+}
+
+/**
+ * Add the power spectrum of the last fft_length samples to the sums
+ */
+static void raw_process_segment(void)
+{
+	const uint16_t n = vrd->fft_length;
+
+	// The ring is full, so the oldest sample is where the next one goes
+	const uint16_t start = vrd->write_idx;
+
+	for (int axis = 0; axis < 3; axis++) {
+		const float *samples = vrd->samples[axis];
+
+		// Remove the mean, otherwise gravity or a rotation dominates the lowest bins
+		float mean = 0;
+		for (int i = 0; i < n; i++)
+			mean += samples[i];
+		mean /= n;
+
+		uint16_t idx = start;
+		for (int i = 0; i < n; i++) {
+			vrd->fft_in[i] = (samples[idx] - mean) * vrd->window[i];
+			if (++idx >= n)
+				idx = 0;
+		}
+
+		// Only the first half of the bins, the rest mirrors them for a real input
+		real_fft_power(vrd->fft_in, vrd->power[axis], vrd->fft_out, vrd->twiddle, n);
+	}
+
+	vrd->num_segments++;
+}
+
+/**
+ * Publish the averaged spectrum and its peaks, then start a new average
+ */
+static void raw_publish(void)
+{
+	const uint16_t n = vrd->fft_length;
+	const uint16_t bins = n >> 1;
+
+	// Amplitude of a sine that falls in a bin: twice for the mirrored half of
+	// the spectrum and twice for the coherent gain of 0.5 of the Hann window
+	const float scale = 4.0f / n;
+	const float inv_segments = 1.0f / vrd->num_segments;
+
+	for (int axis = 0; axis < 3; axis++) {
+		float *power = vrd->power[axis];
+		for (int i = 0; i < bins; i++)
+			power[i] = sqrtf(power[i] * inv_segments) * scale;
+	}
+
+	VibrationAnalysisOutputData output;
+	for (int i = 0; i < bins; i++) {
+		output.x = vrd->power[0][i];
+		output.y = vrd->power[1][i];
+		output.z = vrd->power[2][i];
+		VibrationAnalysisOutputInstSet(i, &output);
+	}
+
+	VibrationAnalysisPeakData peak;
+	peak.SampleRate = vrd->sample_rate;
+	peak.TapOverruns = vrd->tap_overruns;
+	peak.Source = (vrd->source == VIBRATIONANALYSISSETTINGS_SOURCE_RAWGYROS) ?
+			VIBRATIONANALYSISPEAK_SOURCE_RAWGYROS : VIBRATIONANALYSISPEAK_SOURCE_RAWACCELS;
+	for (int axis = 0; axis < 3; axis++) {
+		const float *amplitude = vrd->power[axis];
+
+		// Skip the DC bin, the mean was removed and the window leaks it into bin 1 anyway
+		int max_bin = 2;
+		for (int i = 3; i < bins; i++)
+			if (amplitude[i] > amplitude[max_bin])
+				max_bin = i;
+
+		// Place the peak between the bins with a parabola through the neighbours
+		float offset = 0;
+		if (max_bin < bins - 1) {
+			float denom = amplitude[max_bin - 1] - 2 * amplitude[max_bin] + amplitude[max_bin + 1];
+			if (denom < 0)
+				offset = 0.5f * (amplitude[max_bin - 1] - amplitude[max_bin + 1]) / denom;
+		}
+
+		peak.Frequency[axis] = (max_bin + offset) * vrd->sample_rate / n;
+		peak.Amplitude[axis] = amplitude[max_bin];
+	}
+	VibrationAnalysisPeakSet(&peak);
+
+	for (int axis = 0; axis < 3; axis++)
+		memset(vrd->power[axis], 0, bins * sizeof(float));
+	vrd->num_segments = 0;
+}
+
+/**
+ * Analyze the samples of the tapped sensor at the full rate they arrive.  A
+ * segment is transformed every fft_length/2 samples, and every WELCH_SEGMENTS
+ * segments the averaged spectrum is published.
+ */
+static void VibrationAnalysisRawTask(void *parameters)
+{
+	const enum pios_sensor_type sensor = (vrd->source == VIBRATIONANALYSISSETTINGS_SOURCE_RAWGYROS) ?
+			PIOS_SENSOR_GYRO : PIOS_SENSOR_ACCEL;
+	uint8_t runAnalysisFlag = VIBRATIONANALYSISSETTINGS_TESTINGSTATUS_OFF;
+	portTickType lastSettingsUpdateTime = xTaskGetTickCount() - MS2TICKS(SETTINGS_THROTTLING_MS);
+	union raw_sample sample;
+
+	raw_reset();
+
+	while(1)
+	{
+		// Only check settings once every 100ms
+		if(xTaskGetTickCount() - lastSettingsUpdateTime > MS2TICKS(SETTINGS_THROTTLING_MS)){
+			VibrationAnalysisSettingsTestingStatusGet(&runAnalysisFlag);
+			lastSettingsUpdateTime = xTaskGetTickCount();
+		}
+
+		// If analysis is turned off, stop the tap, delay and then loop.
+		if (runAnalysisFlag == VIBRATIONANALYSISSETTINGS_TESTINGSTATUS_OFF) {
+			if (vrd->num_samples > 0 || vrd->last_segment_time != 0) {
+				PIOS_SENSORS_SetTap(sensor, NULL);
+				raw_reset();
+			}
+			vTaskDelay(200);
+			continue;
+		}
+
+		PIOS_SENSORS_SetTap(sensor, vrd->queue);
+
+		if (xQueueReceive(vrd->queue, &sample, MS2TICKS(SETTINGS_THROTTLING_MS)) != pdTRUE)
+			continue;
+
+		// The tap runs over while a segment is transformed if the sensor is
+		// fast enough.  A segment with samples missing would smear the
+		// spectrum and the rate estimate, so start the window again.
+		uint32_t tap_overruns = PIOS_SENSORS_GetTapOverruns(sensor);
+		if (tap_overruns != vrd->tap_overruns) {
+			vrd->tap_overruns = tap_overruns;
+			raw_restart_window();
+		}
+
+		const uint16_t idx = vrd->write_idx;
+		if (sensor == PIOS_SENSOR_GYRO) {
+			vrd->samples[0][idx] = sample.gyro.x;
+			vrd->samples[1][idx] = sample.gyro.y;
+			vrd->samples[2][idx] = sample.gyro.z;
+		} else {
+			vrd->samples[0][idx] = sample.accel.x;
+			vrd->samples[1][idx] = sample.accel.y;
+			vrd->samples[2][idx] = sample.accel.z;
+		}
+		if (++vrd->write_idx >= vrd->fft_length)
+			vrd->write_idx = 0;
+		if (vrd->num_samples < vrd->fft_length)
+			vrd->num_samples++;
+		vrd->new_samples++;
+
+		// Segments overlap by half
+		if (vrd->num_samples < vrd->fft_length || vrd->new_samples < (vrd->fft_length>>1))
+			continue;
+
+		// Estimate the sensor rate from the time the last half segment took
+		if (vrd->last_segment_time != 0) {
+			float rate = vrd->new_samples * 1e6f / PIOS_DELAY_DiffuS(vrd->last_segment_time);
+			if (vrd->sample_rate == 0)
+				vrd->sample_rate = rate;
+			else
+				vrd->sample_rate = 0.9f * vrd->sample_rate + 0.1f * rate;
+		}
+		vrd->last_segment_time = PIOS_DELAY_GetRaw();
+		vrd->new_samples = 0;
+
+		raw_process_segment();
+
+		if (vrd->num_segments >= WELCH_SEGMENTS && vrd->sample_rate > 0)
+			raw_publish();
+	}
+}
+
 /**
  * @}
  * @}
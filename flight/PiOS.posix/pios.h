@@ -74,6 +74,7 @@
 #include <pios_sensors.h>
 #include <pios_sim.h>
 #include <pios_flashfs.h>
+#include <pios_streamfs.h>
 
 #if defined(PIOS_INCLUDE_IAP)
 #include <pios_iap.h>
@@ -294,6 +294,72 @@ int32_t PIOS_COM_SendBufferNonBlocking(uintptr_t com_id, const uint8_t *buffer,
 	return (bytes_into_fifo);
 }
 
+/**
+* Reserve contiguous space in the transmit buffer so a caller can build
+* a package in place instead of copying it in with PIOS_COM_SendBuffer
+* \param[in] port COM port
+* \param[in] len number of bytes required
+* \return pointer to the reserved space
+* \return NULL if the port is not available or the space is not free
+*         in one piece (caller should fall back to PIOS_COM_SendBuffer)
+*/
+uint8_t *PIOS_COM_ReserveTxBuffer(uintptr_t com_id, uint16_t len)
+{
+	struct pios_com_dev * com_dev = (struct pios_com_dev *)com_id;
+
+	if (!PIOS_COM_validate(com_dev)) {
+		/* Undefined COM port for this board (see pios_board.c) */
+		return NULL;
+	}
+
+	PIOS_Assert(com_dev->has_tx);
+
+	if (com_dev->driver->available && !com_dev->driver->available(com_dev->lower_id)) {
+		/* Let PIOS_COM_SendBuffer deal with a disconnected device */
+		return NULL;
+	}
+
+	uint8_t *data;
+	if (fifoBuf_getWritePtr(&com_dev->tx, &data) < len) {
+		return NULL;
+	}
+
+	return data;
+}
+
+/**
+* Add bytes written into space from PIOS_COM_ReserveTxBuffer to the
+* transmit buffer
+* \param[in] port COM port
+* \param[in] len number of bytes written
+* \param[in] start_tx start the transmitter now, false lets several
+*            packages be committed before the driver is kicked
+* \return -1 if port not available
+* \return number of bytes committed on success
+*/
+int32_t PIOS_COM_CommitTxBuffer(uintptr_t com_id, uint16_t len, bool start_tx)
+{
+	struct pios_com_dev * com_dev = (struct pios_com_dev *)com_id;
+
+	if (!PIOS_COM_validate(com_dev)) {
+		/* Undefined COM port for this board (see pios_board.c) */
+		return -1;
+	}
+
+	PIOS_Assert(com_dev->has_tx);
+
+	fifoBuf_commitData(&com_dev->tx, len);
+
+	if (start_tx && com_dev->driver->tx_start) {
+		uint16_t tx_bytes_avail = fifoBuf_getUsed(&com_dev->tx);
+		if (tx_bytes_avail > 0) {
+			com_dev->driver->tx_start(com_dev->lower_id, tx_bytes_avail);
+		}
+	}
+
+	return len;
+}
+
 /**
 * Sends a package over given port
 * (blocking function)
@@ -32,6 +32,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>		/* NULL */
+#include <string.h>		/* memset */
 
 #define MIN(x,y) ((x) < (y) ? (x) : (y))
 
@@ -59,6 +60,27 @@ struct logfs_state {
 	/* Underlying flash partition handle */
 	uintptr_t partition_id;
 	uint32_t partition_size;
+
+	/*
+	 * RAM index of the active arena.  One tag byte per slot, zero for
+	 * slots that are not active, otherwise a hash of the object id and
+	 * instance stored in that slot.  Lookups only read slot headers from
+	 * flash when the tag matches.
+	 */
+	uint8_t *slot_tags;
+
+	/*
+	 * Incremental garbage collection.  Active slots are copied a few at a
+	 * time into the reserved destination arena while the source arena
+	 * stays authoritative.  gc_copied marks source slots that already have
+	 * a copy so that obsoleting them can be mirrored in the destination.
+	 */
+	bool next_arena_erased;
+	bool gc_in_progress;
+	uint8_t gc_arena_id;
+	uint16_t gc_src_slot;
+	uint16_t gc_dst_slot;
+	uint8_t *gc_copied;
 };
 
 /*
@@ -78,6 +100,18 @@ static uintptr_t logfs_get_addr(const struct logfs_state *logfs, uint8_t arena_i
 		(slot_id  * logfs->cfg->slot_size));
 }
 
+/**
+ * @brief Compute the RAM index tag for an object instance
+ * @return tag in the range 1..255, 0 is reserved for inactive slots
+ */
+static uint8_t logfs_slot_tag(uint32_t obj_id, uint16_t obj_inst_id)
+{
+	uint32_t hash = obj_id ^ (obj_id >> 16) ^ ((uint32_t)obj_inst_id * 0x9E3779B1);
+	hash ^= hash >> 8;
+
+	return 1 + (hash % 255);
+}
+
 /*
  * The bits within these enum values must progress ONLY
  * from 1 -> 0 so that we can write later ones on top
@@ -406,6 +440,9 @@ static int32_t logfs_unmount_log(struct logfs_state *logfs)
 	logfs->num_free_slots   = 0;
 	logfs->mounted          = false;
 
+	/* Any partially copied arena will be erased again before reuse */
+	logfs->gc_in_progress   = false;
+
 	return 0;
 }
 
@@ -417,6 +454,9 @@ static int32_t logfs_mount_log(struct logfs_state *logfs, uint8_t arena_id)
 	logfs->num_free_slots   = 0;
 	logfs->active_arena_id  = arena_id;
 
+	logfs->next_arena_erased = false;
+	logfs->gc_in_progress    = false;
+
 	/* Scan the log to find out how full it is */
 	for (uint16_t slot_id = 1;
 	     slot_id < (logfs->cfg->arena_size / logfs->cfg->slot_size);
@@ -437,12 +477,15 @@ static int32_t logfs_mount_log(struct logfs_state *logfs, uint8_t arena_id)
 		PIOS_Assert (slot_hdr.state == SLOT_STATE_EMPTY ||
 			logfs->num_free_slots == 0);
 
+		logfs->slot_tags[slot_id] = 0;
+
 		switch (slot_hdr.state) {
 		case SLOT_STATE_EMPTY:
 			logfs->num_free_slots++;
 			break;
 		case SLOT_STATE_ACTIVE:
 			logfs->num_active_slots++;
+			logfs->slot_tags[slot_id] = logfs_slot_tag(slot_hdr.obj_id, slot_hdr.obj_inst_id);
 			break;
 		case SLOT_STATE_RESERVED:
 		case SLOT_STATE_OBSOLETE:
@@ -470,12 +513,18 @@ static struct logfs_state *PIOS_FLASHFS_Logfs_alloc(void)
 	if (!logfs) return (NULL);
 
 	logfs->magic = PIOS_FLASHFS_LOGFS_DEV_MAGIC;
+	logfs->slot_tags = NULL;
+	logfs->gc_copied = NULL;
 	return(logfs);
 }
 static void PIOS_FLASHFS_Logfs_free(struct logfs_state *logfs)
 {
 	/* Invalidate the magic */
 	logfs->magic = ~PIOS_FLASHFS_LOGFS_DEV_MAGIC;
+	if (logfs->slot_tags)
+		PIOS_free(logfs->slot_tags);
+	if (logfs->gc_copied)
+		PIOS_free(logfs->gc_copied);
 	PIOS_free(logfs);
 }
 
@@ -521,6 +570,22 @@ int32_t PIOS_FLASHFS_Logfs_Init(uintptr_t *fs_id, const struct flashfs_logfs_cfg
 	logfs->partition_size = partition_size; /* size of underlying partition */
 	logfs->mounted        = false;
 
+	/* Allocate the RAM slot index */
+	logfs->slot_tags = (uint8_t *)PIOS_malloc(cfg->arena_size / cfg->slot_size);
+	if (!logfs->slot_tags) {
+		rc = -1;
+		goto out_exit;
+	}
+	logfs->slot_tags[0] = 0;
+
+	/* Allocate the map of slots copied by an incremental garbage collection */
+	logfs->gc_copied = (uint8_t *)PIOS_malloc((cfg->arena_size / cfg->slot_size + 7) / 8);
+	if (!logfs->gc_copied) {
+		rc = -1;
+		goto out_exit;
+	}
+	logfs->gc_in_progress = false;
+
 	if (PIOS_FLASH_start_transaction(logfs->partition_id) != 0) {
 		rc = -1;
 		goto out_exit;
@@ -587,72 +652,214 @@ out_exit:
 	return rc;
 }
 
-/* NOTE: Must be called while holding the flash transaction lock */
-static int32_t logfs_garbage_collect (struct logfs_state *logfs) {
-	PIOS_Assert (logfs->mounted);
+/**
+ * @brief Make sure the arena following the active one is erased
+ * @return 0 if success, < 0 on failure
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t logfs_prepare_next_arena(struct logfs_state *logfs)
+{
+	uint8_t next_arena_id = (logfs->active_arena_id + 1) % (logfs->partition_size / logfs->cfg->arena_size);
+	uintptr_t arena_addr = logfs_get_addr (logfs, next_arena_id, 0);
 
-	/* Source arena is the active arena */
-	uint8_t src_arena_id = logfs->active_arena_id;
+	/* An erased arena header is only written once the whole arena has been erased */
+	struct arena_header arena_hdr;
+	if (PIOS_FLASH_read_data(logfs->partition_id,
+					arena_addr,
+					(uint8_t *)&arena_hdr,
+					sizeof(arena_hdr)) != 0) {
+		return -1;
+	}
 
-	/* Compute destination arena */
-	uint8_t dst_arena_id = (logfs->active_arena_id + 1) % (logfs->partition_size / logfs->cfg->arena_size);
+	if ((arena_hdr.state != ARENA_STATE_ERASED) ||
+		(arena_hdr.magic != logfs->cfg->fs_magic)) {
+		if (logfs_erase_arena (logfs, next_arena_id) != 0) {
+			return -2;
+		}
+	}
 
-	/* Erase destination arena */
-	if (logfs_erase_arena (logfs, dst_arena_id) != 0) {
-		return -1;
+	logfs->next_arena_erased = true;
+
+	return 0;
+}
+
+/**
+ * @brief Reserve the next arena and start copying active slots into it
+ * @return 0 if success, < 0 on failure
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t logfs_gc_start(struct logfs_state *logfs)
+{
+	PIOS_Assert (logfs->mounted);
+	PIOS_Assert (!logfs->gc_in_progress);
+
+	/*
+	 * Normally done ahead of time from the background.  A save that fills
+	 * the log before any background step ran erases here, in the caller.
+	 */
+	if (!logfs->next_arena_erased) {
+		if (logfs_prepare_next_arena (logfs) != 0) {
+			return -1;
+		}
 	}
 
+	uint8_t dst_arena_id = (logfs->active_arena_id + 1) % (logfs->partition_size / logfs->cfg->arena_size);
+
 	/* Reserve the destination arena so we can start filling it */
+	logfs->next_arena_erased = false;
 	if (logfs_reserve_arena (logfs, dst_arena_id) != 0) {
 		/* Unable to reserve the arena */
 		return -2;
 	}
 
-	/* Copy active slots from active arena to destination arena */
-	uint16_t dst_slot_id = 1;
-	for (uint16_t src_slot_id = 1;
-	     src_slot_id < (logfs->cfg->arena_size / logfs->cfg->slot_size);
-	     src_slot_id++) {
-		struct slot_header slot_hdr;
-		uintptr_t src_addr = logfs_get_addr (logfs, src_arena_id, src_slot_id);
-		if (PIOS_FLASH_read_data(logfs->partition_id,
-						src_addr,
-						(uint8_t *)&slot_hdr,
-						sizeof (slot_hdr)) != 0) {
-			return -3;
-		}
+	memset(logfs->gc_copied, 0, (logfs->cfg->arena_size / logfs->cfg->slot_size + 7) / 8);
+	logfs->gc_arena_id    = dst_arena_id;
+	logfs->gc_src_slot    = 1;
+	logfs->gc_dst_slot    = 1;
+	logfs->gc_in_progress = true;
+
+	return 0;
+}
+
+/**
+ * @brief Copy up to max_slots active slots into the destination arena
+ * @return 0 if success, < 0 on failure
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t logfs_gc_copy(struct logfs_state *logfs, uint16_t max_slots)
+{
+	PIOS_Assert (logfs->gc_in_progress);
+
+	uint16_t end_slot = (logfs->cfg->arena_size / logfs->cfg->slot_size) - logfs->num_free_slots;
 
-		if (slot_hdr.state == SLOT_STATE_ACTIVE) {
-			uintptr_t dst_addr = logfs_get_addr (logfs, dst_arena_id, dst_slot_id);
-			if (logfs_raw_copy_bytes(logfs,
+	while ((logfs->gc_src_slot < end_slot) && max_slots) {
+		uint16_t src_slot_id = logfs->gc_src_slot;
+
+		/* Only active slots carry a tag, everything else is garbage */
+		if (logfs->slot_tags[src_slot_id] != 0) {
+			struct slot_header slot_hdr;
+			uintptr_t src_addr = logfs_get_addr (logfs, logfs->active_arena_id, src_slot_id);
+			if (PIOS_FLASH_read_data(logfs->partition_id,
 							src_addr,
-							sizeof(slot_hdr) + slot_hdr.obj_size,
-							dst_addr) != 0) {
-				/* Failed to copy all bytes */
-				return -4;
+							(uint8_t *)&slot_hdr,
+							sizeof (slot_hdr)) != 0) {
+				return -1;
+			}
+
+			if (slot_hdr.state == SLOT_STATE_ACTIVE) {
+				uintptr_t dst_addr = logfs_get_addr (logfs, logfs->gc_arena_id, logfs->gc_dst_slot);
+				if (logfs_raw_copy_bytes(logfs,
+								src_addr,
+								sizeof(slot_hdr) + slot_hdr.obj_size,
+								dst_addr) != 0) {
+					/* Failed to copy all bytes */
+					return -2;
+				}
+				logfs->gc_copied[src_slot_id / 8] |= 1 << (src_slot_id % 8);
+				logfs->gc_dst_slot++;
+				max_slots--;
 			}
-			dst_slot_id++;
 		}
+
+		logfs->gc_src_slot++;
 	}
 
+	return 0;
+}
+
+/**
+ * @brief Has the incremental garbage collection copied every active slot?
+ */
+static bool logfs_gc_is_done(const struct logfs_state *logfs)
+{
+	return (logfs->gc_src_slot >= (logfs->cfg->arena_size / logfs->cfg->slot_size) - logfs->num_free_slots);
+}
+
+/**
+ * @brief Switch over to the destination arena once all slots are copied
+ * @return 0 if success, < 0 on failure
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t logfs_gc_finish(struct logfs_state *logfs)
+{
+	PIOS_Assert (logfs->gc_in_progress);
+	PIOS_Assert (logfs_gc_is_done(logfs));
+
+	uint8_t src_arena_id = logfs->active_arena_id;
+	uint8_t dst_arena_id = logfs->gc_arena_id;
+
 	/* Activate the destination arena */
 	if (logfs_activate_arena (logfs, dst_arena_id) != 0) {
-		return -5;
+		return -1;
 	}
 
 	/* Unmount the source arena */
 	if (logfs_unmount_log (logfs) != 0) {
-		return -6;
+		return -2;
 	}
 
 	/* Obsolete the source arena */
 	if (logfs_obsolete_arena (logfs, src_arena_id) != 0) {
-		return -7;
+		return -3;
 	}
 
 	/* Mount the new arena */
 	if (logfs_mount_log (logfs, dst_arena_id) != 0) {
-		return -8;
+		return -4;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Obsolete the copy of a source slot made by a running garbage collection
+ * @return 0 if success, < 0 on failure
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t logfs_gc_obsolete_copy(struct logfs_state *logfs, uint16_t src_slot_id, const struct slot_header *slot_hdr)
+{
+	if (!logfs->gc_in_progress ||
+		!(logfs->gc_copied[src_slot_id / 8] & (1 << (src_slot_id % 8)))) {
+		/* Not copied (yet), nothing to do */
+		return 0;
+	}
+
+	/* Slots are copied in order so the copy sits after all earlier copies */
+	uint16_t dst_slot_id = 1;
+	for (uint16_t i = 0; i < src_slot_id / 8; i++) {
+		dst_slot_id += __builtin_popcount(logfs->gc_copied[i]);
+	}
+	dst_slot_id += __builtin_popcount(logfs->gc_copied[src_slot_id / 8] & ((1 << (src_slot_id % 8)) - 1));
+
+	uintptr_t dst_addr = logfs_get_addr (logfs, logfs->gc_arena_id, dst_slot_id);
+	if (PIOS_FLASH_write_data(logfs->partition_id,
+					dst_addr,
+					(uint8_t *)slot_hdr,
+					sizeof(*slot_hdr)) != 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+/* NOTE: Must be called while holding the flash transaction lock */
+static int32_t logfs_garbage_collect (struct logfs_state *logfs) {
+	PIOS_Assert (logfs->mounted);
+
+	/* Pick up where the background left off, if it got started at all */
+	if (!logfs->gc_in_progress) {
+		if (logfs_gc_start (logfs) != 0) {
+			return -1;
+		}
+	}
+
+	/* Copy whatever has not been copied yet */
+	if (logfs_gc_copy (logfs, UINT16_MAX) != 0) {
+		return -2;
+	}
+
+	if (logfs_gc_finish (logfs) != 0) {
+		return -3;
 	}
 
 	return 0;
@@ -667,9 +874,17 @@ static int16_t logfs_object_find_next (const struct logfs_state *logfs, struct s
 	/* First slot in the arena is reserved for arena header, skip it. */
 	if (*curr_slot == 0) *curr_slot = 1;
 
-	for (uint16_t slot_id = *curr_slot;
-	     slot_id < (logfs->cfg->arena_size / logfs->cfg->slot_size);
-	     slot_id++) {
+	uint8_t tag = logfs_slot_tag(obj_id, obj_inst_id);
+
+	/* Free slots are contiguous at the end of the log, no need to look at them */
+	uint16_t end_slot = (logfs->cfg->arena_size / logfs->cfg->slot_size) - logfs->num_free_slots;
+
+	for (uint16_t slot_id = *curr_slot; slot_id < end_slot; slot_id++) {
+		if (logfs->slot_tags[slot_id] != tag) {
+			/* Slot is inactive or holds a different object */
+			continue;
+		}
+
 		uintptr_t slot_addr = logfs_get_addr (logfs, logfs->active_arena_id, slot_id);
 
 		if (PIOS_FLASH_read_data(logfs->partition_id,
@@ -718,8 +933,14 @@ static int8_t logfs_delete_object (struct logfs_state *logfs, uint32_t obj_id, u
 				rc = -2;
 				goto out_exit;
 			}
+			/* Keep a copy made by a running garbage collection in sync */
+			if (logfs_gc_obsolete_copy(logfs, curr_slot_id, &slot_hdr) != 0) {
+				rc = -3;
+				goto out_exit;
+			}
 			/* Object has been successfully obsoleted and is no longer active */
 			logfs->num_active_slots--;
+			logfs->slot_tags[curr_slot_id] = 0;
 			break;
 		case -1:
 			/* Search completed, object not found */
@@ -832,6 +1053,7 @@ static int8_t logfs_append_to_log (struct logfs_state *logfs, uint32_t obj_id, u
 
 	/* Object has been successfully written to the slot */
 	logfs->num_active_slots++;
+	logfs->slot_tags[free_slot_id] = logfs_slot_tag(obj_id, obj_inst_id);
 	return 0;
 }
 
@@ -856,8 +1078,12 @@ static int8_t logfs_append_to_log (struct logfs_state *logfs, uint32_t obj_id, u
  * @retval -3 if failure to delete any previous versions of the object
  * @retval -4 if filesystem is entirely full and garbage collection won't help
  * @retval -5 if garbage collection failed
- * @retval -6 if filesystem is full even after garbage collection should have freed space
+ * @retval -6 if the log is still full after garbage collection
  * @retval -7 if writing the new object to the filesystem failed
+ * @note A save that finds the log full collects garbage in the foreground.
+ *       That also erases the next arena first unless a background
+ *       PIOS_FLASHFS_GarbageCollect step already did, so callers that must
+ *       not block on an erase should keep calling it while idle.
  */
 int32_t PIOS_FLASHFS_ObjSave(uintptr_t fs_id, uint32_t obj_id, uint16_t obj_inst_id, uint8_t *obj_data, uint16_t obj_size)
 {
@@ -901,14 +1127,21 @@ int32_t PIOS_FLASHFS_ObjSave(uintptr_t fs_id, uint32_t obj_id, uint16_t obj_inst
 			rc = -5;
 			goto out_end_trans;
 		}
+		/*
+		 * Slots obsoleted after a background collection copied them still
+		 * take up room in the new arena.  If that leaves no room, compact
+		 * once more, this time only the active slots get copied.  The old
+		 * version of this object is already obsolete so the save must not
+		 * give up here.
+		 */
+		if (logfs_log_is_full(logfs)) {
+			if (logfs_garbage_collect(logfs) != 0) {
+				rc = -5;
+				goto out_end_trans;
+			}
+		}
 		/* Check one more time just to be sure we actually free'd some space */
 		if (logfs_log_is_full(logfs)) {
-			/*
-			 * Log is still full even after gc!
-			 * NOTE: This should not happen since the filesystem wasn't full
-			 *       when we checked above so gc should have helped.
-			 */
-			PIOS_DEBUG_Assert(0);
 			rc = -6;
 			goto out_end_trans;
 		}
@@ -1043,6 +1276,88 @@ out_exit:
 	return rc;
 }
 
+/**
+ * @brief Perform a bounded step of background garbage collection
+ * @param[in] fs_id The filesystem to use for this action
+ * @param[in] max_slots The maximum number of slots to copy in this step
+ * @return 0 if there is nothing left to do, 1 if more steps are needed, or error code
+ * @retval -1 if fs_id is not a valid filesystem instance
+ * @retval -2 if failed to start transaction
+ * @retval -3 if failed to erase or reserve the next arena
+ * @retval -4 if failed to copy slots into the next arena
+ * @retval -5 if failed to switch over to the next arena
+ * @note Each step either erases the next arena or copies up to max_slots slots,
+ *       which bounds how long a concurrent PIOS_FLASHFS_ObjSave can be blocked.
+ *       Collection starts once less than a quarter of the log is left free so
+ *       that saves rarely have to collect the log themselves.
+ */
+int32_t PIOS_FLASHFS_GarbageCollect(uintptr_t fs_id, uint16_t max_slots)
+{
+	int32_t rc;
+
+	struct logfs_state *logfs = (struct logfs_state *)fs_id;
+
+	if (!PIOS_FLASHFS_Logfs_validate(logfs)) {
+		rc = -1;
+		goto out_exit;
+	}
+
+	if (PIOS_FLASH_start_transaction(logfs->partition_id) != 0) {
+		rc = -2;
+		goto out_exit;
+	}
+
+	uint16_t num_slots = logfs->cfg->arena_size / logfs->cfg->slot_size;
+
+	if (!logfs->gc_in_progress) {
+		/* Erasing takes a whole step on its own */
+		if (!logfs->next_arena_erased) {
+			if (logfs_prepare_next_arena(logfs) != 0) {
+				rc = -3;
+				goto out_end_trans;
+			}
+			rc = 1;
+			goto out_end_trans;
+		}
+
+		/* Only collect when the log is getting full and there is something to reclaim */
+		if ((logfs->num_free_slots > num_slots / 4) ||
+			(logfs->num_active_slots + logfs->num_free_slots >= num_slots - 1)) {
+			rc = 0;
+			goto out_end_trans;
+		}
+
+		if (logfs_gc_start(logfs) != 0) {
+			rc = -3;
+			goto out_end_trans;
+		}
+	}
+
+	if (logfs_gc_copy(logfs, max_slots) != 0) {
+		rc = -4;
+		goto out_end_trans;
+	}
+
+	if (!logfs_gc_is_done(logfs)) {
+		rc = 1;
+		goto out_end_trans;
+	}
+
+	if (logfs_gc_finish(logfs) != 0) {
+		rc = -5;
+		goto out_end_trans;
+	}
+
+	/* The old arena still needs to be erased */
+	rc = 1;
+
+out_end_trans:
+	PIOS_FLASH_end_transaction(logfs->partition_id);
+
+out_exit:
+	return rc;
+}
+
 /**
  * @brief Erases all filesystem arenas and activate the first arena
  * @param[in] fs_id The filesystem to use for this action
@@ -42,13 +42,13 @@ enum pios_l3gd20_dev_magic {
     PIOS_L3GD20_DEV_MAGIC = 0x9d39bced,
 };
 
-#define PIOS_L3GD20_QUEUESIZE 2
+#define PIOS_L3GD20_RING_SIZE 8
 
 //! Local types
 struct l3gd20_dev {
 	uint32_t spi_id;
 	uint32_t slave_num;
-	xQueueHandle queue;
+	struct pios_sensors_ring *ring;
 	const struct pios_l3gd20_cfg *cfg;
 	enum pios_l3gd20_filter bandwidth;
 	enum pios_l3gd20_range range;
@@ -96,9 +96,9 @@ static struct l3gd20_dev *PIOS_L3GD20_alloc(void)
 
 	l3gd20_dev->configured = false;
 
-	l3gd20_dev->queue = xQueueCreate(PIOS_L3GD20_QUEUESIZE, sizeof(struct pios_sensor_gyro_data));
+	l3gd20_dev->ring = PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_gyro_data), PIOS_L3GD20_RING_SIZE);
 
-	if (l3gd20_dev->queue == NULL) {
+	if (l3gd20_dev->ring == NULL) {
 		vPortFree(l3gd20_dev);
 		return NULL;
 	}
@@ -149,7 +149,7 @@ int32_t PIOS_L3GD20_Init(uint32_t spi_id, uint32_t slave_num, const struct pios_
 	struct pios_l3gd20_data data;
 	PIOS_L3GD20_ReadGyros(&data);
 
-	PIOS_SENSORS_Register(PIOS_SENSOR_GYRO, pios_l3gd20_dev->queue);
+	PIOS_SENSORS_RegisterRing(PIOS_SENSOR_GYRO, pios_l3gd20_dev->ring);
 
 	return 0;
 }
@@ -459,10 +459,9 @@ bool PIOS_L3GD20_IRQHandler(void)
 	normalized_data.z = -data.gyro_z * scale;
 	normalized_data.temperature = PIOS_L3GD20_GetRegIsr(PIOS_L3GD20_OUT_TEMP, &woken);
 
-	portBASE_TYPE xHigherPriorityTaskWoken;
-	xQueueSendToBackFromISR(pios_l3gd20_dev->queue, (void *)&normalized_data, &xHigherPriorityTaskWoken);
+	PIOS_SENSORS_PushFromISR(pios_l3gd20_dev->ring, &normalized_data, &woken);
 
-	return woken || (xHigherPriorityTaskWoken == pdTRUE);
+	return woken;
 }
 
 #endif /* PIOS_INCLUDE_L3GD20 */
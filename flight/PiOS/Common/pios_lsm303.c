@@ -43,6 +43,7 @@ enum pios_lsm303_dev_magic {
 };
 
 #define PIOS_LSM303_MAX_QUEUESIZE 2
+#define PIOS_LSM303_RING_SIZE 8
 
 struct lsm303_dev {
 	uint32_t i2c_id;
@@ -50,7 +51,7 @@ struct lsm303_dev {
 	uint8_t i2c_addr_mag;
 	enum pios_lsm303_accel_range accel_range;
 	enum pios_lsm303_mag_range mag_range;
-	xQueueHandle queue_accel;
+	struct pios_sensors_ring *ring_accel;
 	xQueueHandle queue_mag;
 	xTaskHandle TaskHandle;
 	xSemaphoreHandle data_ready_sema;
@@ -99,9 +100,9 @@ static struct lsm303_dev *PIOS_LSM303_alloc(void)
 
 	lsm303_dev->magic = PIOS_LSM303_DEV_MAGIC;
 
-	lsm303_dev->queue_accel = xQueueCreate(PIOS_LSM303_MAX_QUEUESIZE, sizeof(struct pios_sensor_accel_data));
+	lsm303_dev->ring_accel = PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_accel_data), PIOS_LSM303_RING_SIZE);
 
-	if (lsm303_dev->queue_accel == NULL) {
+	if (lsm303_dev->ring_accel == NULL) {
 		vPortFree(lsm303_dev);
 		return NULL;
 	}
@@ -178,7 +179,7 @@ int32_t PIOS_LSM303_Init(uint32_t i2c_id, const struct pios_lsm303_cfg *cfg)
 	/* Set up EXTI line */
 	PIOS_EXTI_Init(cfg->exti_cfg);
 
-	PIOS_SENSORS_Register(PIOS_SENSOR_ACCEL, pios_lsm303_dev->queue_accel);
+	PIOS_SENSORS_RegisterRing(PIOS_SENSOR_ACCEL, pios_lsm303_dev->ring_accel);
 	PIOS_SENSORS_Register(PIOS_SENSOR_MAG, pios_lsm303_dev->queue_mag);
 
 	return 0;
@@ -652,7 +653,7 @@ static void PIOS_LSM303_Task(void *parameters)
 			normalized_data.z = -data.accel_z * accel_scale;
 			normalized_data.temperature = 0;
 
-			xQueueSendToBack(pios_lsm303_dev->queue_accel, (void *)&normalized_data, 0);
+			PIOS_SENSORS_Push(pios_lsm303_dev->ring_accel, &normalized_data);
 		}
 
 		/*
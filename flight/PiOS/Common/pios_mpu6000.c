@@ -42,16 +42,16 @@ enum pios_mpu6000_dev_magic {
     PIOS_MPU6000_DEV_MAGIC = 0x9da9b3ed,
 };
 
-#define PIOS_MPU6000_MAX_QUEUESIZE 2
+#define PIOS_MPU6000_RING_SIZE 8
 
 struct mpu6000_dev {
 	uint32_t spi_id;
 	uint32_t slave_num;
 	enum pios_mpu60x0_range gyro_range;
-	xQueueHandle gyro_queue;
+	struct pios_sensors_ring *gyro_ring;
 #if defined(PIOS_MPU6000_ACCEL)
 	enum pios_mpu60x0_accel_range accel_range;
-	xQueueHandle accel_queue;
+	struct pios_sensors_ring *accel_ring;
 #endif /* PIOS_MPU6000_ACCEL */
 	const struct pios_mpu60x0_cfg *cfg;
 	volatile bool configured;
@@ -87,17 +87,17 @@ static struct mpu6000_dev *PIOS_MPU6000_alloc(void)
 	mpu6000_dev->configured = false;
 
 #if defined(PIOS_MPU6000_ACCEL)
-	mpu6000_dev->accel_queue = xQueueCreate(PIOS_MPU6000_MAX_QUEUESIZE, sizeof(struct pios_sensor_accel_data));
+	mpu6000_dev->accel_ring = PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_accel_data), PIOS_MPU6000_RING_SIZE);
 
-	if (mpu6000_dev->accel_queue == NULL) {
+	if (mpu6000_dev->accel_ring == NULL) {
 		vPortFree(mpu6000_dev);
 		return NULL;
 	}
 #endif /* PIOS_MPU6000_ACCEL */
 
-	mpu6000_dev->gyro_queue = xQueueCreate(PIOS_MPU6000_MAX_QUEUESIZE, sizeof(struct pios_sensor_gyro_data));
+	mpu6000_dev->gyro_ring = PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_gyro_data), PIOS_MPU6000_RING_SIZE);
 
-	if (mpu6000_dev->gyro_queue == NULL) {
+	if (mpu6000_dev->gyro_ring == NULL) {
 		vPortFree(mpu6000_dev);
 		return NULL;
 	}
@@ -147,10 +147,10 @@ int32_t PIOS_MPU6000_Init(uint32_t spi_id, uint32_t slave_num, const struct pios
 	PIOS_EXTI_Init(cfg->exti_cfg);
 
 #if defined(PIOS_MPU6000_ACCEL)
-	PIOS_SENSORS_Register(PIOS_SENSOR_ACCEL, pios_mpu6000_dev->accel_queue);
+	PIOS_SENSORS_RegisterRing(PIOS_SENSOR_ACCEL, pios_mpu6000_dev->accel_ring);
 #endif /* PIOS_MPU6000_ACCEL */
 
-	PIOS_SENSORS_Register(PIOS_SENSOR_GYRO, pios_mpu6000_dev->gyro_queue);
+	PIOS_SENSORS_RegisterRing(PIOS_SENSOR_GYRO, pios_mpu6000_dev->gyro_ring);
 
 	return 0;
 }
@@ -613,13 +613,10 @@ bool PIOS_MPU6000_IRQHandler(void)
 	gyro_data.z *= gyro_scale;
 	gyro_data.temperature = temperature;
 
-	portBASE_TYPE xHigherPriorityTaskWoken_accel;
-	xQueueSendToBackFromISR(pios_mpu6000_dev->accel_queue, (void *)&accel_data, &xHigherPriorityTaskWoken_accel);
+	PIOS_SENSORS_PushFromISR(pios_mpu6000_dev->accel_ring, &accel_data, &woken);
+	PIOS_SENSORS_PushFromISR(pios_mpu6000_dev->gyro_ring, &gyro_data, &woken);
 
-	portBASE_TYPE xHigherPriorityTaskWoken_gyro;
-	xQueueSendToBackFromISR(pios_mpu6000_dev->gyro_queue, (void *)&gyro_data, &xHigherPriorityTaskWoken_gyro);
-
-	return (xHigherPriorityTaskWoken_accel == pdTRUE) || (xHigherPriorityTaskWoken_gyro == pdTRUE) || woken == true;
+	return woken;
 
 #else
 
@@ -656,10 +653,9 @@ bool PIOS_MPU6000_IRQHandler(void)
 	gyro_data.z *= gyro_scale;
 	gyro_data.temperature = temperature;
 
-	portBASE_TYPE xHigherPriorityTaskWoken_gyro;
-	xQueueSendToBackFromISR(pios_mpu6000_dev->gyro_queue, (void *)&gyro_data, &xHigherPriorityTaskWoken_gyro);
+	PIOS_SENSORS_PushFromISR(pios_mpu6000_dev->gyro_ring, &gyro_data, &woken);
 
-	return (xHigherPriorityTaskWoken_gyro == pdTRUE || woken == true);
+	return woken;
 
 #endif /* PIOS_MPU6000_ACCEL */
 
@@ -46,16 +46,16 @@ enum pios_mpu6050_dev_magic {
     PIOS_MPU6050_DEV_MAGIC = 0xf21d26a2,
 };
 
-#define PIOS_MPU6050_MAX_QUEUESIZE 2
+#define PIOS_MPU6050_RING_SIZE 8
 
 struct mpu6050_dev {
 	uint32_t i2c_id;
 	uint8_t i2c_addr;
 	enum pios_mpu60x0_range gyro_range;
-	xQueueHandle gyro_queue;
+	struct pios_sensors_ring *gyro_ring;
 #if defined(PIOS_MPU6050_ACCEL)
 	enum pios_mpu60x0_accel_range accel_range;
-	xQueueHandle accel_queue;
+	struct pios_sensors_ring *accel_ring;
 #endif /* PIOS_MPU6050_ACCEL */
 	xTaskHandle TaskHandle;
 	xSemaphoreHandle data_ready_sema;
@@ -90,17 +90,17 @@ static struct mpu6050_dev *PIOS_MPU6050_alloc(void)
 	mpu6050_dev->magic = PIOS_MPU6050_DEV_MAGIC;
 
 #if defined(PIOS_MPU6050_ACCEL)
-	mpu6050_dev->accel_queue = xQueueCreate(PIOS_MPU6050_MAX_QUEUESIZE, sizeof(struct pios_sensor_accel_data));
+	mpu6050_dev->accel_ring = PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_accel_data), PIOS_MPU6050_RING_SIZE);
 
-	if (mpu6050_dev->accel_queue == NULL) {
+	if (mpu6050_dev->accel_ring == NULL) {
 		vPortFree(mpu6050_dev);
 		return NULL;
 	}
 #endif /* PIOS_MPU6050_ACCEL */
 
-	mpu6050_dev->gyro_queue = xQueueCreate(PIOS_MPU6050_MAX_QUEUESIZE, sizeof(struct pios_sensor_gyro_data));
+	mpu6050_dev->gyro_ring = PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_gyro_data), PIOS_MPU6050_RING_SIZE);
 
-	if (mpu6050_dev->gyro_queue == NULL) {
+	if (mpu6050_dev->gyro_ring == NULL) {
 		vPortFree(mpu6050_dev);
 		return NULL;
 	}
@@ -160,10 +160,10 @@ int32_t PIOS_MPU6050_Init(uint32_t i2c_id, uint8_t i2c_addr, const struct pios_m
 	PIOS_EXTI_Init(cfg->exti_cfg);
 
 #if defined(PIOS_MPU6050_ACCEL)
-	PIOS_SENSORS_Register(PIOS_SENSOR_ACCEL, pios_mpu6050_dev->accel_queue);
+	PIOS_SENSORS_RegisterRing(PIOS_SENSOR_ACCEL, pios_mpu6050_dev->accel_ring);
 #endif /* PIOS_MPU6050_ACCEL */
 
-	PIOS_SENSORS_Register(PIOS_SENSOR_GYRO, pios_mpu6050_dev->gyro_queue);
+	PIOS_SENSORS_RegisterRing(PIOS_SENSOR_GYRO, pios_mpu6050_dev->gyro_ring);
 
 	return 0;
 }
@@ -640,9 +640,9 @@ static void PIOS_MPU6050_Task(void *parameters)
 		gyro_data.z *= gyro_scale;
 		gyro_data.temperature = temperature;
 
-		xQueueSendToBack(pios_mpu6050_dev->accel_queue, (void *)&accel_data, 0);
+		PIOS_SENSORS_Push(pios_mpu6050_dev->accel_ring, &accel_data);
 
-		xQueueSendToBack(pios_mpu6050_dev->gyro_queue, (void *)&gyro_data, 0);
+		PIOS_SENSORS_Push(pios_mpu6050_dev->gyro_ring, &gyro_data);
 
 #else
 
@@ -679,7 +679,7 @@ static void PIOS_MPU6050_Task(void *parameters)
 		gyro_data.z *= gyro_scale;
 		gyro_data.temperature = temperature;
 
-		xQueueSendToBack(pios_mpu6050_dev->gyro_queue, (void *)&gyro_data, 0);
+		PIOS_SENSORS_Push(pios_mpu6050_dev->gyro_ring, &gyro_data);
 
 #endif /* PIOS_MPU6050_ACCEL */
 	}
@@ -60,13 +60,14 @@ enum pios_mpu9150_dev_magic {
 };
 
 #define PIOS_MPU9150_MAX_DOWNSAMPLE 2
+#define PIOS_MPU9150_RING_SIZE 8
 struct mpu9150_dev {
 	uint32_t i2c_id;
 	uint8_t i2c_addr;
 	enum pios_mpu60x0_accel_range accel_range;
 	enum pios_mpu60x0_range gyro_range;
-	xQueueHandle gyro_queue;
-	xQueueHandle accel_queue;
+	struct pios_sensors_ring *gyro_ring;
+	struct pios_sensors_ring *accel_ring;
 	xQueueHandle mag_queue;
 	xTaskHandle TaskHandle;
 	xSemaphoreHandle data_ready_sema;
@@ -101,14 +102,14 @@ static struct mpu9150_dev * PIOS_MPU9150_alloc(void)
 	
 	mpu9150_dev->magic = PIOS_MPU9150_DEV_MAGIC;
 	
-	mpu9150_dev->accel_queue = xQueueCreate(PIOS_MPU9150_MAX_DOWNSAMPLE, sizeof(struct pios_sensor_gyro_data));
-	if (mpu9150_dev->accel_queue == NULL) {
+	mpu9150_dev->accel_ring = PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_accel_data), PIOS_MPU9150_RING_SIZE);
+	if (mpu9150_dev->accel_ring == NULL) {
 		vPortFree(mpu9150_dev);
 		return NULL;
 	}
 
-	mpu9150_dev->gyro_queue = xQueueCreate(PIOS_MPU9150_MAX_DOWNSAMPLE, sizeof(struct pios_sensor_gyro_data));
-	if (mpu9150_dev->gyro_queue == NULL) {
+	mpu9150_dev->gyro_ring = PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_gyro_data), PIOS_MPU9150_RING_SIZE);
+	if (mpu9150_dev->gyro_ring == NULL) {
 		vPortFree(mpu9150_dev);
 		return NULL;
 	}
@@ -176,8 +177,8 @@ int32_t PIOS_MPU9150_Init(uint32_t i2c_id, uint8_t i2c_addr, const struct pios_m
 						 &dev->TaskHandle);
 	PIOS_Assert(result == pdPASS);
 
-	PIOS_SENSORS_Register(PIOS_SENSOR_ACCEL, dev->accel_queue);
-	PIOS_SENSORS_Register(PIOS_SENSOR_GYRO, dev->gyro_queue);
+	PIOS_SENSORS_RegisterRing(PIOS_SENSOR_ACCEL, dev->accel_ring);
+	PIOS_SENSORS_RegisterRing(PIOS_SENSOR_GYRO, dev->gyro_ring);
 	PIOS_SENSORS_Register(PIOS_SENSOR_MAG, dev->mag_queue);
 
 	return 0;
@@ -701,8 +702,8 @@ static void PIOS_MPU9150_Task(void *parameters)
 		gyro_data.z *= gyro_scale;
 		gyro_data.temperature = temperature;
 
-		xQueueSendToBack(dev->accel_queue, (void *)&accel_data, 0);
-		xQueueSendToBack(dev->gyro_queue, (void *)&gyro_data, 0);
+		PIOS_SENSORS_Push(dev->accel_ring, &accel_data);
+		PIOS_SENSORS_Push(dev->gyro_ring, &gyro_data);
 
 		// Check for mag data ready.  Reading it clears this flag.
 		if (PIOS_MPU9150_Mag_GetReg(MPU9150_MAG_STATUS) > 0) {
@@ -31,16 +31,54 @@
 // TODO: Make this pios driver actually create the queue and set that to the 
 // lower driver (??)
 
+#include <string.h>
 #include "pios_sensors.h"
+#include "semphr.h"
+#include "task.h"
+
+/**
+ * A ring of samples shared by one producer, normally a driver interrupt,
+ * and one consumer task.  Only the producer writes the head and only the
+ * consumer writes the tail, so neither side needs a critical section.  The
+ * indices run freely and are masked, which needs a power of two length.
+ */
+struct pios_sensors_ring {
+	uint8_t *samples;
+	uint16_t sample_size;
+	uint16_t mask;
+	volatile uint16_t head;
+	volatile uint16_t tail;
+	volatile uint32_t overruns;
+	xSemaphoreHandle data_ready;
+};
+
+//! Make the ring indices and samples visible to the other side in order
+#define RING_BARRIER() __sync_synchronize()
+
+//! The most float fields a sample can have to be averaged
+#define MAX_AVERAGE_FIELDS 4
 
 //! The list of queue handles
 static xQueueHandle queues[PIOS_SENSOR_LAST];
 
+//! The list of sample rings
+static struct pios_sensors_ring *rings[PIOS_SENSOR_LAST];
+
+//! Queues that get a copy of the samples, for analysis at the full sensor rate
+static xQueueHandle taps[PIOS_SENSOR_LAST];
+
+//! Samples dropped because a tap queue was full
+static volatile uint32_t tap_overruns[PIOS_SENSOR_LAST];
+
 //! Initialize the sensors interface
 int32_t PIOS_SENSORS_Init()
 {
-	for (uint32_t i = 0; i < PIOS_SENSOR_LAST; i++)
+	for (uint32_t i = 0; i < PIOS_SENSOR_LAST; i++) {
 		queues[i] = NULL;
+		rings[i] = NULL;
+		taps[i] = NULL;
+		tap_overruns[i] = 0;
+	}
 
 	return 0;
 }
@@ -63,4 +101,281 @@ xQueueHandle PIOS_SENSORS_GetQueue(enum pios_sensor_type type)
 		return NULL;
 
 	return queues[type];
-}
\ No newline at end of file
+}
+
+/**
+ * Set a queue that gets a copy of every sample of a sensor type.  The
+ * samples are passed on by whatever reads the queue of the sensor, so the
+ * tap sees the raw driver data at the full sensor rate.  Samples are
+ * dropped when the tap queue is full and counted as tap overruns.
+ * \param[in] type The sensor type to tap
+ * \param[in] queue The queue to copy the samples to, NULL to stop
+ * \return 0 if successful, -1 if not
+ */
+int32_t PIOS_SENSORS_SetTap(enum pios_sensor_type type, xQueueHandle queue)
+{
+	if (type < 0 || type >= PIOS_SENSOR_LAST)
+		return -1;
+
+	taps[type] = queue;
+
+	return 0;
+}
+
+/**
+ * Copy a sample taken from a sensor queue to the tap for that type, if any
+ * \param[in] type The sensor type of the sample
+ * \param[in] sample The sample as read from the queue
+ */
+void PIOS_SENSORS_Tap(enum pios_sensor_type type, const void *sample)
+{
+	xQueueHandle tap = taps[type];
+
+	if (tap != NULL && xQueueSendToBack(tap, sample, 0) != pdTRUE)
+		tap_overruns[type]++;
+}
+
+/**
+ * Get the number of samples that did not fit into the tap for a sensor type
+ * \param[in] type The sensor type
+ * \return the number of samples dropped since startup
+ */
+uint32_t PIOS_SENSORS_GetTapOverruns(enum pios_sensor_type type)
+{
+	if (type < 0 || type >= PIOS_SENSOR_LAST)
+		return 0;
+
+	return tap_overruns[type];
+}
+
+/**
+ * Create a sample ring for a sensor driver
+ * \param[in] sample_size The size of one sample
+ * \param[in] num_samples The length of the ring, must be a power of two
+ * \return the ring or NULL if it could not be allocated
+ */
+struct pios_sensors_ring *PIOS_SENSORS_CreateRing(uint16_t sample_size, uint16_t num_samples)
+{
+	if (num_samples < 2 || (num_samples & (num_samples - 1)) != 0)
+		return NULL;
+
+	struct pios_sensors_ring *ring = pvPortMalloc(sizeof(*ring));
+	if (ring == NULL)
+		return NULL;
+
+	ring->samples = pvPortMalloc(sample_size * num_samples);
+	if (ring->samples == NULL) {
+		vPortFree(ring);
+		return NULL;
+	}
+
+	vSemaphoreCreateBinary(ring->data_ready);
+	if (ring->data_ready == NULL) {
+		vPortFree(ring->samples);
+		vPortFree(ring);
+		return NULL;
+	}
+
+	// The semaphore starts out given, nothing is waiting for it yet
+	xSemaphoreTake(ring->data_ready, 0);
+
+	ring->sample_size = sample_size;
+	ring->mask = num_samples - 1;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->overruns = 0;
+
+	return ring;
+}
+
+/**
+ * Register the sample ring of a sensor with the PIOS_SENSORS interface
+ * \param[in] type The sensor type the ring carries
+ * \param[in] ring The ring created with @ref PIOS_SENSORS_CreateRing
+ * \return 0 if successful, -1 if not
+ */
+int32_t PIOS_SENSORS_RegisterRing(enum pios_sensor_type type, struct pios_sensors_ring *ring)
+{
+	if (type < 0 || type >= PIOS_SENSOR_LAST || ring == NULL)
+		return -1;
+
+	if (rings[type] != NULL)
+		return -1;
+
+	rings[type] = ring;
+
+	return 0;
+}
+
+//! Get the sample ring for a sensor type
+struct pios_sensors_ring *PIOS_SENSORS_GetRing(enum pios_sensor_type type)
+{
+	if (type < 0 || type >= PIOS_SENSOR_LAST)
+		return NULL;
+
+	return rings[type];
+}
+
+/**
+ * Copy a sample into the ring and publish it
+ * \return true if the ring was empty before, so the consumer may be waiting
+ */
+static bool ring_write(struct pios_sensors_ring *ring, const void *sample, bool *stored)
+{
+	uint16_t head = ring->head;
+
+	if ((uint16_t)(head - ring->tail) > ring->mask) {
+		// Full, drop the new sample.  Only the consumer may move the tail.
+		ring->overruns++;
+		*stored = false;
+		return false;
+	}
+
+	memcpy(&ring->samples[(head & ring->mask) * ring->sample_size], sample, ring->sample_size);
+
+	RING_BARRIER();
+	ring->head = head + 1;
+	RING_BARRIER();
+
+	*stored = true;
+
+	// Read the tail after publishing the head.  Either the consumer already
+	// caught up with the old head and this wakes it, or it has not checked
+	// for new samples yet and will see this one.
+	return ring->tail == head;
+}
+
+/**
+ * Add a sample to a ring from a task.  The sample is dropped and counted as
+ * an overrun if the ring is full.
+ * \param[in] ring The ring to add to
+ * \param[in] sample The sample to copy
+ * \return true if the sample was stored
+ */
+bool PIOS_SENSORS_Push(struct pios_sensors_ring *ring, const void *sample)
+{
+	bool stored;
+
+	if (ring_write(ring, sample, &stored))
+		xSemaphoreGive(ring->data_ready);
+
+	return stored;
+}
+
+/**
+ * Add a sample to a ring from an interrupt.  The sample is dropped and
+ * counted as an overrun if the ring is full.
+ * \param[in] ring The ring to add to
+ * \param[in] sample The sample to copy
+ * \param[out] woken Set if a higher priority task was woken
+ * \return true if the sample was stored
+ */
+bool PIOS_SENSORS_PushFromISR(struct pios_sensors_ring *ring, const void *sample, bool *woken)
+{
+	bool stored;
+
+	if (ring_write(ring, sample, &stored)) {
+		portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+		xSemaphoreGiveFromISR(ring->data_ready, &xHigherPriorityTaskWoken);
+		*woken = *woken || xHigherPriorityTaskWoken == pdTRUE;
+	}
+
+	return stored;
+}
+
+/**
+ * Take the oldest sample from a ring.  Call this repeatedly to drain every
+ * sample that arrived since the last time.
+ * \param[in] ring The ring to read from
+ * \param[out] sample Where to copy the sample
+ * \return true if a sample was read, false if the ring was empty
+ */
+bool PIOS_SENSORS_Pop(struct pios_sensors_ring *ring, void *sample)
+{
+	uint16_t tail = ring->tail;
+
+	if (tail == ring->head)
+		return false;
+
+	RING_BARRIER();
+	memcpy(sample, &ring->samples[(tail & ring->mask) * ring->sample_size], ring->sample_size);
+	RING_BARRIER();
+
+	ring->tail = tail + 1;
+	RING_BARRIER();
+
+	return true;
+}
+
+/**
+ * Take every sample from the ring of a sensor type, pass each one to the tap
+ * and average them.  The samples must be made of floats only, like the gyro
+ * and accel samples.
+ * \param[in] type The sensor type to read
+ * \param[out] average The average of the samples, unchanged if there were none
+ * \return the number of samples read
+ */
+uint32_t PIOS_SENSORS_PopAverage(enum pios_sensor_type type, void *average)
+{
+	struct pios_sensors_ring *ring = PIOS_SENSORS_GetRing(type);
+	float sample[MAX_AVERAGE_FIELDS];
+	float sum[MAX_AVERAGE_FIELDS] = {0};
+	uint32_t count = 0;
+
+	if (ring == NULL || ring->sample_size > sizeof(sample))
+		return 0;
+
+	const uint32_t fields = ring->sample_size / sizeof(float);
+
+	while (PIOS_SENSORS_Pop(ring, sample)) {
+		PIOS_SENSORS_Tap(type, sample);
+		for (uint32_t i = 0; i < fields; i++)
+			sum[i] += sample[i];
+		count++;
+	}
+
+	if (count > 0) {
+		for (uint32_t i = 0; i < fields; i++)
+			sum[i] /= count;
+		memcpy(average, sum, fields * sizeof(float));
+	}
+
+	return count;
+}
+
+/**
+ * Wait until a ring has samples
+ * \param[in] ring The ring to wait on
+ * \param[in] timeout_ms The longest time to wait
+ * \return true if there are samples, false on a timeout
+ */
+bool PIOS_SENSORS_WaitRing(struct pios_sensors_ring *ring, uint32_t timeout_ms)
+{
+	const portTickType timeout = timeout_ms / portTICK_RATE_MS;
+	const portTickType start = xTaskGetTickCount();
+
+	// The semaphore can be left given by samples that were already read,
+	// so check the ring again after every wake up
+	while (ring->tail == ring->head) {
+		portTickType elapsed = xTaskGetTickCount() - start;
+		if (elapsed >= timeout)
+			return false;
+
+		xSemaphoreTake(ring->data_ready, timeout - elapsed);
+	}
+
+	return true;
+}
+
+/**
+ * Get the number of samples a sensor type dropped because its ring was full
+ * \param[in] type The sensor type
+ * \return the number of dropped samples since startup
+ */
+uint32_t PIOS_SENSORS_GetOverruns(enum pios_sensor_type type)
+{
+	if (type < 0 || type >= PIOS_SENSOR_LAST || rings[type] == NULL)
+		return 0;
+
+	return rings[type]->overruns;
+}
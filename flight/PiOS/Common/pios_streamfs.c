@@ -0,0 +1,988 @@
+/**
+ ******************************************************************************
+ * @file       pios_streamfs.c
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup PIOS PIOS Core hardware abstraction layer
+ * @{
+ * @addtogroup PIOS_STREAMFS Flash Stream Filesystem Function
+ * @{
+ * @brief Append only stream filesystem for internal or external NOR Flash
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/* Project Includes */
+#include "pios.h"
+
+#include "pios_flash.h"		/* PIOS_FLASH_* */
+#include "pios_streamfs_priv.h"	/* Internal API */
+
+#include <stdbool.h>
+#include <stddef.h>		/* NULL */
+#include <string.h>		/* memcpy */
+
+#define MIN(x,y) ((x) < (y) ? (x) : (y))
+
+/*
+ * The partition is divided into arenas which are erased one at a time.
+ * Files are written sequentially into consecutive arenas, wrapping around
+ * at the end of the partition and overwriting the oldest data.  The first
+ * page of each arena holds a header naming the file and segment stored in
+ * it, written as soon as the arena is started.  Data follows in write_size
+ * pages.  The last page is reserved for a footer with the exact length of
+ * the data, written when the arena is full or the file is closed.  If the
+ * footer is missing, e.g. after a power loss, the data is recovered up to
+ * the last page that is not erased.  Arenas without a valid header are
+ * free.
+ */
+
+enum pios_streamfs_dev_magic {
+	PIOS_STREAMFS_DEV_MAGIC = 0x8a7d21c3,
+};
+
+struct streamfs_header {
+	uint32_t magic;
+	uint16_t file_id;
+	uint16_t file_segment;
+} __attribute__((packed));
+
+struct streamfs_footer {
+	uint32_t magic;
+	uint32_t written_bytes;
+	uint16_t file_id;
+	uint16_t file_segment;
+} __attribute__((packed));
+
+/*
+ * Filesystem state data tracked in RAM
+ */
+struct streamfs_state {
+	enum pios_streamfs_dev_magic magic;
+	const struct streamfs_cfg *cfg;
+
+	/* Underlying flash partition handle */
+	uintptr_t partition_id;
+	uint32_t partition_size;
+	uint16_t num_arenas;
+
+	/* Currently open file, only one can be open at a time */
+	bool file_open_writing;
+	bool file_open_reading;
+	uint16_t file_id;
+	uint16_t file_segment;
+	uint16_t active_arena_id;
+	uint32_t arena_offset;	/* Position within the active arena */
+	uint32_t arena_bytes;	/* Bytes of the file in the active arena when reading */
+	bool next_arena_erased;	/* The arena after the active one is erased ahead of time */
+
+	/* Tail of the written data that does not fill a page yet */
+	uint8_t *page_buffer;
+	uint32_t page_fill;
+};
+
+/*
+ * Internal Utility functions
+ */
+
+/**
+ * @brief Return the offset in flash of a position within an arena
+ */
+static uintptr_t streamfs_get_addr(const struct streamfs_state *streamfs, uint16_t arena_id, uint32_t arena_offset)
+{
+	PIOS_Assert(arena_id < streamfs->num_arenas);
+	PIOS_Assert(arena_offset < streamfs->cfg->arena_size);
+
+	return (arena_id * streamfs->cfg->arena_size) + arena_offset;
+}
+
+/**
+ * @brief Return the offset in flash of a data position within an arena
+ */
+static uintptr_t streamfs_get_data_addr(const struct streamfs_state *streamfs, uint16_t arena_id, uint32_t data_offset)
+{
+	/* Data starts after the header page */
+	return streamfs_get_addr(streamfs, arena_id, streamfs->cfg->write_size + data_offset);
+}
+
+/**
+ * @brief Return the number of data bytes that fit in one arena
+ */
+static uint32_t streamfs_arena_capacity(const struct streamfs_state *streamfs)
+{
+	return streamfs->cfg->arena_size - 2 * streamfs->cfg->write_size;
+}
+
+/**
+ * @brief Read the header of an arena
+ * @return 0 if the arena holds a file segment, < 0 if it is free
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t streamfs_read_header(const struct streamfs_state *streamfs, uint16_t arena_id, struct streamfs_header *header)
+{
+	if (PIOS_FLASH_read_data(streamfs->partition_id,
+					streamfs_get_addr(streamfs, arena_id, 0),
+					(uint8_t *)header,
+					sizeof(*header)) != 0) {
+		return -1;
+	}
+
+	if (header->magic != streamfs->cfg->fs_magic) {
+		return -2;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Check whether a data page of an arena is still erased
+ * @return 1 if erased, 0 if written, < 0 on failure
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t streamfs_page_erased(const struct streamfs_state *streamfs, uint16_t arena_id, uint32_t data_offset)
+{
+	uint8_t buf[32];
+
+	for (uint32_t pos = 0; pos < streamfs->cfg->write_size; pos += sizeof(buf)) {
+		uint16_t len = MIN(sizeof(buf), streamfs->cfg->write_size - pos);
+		if (PIOS_FLASH_read_data(streamfs->partition_id,
+						streamfs_get_data_addr(streamfs, arena_id, data_offset + pos),
+						buf,
+						len) != 0) {
+			return -1;
+		}
+
+		for (uint16_t i = 0; i < len; i++) {
+			if (buf[i] != 0xFF)
+				return 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Find how many data bytes a file segment holds
+ * @return 0 if success, < 0 on failure
+ * @note Must be called while holding the flash transaction lock
+ * @note Without footer only whole pages are counted, up to the last one
+ *       that is not erased
+ */
+static int32_t streamfs_get_written_bytes(const struct streamfs_state *streamfs, uint16_t arena_id, const struct streamfs_header *header, uint32_t *written_bytes)
+{
+	struct streamfs_footer footer;
+	uint32_t capacity = streamfs_arena_capacity(streamfs);
+
+	if (PIOS_FLASH_read_data(streamfs->partition_id,
+					streamfs_get_addr(streamfs, arena_id, streamfs->cfg->arena_size - sizeof(footer)),
+					(uint8_t *)&footer,
+					sizeof(footer)) != 0) {
+		return -1;
+	}
+
+	if (footer.magic == streamfs->cfg->fs_magic &&
+		footer.file_id == header->file_id &&
+		footer.file_segment == header->file_segment &&
+		footer.written_bytes <= capacity) {
+		*written_bytes = footer.written_bytes;
+		return 0;
+	}
+
+	/* The arena was never closed, look for the last page written */
+	uint32_t data_offset;
+	for (data_offset = capacity; data_offset > 0; data_offset -= streamfs->cfg->write_size) {
+		int32_t erased = streamfs_page_erased(streamfs, arena_id, data_offset - streamfs->cfg->write_size);
+		if (erased < 0)
+			return -2;
+		if (!erased)
+			break;
+	}
+
+	*written_bytes = data_offset;
+	return 0;
+}
+
+/**
+ * @brief Find the arena holding the most recently written file segment
+ * @return arena id if found, -1 if the filesystem is empty
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t streamfs_find_newest_arena(const struct streamfs_state *streamfs, struct streamfs_header *newest)
+{
+	int32_t newest_arena_id = -1;
+
+	for (uint16_t arena_id = 0; arena_id < streamfs->num_arenas; arena_id++) {
+		struct streamfs_header header;
+		if (streamfs_read_header(streamfs, arena_id, &header) != 0)
+			continue;
+
+		if (newest_arena_id < 0 ||
+			header.file_id > newest->file_id ||
+			(header.file_id == newest->file_id && header.file_segment > newest->file_segment)) {
+			*newest = header;
+			newest_arena_id = arena_id;
+		}
+	}
+
+	return newest_arena_id;
+}
+
+/**
+ * @brief Find the arena holding a given segment of a file, or the first
+ *        segment still present when segment is negative
+ * @return arena id if found, -1 otherwise
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t streamfs_find_segment(const struct streamfs_state *streamfs, uint16_t file_id, int32_t file_segment, uint16_t start_arena_id, struct streamfs_header *found)
+{
+	int32_t found_arena_id = -1;
+
+	/* Segments are usually consecutive, so start looking after the current one */
+	for (uint16_t i = 0; i < streamfs->num_arenas; i++) {
+		uint16_t arena_id = (start_arena_id + i) % streamfs->num_arenas;
+
+		struct streamfs_header header;
+		if (streamfs_read_header(streamfs, arena_id, &header) != 0)
+			continue;
+		if (header.file_id != file_id)
+			continue;
+
+		if (file_segment >= 0) {
+			if (header.file_segment == file_segment) {
+				*found = header;
+				return arena_id;
+			}
+		} else if (found_arena_id < 0 || header.file_segment < found->file_segment) {
+			*found = header;
+			found_arena_id = arena_id;
+		}
+	}
+
+	return found_arena_id;
+}
+
+/**
+ * @brief Start reading a file segment from its beginning
+ * @return 0 if success, < 0 on failure
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t streamfs_open_segment(struct streamfs_state *streamfs, uint16_t arena_id, const struct streamfs_header *header)
+{
+	uint32_t written_bytes;
+	if (streamfs_get_written_bytes(streamfs, arena_id, header, &written_bytes) != 0)
+		return -1;
+
+	streamfs->file_segment = header->file_segment;
+	streamfs->active_arena_id = arena_id;
+	streamfs->arena_offset = 0;
+	streamfs->arena_bytes = written_bytes;
+
+	return 0;
+}
+
+/**
+ * @brief Erase an arena unless that was done ahead of time, write its
+ *        header and make it the one being written
+ * @return 0 if success, < 0 on failure
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t streamfs_new_arena(struct streamfs_state *streamfs, uint16_t arena_id, bool erased)
+{
+	streamfs->next_arena_erased = false;
+
+	if (!erased &&
+		PIOS_FLASH_erase_range(streamfs->partition_id,
+					streamfs_get_addr(streamfs, arena_id, 0),
+					streamfs->cfg->arena_size) != 0) {
+		return -1;
+	}
+
+	struct streamfs_header header = {
+		.magic        = streamfs->cfg->fs_magic,
+		.file_id      = streamfs->file_id,
+		.file_segment = streamfs->file_segment,
+	};
+
+	if (PIOS_FLASH_write_data(streamfs->partition_id,
+					streamfs_get_addr(streamfs, arena_id, 0),
+					(uint8_t *)&header,
+					sizeof(header)) != 0) {
+		return -2;
+	}
+
+	streamfs->active_arena_id = arena_id;
+	streamfs->arena_offset = 0;
+
+	return 0;
+}
+
+/**
+ * @brief Write the footer that finalizes the arena being written
+ * @return 0 if success, < 0 on failure
+ * @note Must be called while holding the flash transaction lock
+ */
+static int32_t streamfs_close_arena(struct streamfs_state *streamfs)
+{
+	struct streamfs_footer footer = {
+		.magic         = streamfs->cfg->fs_magic,
+		.written_bytes = streamfs->arena_offset,
+		.file_id       = streamfs->file_id,
+		.file_segment  = streamfs->file_segment,
+	};
+
+	if (PIOS_FLASH_write_data(streamfs->partition_id,
+					streamfs_get_addr(streamfs, streamfs->active_arena_id, streamfs->cfg->arena_size - sizeof(footer)),
+					(uint8_t *)&footer,
+					sizeof(footer)) != 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write at most one page of data at the end of the open file,
+ *        moving on to the next arena when the active one is full
+ * @return 0 if success, < 0 on failure
+ * @note Must be called while holding the flash transaction lock
+ * @note The next arena is erased here unless PIOS_STREAMFS_EraseNextArena
+ *       already did so
+ */
+static int32_t streamfs_write_page(struct streamfs_state *streamfs, const uint8_t *data, uint16_t len)
+{
+	PIOS_Assert(len <= streamfs->cfg->write_size);
+
+	if (streamfs->arena_offset + streamfs->cfg->write_size > streamfs_arena_capacity(streamfs)) {
+		if (streamfs_close_arena(streamfs) != 0)
+			return -1;
+
+		streamfs->file_segment++;
+		if (streamfs_new_arena(streamfs, (streamfs->active_arena_id + 1) % streamfs->num_arenas,
+					streamfs->next_arena_erased) != 0)
+			return -2;
+	}
+
+	if (PIOS_FLASH_write_data(streamfs->partition_id,
+					streamfs_get_data_addr(streamfs, streamfs->active_arena_id, streamfs->arena_offset),
+					data,
+					len) != 0) {
+		return -3;
+	}
+
+	streamfs->arena_offset += len;
+
+	return 0;
+}
+
+static bool PIOS_STREAMFS_validate(const struct streamfs_state *streamfs)
+{
+	return (streamfs && (streamfs->magic == PIOS_STREAMFS_DEV_MAGIC));
+}
+
+static struct streamfs_state *PIOS_STREAMFS_alloc(void)
+{
+	struct streamfs_state *streamfs;
+
+	streamfs = (struct streamfs_state *)PIOS_malloc(sizeof(*streamfs));
+	if (!streamfs) return (NULL);
+
+	streamfs->magic = PIOS_STREAMFS_DEV_MAGIC;
+	streamfs->page_buffer = NULL;
+	return(streamfs);
+}
+static void PIOS_STREAMFS_free(struct streamfs_state *streamfs)
+{
+	/* Invalidate the magic */
+	streamfs->magic = ~PIOS_STREAMFS_DEV_MAGIC;
+	if (streamfs->page_buffer)
+		PIOS_free(streamfs->page_buffer);
+	PIOS_free(streamfs);
+}
+
+/**
+ * @brief Initialize a stream filesystem on a flash partition
+ * @return 0 if success, -1 if failure
+ */
+int32_t PIOS_STREAMFS_Init(uintptr_t *fs_id, const struct streamfs_cfg *cfg, enum pios_flash_partition_labels partition_label)
+{
+	PIOS_Assert(cfg);
+
+	/* Find the partition id for the requested partition label */
+	uintptr_t partition_id;
+	if (PIOS_FLASH_find_partition_id(partition_label, &partition_id) != 0) {
+		return -1;
+	}
+
+	/* Query the total partition size */
+	uint32_t partition_size;
+	if (PIOS_FLASH_get_partition_size(partition_id, &partition_size) != 0) {
+		return -1;
+	}
+
+	/* We must have at least 2 arenas so the one being written is never the only one */
+	PIOS_Assert((partition_size / cfg->arena_size > 1));
+
+	/* arena_size must exactly divide the partition size */
+	PIOS_Assert((partition_size % cfg->arena_size) == 0);
+
+	/* The header and footer must fit in the first and last page of the arena */
+	PIOS_Assert(cfg->write_size >= sizeof(struct streamfs_footer));
+	PIOS_Assert((cfg->arena_size % cfg->write_size) == 0);
+	PIOS_Assert(cfg->arena_size > 2 * cfg->write_size);
+
+	struct streamfs_state *streamfs;
+
+	streamfs = PIOS_STREAMFS_alloc();
+	if (!streamfs) {
+		return -1;
+	}
+
+	/* Bind configuration parameters to this filesystem instance */
+	streamfs->cfg               = cfg;	/* filesystem configuration */
+	streamfs->partition_id      = partition_id; /* underlying partition */
+	streamfs->partition_size    = partition_size; /* size of underlying partition */
+	streamfs->num_arenas        = partition_size / cfg->arena_size;
+	streamfs->file_open_writing = false;
+	streamfs->file_open_reading = false;
+	streamfs->page_fill         = 0;
+	streamfs->next_arena_erased = false;
+
+	streamfs->page_buffer = (uint8_t *)PIOS_malloc(cfg->write_size);
+	if (!streamfs->page_buffer) {
+		PIOS_STREAMFS_free(streamfs);
+		return -1;
+	}
+
+	*fs_id = (uintptr_t) streamfs;
+
+	return 0;
+}
+
+int32_t PIOS_STREAMFS_Destroy(uintptr_t fs_id)
+{
+	int32_t rc;
+
+	struct streamfs_state *streamfs = (struct streamfs_state *)fs_id;
+
+	if (!PIOS_STREAMFS_validate(streamfs)) {
+		rc = -1;
+		goto out_exit;
+	}
+
+	PIOS_STREAMFS_free(streamfs);
+	rc = 0;
+
+out_exit:
+	return rc;
+}
+
+/**********************************
+ *
+ * Provide a PIOS_STREAMFS_* driver
+ *
+ *********************************/
+#include "pios_streamfs.h"	/* API for stream filesystem */
+
+/**
+ * @brief Erases all files in the filesystem
+ * @param[in] fs_id The filesystem to use for this action
+ * @return 0 if success or error code
+ * @retval -1 if fs_id is not a valid filesystem instance
+ * @retval -2 if a file is open
+ * @retval -3 if failed to start transaction
+ * @retval -4 if failed to erase the partition
+ */
+int32_t PIOS_STREAMFS_Format(uintptr_t fs_id)
+{
+	int32_t rc;
+
+	struct streamfs_state *streamfs = (struct streamfs_state *)fs_id;
+
+	if (!PIOS_STREAMFS_validate(streamfs)) {
+		rc = -1;
+		goto out_exit;
+	}
+
+	if (streamfs->file_open_writing || streamfs->file_open_reading) {
+		rc = -2;
+		goto out_exit;
+	}
+
+	if (PIOS_FLASH_start_transaction(streamfs->partition_id) != 0) {
+		rc = -3;
+		goto out_exit;
+	}
+
+	if (PIOS_FLASH_erase_partition(streamfs->partition_id) != 0) {
+		rc = -4;
+		goto out_end_trans;
+	}
+
+	rc = 0;
+
+out_end_trans:
+	PIOS_FLASH_end_transaction(streamfs->partition_id);
+
+out_exit:
+	return rc;
+}
+
+/**
+ * @brief Start a new file after the most recent one
+ * @param[in] fs_id The filesystem to use for this action
+ * @return file id of the new file if success or error code
+ * @retval -1 if fs_id is not a valid filesystem instance
+ * @retval -2 if a file is already open
+ * @retval -3 if failed to start transaction
+ * @retval -4 if failed to erase the first arena of the file
+ * @note The oldest file data is overwritten once the partition is full
+ */
+int32_t PIOS_STREAMFS_OpenWrite(uintptr_t fs_id)
+{
+	int32_t rc;
+
+	struct streamfs_state *streamfs = (struct streamfs_state *)fs_id;
+
+	if (!PIOS_STREAMFS_validate(streamfs)) {
+		rc = -1;
+		goto out_exit;
+	}
+
+	if (streamfs->file_open_writing || streamfs->file_open_reading) {
+		rc = -2;
+		goto out_exit;
+	}
+
+	if (PIOS_FLASH_start_transaction(streamfs->partition_id) != 0) {
+		rc = -3;
+		goto out_exit;
+	}
+
+	struct streamfs_header newest;
+	int32_t newest_arena_id = streamfs_find_newest_arena(streamfs, &newest);
+
+	uint16_t arena_id;
+	if (newest_arena_id >= 0) {
+		streamfs->file_id = newest.file_id + 1;
+		arena_id = (newest_arena_id + 1) % streamfs->num_arenas;
+	} else {
+		streamfs->file_id = 0;
+		arena_id = 0;
+	}
+	streamfs->file_segment = 0;
+	streamfs->page_fill = 0;
+
+	if (streamfs_new_arena(streamfs, arena_id, false) != 0) {
+		rc = -4;
+		goto out_end_trans;
+	}
+
+	streamfs->file_open_writing = true;
+	rc = streamfs->file_id;
+
+out_end_trans:
+	PIOS_FLASH_end_transaction(streamfs->partition_id);
+
+out_exit:
+	return rc;
+}
+
+/**
+ * @brief Append data to the file open for writing
+ * @param[in] fs_id The filesystem to use for this action
+ * @param[in] data Data to append
+ * @param[in] len Length of the data
+ * @return 0 if success or error code
+ * @retval -1 if fs_id is not a valid filesystem instance
+ * @retval -2 if no file is open for writing
+ * @retval -3 if failed to start transaction
+ * @retval -4 if failed to write to flash
+ * @note Only whole pages are written, the remainder is kept in RAM until
+ *       more data arrives or the file is closed
+ */
+int32_t PIOS_STREAMFS_Write(uintptr_t fs_id, const uint8_t *data, uint32_t len)
+{
+	int32_t rc;
+
+	struct streamfs_state *streamfs = (struct streamfs_state *)fs_id;
+
+	if (!PIOS_STREAMFS_validate(streamfs)) {
+		rc = -1;
+		goto out_exit;
+	}
+
+	if (!streamfs->file_open_writing) {
+		rc = -2;
+		goto out_exit;
+	}
+
+	if (PIOS_FLASH_start_transaction(streamfs->partition_id) != 0) {
+		rc = -3;
+		goto out_exit;
+	}
+
+	uint32_t write_size = streamfs->cfg->write_size;
+	while (len > 0) {
+		/* Write aligned pages straight from the caller's buffer */
+		if (streamfs->page_fill == 0 && len >= write_size) {
+			if (streamfs_write_page(streamfs, data, write_size) != 0) {
+				rc = -4;
+				goto out_end_trans;
+			}
+			data += write_size;
+			len -= write_size;
+			continue;
+		}
+
+		uint32_t copy = MIN(write_size - streamfs->page_fill, len);
+		memcpy(&streamfs->page_buffer[streamfs->page_fill], data, copy);
+		streamfs->page_fill += copy;
+		data += copy;
+		len -= copy;
+
+		if (streamfs->page_fill == write_size) {
+			streamfs->page_fill = 0;
+			if (streamfs_write_page(streamfs, streamfs->page_buffer, write_size) != 0) {
+				rc = -4;
+				goto out_end_trans;
+			}
+		}
+	}
+
+	rc = 0;
+
+out_end_trans:
+	PIOS_FLASH_end_transaction(streamfs->partition_id);
+
+out_exit:
+	return rc;
+}
+
+/**
+ * @brief Erase the arena after the one being written ahead of time
+ * @param[in] fs_id The filesystem to use for this action
+ * @return 0 if success or error code
+ * @retval -1 if fs_id is not a valid filesystem instance
+ * @retval -2 if no file is open for writing
+ * @retval -3 if failed to start transaction
+ * @retval -4 if failed to erase the arena
+ * @note Call this while the writer is idle so that PIOS_STREAMFS_Write
+ *       does not have to wait for an erase when the active arena fills up.
+ *       Does nothing if the next arena is already erased.
+ */
+int32_t PIOS_STREAMFS_EraseNextArena(uintptr_t fs_id)
+{
+	int32_t rc;
+
+	struct streamfs_state *streamfs = (struct streamfs_state *)fs_id;
+
+	if (!PIOS_STREAMFS_validate(streamfs)) {
+		rc = -1;
+		goto out_exit;
+	}
+
+	if (!streamfs->file_open_writing) {
+		rc = -2;
+		goto out_exit;
+	}
+
+	if (streamfs->next_arena_erased) {
+		rc = 0;
+		goto out_exit;
+	}
+
+	if (PIOS_FLASH_start_transaction(streamfs->partition_id) != 0) {
+		rc = -3;
+		goto out_exit;
+	}
+
+	uint16_t arena_id = (streamfs->active_arena_id + 1) % streamfs->num_arenas;
+	if (PIOS_FLASH_erase_range(streamfs->partition_id,
+					streamfs_get_addr(streamfs, arena_id, 0),
+					streamfs->cfg->arena_size) != 0) {
+		rc = -4;
+		goto out_end_trans;
+	}
+
+	streamfs->next_arena_erased = true;
+	rc = 0;
+
+out_end_trans:
+	PIOS_FLASH_end_transaction(streamfs->partition_id);
+
+out_exit:
+	return rc;
+}
+
+/**
+ * @brief Open an existing file for reading from its oldest data still present
+ * @param[in] fs_id The filesystem to use for this action
+ * @param[in] file_id The file to open
+ * @return 0 if success or error code
+ * @retval -1 if fs_id is not a valid filesystem instance
+ * @retval -2 if a file is already open
+ * @retval -3 if failed to start transaction
+ * @retval -4 if the file does not exist
+ * @retval -5 if failed to read from flash
+ */
+int32_t PIOS_STREAMFS_OpenRead(uintptr_t fs_id, uint16_t file_id)
+{
+	int32_t rc;
+
+	struct streamfs_state *streamfs = (struct streamfs_state *)fs_id;
+
+	if (!PIOS_STREAMFS_validate(streamfs)) {
+		rc = -1;
+		goto out_exit;
+	}
+
+	if (streamfs->file_open_writing || streamfs->file_open_reading) {
+		rc = -2;
+		goto out_exit;
+	}
+
+	if (PIOS_FLASH_start_transaction(streamfs->partition_id) != 0) {
+		rc = -3;
+		goto out_exit;
+	}
+
+	struct streamfs_header header;
+	int32_t arena_id = streamfs_find_segment(streamfs, file_id, -1, 0, &header);
+	if (arena_id < 0) {
+		rc = -4;
+		goto out_end_trans;
+	}
+
+	if (streamfs_open_segment(streamfs, arena_id, &header) != 0) {
+		rc = -5;
+		goto out_end_trans;
+	}
+
+	streamfs->file_id = file_id;
+	streamfs->file_open_reading = true;
+
+	rc = 0;
+
+out_end_trans:
+	PIOS_FLASH_end_transaction(streamfs->partition_id);
+
+out_exit:
+	return rc;
+}
+
+/**
+ * @brief Read data from the file open for reading
+ * @param[in] fs_id The filesystem to use for this action
+ * @param[out] data Buffer to read into
+ * @param[in] len Size of the buffer
+ * @return number of bytes read, 0 at the end of the file, or error code
+ * @retval -1 if fs_id is not a valid filesystem instance
+ * @retval -2 if no file is open for reading
+ * @retval -3 if failed to start transaction
+ * @retval -4 if failed to read from flash
+ */
+int32_t PIOS_STREAMFS_Read(uintptr_t fs_id, uint8_t *data, uint32_t len)
+{
+	int32_t rc;
+
+	struct streamfs_state *streamfs = (struct streamfs_state *)fs_id;
+
+	if (!PIOS_STREAMFS_validate(streamfs)) {
+		rc = -1;
+		goto out_exit;
+	}
+
+	if (!streamfs->file_open_reading) {
+		rc = -2;
+		goto out_exit;
+	}
+
+	if (PIOS_FLASH_start_transaction(streamfs->partition_id) != 0) {
+		rc = -3;
+		goto out_exit;
+	}
+
+	uint32_t bytes_read = 0;
+	while (len > 0) {
+		if (streamfs->arena_offset >= streamfs->arena_bytes) {
+			/* Move on to the next segment of the file, if there is one */
+			struct streamfs_header header;
+			int32_t arena_id = streamfs_find_segment(streamfs, streamfs->file_id,
+							streamfs->file_segment + 1,
+							(streamfs->active_arena_id + 1) % streamfs->num_arenas,
+							&header);
+			if (arena_id < 0)
+				break;
+
+			if (streamfs_open_segment(streamfs, arena_id, &header) != 0) {
+				rc = -4;
+				goto out_end_trans;
+			}
+			continue;
+		}
+
+		uint16_t chunk = MIN(MIN(len, streamfs->arena_bytes - streamfs->arena_offset), 0xFFFF);
+		if (PIOS_FLASH_read_data(streamfs->partition_id,
+						streamfs_get_data_addr(streamfs, streamfs->active_arena_id, streamfs->arena_offset),
+						data,
+						chunk) != 0) {
+			rc = -4;
+			goto out_end_trans;
+		}
+
+		streamfs->arena_offset += chunk;
+		bytes_read += chunk;
+		data += chunk;
+		len -= chunk;
+	}
+
+	rc = bytes_read;
+
+out_end_trans:
+	PIOS_FLASH_end_transaction(streamfs->partition_id);
+
+out_exit:
+	return rc;
+}
+
+/**
+ * @brief Close the open file.  A file open for writing is flushed to flash.
+ * @param[in] fs_id The filesystem to use for this action
+ * @return 0 if success or error code
+ * @retval -1 if fs_id is not a valid filesystem instance
+ * @retval -2 if no file is open
+ * @retval -3 if failed to start transaction
+ * @retval -4 if failed to write the end of the file
+ */
+int32_t PIOS_STREAMFS_Close(uintptr_t fs_id)
+{
+	int32_t rc;
+
+	struct streamfs_state *streamfs = (struct streamfs_state *)fs_id;
+
+	if (!PIOS_STREAMFS_validate(streamfs)) {
+		rc = -1;
+		goto out_exit;
+	}
+
+	if (streamfs->file_open_reading) {
+		streamfs->file_open_reading = false;
+		rc = 0;
+		goto out_exit;
+	}
+
+	if (!streamfs->file_open_writing) {
+		rc = -2;
+		goto out_exit;
+	}
+
+	if (PIOS_FLASH_start_transaction(streamfs->partition_id) != 0) {
+		rc = -3;
+		goto out_exit;
+	}
+
+	/* The file is closed even if the flush fails, the arena is then left without footer */
+	streamfs->file_open_writing = false;
+
+	if (streamfs->page_fill > 0) {
+		uint16_t page_fill = streamfs->page_fill;
+		streamfs->page_fill = 0;
+		if (streamfs_write_page(streamfs, streamfs->page_buffer, page_fill) != 0) {
+			rc = -4;
+			goto out_end_trans;
+		}
+	}
+
+	if (streamfs_close_arena(streamfs) != 0) {
+		rc = -4;
+		goto out_end_trans;
+	}
+
+	rc = 0;
+
+out_end_trans:
+	PIOS_FLASH_end_transaction(streamfs->partition_id);
+
+out_exit:
+	return rc;
+}
+
+/**
+ * @brief Scan the filesystem for the lowest or highest file id present
+ * @return file id if found, -1 if invalid or -2 if there are no files
+ */
+static int32_t streamfs_scan_file_ids(uintptr_t fs_id, bool highest)
+{
+	int32_t rc;
+
+	struct streamfs_state *streamfs = (struct streamfs_state *)fs_id;
+
+	if (!PIOS_STREAMFS_validate(streamfs)) {
+		rc = -1;
+		goto out_exit;
+	}
+
+	if (PIOS_FLASH_start_transaction(streamfs->partition_id) != 0) {
+		rc = -1;
+		goto out_exit;
+	}
+
+	rc = -2;
+	for (uint16_t arena_id = 0; arena_id < streamfs->num_arenas; arena_id++) {
+		struct streamfs_header header;
+		if (streamfs_read_header(streamfs, arena_id, &header) != 0)
+			continue;
+
+		if (rc < 0 ||
+			(highest && header.file_id > rc) ||
+			(!highest && header.file_id < rc)) {
+			rc = header.file_id;
+		}
+	}
+
+	PIOS_FLASH_end_transaction(streamfs->partition_id);
+
+out_exit:
+	return rc;
+}
+
+/**
+ * @brief Get the id of the oldest file still (partially) present
+ * @param[in] fs_id The filesystem to use for this action
+ * @return file id if success or error code
+ * @retval -1 if fs_id is not a valid filesystem instance
+ * @retval -2 if there are no files
+ */
+int32_t PIOS_STREAMFS_MinFileId(uintptr_t fs_id)
+{
+	return streamfs_scan_file_ids(fs_id, false);
+}
+
+/**
+ * @brief Get the id of the most recent file
+ * @param[in] fs_id The filesystem to use for this action
+ * @return file id if success or error code
+ * @retval -1 if fs_id is not a valid filesystem instance
+ * @retval -2 if there are no files
+ */
+int32_t PIOS_STREAMFS_MaxFileId(uintptr_t fs_id)
+{
+	return streamfs_scan_file_ids(fs_id, true);
+}
+
+/**
+ * @}
+ * @}
+ */
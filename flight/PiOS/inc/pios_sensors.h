@@ -32,6 +32,7 @@
 #define PIOS_SENSOR_H
 
 #include "stdint.h"
+#include "stdbool.h"
 #include "FreeRTOS.h"
 #include "queue.h"
 
@@ -81,6 +82,9 @@ struct pios_sensor_registration {
 	xQueueHandle queue;
 };
 
+//! Lock free ring of samples with one producer (a driver) and one consumer
+struct pios_sensors_ring;
+
 //! Initialize the PIOS_SENSORS interface
 int32_t PIOS_SENSORS_Init();
 
@@ -90,4 +94,40 @@ int32_t PIOS_SENSORS_Register(enum pios_sensor_type type, xQueueHandle queue);
 //! Get the data queue for a sensor type
 xQueueHandle PIOS_SENSORS_GetQueue(enum pios_sensor_type type);
 
+//! Set a queue that gets a copy of every sample of a sensor type
+int32_t PIOS_SENSORS_SetTap(enum pios_sensor_type type, xQueueHandle queue);
+
+//! Copy a sample taken from a sensor queue to the tap for that type
+void PIOS_SENSORS_Tap(enum pios_sensor_type type, const void *sample);
+
+//! Get the number of samples that did not fit into the tap for a sensor type
+uint32_t PIOS_SENSORS_GetTapOverruns(enum pios_sensor_type type);
+
+//! Create a sample ring for a sensor driver
+struct pios_sensors_ring *PIOS_SENSORS_CreateRing(uint16_t sample_size, uint16_t num_samples);
+
+//! Register the sample ring of a sensor with the PIOS_SENSORS interface
+int32_t PIOS_SENSORS_RegisterRing(enum pios_sensor_type type, struct pios_sensors_ring *ring);
+
+//! Get the sample ring for a sensor type
+struct pios_sensors_ring *PIOS_SENSORS_GetRing(enum pios_sensor_type type);
+
+//! Add a sample to a ring from a task
+bool PIOS_SENSORS_Push(struct pios_sensors_ring *ring, const void *sample);
+
+//! Add a sample to a ring from an interrupt
+bool PIOS_SENSORS_PushFromISR(struct pios_sensors_ring *ring, const void *sample, bool *woken);
+
+//! Take the oldest sample from a ring
+bool PIOS_SENSORS_Pop(struct pios_sensors_ring *ring, void *sample);
+
+//! Take, tap and average every sample in the ring of a sensor type
+uint32_t PIOS_SENSORS_PopAverage(enum pios_sensor_type type, void *average);
+
+//! Wait until a ring has samples
+bool PIOS_SENSORS_WaitRing(struct pios_sensors_ring *ring, uint32_t timeout_ms);
+
+//! Get the number of samples a sensor type dropped because its ring was full
+uint32_t PIOS_SENSORS_GetOverruns(enum pios_sensor_type type);
+
 #endif /* PIOS_SENSOR_H */
\ No newline at end of file
@@ -183,6 +183,7 @@
 #if defined(PIOS_INCLUDE_FLASH)
 #include <pios_flash.h>
 #include <pios_flashfs.h>
+#include <pios_streamfs.h>
 #endif
 
 #if defined(PIOS_INCLUDE_BL_HELPER)
@@ -46,6 +46,7 @@
 
 #define TASK_PRIORITY (tskIDLE_PRIORITY + 3)
 #define MAX_UPDATE_PERIOD_MS 1000
+#define INITIAL_HEAP_SIZE 16
 
 // Private types
 
@@ -66,12 +67,22 @@ struct PeriodicObjectListStruct {
 	EventCallbackInfo evInfo; /** Event callback information */
     uint16_t updatePeriodMs; /** Update period in ms or 0 if no periodic updates are needed */
     int32_t timeToNextUpdateMs; /** Time delay to the next update */
+    int16_t heapIndex; /** Position in the update heap or -1 if not scheduled */
     struct PeriodicObjectListStruct* next; /** Needed by linked list library (utlist.h) */
 };
 typedef struct PeriodicObjectListStruct PeriodicObjectList;
 
 // Private variables
 static PeriodicObjectList* objList;
+
+/**
+ * Binary min-heap of the scheduled entries of objList, ordered by
+ * timeToNextUpdateMs. The next entry due is always updateHeap[0].
+ */
+static PeriodicObjectList** updateHeap;
+static uint16_t updateHeapSize;
+static uint16_t updateHeapMaxSize;
+
 static xQueueHandle queue;
 static xTaskHandle eventTaskHandle;
 static xSemaphoreHandle mutex;
@@ -83,6 +94,11 @@ static void eventTask();
 static int32_t eventPeriodicCreate(UAVObjEvent* ev, UAVObjEventCallback cb, xQueueHandle queue, uint16_t periodMs);
 static int32_t eventPeriodicUpdate(UAVObjEvent* ev, UAVObjEventCallback cb, xQueueHandle queue, uint16_t periodMs);
 static uint16_t randomizePeriod(uint16_t periodMs);
+static void schedulePeriodic(PeriodicObjectList* objEntry);
+static int32_t heapInsert(PeriodicObjectList* objEntry);
+static void heapRemove(PeriodicObjectList* objEntry);
+static void heapSiftUp(uint16_t idx);
+static void heapSiftDown(uint16_t idx);
 
 
 /**
@@ -93,6 +109,9 @@ int32_t EventDispatcherInitialize()
 {
 	// Initialize variables
 	objList = NULL;
+	updateHeap = NULL;
+	updateHeapSize = 0;
+	updateHeapMaxSize = 0;
 	memset(&stats, 0, sizeof(EventStats));
 
 	// Create mutex
@@ -233,9 +252,11 @@ static int32_t eventPeriodicCreate(UAVObjEvent* ev, UAVObjEventCallback cb, xQue
 	objEntry->evInfo.cb = cb;
 	objEntry->evInfo.queue = queue;
     objEntry->updatePeriodMs = periodMs;
-    objEntry->timeToNextUpdateMs = randomizePeriod(periodMs); // avoid bunching of updates
+    objEntry->timeToNextUpdateMs = xTaskGetTickCount()*portTICK_RATE_MS + randomizePeriod(periodMs); // avoid bunching of updates
+    objEntry->heapIndex = -1;
     // Add to list
     LL_APPEND(objList, objEntry);
+    schedulePeriodic(objEntry);
 	// Release lock
 	xSemaphoreGiveRecursive(mutex);
     return 0;
@@ -265,7 +286,8 @@ static int32_t eventPeriodicUpdate(UAVObjEvent* ev, UAVObjEventCallback cb, xQue
 		{
 			// Object found, update period
 			objEntry->updatePeriodMs = periodMs;
-			objEntry->timeToNextUpdateMs = randomizePeriod(periodMs); // avoid bunching of updates
+			objEntry->timeToNextUpdateMs = xTaskGetTickCount()*portTICK_RATE_MS + randomizePeriod(periodMs); // avoid bunching of updates
+			schedulePeriodic(objEntry);
 			// Release lock
 			xSemaphoreGiveRecursive(mutex);
 			return 0;
@@ -320,61 +342,179 @@ static void eventTask()
 }
 
 /**
- * Handle periodic updates for all objects.
+ * Handle periodic updates for all objects that are due.
  * \return The system time until the next update (in ms) or -1 if failed
  */
 static int32_t processPeriodicUpdates()
 {
 	PeriodicObjectList* objEntry;
 	int32_t timeNow;
-    int32_t timeToNextUpdate;
-    int32_t offset;
+	int32_t latency;
+	int32_t offset;
 
 	// Get lock
 	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
 
-    // Iterate through each object and update its timer, if zero then transmit object.
-    // Also calculate smallest delay to next update.
-    timeToNextUpdate = xTaskGetTickCount()*portTICK_RATE_MS + MAX_UPDATE_PERIOD_MS;
-    LL_FOREACH(objList, objEntry)
-    {
-        // If object is configured for periodic updates
-        if (objEntry->updatePeriodMs > 0)
-        {
-            // Check if time for the next update
-        	timeNow = xTaskGetTickCount()*portTICK_RATE_MS;
-            if (objEntry->timeToNextUpdateMs <= timeNow)
-            {
-                // Reset timer
-            	offset = ( timeNow - objEntry->timeToNextUpdateMs ) % objEntry->updatePeriodMs;
-            	objEntry->timeToNextUpdateMs = timeNow + objEntry->updatePeriodMs - offset;
-    			// Invoke callback, if one
-    			if ( objEntry->evInfo.cb != 0)
-    			{
-    				objEntry->evInfo.cb(&objEntry->evInfo.ev); // the function is expected to copy the event information
-    			}
-    			// Push event to queue, if one
-    			if ( objEntry->evInfo.queue != 0)
-    			{
-    				if ( xQueueSend(objEntry->evInfo.queue, &objEntry->evInfo.ev, 0) != pdTRUE ) // do not block if queue is full
-    				{
-						if (objEntry->evInfo.ev.obj != NULL)
-							stats.lastErrorID = UAVObjGetID(objEntry->evInfo.ev.obj);
-    					++stats.eventErrors;
-    				}
-    			}
-            }
-            // Update minimum delay
-            if (objEntry->timeToNextUpdateMs < timeToNextUpdate)
-            {
-            	timeToNextUpdate = objEntry->timeToNextUpdateMs;
-            }
-        }
-    }
-
-    // Done
-    xSemaphoreGiveRecursive(mutex);
-    return timeToNextUpdate;
+	timeNow = xTaskGetTickCount()*portTICK_RATE_MS;
+
+	// Only the entries at the top of the heap can be due
+	while (updateHeapSize > 0 && updateHeap[0]->timeToNextUpdateMs <= timeNow)
+	{
+		objEntry = updateHeap[0];
+
+		// Track how late this update is
+		latency = timeNow - objEntry->timeToNextUpdateMs;
+		++stats.periodicDispatches;
+		stats.periodicLatencySumMs += latency;
+		if ((uint32_t)latency > stats.periodicMaxLatencyMs)
+			stats.periodicMaxLatencyMs = latency;
+
+		// Reset timer and move the entry down the heap
+		offset = ( timeNow - objEntry->timeToNextUpdateMs ) % objEntry->updatePeriodMs;
+		objEntry->timeToNextUpdateMs = timeNow + objEntry->updatePeriodMs - offset;
+		heapSiftDown(0);
+
+		// Invoke callback, if one
+		if ( objEntry->evInfo.cb != 0)
+		{
+			objEntry->evInfo.cb(&objEntry->evInfo.ev); // the function is expected to copy the event information
+		}
+		// Push event to queue, if one
+		if ( objEntry->evInfo.queue != 0)
+		{
+			if ( xQueueSend(objEntry->evInfo.queue, &objEntry->evInfo.ev, 0) != pdTRUE ) // do not block if queue is full
+			{
+				if (objEntry->evInfo.ev.obj != NULL)
+					stats.lastErrorID = UAVObjGetID(objEntry->evInfo.ev.obj);
+				++stats.eventErrors;
+			}
+		}
+	}
+
+	// The next update is the one at the top of the heap
+	int32_t timeToNextUpdate = timeNow + MAX_UPDATE_PERIOD_MS;
+	if (updateHeapSize > 0 && updateHeap[0]->timeToNextUpdateMs < timeToNextUpdate)
+		timeToNextUpdate = updateHeap[0]->timeToNextUpdateMs;
+
+	// Done
+	xSemaphoreGiveRecursive(mutex);
+	return timeToNextUpdate;
+}
+
+/**
+ * Add, move or remove an entry in the update heap after its period or
+ * next update time has changed. Must be called with the mutex held.
+ */
+static void schedulePeriodic(PeriodicObjectList* objEntry)
+{
+	if (objEntry->updatePeriodMs == 0) {
+		heapRemove(objEntry);
+	} else if (objEntry->heapIndex < 0) {
+		if (heapInsert(objEntry) != 0)
+			++stats.eventErrors;
+	} else {
+		heapSiftUp(objEntry->heapIndex);
+		heapSiftDown(objEntry->heapIndex);
+	}
+}
+
+/**
+ * Insert an entry in the update heap, growing it if needed
+ * \return Success (0), failure (-1)
+ */
+static int32_t heapInsert(PeriodicObjectList* objEntry)
+{
+	if (updateHeapSize == updateHeapMaxSize) {
+		uint16_t maxSize = updateHeapMaxSize ? updateHeapMaxSize * 2 : INITIAL_HEAP_SIZE;
+		PeriodicObjectList** newHeap = (PeriodicObjectList**)pvPortMalloc(maxSize * sizeof(PeriodicObjectList*));
+		if (newHeap == NULL)
+			return -1;
+
+		if (updateHeap != NULL) {
+			memcpy(newHeap, updateHeap, updateHeapSize * sizeof(PeriodicObjectList*));
+			vPortFree(updateHeap);
+		}
+		updateHeap = newHeap;
+		updateHeapMaxSize = maxSize;
+	}
+
+	objEntry->heapIndex = updateHeapSize;
+	updateHeap[updateHeapSize++] = objEntry;
+	heapSiftUp(objEntry->heapIndex);
+
+	return 0;
+}
+
+/**
+ * Remove an entry from the update heap, if it is in it
+ */
+static void heapRemove(PeriodicObjectList* objEntry)
+{
+	int16_t idx = objEntry->heapIndex;
+	if (idx < 0)
+		return;
+
+	objEntry->heapIndex = -1;
+
+	// Fill the hole with the last entry and restore the heap order
+	if (--updateHeapSize != idx) {
+		PeriodicObjectList* moved = updateHeap[updateHeapSize];
+		updateHeap[idx] = moved;
+		moved->heapIndex = idx;
+		heapSiftUp(idx);
+		heapSiftDown(moved->heapIndex);
+	}
+}
+
+/**
+ * Swap two entries of the update heap
+ */
+static void heapSwap(uint16_t a, uint16_t b)
+{
+	PeriodicObjectList* tmp = updateHeap[a];
+	updateHeap[a] = updateHeap[b];
+	updateHeap[b] = tmp;
+	updateHeap[a]->heapIndex = a;
+	updateHeap[b]->heapIndex = b;
+}
+
+/**
+ * Move an entry up the heap until its parent is due before it
+ */
+static void heapSiftUp(uint16_t idx)
+{
+	while (idx > 0) {
+		uint16_t parent = (idx - 1) / 2;
+		if (updateHeap[parent]->timeToNextUpdateMs <= updateHeap[idx]->timeToNextUpdateMs)
+			break;
+		heapSwap(parent, idx);
+		idx = parent;
+	}
+}
+
+/**
+ * Move an entry down the heap until both children are due after it
+ */
+static void heapSiftDown(uint16_t idx)
+{
+	while (true) {
+		uint16_t smallest = idx;
+		uint16_t left = 2 * idx + 1;
+		uint16_t right = left + 1;
+
+		if (left < updateHeapSize &&
+				updateHeap[left]->timeToNextUpdateMs < updateHeap[smallest]->timeToNextUpdateMs)
+			smallest = left;
+		if (right < updateHeapSize &&
+				updateHeap[right]->timeToNextUpdateMs < updateHeap[smallest]->timeToNextUpdateMs)
+			smallest = right;
+
+		if (smallest == idx)
+			break;
+
+		heapSwap(idx, smallest);
+		idx = smallest;
+	}
 }
 
 /**
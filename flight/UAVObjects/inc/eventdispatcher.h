@@ -39,6 +39,9 @@
 typedef struct {
 	uint32_t lastErrorID;
 	uint32_t eventErrors;
+	uint32_t periodicDispatches; /** Number of periodic events dispatched */
+	uint32_t periodicLatencySumMs; /** Total time periodic events were dispatched after they were due */
+	uint32_t periodicMaxLatencyMs; /** Longest time a periodic event was dispatched after it was due */
 } EventStats;
 
 // Public functions
@@ -34,6 +34,13 @@
 #define UAVOBJ_ALL_INSTANCES 0xFFFF
 #define UAVOBJ_MAX_INSTANCES 1000
 
+/*
+ * Multi instance objects store their instances in chunks that double in
+ * size, this is enough chunks to reach UAVOBJ_MAX_INSTANCES starting from
+ * a single instance.
+ */
+#define UAVOBJ_MAX_INSTANCE_CHUNKS 11
+
 /*
  * Shifts and masks used to read/write metadata flags.
  */
@@ -136,13 +143,18 @@ typedef struct {
 	uint32_t eventCallbackErrors;
 	uint32_t lastCallbackErrorID;
 	uint32_t lastQueueErrorID;
+	uint32_t lockContentions; /** Number of times the object manager lock was already held by another task */
+	uint32_t lockMaxHoldUs; /** Longest time the object manager lock was held */
+	uint32_t seqReadRetries; /** Number of lockless reads retried due to a concurrent write */
+	uint32_t saveMaxUs; /** Longest time spent saving an object to the filesystem */
 } UAVObjStats;
 
 int32_t UAVObjInitialize();
 void UAVObjGetStats(UAVObjStats* statsOut);
 void UAVObjClearStats();
 UAVObjHandle UAVObjRegister(uint32_t id,
-		int32_t isSingleInstance, int32_t isSettings, uint32_t numBytes, UAVObjInitializeCallback initCb);
+		int32_t isSingleInstance, int32_t isSettings, uint32_t numBytes,
+		uint16_t numInstances, UAVObjInitializeCallback initCb);
 UAVObjHandle UAVObjGetByID(uint32_t id);
 uint32_t UAVObjGetID(UAVObjHandle obj);
 uint32_t UAVObjGetNumBytes(UAVObjHandle obj);
@@ -43,6 +43,7 @@
 #define $(NAMEUC)_ISSINGLEINST $(ISSINGLEINST)
 #define $(NAMEUC)_ISSETTINGS $(ISSETTINGS)
 #define $(NAMEUC)_NUMBYTES $(NUMBYTES)
+#define $(NAMEUC)_NUMINSTANCES $(NUMINSTANCES)
 
 // Generic interface functions
 int32_t $(NAME)Initialize();
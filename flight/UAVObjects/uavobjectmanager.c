@@ -37,6 +37,22 @@ extern uintptr_t pios_uavo_settings_fs_id;
 
 // Constants
 
+/**
+ * Initial number of entries in the object index. The index doubles in size
+ * whenever it fills up.
+ */
+#ifndef UAVOBJ_INDEX_INITIAL_SIZE
+#define UAVOBJ_INDEX_INITIAL_SIZE 32
+#endif
+
+/**
+ * Number of lockless attempts to read a single instance object before
+ * falling back to taking the lock.
+ */
+#ifndef UAVOBJ_SEQ_READ_ATTEMPTS
+#define UAVOBJ_SEQ_READ_ATTEMPTS 3
+#endif
+
 // Private types
 
 // Macros
@@ -54,16 +70,17 @@ struct ObjectEventEntry {
 	UAVObjEventCallback       cb;
 	uint8_t                   eventMask;
 	struct ObjectEventEntry * next;
+	struct ObjectEventEntry * next_retired;
 };
 
 /*
   MetaInstance   == [UAVOBase [UAVObjMetadata]]
-  SingleInstance == [UAVOBase [UAVOData [InstanceData]]]
-  MultiInstance  == [UAVOBase [UAVOData [NumInstances [InstanceData0 [next]]]]
-                                                  ____________________/
-                                                  \-->[InstanceData1 [next]]
-                                                  _________...________/
-                                                  \-->[InstanceDataN [next]]
+  SingleInstance == [UAVOBase [UAVOData [Seq [InstanceData]]]]
+  MultiInstance  == [UAVOBase [UAVOData [NumInstances [Chunk0Instances [Chunks [Chunk0Data]]]]]]
+                                                                        |
+                                                                        +-->[Chunk1Data]
+                                                                        +-->[Chunk2Data]
+                                                                        +-->...
  */
 
 /*
@@ -107,35 +124,67 @@ struct UAVOData {
 struct UAVOSingle {
 	struct UAVOData   uavo;
 
-	uint8_t           instance0[];
-	/* 
-	 * Additional space will be malloc'd here to hold the
-	 * the data for this instance.
+	/*
+	 * Sequence counter for lockless reads of instance0. Odd while a
+	 * write is in progress, incremented twice by every write.
 	 */
-} __attribute__((packed));
+	volatile uint16_t seq;
+
+	/*
+	 * Held by the writer of instance0. Writers also run with interrupts
+	 * disabled, so this is only ever contended by writers running in
+	 * parallel on a multi core host.
+	 */
+	volatile uint8_t  write_lock;
 
-/* Part of a linked list of instances chained off of a multi instance UAVO. */
-struct UAVOMultiInst {
-	struct UAVOMultiInst * next;
-	uint8_t                instance[];
+	uint8_t           instance0[];
 	/* 
 	 * Additional space will be malloc'd here to hold the
 	 * the data for this instance.
 	 */
 } __attribute__((packed));
 
-/* Augmented type for Multi Instance Data UAVO */
+/*
+ * Augmented type for Multi Instance Data UAVO
+ *
+ * Instances are stored in chunks which double in size so that any
+ * instance can be reached in constant time. Chunk 0 holds
+ * chunk0_instances instances and is allocated along with the object,
+ * chunk n > 0 holds (chunk0_instances << (n - 1)) instances and is only
+ * allocated once the first instance in it is created.
+ */
 struct UAVOMulti {
 	struct UAVOData        uavo;
 
 	uint16_t               num_instances;
-	struct UAVOMultiInst   instance0;
+	uint16_t               chunk0_instances;
+	uint8_t *              chunks[UAVOBJ_MAX_INSTANCE_CHUNKS];
+	uint8_t                chunk0[];
 	/*
 	 * Additional space will be malloc'd here to hold the
-	 * the data for instance 0.
+	 * the data for the instances in chunk 0.
 	 */
 } __attribute__((packed));
 
+/*
+ * Index of all registered data objects sorted by object id. This lets
+ * UAVObjGetByID do a binary search instead of walking uavo_list.
+ * Metaobjects are not indexed, they are found through their parent
+ * object since a metaobject id is always the parent id + 1.
+ *
+ * The index is only ever modified with the object manager mutex held.
+ * Readers do not take the mutex, they sample uavo_index_seq before and
+ * after the search and fall back to a locked search if the index was
+ * being modified at the same time. Every slot below num_entries always
+ * holds a valid object pointer, so a racing reader can miss but never
+ * return the wrong object.
+ */
+struct UAVOIndex {
+	uint16_t           num_entries;
+	uint16_t           max_entries;
+	struct UAVOData *  entries[];
+};
+
 /** all information about a metaobject are hardcoded constants **/
 #define MetaNumBytes sizeof(UAVObjMetadata)
 #define MetaBaseObjectPtr(obj) ((struct UAVOData *)((obj)-offsetof(struct UAVOData, metaObj)))
@@ -146,22 +195,44 @@ struct UAVOMulti {
 
 /** all information about instances are dependant on object type **/
 #define ObjSingleInstanceDataOffset(obj) ((void*)(&(( (struct UAVOSingle*)obj )->instance0)))
-#define InstanceDataOffset(inst) ((void*)&(( (struct UAVOMultiInst*)inst )->instance))
 #define InstanceData(instance) (void*)instance
 
+/** single instance data objects are read and written without taking the object manager lock **/
+#define isSingleInstanceData(obj) (((struct UAVOBase *)(obj))->flags.isSingle && !((struct UAVOBase *)(obj))->flags.isMeta)
+
 // Private functions
 static int32_t sendEvent(struct UAVOBase * obj, uint16_t instId,
 			UAVObjEventType event);
 static InstanceHandle createInstance(struct UAVOData * obj, uint16_t instId);
 static InstanceHandle getInstance(struct UAVOData * obj, uint16_t instId);
+static uint8_t instanceChunk(const struct UAVOMulti * obj, uint16_t instId,
+			uint16_t * chunk_offset);
+static void readSingleInstance(struct UAVOSingle * obj, void * dataOut,
+			uint32_t offset, uint32_t size);
+static void lockSingleInstance(struct UAVOSingle * obj);
+static void unlockSingleInstance(struct UAVOSingle * obj);
+static void writeSingleInstance(struct UAVOSingle * obj, const void * dataIn,
+			uint32_t offset, uint32_t size);
+static void lockObjectManager(void);
+static void unlockObjectManager(void);
+static int32_t indexInsert(struct UAVOData * obj);
+static UAVObjHandle indexLookup(uint32_t id);
+static int32_t saveObject(UAVObjHandle obj_handle, uint16_t instId);
 static int32_t connectObj(UAVObjHandle obj_handle, xQueueHandle queue,
 			UAVObjEventCallback cb, uint8_t eventMask);
 static int32_t disconnectObj(UAVObjHandle obj_handle, xQueueHandle queue,
 			UAVObjEventCallback cb);
+static void freeRetiredEvents(void);
 
 // Private variables
 static struct UAVOData * uavo_list;
+static struct UAVOIndex * volatile uavo_index;
+static volatile uint32_t uavo_index_seq;
+static struct ObjectEventEntry * retired_events;
+static volatile uint32_t event_walkers;
 static xSemaphoreHandle mutex;
+static uint16_t mutex_depth;
+static uint32_t mutex_taken_raw;
 static const UAVObjMetadata defMetadata = {
 	.flags = (ACCESS_READWRITE << UAVOBJ_ACCESS_SHIFT |
 		ACCESS_READWRITE << UAVOBJ_GCS_ACCESS_SHIFT |
@@ -185,6 +256,10 @@ int32_t UAVObjInitialize()
 {
 	// Initialize variables
 	uavo_list = NULL;
+	uavo_index = NULL;
+	uavo_index_seq = 0;
+	retired_events = NULL;
+	event_walkers = 0;
 	memset(&stats, 0, sizeof(UAVObjStats));
 
 	// Create mutex
@@ -206,9 +281,9 @@ int32_t UAVObjInitialize()
  */
 void UAVObjGetStats(UAVObjStats * statsOut)
 {
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 	memcpy(statsOut, &stats, sizeof(UAVObjStats));
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 }
 
 /**
@@ -216,9 +291,9 @@ void UAVObjGetStats(UAVObjStats * statsOut)
  */
 void UAVObjClearStats()
 {
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 	memset(&stats, 0, sizeof(UAVObjStats));
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 }
 
 /************************
@@ -255,16 +330,21 @@ static struct UAVOData * UAVObjAllocSingle(uint32_t num_bytes)
 	uavo_base->next_event     = NULL;
 
 	/* Clear the instance data carried in the UAVO */
+	uavo_single->seq = 0;
+	uavo_single->write_lock = 0;
 	memset(&(uavo_single->instance0), 0, num_bytes);
 
 	/* Give back the generic UAVO part */
 	return (&(uavo_single->uavo));
 }
 
-static struct UAVOData * UAVObjAllocMulti(uint32_t num_bytes)
+static struct UAVOData * UAVObjAllocMulti(uint32_t num_bytes, uint16_t num_instances)
 {
-	/* Compute the complete size of the object, including the data for a single embedded instance */
-	uint32_t object_size = sizeof(struct UAVOMulti) + num_bytes;
+	if (num_instances == 0)
+		num_instances = 1;
+
+	/* Compute the complete size of the object, including the data for all instances in chunk 0 */
+	uint32_t object_size = sizeof(struct UAVOMulti) + num_bytes * num_instances;
 
 	/* Allocate the object from the heap */
 	struct UAVOMulti * uavo_multi = (struct UAVOMulti *) PIOS_malloc_no_dma(object_size);
@@ -279,10 +359,12 @@ static struct UAVOData * UAVObjAllocMulti(uint32_t num_bytes)
 
 	/* Set up the type-specific part of the UAVO */
 	uavo_multi->num_instances = 1;
+	uavo_multi->chunk0_instances = num_instances;
+	memset(uavo_multi->chunks, 0, sizeof(uavo_multi->chunks));
+	uavo_multi->chunks[0] = uavo_multi->chunk0;
 
 	/* Clear the instance data carried in the UAVO */
-	uavo_multi->instance0.next = NULL;
-	memset (&(uavo_multi->instance0.instance), 0, num_bytes);
+	memset(uavo_multi->chunk0, 0, num_bytes * num_instances);
 
 	/* Give back the generic UAVO part */
 	return (&(uavo_multi->uavo));
@@ -298,18 +380,19 @@ static struct UAVOData * UAVObjAllocMulti(uint32_t num_bytes)
  * \param[in] isSingleInstance Is this a single instance or multi-instance object
  * \param[in] isSettings Is this a settings object
  * \param[in] numBytes Number of bytes of object data (for one instance)
+ * \param[in] numInstances Number of instances to allocate storage for up front (multi-instance only)
  * \param[in] initCb Default field and metadata initialization function
  * \return Object handle, or NULL if failure.
  * \return
  */
 UAVObjHandle UAVObjRegister(uint32_t id, 
 			int32_t isSingleInstance, int32_t isSettings,
-			uint32_t num_bytes,
+			uint32_t num_bytes, uint16_t num_instances,
 			UAVObjInitializeCallback initCb)
 {
 	struct UAVOData * uavo_data = NULL;
 
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	/* Don't allow duplicate registrations */
 	if (UAVObjGetByID(id))
@@ -319,7 +402,7 @@ UAVObjHandle UAVObjRegister(uint32_t id,
 	if (isSingleInstance) {
 		uavo_data = UAVObjAllocSingle (num_bytes);
 	} else {
-		uavo_data = UAVObjAllocMulti (num_bytes);
+		uavo_data = UAVObjAllocMulti (num_bytes, num_instances);
 	}
 
 	if (!uavo_data)
@@ -335,9 +418,6 @@ UAVObjHandle UAVObjRegister(uint32_t id,
 	/* Initialize the embedded meta UAVO */
 	UAVObjInitMetaData (&uavo_data->metaObj);
 
-	/* Add the newly created object to the global list of objects */
-	LL_APPEND(uavo_list, uavo_data);
-
 	/* Initialize object fields and metadata to default values */
 	if (initCb)
 		initCb((UAVObjHandle) uavo_data, 0);
@@ -349,12 +429,26 @@ UAVObjHandle UAVObjRegister(uint32_t id,
 	if (uavo_data->base.flags.isSettings)
 		UAVObjLoad((UAVObjHandle) uavo_data, 0);
 
+	/*
+	 * Make the object visible to lookups by id. This is done last since
+	 * UAVObjGetByID doesn't take the lock, so telemetry must not be able
+	 * to find an object that isn't initialized and loaded yet.
+	 */
+	if (indexInsert(uavo_data) != 0) {
+		PIOS_free(uavo_data);
+		uavo_data = NULL;
+		goto unlock_exit;
+	}
+
+	/* Add the newly created object to the global list of objects */
+	LL_APPEND(uavo_list, uavo_data);
+
 	// fire events for outer object and its embedded meta object
 	UAVObjInstanceUpdated((UAVObjHandle) uavo_data, 0);
 	UAVObjInstanceUpdated((UAVObjHandle) &(uavo_data->metaObj), 0);
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return (UAVObjHandle) uavo_data;
 }
 
@@ -365,26 +459,26 @@ unlock_exit:
  */
 UAVObjHandle UAVObjGetByID(uint32_t id)
 {
-	UAVObjHandle * found_obj = (UAVObjHandle *) NULL;
+	UAVObjHandle found_obj;
 
-	// Get lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	/* Fast path, search the index without taking the lock */
+	uint32_t seq = uavo_index_seq;
+	__sync_synchronize();
 
-	// Look for object
-	struct UAVOData * tmp_obj;
-	LL_FOREACH(uavo_list, tmp_obj) {
-		if (tmp_obj->id == id) {
-			found_obj = (UAVObjHandle *)tmp_obj;
-			goto unlock_exit;
-		}
-		if (MetaObjectId(tmp_obj->id) == id) {
-			found_obj = (UAVObjHandle *)&(tmp_obj->metaObj);
-			goto unlock_exit;
-		}
+	if ((seq & 1) == 0) {
+		found_obj = indexLookup(id);
+		__sync_synchronize();
+
+		/* A hit is always valid, a miss is only valid if the index didn't change */
+		if (found_obj || seq == uavo_index_seq)
+			return found_obj;
 	}
 
-unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	/* The index is being updated, wait for the writer to finish */
+	lockObjectManager();
+	found_obj = indexLookup(id);
+	unlockObjectManager();
+
 	return found_obj;
 }
 
@@ -501,7 +595,7 @@ uint16_t UAVObjCreateInstance(UAVObjHandle obj_handle,
 	}
 
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	InstanceHandle instEntry;
 	uint16_t instId = 0;
@@ -519,7 +613,7 @@ uint16_t UAVObjCreateInstance(UAVObjHandle obj_handle,
 	}
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 
 	return instId;
 }
@@ -581,8 +675,19 @@ int32_t UAVObjUnpack(UAVObjHandle obj_handle, uint16_t instId,
 {
 	PIOS_Assert(obj_handle);
 
+	if (isSingleInstanceData(obj_handle)) {
+		struct UAVOSingle * obj = (struct UAVOSingle *) obj_handle;
+
+		if (instId != 0)
+			return -1;
+
+		writeSingleInstance(obj, dataIn, 0, obj->uavo.instance_size);
+		sendEvent((struct UAVOBase *)obj_handle, instId, EV_UNPACKED);
+		return 0;
+	}
+
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -617,7 +722,7 @@ int32_t UAVObjUnpack(UAVObjHandle obj_handle, uint16_t instId,
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
@@ -632,8 +737,18 @@ int32_t UAVObjPack(UAVObjHandle obj_handle, uint16_t instId, uint8_t * dataOut)
 {
 	PIOS_Assert(obj_handle);
 
+	if (isSingleInstanceData(obj_handle)) {
+		struct UAVOSingle * obj = (struct UAVOSingle *) obj_handle;
+
+		if (instId != 0)
+			return -1;
+
+		readSingleInstance(obj, dataOut, 0, obj->uavo.instance_size);
+		return 0;
+	}
+
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -661,19 +776,18 @@ int32_t UAVObjPack(UAVObjHandle obj_handle, uint16_t instId, uint8_t * dataOut)
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
-#if defined(PIOS_INCLUDE_FASTHEAP)
 /**
- * Trampoline buffer used for loads from the underlying filesystem.
+ * Trampoline buffer used for saves to the underlying filesystem.
  * This is required on platforms that store the UAVO data in non-DMA
  * RAM regions since the underlying flash driver may use DMA to transfer
- * the data into the buffer that we give it.
+ * the data from the buffer that we give it. Single instance data is
+ * always saved from here so that writers never wait for the flash.
  */
 static uint8_t uavobj_save_trampoline[256] __attribute__((aligned(4)));
-#endif	/* PIOS_INCLUDE_FASTHEAP */
 
 /**
  * Save the data of the specified object to the file system (SD card).
@@ -686,6 +800,28 @@ static uint8_t uavobj_save_trampoline[256] __attribute__((aligned(4)));
  * @return 0 if success or -1 if failure
  */
 int32_t UAVObjSave(UAVObjHandle obj_handle, uint16_t instId)
+{
+	uint32_t save_start_raw = PIOS_DELAY_GetRaw();
+
+	int32_t rc = saveObject(obj_handle, instId);
+
+	// Track the worst case time spent waiting on the filesystem
+	uint32_t save_us = PIOS_DELAY_DiffuS(save_start_raw);
+	lockObjectManager();
+	if (save_us > stats.saveMaxUs)
+		stats.saveMaxUs = save_us;
+	unlockObjectManager();
+
+	return rc;
+}
+
+/**
+ * Write one object instance to the settings filesystem
+ * \param[in] obj_handle The object handle
+ * \param[in] instId The instance ID
+ * \return 0 if success or -1 if failure
+ */
+static int32_t saveObject(UAVObjHandle obj_handle, uint16_t instId)
 {
 	PIOS_Assert(obj_handle);
 
@@ -713,6 +849,23 @@ int32_t UAVObjSave(UAVObjHandle obj_handle, uint16_t instId)
 					UAVObjGetNumBytes(obj_handle));
 #endif  /* PIOS_INCLUDE_FASTHEAP */
 
+		if (rc != 0)
+			return -1;
+	} else if (isSingleInstanceData(obj_handle)) {
+		struct UAVOSingle * obj = (struct UAVOSingle *) obj_handle;
+
+		if (instId != 0)
+			return -1;
+
+		// Save a snapshot of the object to the filesystem
+		readSingleInstance(obj, uavobj_save_trampoline, 0, obj->uavo.instance_size);
+
+		int32_t rc = PIOS_FLASHFS_ObjSave(pios_uavo_settings_fs_id,
+					obj->uavo.id,
+					instId,
+					uavobj_save_trampoline,
+					obj->uavo.instance_size);
+
 		if (rc != 0)
 			return -1;
 	} else {
@@ -751,15 +904,14 @@ int32_t UAVObjSave(UAVObjHandle obj_handle, uint16_t instId)
 	return 0;
 }
 
-#if defined(PIOS_INCLUDE_FASTHEAP)
 /**
  * Trampoline buffer used for loads from the underlying filesystem.
  * This is required on platforms that store the UAVO data in non-DMA
  * RAM regions since the underlying flash driver may use DMA to transfer
- * the data into the buffer that we give it.
+ * the data into the buffer that we give it. Single instance data is
+ * always loaded through here so that writers never wait for the flash.
  */
 static uint8_t uavobj_load_trampoline[256] __attribute__((aligned(4)));
-#endif	/* PIOS_INCLUDE_FASTHEAP */
 
 /**
  * Load an object from the file system (SD card).
@@ -800,6 +952,24 @@ int32_t UAVObjLoad(UAVObjHandle obj_handle, uint16_t instId)
 		memcpy(MetaDataPtr((struct UAVOMeta *)obj_handle), uavobj_load_trampoline, UAVObjGetNumBytes(obj_handle));
 #endif  /* PIOS_INCLUDE_FASTHEAP */
 
+	} else if (isSingleInstanceData(obj_handle)) {
+		struct UAVOSingle * obj = (struct UAVOSingle *) obj_handle;
+
+		if (instId != 0)
+			return -1;
+
+		// Load the object from the filesystem, lockless readers must not see a partial load
+		int32_t rc = PIOS_FLASHFS_ObjLoad(pios_uavo_settings_fs_id,
+					obj->uavo.id,
+					instId,
+					uavobj_load_trampoline,
+					obj->uavo.instance_size);
+
+		if (rc != 0)
+			return -1;
+
+		writeSingleInstance(obj, uavobj_load_trampoline, 0, obj->uavo.instance_size);
+
 	} else {
 
 		InstanceHandle instEntry = getInstance( (struct UAVOData *)obj_handle, instId);
@@ -858,7 +1028,7 @@ int32_t UAVObjSaveSettings()
 	struct UAVOData *obj;
 
 	// Get lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -877,7 +1047,7 @@ int32_t UAVObjSaveSettings()
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
@@ -890,7 +1060,7 @@ int32_t UAVObjLoadSettings()
 	struct UAVOData *obj;
 
 	// Get lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -909,7 +1079,7 @@ int32_t UAVObjLoadSettings()
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
@@ -922,7 +1092,7 @@ int32_t UAVObjDeleteSettings()
 	struct UAVOData *obj;
 
 	// Get lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -941,7 +1111,7 @@ int32_t UAVObjDeleteSettings()
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
@@ -954,7 +1124,7 @@ int32_t UAVObjSaveMetaobjects()
 	struct UAVOData *obj;
 
 	// Get lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -970,7 +1140,7 @@ int32_t UAVObjSaveMetaobjects()
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
@@ -983,7 +1153,7 @@ int32_t UAVObjLoadMetaobjects()
 	struct UAVOData *obj;
 
 	// Get lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -999,7 +1169,7 @@ int32_t UAVObjLoadMetaobjects()
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
@@ -1012,7 +1182,7 @@ int32_t UAVObjDeleteMetaobjects()
 	struct UAVOData *obj;
 
 	// Get lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -1028,7 +1198,7 @@ int32_t UAVObjDeleteMetaobjects()
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
@@ -1088,8 +1258,19 @@ int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
 {
 	PIOS_Assert(obj_handle);
 
+	if (isSingleInstanceData(obj_handle)) {
+		struct UAVOSingle * obj = (struct UAVOSingle *) obj_handle;
+
+		if (instId != 0 || UAVObjReadOnly(obj_handle))
+			return -1;
+
+		writeSingleInstance(obj, dataIn, 0, obj->uavo.instance_size);
+		sendEvent((struct UAVOBase *)obj_handle, instId, EV_UPDATED);
+		return 0;
+	}
+
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -1123,7 +1304,7 @@ int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
@@ -1138,8 +1319,22 @@ int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, con
 {
 	PIOS_Assert(obj_handle);
 
+	if (isSingleInstanceData(obj_handle)) {
+		struct UAVOSingle * obj = (struct UAVOSingle *) obj_handle;
+
+		if (instId != 0 || UAVObjReadOnly(obj_handle))
+			return -1;
+
+		if ((size + offset) > obj->uavo.instance_size)
+			return -1;
+
+		writeSingleInstance(obj, dataIn, offset, size);
+		sendEvent((struct UAVOBase *)obj_handle, instId, EV_UPDATED);
+		return 0;
+	}
+
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -1189,7 +1384,7 @@ int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, con
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
@@ -1205,8 +1400,18 @@ int32_t UAVObjGetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
 {
 	PIOS_Assert(obj_handle);
 
+	if (isSingleInstanceData(obj_handle)) {
+		struct UAVOSingle * obj = (struct UAVOSingle *) obj_handle;
+
+		if (instId != 0)
+			return -1;
+
+		readSingleInstance(obj, dataOut, 0, obj->uavo.instance_size);
+		return 0;
+	}
+
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -1236,7 +1441,7 @@ int32_t UAVObjGetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
@@ -1251,8 +1456,21 @@ int32_t UAVObjGetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, voi
 {
 	PIOS_Assert(obj_handle);
 
+	if (isSingleInstanceData(obj_handle)) {
+		struct UAVOSingle * obj = (struct UAVOSingle *) obj_handle;
+
+		if (instId != 0)
+			return -1;
+
+		if ((size + offset) > obj->uavo.instance_size)
+			return -1;
+
+		readSingleInstance(obj, dataOut, offset, size);
+		return 0;
+	}
+
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	int32_t rc = -1;
 
@@ -1294,7 +1512,7 @@ int32_t UAVObjGetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, voi
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return rc;
 }
 
@@ -1313,11 +1531,11 @@ int32_t UAVObjSetMetadata(UAVObjHandle obj_handle, const UAVObjMetadata * dataIn
 		return -1;
 	}
 
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	UAVObjSetData((UAVObjHandle) MetaObjectPtr((struct UAVOData *)obj_handle), dataIn);
 
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return 0;
 }
 
@@ -1332,7 +1550,7 @@ int32_t UAVObjGetMetadata(UAVObjHandle obj_handle, UAVObjMetadata * dataOut)
 	PIOS_Assert(obj_handle);
 
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	// Get metadata
 	if (UAVObjIsMetaobject(obj_handle)) {
@@ -1343,7 +1561,7 @@ int32_t UAVObjGetMetadata(UAVObjHandle obj_handle, UAVObjMetadata * dataOut)
 	}
 
 	// Unlock
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return 0;
 }
 
@@ -1506,9 +1724,9 @@ int32_t UAVObjConnectQueue(UAVObjHandle obj_handle, xQueueHandle queue,
 	PIOS_Assert(obj_handle);
 	PIOS_Assert(queue);
 	int32_t res;
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 	res = connectObj(obj_handle, queue, 0, eventMask);
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return res;
 }
 
@@ -1523,9 +1741,9 @@ int32_t UAVObjDisconnectQueue(UAVObjHandle obj_handle, xQueueHandle queue)
 	PIOS_Assert(obj_handle);
 	PIOS_Assert(queue);
 	int32_t res;
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 	res = disconnectObj(obj_handle, queue, 0);
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return res;
 }
 
@@ -1542,9 +1760,9 @@ int32_t UAVObjConnectCallback(UAVObjHandle obj_handle, UAVObjEventCallback cb,
 {
 	PIOS_Assert(obj_handle);
 	int32_t res;
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 	res = connectObj(obj_handle, 0, cb, eventMask);
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return res;
 }
 
@@ -1558,9 +1776,9 @@ int32_t UAVObjDisconnectCallback(UAVObjHandle obj_handle, UAVObjEventCallback cb
 {
 	PIOS_Assert(obj_handle);
 	int32_t res;
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 	res = disconnectObj(obj_handle, 0, cb);
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 	return res;
 }
 
@@ -1583,9 +1801,9 @@ void UAVObjRequestUpdate(UAVObjHandle obj_handle)
 void UAVObjRequestInstanceUpdate(UAVObjHandle obj_handle, uint16_t instId)
 {
 	PIOS_Assert(obj_handle);
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 	sendEvent((struct UAVOBase *) obj_handle, instId, EV_UPDATE_REQ);
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 }
 
 /**
@@ -1605,9 +1823,9 @@ void UAVObjUpdated(UAVObjHandle obj_handle)
 void UAVObjInstanceUpdated(UAVObjHandle obj_handle, uint16_t instId)
 {
 	PIOS_Assert(obj_handle);
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 	sendEvent((struct UAVOBase *) obj_handle, instId, EV_UPDATED_MANUAL);
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 }
 
 /**
@@ -1620,7 +1838,7 @@ void UAVObjIterate(void (*iterator) (UAVObjHandle obj))
 	PIOS_Assert(iterator);
 
 	// Get lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	lockObjectManager();
 
 	// Iterate through the list and invoke iterator for each object
 	struct UAVOData *obj;
@@ -1630,11 +1848,12 @@ void UAVObjIterate(void (*iterator) (UAVObjHandle obj))
 	}
 
 	// Release lock
-	xSemaphoreGiveRecursive(mutex);
+	unlockObjectManager();
 }
 
 /**
  * Send a triggered event to all event queues registered on the object.
+ * This may be called without the lock held.
  */
 static int32_t sendEvent(struct UAVOBase * obj, uint16_t instId,
 			UAVObjEventType triggered_event)
@@ -1646,6 +1865,12 @@ static int32_t sendEvent(struct UAVOBase * obj, uint16_t instId,
 		.instId = instId,
 	};
 
+	/*
+	 * The list is walked without the lock. Entries disconnected meanwhile
+	 * are only freed once no sendEvent is walking any list.
+	 */
+	__sync_fetch_and_add(&event_walkers, 1);
+
 	// Go through each object and push the event message in the queue (if event is activated for the queue)
 	struct ObjectEventEntry *event;
 	LL_FOREACH(obj->next_event, event) {
@@ -1671,6 +1896,8 @@ static int32_t sendEvent(struct UAVOBase * obj, uint16_t instId,
 		}
 	}
 
+	__sync_fetch_and_sub(&event_walkers, 1);
+
 	return 0;
 }
 
@@ -1679,8 +1906,6 @@ static int32_t sendEvent(struct UAVOBase * obj, uint16_t instId,
  */
 static InstanceHandle createInstance(struct UAVOData * obj, uint16_t instId)
 {
-	struct UAVOMultiInst *instEntry;
-
 	/* Don't allow more than one instance for single instance objects */
 	if (UAVObjIsSingleInstance(&(obj->base))) {
 		PIOS_Assert(0);
@@ -1697,27 +1922,32 @@ static InstanceHandle createInstance(struct UAVOData * obj, uint16_t instId)
 		return NULL;
 	}
 
+	/* Augment our pointer to reflect the proper type */
+	struct UAVOMulti * uavo_multi = (struct UAVOMulti *) obj;
+
 	// Create any missing instances (all instance IDs must be sequential)
-	for (uint16_t n = UAVObjGetNumInstances(&(obj->base)); n < instId; ++n) {
-		if (createInstance(obj, n) == NULL) {
-			return NULL;
+	for (uint16_t n = uavo_multi->num_instances; n <= instId; ++n) {
+		uint16_t chunk_offset;
+		uint8_t chunk = instanceChunk(uavo_multi, n, &chunk_offset);
+
+		/* Allocate the chunk when creating its first instance */
+		if (uavo_multi->chunks[chunk] == NULL) {
+			uint32_t chunk_instances = (uint32_t)uavo_multi->chunk0_instances << (chunk - 1);
+			uint8_t * chunk_data = (uint8_t *) PIOS_malloc_no_dma(chunk_instances * obj->instance_size);
+			if (chunk_data == NULL)
+				return NULL;
+			uavo_multi->chunks[chunk] = chunk_data;
 		}
-	}
 
-	/* Create the actual instance */
-	instEntry = (struct UAVOMultiInst *) PIOS_malloc_no_dma(sizeof(struct UAVOMultiInst)+obj->instance_size);
-	if (!instEntry)
-		return NULL;
-	memset(InstanceDataOffset(instEntry), 0, obj->instance_size);
-	LL_APPEND(( (struct UAVOMulti*)obj )->instance0.next, instEntry);
-
-	( (struct UAVOMulti*)obj )->num_instances++;
+		memset(uavo_multi->chunks[chunk] + chunk_offset * obj->instance_size, 0, obj->instance_size);
+		uavo_multi->num_instances++;
 
-	// Fire event
-	UAVObjInstanceUpdated((UAVObjHandle) obj, instId);
+		// Fire event
+		UAVObjInstanceUpdated((UAVObjHandle) obj, n);
+	}
 
 	// Done
-	return InstanceDataOffset(instEntry);
+	return getInstance(obj, instId);
 }
 
 /**
@@ -1751,18 +1981,238 @@ static InstanceHandle getInstance(struct UAVOData * obj, uint16_t instId)
 		if (instId >= uavo_multi->num_instances)
 			return NULL;
 
-		// Look for specified instance ID
-		uint16_t instance = 0;
-		struct UAVOMultiInst *instEntry;
-		LL_FOREACH(&(uavo_multi->instance0), instEntry) {
-			if (instance++ == instId) {
-				/* Found it */
-				return &(instEntry->instance);
-			}
+		uint16_t chunk_offset;
+		uint8_t chunk = instanceChunk(uavo_multi, instId, &chunk_offset);
+
+		return uavo_multi->chunks[chunk] + chunk_offset * obj->instance_size;
+	}
+}
+
+/**
+ * Find the chunk holding an instance of a multi instance object
+ * \param[in] obj The object
+ * \param[in] instId The instance ID
+ * \param[out] chunk_offset The index of the instance within the chunk
+ * \return The chunk index
+ */
+static uint8_t instanceChunk(const struct UAVOMulti * obj, uint16_t instId,
+			uint16_t * chunk_offset)
+{
+	if (instId < obj->chunk0_instances) {
+		*chunk_offset = instId;
+		return 0;
+	}
+
+	/* Chunk n > 0 starts at instance (chunk0_instances << (n - 1)) */
+	uint32_t ratio = instId / obj->chunk0_instances;
+	uint8_t chunk = 32 - __builtin_clz(ratio);
+
+	*chunk_offset = instId - ((uint32_t)obj->chunk0_instances << (chunk - 1));
+	return chunk;
+}
+
+/**
+ * Copy data out of a single instance object without taking the lock.
+ * The copy is retried if a writer modified the object while it was
+ * being read.
+ */
+static void readSingleInstance(struct UAVOSingle * obj, void * dataOut,
+			uint32_t offset, uint32_t size)
+{
+	for (uint8_t attempt = 0; attempt < UAVOBJ_SEQ_READ_ATTEMPTS; attempt++) {
+		uint16_t seq = obj->seq;
+		__sync_synchronize();
+
+		if ((seq & 1) == 0) {
+			memcpy(dataOut, obj->instance0 + offset, size);
+			__sync_synchronize();
+
+			if (seq == obj->seq)
+				return;
 		}
-		/* Instance was not found */
-		return NULL;
+
+		__sync_fetch_and_add(&stats.seqReadRetries, 1);
 	}
+
+	/*
+	 * Only seen on a host where the writer runs in parallel on another
+	 * core, copy while holding the writer section.
+	 */
+	lockSingleInstance(obj);
+	memcpy(dataOut, obj->instance0 + offset, size);
+	unlockSingleInstance(obj);
+}
+
+/**
+ * Enter the writer section of a single instance object. It only covers
+ * a memcpy of the object data, so it runs with interrupts disabled and
+ * never waits for the object manager lock or the flash.
+ */
+static void lockSingleInstance(struct UAVOSingle * obj)
+{
+	PIOS_IRQ_Disable();
+
+	while (__sync_lock_test_and_set(&obj->write_lock, 1))
+		;
+}
+
+/**
+ * Leave the writer section of a single instance object
+ */
+static void unlockSingleInstance(struct UAVOSingle * obj)
+{
+	__sync_lock_release(&obj->write_lock);
+
+	PIOS_IRQ_Enable();
+}
+
+/**
+ * Copy data into a single instance object. The sequence counter is odd
+ * while the copy is in progress to let lockless readers detect it.
+ */
+static void writeSingleInstance(struct UAVOSingle * obj, const void * dataIn,
+			uint32_t offset, uint32_t size)
+{
+	lockSingleInstance(obj);
+
+	obj->seq++;
+	__sync_synchronize();
+
+	memcpy(obj->instance0 + offset, dataIn, size);
+
+	__sync_synchronize();
+	obj->seq++;
+
+	unlockSingleInstance(obj);
+}
+
+/**
+ * Take the object manager lock, counting how often it was contended
+ */
+static void lockObjectManager(void)
+{
+	if (xSemaphoreTakeRecursive(mutex, 0) != pdTRUE) {
+		xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+		++stats.lockContentions;
+	}
+
+	if (mutex_depth++ == 0)
+		mutex_taken_raw = PIOS_DELAY_GetRaw();
+}
+
+/**
+ * Release the object manager lock, tracking the longest time it was held
+ */
+static void unlockObjectManager(void)
+{
+	if (--mutex_depth == 0) {
+		uint32_t held_us = PIOS_DELAY_DiffuS(mutex_taken_raw);
+		if (held_us > stats.lockMaxHoldUs)
+			stats.lockMaxHoldUs = held_us;
+	}
+
+	xSemaphoreGiveRecursive(mutex);
+}
+
+/**
+ * Add an object to the sorted object index, growing the index if needed.
+ * Must be called with the mutex held.
+ * \return 0 if success or -1 if failure
+ */
+static int32_t indexInsert(struct UAVOData * obj)
+{
+	struct UAVOIndex * index = uavo_index;
+
+	if (index == NULL || index->num_entries == index->max_entries) {
+		uint16_t max_entries = index ? index->max_entries * 2 : UAVOBJ_INDEX_INITIAL_SIZE;
+
+		struct UAVOIndex * new_index = (struct UAVOIndex *) PIOS_malloc_no_dma(sizeof(struct UAVOIndex) +
+				max_entries * sizeof(new_index->entries[0]));
+		if (new_index == NULL)
+			return -1;
+
+		new_index->max_entries = max_entries;
+		new_index->num_entries = 0;
+		if (index) {
+			memcpy(new_index->entries, index->entries, index->num_entries * sizeof(index->entries[0]));
+			new_index->num_entries = index->num_entries;
+		}
+
+		/* Publish the new index only once it is complete */
+		__sync_synchronize();
+		uavo_index = new_index;
+
+		/*
+		 * The old index is never freed since a lockless reader may still be
+		 * searching it. Growth is geometric so this wastes less memory than
+		 * the final index size.
+		 */
+		index = new_index;
+	}
+
+	/* Mark the index as being modified */
+	uavo_index_seq++;
+	__sync_synchronize();
+
+	/* Shift larger ids up by one to open a slot for the new object */
+	uint16_t pos = index->num_entries;
+	while (pos > 0 && index->entries[pos - 1]->id > obj->id) {
+		index->entries[pos] = index->entries[pos - 1];
+		pos--;
+	}
+	index->entries[pos] = obj;
+	index->num_entries++;
+
+	__sync_synchronize();
+	uavo_index_seq++;
+
+	return 0;
+}
+
+/**
+ * Binary search of the object index for a data object
+ */
+static struct UAVOData * indexSearch(const struct UAVOIndex * index, uint32_t id)
+{
+	uint16_t lo = 0;
+	uint16_t hi = index->num_entries;
+
+	while (lo < hi) {
+		uint16_t mid = lo + (hi - lo) / 2;
+		struct UAVOData * obj = index->entries[mid];
+
+		if (obj->id == id)
+			return obj;
+
+		if (obj->id < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return NULL;
+}
+
+/**
+ * Find a data or metaobject in the object index
+ * \return The object or NULL if not found.
+ */
+static UAVObjHandle indexLookup(uint32_t id)
+{
+	const struct UAVOIndex * index = uavo_index;
+	if (index == NULL)
+		return NULL;
+
+	struct UAVOData * obj = indexSearch(index, id);
+	if (obj)
+		return (UAVObjHandle) obj;
+
+	/* Not a data object, check if it is the metaobject of one */
+	obj = indexSearch(index, id - 1);
+	if (obj)
+		return (UAVObjHandle) &(obj->metaObj);
+
+	return NULL;
 }
 
 /**
@@ -1789,6 +2239,8 @@ static int32_t connectObj(UAVObjHandle obj_handle, xQueueHandle queue,
 		}
 	}
 
+	freeRetiredEvents();
+
 	// Add queue to list
 	event =	(struct ObjectEventEntry *) PIOS_malloc_no_dma(sizeof(struct ObjectEventEntry));
 	if (event == NULL) {
@@ -1797,6 +2249,9 @@ static int32_t connectObj(UAVObjHandle obj_handle, xQueueHandle queue,
 	event->queue = queue;
 	event->cb = cb;
 	event->eventMask = eventMask;
+
+	/* sendEvent walks this list without the lock, only link in complete entries */
+	__sync_synchronize();
 	LL_APPEND(obj->next_event, event);
 
 	// Done
@@ -1821,8 +2276,15 @@ static int32_t disconnectObj(UAVObjHandle obj_handle, xQueueHandle queue,
 	LL_FOREACH(obj->next_event, event) {
 		if ((event->queue == queue
 				&& event->cb == cb)) {
+			/*
+			 * sendEvent may be walking the list without the lock. Unlinking
+			 * leaves event->next intact, so retire the entry and free it
+			 * once nobody can be looking at it.
+			 */
 			LL_DELETE(obj->next_event, event);
-			vPortFree(event);
+			event->next_retired = retired_events;
+			retired_events = event;
+			freeRetiredEvents();
 			return 0;
 		}
 	}
@@ -1831,6 +2293,24 @@ static int32_t disconnectObj(UAVObjHandle obj_handle, xQueueHandle queue,
 	return -1;
 }
 
+/**
+ * Free the disconnected event entries if no sendEvent is walking a list.
+ * Must be called with the mutex held.
+ */
+static void freeRetiredEvents(void)
+{
+	/* Pairs with the barrier implied by the increment in sendEvent */
+	__sync_synchronize();
+	if (event_walkers != 0)
+		return;
+
+	while (retired_events) {
+		struct ObjectEventEntry * event = retired_events;
+		retired_events = event->next_retired;
+		vPortFree(event);
+	}
+}
+
 
 /**
  * getEventMask Iterates through the connections and returns the event mask
@@ -33,6 +33,9 @@
 
 // Public types
 typedef int32_t (*UAVTalkOutputStream)(uint8_t* data, int32_t length);
+typedef uint8_t *(*UAVTalkReserveStream)(uint16_t length);
+typedef int32_t (*UAVTalkCommitStream)(uint16_t length, bool flush);
+typedef void (*UAVTalkTransactionCallback)(UAVObjHandle obj, uint16_t instId, bool success, uint8_t retries);
 
 //! Tracking statistics for a UAVTalk connection
 typedef struct {
@@ -54,14 +57,22 @@ typedef enum {UAVTALK_STATE_ERROR=0, UAVTALK_STATE_SYNC, UAVTALK_STATE_TYPE, UAV
 UAVTalkConnection UAVTalkInitialize(UAVTalkOutputStream outputStream);
 int32_t UAVTalkSetOutputStream(UAVTalkConnection connection, UAVTalkOutputStream outputStream);
 UAVTalkOutputStream UAVTalkGetOutputStream(UAVTalkConnection connection);
+int32_t UAVTalkSetZeroCopyStream(UAVTalkConnection connection, UAVTalkReserveStream reserveStream, UAVTalkCommitStream commitStream);
+void UAVTalkBeginBatch(UAVTalkConnection connection);
+int32_t UAVTalkEndBatch(UAVTalkConnection connection);
+int32_t UAVTalkSetDeltaCompression(UAVTalkConnection connection, bool enable);
 int32_t UAVTalkSendObject(UAVTalkConnection connection, UAVObjHandle obj, uint16_t instId, uint8_t acked, int32_t timeoutMs);
 int32_t UAVTalkSendObjectTimestamped(UAVTalkConnection connectionHandle, UAVObjHandle obj, uint16_t instId, uint8_t acked, int32_t timeoutMs);
 int32_t UAVTalkSendObjectRequest(UAVTalkConnection connection, UAVObjHandle obj, uint16_t instId, int32_t timeoutMs);
+int32_t UAVTalkSendObjectPipelined(UAVTalkConnection connection, UAVObjHandle obj, uint16_t instId, uint8_t retries, int32_t timeoutMs, UAVTalkTransactionCallback cb);
+int32_t UAVTalkSendObjectRequestPipelined(UAVTalkConnection connection, UAVObjHandle obj, uint16_t instId, uint8_t retries, int32_t timeoutMs, UAVTalkTransactionCallback cb);
+uint32_t UAVTalkProcessTransactions(UAVTalkConnection connection);
 int32_t UAVTalkSendAck(UAVTalkConnection connectionHandle, UAVObjHandle obj, uint16_t instId);
 int32_t UAVTalkSendNack(UAVTalkConnection connectionHandle, uint32_t objId);
 int32_t UAVTalkSendBuf(UAVTalkConnection connectionHandle, uint8_t *buf, uint16_t len);
 UAVTalkRxState UAVTalkProcessInputStream(UAVTalkConnection connection, uint8_t rxbyte);
 UAVTalkRxState UAVTalkProcessInputStreamQuiet(UAVTalkConnection connection, uint8_t rxbyte);
+UAVTalkRxState UAVTalkProcessInputBuffer(UAVTalkConnection connection, const uint8_t *buf, uint16_t len);
 UAVTalkRxState UAVTalkRelayInputStream(UAVTalkConnection connectionHandle, uint8_t rxbyte);
 void UAVTalkGetStats(UAVTalkConnection connection, UAVTalkStats *stats);
 void UAVTalkResetStats(UAVTalkConnection connection);
@@ -61,6 +61,25 @@ typedef uint8_t uavtalk_checksum;
 #define UAVTALK_MIN_PACKET_LENGTH       UAVTALK_MAX_HEADER_LENGTH + UAVTALK_CHECKSUM_LENGTH
 #define UAVTALK_MAX_PACKET_LENGTH       UAVTALK_MIN_PACKET_LENGTH + UAVTALK_MAX_PAYLOAD_LENGTH
 
+//! Number of ACK/REQ transactions that can be outstanding at once
+#if !defined(UAVTALK_MAX_TRANSACTIONS)
+#define UAVTALK_MAX_TRANSACTIONS        4
+#endif
+
+//! How often a sender waiting for a free transaction checks for timeouts
+#define UAVTALK_TRANS_POLL_MS           10
+
+//! Number of objects for which a copy of the last sent data is kept for delta frames
+#if !defined(UAVTALK_DELTA_SLOTS)
+#define UAVTALK_DELTA_SLOTS             4
+#endif
+
+//! Smallest object worth sending as a delta frame
+#define UAVTALK_DELTA_MIN_LENGTH        32
+
+//! Maximum number of delta frames in a row before the full object is sent again
+#define UAVTALK_DELTA_FULL_INTERVAL     16
+
 //! State information for the UAVTalk parser
 typedef struct {
     UAVObjHandle obj;
@@ -78,20 +97,56 @@ typedef struct {
     uint16_t rxPacketLength;
 } UAVTalkInputProcessor;
 
+//! An outstanding transaction waiting for an ACK or the requested object
+typedef struct {
+    UAVObjHandle obj;
+    uint16_t instId;
+    uint8_t type;
+    uint8_t retriesLeft;
+    uint8_t retries;
+    bool waiting;
+    bool done;
+    bool success;
+    portTickType timeout;
+    portTickType deadline;
+    xSemaphoreHandle sema;
+    UAVTalkTransactionCallback cb;
+} UAVTalkTransaction;
+
+//! The last data sent for an object, the base the next delta frame is encoded against
+typedef struct {
+    UAVObjHandle obj;
+    uint16_t instId;
+    bool valid;
+    uint8_t deltasSinceFull;
+    portTickType lastUsed;
+    uint8_t *base;
+} UAVTalkDeltaSlot;
+
 //! Information for the physical link
 typedef struct {
     uint8_t canari;
     UAVTalkOutputStream outStream;
     xSemaphoreHandle lock;
-    xSemaphoreHandle transLock;
-    xSemaphoreHandle respSema;
-    UAVObjHandle respObj;
-    uint16_t respInstId;
+    xSemaphoreHandle transFreed;
+    UAVTalkTransaction trans[UAVTALK_MAX_TRANSACTIONS];
+    volatile bool transDone;
     UAVTalkStats stats;
     UAVTalkInputProcessor iproc;
     uint8_t *rxBuffer;
     uint32_t txSize;
     uint8_t *txBuffer;
+    uint16_t txPending;
+    uint8_t txBatch;
+    xTaskHandle txBatchOwner;
+    uint8_t txHold;
+    bool txKickPending;
+    UAVTalkReserveStream reserveStream;
+    UAVTalkCommitStream commitStream;
+    bool deltaEnabled;
+    UAVTalkDeltaSlot *deltaSlots;
+    uint8_t *deltaBuffer;
+    uint8_t *deltaRxBuffer;
 } UAVTalkConnectionData;
 
 #define UAVTALK_CANARI         0xCA
@@ -106,6 +161,7 @@ typedef struct {
 #define UAVTALK_TYPE_OBJ_ACK   (UAVTALK_TYPE_VER | 0x02)
 #define UAVTALK_TYPE_ACK       (UAVTALK_TYPE_VER | 0x03)
 #define UAVTALK_TYPE_NACK      (UAVTALK_TYPE_VER | 0x04)
+#define UAVTALK_TYPE_OBJ_DELTA (UAVTALK_TYPE_VER | 0x05)
 #define UAVTALK_TYPE_OBJ_TS       (UAVTALK_TIMESTAMPED | UAVTALK_TYPE_OBJ)
 #define UAVTALK_TYPE_OBJ_ACK_TS   (UAVTALK_TIMESTAMPED | UAVTALK_TYPE_OBJ_ACK)
 
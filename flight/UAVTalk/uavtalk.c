@@ -42,7 +42,21 @@ static int32_t sendObject(UAVTalkConnectionData *connection, UAVObjHandle obj, u
 static int32_t sendSingleObject(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId, uint8_t type);
 static int32_t sendNack(UAVTalkConnectionData *connection, uint32_t objId);
 static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId, uint8_t* data, int32_t length);
-static void updateAck(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId);
+static UAVTalkRxState processInputByte(UAVTalkConnectionData *connection, uint8_t rxbyte);
+static uint8_t *txReserve(UAVTalkConnectionData *connection, uint16_t length);
+static int32_t txCommit(UAVTalkConnectionData *connection, uint8_t *buf, uint16_t length);
+static int32_t txFlush(UAVTalkConnectionData *connection);
+static bool txDeferred(UAVTalkConnectionData *connection);
+static void updateAck(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId, bool request);
+static void updateNack(UAVTalkConnectionData *connection, uint32_t objId);
+static UAVTalkTransaction *startTransaction(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId, uint8_t type, uint8_t retries, int32_t timeoutMs, UAVTalkTransactionCallback cb, bool waiting);
+static void completeTransaction(UAVTalkConnectionData *connection, UAVTalkTransaction *trans, bool success);
+static void finishTransactions(UAVTalkConnectionData *connection);
+static portTickType processTransactions(UAVTalkConnectionData *connection);
+static UAVTalkDeltaSlot *deltaSlot(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId, bool bind);
+static void deltaForget(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId);
+static int32_t deltaEncode(const uint8_t *base, const uint8_t *data, uint16_t length, uint8_t *out);
+static int32_t deltaDecode(uint8_t *base, uint16_t length, const uint8_t *delta, uint16_t deltaLength);
 
 /**
  * Initialize the UAVTalk library
@@ -60,15 +74,31 @@ UAVTalkConnection UAVTalkInitialize(UAVTalkOutputStream outputStream)
 	connection->iproc.rxPacketLength = 0;
 	connection->iproc.state = UAVTALK_STATE_SYNC;
 	connection->outStream = outputStream;
+	connection->reserveStream = NULL;
+	connection->commitStream = NULL;
+	connection->txPending = 0;
+	connection->txBatch = 0;
+	connection->txBatchOwner = NULL;
+	connection->txHold = 0;
+	connection->txKickPending = false;
+	connection->transDone = false;
+	connection->deltaEnabled = false;
+	connection->deltaSlots = NULL;
+	connection->deltaBuffer = NULL;
+	connection->deltaRxBuffer = NULL;
 	connection->lock = xSemaphoreCreateRecursiveMutex();
-	connection->transLock = xSemaphoreCreateRecursiveMutex();
+	vSemaphoreCreateBinary(connection->transFreed);
+	xSemaphoreTake(connection->transFreed, 0); // reset to zero
+	for (uint8_t i = 0; i < UAVTALK_MAX_TRANSACTIONS; i++) {
+		connection->trans[i].obj = 0;
+		vSemaphoreCreateBinary(connection->trans[i].sema);
+		xSemaphoreTake(connection->trans[i].sema, 0); // reset to zero
+	}
 	// allocate buffers
 	connection->rxBuffer = pvPortMalloc(UAVTALK_MAX_PACKET_LENGTH);
 	if (!connection->rxBuffer) return 0;
 	connection->txBuffer = pvPortMalloc(UAVTALK_MAX_PACKET_LENGTH);
 	if (!connection->txBuffer) return 0;
-	vSemaphoreCreateBinary(connection->respSema);
-	xSemaphoreTake(connection->respSema, 0); // reset to zero
 	UAVTalkResetStats( (UAVTalkConnection) connection );
 	return (UAVTalkConnection) connection;
 }
@@ -89,6 +119,9 @@ int32_t UAVTalkSetOutputStream(UAVTalkConnection connectionHandle, UAVTalkOutput
 	// Lock
 	xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
 	
+	// Anything coalesced so far belongs to the old stream
+	txFlush(connection);
+
 	// set output stream
 	connection->outStream = outputStream;
 	
@@ -111,6 +144,135 @@ UAVTalkOutputStream UAVTalkGetOutputStream(UAVTalkConnection connectionHandle)
 	return connection->outStream;
 }
 
+/**
+ * Let packets be built directly in the output stream's buffer instead of
+ * being built in the connection and copied out.  The reserve function returns
+ * space for a whole packet or NULL, in which case the packet goes through the
+ * normal output stream.  The commit function adds the packet to the stream and
+ * starts transmission when flush is set.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] reserveStream Function that reserves space in the output stream
+ * \param[in] commitStream Function that commits the reserved space
+ * \return 0 Success
+ * \return -1 Failure
+ */
+int32_t UAVTalkSetZeroCopyStream(UAVTalkConnection connectionHandle, UAVTalkReserveStream reserveStream, UAVTalkCommitStream commitStream)
+{
+	UAVTalkConnectionData *connection;
+	CHECKCONHANDLE(connectionHandle,connection,return -1);
+
+	xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+
+	txFlush(connection);
+	connection->reserveStream = reserveStream;
+	connection->commitStream = commitStream;
+
+	xSemaphoreGiveRecursive(connection->lock);
+
+	return 0;
+}
+
+/**
+ * Start coalescing sent packets.  Until the matching UAVTalkEndBatch()
+ * packets are collected and handed to the output stream together rather than
+ * one call per object.  Transactions that wait for a response and replies to
+ * received packets still flush immediately.  The batch belongs to the calling
+ * task: while it is open other tasks keep sending straight away, taking the
+ * packets collected so far with them, and their own batches are ignored.
+ * \param[in] connection UAVTalkConnection to be used
+ */
+void UAVTalkBeginBatch(UAVTalkConnection connectionHandle)
+{
+	UAVTalkConnectionData *connection;
+	CHECKCONHANDLE(connectionHandle,connection,return);
+
+	xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+	xTaskHandle self = xTaskGetCurrentTaskHandle();
+	if (connection->txBatch == 0)
+		connection->txBatchOwner = self;
+	if (connection->txBatchOwner == self)
+		++connection->txBatch;
+	xSemaphoreGiveRecursive(connection->lock);
+}
+
+/**
+ * Stop coalescing and send everything collected since UAVTalkBeginBatch()
+ * \param[in] connection UAVTalkConnection to be used
+ * \return 0 Success
+ * \return -1 Failure
+ */
+int32_t UAVTalkEndBatch(UAVTalkConnection connectionHandle)
+{
+	UAVTalkConnectionData *connection;
+	CHECKCONHANDLE(connectionHandle,connection,return -1);
+
+	int32_t ret = 0;
+
+	xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+	if (connection->txBatch > 0 && connection->txBatchOwner == xTaskGetCurrentTaskHandle() &&
+			--connection->txBatch == 0) {
+		connection->txBatchOwner = NULL;
+		ret = txFlush(connection);
+	}
+	xSemaphoreGiveRecursive(connection->lock);
+
+	return ret;
+}
+
+/**
+ * Enable or disable sending large objects as delta frames.  A delta frame
+ * only carries the bytes that changed since the object was last sent, so
+ * it must only be enabled once the other end has announced it can decode
+ * them.  The copies of the last sent data are dropped whenever the setting
+ * changes, so the first update of every object afterwards is sent in full.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] enable True to send delta frames
+ * \return 0 Success
+ * \return -1 Failure
+ */
+int32_t UAVTalkSetDeltaCompression(UAVTalkConnection connectionHandle, bool enable)
+{
+	UAVTalkConnectionData *connection;
+	CHECKCONHANDLE(connectionHandle,connection,return -1);
+
+	int32_t ret = 0;
+
+	xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+
+	if (enable == connection->deltaEnabled)
+		goto out;
+
+	// Buffers are only allocated for links that actually use delta frames
+	if (enable && connection->deltaSlots == NULL) {
+		// The slots, one copy per slot and the buffer the delta frame is built in
+		UAVTalkDeltaSlot *slots = pvPortMalloc(UAVTALK_DELTA_SLOTS * sizeof(UAVTalkDeltaSlot) +
+				(UAVTALK_DELTA_SLOTS + 1) * UAVTALK_MAX_PAYLOAD_LENGTH);
+		if (!slots) {
+			ret = -1;
+			goto out;
+		}
+		uint8_t *buffers = (uint8_t *) &slots[UAVTALK_DELTA_SLOTS];
+		for (uint8_t i = 0; i < UAVTALK_DELTA_SLOTS; i++) {
+			slots[i].obj = 0;
+			slots[i].base = &buffers[i * UAVTALK_MAX_PAYLOAD_LENGTH];
+		}
+		connection->deltaSlots = slots;
+		connection->deltaBuffer = &buffers[UAVTALK_DELTA_SLOTS * UAVTALK_MAX_PAYLOAD_LENGTH];
+	}
+
+	if (connection->deltaSlots != NULL) {
+		for (uint8_t i = 0; i < UAVTALK_DELTA_SLOTS; i++)
+			connection->deltaSlots[i].valid = false;
+	}
+
+	connection->deltaEnabled = enable;
+
+out:
+	xSemaphoreGiveRecursive(connection->lock);
+
+	return ret;
+}
+
 /**
  * Get communication statistics counters
  * \param[in] connection UAVTalkConnection to be used
@@ -230,6 +392,77 @@ int32_t UAVTalkSendObjectTimestamped(UAVTalkConnection connectionHandle, UAVObjH
 	}
 }
 
+/**
+ * Send the specified object and track the ACK without waiting for it.  Up to
+ * UAVTALK_MAX_TRANSACTIONS transactions can be outstanding; this only blocks
+ * while all of them are in use.  Lost packets are resent individually by
+ * UAVTalkProcessTransactions().
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] obj Object to send
+ * \param[in] instId The instance ID or UAVOBJ_ALL_INSTANCES for all instances.
+ * \param[in] retries Number of times to resend the object if the ACK times out
+ * \param[in] timeoutMs Time to wait for each ACK
+ * \param[in] cb Called when the ACK is received or the last retry times out,
+ *               may be NULL.  It runs without the connection lock in whichever
+ *               task noticed, so it may run in several tasks at once.
+ * \return 0 Transaction started
+ * \return -1 Failure
+ */
+int32_t UAVTalkSendObjectPipelined(UAVTalkConnection connectionHandle, UAVObjHandle obj, uint16_t instId, uint8_t retries, int32_t timeoutMs, UAVTalkTransactionCallback cb)
+{
+	UAVTalkConnectionData *connection;
+	CHECKCONHANDLE(connectionHandle,connection,return -1);
+
+	if (startTransaction(connection, obj, instId, UAVTALK_TYPE_OBJ_ACK, retries, timeoutMs, cb, false) == NULL)
+		return -1;
+
+	return 0;
+}
+
+/**
+ * Request an update for the specified object without waiting for it.  Works
+ * like UAVTalkSendObjectPipelined() with the transaction completing when the
+ * object is received.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] obj Object to update
+ * \param[in] instId The instance ID or UAVOBJ_ALL_INSTANCES for all instances.
+ * \param[in] retries Number of times to resend the request if it times out
+ * \param[in] timeoutMs Time to wait for each response
+ * \param[in] cb Completion callback, may be NULL.  It must not block.
+ * \return 0 Transaction started
+ * \return -1 Failure
+ */
+int32_t UAVTalkSendObjectRequestPipelined(UAVTalkConnection connectionHandle, UAVObjHandle obj, uint16_t instId, uint8_t retries, int32_t timeoutMs, UAVTalkTransactionCallback cb)
+{
+	UAVTalkConnectionData *connection;
+	CHECKCONHANDLE(connectionHandle,connection,return -1);
+
+	if (startTransaction(connection, obj, instId, UAVTALK_TYPE_OBJ_REQ, retries, timeoutMs, cb, false) == NULL)
+		return -1;
+
+	return 0;
+}
+
+/**
+ * Resend or fail pipelined transactions whose response timed out.  Tasks
+ * that start pipelined transactions should call this regularly.
+ * \param[in] connection UAVTalkConnection to be used
+ * \return Ticks until the next transaction times out, portMAX_DELAY if none
+ */
+uint32_t UAVTalkProcessTransactions(UAVTalkConnection connectionHandle)
+{
+	UAVTalkConnectionData *connection;
+	CHECKCONHANDLE(connectionHandle,connection,return portMAX_DELAY);
+
+	xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+	portTickType next = processTransactions(connection);
+	xSemaphoreGiveRecursive(connection->lock);
+
+	finishTransactions(connection);
+
+	return next;
+}
+
 /**
  * Execute the requested transaction on an object.
  * \param[in] connection UAVTalkConnection to be used
@@ -249,32 +482,20 @@ static int32_t objectTransaction(UAVTalkConnectionData *connection, UAVObjHandle
 	// Send object depending on if a response is needed
 	if (type == UAVTALK_TYPE_OBJ_ACK || type == UAVTALK_TYPE_OBJ_ACK_TS || type == UAVTALK_TYPE_OBJ_REQ)
 	{
-		// Get transaction lock (will block if a transaction is pending)
-		xSemaphoreTakeRecursive(connection->transLock, portMAX_DELAY);
-		// Send object
+		// Send object, other transactions may be outstanding at the same time
+		UAVTalkTransaction *trans = startTransaction(connection, obj, instId, type, 0, timeoutMs, NULL, true);
+		if (trans == NULL)
+			return -1;
+		// Wait for response (or timeout)
+		respReceived = xSemaphoreTake(trans->sema, timeoutMs/portTICK_RATE_MS);
+		// Release the transaction
 		xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
-		connection->respObj = obj;
-		connection->respInstId = instId;
-		sendObject(connection, obj, instId, type);
+		xSemaphoreTake(trans->sema, 0); // non blocking call to make sure the value is reset to zero (binary sema)
+		bool success = (respReceived == pdTRUE) && trans->success;
+		trans->obj = 0;
+		xSemaphoreGive(connection->transFreed);
 		xSemaphoreGiveRecursive(connection->lock);
-		// Wait for response (or timeout)
-		respReceived = xSemaphoreTake(connection->respSema, timeoutMs/portTICK_RATE_MS);
-		// Check if a response was received
-		if (respReceived == pdFALSE)
-		{
-			// Cancel transaction
-			xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
-			xSemaphoreTake(connection->respSema, 0); // non blocking call to make sure the value is reset to zero (binary sema)
-			connection->respObj = 0;
-			xSemaphoreGiveRecursive(connection->lock);
-			xSemaphoreGiveRecursive(connection->transLock);
-			return -1;
-		}
-		else
-		{
-			xSemaphoreGiveRecursive(connection->transLock);
-			return 0;
-		}
+		return success ? 0 : -1;
 	}
 	else if (type == UAVTALK_TYPE_OBJ || type == UAVTALK_TYPE_OBJ_TS)
 	{
@@ -300,9 +521,22 @@ UAVTalkRxState UAVTalkProcessInputStreamQuiet(UAVTalkConnection connectionHandle
 	UAVTalkConnectionData *connection;
     CHECKCONHANDLE(connectionHandle,connection,return -1);
 
-	UAVTalkInputProcessor *iproc = &connection->iproc;
 	++connection->stats.rxBytes;
 
+	return processInputByte(connection, rxbyte);
+}
+
+/**
+ * Run the receive state machine on a single byte.  The connection handle
+ * must already have been validated and the byte counted by the caller.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] rxbyte Received byte
+ * \return UAVTalkRxState
+ */
+static UAVTalkRxState processInputByte(UAVTalkConnectionData *connection, uint8_t rxbyte)
+{
+	UAVTalkInputProcessor *iproc = &connection->iproc;
+
 	if (iproc->state == UAVTALK_STATE_ERROR || iproc->state == UAVTALK_STATE_COMPLETE)
 		iproc->state = UAVTALK_STATE_SYNC;
 	
@@ -385,7 +619,9 @@ UAVTalkRxState UAVTalkProcessInputStreamQuiet(UAVTalkConnection connectionHandle
 			if (iproc->type == UAVTALK_TYPE_OBJ_REQ || iproc->type == UAVTALK_TYPE_ACK || iproc->type == UAVTALK_TYPE_NACK)
 			{
 				iproc->length = 0;
-				iproc->instanceLength = 0;
+				// Requests and ACKs of a multi instance object still carry the instance ID
+				iproc->instanceLength = (iproc->type != UAVTALK_TYPE_NACK && iproc->obj && !UAVObjIsSingleInstance(iproc->obj)) ? 2 : 0;
+				iproc->timestampLength = 0;
 			}
 			else
 			{
@@ -394,6 +630,21 @@ UAVTalkRxState UAVTalkProcessInputStreamQuiet(UAVTalkConnection connectionHandle
 					iproc->length = UAVObjGetNumBytes(iproc->obj);
 					iproc->instanceLength = (UAVObjIsSingleInstance(iproc->obj) ? 0 : 2);
 					iproc->timestampLength = (iproc->type & UAVTALK_TIMESTAMPED) ? 2 : 0;
+
+					// Delta frames are as long as the changes they carry, which
+					// is always less than the object itself
+					if (iproc->type == UAVTALK_TYPE_OBJ_DELTA)
+					{
+						uint32_t deltaLength = iproc->packet_size - iproc->rxPacketLength - iproc->instanceLength;
+						if (iproc->packet_size < iproc->rxPacketLength + iproc->instanceLength + 2 ||
+								deltaLength >= iproc->length)
+						{
+							connection->stats.rxErrors++;
+							iproc->state = UAVTALK_STATE_ERROR;
+							break;
+						}
+						iproc->length = deltaLength;
+					}
 				}
 				else
 				{
@@ -555,12 +806,77 @@ UAVTalkRxState UAVTalkProcessInputStream(UAVTalkConnection connectionHandle, uin
 
 		xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
 		receiveObject(connection, iproc->type, iproc->objId, iproc->instId, connection->rxBuffer, iproc->length);
+		txFlush(connection);
 		xSemaphoreGiveRecursive(connection->lock);
+
+		finishTransactions(connection);
 	}
 
 	return state;
 }
 
+/**
+ * Process a buffer of bytes from the telemetry stream.  Complete objects are
+ * dispatched exactly as with UAVTalkProcessInputStream(), but the handle check
+ * and statistics update happen once per buffer, the stream is scanned for the
+ * sync byte with memchr() and object payloads are copied and checksummed as
+ * whole spans rather than byte by byte.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] buf Received bytes
+ * \param[in] len Number of bytes in buf
+ * \return UAVTalkRxState after the last byte of the buffer
+ */
+UAVTalkRxState UAVTalkProcessInputBuffer(UAVTalkConnection connectionHandle, const uint8_t *buf, uint16_t len)
+{
+	UAVTalkConnectionData *connection;
+	CHECKCONHANDLE(connectionHandle,connection,return -1);
+
+	UAVTalkInputProcessor *iproc = &connection->iproc;
+	connection->stats.rxBytes += len;
+
+	uint16_t pos = 0;
+	while (pos < len) {
+		if (iproc->state == UAVTALK_STATE_ERROR || iproc->state == UAVTALK_STATE_COMPLETE)
+			iproc->state = UAVTALK_STATE_SYNC;
+
+		if (iproc->state == UAVTALK_STATE_SYNC) {
+			// Skip straight to the next sync byte, if any
+			const uint8_t *sync = memchr(&buf[pos], UAVTALK_SYNC_VAL, len - pos);
+			if (sync == NULL)
+				break;
+			pos = sync - buf;
+		} else if (iproc->state == UAVTALK_STATE_DATA) {
+			// Take as much of the payload as this buffer holds in one go
+			uint16_t span = iproc->length - iproc->rxCount;
+			if (span > len - pos)
+				span = len - pos;
+
+			memcpy(&connection->rxBuffer[iproc->rxCount], &buf[pos], span);
+			iproc->cs = PIOS_CRC_updateCRC(iproc->cs, &buf[pos], span);
+			iproc->rxCount += span;
+			iproc->rxPacketLength += span;
+			pos += span;
+
+			if (iproc->rxCount >= iproc->length) {
+				iproc->state = UAVTALK_STATE_CS;
+				iproc->rxCount = 0;
+			}
+			continue;
+		}
+
+		if (processInputByte(connection, buf[pos++]) == UAVTALK_STATE_COMPLETE) {
+			xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+			receiveObject(connection, iproc->type, iproc->objId, iproc->instId, connection->rxBuffer, iproc->length);
+			txFlush(connection);
+			xSemaphoreGiveRecursive(connection->lock);
+		}
+	}
+
+	finishTransactions(connection);
+
+	return iproc->state;
+}
+
 /**
  * Process an byte from the telemetry stream, sending the packet out the output stream when it's complete
  * This allows the interlieving of packets on an output UAVTalk stream, and is used by the OPLink device to
@@ -583,21 +899,25 @@ UAVTalkRxState UAVTalkRelayInputStream(UAVTalkConnection connectionHandle, uint8
 
 		if (!connection->outStream) return -1;
 
+		xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+
+		uint8_t *txBuffer = txReserve(connection, iproc->rxPacketLength);
+
 		// Setup type and object id fields
-		connection->txBuffer[0] = UAVTALK_SYNC_VAL;  // sync byte
-		connection->txBuffer[1] = iproc->type;
+		txBuffer[0] = UAVTALK_SYNC_VAL;  // sync byte
+		txBuffer[1] = iproc->type;
 		// data length inserted here below
-		connection->txBuffer[4] = (uint8_t)(iproc->objId & 0xFF);
-		connection->txBuffer[5] = (uint8_t)((iproc->objId >> 8) & 0xFF);
-		connection->txBuffer[6] = (uint8_t)((iproc->objId >> 16) & 0xFF);
-		connection->txBuffer[7] = (uint8_t)((iproc->objId >> 24) & 0xFF);
+		txBuffer[4] = (uint8_t)(iproc->objId & 0xFF);
+		txBuffer[5] = (uint8_t)((iproc->objId >> 8) & 0xFF);
+		txBuffer[6] = (uint8_t)((iproc->objId >> 16) & 0xFF);
+		txBuffer[7] = (uint8_t)((iproc->objId >> 24) & 0xFF);
 	
 		// Setup instance ID if one is required
 		int32_t dataOffset = 8;
 		if (iproc->instanceLength > 0)
 		{
-			connection->txBuffer[8] = (uint8_t)(iproc->instId & 0xFF);
-			connection->txBuffer[9] = (uint8_t)((iproc->instId >> 8) & 0xFF);
+			txBuffer[8] = (uint8_t)(iproc->instId & 0xFF);
+			txBuffer[9] = (uint8_t)((iproc->instId >> 8) & 0xFF);
 			dataOffset = 10;
 		}
 
@@ -605,23 +925,28 @@ UAVTalkRxState UAVTalkRelayInputStream(UAVTalkConnection connectionHandle, uint8
 		if (iproc->type & UAVTALK_TIMESTAMPED)
 		{
 			portTickType time = xTaskGetTickCount();
-			connection->txBuffer[dataOffset] = (uint8_t)(time & 0xFF);
-			connection->txBuffer[dataOffset + 1] = (uint8_t)((time >> 8) & 0xFF);
+			txBuffer[dataOffset] = (uint8_t)(time & 0xFF);
+			txBuffer[dataOffset + 1] = (uint8_t)((time >> 8) & 0xFF);
 			dataOffset += 2;
 		}
 	
 		// Copy data (if any)
-		memcpy(&connection->txBuffer[dataOffset], connection->rxBuffer, iproc->length);
+		memcpy(&txBuffer[dataOffset], connection->rxBuffer, iproc->length);
 	
 		// Store the packet length
-		connection->txBuffer[2] = (uint8_t)((dataOffset + iproc->length) & 0xFF);
-		connection->txBuffer[3] = (uint8_t)(((dataOffset + iproc->length) >> 8) & 0xFF);
+		txBuffer[2] = (uint8_t)((dataOffset + iproc->length) & 0xFF);
+		txBuffer[3] = (uint8_t)(((dataOffset + iproc->length) >> 8) & 0xFF);
 	
 		// Copy the checksum
-		connection->txBuffer[dataOffset + iproc->length] = iproc->cs;
+		txBuffer[dataOffset + iproc->length] = iproc->cs;
 
 		// Send the buffer.
-		if (UAVTalkSendBuf(connectionHandle, connection->txBuffer, iproc->rxPacketLength) < 0)
+		connection->stats.txBytes += iproc->rxPacketLength;
+		int32_t rc = txCommit(connection, txBuffer, iproc->rxPacketLength);
+
+		xSemaphoreGiveRecursive(connection->lock);
+
+		if (rc < 0)
 			return UAVTALK_STATE_ERROR;
 	}
 
@@ -691,6 +1016,9 @@ int32_t UAVTalkSendBuf(UAVTalkConnection connectionHandle, uint8_t *buf, uint16_
 	// Lock
 	xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
 
+	// Keep this behind anything already coalesced
+	txFlush(connection);
+
 	// Output the buffer
 	int32_t rc = (*connection->outStream)(buf, len);
 
@@ -709,7 +1037,7 @@ int32_t UAVTalkSendBuf(UAVTalkConnection connectionHandle, uint8_t *buf, uint16_
 /**
  * Receive an object. This function process objects received through the telemetry stream.
  * \param[in] connection UAVTalkConnection to be used
- * \param[in] type Type of received message (UAVTALK_TYPE_OBJ, UAVTALK_TYPE_OBJ_REQ, UAVTALK_TYPE_OBJ_ACK, UAVTALK_TYPE_ACK, UAVTALK_TYPE_NACK)
+ * \param[in] type Type of received message (UAVTALK_TYPE_OBJ, UAVTALK_TYPE_OBJ_REQ, UAVTALK_TYPE_OBJ_ACK, UAVTALK_TYPE_ACK, UAVTALK_TYPE_NACK, UAVTALK_TYPE_OBJ_DELTA)
  * \param[in] objId ID of the object to work on
  * \param[in] instId The instance ID of UAVOBJ_ALL_INSTANCES for all instances.
  * \param[in] data Data buffer
@@ -735,8 +1063,8 @@ static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, ui
 			{
 				// Unpack object, if the instance does not exist it will be created!
 				UAVObjUnpack(obj, instId, data);
-				// Check if an ack is pending
-				updateAck(connection, obj, instId);
+				// Check if a request is pending
+				updateAck(connection, obj, instId, true);
 			}
 			else
 			{
@@ -767,22 +1095,56 @@ static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, ui
 				ret = -1;
 			}
 			break;
+		case UAVTALK_TYPE_OBJ_DELTA:
+			// All instances, not allowed for delta messages
+			if (obj && (instId != UAVOBJ_ALL_INSTANCES))
+			{
+				// Only links that receive delta frames pay for the buffer they are applied in
+				if (connection->deltaRxBuffer == NULL)
+					connection->deltaRxBuffer = pvPortMalloc(UAVTALK_MAX_PAYLOAD_LENGTH);
+
+				uint8_t *next = connection->deltaRxBuffer;
+				uint16_t objLength = UAVObjGetNumBytes(obj);
+				if (next && UAVObjPack(obj, instId, next) == 0 &&
+						deltaDecode(next, objLength, data, length) == 0)
+				{
+					UAVObjUnpack(obj, instId, next);
+					updateAck(connection, obj, instId, true);
+				}
+				else
+				{
+					// The changes do not apply to what we have, ask for the whole object
+					connection->stats.rxErrors++;
+					sendObject(connection, obj, instId, UAVTALK_TYPE_OBJ_REQ);
+					ret = -1;
+				}
+			}
+			else
+			{
+				ret = -1;
+			}
+			break;
 		case UAVTALK_TYPE_OBJ_REQ:
 			// Send requested object if message is of type OBJ_REQ
-			if (obj == 0)
+			if (obj == 0) {
 				sendNack(connection, objId);
-			else
+			} else {
+				// A request is also how the other end recovers from a lost
+				// delta frame, so always answer with the full object
+				deltaForget(connection, obj, instId);
 				sendObject(connection, obj, instId, UAVTALK_TYPE_OBJ);
+			}
 			break;
 		case UAVTALK_TYPE_NACK:
-			// Do nothing on flight side, let it time out.
+			// The other end does not know this object, fail without retrying
+			updateNack(connection, objId);
 			break;
 		case UAVTALK_TYPE_ACK:
 			// All instances, not allowed for ACK messages
 			if (obj && (instId != UAVOBJ_ALL_INSTANCES))
 			{
 				// Check if an ack is pending
-				updateAck(connection, obj, instId);
+				updateAck(connection, obj, instId, false);
 			}
 			else
 			{
@@ -797,20 +1159,214 @@ static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, ui
 }
 
 /**
- * Check if an ack is pending on an object and give response semaphore
+ * Complete the transactions waiting for this response
  * \param[in] connection UAVTalkConnection to be used
  * \param[in] obj Object
  * \param[in] instId The instance ID of UAVOBJ_ALL_INSTANCES for all instances.
+ * \param[in] request True when the object itself was received, which answers
+ *                    a request, false for an ACK
  */
-static void updateAck(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId)
+static void updateAck(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId, bool request)
 {
-	if (connection->respObj == obj && (connection->respInstId == instId || connection->respInstId == UAVOBJ_ALL_INSTANCES))
-	{
-		xSemaphoreGive(connection->respSema);
-		connection->respObj = 0;
+	for (uint8_t i = 0; i < UAVTALK_MAX_TRANSACTIONS; i++) {
+		UAVTalkTransaction *trans = &connection->trans[i];
+		if (trans->obj != obj || trans->done)
+			continue;
+		if ((trans->type == UAVTALK_TYPE_OBJ_REQ) != request)
+			continue;
+		if (trans->instId == instId || trans->instId == UAVOBJ_ALL_INSTANCES)
+			completeTransaction(connection, trans, true);
+	}
+}
+
+/**
+ * Fail the transactions for an object the other end does not know
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] objId Object ID from the NACK
+ */
+static void updateNack(UAVTalkConnectionData *connection, uint32_t objId)
+{
+	for (uint8_t i = 0; i < UAVTALK_MAX_TRANSACTIONS; i++) {
+		UAVTalkTransaction *trans = &connection->trans[i];
+		if (trans->obj != 0 && !trans->done && UAVObjGetID(trans->obj) == objId)
+			completeTransaction(connection, trans, false);
 	}
 }
 
+/**
+ * Take a free transaction slot, send the object and start tracking the
+ * response.  Waits for a slot if all of them are in use.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] obj Object
+ * \param[in] instId The instance ID of UAVOBJ_ALL_INSTANCES for all instances.
+ * \param[in] type Transaction type, UAVTALK_TYPE_OBJ_ACK(_TS) or UAVTALK_TYPE_OBJ_REQ
+ * \param[in] retries Number of resends when the response times out
+ * \param[in] timeoutMs Time to wait for each response, and for a free slot
+ *                      when the caller waits itself
+ * \param[in] cb Completion callback for pipelined transactions
+ * \param[in] waiting True if the caller waits on the transaction semaphore
+ *                    and handles the timeout itself
+ * \return The transaction or NULL if no slot became free
+ */
+static UAVTalkTransaction *startTransaction(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId, uint8_t type, uint8_t retries, int32_t timeoutMs, UAVTalkTransactionCallback cb, bool waiting)
+{
+	UAVTalkTransaction *trans = NULL;
+	portTickType start = xTaskGetTickCount();
+
+	while (1) {
+		finishTransactions(connection);
+
+		xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+
+		portTickType wait = processTransactions(connection);
+		for (uint8_t i = 0; i < UAVTALK_MAX_TRANSACTIONS; i++) {
+			if (connection->trans[i].obj == 0) {
+				trans = &connection->trans[i];
+				break;
+			}
+		}
+		if (trans)
+			break;
+
+		xSemaphoreGiveRecursive(connection->lock);
+
+		// Transactions that just timed out free their slots straight away
+		if (connection->transDone)
+			continue;
+
+		// All slots are in use, wait for one to be freed
+		if (waiting) {
+			portTickType elapsed = xTaskGetTickCount() - start;
+			if (elapsed >= timeoutMs / portTICK_RATE_MS)
+				return NULL;
+			if (wait > timeoutMs / portTICK_RATE_MS - elapsed)
+				wait = timeoutMs / portTICK_RATE_MS - elapsed;
+		}
+		if (wait > UAVTALK_TRANS_POLL_MS / portTICK_RATE_MS)
+			wait = UAVTALK_TRANS_POLL_MS / portTICK_RATE_MS;
+		xSemaphoreTake(connection->transFreed, wait);
+	}
+
+	trans->obj = obj;
+	trans->instId = instId;
+	trans->type = type;
+	trans->retriesLeft = retries;
+	trans->retries = 0;
+	trans->waiting = waiting;
+	trans->done = false;
+	trans->success = false;
+	trans->timeout = timeoutMs / portTICK_RATE_MS;
+	trans->deadline = xTaskGetTickCount() + trans->timeout;
+	trans->cb = cb;
+
+	sendObject(connection, obj, instId, type);
+	// Someone is blocked on this one so it has to go out now
+	if (waiting)
+		txFlush(connection);
+
+	xSemaphoreGiveRecursive(connection->lock);
+
+	finishTransactions(connection);
+
+	return trans;
+}
+
+/**
+ * Finish a transaction.  A waiting caller is woken and frees the slot itself,
+ * pipelined transactions keep their slot until finishTransactions() runs
+ * their callback.  Must be called with the connection lock held.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] trans The transaction
+ * \param[in] success True if the response was received
+ */
+static void completeTransaction(UAVTalkConnectionData *connection, UAVTalkTransaction *trans, bool success)
+{
+	trans->done = true;
+	trans->success = success;
+
+	if (trans->waiting) {
+		xSemaphoreGive(trans->sema);
+		return;
+	}
+
+	connection->transDone = true;
+}
+
+/**
+ * Free the completed pipelined transactions and run their callbacks.  The
+ * callbacks run after the connection lock is released so they never hold up
+ * the receive path or other senders.  Must be called without the connection
+ * lock held.
+ * \param[in] connection UAVTalkConnection to be used
+ */
+static void finishTransactions(UAVTalkConnectionData *connection)
+{
+	// Completions always set this under the lock before it is released
+	if (!connection->transDone)
+		return;
+
+	UAVTalkTransaction done[UAVTALK_MAX_TRANSACTIONS];
+	uint8_t numDone = 0;
+
+	xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+
+	connection->transDone = false;
+	for (uint8_t i = 0; i < UAVTALK_MAX_TRANSACTIONS; i++) {
+		UAVTalkTransaction *trans = &connection->trans[i];
+		if (trans->obj == 0 || trans->waiting || !trans->done)
+			continue;
+		done[numDone++] = *trans;
+		trans->obj = 0;
+	}
+	if (numDone > 0)
+		xSemaphoreGive(connection->transFreed);
+
+	xSemaphoreGiveRecursive(connection->lock);
+
+	for (uint8_t i = 0; i < numDone; i++) {
+		if (done[i].cb)
+			done[i].cb(done[i].obj, done[i].instId, done[i].success, done[i].retries);
+	}
+}
+
+/**
+ * Resend pipelined transactions whose response timed out and fail those
+ * that ran out of retries.  Must be called with the connection lock held.
+ * \param[in] connection UAVTalkConnection to be used
+ * \return Ticks until the next transaction times out, portMAX_DELAY if none
+ */
+static portTickType processTransactions(UAVTalkConnectionData *connection)
+{
+	portTickType now = xTaskGetTickCount();
+	portTickType next = portMAX_DELAY;
+
+	for (uint8_t i = 0; i < UAVTALK_MAX_TRANSACTIONS; i++) {
+		UAVTalkTransaction *trans = &connection->trans[i];
+		if (trans->obj == 0 || trans->waiting || trans->done)
+			continue;
+
+		int32_t remaining = (int32_t)(trans->deadline - now);
+		if (remaining <= 0) {
+			if (trans->retriesLeft == 0) {
+				completeTransaction(connection, trans, false);
+				continue;
+			}
+
+			// Only this one is resent, the others keep waiting
+			--trans->retriesLeft;
+			++trans->retries;
+			sendObject(connection, trans->obj, trans->instId, trans->type);
+			trans->deadline = now + trans->timeout;
+			remaining = trans->timeout;
+		}
+
+		if ((portTickType)remaining < next)
+			next = remaining;
+	}
+
+	return next;
+}
+
 /**
  * Send an object through the telemetry link.
  * \param[in] connection UAVTalkConnection to be used
@@ -838,11 +1394,15 @@ static int32_t sendObject(UAVTalkConnectionData *connection, UAVObjHandle obj, u
 		{
 			// Get number of instances
 			numInst = UAVObjGetNumInstances(obj);
-			// Send all instances
+			// Send all instances, handing them to the output stream together
+			++connection->txHold;
 			for (n = 0; n < numInst; ++n)
 			{
 				sendSingleObject(connection, obj, n, type);
 			}
+			--connection->txHold;
+			if (!txDeferred(connection))
+				txFlush(connection);
 			return 0;
 		}
 		else
@@ -885,40 +1445,10 @@ static int32_t sendSingleObject(UAVTalkConnectionData *connection, UAVObjHandle
 	int32_t length;
 	int32_t dataOffset;
 	uint32_t objId;
+	uint8_t *txBuffer;
 
 	if (!connection->outStream) return -1;
 
-	// Setup type and object id fields
-	objId = UAVObjGetID(obj);
-	connection->txBuffer[0] = UAVTALK_SYNC_VAL;  // sync byte
-	connection->txBuffer[1] = type;
-	// data length inserted here below
-	connection->txBuffer[4] = (uint8_t)(objId & 0xFF);
-	connection->txBuffer[5] = (uint8_t)((objId >> 8) & 0xFF);
-	connection->txBuffer[6] = (uint8_t)((objId >> 16) & 0xFF);
-	connection->txBuffer[7] = (uint8_t)((objId >> 24) & 0xFF);
-	
-	// Setup instance ID if one is required
-	if (UAVObjIsSingleInstance(obj))
-	{
-		dataOffset = 8;
-	}
-	else
-	{
-		connection->txBuffer[8] = (uint8_t)(instId & 0xFF);
-		connection->txBuffer[9] = (uint8_t)((instId >> 8) & 0xFF);
-		dataOffset = 10;
-	}
-
-	// Add timestamp when the transaction type is appropriate
-	if (type & UAVTALK_TIMESTAMPED)
-	{
-		portTickType time = xTaskGetTickCount();
-		connection->txBuffer[dataOffset] = (uint8_t)(time & 0xFF);
-		connection->txBuffer[dataOffset + 1] = (uint8_t)((time >> 8) & 0xFF);
-		dataOffset += 2;
-	}
-	
 	// Determine data length
 	if (type == UAVTALK_TYPE_OBJ_REQ || type == UAVTALK_TYPE_ACK)
 	{
@@ -934,27 +1464,90 @@ static int32_t sendSingleObject(UAVTalkConnectionData *connection, UAVObjHandle
 	{
 		return -1;
 	}
+
+	// Determine header length, instance ID and timestamp are optional
+	dataOffset = 8;
+	if (!UAVObjIsSingleInstance(obj))
+		dataOffset += 2;
+	if (type & UAVTALK_TIMESTAMPED)
+		dataOffset += 2;
+
+	uint16_t tx_msg_len = dataOffset+length+UAVTALK_CHECKSUM_LENGTH;
+	txBuffer = txReserve(connection, tx_msg_len);
+
+	// Setup type and object id fields
+	objId = UAVObjGetID(obj);
+	txBuffer[0] = UAVTALK_SYNC_VAL;  // sync byte
+	txBuffer[1] = type;
+	// data length inserted here below
+	txBuffer[4] = (uint8_t)(objId & 0xFF);
+	txBuffer[5] = (uint8_t)((objId >> 8) & 0xFF);
+	txBuffer[6] = (uint8_t)((objId >> 16) & 0xFF);
+	txBuffer[7] = (uint8_t)((objId >> 24) & 0xFF);
+	
+	// Setup instance ID if one is required
+	if (!UAVObjIsSingleInstance(obj))
+	{
+		txBuffer[8] = (uint8_t)(instId & 0xFF);
+		txBuffer[9] = (uint8_t)((instId >> 8) & 0xFF);
+	}
+
+	// Add timestamp when the transaction type is appropriate
+	if (type & UAVTALK_TIMESTAMPED)
+	{
+		portTickType time = xTaskGetTickCount();
+		txBuffer[dataOffset - 2] = (uint8_t)(time & 0xFF);
+		txBuffer[dataOffset - 1] = (uint8_t)((time >> 8) & 0xFF);
+	}
 	
 	// Copy data (if any)
 	if (length > 0)
 	{
-		if ( UAVObjPack(obj, instId, &connection->txBuffer[dataOffset]) < 0 )
+		if ( UAVObjPack(obj, instId, &txBuffer[dataOffset]) < 0 )
 		{
 			return -1;
 		}
 	}
 	
+	// Send large objects as the bytes that changed since they were last sent
+	if (connection->deltaEnabled && length >= UAVTALK_DELTA_MIN_LENGTH &&
+			(type == UAVTALK_TYPE_OBJ || type == UAVTALK_TYPE_OBJ_ACK))
+	{
+		// Acked updates keep the copy current but do not claim a slot
+		UAVTalkDeltaSlot *slot = deltaSlot(connection, obj, instId, type == UAVTALK_TYPE_OBJ);
+		if (slot)
+		{
+			int32_t deltaLength = -1;
+			if (type == UAVTALK_TYPE_OBJ && slot->valid && slot->deltasSinceFull < UAVTALK_DELTA_FULL_INTERVAL)
+			{
+				deltaLength = deltaEncode(slot->base, &txBuffer[dataOffset], length, connection->deltaBuffer);
+			}
+			memcpy(slot->base, &txBuffer[dataOffset], length);
+			slot->valid = true;
+
+			if (deltaLength > 0)
+			{
+				memcpy(&txBuffer[dataOffset], connection->deltaBuffer, deltaLength);
+				txBuffer[1] = UAVTALK_TYPE_OBJ_DELTA;
+				length = deltaLength;
+				tx_msg_len = dataOffset+length+UAVTALK_CHECKSUM_LENGTH;
+				++slot->deltasSinceFull;
+			}
+			else
+			{
+				slot->deltasSinceFull = 0;
+			}
+		}
+	}
+
 	// Store the packet length
-	connection->txBuffer[2] = (uint8_t)((dataOffset+length) & 0xFF);
-	connection->txBuffer[3] = (uint8_t)(((dataOffset+length) >> 8) & 0xFF);
+	txBuffer[2] = (uint8_t)((dataOffset+length) & 0xFF);
+	txBuffer[3] = (uint8_t)(((dataOffset+length) >> 8) & 0xFF);
 	
 	// Calculate checksum
-	connection->txBuffer[dataOffset+length] = PIOS_CRC_updateCRC(0, connection->txBuffer, dataOffset+length);
+	txBuffer[dataOffset+length] = PIOS_CRC_updateCRC(0, txBuffer, dataOffset+length);
 
-	uint16_t tx_msg_len = dataOffset+length+UAVTALK_CHECKSUM_LENGTH;
-	int32_t rc = (*connection->outStream)(connection->txBuffer, tx_msg_len);
-
-	if (rc == tx_msg_len) {
+	if (txCommit(connection, txBuffer, tx_msg_len) == 0) {
 		// Update stats
 		++connection->stats.txObjects;
 		connection->stats.txBytes += tx_msg_len;
@@ -975,30 +1568,31 @@ static int32_t sendSingleObject(UAVTalkConnectionData *connection, UAVObjHandle
 static int32_t sendNack(UAVTalkConnectionData *connection, uint32_t objId)
 {
 	int32_t dataOffset;
+	uint8_t *txBuffer;
 
 	if (!connection->outStream) return -1;
 
-	connection->txBuffer[0] = UAVTALK_SYNC_VAL;  // sync byte
-	connection->txBuffer[1] = UAVTALK_TYPE_NACK;
-	// data length inserted here below
-	connection->txBuffer[4] = (uint8_t)(objId & 0xFF);
-	connection->txBuffer[5] = (uint8_t)((objId >> 8) & 0xFF);
-	connection->txBuffer[6] = (uint8_t)((objId >> 16) & 0xFF);
-	connection->txBuffer[7] = (uint8_t)((objId >> 24) & 0xFF);
-
 	dataOffset = 8;
 
+	uint16_t tx_msg_len = dataOffset+UAVTALK_CHECKSUM_LENGTH;
+	txBuffer = txReserve(connection, tx_msg_len);
+
+	txBuffer[0] = UAVTALK_SYNC_VAL;  // sync byte
+	txBuffer[1] = UAVTALK_TYPE_NACK;
+	// data length inserted here below
+	txBuffer[4] = (uint8_t)(objId & 0xFF);
+	txBuffer[5] = (uint8_t)((objId >> 8) & 0xFF);
+	txBuffer[6] = (uint8_t)((objId >> 16) & 0xFF);
+	txBuffer[7] = (uint8_t)((objId >> 24) & 0xFF);
+
 	// Store the packet length
-	connection->txBuffer[2] = (uint8_t)((dataOffset) & 0xFF);
-	connection->txBuffer[3] = (uint8_t)(((dataOffset) >> 8) & 0xFF);
+	txBuffer[2] = (uint8_t)((dataOffset) & 0xFF);
+	txBuffer[3] = (uint8_t)(((dataOffset) >> 8) & 0xFF);
 
 	// Calculate checksum
-	connection->txBuffer[dataOffset] = PIOS_CRC_updateCRC(0, connection->txBuffer, dataOffset);
-
-	uint16_t tx_msg_len = dataOffset+UAVTALK_CHECKSUM_LENGTH;
-	int32_t rc = (*connection->outStream)(connection->txBuffer, tx_msg_len);
+	txBuffer[dataOffset] = PIOS_CRC_updateCRC(0, txBuffer, dataOffset);
 
-	if (rc == tx_msg_len) {
+	if (txCommit(connection, txBuffer, tx_msg_len) == 0) {
 		// Update stats
 		connection->stats.txBytes += tx_msg_len;
 	}
@@ -1007,6 +1601,259 @@ static int32_t sendNack(UAVTalkConnectionData *connection, uint32_t objId)
 	return 0;
 }
 
+/**
+ * Find the delta slot holding the last sent copy of an object instance.
+ * Must be called with the connection lock held.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] obj Object handle
+ * \param[in] instId The instance ID
+ * \param[in] bind Take over the least recently used slot if the instance has none
+ * \return The slot or NULL if there is none
+ */
+static UAVTalkDeltaSlot *deltaSlot(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId, bool bind)
+{
+	portTickType now = xTaskGetTickCount();
+	UAVTalkDeltaSlot *oldest = NULL;
+
+	for (uint8_t i = 0; i < UAVTALK_DELTA_SLOTS; i++) {
+		UAVTalkDeltaSlot *slot = &connection->deltaSlots[i];
+		if (slot->obj == obj && slot->instId == instId) {
+			slot->lastUsed = now;
+			return slot;
+		}
+		if (oldest == NULL || slot->obj == 0 ||
+				(oldest->obj != 0 && (now - slot->lastUsed) > (now - oldest->lastUsed)))
+			oldest = slot;
+	}
+
+	if (!bind)
+		return NULL;
+
+	// Objects sent once, like settings, lose their slot to periodic ones
+	oldest->obj = obj;
+	oldest->instId = instId;
+	oldest->valid = false;
+	oldest->deltasSinceFull = 0;
+	oldest->lastUsed = now;
+
+	return oldest;
+}
+
+/**
+ * Drop the last sent copy of an object so it is sent in full next time.
+ * Must be called with the connection lock held.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] obj Object handle
+ * \param[in] instId The instance ID or UAVOBJ_ALL_INSTANCES
+ */
+static void deltaForget(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId)
+{
+	if (connection->deltaSlots == NULL)
+		return;
+
+	for (uint8_t i = 0; i < UAVTALK_DELTA_SLOTS; i++) {
+		UAVTalkDeltaSlot *slot = &connection->deltaSlots[i];
+		if (slot->obj == obj && (instId == UAVOBJ_ALL_INSTANCES || slot->instId == instId))
+			slot->valid = false;
+	}
+}
+
+/**
+ * Encode the difference between two copies of an object as a delta frame
+ * payload.  The payload starts with the CRC16 of the base the receiver has
+ * to apply it to, followed by runs of a count of unchanged bytes to skip,
+ * a count of changed bytes and the changed bytes XORed with the base.
+ * \param[in] base The data last sent
+ * \param[in] data The data to send now
+ * \param[in] length Length of the object
+ * \param[out] out Buffer of at least length bytes for the payload
+ * \return Length of the payload or -1 if it would not be shorter than the object
+ */
+static int32_t deltaEncode(const uint8_t *base, const uint8_t *data, uint16_t length, uint8_t *out)
+{
+	uint16_t crc = PIOS_CRC16_updateCRC(0, base, length);
+	out[0] = (uint8_t)(crc & 0xFF);
+	out[1] = (uint8_t)((crc >> 8) & 0xFF);
+
+	uint16_t outLength = 2;
+	uint16_t i = 0;
+
+	while (i < length) {
+		uint16_t skip = 0;
+		while (i < length && data[i] == base[i] && skip < 0xFF) {
+			++i;
+			++skip;
+		}
+
+		// Nothing changed in the rest of the object
+		if (i == length)
+			break;
+
+		// A single unchanged byte is cheaper to send than a new run
+		uint16_t start = i;
+		while (i < length && i - start < 0xFF &&
+				(data[i] != base[i] || (i + 1 < length && data[i + 1] != base[i + 1])))
+			++i;
+
+		uint16_t count = i - start;
+		if (outLength + 2 + count >= length)
+			return -1;
+
+		out[outLength++] = (uint8_t)skip;
+		out[outLength++] = (uint8_t)count;
+		for (uint16_t j = start; j < i; j++)
+			out[outLength++] = data[j] ^ base[j];
+	}
+
+	return outLength;
+}
+
+/**
+ * Apply a delta frame payload built by deltaEncode() to the data it was
+ * encoded against.  The runs are checked against the object length before
+ * anything is changed, so a malformed frame leaves the data as it was.
+ * \param[in,out] base The current data of the object, updated in place
+ * \param[in] length Length of the object
+ * \param[in] delta The delta frame payload
+ * \param[in] deltaLength Length of the payload
+ * \return 0 Success
+ * \return -1 The payload was encoded against different data or is malformed
+ */
+static int32_t deltaDecode(uint8_t *base, uint16_t length, const uint8_t *delta, uint16_t deltaLength)
+{
+	if (deltaLength < 2)
+		return -1;
+
+	// Make sure both ends agree on what the changes apply to
+	uint16_t crc = PIOS_CRC16_updateCRC(0, base, length);
+	if (delta[0] != (uint8_t)(crc & 0xFF) || delta[1] != (uint8_t)((crc >> 8) & 0xFF))
+		return -1;
+
+	uint16_t pos = 0;
+	for (uint16_t i = 2; i < deltaLength; ) {
+		if (i + 2 > deltaLength)
+			return -1;
+		pos += delta[i];
+		uint16_t count = delta[i + 1];
+		i += 2;
+		if (pos + count > length || i + count > deltaLength)
+			return -1;
+		pos += count;
+		i += count;
+	}
+
+	pos = 0;
+	for (uint16_t i = 2; i < deltaLength; ) {
+		pos += delta[i];
+		uint16_t count = delta[i + 1];
+		i += 2;
+		for (uint16_t j = 0; j < count; j++)
+			base[pos++] ^= delta[i++];
+	}
+
+	return 0;
+}
+
+/**
+ * Get space to build an outgoing packet in.  This is the output stream's own
+ * buffer when the zero copy stream can provide it, otherwise the next free
+ * part of the connection transmit buffer, which is flushed first if the
+ * packet would not fit.  Must be called with the connection lock held.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] length Length of the complete packet including checksum
+ * \return Pointer to at least length bytes
+ */
+static uint8_t *txReserve(UAVTalkConnectionData *connection, uint16_t length)
+{
+	if (connection->reserveStream) {
+		// Coalesced packets have to go out first to keep the order
+		if (connection->txPending > 0)
+			txFlush(connection);
+
+		uint8_t *buf = connection->reserveStream(length);
+		if (buf)
+			return buf;
+	}
+
+	if (connection->txPending + length > UAVTALK_MAX_PACKET_LENGTH)
+		txFlush(connection);
+
+	return &connection->txBuffer[connection->txPending];
+}
+
+/**
+ * Add a packet built in space from txReserve() to the output.  Outside of a
+ * batch it is sent right away.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] buf Pointer returned by txReserve()
+ * \param[in] length Length of the complete packet including checksum
+ * \return 0 Success
+ * \return -1 Failure
+ */
+static int32_t txCommit(UAVTalkConnectionData *connection, uint8_t *buf, uint16_t length)
+{
+	if (buf != &connection->txBuffer[connection->txPending]) {
+		// Built in place, only start the transmitter once the batch is done
+		bool flush = !txDeferred(connection);
+		connection->txKickPending = !flush;
+		if (connection->commitStream(length, flush) != length) {
+			++connection->stats.txErrors;
+			return -1;
+		}
+		return 0;
+	}
+
+	connection->txPending += length;
+	if (!txDeferred(connection))
+		return txFlush(connection);
+
+	return 0;
+}
+
+/**
+ * Send all coalesced packets and start transmission of any packets that
+ * were built in place.  Must be called with the connection lock held.
+ * \param[in] connection UAVTalkConnection to be used
+ * \return 0 Success
+ * \return -1 Failure
+ */
+static int32_t txFlush(UAVTalkConnectionData *connection)
+{
+	int32_t ret = 0;
+
+	if (connection->txPending > 0) {
+		uint16_t length = connection->txPending;
+		connection->txPending = 0;
+		if (!connection->outStream || (*connection->outStream)(connection->txBuffer, length) != length) {
+			++connection->stats.txErrors;
+			ret = -1;
+		}
+	}
+
+	if (connection->txKickPending) {
+		connection->txKickPending = false;
+		connection->commitStream(0, true);
+	}
+
+	return ret;
+}
+
+/**
+ * Check whether sent packets are held back.  They are while all instances of
+ * an object are being sent and while the calling task has a batch open.  A
+ * packet sent by any other task flushes whatever was held, so it never waits
+ * for another task's batch.  Must be called with the connection lock held.
+ * \param[in] connection UAVTalkConnection to be used
+ * \return true if packets are held back
+ */
+static bool txDeferred(UAVTalkConnectionData *connection)
+{
+	if (connection->txHold > 0)
+		return true;
+
+	return connection->txBatch > 0 && connection->txBatchOwner == xTaskGetCurrentTaskHandle();
+}
+
 /**
  * @}
  * @}
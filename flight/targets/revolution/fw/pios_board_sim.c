@@ -94,6 +94,7 @@ const struct pios_tcp_cfg pios_tcp_aux_cfg = {
 
 uintptr_t pios_uavo_settings_fs_id;
 uintptr_t pios_waypoints_settings_fs_id;
+uintptr_t pios_streamfs_id;
 
 /*
  * Board specific number of devices.
@@ -133,6 +134,9 @@ void PIOS_Board_Init(void) {
 	if (PIOS_FLASHFS_Logfs_Init(&pios_waypoints_settings_fs_id, &flashfs_config_waypoints, FLASH_PARTITION_LABEL_WAYPOINTS) != 0)
 		fprintf(stderr, "Unable to open the waypoints partition\n");
 
+	if (PIOS_STREAMFS_Init(&pios_streamfs_id, &streamfs_config_log, FLASH_PARTITION_LABEL_LOG) != 0)
+		fprintf(stderr, "Unable to open the log partition\n");
+
 	/* Initialize UAVObject libraries */
 	EventDispatcherInitialize();
 	UAVObjInitialize();
@@ -219,11 +223,13 @@ void PIOS_Board_Init(void) {
 	pios_rcvr_group_map[MANUALCONTROLSETTINGS_CHANNELGROUPS_GCS] = pios_gcsrcvr_rcvr_id;
 #endif	/* PIOS_INCLUDE_GCSRCVR */
 
-	// Register fake address.  Later if we really fake entire sensors then
-	// it will make sense to have real queues registered.  For now if these
-	// queues are used a crash is appropriate.
-	PIOS_SENSORS_Register(PIOS_SENSOR_ACCEL, (xQueueHandle) 1);
-	PIOS_SENSORS_Register(PIOS_SENSOR_GYRO, (xQueueHandle) 1);
+	// The accel and gyro rings are real so the lock free sample path runs
+	// on the simulator too.  Register fake addresses for the other sensors.
+	// Later if we really fake entire sensors then it will make sense to have
+	// real queues registered.  For now if these queues are used a crash is
+	// appropriate.
+	PIOS_SENSORS_RegisterRing(PIOS_SENSOR_ACCEL, PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_accel_data), 8));
+	PIOS_SENSORS_RegisterRing(PIOS_SENSOR_GYRO, PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_gyro_data), 8));
 	PIOS_SENSORS_Register(PIOS_SENSOR_MAG, (xQueueHandle) 1);
 	PIOS_SENSORS_Register(PIOS_SENSOR_BARO, (xQueueHandle) 1);
 }
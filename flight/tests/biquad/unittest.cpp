@@ -0,0 +1,175 @@
+/**
+ ******************************************************************************
+ * @file       unittest.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2013
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Unit test
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * NOTE: This program uses the Google Test infrastructure to drive the unit test
+ *
+ * Main site for Google Test: http://code.google.com/p/googletest/
+ * Documentation and examples: http://code.google.com/p/googletest/wiki/Documentation
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>		/* printf */
+#include <stdlib.h>		/* abort */
+#include <string.h>		/* memset */
+#include <stdint.h>		/* uint*_t */
+
+extern "C" {
+
+#include "biquad.h"		/* API for biquad functions */
+
+}
+
+#include <math.h>		/* fabs() */
+
+// To use a test fixture, derive a class from testing::Test.
+class Biquad : public testing::Test {
+protected:
+  virtual void SetUp() {
+    memset(&bq, 0, sizeof(bq));
+  }
+
+  virtual void TearDown() {
+  }
+
+  // Run a sine through the filter and return the steady state peak output
+  float sineGain(float freq, float sample_rate) {
+    const int settle = 2000;
+    const int measure = 2000;
+    float peak = 0;
+
+    biquad_reset(&bq, 0);
+    for (int i = 0; i < settle + measure; i++) {
+      float y = biquad_apply(&bq, sinf(2 * M_PI * freq * i / sample_rate));
+      if (i >= settle && fabs(y) > peak)
+        peak = fabs(y);
+    }
+    return peak;
+  }
+
+  struct biquad bq;
+};
+
+// Test fixture for biquad_configure_notch()
+class Notch : public Biquad {
+};
+
+TEST_F(Notch, UnityDCGain) {
+  biquad_configure_notch(&bq, 100.0f, 3.0f, 1000.0f);
+  biquad_reset(&bq, 0);
+
+  float y = 0;
+  for (int i = 0; i < 1000; i++)
+    y = biquad_apply(&bq, 5.0f);
+  EXPECT_NEAR(5.0f, y, 1e-4f);
+};
+
+TEST_F(Notch, RejectsCenter) {
+  biquad_configure_notch(&bq, 100.0f, 3.0f, 1000.0f);
+  EXPECT_GT(0.01f, sineGain(100.0f, 1000.0f));
+};
+
+TEST_F(Notch, PassesAwayFromCenter) {
+  biquad_configure_notch(&bq, 100.0f, 3.0f, 1000.0f);
+  EXPECT_LT(0.95f, sineGain(10.0f, 1000.0f));
+  EXPECT_LT(0.95f, sineGain(400.0f, 1000.0f));
+};
+
+TEST_F(Notch, BandwidthFromQ) {
+  // Gain at the -3dB edges f0 * (sqrt(1 + 1/(4Q^2)) +- 1/(2Q)) is 1/sqrt(2)
+  const float f0 = 100.0f;
+  const float q = 2.0f;
+  const float k = sqrtf(1 + 1 / (4 * q * q));
+
+  biquad_configure_notch(&bq, f0, q, 8000.0f);
+  EXPECT_NEAR(M_SQRT1_2, sineGain(f0 * (k + 1 / (2 * q)), 8000.0f), 0.02f);
+  EXPECT_NEAR(M_SQRT1_2, sineGain(f0 * (k - 1 / (2 * q)), 8000.0f), 0.02f);
+};
+
+TEST_F(Notch, InvalidIsPassthrough) {
+  const float x[] = {1.0f, -2.0f, 3.5f, 0.25f};
+
+  // Center at or above Nyquist, non-positive center and non-positive q
+  const float bad[][3] = {
+    {500.0f, 3.0f, 1000.0f},
+    {600.0f, 3.0f, 1000.0f},
+    {0.0f, 3.0f, 1000.0f},
+    {-10.0f, 3.0f, 1000.0f},
+    {100.0f, 0.0f, 1000.0f},
+    {100.0f, 3.0f, 0.0f},
+    {NAN, 3.0f, 1000.0f},
+  };
+
+  for (unsigned int j = 0; j < sizeof(bad) / sizeof(bad[0]); j++) {
+    biquad_configure_notch(&bq, bad[j][0], bad[j][1], bad[j][2]);
+    biquad_reset(&bq, 0);
+    for (unsigned int i = 0; i < sizeof(x) / sizeof(x[0]); i++)
+      EXPECT_EQ(x[i], biquad_apply(&bq, x[i]));
+  }
+};
+
+TEST_F(Notch, RetuneKeepsState) {
+  // Moving the center must not disturb a constant signal
+  biquad_configure_notch(&bq, 100.0f, 3.0f, 1000.0f);
+  biquad_reset(&bq, 2.0f);
+
+  for (int i = 0; i < 100; i++) {
+    biquad_configure_notch(&bq, 100.0f + i, 3.0f, 1000.0f);
+    EXPECT_NEAR(2.0f, biquad_apply(&bq, 2.0f), 1e-5f);
+  }
+};
+
+TEST_F(Notch, TracksMovingTone) {
+  // Follow a tone sweeping from 100 to 200 Hz and check it stays rejected
+  const float fs = 1000.0f;
+  float phase = 0;
+  float peak = 0;
+
+  biquad_reset(&bq, 0);
+  for (int i = 0; i < 10000; i++) {
+    float f = 100.0f + 100.0f * i / 10000;
+    biquad_configure_notch(&bq, f, 3.0f, fs);
+    phase += 2 * M_PI * f / fs;
+    float y = biquad_apply(&bq, sinf(phase));
+    if (i > 500 && fabs(y) > peak)
+      peak = fabs(y);
+  }
+  EXPECT_GT(0.05f, peak);
+};
+
+// Test fixture for biquad_configure_passthrough()
+class Passthrough : public Biquad {
+};
+
+TEST_F(Passthrough, Identity) {
+  biquad_configure_notch(&bq, 100.0f, 3.0f, 1000.0f);
+  biquad_reset(&bq, 7.0f);
+  biquad_configure_passthrough(&bq);
+
+  for (int i = -10; i < 10; i++)
+    EXPECT_EQ((float) i, biquad_apply(&bq, (float) i));
+};
@@ -0,0 +1,65 @@
+/**
+ ******************************************************************************
+ * @file       insgps13state_general.c
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Reference build of the INS with the general measurement update
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * The filter keeps its state in file scope variables, so a second copy is
+ * built here with every exported symbol prefixed by ref_ and linked next
+ * to the copy under test.
+ */
+
+#define GENERAL_UPDATE
+
+#define ins_get_num_states ref_ins_get_num_states
+#define INSGPSInit ref_INSGPSInit
+#define INSGetState ref_INSGetState
+#define INSGetVariance ref_INSGetVariance
+#define INSResetP ref_INSResetP
+#define INSSetState ref_INSSetState
+#define INSPosVelReset ref_INSPosVelReset
+#define INSSetPosVelVar ref_INSSetPosVelVar
+#define INSSetGyroBias ref_INSSetGyroBias
+#define INSSetAccelVar ref_INSSetAccelVar
+#define INSSetGyroVar ref_INSSetGyroVar
+#define INSSetMagVar ref_INSSetMagVar
+#define INSSetBaroVar ref_INSSetBaroVar
+#define INSSetMagNorth ref_INSSetMagNorth
+#define INSStatePrediction ref_INSStatePrediction
+#define INSCovariancePrediction ref_INSCovariancePrediction
+#define MagCorrection ref_MagCorrection
+#define MagVelBaroCorrection ref_MagVelBaroCorrection
+#define GpsBaroCorrection ref_GpsBaroCorrection
+#define FullCorrection ref_FullCorrection
+#define GpsMagCorrection ref_GpsMagCorrection
+#define VelBaroCorrection ref_VelBaroCorrection
+#define INSCorrection ref_INSCorrection
+#define zeros ref_zeros
+
+#include "insgps13state.c"
+
+/**
+ * @}
+ * @}
+ */
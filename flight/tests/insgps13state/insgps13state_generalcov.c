@@ -0,0 +1,65 @@
+/**
+ ******************************************************************************
+ * @file       insgps13state_generalcov.c
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Reference build of the INS with the general covariance prediction
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * The filter keeps its state in file scope variables, so another copy is
+ * built here with every exported symbol prefixed by cov_ and linked next
+ * to the copy under test.
+ */
+
+#define GENERAL_COV
+
+#define ins_get_num_states cov_ins_get_num_states
+#define INSGPSInit cov_INSGPSInit
+#define INSGetState cov_INSGetState
+#define INSGetVariance cov_INSGetVariance
+#define INSResetP cov_INSResetP
+#define INSSetState cov_INSSetState
+#define INSPosVelReset cov_INSPosVelReset
+#define INSSetPosVelVar cov_INSSetPosVelVar
+#define INSSetGyroBias cov_INSSetGyroBias
+#define INSSetAccelVar cov_INSSetAccelVar
+#define INSSetGyroVar cov_INSSetGyroVar
+#define INSSetMagVar cov_INSSetMagVar
+#define INSSetBaroVar cov_INSSetBaroVar
+#define INSSetMagNorth cov_INSSetMagNorth
+#define INSStatePrediction cov_INSStatePrediction
+#define INSCovariancePrediction cov_INSCovariancePrediction
+#define MagCorrection cov_MagCorrection
+#define MagVelBaroCorrection cov_MagVelBaroCorrection
+#define GpsBaroCorrection cov_GpsBaroCorrection
+#define FullCorrection cov_FullCorrection
+#define GpsMagCorrection cov_GpsMagCorrection
+#define VelBaroCorrection cov_VelBaroCorrection
+#define INSCorrection cov_INSCorrection
+#define zeros cov_zeros
+
+#include "insgps13state.c"
+
+/**
+ * @}
+ * @}
+ */
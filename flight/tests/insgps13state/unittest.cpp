@@ -0,0 +1,294 @@
+/**
+ ******************************************************************************
+ * @file       unittest.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Unit test
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * NOTE: This program uses the Google Test infrastructure to drive the unit test
+ *
+ * Main site for Google Test: http://code.google.com/p/googletest/
+ * Documentation and examples: http://code.google.com/p/googletest/wiki/Documentation
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>		/* printf */
+#include <string.h>		/* memcmp */
+#include <stdint.h>		/* uint*_t */
+#include <math.h>		/* sinf */
+#include <time.h>		/* clock */
+
+extern "C" {
+
+#include "insgps.h"
+
+/* The same filter built with the general measurement update (insgps13state_general.c) */
+void ref_INSGPSInit();
+void ref_INSStatePrediction(const float gyro_data[3], const float accel_data[3], float dT);
+void ref_INSCovariancePrediction(float dT);
+void ref_INSCorrection(const float mag_data[3], const float Pos[3], const float Vel[3], float BaroAlt, uint16_t SensorsUsed);
+void ref_INSGetState(float *pos, float *vel, float *attitude, float *bias);
+void ref_INSGetVariance(float *p);
+void ref_INSSetMagNorth(const float B[3]);
+
+/* The same filter built with the general covariance prediction (insgps13state_generalcov.c) */
+void cov_INSGPSInit();
+void cov_INSStatePrediction(const float gyro_data[3], const float accel_data[3], float dT);
+void cov_INSCovariancePrediction(float dT);
+void cov_INSCorrection(const float mag_data[3], const float Pos[3], const float Vel[3], float BaroAlt, uint16_t SensorsUsed);
+void cov_INSGetState(float *pos, float *vel, float *attitude, float *bias);
+void cov_INSGetVariance(float *p);
+void cov_INSSetMagNorth(const float B[3]);
+
+}
+
+#define NUM_STATES 13
+#define DT 0.002f
+
+// To use a test fixture, derive a class from testing::Test.
+class INSGPS : public testing::Test {
+protected:
+  virtual void SetUp() {
+    const float Be[3] = {0.45f, 0.05f, 0.89f};
+
+    INSGPSInit();
+    INSSetMagNorth(Be);
+    ref_INSGPSInit();
+    ref_INSSetMagNorth(Be);
+    cov_INSGPSInit();
+    cov_INSSetMagNorth(Be);
+
+    seed = 12345;
+  }
+
+  virtual void TearDown() {
+  }
+
+  /* Deterministic noise so both builds see the same inputs */
+  float noise(float amplitude) {
+    seed = seed * 1103515245 + 12345;
+    return amplitude * (((seed >> 16) & 0x7fff) / 16384.0f - 1.0f);
+  }
+
+  /* Sensor data for a vehicle slowly circling and rocking */
+  void sensors(int step, float gyro[3], float accel[3], float mag[3], float pos[3], float vel[3], float *baro) {
+    float t = step * DT;
+
+    gyro[0] = 0.3f * sinf(0.7f * t) + noise(0.01f);
+    gyro[1] = 0.2f * cosf(0.5f * t) + noise(0.01f);
+    gyro[2] = 0.1f + noise(0.01f);
+
+    accel[0] = noise(0.2f);
+    accel[1] = noise(0.2f);
+    accel[2] = -9.81f + noise(0.2f);
+
+    mag[0] = 0.45f * cosf(0.1f * t) + noise(0.01f);
+    mag[1] = -0.45f * sinf(0.1f * t) + noise(0.01f);
+    mag[2] = 0.89f + noise(0.01f);
+
+    pos[0] = 20.0f * sinf(0.1f * t) + noise(1.0f);
+    pos[1] = 20.0f * cosf(0.1f * t) + noise(1.0f);
+    pos[2] = -10.0f + noise(2.0f);
+
+    vel[0] = 2.0f * cosf(0.1f * t) + noise(0.1f);
+    vel[1] = -2.0f * sinf(0.1f * t) + noise(0.1f);
+    vel[2] = noise(0.1f);
+
+    *baro = 10.0f + noise(0.5f);
+  }
+
+  /* The sensors fused on a step, like the GPS and baro arriving slower than the mag */
+  uint16_t sensorsUsed(int step) {
+    uint16_t used = MAG_SENSORS;
+    if (step % 5 == 0)
+      used |= BARO_SENSOR;
+    if (step % 20 == 0)
+      used |= POS_SENSORS | HORIZ_SENSORS | VERT_SENSORS;
+    return used;
+  }
+
+  uint32_t seed;
+};
+
+TEST_F(INSGPS, SparseUpdateMatchesGeneral) {
+  float gyro[3], accel[3], mag[3], pos[3], vel[3], baro;
+
+  for (int step = 0; step < 5000; step++) {
+    sensors(step, gyro, accel, mag, pos, vel, &baro);
+    uint16_t used = sensorsUsed(step);
+
+    INSStatePrediction(gyro, accel, DT);
+    INSCovariancePrediction(DT);
+    INSCorrection(mag, pos, vel, baro, used);
+
+    ref_INSStatePrediction(gyro, accel, DT);
+    ref_INSCovariancePrediction(DT);
+    ref_INSCorrection(mag, pos, vel, baro, used);
+
+    float state[4][4], ref_state[4][4];
+    INSGetState(state[0], state[1], state[2], state[3]);
+    ref_INSGetState(ref_state[0], ref_state[1], ref_state[2], ref_state[3]);
+
+    float var[NUM_STATES], ref_var[NUM_STATES];
+    INSGetVariance(var);
+    ref_INSGetVariance(ref_var);
+
+    /* The same non-zero terms are summed in the same order, so bit for bit the same */
+    ASSERT_EQ(0, memcmp(&state[0][0], &ref_state[0][0], 3 * sizeof(float))) << "position differs at step " << step;
+    ASSERT_EQ(0, memcmp(&state[1][0], &ref_state[1][0], 3 * sizeof(float))) << "velocity differs at step " << step;
+    ASSERT_EQ(0, memcmp(&state[2][0], &ref_state[2][0], 4 * sizeof(float))) << "attitude differs at step " << step;
+    ASSERT_EQ(0, memcmp(&state[3][0], &ref_state[3][0], 3 * sizeof(float))) << "gyro bias differs at step " << step;
+    ASSERT_EQ(0, memcmp(var, ref_var, sizeof(var))) << "variance differs at step " << step;
+  }
+}
+
+TEST_F(INSGPS, PackedPredictionMatchesGeneral) {
+  float gyro[3], accel[3], mag[3], pos[3], vel[3], baro;
+
+  for (int step = 0; step < 5000; step++) {
+    sensors(step, gyro, accel, mag, pos, vel, &baro);
+    uint16_t used = sensorsUsed(step);
+
+    INSStatePrediction(gyro, accel, DT);
+    INSCovariancePrediction(DT);
+    INSCorrection(mag, pos, vel, baro, used);
+
+    cov_INSStatePrediction(gyro, accel, DT);
+    cov_INSCovariancePrediction(DT);
+    cov_INSCorrection(mag, pos, vel, baro, used);
+
+    float state[13], cov_state[13];
+    INSGetState(&state[0], &state[3], &state[6], &state[10]);
+    cov_INSGetState(&cov_state[0], &cov_state[3], &cov_state[6], &cov_state[10]);
+
+    float var[NUM_STATES], cov_var[NUM_STATES];
+    INSGetVariance(var);
+    cov_INSGetVariance(cov_var);
+
+    /* The terms are summed in a different order, so only close */
+    for (int i = 0; i < NUM_STATES; i++) {
+      ASSERT_NEAR(cov_state[i], state[i], 1e-4f * (1.0f + fabsf(cov_state[i]))) << "state " << i << " differs at step " << step;
+      ASSERT_NEAR(cov_var[i], var[i], 1e-3f * fabsf(cov_var[i])) << "variance " << i << " differs at step " << step;
+    }
+  }
+}
+
+TEST_F(INSGPS, ResetVariance) {
+  float gyro[3], accel[3], mag[3], pos[3], vel[3], baro;
+
+  /* Build up some correlation between the states first */
+  for (int step = 0; step < 500; step++) {
+    sensors(step, gyro, accel, mag, pos, vel, &baro);
+    INSStatePrediction(gyro, accel, DT);
+    INSCovariancePrediction(DT);
+    INSCorrection(mag, pos, vel, baro, sensorsUsed(step));
+  }
+
+  const float diag[NUM_STATES] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+  float var[NUM_STATES];
+
+  INSResetP(diag);
+  INSGetVariance(var);
+  for (int i = 0; i < NUM_STATES; i++)
+    EXPECT_EQ(diag[i], var[i]);
+
+  /* Only the position and velocity variances go back to their initial values */
+  INSPosVelReset(pos, vel);
+  INSGetVariance(var);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(25.0f, var[i]);
+    EXPECT_EQ(5.0f, var[i + 3]);
+  }
+  for (int i = 6; i < NUM_STATES; i++)
+    EXPECT_EQ(diag[i], var[i]);
+
+  /* With no correlation left the position variance grows by exactly the
+   * velocity variance over a prediction */
+  INSCovariancePrediction(DT);
+  INSGetVariance(var);
+  EXPECT_EQ(5.0f * DT * DT + 25.0f, var[0]);
+}
+
+TEST_F(INSGPS, PredictionBenchmark) {
+  float gyro[3], accel[3], mag[3], pos[3], vel[3], baro;
+  const int iterations = 20000;
+
+  sensors(0, gyro, accel, mag, pos, vel, &baro);
+
+  /* The packed prediction is the one every target builds */
+  clock_t start = clock();
+  for (int i = 0; i < iterations; i++) {
+    INSStatePrediction(gyro, accel, DT);
+    INSCovariancePrediction(DT);
+  }
+  clock_t packed = clock() - start;
+
+  start = clock();
+  for (int i = 0; i < iterations; i++) {
+    cov_INSStatePrediction(gyro, accel, DT);
+    cov_INSCovariancePrediction(DT);
+  }
+  clock_t general = clock() - start;
+
+  printf("Prediction: packed %.2f us, general %.2f us\n",
+         1e6 * packed / CLOCKS_PER_SEC / iterations,
+         1e6 * general / CLOCKS_PER_SEC / iterations);
+
+  float var[NUM_STATES];
+  INSGetVariance(var);
+  for (int i = 0; i < NUM_STATES; i++)
+    EXPECT_TRUE(isfinite(var[i]));
+}
+
+TEST_F(INSGPS, SparseUpdateBenchmark) {
+  float gyro[3], accel[3], mag[3], pos[3], vel[3], baro;
+  const int iterations = 20000;
+
+  sensors(0, gyro, accel, mag, pos, vel, &baro);
+
+  clock_t start = clock();
+  for (int i = 0; i < iterations; i++)
+    INSCorrection(mag, pos, vel, baro, FULL_SENSORS);
+  clock_t sparse = clock() - start;
+
+  start = clock();
+  for (int i = 0; i < iterations; i++)
+    ref_INSCorrection(mag, pos, vel, baro, FULL_SENSORS);
+  clock_t general = clock() - start;
+
+  printf("Full measurement update: sparse %.2f us, general %.2f us\n",
+         1e6 * sparse / CLOCKS_PER_SEC / iterations,
+         1e6 * general / CLOCKS_PER_SEC / iterations);
+
+  /* The filter must still be usable after that many updates */
+  float var[NUM_STATES];
+  INSGetVariance(var);
+  for (int i = 0; i < NUM_STATES; i++)
+    EXPECT_TRUE(isfinite(var[i]));
+}
+
+/**
+ * @}
+ * @}
+ */
@@ -333,6 +333,183 @@ TEST_F(LogfsTestCooked, WriteManyVerify) {
   EXPECT_EQ(0, memcmp(obj3, obj3_check, sizeof(obj3)));
 }
 
+TEST_F(LogfsTestCooked, LoadIsIndexed) {
+  const uint16_t num_objs = (flashfs_config_settings.arena_size / flashfs_config_settings.slot_size) * 3 / 4;
+  unsigned char obj1_check[OBJ1_SIZE];
+  uint32_t reads;
+
+  /* Fill most of the arena with distinct instances, leaving room for gc to make progress */
+  for (uint16_t i = 0; i < num_objs; i++) {
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, i, obj1, sizeof(obj1)));
+  }
+
+  /*
+   * Scanning the log would cost one flash read per slot.  With the index a
+   * load reads the matching slot header and the data, plus the odd header
+   * of a slot whose tag happens to collide.
+   */
+  reads = PIOS_Flash_Posix_GetReadCount(pios_posix_flash_id);
+  for (uint16_t i = 0; i < num_objs; i++) {
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, i, obj1_check, sizeof(obj1_check)));
+  }
+  EXPECT_GE(3U * num_objs, PIOS_Flash_Posix_GetReadCount(pios_posix_flash_id) - reads);
+
+  /* Misses should not walk the log either */
+  reads = PIOS_Flash_Posix_GetReadCount(pios_posix_flash_id);
+  EXPECT_EQ(-3, PIOS_FLASHFS_ObjLoad(fs_id, OBJ2_ID, 0, obj1_check, sizeof(obj1_check)));
+  EXPECT_GE(8U, PIOS_Flash_Posix_GetReadCount(pios_posix_flash_id) - reads);
+
+  /* Keep rewriting a few objects to force garbage collection, the index must follow */
+  for (uint32_t i = 0; i < 1000; i++) {
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, i % 8, (i & 1) ? obj1_alt : obj1, sizeof(obj1)));
+  }
+
+  reads = PIOS_Flash_Posix_GetReadCount(pios_posix_flash_id);
+  for (uint16_t i = 0; i < num_objs; i++) {
+    memset(obj1_check, 0, sizeof(obj1_check));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, i, obj1_check, sizeof(obj1_check)));
+    EXPECT_EQ(0, memcmp(((i < 8) && (i & 1)) ? obj1_alt : obj1, obj1_check, sizeof(obj1)));
+  }
+  EXPECT_GE(3U * num_objs, PIOS_Flash_Posix_GetReadCount(pios_posix_flash_id) - reads);
+
+  /* The index is rebuilt when the filesystem is mounted again */
+  PIOS_FLASHFS_Logfs_Destroy(fs_id);
+  EXPECT_EQ(0, PIOS_FLASHFS_Logfs_Init(&fs_id, &flashfs_config_settings, FLASH_PARTITION_LABEL_SETTINGS));
+
+  reads = PIOS_Flash_Posix_GetReadCount(pios_posix_flash_id);
+  for (uint16_t i = 0; i < num_objs; i++) {
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, i, obj1_check, sizeof(obj1_check)));
+  }
+  EXPECT_GE(3U * num_objs, PIOS_Flash_Posix_GetReadCount(pios_posix_flash_id) - reads);
+
+  /* Deleted objects drop out of the index */
+  EXPECT_EQ(0, PIOS_FLASHFS_ObjDelete(fs_id, OBJ1_ID, 5));
+  EXPECT_EQ(-3, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, 5, obj1_check, sizeof(obj1_check)));
+  EXPECT_EQ(0, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, 6, obj1_check, sizeof(obj1_check)));
+}
+
+TEST_F(LogfsTestCooked, BackgroundGarbageCollect) {
+  const uint16_t num_objs = 64;
+  uint32_t version[num_objs];
+  unsigned char obj1_check[OBJ1_SIZE];
+
+  for (uint16_t i = 0; i < num_objs; i++) {
+    version[i] = 0;
+    memcpy(obj1, &version[i], sizeof(version[i]));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, i, obj1, sizeof(obj1)));
+  }
+
+  /* Keep rewriting objects while the background collects, saves must never erase */
+  for (uint32_t i = 0; i < 2000; i++) {
+    uint16_t inst = (i * 7) % num_objs;
+    version[inst] = i;
+    memcpy(obj1, &version[inst], sizeof(version[inst]));
+
+    uint32_t erases = PIOS_Flash_Posix_GetEraseCount(pios_posix_flash_id);
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, inst, obj1, sizeof(obj1)));
+    EXPECT_EQ(erases, PIOS_Flash_Posix_GetEraseCount(pios_posix_flash_id));
+
+    EXPECT_LE(0, PIOS_FLASHFS_GarbageCollect(fs_id, 4));
+  }
+
+  /* Every object must come back at its latest version */
+  for (uint16_t i = 0; i < num_objs; i++) {
+    memcpy(obj1, &version[i], sizeof(version[i]));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, i, obj1_check, sizeof(obj1_check)));
+    EXPECT_EQ(0, memcmp(obj1, obj1_check, sizeof(obj1)));
+  }
+
+  /* Run the collector until it is idle */
+  int32_t rc;
+  while ((rc = PIOS_FLASHFS_GarbageCollect(fs_id, 4)) == 1) ;
+  EXPECT_EQ(0, rc);
+}
+
+TEST_F(LogfsTestCooked, BackgroundGarbageCollectRemount) {
+  const uint16_t num_objs = 128;
+  uint32_t version[num_objs];
+  unsigned char obj1_check[OBJ1_SIZE];
+
+  for (uint16_t i = 0; i < num_objs; i++) {
+    version[i] = 0;
+    memcpy(obj1, &version[i], sizeof(version[i]));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, i, obj1, sizeof(obj1)));
+  }
+
+  /* Churn until a collection is in progress, then overwrite objects it already copied */
+  for (uint32_t i = 0; i < 120; i++) {
+    uint16_t inst = i % 16;
+    version[inst] = i + 1;
+    memcpy(obj1, &version[inst], sizeof(version[inst]));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, inst, obj1, sizeof(obj1)));
+    EXPECT_LE(0, PIOS_FLASHFS_GarbageCollect(fs_id, 2));
+  }
+
+  /* Losing power half way through a collection must not lose anything */
+  PIOS_FLASHFS_Logfs_Destroy(fs_id);
+  EXPECT_EQ(0, PIOS_FLASHFS_Logfs_Init(&fs_id, &flashfs_config_settings, FLASH_PARTITION_LABEL_SETTINGS));
+
+  for (uint16_t i = 0; i < num_objs; i++) {
+    memcpy(obj1, &version[i], sizeof(version[i]));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, i, obj1_check, sizeof(obj1_check)));
+    EXPECT_EQ(0, memcmp(obj1, obj1_check, sizeof(obj1)));
+  }
+
+  /* The partially filled arena gets erased and reused */
+  for (uint32_t i = 0; i < 1000; i++) {
+    uint16_t inst = i % 16;
+    version[inst] = 1000 + i;
+    memcpy(obj1, &version[inst], sizeof(version[inst]));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, inst, obj1, sizeof(obj1)));
+    EXPECT_LE(0, PIOS_FLASHFS_GarbageCollect(fs_id, 2));
+  }
+
+  for (uint16_t i = 0; i < num_objs; i++) {
+    memcpy(obj1, &version[i], sizeof(version[i]));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, i, obj1_check, sizeof(obj1_check)));
+    EXPECT_EQ(0, memcmp(obj1, obj1_check, sizeof(obj1)));
+  }
+}
+
+TEST_F(LogfsTestCooked, FillLogDuringBackgroundGarbageCollect) {
+  const uint16_t num_objs = 128;
+  uint32_t version[num_objs];
+  unsigned char obj1_check[OBJ1_SIZE];
+
+  for (uint16_t i = 0; i < num_objs; i++) {
+    version[i] = 0;
+    memcpy(obj1, &version[i], sizeof(version[i]));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, i, obj1, sizeof(obj1)));
+  }
+
+  /* Leave less than a quarter of the log free so the background collects */
+  for (uint32_t i = 0; i < 70; i++) {
+    version[0] = i + 1;
+    memcpy(obj1, &version[0], sizeof(version[0]));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, 0, obj1, sizeof(obj1)));
+  }
+
+  /* Erase the next arena and copy part of the log into it */
+  for (uint32_t i = 0; i < 8; i++) {
+    EXPECT_EQ(1, PIOS_FLASHFS_GarbageCollect(fs_id, 4));
+  }
+
+  /* Obsolete the copied slots and keep saving until the log has filled up more than once */
+  for (uint32_t i = 0; i < 300; i++) {
+    uint16_t inst = 1 + (i % 40);
+    version[inst] = 1000 + i;
+    memcpy(obj1, &version[inst], sizeof(version[inst]));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, inst, obj1, sizeof(obj1)));
+  }
+
+  /* No save may lose an object */
+  for (uint16_t i = 0; i < num_objs; i++) {
+    memcpy(obj1, &version[i], sizeof(version[i]));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, i, obj1_check, sizeof(obj1_check)));
+    EXPECT_EQ(0, memcmp(obj1, obj1_check, sizeof(obj1)));
+  }
+}
+
 class LogfsTestCookedMultiPart : public LogfsTestRaw {
 protected:
   virtual void SetUp() {
@@ -19,19 +19,27 @@ const struct flashfs_logfs_cfg flashfs_config_waypoints = {
 	.slot_size     = 0x00000400, /* 256 bytes */
 };
 
+#include "pios_streamfs_priv.h"
+
+const struct streamfs_cfg streamfs_config_log = {
+	.fs_magic      = 0x7c9e2a53,
+	.arena_size    = 0x00010000, /* 64 KB */
+	.write_size    = 0x00000100, /* 256 bytes */
+};
+
 #include "pios_flash_posix_priv.h"
 
 #include "pios_flash_priv.h"
 
 const struct pios_flash_posix_cfg flash_config = {
-	.size_of_flash  = 3 * 1024 * 1024,
+	.size_of_flash  = 4 * 1024 * 1024,
 	.size_of_sector = FLASH_SECTOR_64KB,
 };
 
 static const struct pios_flash_sector_range posix_flash_sectors[] = {
 	{
 		.base_sector = 0,
-		.last_sector = 47,
+		.last_sector = 63,
 		.sector_size = FLASH_SECTOR_64KB,
 	},
 };
@@ -63,6 +71,15 @@ const struct pios_flash_partition pios_flash_partition_table[] = {
 		.chip_offset  = (32 * 64 * 1024),
 		.size         = (47 - 32 + 1) * FLASH_SECTOR_64KB,
 	},
+
+	{
+		.label        = FLASH_PARTITION_LABEL_LOG,
+		.chip_desc    = &pios_flash_chip_posix,
+		.first_sector = 48,
+		.last_sector  = 63,
+		.chip_offset  = (48 * 64 * 1024),
+		.size         = (63 - 48 + 1) * FLASH_SECTOR_64KB,
+	},
 };
 
 uint32_t pios_flash_partition_table_size = NELEMENTS(pios_flash_partition_table);
@@ -0,0 +1,290 @@
+/**
+ ******************************************************************************
+ * @file       unittest.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2013
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Unit test
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * NOTE: This program uses the Google Test infrastructure to drive the unit test
+ *
+ * Main site for Google Test: http://code.google.com/p/googletest/
+ * Documentation and examples: http://code.google.com/p/googletest/wiki/Documentation
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>		/* printf */
+#include <stdlib.h>		/* abort */
+#include <string.h>		/* memset */
+#include <stdint.h>		/* uint*_t */
+#include <deque>		/* std::deque */
+
+extern "C" {
+
+#include "pios.h"
+#include "pios_com_priv.h"
+#include "fifo_buffer.h"
+
+}
+
+#define FIFO_SIZE 64
+#define FIFO_ROUNDS 2000
+
+class FifoBufferTest : public testing::Test {
+protected:
+  virtual void SetUp() {
+    memset(storage, 0, sizeof(storage));
+    fifoBuf_init(&fifo, storage, sizeof(storage));
+  }
+
+  virtual void TearDown() {
+  }
+
+  /* Move the read and write index to pos with an empty buffer */
+  void moveTo(uint16_t pos) {
+    uint8_t data[FIFO_SIZE];
+    memset(data, 0, sizeof(data));
+    EXPECT_EQ(pos, fifoBuf_putData(&fifo, data, pos));
+    EXPECT_EQ(pos, fifoBuf_getData(&fifo, data, pos));
+  }
+
+  uint8_t storage[FIFO_SIZE];
+  t_fifo_buffer fifo;
+};
+
+TEST_F(FifoBufferTest, EmptyBuffer) {
+  uint8_t *ptr;
+
+  /* One byte always stays free to tell a full buffer from an empty one */
+  EXPECT_EQ(FIFO_SIZE - 1, fifoBuf_getWritePtr(&fifo, &ptr));
+  EXPECT_EQ(storage, ptr);
+
+  for (uint8_t i = 0; i < 10; i++)
+    ptr[i] = i + 1;
+  fifoBuf_commitData(&fifo, 10);
+  EXPECT_EQ(10, fifoBuf_getUsed(&fifo));
+
+  uint8_t out[10];
+  EXPECT_EQ(10, fifoBuf_getData(&fifo, out, sizeof(out)));
+  for (uint8_t i = 0; i < 10; i++)
+    EXPECT_EQ(i + 1, out[i]);
+}
+
+TEST_F(FifoBufferTest, StopsAtEndOfBuffer) {
+  uint8_t *ptr;
+
+  moveTo(FIFO_SIZE - 8);
+
+  /* The space before the read index is not contiguous with the end */
+  EXPECT_EQ(8, fifoBuf_getWritePtr(&fifo, &ptr));
+  EXPECT_EQ(&storage[FIFO_SIZE - 8], ptr);
+  EXPECT_EQ(FIFO_SIZE - 1, fifoBuf_getFree(&fifo));
+
+  memset(ptr, 0xA5, 8);
+  fifoBuf_commitData(&fifo, 8);
+  EXPECT_EQ(8, fifoBuf_getUsed(&fifo));
+
+  /* The write index wrapped to the start */
+  EXPECT_EQ(FIFO_SIZE - 8 - 1, fifoBuf_getWritePtr(&fifo, &ptr));
+  EXPECT_EQ(storage, ptr);
+}
+
+TEST_F(FifoBufferTest, StopsBeforeReadIndex) {
+  uint8_t *ptr;
+  uint8_t data[FIFO_SIZE];
+
+  /* Write across the end so that the write index is behind the read index */
+  memset(data, 0, sizeof(data));
+  moveTo(FIFO_SIZE - 8);
+  EXPECT_EQ(20, fifoBuf_putData(&fifo, data, 20));
+
+  EXPECT_EQ(FIFO_SIZE - 20 - 1, fifoBuf_getWritePtr(&fifo, &ptr));
+  EXPECT_EQ(&storage[12], ptr);
+
+  /* Filling it completely leaves the buffer full, not empty */
+  fifoBuf_commitData(&fifo, FIFO_SIZE - 20 - 1);
+  EXPECT_EQ(FIFO_SIZE - 1, fifoBuf_getUsed(&fifo));
+  EXPECT_EQ(0, fifoBuf_getFree(&fifo));
+  EXPECT_EQ(0, fifoBuf_getWritePtr(&fifo, &ptr));
+}
+
+TEST_F(FifoBufferTest, MatchesPutData) {
+  std::deque<uint8_t> model;
+  uint8_t next = 0;
+
+  srand(1234);
+  for (uint32_t round = 0; round < FIFO_ROUNDS; round++) {
+    uint16_t len = rand() % FIFO_SIZE;
+
+    if (rand() & 1) {
+      /* Write in place whatever fits in one piece */
+      uint8_t *ptr;
+      uint16_t avail = fifoBuf_getWritePtr(&fifo, &ptr);
+      ASSERT_LE(avail, fifoBuf_getFree(&fifo));
+      if (len > avail)
+        len = avail;
+      for (uint16_t i = 0; i < len; i++) {
+        ptr[i] = next;
+        model.push_back(next++);
+      }
+      fifoBuf_commitData(&fifo, len);
+    } else {
+      uint8_t out[FIFO_SIZE];
+      len = fifoBuf_getData(&fifo, out, len);
+      for (uint16_t i = 0; i < len; i++) {
+        ASSERT_EQ(model.front(), out[i]);
+        model.pop_front();
+      }
+    }
+
+    ASSERT_EQ(model.size(), fifoBuf_getUsed(&fifo));
+  }
+}
+
+/* A driver that only records what the COM layer asks of it */
+static struct {
+  pios_com_callback tx_out_cb;
+  uintptr_t tx_context;
+  uint32_t tx_starts;
+  uint16_t tx_bytes_avail;
+  bool available;
+} fake_dev;
+
+static void fake_tx_start(uintptr_t /* id */, uint16_t tx_bytes_avail)
+{
+  fake_dev.tx_starts++;
+  fake_dev.tx_bytes_avail = tx_bytes_avail;
+}
+
+static void fake_bind_tx_cb(uintptr_t /* id */, pios_com_callback tx_out_cb, uintptr_t context)
+{
+  fake_dev.tx_out_cb = tx_out_cb;
+  fake_dev.tx_context = context;
+}
+
+static bool fake_available(uintptr_t /* id */)
+{
+  return fake_dev.available;
+}
+
+static const struct pios_com_driver fake_driver = {
+  NULL,
+  NULL,
+  fake_tx_start,
+  NULL,
+  NULL,
+  fake_bind_tx_cb,
+  fake_available,
+};
+
+class PiosComTest : public testing::Test {
+protected:
+  virtual void SetUp() {
+    memset(&fake_dev, 0, sizeof(fake_dev));
+    fake_dev.available = true;
+    ASSERT_EQ(0, PIOS_COM_Init(&com_id, &fake_driver, 0, NULL, 0, tx_buffer, sizeof(tx_buffer)));
+  }
+
+  virtual void TearDown() {
+  }
+
+  /* Take everything out of the TX buffer like the driver's interrupt would */
+  uint16_t drain(uint8_t *out, uint16_t len) {
+    uint16_t headroom;
+    bool need_yield;
+    return fake_dev.tx_out_cb(fake_dev.tx_context, out, len, &headroom, &need_yield);
+  }
+
+  uintptr_t com_id;
+  uint8_t tx_buffer[FIFO_SIZE];
+};
+
+TEST_F(PiosComTest, ReserveAndCommit) {
+  uint8_t *ptr = PIOS_COM_ReserveTxBuffer(com_id, 10);
+  ASSERT_TRUE(ptr != NULL);
+  for (uint8_t i = 0; i < 10; i++)
+    ptr[i] = 0x10 + i;
+
+  /* Committed without a kick the driver is left alone */
+  EXPECT_EQ(10, PIOS_COM_CommitTxBuffer(com_id, 10, false));
+  EXPECT_EQ(0U, fake_dev.tx_starts);
+
+  ptr = PIOS_COM_ReserveTxBuffer(com_id, 5);
+  ASSERT_TRUE(ptr != NULL);
+  memset(ptr, 0x77, 5);
+  EXPECT_EQ(5, PIOS_COM_CommitTxBuffer(com_id, 5, true));
+  EXPECT_EQ(1U, fake_dev.tx_starts);
+  EXPECT_EQ(15, fake_dev.tx_bytes_avail);
+
+  uint8_t out[FIFO_SIZE];
+  ASSERT_EQ(15, drain(out, sizeof(out)));
+  for (uint8_t i = 0; i < 10; i++)
+    EXPECT_EQ(0x10 + i, out[i]);
+  for (uint8_t i = 10; i < 15; i++)
+    EXPECT_EQ(0x77, out[i]);
+}
+
+TEST_F(PiosComTest, OrderWithSendBuffer) {
+  const uint8_t first[] = { 1, 2, 3 };
+  const uint8_t last[] = { 7, 8 };
+
+  EXPECT_EQ(3, PIOS_COM_SendBufferNonBlocking(com_id, first, sizeof(first)));
+  uint8_t *ptr = PIOS_COM_ReserveTxBuffer(com_id, 3);
+  ASSERT_TRUE(ptr != NULL);
+  ptr[0] = 4;
+  ptr[1] = 5;
+  ptr[2] = 6;
+  EXPECT_EQ(3, PIOS_COM_CommitTxBuffer(com_id, 3, false));
+  EXPECT_EQ(2, PIOS_COM_SendBufferNonBlocking(com_id, last, sizeof(last)));
+
+  uint8_t out[FIFO_SIZE];
+  ASSERT_EQ(8, drain(out, sizeof(out)));
+  for (uint8_t i = 0; i < 8; i++)
+    EXPECT_EQ(i + 1, out[i]);
+}
+
+TEST_F(PiosComTest, NoContiguousSpace) {
+  uint8_t data[FIFO_SIZE];
+
+  /* Leave the indexes near the end of the buffer */
+  memset(data, 0, sizeof(data));
+  EXPECT_EQ(FIFO_SIZE - 8, PIOS_COM_SendBufferNonBlocking(com_id, data, FIFO_SIZE - 8));
+  EXPECT_EQ(FIFO_SIZE - 8, drain(data, FIFO_SIZE - 8));
+
+  /* Plenty of room in total but only 8 bytes in one piece */
+  EXPECT_TRUE(PIOS_COM_ReserveTxBuffer(com_id, 9) == NULL);
+  EXPECT_TRUE(PIOS_COM_ReserveTxBuffer(com_id, 8) != NULL);
+}
+
+TEST_F(PiosComTest, Unavailable) {
+  fake_dev.available = false;
+  EXPECT_TRUE(PIOS_COM_ReserveTxBuffer(com_id, 1) == NULL);
+}
+
+TEST_F(PiosComTest, InvalidPort) {
+  uint32_t bogus = 0;
+
+  EXPECT_TRUE(PIOS_COM_ReserveTxBuffer(0, 1) == NULL);
+  EXPECT_TRUE(PIOS_COM_ReserveTxBuffer((uintptr_t)&bogus, 1) == NULL);
+  EXPECT_EQ(-1, PIOS_COM_CommitTxBuffer(0, 1, true));
+}
@@ -0,0 +1,16 @@
+/*
+ * Minimal stand-ins for the PiOS services used by the COM layer
+ */
+
+#include "pios.h"
+#include "pios_delay.h"
+
+void * PIOS_malloc(size_t size)
+{
+	return malloc(size);
+}
+
+int32_t PIOS_DELAY_WaitmS(uint32_t mS)
+{
+	return 0;
+}
@@ -0,0 +1,17 @@
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#define pvPortMalloc(xSize) (malloc(xSize))
+#define vPortFree(pv) (free(pv))
+
+typedef long portBASE_TYPE;
+typedef uint32_t portTickType;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define portTICK_RATE_MS 1
+
+#endif /* FREERTOS_H */
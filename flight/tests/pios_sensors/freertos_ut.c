@@ -0,0 +1,87 @@
+/*
+ * Minimal FreeRTOS semaphore and tick emulation on top of pthreads, enough
+ * to run the PIOS_SENSORS sample rings on the host.
+ */
+
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+struct ut_semaphore {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int given;
+};
+
+xSemaphoreHandle ut_semaphore_create_binary(void)
+{
+	struct ut_semaphore *sema = malloc(sizeof(*sema));
+
+	if (sema == NULL)
+		return NULL;
+
+	pthread_mutex_init(&sema->lock, NULL);
+	pthread_cond_init(&sema->cond, NULL);
+
+	// FreeRTOS creates binary semaphores given
+	sema->given = 1;
+
+	return sema;
+}
+
+portBASE_TYPE xSemaphoreTake(xSemaphoreHandle sema, portTickType ticks)
+{
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += ticks / 1000;
+	deadline.tv_nsec += (ticks % 1000) * 1000000L;
+	if (deadline.tv_nsec >= 1000000000L) {
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000L;
+	}
+
+	pthread_mutex_lock(&sema->lock);
+	while (!sema->given) {
+		if (pthread_cond_timedwait(&sema->cond, &sema->lock, &deadline) == ETIMEDOUT)
+			break;
+	}
+	portBASE_TYPE result = sema->given ? pdTRUE : pdFALSE;
+	sema->given = 0;
+	pthread_mutex_unlock(&sema->lock);
+
+	return result;
+}
+
+portBASE_TYPE xSemaphoreGive(xSemaphoreHandle sema)
+{
+	pthread_mutex_lock(&sema->lock);
+	portBASE_TYPE result = sema->given ? pdFALSE : pdTRUE;
+	sema->given = 1;
+	pthread_cond_signal(&sema->cond);
+	pthread_mutex_unlock(&sema->lock);
+
+	return result;
+}
+
+portBASE_TYPE xSemaphoreGiveFromISR(xSemaphoreHandle sema, portBASE_TYPE *woken)
+{
+	*woken = pdTRUE;
+	return xSemaphoreGive(sema);
+}
+
+portTickType xTaskGetTickCount(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+portBASE_TYPE xQueueSendToBack(xQueueHandle queue, const void *item, portTickType ticks)
+{
+	return pdFALSE;
+}
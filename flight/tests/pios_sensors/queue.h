@@ -0,0 +1,8 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+typedef void * xQueueHandle;
+
+portBASE_TYPE xQueueSendToBack(xQueueHandle queue, const void *item, portTickType ticks);
+
+#endif /* QUEUE_H */
@@ -0,0 +1,15 @@
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include "queue.h"
+
+typedef struct ut_semaphore * xSemaphoreHandle;
+
+xSemaphoreHandle ut_semaphore_create_binary(void);
+portBASE_TYPE xSemaphoreTake(xSemaphoreHandle sema, portTickType ticks);
+portBASE_TYPE xSemaphoreGive(xSemaphoreHandle sema);
+portBASE_TYPE xSemaphoreGiveFromISR(xSemaphoreHandle sema, portBASE_TYPE *woken);
+
+#define vSemaphoreCreateBinary(sema) ((sema) = ut_semaphore_create_binary())
+
+#endif /* SEMAPHORE_H */
@@ -0,0 +1,6 @@
+#ifndef TASK_H
+#define TASK_H
+
+portTickType xTaskGetTickCount(void);
+
+#endif /* TASK_H */
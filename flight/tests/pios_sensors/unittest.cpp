@@ -0,0 +1,256 @@
+/**
+ ******************************************************************************
+ * @file       unittest.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2013
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Unit test
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * NOTE: This program uses the Google Test infrastructure to drive the unit test
+ *
+ * Main site for Google Test: http://code.google.com/p/googletest/
+ * Documentation and examples: http://code.google.com/p/googletest/wiki/Documentation
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>		/* printf */
+#include <stdlib.h>		/* abort */
+#include <string.h>		/* memset */
+#include <stdint.h>		/* uint*_t */
+#include <pthread.h>		/* pthread_create */
+#include <unistd.h>		/* usleep */
+
+extern "C" {
+
+#include "pios_sensors.h"	/* API for the sensor sample rings */
+
+}
+
+// To use a test fixture, derive a class from testing::Test.
+class SensorsRing : public testing::Test {
+protected:
+  virtual void SetUp() {
+    PIOS_SENSORS_Init();
+  }
+
+  virtual void TearDown() {
+  }
+};
+
+TEST_F(SensorsRing, CreateNeedsPowerOfTwo) {
+  EXPECT_TRUE(NULL == PIOS_SENSORS_CreateRing(sizeof(uint32_t), 0));
+  EXPECT_TRUE(NULL == PIOS_SENSORS_CreateRing(sizeof(uint32_t), 1));
+  EXPECT_TRUE(NULL == PIOS_SENSORS_CreateRing(sizeof(uint32_t), 6));
+  EXPECT_TRUE(NULL != PIOS_SENSORS_CreateRing(sizeof(uint32_t), 2));
+  EXPECT_TRUE(NULL != PIOS_SENSORS_CreateRing(sizeof(uint32_t), 8));
+};
+
+TEST_F(SensorsRing, TapCountsOverruns) {
+  struct pios_sensor_gyro_data sample = { 1.0f, 2.0f, 3.0f, 25.0f };
+  int tap_queue;
+
+  /* Without a tap nothing is dropped */
+  PIOS_SENSORS_Tap(PIOS_SENSOR_GYRO, &sample);
+  EXPECT_EQ(0U, PIOS_SENSORS_GetTapOverruns(PIOS_SENSOR_GYRO));
+
+  /* The queue mock is always full */
+  EXPECT_EQ(0, PIOS_SENSORS_SetTap(PIOS_SENSOR_GYRO, &tap_queue));
+  for (int i = 0; i < 3; i++)
+    PIOS_SENSORS_Tap(PIOS_SENSOR_GYRO, &sample);
+  EXPECT_EQ(3U, PIOS_SENSORS_GetTapOverruns(PIOS_SENSOR_GYRO));
+  EXPECT_EQ(0U, PIOS_SENSORS_GetTapOverruns(PIOS_SENSOR_ACCEL));
+
+  EXPECT_EQ(0, PIOS_SENSORS_SetTap(PIOS_SENSOR_GYRO, NULL));
+  PIOS_SENSORS_Tap(PIOS_SENSOR_GYRO, &sample);
+  EXPECT_EQ(3U, PIOS_SENSORS_GetTapOverruns(PIOS_SENSOR_GYRO));
+}
+
+TEST_F(SensorsRing, Register) {
+  struct pios_sensors_ring *ring = PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_gyro_data), 8);
+  ASSERT_TRUE(NULL != ring);
+
+  EXPECT_TRUE(NULL == PIOS_SENSORS_GetRing(PIOS_SENSOR_GYRO));
+  EXPECT_EQ(0, PIOS_SENSORS_RegisterRing(PIOS_SENSOR_GYRO, ring));
+  EXPECT_EQ(ring, PIOS_SENSORS_GetRing(PIOS_SENSOR_GYRO));
+
+  // Only one ring per sensor type
+  EXPECT_EQ(-1, PIOS_SENSORS_RegisterRing(PIOS_SENSOR_GYRO, ring));
+  EXPECT_EQ(-1, PIOS_SENSORS_RegisterRing(PIOS_SENSOR_LAST, ring));
+  EXPECT_EQ(-1, PIOS_SENSORS_RegisterRing(PIOS_SENSOR_ACCEL, NULL));
+  EXPECT_TRUE(NULL == PIOS_SENSORS_GetRing(PIOS_SENSOR_ACCEL));
+};
+
+TEST_F(SensorsRing, PushPopInOrder) {
+  struct pios_sensors_ring *ring = PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_gyro_data), 8);
+  ASSERT_TRUE(NULL != ring);
+
+  struct pios_sensor_gyro_data in, out;
+  EXPECT_FALSE(PIOS_SENSORS_Pop(ring, &out));
+
+  for (int i = 0; i < 5; i++) {
+    in.x = i; in.y = -i; in.z = 2 * i; in.temperature = 25;
+    EXPECT_TRUE(PIOS_SENSORS_Push(ring, &in));
+  }
+
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(PIOS_SENSORS_Pop(ring, &out));
+    EXPECT_EQ(i, out.x);
+    EXPECT_EQ(-i, out.y);
+    EXPECT_EQ(2 * i, out.z);
+    EXPECT_EQ(25, out.temperature);
+  }
+  EXPECT_FALSE(PIOS_SENSORS_Pop(ring, &out));
+};
+
+TEST_F(SensorsRing, PopAverage) {
+  struct pios_sensors_ring *ring = PIOS_SENSORS_CreateRing(sizeof(struct pios_sensor_accel_data), 8);
+  ASSERT_TRUE(NULL != ring);
+
+  struct pios_sensor_accel_data in, average = {1, 2, 3, 4};
+
+  // Without a registered ring or samples the average is left alone
+  EXPECT_EQ(0U, PIOS_SENSORS_PopAverage(PIOS_SENSOR_ACCEL, &average));
+  ASSERT_EQ(0, PIOS_SENSORS_RegisterRing(PIOS_SENSOR_ACCEL, ring));
+  EXPECT_EQ(0U, PIOS_SENSORS_PopAverage(PIOS_SENSOR_ACCEL, &average));
+  EXPECT_EQ(1, average.x);
+  EXPECT_EQ(4, average.temperature);
+
+  for (int i = 0; i < 4; i++) {
+    in.x = i; in.y = -2 * i; in.z = 10; in.temperature = 20 + i;
+    ASSERT_TRUE(PIOS_SENSORS_Push(ring, &in));
+  }
+
+  EXPECT_EQ(4U, PIOS_SENSORS_PopAverage(PIOS_SENSOR_ACCEL, &average));
+  EXPECT_FLOAT_EQ(1.5f, average.x);
+  EXPECT_FLOAT_EQ(-3.0f, average.y);
+  EXPECT_FLOAT_EQ(10.0f, average.z);
+  EXPECT_FLOAT_EQ(21.5f, average.temperature);
+
+  // Every sample was taken
+  EXPECT_FALSE(PIOS_SENSORS_Pop(ring, &in));
+};
+
+TEST_F(SensorsRing, FullDropsNewest) {
+  struct pios_sensors_ring *ring = PIOS_SENSORS_CreateRing(sizeof(uint32_t), 4);
+  ASSERT_TRUE(NULL != ring);
+  ASSERT_EQ(0, PIOS_SENSORS_RegisterRing(PIOS_SENSOR_ACCEL, ring));
+
+  bool woken = false;
+  for (uint32_t i = 0; i < 10; i++)
+    EXPECT_EQ(i < 4, PIOS_SENSORS_PushFromISR(ring, &i, &woken));
+  EXPECT_TRUE(woken);
+
+  EXPECT_EQ(6u, PIOS_SENSORS_GetOverruns(PIOS_SENSOR_ACCEL));
+  EXPECT_EQ(0u, PIOS_SENSORS_GetOverruns(PIOS_SENSOR_GYRO));
+
+  uint32_t out;
+  for (uint32_t i = 0; i < 4; i++) {
+    ASSERT_TRUE(PIOS_SENSORS_Pop(ring, &out));
+    EXPECT_EQ(i, out);
+  }
+  EXPECT_FALSE(PIOS_SENSORS_Pop(ring, &out));
+};
+
+TEST_F(SensorsRing, IndexWrap) {
+  // Run the free running indices through their overflow
+  struct pios_sensors_ring *ring = PIOS_SENSORS_CreateRing(sizeof(uint32_t), 8);
+  ASSERT_TRUE(NULL != ring);
+
+  uint32_t out;
+  for (uint32_t i = 0; i < 200000; i += 3) {
+    for (uint32_t j = i; j < i + 3; j++)
+      ASSERT_TRUE(PIOS_SENSORS_Push(ring, &j));
+    for (uint32_t j = i; j < i + 3; j++) {
+      ASSERT_TRUE(PIOS_SENSORS_Pop(ring, &out));
+      ASSERT_EQ(j, out);
+    }
+  }
+  EXPECT_FALSE(PIOS_SENSORS_Pop(ring, &out));
+};
+
+TEST_F(SensorsRing, WaitTimesOut) {
+  struct pios_sensors_ring *ring = PIOS_SENSORS_CreateRing(sizeof(uint32_t), 8);
+  ASSERT_TRUE(NULL != ring);
+
+  EXPECT_FALSE(PIOS_SENSORS_WaitRing(ring, 0));
+  EXPECT_FALSE(PIOS_SENSORS_WaitRing(ring, 5));
+
+  uint32_t sample = 42;
+  PIOS_SENSORS_Push(ring, &sample);
+  EXPECT_TRUE(PIOS_SENSORS_WaitRing(ring, 0));
+
+  // A stale wake up from a sample that was already read is not data
+  ASSERT_TRUE(PIOS_SENSORS_Pop(ring, &sample));
+  EXPECT_FALSE(PIOS_SENSORS_WaitRing(ring, 5));
+};
+
+struct producer_args {
+  struct pios_sensors_ring *ring;
+  uint32_t count;
+};
+
+static void *producer(void *arg)
+{
+  struct producer_args *args = (struct producer_args *) arg;
+
+  for (uint32_t i = 1; i <= args->count; i++) {
+    bool woken = false;
+    PIOS_SENSORS_PushFromISR(args->ring, &i, &woken);
+    if ((i & 0x3ff) == 0)
+      usleep(100);
+  }
+
+  return NULL;
+}
+
+TEST_F(SensorsRing, ConcurrentProducer) {
+  // Every sample is either delivered in order or counted as an overrun
+  struct pios_sensors_ring *ring = PIOS_SENSORS_CreateRing(sizeof(uint32_t), 16);
+  ASSERT_TRUE(NULL != ring);
+  ASSERT_EQ(0, PIOS_SENSORS_RegisterRing(PIOS_SENSOR_GYRO, ring));
+
+  struct producer_args args = { ring, 500000 };
+  pthread_t thread;
+  ASSERT_EQ(0, pthread_create(&thread, NULL, producer, &args));
+
+  uint32_t received = 0;
+  uint32_t last = 0;
+  uint32_t sample;
+  while (last < args.count && PIOS_SENSORS_WaitRing(ring, 100)) {
+    while (PIOS_SENSORS_Pop(ring, &sample)) {
+      ASSERT_GT(sample, last);
+      last = sample;
+      received++;
+    }
+  }
+
+  pthread_join(thread, NULL);
+  while (PIOS_SENSORS_Pop(ring, &sample)) {
+    ASSERT_GT(sample, last);
+    last = sample;
+    received++;
+  }
+
+  EXPECT_EQ(args.count, received + PIOS_SENSORS_GetOverruns(PIOS_SENSOR_GYRO));
+  EXPECT_LT(0u, received);
+};
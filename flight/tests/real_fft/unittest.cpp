@@ -0,0 +1,158 @@
+/**
+ ******************************************************************************
+ * @file       unittest.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Unit test
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * NOTE: This program uses the Google Test infrastructure to drive the unit test
+ *
+ * Main site for Google Test: http://code.google.com/p/googletest/
+ * Documentation and examples: http://code.google.com/p/googletest/wiki/Documentation
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>		/* printf */
+#include <stdlib.h>		/* abort */
+#include <string.h>		/* memset */
+#include <stdint.h>		/* uint*_t */
+
+extern "C" {
+
+#include "real_fft.h"		/* API for real FFT functions */
+
+}
+
+#include <math.h>		/* fabs() */
+
+#define MAX_FFT_LENGTH 512
+
+// To use a test fixture, derive a class from testing::Test.
+class RealFFT : public testing::Test {
+protected:
+  virtual void SetUp() {
+    srand(1234);
+  }
+
+  virtual void TearDown() {
+  }
+
+  // Power of the first n/2 bins computed straight from the DFT definition
+  void dftPower(const float *in, double *power, uint16_t n) {
+    for (int k = 0; k < n / 2; k++) {
+      double re = 0, im = 0;
+      for (int i = 0; i < n; i++) {
+        re += in[i] * cos(2 * M_PI * k * i / n);
+        im -= in[i] * sin(2 * M_PI * k * i / n);
+      }
+      power[k] = re * re + im * im;
+    }
+  }
+
+  // Largest difference to the DFT, relative to the largest bin
+  double maxError(const float *in, uint16_t n) {
+    float twiddle[MAX_FFT_LENGTH];
+    float buf[MAX_FFT_LENGTH];
+    float power[MAX_FFT_LENGTH / 2];
+    double expected[MAX_FFT_LENGTH / 2];
+
+    real_fft_init_twiddle(twiddle, n);
+    memset(power, 0, sizeof(power));
+    real_fft_power(in, power, buf, twiddle, n);
+    dftPower(in, expected, n);
+
+    double peak = 0;
+    for (int k = 0; k < n / 2; k++)
+      peak = fmax(peak, expected[k]);
+
+    double error = 0;
+    for (int k = 0; k < n / 2; k++)
+      error = fmax(error, fabs(power[k] - expected[k]));
+    return error / peak;
+  }
+
+  float in[MAX_FFT_LENGTH];
+};
+
+TEST_F(RealFFT, MatchesDFTRandom) {
+  for (uint16_t n = 4; n <= MAX_FFT_LENGTH; n <<= 1) {
+    for (int i = 0; i < n; i++)
+      in[i] = 2.0f * rand() / RAND_MAX - 1;
+    EXPECT_LT(maxError(in, n), 1e-6) << "length " << n;
+  }
+}
+
+TEST_F(RealFFT, MatchesDFTSines) {
+  // A sine on a bin, one between bins and an offset
+  const uint16_t n = 256;
+  for (int i = 0; i < n; i++)
+    in[i] = 0.3f + sinf(2 * M_PI * 10 * i / n) + 0.5f * cosf(2 * M_PI * 37.5f * i / n);
+  EXPECT_LT(maxError(in, n), 1e-6);
+}
+
+TEST_F(RealFFT, SineInOneBin) {
+  const uint16_t n = 128;
+  float twiddle[n];
+  float buf[n];
+  float power[n / 2];
+
+  for (int i = 0; i < n; i++)
+    in[i] = sinf(2 * M_PI * 5 * i / n);
+
+  real_fft_init_twiddle(twiddle, n);
+  memset(power, 0, sizeof(power));
+  real_fft_power(in, power, buf, twiddle, n);
+
+  // All power in bin 5, with magnitude n/2
+  for (int k = 0; k < n / 2; k++) {
+    if (k == 5)
+      EXPECT_NEAR(n / 2, sqrtf(power[k]), 1e-3);
+    else
+      EXPECT_NEAR(0, sqrtf(power[k]), 1e-3);
+  }
+}
+
+TEST_F(RealFFT, AddsToPowerAndKeepsInput) {
+  const uint16_t n = 64;
+  float twiddle[n];
+  float buf[n];
+  float once[n / 2];
+  float twice[n / 2];
+  float copy[n];
+
+  for (int i = 0; i < n; i++)
+    in[i] = 2.0f * rand() / RAND_MAX - 1;
+  memcpy(copy, in, sizeof(copy));
+
+  real_fft_init_twiddle(twiddle, n);
+  memset(once, 0, sizeof(once));
+  memset(twice, 0, sizeof(twice));
+  real_fft_power(in, once, buf, twiddle, n);
+  real_fft_power(in, twice, buf, twiddle, n);
+  real_fft_power(in, twice, buf, twiddle, n);
+
+  EXPECT_EQ(0, memcmp(copy, in, sizeof(copy)));
+  for (int k = 0; k < n / 2; k++)
+    EXPECT_FLOAT_EQ(2 * once[k], twice[k]);
+}
@@ -0,0 +1,7 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* Would be from the board's pios_board.h */
+#define RS_ECC_NPARITY 4
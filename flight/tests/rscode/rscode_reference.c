@@ -0,0 +1,319 @@
+/**
+ ******************************************************************************
+ * @file       rscode_reference.c
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Reference copy of the original rscode encoder and decoder
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * This is the codec from Henry Minsky's rscode library as it was used by
+ * the RFM22B driver before the table driven rewrite: polynomials of
+ * MAXDEG ints, gmult() calls everywhere and a Chien search over the whole
+ * field. The galois tables are generated from the field polynomial rather
+ * than copied so they cross check the constant tables in galois.c.
+ */
+
+#include <openpilot.h>
+#include "rscode_reference.h"
+
+#define NPAR RS_ECC_NPARITY
+#define MAXDEG (NPAR*2)
+
+static int gexp[512];
+static int glog[256];
+
+static int pBytes[MAXDEG];
+static int synBytes[MAXDEG];
+static int genPoly[MAXDEG*2];
+
+static int Lambda[MAXDEG];
+static int Omega[MAXDEG];
+static int ErrorLocs[256];
+static int NErrors;
+
+static void init_exp_table(void)
+{
+	int i, z;
+	int pinit, p1, p2, p3, p4, p5, p6, p7, p8;
+
+	pinit = p2 = p3 = p4 = p5 = p6 = p7 = p8 = 0;
+	p1 = 1;
+
+	gexp[0] = 1;
+	gexp[255] = gexp[0];
+	glog[0] = 0;
+
+	for (i = 1; i < 256; i++) {
+		pinit = p8;
+		p8 = p7;
+		p7 = p6;
+		p6 = p5;
+		p5 = p4 ^ pinit;
+		p4 = p3 ^ pinit;
+		p3 = p2 ^ pinit;
+		p2 = p1;
+		p1 = pinit;
+		gexp[i] = p1 + p2*2 + p3*4 + p4*8 + p5*16 + p6*32 + p7*64 + p8*128;
+		gexp[i+255] = gexp[i];
+	}
+	gexp[511] = 0;
+
+	for (i = 1; i < 256; i++) {
+		for (z = 0; z < 256; z++) {
+			if (gexp[z] == i) {
+				glog[i] = z;
+				break;
+			}
+		}
+	}
+}
+
+static int gmult(int a, int b)
+{
+	if (a == 0 || b == 0)
+		return 0;
+	return gexp[glog[a] + glog[b]];
+}
+
+static int ginv(int elt)
+{
+	return gexp[255 - glog[elt]];
+}
+
+static void zero_poly(int poly[])
+{
+	for (int i = 0; i < MAXDEG; i++)
+		poly[i] = 0;
+}
+
+static void copy_poly(int dst[], int src[])
+{
+	for (int i = 0; i < MAXDEG; i++)
+		dst[i] = src[i];
+}
+
+static void mul_z_poly(int src[])
+{
+	for (int i = MAXDEG-1; i > 0; i--)
+		src[i] = src[i-1];
+	src[0] = 0;
+}
+
+static void mult_polys(int dst[], int p1[], int p2[])
+{
+	int i, j;
+	int tmp1[MAXDEG*2];
+
+	for (i = 0; i < (MAXDEG*2); i++)
+		dst[i] = 0;
+
+	for (i = 0; i < MAXDEG; i++) {
+		for (j = MAXDEG; j < (MAXDEG*2); j++)
+			tmp1[j] = 0;
+		for (j = 0; j < MAXDEG; j++)
+			tmp1[j] = gmult(p2[j], p1[i]);
+		for (j = (MAXDEG*2)-1; j >= i; j--)
+			tmp1[j] = tmp1[j-i];
+		for (j = 0; j < i; j++)
+			tmp1[j] = 0;
+		for (j = 0; j < (MAXDEG*2); j++)
+			dst[j] ^= tmp1[j];
+	}
+}
+
+void ref_initialize_ecc(void)
+{
+	int i, tp[MAXDEG], tp1[MAXDEG];
+
+	init_exp_table();
+
+	zero_poly(tp1);
+	tp1[0] = 1;
+	for (i = 1; i <= NPAR; i++) {
+		zero_poly(tp);
+		tp[0] = gexp[i];
+		tp[1] = 1;
+		mult_polys(genPoly, tp, tp1);
+		copy_poly(tp1, genPoly);
+	}
+}
+
+int ref_gexp(int i)
+{
+	return gexp[i];
+}
+
+int ref_glog(int i)
+{
+	return glog[i];
+}
+
+void ref_encode_data(unsigned char msg[], int nbytes, unsigned char dst[])
+{
+	int i, LFSR[NPAR+1], dbyte, j;
+
+	for (i = 0; i < NPAR+1; i++)
+		LFSR[i] = 0;
+
+	for (i = 0; i < nbytes; i++) {
+		dbyte = msg[i] ^ LFSR[NPAR-1];
+		for (j = NPAR-1; j > 0; j--)
+			LFSR[j] = LFSR[j-1] ^ gmult(genPoly[j], dbyte);
+		LFSR[0] = gmult(genPoly[0], dbyte);
+	}
+
+	for (i = 0; i < NPAR; i++)
+		pBytes[i] = LFSR[i];
+
+	for (i = 0; i < nbytes; i++)
+		dst[i] = msg[i];
+	for (i = 0; i < NPAR; i++)
+		dst[i+nbytes] = pBytes[NPAR-1-i];
+}
+
+void ref_decode_data(unsigned char data[], int nbytes)
+{
+	int i, j, sum;
+	for (j = 0; j < NPAR; j++) {
+		sum = 0;
+		for (i = 0; i < nbytes; i++)
+			sum = data[i] ^ gmult(gexp[j+1], sum);
+		synBytes[j] = sum;
+	}
+}
+
+int ref_syndrome(int j)
+{
+	return synBytes[j];
+}
+
+int ref_check_syndrome(void)
+{
+	for (int i = 0; i < NPAR; i++)
+		if (synBytes[i] != 0)
+			return 1;
+	return 0;
+}
+
+static int compute_discrepancy(int lambda[], int S[], int L, int n)
+{
+	int i, sum = 0;
+	for (i = 0; i <= L; i++)
+		sum ^= gmult(lambda[i], S[n-i]);
+	return sum;
+}
+
+/* Erasures are not used by the radio so the reference leaves them out */
+static void Modified_Berlekamp_Massey(void)
+{
+	int n, L, L2, k, d, i;
+	int psi[MAXDEG], psi2[MAXDEG], D[MAXDEG];
+	int product[MAXDEG*2];
+
+	zero_poly(psi);
+	psi[0] = 1;
+	copy_poly(D, psi);
+	mul_z_poly(D);
+
+	k = -1; L = 0;
+
+	for (n = 0; n < NPAR; n++) {
+		d = compute_discrepancy(psi, synBytes, L, n);
+		if (d != 0) {
+			for (i = 0; i < MAXDEG; i++)
+				psi2[i] = psi[i] ^ gmult(d, D[i]);
+			if (L < (n-k)) {
+				L2 = n-k;
+				k = n-L;
+				for (i = 0; i < MAXDEG; i++)
+					D[i] = gmult(psi[i], ginv(d));
+				L = L2;
+			}
+			for (i = 0; i < MAXDEG; i++)
+				psi[i] = psi2[i];
+		}
+		mul_z_poly(D);
+	}
+
+	for (i = 0; i < MAXDEG; i++)
+		Lambda[i] = psi[i];
+
+	mult_polys(product, Lambda, synBytes);
+	zero_poly(Omega);
+	for (i = 0; i < NPAR; i++)
+		Omega[i] = product[i];
+}
+
+static void Find_Roots(void)
+{
+	int sum, r, k;
+	NErrors = 0;
+
+	for (r = 1; r < 256; r++) {
+		sum = 0;
+		for (k = 0; k < NPAR+1; k++)
+			sum ^= gmult(gexp[(k*r)%255], Lambda[k]);
+		if (sum == 0) {
+			ErrorLocs[NErrors] = (255-r);
+			NErrors++;
+		}
+	}
+}
+
+int ref_correct_errors(unsigned char codeword[], int csize)
+{
+	int r, i, j, err;
+
+	Modified_Berlekamp_Massey();
+	Find_Roots();
+
+	if ((NErrors <= NPAR) && NErrors > 0) {
+		for (r = 0; r < NErrors; r++) {
+			if (ErrorLocs[r] >= csize)
+				return 0;
+		}
+
+		for (r = 0; r < NErrors; r++) {
+			int num, denom;
+			i = ErrorLocs[r];
+
+			num = 0;
+			for (j = 0; j < MAXDEG; j++)
+				num ^= gmult(Omega[j], gexp[((255-i)*j)%255]);
+
+			denom = 0;
+			for (j = 1; j < MAXDEG; j += 2)
+				denom ^= gmult(Lambda[j], gexp[((255-i)*(j-1)) % 255]);
+
+			err = gmult(num, ginv(denom));
+			codeword[csize-i-1] ^= err;
+		}
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @}
+ * @}
+ */
@@ -0,0 +1,44 @@
+/**
+ ******************************************************************************
+ * @file       rscode_reference.h
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Reference copy of the original rscode encoder and decoder
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef RSCODE_REFERENCE_H
+#define RSCODE_REFERENCE_H
+
+void ref_initialize_ecc(void);
+int ref_gexp(int i);
+int ref_glog(int i);
+void ref_encode_data(unsigned char msg[], int nbytes, unsigned char dst[]);
+void ref_decode_data(unsigned char data[], int nbytes);
+int ref_syndrome(int j);
+int ref_check_syndrome(void);
+int ref_correct_errors(unsigned char codeword[], int csize);
+
+#endif /* RSCODE_REFERENCE_H */
+
+/**
+ * @}
+ * @}
+ */
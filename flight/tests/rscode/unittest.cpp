@@ -0,0 +1,256 @@
+/**
+ ******************************************************************************
+ * @file       unittest.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Unit test
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * NOTE: This program uses the Google Test infrastructure to drive the unit test
+ *
+ * Main site for Google Test: http://code.google.com/p/googletest/
+ * Documentation and examples: http://code.google.com/p/googletest/wiki/Documentation
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>		/* printf */
+#include <stdlib.h>		/* rand */
+#include <string.h>		/* memcpy */
+#include <stdint.h>		/* uint*_t */
+#include <time.h>		/* clock */
+
+extern "C" {
+
+#include "ecc.h"		/* API for the Reed-Solomon codec */
+#include "rscode_reference.h"	/* original codec to compare against */
+
+}
+
+#define MAX_CODEWORD 255
+
+// To use a test fixture, derive a class from testing::Test.
+class RSCode : public testing::Test {
+protected:
+  virtual void SetUp() {
+    srand(1234);
+    initialize_ecc();
+    ref_initialize_ecc();
+  }
+
+  virtual void TearDown() {
+  }
+
+  void randomFill(unsigned char *buf, int len) {
+    for (int i = 0; i < len; i++)
+      buf[i] = rand() & 0xff;
+  }
+
+  // Encode a random message of msg_len bytes with both codecs and check they agree
+  void encodeBoth(unsigned char *codeword, int msg_len) {
+    unsigned char ref[MAX_CODEWORD];
+
+    randomFill(codeword, msg_len);
+    ref_encode_data(codeword, msg_len, ref);
+    encode_data(codeword, msg_len, codeword);
+    ASSERT_EQ(0, memcmp(ref, codeword, msg_len + RS_ECC_NPARITY));
+  }
+
+  // Corrupt num_errors distinct bytes of the codeword
+  void corrupt(unsigned char *codeword, int len, int num_errors) {
+    bool hit[MAX_CODEWORD] = { false };
+    for (int i = 0; i < num_errors && i < len; i++) {
+      int loc;
+      do {
+        loc = rand() % len;
+      } while (hit[loc]);
+      hit[loc] = true;
+      codeword[loc] ^= (rand() % 255) + 1;
+    }
+  }
+
+  // Run both decoders over the same received bytes and check that they
+  // agree on the syndrome, on the outcome and on the corrected bytes
+  int decodeBoth(unsigned char *received, int len) {
+    unsigned char ref[MAX_CODEWORD];
+    memcpy(ref, received, len);
+
+    decode_data(received, len);
+    ref_decode_data(ref, len);
+    EXPECT_EQ(ref_check_syndrome(), check_syndrome());
+    for (int i = 0; i < RS_ECC_NPARITY; i++)
+      EXPECT_EQ(ref_syndrome(i), synBytes[i]);
+
+    int ret = 0, ref_ret = 0;
+    if (check_syndrome() != 0) {
+      ret = correct_errors_erasures(received, len, 0, 0);
+      ref_ret = ref_correct_errors(ref, len);
+    }
+    EXPECT_EQ(ref_ret, ret);
+    EXPECT_EQ(0, memcmp(ref, received, len));
+    return ret;
+  }
+};
+
+TEST_F(RSCode, GaloisTables) {
+  for (int i = 0; i < 512; i++)
+    EXPECT_EQ(ref_gexp(i), gexp[i]);
+  for (int i = 0; i < 256; i++)
+    EXPECT_EQ(ref_glog(i), glog[i]);
+}
+
+TEST_F(RSCode, EncodeBitExact) {
+  unsigned char codeword[MAX_CODEWORD];
+
+  for (int len = 1; len <= MAX_CODEWORD - RS_ECC_NPARITY; len++)
+    encodeBoth(codeword, len);
+
+  // All zero messages and messages of a single repeated byte
+  for (int v = 0; v < 256; v++) {
+    unsigned char msg[64], ref[64 + RS_ECC_NPARITY];
+    memset(msg, v, sizeof(msg));
+    ref_encode_data(msg, sizeof(msg), ref);
+    encode_data(msg, sizeof(msg), codeword);
+    EXPECT_EQ(0, memcmp(ref, codeword, sizeof(ref)));
+  }
+}
+
+TEST_F(RSCode, CleanPacket) {
+  unsigned char codeword[MAX_CODEWORD], copy[MAX_CODEWORD];
+  const int msg_len = 100;
+
+  encodeBoth(codeword, msg_len);
+  memcpy(copy, codeword, sizeof(copy));
+
+  decode_data(codeword, msg_len + RS_ECC_NPARITY);
+  EXPECT_EQ(0, check_syndrome());
+
+  // A clean packet has nothing to correct and must be left alone
+  EXPECT_EQ(0, correct_errors_erasures(codeword, msg_len + RS_ECC_NPARITY, 0, 0));
+  EXPECT_EQ(0, memcmp(copy, codeword, sizeof(copy)));
+}
+
+TEST_F(RSCode, CorrectsUpToTwoErrors) {
+  unsigned char codeword[MAX_CODEWORD], sent[MAX_CODEWORD];
+
+  for (int trial = 0; trial < 2000; trial++) {
+    int msg_len = 1 + rand() % (MAX_CODEWORD - RS_ECC_NPARITY);
+    int len = msg_len + RS_ECC_NPARITY;
+    int num_errors = 1 + trial % (RS_ECC_NPARITY / 2);
+
+    encodeBoth(codeword, msg_len);
+    memcpy(sent, codeword, len);
+    corrupt(codeword, len, num_errors);
+
+    EXPECT_EQ(1, decodeBoth(codeword, len));
+    ASSERT_EQ(0, memcmp(sent, codeword, len));
+  }
+}
+
+TEST_F(RSCode, UncorrectableMatchesReference) {
+  unsigned char codeword[MAX_CODEWORD];
+
+  // Too many errors for the code. Whether these are rejected or
+  // miscorrected must not change.
+  for (int trial = 0; trial < 5000; trial++) {
+    int msg_len = 1 + rand() % (MAX_CODEWORD - RS_ECC_NPARITY);
+    int len = msg_len + RS_ECC_NPARITY;
+
+    encodeBoth(codeword, msg_len);
+    corrupt(codeword, len, RS_ECC_NPARITY / 2 + 1 + rand() % 8);
+    decodeBoth(codeword, len);
+  }
+
+  // Pure noise, with short lengths to exercise roots outside the codeword
+  for (int trial = 0; trial < 20000; trial++) {
+    int len = 1 + rand() % (trial < 10000 ? 16 : MAX_CODEWORD);
+    randomFill(codeword, len);
+    decodeBoth(codeword, len);
+  }
+}
+
+TEST_F(RSCode, Benchmark) {
+  // A full packet as sent by the RFM22B packet handler
+  unsigned char codeword[MAX_CODEWORD], received[MAX_CODEWORD];
+  const int msg_len = MAX_CODEWORD - RS_ECC_NPARITY;
+  const int iterations = 20000;
+
+  randomFill(codeword, msg_len);
+
+  clock_t start = clock();
+  for (int i = 0; i < iterations; i++)
+    encode_data(codeword, msg_len, codeword);
+  clock_t encode = clock() - start;
+
+  start = clock();
+  for (int i = 0; i < iterations; i++)
+    ref_encode_data(codeword, msg_len, received);
+  clock_t ref_encode = clock() - start;
+
+  start = clock();
+  for (int i = 0; i < iterations; i++) {
+    decode_data(codeword, MAX_CODEWORD);
+    EXPECT_EQ(0, check_syndrome());
+  }
+  clock_t clean = clock() - start;
+
+  start = clock();
+  for (int i = 0; i < iterations; i++)
+    ref_decode_data(codeword, MAX_CODEWORD);
+  clock_t ref_clean = clock() - start;
+
+  clock_t correct = 0, ref_correct = 0;
+  for (int i = 0; i < iterations; i++) {
+    memcpy(received, codeword, MAX_CODEWORD);
+    received[i % MAX_CODEWORD] ^= 0x5a;
+    received[(i * 7 + 3) % MAX_CODEWORD] ^= 0xa5;
+
+    start = clock();
+    decode_data(received, MAX_CODEWORD);
+    correct_errors_erasures(received, MAX_CODEWORD, 0, 0);
+    correct += clock() - start;
+    ASSERT_EQ(0, memcmp(codeword, received, MAX_CODEWORD));
+
+    received[i % MAX_CODEWORD] ^= 0x5a;
+    received[(i * 7 + 3) % MAX_CODEWORD] ^= 0xa5;
+
+    start = clock();
+    ref_decode_data(received, MAX_CODEWORD);
+    ref_correct_errors(received, MAX_CODEWORD);
+    ref_correct += clock() - start;
+  }
+
+  printf("Encode: %.2f us, reference %.2f us\n",
+         1e6 * encode / CLOCKS_PER_SEC / iterations,
+         1e6 * ref_encode / CLOCKS_PER_SEC / iterations);
+  printf("Clean decode: %.2f us, reference %.2f us\n",
+         1e6 * clean / CLOCKS_PER_SEC / iterations,
+         1e6 * ref_clean / CLOCKS_PER_SEC / iterations);
+  printf("Two error correction: %.2f us, reference %.2f us\n",
+         1e6 * correct / CLOCKS_PER_SEC / iterations,
+         1e6 * ref_correct / CLOCKS_PER_SEC / iterations);
+}
+
+/**
+ * @}
+ * @}
+ */
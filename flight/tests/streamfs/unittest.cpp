@@ -0,0 +1,324 @@
+/**
+ ******************************************************************************
+ * @file       unittest.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Unit test
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * NOTE: This program uses the Google Test infrastructure to drive the unit test
+ *
+ * Main site for Google Test: http://code.google.com/p/googletest/
+ * Documentation and examples: http://code.google.com/p/googletest/wiki/Documentation
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>		/* printf */
+#include <stdlib.h>		/* abort */
+#include <string.h>		/* memset */
+#include <stdint.h>		/* uint*_t */
+
+extern "C" {
+#include "pios_flash_priv.h"	/* struct pios_flash_partition */
+
+extern const struct pios_flash_partition pios_flash_partition_table[];
+extern uint32_t pios_flash_partition_table_size;
+
+#include "pios_flash_posix_priv.h"
+
+extern uintptr_t pios_posix_flash_id;
+extern struct pios_flash_posix_cfg flash_config;
+
+#include "pios_streamfs_priv.h"
+
+extern struct streamfs_cfg streamfs_config_log;
+
+#include "pios_streamfs.h"	/* PIOS_STREAMFS_* */
+
+}
+
+#define LOG_PARTITION_SIZE (16 * 64 * 1024)
+
+// To use a test fixture, derive a class from testing::Test.
+class StreamfsTestRaw : public testing::Test {
+protected:
+  virtual void SetUp() {
+    /* create an empty, appropriately sized flash filesystem */
+    FILE * theflash = fopen("theflash.bin", "w");
+    uint8_t sector[flash_config.size_of_sector];
+    memset(sector, 0xFF, sizeof(sector));
+    for (uint32_t i = 0; i < flash_config.size_of_flash / flash_config.size_of_sector; i++) {
+      fwrite(sector, sizeof(sector), 1, theflash);
+    }
+    fclose(theflash);
+  }
+
+  virtual void TearDown() {
+    unlink("theflash.bin");
+  }
+
+  /* Deterministic contents that differ between files and positions */
+  static uint8_t pattern(uint32_t file, uint32_t pos) {
+    return (uint8_t)((pos * 7) + (pos >> 8) + file * 31);
+  }
+};
+
+TEST_F(StreamfsTestRaw, StreamfsInit) {
+  EXPECT_EQ(0, PIOS_Flash_Posix_Init(&pios_posix_flash_id, &flash_config));
+
+  /* Register the partition table */
+  PIOS_FLASH_register_partition_table(pios_flash_partition_table, pios_flash_partition_table_size);
+
+  uintptr_t fs_id;
+  EXPECT_EQ(0, PIOS_STREAMFS_Init(&fs_id, &streamfs_config_log, FLASH_PARTITION_LABEL_LOG));
+
+  PIOS_STREAMFS_Destroy(fs_id);
+  PIOS_Flash_Posix_Destroy(pios_posix_flash_id);
+}
+
+class StreamfsTestCooked : public StreamfsTestRaw {
+protected:
+  virtual void SetUp() {
+    /* First, we need to set up the super fixture (StreamfsTestRaw) */
+    StreamfsTestRaw::SetUp();
+
+    /* Init the flash and the streamfs so we don't need to repeat this in every test */
+    EXPECT_EQ(0, PIOS_Flash_Posix_Init(&pios_posix_flash_id, &flash_config));
+    PIOS_FLASH_register_partition_table(pios_flash_partition_table, pios_flash_partition_table_size);
+    EXPECT_EQ(0, PIOS_STREAMFS_Init(&fs_id, &streamfs_config_log, FLASH_PARTITION_LABEL_LOG));
+  }
+
+  virtual void TearDown() {
+    PIOS_STREAMFS_Destroy(fs_id);
+    PIOS_Flash_Posix_Destroy(pios_posix_flash_id);
+    StreamfsTestRaw::TearDown();
+  }
+
+  /* Write a file of the given size in chunks of an awkward size */
+  int32_t writeFile(uint32_t file, uint32_t size, bool close = true) {
+    int32_t file_id = PIOS_STREAMFS_OpenWrite(fs_id);
+    if (file_id < 0)
+      return file_id;
+
+    uint8_t chunk[77];
+    for (uint32_t pos = 0; pos < size; pos += sizeof(chunk)) {
+      uint32_t len = size - pos < sizeof(chunk) ? size - pos : sizeof(chunk);
+      for (uint32_t i = 0; i < len; i++)
+        chunk[i] = pattern(file, pos + i);
+      if (PIOS_STREAMFS_Write(fs_id, chunk, len) != 0)
+        return -100;
+    }
+
+    if (close && PIOS_STREAMFS_Close(fs_id) != 0)
+      return -101;
+
+    return file_id;
+  }
+
+  /* Read a file back, check it holds the expected data and return its size */
+  int32_t verifyFile(uint16_t file_id, uint32_t file, uint32_t first_pos = 0) {
+    if (PIOS_STREAMFS_OpenRead(fs_id, file_id) != 0)
+      return -1;
+
+    uint32_t pos = first_pos;
+    uint8_t buf[1000];
+    int32_t len;
+    while ((len = PIOS_STREAMFS_Read(fs_id, buf, sizeof(buf))) > 0) {
+      for (int32_t i = 0; i < len; i++, pos++) {
+        if (buf[i] != pattern(file, pos)) {
+          PIOS_STREAMFS_Close(fs_id);
+          return -2;
+        }
+      }
+    }
+
+    PIOS_STREAMFS_Close(fs_id);
+    return len < 0 ? -3 : (int32_t)(pos - first_pos);
+  }
+
+  uintptr_t fs_id;
+};
+
+TEST_F(StreamfsTestCooked, BadIdStreamfsFormat) {
+  EXPECT_EQ(-1, PIOS_STREAMFS_Format(fs_id + 1));
+}
+
+TEST_F(StreamfsTestCooked, BadIdOpenWrite) {
+  EXPECT_EQ(-1, PIOS_STREAMFS_OpenWrite(fs_id + 1));
+}
+
+TEST_F(StreamfsTestCooked, Empty) {
+  EXPECT_EQ(-2, PIOS_STREAMFS_MinFileId(fs_id));
+  EXPECT_EQ(-2, PIOS_STREAMFS_MaxFileId(fs_id));
+  EXPECT_EQ(-4, PIOS_STREAMFS_OpenRead(fs_id, 0));
+}
+
+TEST_F(StreamfsTestCooked, WriteNotOpen) {
+  uint8_t data[4] = { 1, 2, 3, 4 };
+  EXPECT_EQ(-2, PIOS_STREAMFS_Write(fs_id, data, sizeof(data)));
+  EXPECT_EQ(-2, PIOS_STREAMFS_Close(fs_id));
+}
+
+TEST_F(StreamfsTestCooked, OnlyOneFileOpen) {
+  EXPECT_EQ(0, PIOS_STREAMFS_OpenWrite(fs_id));
+  EXPECT_EQ(-2, PIOS_STREAMFS_OpenWrite(fs_id));
+  EXPECT_EQ(-2, PIOS_STREAMFS_OpenRead(fs_id, 0));
+  EXPECT_EQ(-2, PIOS_STREAMFS_Format(fs_id));
+  EXPECT_EQ(0, PIOS_STREAMFS_Close(fs_id));
+}
+
+TEST_F(StreamfsTestCooked, WriteVerifySmall) {
+  EXPECT_EQ(0, writeFile(0, 100));
+  EXPECT_EQ(0, PIOS_STREAMFS_MinFileId(fs_id));
+  EXPECT_EQ(0, PIOS_STREAMFS_MaxFileId(fs_id));
+  EXPECT_EQ(100, verifyFile(0, 0));
+}
+
+TEST_F(StreamfsTestCooked, WriteVerifyAcrossArenas) {
+  /* Several arenas and a partial last page */
+  const uint32_t size = 3 * 64 * 1024 + 1234;
+  EXPECT_EQ(0, writeFile(0, size));
+  EXPECT_EQ((int32_t)size, verifyFile(0, 0));
+}
+
+TEST_F(StreamfsTestCooked, WriteVerifySeveralFiles) {
+  EXPECT_EQ(0, writeFile(0, 5000));
+  EXPECT_EQ(1, writeFile(1, 70000));
+  EXPECT_EQ(2, writeFile(2, 10));
+
+  EXPECT_EQ(0, PIOS_STREAMFS_MinFileId(fs_id));
+  EXPECT_EQ(2, PIOS_STREAMFS_MaxFileId(fs_id));
+
+  EXPECT_EQ(5000, verifyFile(0, 0));
+  EXPECT_EQ(70000, verifyFile(1, 1));
+  EXPECT_EQ(10, verifyFile(2, 2));
+}
+
+TEST_F(StreamfsTestCooked, Remount) {
+  EXPECT_EQ(0, writeFile(0, 5000));
+  EXPECT_EQ(1, writeFile(1, 6000));
+
+  PIOS_STREAMFS_Destroy(fs_id);
+  EXPECT_EQ(0, PIOS_STREAMFS_Init(&fs_id, &streamfs_config_log, FLASH_PARTITION_LABEL_LOG));
+
+  /* New files continue after the existing ones */
+  EXPECT_EQ(2, writeFile(2, 7000));
+
+  EXPECT_EQ(5000, verifyFile(0, 0));
+  EXPECT_EQ(6000, verifyFile(1, 1));
+  EXPECT_EQ(7000, verifyFile(2, 2));
+}
+
+TEST_F(StreamfsTestCooked, Format) {
+  EXPECT_EQ(0, writeFile(0, 5000));
+  EXPECT_EQ(0, PIOS_STREAMFS_Format(fs_id));
+  EXPECT_EQ(-2, PIOS_STREAMFS_MaxFileId(fs_id));
+  EXPECT_EQ(0, writeFile(0, 100));
+}
+
+TEST_F(StreamfsTestCooked, WrapAround) {
+  /* Each file takes two arenas, so the first files get overwritten */
+  const uint32_t size = 100000;
+  const uint32_t num_files = 12;
+  for (uint32_t file = 0; file < num_files; file++)
+    EXPECT_EQ((int32_t)file, writeFile(file, size));
+
+  EXPECT_EQ((int32_t)(num_files - 1), PIOS_STREAMFS_MaxFileId(fs_id));
+
+  /* 16 arenas hold the last 8 files */
+  int32_t oldest = PIOS_STREAMFS_MinFileId(fs_id);
+  EXPECT_EQ((int32_t)(num_files - 8), oldest);
+  EXPECT_EQ(-4, PIOS_STREAMFS_OpenRead(fs_id, 0));
+
+  for (uint32_t file = oldest; file < num_files; file++)
+    EXPECT_EQ((int32_t)size, verifyFile(file, file));
+}
+
+TEST_F(StreamfsTestCooked, LongFileOverwritesItsStart) {
+  /* Larger than the partition, only the end of the file is kept */
+  const uint32_t size = LOG_PARTITION_SIZE + 200000;
+  EXPECT_EQ(0, writeFile(0, size));
+
+  /* Skip to the first byte still present, arenas hold whole pages */
+  uint32_t arena_data = 64 * 1024 - 2 * 256;
+  uint32_t total_segments = (size + arena_data - 1) / arena_data;
+  uint32_t first_segment = total_segments - LOG_PARTITION_SIZE / (64 * 1024);
+  uint32_t first_pos = first_segment * arena_data;
+
+  EXPECT_EQ((int32_t)(size - first_pos), verifyFile(0, 0, first_pos));
+}
+
+TEST_F(StreamfsTestCooked, UnclosedFile) {
+  EXPECT_EQ(0, writeFile(0, 5000));
+
+  /* Power is lost while the second file is being written */
+  const uint32_t size = 2 * 64 * 1024 + 500;
+  EXPECT_EQ(1, writeFile(1, size, false));
+
+  PIOS_STREAMFS_Destroy(fs_id);
+  EXPECT_EQ(0, PIOS_STREAMFS_Init(&fs_id, &streamfs_config_log, FLASH_PARTITION_LABEL_LOG));
+
+  /* Everything but the partial page still held in RAM is recovered */
+  const int32_t recovered = size - size % 256;
+  EXPECT_EQ(recovered, verifyFile(1, 1));
+  EXPECT_EQ(5000, verifyFile(0, 0));
+
+  EXPECT_EQ(2, writeFile(2, 1000));
+  EXPECT_EQ(1000, verifyFile(2, 2));
+  EXPECT_EQ(recovered, verifyFile(1, 1));
+}
+
+TEST_F(StreamfsTestCooked, UnclosedFileInFirstArena) {
+  /* Power is lost before the first arena of the file is full */
+  EXPECT_EQ(0, writeFile(0, 1000, false));
+
+  PIOS_STREAMFS_Destroy(fs_id);
+  EXPECT_EQ(0, PIOS_STREAMFS_Init(&fs_id, &streamfs_config_log, FLASH_PARTITION_LABEL_LOG));
+
+  EXPECT_EQ(0, PIOS_STREAMFS_MaxFileId(fs_id));
+  EXPECT_EQ(768, verifyFile(0, 0));
+  EXPECT_EQ(1, writeFile(1, 1000));
+}
+
+TEST_F(StreamfsTestCooked, EraseNextArena) {
+  EXPECT_EQ(-2, PIOS_STREAMFS_EraseNextArena(fs_id));
+  EXPECT_EQ(0, PIOS_STREAMFS_OpenWrite(fs_id));
+  EXPECT_EQ(0, PIOS_STREAMFS_EraseNextArena(fs_id));
+
+  /* Erasing again does nothing until the next arena is in use */
+  uint32_t erases = PIOS_Flash_Posix_GetEraseCount(pios_posix_flash_id);
+  EXPECT_EQ(0, PIOS_STREAMFS_EraseNextArena(fs_id));
+  EXPECT_EQ(erases, PIOS_Flash_Posix_GetEraseCount(pios_posix_flash_id));
+
+  /* Filling the first arena moves on without erasing */
+  uint8_t page[256];
+  for (uint32_t pos = 0; pos < 64 * 1024; pos += sizeof(page)) {
+    for (uint32_t i = 0; i < sizeof(page); i++)
+      page[i] = pattern(0, pos + i);
+    EXPECT_EQ(0, PIOS_STREAMFS_Write(fs_id, page, sizeof(page)));
+  }
+  EXPECT_EQ(erases, PIOS_Flash_Posix_GetEraseCount(pios_posix_flash_id));
+  EXPECT_EQ(0, PIOS_STREAMFS_Close(fs_id));
+
+  EXPECT_EQ(64 * 1024, verifyFile(0, 0));
+}
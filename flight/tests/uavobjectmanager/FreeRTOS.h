@@ -0,0 +1,33 @@
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#define pvPortMalloc(xSize) (malloc(xSize))
+#define vPortFree(pv) (free(pv))
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY 0xffffffff
+#define portTICK_RATE_MS 1
+
+typedef void * xQueueHandle;
+typedef void * xSemaphoreHandle;
+typedef uint32_t portTickType;
+typedef void * xTaskHandle;
+
+extern xSemaphoreHandle xSemaphoreCreateRecursiveMutex(void);
+extern int32_t xSemaphoreTakeRecursive(xSemaphoreHandle sema, uint32_t ticks);
+extern int32_t xSemaphoreGiveRecursive(xSemaphoreHandle sema);
+extern int32_t xQueueSend(xQueueHandle queue, const void * item, uint32_t ticks);
+
+extern xSemaphoreHandle ut_semaphore_create_binary(void);
+extern int32_t xSemaphoreTake(xSemaphoreHandle sema, portTickType ticks);
+extern int32_t xSemaphoreGive(xSemaphoreHandle sema);
+extern portTickType xTaskGetTickCount(void);
+extern xTaskHandle xTaskGetCurrentTaskHandle(void);
+
+#define vSemaphoreCreateBinary(sema) ((sema) = ut_semaphore_create_binary())
+
+#endif /* FREERTOS_H */
@@ -0,0 +1,5 @@
+/* Only what the PiOS sources built into this test need */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pios_crc.h"
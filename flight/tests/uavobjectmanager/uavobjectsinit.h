@@ -0,0 +1,2 @@
+/* Stands in for the generated header, the tests register their own objects */
+#define UAVOBJECTS_LARGEST 1024
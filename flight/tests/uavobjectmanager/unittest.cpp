@@ -0,0 +1,997 @@
+/**
+ ******************************************************************************
+ * @file       unittest.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2013
+ * @addtogroup UnitTests
+ * @{
+ * @addtogroup UnitTests
+ * @{
+ * @brief Unit test
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * NOTE: This program uses the Google Test infrastructure to drive the unit test
+ *
+ * Main site for Google Test: http://code.google.com/p/googletest/
+ * Documentation and examples: http://code.google.com/p/googletest/wiki/Documentation
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>		/* printf */
+#include <stdlib.h>		/* abort */
+#include <string.h>		/* memset */
+#include <stdint.h>		/* uint*_t */
+#include <time.h>		/* clock */
+#include <pthread.h>	/* pthread_create */
+
+extern "C" {
+
+#include "openpilot.h"
+#include "uavtalk_priv.h"
+
+extern void (*mock_flash_save_hook)(void);
+
+}
+
+/* Roughly the number of objects registered on a Revolution */
+#define NUM_OBJECTS 120
+
+#define OBJ_SIZE 16
+
+#define LOOKUP_ROUNDS 2000
+
+// To use a test fixture, derive a class from testing::Test.
+class UAVObjManagerTest : public testing::Test {
+protected:
+  virtual void SetUp() {
+    ASSERT_EQ(0, UAVObjInitialize());
+
+    /* Spread the ids around like the generator hashes do, leaving room for the meta id */
+    srand(1234);
+    for (uint32_t i = 0; i < NUM_OBJECTS; i++) {
+      obj_ids[i] = ((uint32_t)rand() << 1) & 0xFFFFFFFE;
+      handles[i] = UAVObjRegister(obj_ids[i], (i % 4) != 0, false, OBJ_SIZE, 1, NULL);
+      ASSERT_TRUE(handles[i] != NULL);
+    }
+  }
+
+  virtual void TearDown() {
+  }
+
+  /* Reference implementation of the lookup this index replaces */
+  UAVObjHandle linearLookup(uint32_t id) {
+    for (uint32_t i = 0; i < NUM_OBJECTS; i++) {
+      if (UAVObjGetID(handles[i]) == id)
+        return handles[i];
+      if (UAVObjGetID(UAVObjGetLinkedObj(handles[i])) == id)
+        return UAVObjGetLinkedObj(handles[i]);
+    }
+    return NULL;
+  }
+
+  uint32_t obj_ids[NUM_OBJECTS];
+  UAVObjHandle handles[NUM_OBJECTS];
+};
+
+TEST_F(UAVObjManagerTest, FindDataObjects) {
+  for (uint32_t i = 0; i < NUM_OBJECTS; i++) {
+    EXPECT_EQ(handles[i], UAVObjGetByID(obj_ids[i]));
+    EXPECT_FALSE(UAVObjIsMetaobject(UAVObjGetByID(obj_ids[i])));
+  }
+}
+
+TEST_F(UAVObjManagerTest, FindMetaObjects) {
+  for (uint32_t i = 0; i < NUM_OBJECTS; i++) {
+    UAVObjHandle meta = UAVObjGetByID(obj_ids[i] + 1);
+    ASSERT_TRUE(meta != NULL);
+    EXPECT_TRUE(UAVObjIsMetaobject(meta));
+    EXPECT_EQ(handles[i], UAVObjGetLinkedObj(meta));
+    EXPECT_EQ(obj_ids[i] + 1, UAVObjGetID(meta));
+  }
+}
+
+TEST_F(UAVObjManagerTest, MissingObjects) {
+  /* All registered ids are even, so id + 3 is never a data or meta object */
+  for (uint32_t i = 0; i < NUM_OBJECTS; i++) {
+    if (linearLookup(obj_ids[i] + 3) == NULL) {
+      EXPECT_EQ(NULL, UAVObjGetByID(obj_ids[i] + 3));
+    }
+  }
+}
+
+TEST_F(UAVObjManagerTest, RejectDuplicates) {
+  EXPECT_EQ(NULL, UAVObjRegister(obj_ids[0], true, false, OBJ_SIZE, 1, NULL));
+  EXPECT_EQ(handles[0], UAVObjGetByID(obj_ids[0]));
+}
+
+TEST_F(UAVObjManagerTest, MatchesLinearLookup) {
+  for (uint32_t i = 0; i < NUM_OBJECTS; i++) {
+    EXPECT_EQ(linearLookup(obj_ids[i]), UAVObjGetByID(obj_ids[i]));
+    EXPECT_EQ(linearLookup(obj_ids[i] + 1), UAVObjGetByID(obj_ids[i] + 1));
+  }
+}
+
+TEST_F(UAVObjManagerTest, LookupBenchmark) {
+  volatile uintptr_t sink = 0;
+
+  clock_t start = clock();
+  for (uint32_t round = 0; round < LOOKUP_ROUNDS; round++) {
+    for (uint32_t i = 0; i < NUM_OBJECTS; i++) {
+      sink += (uintptr_t)linearLookup(obj_ids[i] + (round & 1));
+    }
+  }
+  clock_t linear_ticks = clock() - start;
+
+  start = clock();
+  for (uint32_t round = 0; round < LOOKUP_ROUNDS; round++) {
+    for (uint32_t i = 0; i < NUM_OBJECTS; i++) {
+      sink += (uintptr_t)UAVObjGetByID(obj_ids[i] + (round & 1));
+    }
+  }
+  clock_t indexed_ticks = clock() - start;
+
+  printf("%u lookups: linear %.2f ms, indexed %.2f ms\n",
+         LOOKUP_ROUNDS * NUM_OBJECTS,
+         linear_ticks * 1000.0 / CLOCKS_PER_SEC,
+         indexed_ticks * 1000.0 / CLOCKS_PER_SEC);
+
+  EXPECT_LT(indexed_ticks, linear_ticks);
+}
+
+TEST_F(UAVObjManagerTest, SingleInstanceData) {
+  uint8_t data_in[OBJ_SIZE];
+  uint8_t data_out[OBJ_SIZE];
+
+  /* handles[1] is a single instance object */
+  ASSERT_TRUE(UAVObjIsSingleInstance(handles[1]));
+
+  for (uint32_t i = 0; i < OBJ_SIZE; i++)
+    data_in[i] = i + 1;
+
+  EXPECT_EQ(0, UAVObjSetInstanceData(handles[1], 0, data_in));
+  memset(data_out, 0, sizeof(data_out));
+  EXPECT_EQ(0, UAVObjGetInstanceData(handles[1], 0, data_out));
+  EXPECT_EQ(0, memcmp(data_in, data_out, OBJ_SIZE));
+
+  /* Only instance 0 exists */
+  EXPECT_EQ(-1, UAVObjSetInstanceData(handles[1], 1, data_in));
+  EXPECT_EQ(-1, UAVObjGetInstanceData(handles[1], 1, data_out));
+
+  /* Field access */
+  uint8_t field = 0xA5;
+  EXPECT_EQ(0, UAVObjSetInstanceDataField(handles[1], 0, &field, 3, 1));
+  EXPECT_EQ(-1, UAVObjSetInstanceDataField(handles[1], 0, &field, OBJ_SIZE, 1));
+  field = 0;
+  EXPECT_EQ(0, UAVObjGetInstanceDataField(handles[1], 0, &field, 3, 1));
+  EXPECT_EQ(0xA5, field);
+
+  /* Pack and unpack go through the same path */
+  EXPECT_EQ(0, UAVObjUnpack(handles[1], 0, data_in));
+  EXPECT_EQ(0, UAVObjPack(handles[1], 0, data_out));
+  EXPECT_EQ(0, memcmp(data_in, data_out, OBJ_SIZE));
+}
+
+TEST_F(UAVObjManagerTest, SingleInstanceReadOnly) {
+  uint8_t data_in[OBJ_SIZE];
+  uint8_t data_out[OBJ_SIZE];
+  UAVObjMetadata metadata;
+
+  memset(data_in, 0x55, sizeof(data_in));
+  EXPECT_EQ(0, UAVObjSetInstanceData(handles[1], 0, data_in));
+
+  UAVObjGetMetadata(handles[1], &metadata);
+  UAVObjSetAccess(&metadata, ACCESS_READONLY);
+  UAVObjSetMetadata(handles[1], &metadata);
+
+  memset(data_in, 0xAA, sizeof(data_in));
+  EXPECT_EQ(-1, UAVObjSetInstanceData(handles[1], 0, data_in));
+
+  /* Unpacking bypasses the access check */
+  EXPECT_EQ(0, UAVObjGetInstanceData(handles[1], 0, data_out));
+  EXPECT_EQ(0x55, data_out[0]);
+  EXPECT_EQ(0, UAVObjUnpack(handles[1], 0, data_in));
+  EXPECT_EQ(0, UAVObjGetInstanceData(handles[1], 0, data_out));
+  EXPECT_EQ(0xAA, data_out[0]);
+}
+
+TEST_F(UAVObjManagerTest, Stats) {
+  UAVObjStats stats;
+  uint8_t data[OBJ_SIZE];
+
+  UAVObjClearStats();
+  UAVObjGetInstanceData(handles[1], 0, data);
+  UAVObjGetStats(&stats);
+
+  /* Nothing else runs so lockless reads never retry */
+  EXPECT_EQ(0U, stats.seqReadRetries);
+  EXPECT_EQ(0U, stats.lockContentions);
+}
+
+/* Large enough that a writer is likely to be preempted in the middle of a copy */
+#define CONCURRENT_OBJ_SIZE 8192
+#define CONCURRENT_RUN_MS 300
+
+struct concurrent_state {
+  UAVObjHandle obj;
+  volatile bool done;
+  uint32_t torn_reads;
+  uint32_t reads;
+};
+
+static void * concurrent_writer(void * arg)
+{
+  struct concurrent_state * state = (struct concurrent_state *) arg;
+  uint8_t data[CONCURRENT_OBJ_SIZE];
+  struct timespec start, now;
+
+  /* Run for a while rather than a number of writes so that the scheduler preempts us */
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint32_t i = 0; ; i++) {
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if ((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000 > CONCURRENT_RUN_MS)
+      break;
+
+    memset(data, i & 0xFF, sizeof(data));
+    if (i & 1)
+      UAVObjSetInstanceData(state->obj, 0, data);
+    else
+      UAVObjUnpack(state->obj, 0, data);
+  }
+
+  state->done = true;
+  return NULL;
+}
+
+static void * concurrent_reader(void * arg)
+{
+  struct concurrent_state * state = (struct concurrent_state *) arg;
+  uint8_t data[CONCURRENT_OBJ_SIZE];
+
+  while (!state->done) {
+    UAVObjGetInstanceData(state->obj, 0, data);
+    for (uint32_t j = 1; j < sizeof(data); j++) {
+      if (data[j] != data[0]) {
+        __sync_fetch_and_add(&state->torn_reads, 1);
+        break;
+      }
+    }
+    __sync_fetch_and_add(&state->reads, 1);
+  }
+
+  return NULL;
+}
+
+TEST_F(UAVObjManagerTest, ConcurrentSingleInstanceReaders) {
+  struct concurrent_state state;
+  pthread_t writer, second_writer;
+  pthread_t readers[3];
+
+  state.obj = UAVObjRegister(0x2000, true, false, CONCURRENT_OBJ_SIZE, 1, NULL);
+  ASSERT_TRUE(state.obj != NULL);
+  state.done = false;
+  state.torn_reads = 0;
+  state.reads = 0;
+
+  for (uint32_t i = 0; i < 3; i++)
+    ASSERT_EQ(0, pthread_create(&readers[i], NULL, concurrent_reader, &state));
+  ASSERT_EQ(0, pthread_create(&writer, NULL, concurrent_writer, &state));
+  ASSERT_EQ(0, pthread_create(&second_writer, NULL, concurrent_writer, &state));
+
+  pthread_join(writer, NULL);
+  pthread_join(second_writer, NULL);
+  for (uint32_t i = 0; i < 3; i++)
+    pthread_join(readers[i], NULL);
+
+  /* Readers only ever see whole writes, writers never interleave */
+  EXPECT_GT(state.reads, 0U);
+  EXPECT_EQ(0U, state.torn_reads);
+}
+
+TEST_F(UAVObjManagerTest, SaveLoadSingleInstance) {
+  uint8_t data_in[OBJ_SIZE];
+  uint8_t data_out[OBJ_SIZE];
+
+  ASSERT_TRUE(UAVObjIsSingleInstance(handles[1]));
+
+  for (uint32_t i = 0; i < OBJ_SIZE; i++)
+    data_in[i] = 0x30 + i;
+  EXPECT_EQ(0, UAVObjSetInstanceData(handles[1], 0, data_in));
+  EXPECT_EQ(0, UAVObjSave(handles[1], 0));
+
+  /* Loading replaces the current data */
+  memset(data_out, 0, sizeof(data_out));
+  EXPECT_EQ(0, UAVObjSetInstanceData(handles[1], 0, data_out));
+  EXPECT_EQ(0, UAVObjLoad(handles[1], 0));
+  EXPECT_EQ(0, UAVObjGetInstanceData(handles[1], 0, data_out));
+  EXPECT_EQ(0, memcmp(data_in, data_out, OBJ_SIZE));
+
+  /* Only instance 0 exists */
+  EXPECT_EQ(-1, UAVObjSave(handles[1], 1));
+  EXPECT_EQ(-1, UAVObjLoad(handles[1], 1));
+
+  UAVObjDeleteById(obj_ids[1], 0);
+}
+
+/* Set by a writer thread started while the flash save is in progress */
+static UAVObjHandle save_writer_obj;
+static volatile bool save_writer_done;
+static bool save_writer_finished_during_save;
+
+static void * save_writer(void * /* arg */)
+{
+  uint8_t data[OBJ_SIZE];
+
+  memset(data, 0x77, sizeof(data));
+  UAVObjSetInstanceData(save_writer_obj, 0, data);
+  save_writer_done = true;
+  return NULL;
+}
+
+static void save_hook(void)
+{
+  pthread_t thread;
+
+  /* Only the first save, the writer must finish while the flash is busy */
+  mock_flash_save_hook = NULL;
+  save_writer_done = false;
+  ASSERT_EQ(0, pthread_create(&thread, NULL, save_writer, NULL));
+  for (uint32_t ms = 0; ms < 1000 && !save_writer_done; ms++)
+    usleep(1000);
+  save_writer_finished_during_save = save_writer_done;
+
+  /* A writer blocked behind the save can only finish once it is done */
+  if (save_writer_done)
+    pthread_join(thread, NULL);
+  else
+    pthread_detach(thread);
+}
+
+TEST_F(UAVObjManagerTest, WriteDuringFlashSave) {
+  UAVObjHandle settings = UAVObjRegister(0x3000, true, true, OBJ_SIZE, 1, NULL);
+  ASSERT_TRUE(settings != NULL);
+  ASSERT_TRUE(UAVObjIsSingleInstance(handles[1]));
+
+  /* Saving all settings holds the object manager lock over the flash */
+  save_writer_obj = handles[1];
+  save_writer_finished_during_save = false;
+  mock_flash_save_hook = save_hook;
+  EXPECT_EQ(0, UAVObjSaveSettings());
+  EXPECT_TRUE(save_writer_finished_during_save);
+
+  /* Saving the settings object itself does not hold off its writers */
+  save_writer_obj = settings;
+  save_writer_finished_during_save = false;
+  mock_flash_save_hook = save_hook;
+  EXPECT_EQ(0, UAVObjSave(settings, 0));
+  EXPECT_TRUE(save_writer_finished_during_save);
+
+  UAVObjDeleteById(0x3000, 0);
+}
+
+TEST_F(UAVObjManagerTest, MultiInstanceData) {
+  uint8_t data[OBJ_SIZE];
+
+  for (uint16_t num_reserved = 1; num_reserved <= 7; num_reserved += 3) {
+    UAVObjHandle obj = UAVObjRegister(0x1000 + num_reserved * 2, false, false, OBJ_SIZE, num_reserved, NULL);
+    ASSERT_TRUE(obj != NULL);
+    EXPECT_EQ(1, UAVObjGetNumInstances(obj));
+
+    /* Create instances one at a time, tagging each with its id */
+    for (uint16_t inst = 1; inst < 100; inst++) {
+      EXPECT_EQ(inst, UAVObjCreateInstance(obj, NULL));
+      memset(data, inst & 0xFF, sizeof(data));
+      EXPECT_EQ(0, UAVObjSetInstanceData(obj, inst, data));
+    }
+    EXPECT_EQ(100, UAVObjGetNumInstances(obj));
+
+    /* Every instance has its own storage */
+    for (uint16_t inst = 1; inst < 100; inst++) {
+      EXPECT_EQ(0, UAVObjGetInstanceData(obj, inst, data));
+      EXPECT_EQ(inst & 0xFF, data[0]);
+      EXPECT_EQ(inst & 0xFF, data[OBJ_SIZE - 1]);
+    }
+    EXPECT_EQ(-1, UAVObjGetInstanceData(obj, 100, data));
+
+    /* Unpacking past the end creates the missing instances */
+    memset(data, 0x5A, sizeof(data));
+    EXPECT_EQ(0, UAVObjUnpack(obj, 150, data));
+    EXPECT_EQ(151, UAVObjGetNumInstances(obj));
+    EXPECT_EQ(0, UAVObjGetInstanceData(obj, 149, data));
+    EXPECT_EQ(0, data[0]);
+    EXPECT_EQ(0, UAVObjGetInstanceData(obj, 150, data));
+    EXPECT_EQ(0x5A, data[0]);
+
+    /* Instance ids are limited */
+    EXPECT_EQ(-1, UAVObjUnpack(obj, UAVOBJ_MAX_INSTANCES, data));
+    EXPECT_EQ(0, UAVObjUnpack(obj, UAVOBJ_MAX_INSTANCES - 1, data));
+    EXPECT_EQ(UAVOBJ_MAX_INSTANCES, UAVObjGetNumInstances(obj));
+  }
+}
+
+/* A multi instance object large enough that its payload spans several reads */
+#define TALK_OBJ_ID 0x3000
+#define TALK_OBJ_SIZE 100
+#define TALK_INSTANCES 6
+#define TALK_STREAM_SIZE 2048
+#define TALK_SPLIT_ROUNDS 50
+
+static int32_t discard_output(uint8_t * /* data */, int32_t length)
+{
+  return length;
+}
+
+class UAVTalkParserTest : public UAVObjManagerTest {
+protected:
+  virtual void SetUp() {
+    UAVObjManagerTest::SetUp();
+
+    obj = UAVObjRegister(TALK_OBJ_ID, false, false, TALK_OBJ_SIZE, 1, NULL);
+    ASSERT_TRUE(obj != NULL);
+    connection = UAVTalkInitialize(discard_output);
+    ASSERT_TRUE(connection != NULL);
+
+    /* One frame per instance with line noise, a corrupted frame and an unknown object mixed in */
+    stream_len = 0;
+    for (uint16_t inst = 0; inst < TALK_INSTANCES; inst++) {
+      appendFrame(TALK_OBJ_ID, inst, inst * 16);
+      if (inst == 1) {
+        const uint8_t noise[] = { 0x00, 0xFF, UAVTALK_SYNC_VAL, 0x00, 0x12 };
+        memcpy(&stream[stream_len], noise, sizeof(noise));
+        stream_len += sizeof(noise);
+      } else if (inst == 2) {
+        appendFrame(TALK_OBJ_ID, TALK_INSTANCES, 0xE0);
+        stream[stream_len - 1] ^= 0x01;
+      } else if (inst == 3) {
+        appendFrame(TALK_OBJ_ID + 4, 0, 0x70);
+      }
+    }
+  }
+
+  /* Append a UAVTALK_TYPE_OBJ frame for one instance to the stream */
+  void appendFrame(uint32_t obj_id, uint16_t inst, uint8_t fill) {
+    uint8_t * frame = &stream[stream_len];
+    uint16_t size = 10 + TALK_OBJ_SIZE;
+
+    frame[0] = UAVTALK_SYNC_VAL;
+    frame[1] = UAVTALK_TYPE_OBJ;
+    frame[2] = size & 0xFF;
+    frame[3] = size >> 8;
+    for (uint32_t i = 0; i < 4; i++)
+      frame[4 + i] = (obj_id >> (8 * i)) & 0xFF;
+    frame[8] = inst & 0xFF;
+    frame[9] = inst >> 8;
+    for (uint32_t i = 0; i < TALK_OBJ_SIZE; i++)
+      frame[10 + i] = fill + i;
+    frame[size] = PIOS_CRC_updateCRC(0, frame, size);
+
+    stream_len += size + 1;
+  }
+
+  /* Clear everything the previous run received */
+  void reset() {
+    uint8_t data[TALK_OBJ_SIZE];
+    memset(data, 0, sizeof(data));
+    for (uint16_t inst = 0; inst < UAVObjGetNumInstances(obj); inst++)
+      UAVObjSetInstanceData(obj, inst, data);
+    UAVTalkResetStats(connection);
+  }
+
+  /* Every good frame was unpacked and nothing else */
+  void checkReceived() {
+    uint8_t data[TALK_OBJ_SIZE];
+
+    EXPECT_EQ(TALK_INSTANCES, UAVObjGetNumInstances(obj));
+    for (uint16_t inst = 0; inst < TALK_INSTANCES; inst++) {
+      ASSERT_EQ(0, UAVObjGetInstanceData(obj, inst, data));
+      for (uint32_t i = 0; i < TALK_OBJ_SIZE; i++) {
+        if (data[i] != (uint8_t)(inst * 16 + i)) {
+          ADD_FAILURE() << "instance " << inst << " byte " << i;
+          return;
+        }
+      }
+    }
+
+    UAVTalkStats stats;
+    UAVTalkGetStats(connection, &stats);
+    EXPECT_EQ(stream_len, stats.rxBytes);
+    EXPECT_EQ(TALK_INSTANCES + 1U, stats.rxObjects);
+    /* The instance id of the unknown object is counted as payload */
+    EXPECT_EQ((TALK_INSTANCES + 1U) * TALK_OBJ_SIZE + 2, stats.rxObjectBytes);
+    EXPECT_EQ(1U, stats.rxErrors);
+  }
+
+  UAVObjHandle obj;
+  UAVTalkConnection connection;
+  uint8_t stream[TALK_STREAM_SIZE];
+  uint32_t stream_len;
+};
+
+TEST_F(UAVTalkParserTest, ByteByByte) {
+  for (uint32_t i = 0; i < stream_len; i++)
+    UAVTalkProcessInputStream(connection, stream[i]);
+
+  checkReceived();
+}
+
+TEST_F(UAVTalkParserTest, ConcatenatedFrames) {
+  EXPECT_EQ(UAVTALK_STATE_COMPLETE, UAVTalkProcessInputBuffer(connection, stream, stream_len));
+
+  checkReceived();
+}
+
+TEST_F(UAVTalkParserTest, SplitFrames) {
+  /* Every possible split of the stream into two reads */
+  for (uint32_t split = 1; split < stream_len; split++) {
+    reset();
+    UAVTalkProcessInputBuffer(connection, stream, split);
+    UAVTalkProcessInputBuffer(connection, &stream[split], stream_len - split);
+
+    SCOPED_TRACE(split);
+    checkReceived();
+  }
+}
+
+TEST_F(UAVTalkParserTest, RandomReads) {
+  srand(5678);
+  for (uint32_t round = 0; round < TALK_SPLIT_ROUNDS; round++) {
+    reset();
+    for (uint32_t pos = 0; pos < stream_len; ) {
+      uint32_t len = 1 + rand() % 40;
+      if (len > stream_len - pos)
+        len = stream_len - pos;
+      UAVTalkProcessInputBuffer(connection, &stream[pos], len);
+      pos += len;
+    }
+
+    SCOPED_TRACE(round);
+    checkReceived();
+  }
+}
+
+/* Output calls seen by the batching tests */
+#define BATCH_MAX_CALLS 16
+
+/* Packet lengths of the test objects */
+#define SINGLE_LEN (8 + OBJ_SIZE + 1)
+#define MULTI_LEN (10 + OBJ_SIZE + 1)
+static uint32_t batch_calls;
+static int32_t batch_call_len[BATCH_MAX_CALLS];
+
+static int32_t record_output(uint8_t * /* data */, int32_t length)
+{
+  if (batch_calls < BATCH_MAX_CALLS)
+    batch_call_len[batch_calls] = length;
+  batch_calls++;
+  return length;
+}
+
+class UAVTalkBatchTest : public UAVObjManagerTest {
+protected:
+  virtual void SetUp() {
+    UAVObjManagerTest::SetUp();
+
+    connection = UAVTalkInitialize(record_output);
+    ASSERT_TRUE(connection != NULL);
+    batch_calls = 0;
+
+    /* handles[0] has several instances, handles[1] is single instance */
+    multi = handles[0];
+    ASSERT_FALSE(UAVObjIsSingleInstance(multi));
+    ASSERT_EQ(1, UAVObjCreateInstance(multi, NULL));
+    ASSERT_EQ(2, UAVObjCreateInstance(multi, NULL));
+    single = handles[1];
+    ASSERT_TRUE(UAVObjIsSingleInstance(single));
+  }
+
+  UAVTalkConnection connection;
+  UAVObjHandle multi;
+  UAVObjHandle single;
+};
+
+struct batch_sender {
+  UAVTalkConnection connection;
+  UAVObjHandle obj;
+  bool batch;
+  uint32_t calls_after;
+};
+
+/* Another task sending while the test thread has a batch open */
+static void * batch_send_thread(void * arg)
+{
+  struct batch_sender * sender = (struct batch_sender *) arg;
+
+  if (sender->batch)
+    UAVTalkBeginBatch(sender->connection);
+  UAVTalkSendObject(sender->connection, sender->obj, 0, 0, 0);
+  sender->calls_after = batch_calls;
+  if (sender->batch)
+    UAVTalkEndBatch(sender->connection);
+
+  return NULL;
+}
+
+TEST_F(UAVTalkBatchTest, AllInstancesInOneCall) {
+  EXPECT_EQ(0, UAVTalkSendObject(connection, multi, UAVOBJ_ALL_INSTANCES, 0, 0));
+
+  ASSERT_EQ(1U, batch_calls);
+  EXPECT_EQ(3 * MULTI_LEN, batch_call_len[0]);
+}
+
+TEST_F(UAVTalkBatchTest, BatchCoalesces) {
+  UAVTalkBeginBatch(connection);
+  UAVTalkSendObject(connection, single, 0, 0, 0);
+  UAVTalkSendObject(connection, multi, UAVOBJ_ALL_INSTANCES, 0, 0);
+  UAVTalkSendObject(connection, single, 0, 0, 0);
+  EXPECT_EQ(0U, batch_calls);
+
+  EXPECT_EQ(0, UAVTalkEndBatch(connection));
+  ASSERT_EQ(1U, batch_calls);
+  EXPECT_EQ(2 * SINGLE_LEN + 3 * MULTI_LEN, batch_call_len[0]);
+}
+
+TEST_F(UAVTalkBatchTest, OtherTaskSendsImmediately) {
+  struct batch_sender sender = { connection, single, false, 0 };
+  pthread_t thread;
+
+  UAVTalkBeginBatch(connection);
+  UAVTalkSendObject(connection, multi, 1, 0, 0);
+  EXPECT_EQ(0U, batch_calls);
+
+  /* The other task does not wait for our batch and takes it along */
+  ASSERT_EQ(0, pthread_create(&thread, NULL, batch_send_thread, &sender));
+  pthread_join(thread, NULL);
+  EXPECT_EQ(1U, sender.calls_after);
+  ASSERT_EQ(1U, batch_calls);
+  EXPECT_EQ(MULTI_LEN + SINGLE_LEN, batch_call_len[0]);
+
+  /* Our batch is still open */
+  UAVTalkSendObject(connection, multi, 2, 0, 0);
+  EXPECT_EQ(1U, batch_calls);
+  EXPECT_EQ(0, UAVTalkEndBatch(connection));
+  ASSERT_EQ(2U, batch_calls);
+  EXPECT_EQ(MULTI_LEN, batch_call_len[1]);
+}
+
+TEST_F(UAVTalkBatchTest, OtherTaskBatchIgnored) {
+  struct batch_sender sender = { connection, single, true, 0 };
+  pthread_t thread;
+
+  UAVTalkBeginBatch(connection);
+  UAVTalkSendObject(connection, multi, 1, 0, 0);
+
+  /* Its batch neither holds its own packet back nor ends ours */
+  ASSERT_EQ(0, pthread_create(&thread, NULL, batch_send_thread, &sender));
+  pthread_join(thread, NULL);
+  EXPECT_EQ(1U, sender.calls_after);
+
+  UAVTalkSendObject(connection, multi, 2, 0, 0);
+  EXPECT_EQ(1U, batch_calls);
+  EXPECT_EQ(0, UAVTalkEndBatch(connection));
+  EXPECT_EQ(2U, batch_calls);
+}
+
+/* Completions seen by the transaction tests */
+struct trans_result {
+  uint32_t calls;
+  bool success;
+  uint8_t retries;
+  bool lock_free;
+};
+static struct trans_result trans_result;
+static UAVTalkConnection trans_connection;
+
+static void * try_connection_lock(void * arg)
+{
+  UAVTalkConnectionData * connection = (UAVTalkConnectionData *) trans_connection;
+  bool * lock_free = (bool *) arg;
+
+  *lock_free = xSemaphoreTakeRecursive(connection->lock, 0) == pdTRUE;
+  if (*lock_free)
+    xSemaphoreGiveRecursive(connection->lock);
+
+  return NULL;
+}
+
+static void transaction_done(UAVObjHandle /* obj */, uint16_t /* instId */, bool success, uint8_t retries)
+{
+  pthread_t thread;
+
+  trans_result.calls++;
+  trans_result.success = success;
+  trans_result.retries = retries;
+
+  /* Another task must be able to use the connection while this runs */
+  pthread_create(&thread, NULL, try_connection_lock, &trans_result.lock_free);
+  pthread_join(thread, NULL);
+}
+
+class UAVTalkTransactionTest : public UAVTalkBatchTest {
+protected:
+  virtual void SetUp() {
+    UAVTalkBatchTest::SetUp();
+
+    trans_connection = connection;
+    memset(&trans_result, 0, sizeof(trans_result));
+  }
+
+  /* Feed the connection a frame without payload for the single instance object */
+  void receive(uint8_t type) {
+    uint8_t frame[9];
+    uint32_t obj_id = UAVObjGetID(single);
+
+    frame[0] = UAVTALK_SYNC_VAL;
+    frame[1] = type;
+    frame[2] = 8;
+    frame[3] = 0;
+    for (uint32_t i = 0; i < 4; i++)
+      frame[4 + i] = (obj_id >> (8 * i)) & 0xFF;
+    frame[8] = PIOS_CRC_updateCRC(0, frame, 8);
+
+    UAVTalkProcessInputBuffer(connection, frame, sizeof(frame));
+  }
+};
+
+TEST_F(UAVTalkTransactionTest, AckRunsCallbackUnlocked) {
+  EXPECT_EQ(0, UAVTalkSendObjectPipelined(connection, single, 0, 1, 1000, transaction_done));
+  EXPECT_EQ(1U, batch_calls);
+  EXPECT_EQ(0U, trans_result.calls);
+
+  receive(UAVTALK_TYPE_ACK);
+  EXPECT_EQ(1U, trans_result.calls);
+  EXPECT_TRUE(trans_result.success);
+  EXPECT_EQ(0, trans_result.retries);
+  EXPECT_TRUE(trans_result.lock_free);
+
+  /* A second ACK matches nothing */
+  receive(UAVTALK_TYPE_ACK);
+  EXPECT_EQ(1U, trans_result.calls);
+}
+
+TEST_F(UAVTalkTransactionTest, NackFailsImmediately) {
+  EXPECT_EQ(0, UAVTalkSendObjectPipelined(connection, single, 0, 3, 1000, transaction_done));
+
+  receive(UAVTALK_TYPE_NACK);
+  EXPECT_EQ(1U, trans_result.calls);
+  EXPECT_FALSE(trans_result.success);
+  EXPECT_TRUE(trans_result.lock_free);
+}
+
+TEST_F(UAVTalkTransactionTest, TimeoutRetriesThenFails) {
+  struct timespec wait = { 0, 30 * 1000000L };
+
+  EXPECT_EQ(0, UAVTalkSendObjectPipelined(connection, single, 0, 1, 20, transaction_done));
+  EXPECT_EQ(1U, batch_calls);
+
+  /* The first timeout resends, the second one runs out of retries */
+  nanosleep(&wait, NULL);
+  UAVTalkProcessTransactions(connection);
+  EXPECT_EQ(2U, batch_calls);
+  EXPECT_EQ(0U, trans_result.calls);
+
+  nanosleep(&wait, NULL);
+  EXPECT_EQ(portMAX_DELAY, UAVTalkProcessTransactions(connection));
+  EXPECT_EQ(1U, trans_result.calls);
+  EXPECT_FALSE(trans_result.success);
+  EXPECT_EQ(1, trans_result.retries);
+  EXPECT_TRUE(trans_result.lock_free);
+}
+
+TEST_F(UAVTalkTransactionTest, CompletedSlotsAreReused) {
+  /* Far more transactions than slots, each acknowledged in turn */
+  for (uint32_t i = 0; i < 4 * UAVTALK_MAX_TRANSACTIONS; i++) {
+    EXPECT_EQ(0, UAVTalkSendObjectPipelined(connection, single, 0, 0, 1000, transaction_done));
+    receive(UAVTALK_TYPE_ACK);
+  }
+  EXPECT_EQ(4U * UAVTALK_MAX_TRANSACTIONS, trans_result.calls);
+}
+
+/* Output captured by the delta frame tests, one buffer per end of the link */
+#define DELTA_CAPTURE_SIZE 512
+#define DELTA_UPDATES (2 * (UAVTALK_DELTA_FULL_INTERVAL + 1) + 1)
+#define DELTA_INST 3
+
+struct delta_capture {
+  uint8_t data[DELTA_CAPTURE_SIZE];
+  uint32_t len;
+};
+static struct delta_capture delta_sent;
+static struct delta_capture delta_replies;
+
+static int32_t capture(struct delta_capture * out, uint8_t * data, int32_t length)
+{
+  if (out->len + length <= DELTA_CAPTURE_SIZE) {
+    memcpy(&out->data[out->len], data, length);
+    out->len += length;
+  }
+  return length;
+}
+
+static int32_t capture_sent(uint8_t * data, int32_t length)
+{
+  return capture(&delta_sent, data, length);
+}
+
+static int32_t capture_replies(uint8_t * data, int32_t length)
+{
+  return capture(&delta_replies, data, length);
+}
+
+class UAVTalkDeltaTest : public UAVObjManagerTest {
+protected:
+  virtual void SetUp() {
+    UAVObjManagerTest::SetUp();
+
+    obj = UAVObjRegister(TALK_OBJ_ID, false, false, TALK_OBJ_SIZE, 1, NULL);
+    ASSERT_TRUE(obj != NULL);
+    for (uint16_t inst = 1; inst <= DELTA_INST; inst++)
+      ASSERT_EQ(inst, UAVObjCreateInstance(obj, NULL));
+
+    sender = UAVTalkInitialize(capture_sent);
+    ASSERT_TRUE(sender != NULL);
+    ASSERT_EQ(0, UAVTalkSetDeltaCompression(sender, true));
+    receiver = UAVTalkInitialize(capture_replies);
+    ASSERT_TRUE(receiver != NULL);
+
+    memset(&delta_sent, 0, sizeof(delta_sent));
+    memset(&delta_replies, 0, sizeof(delta_replies));
+  }
+
+  /* The data of update n, a few bytes change from one update to the next */
+  static void value(uint32_t n, uint8_t * data) {
+    for (uint32_t i = 0; i < TALK_OBJ_SIZE; i++)
+      data[i] = i;
+    for (uint32_t k = 1; k <= n; k++) {
+      data[(k * 7) % TALK_OBJ_SIZE] += k;
+      data[(k * 13) % TALK_OBJ_SIZE] ^= 0x5A;
+    }
+  }
+
+  /* Send update n and return the frame that went out */
+  void send(uint32_t n) {
+    uint8_t data[TALK_OBJ_SIZE];
+    value(n, data);
+    ASSERT_EQ(0, UAVObjSetInstanceData(obj, DELTA_INST, data));
+    delta_sent.len = 0;
+    ASSERT_EQ(0, UAVTalkSendObject(sender, obj, DELTA_INST, 0, 0));
+    ASSERT_GT(delta_sent.len, 0U);
+  }
+
+  /* Both ends share one object manager, give the receiver back its own copy before it gets the frame */
+  void receive(const uint8_t * base) {
+    ASSERT_EQ(0, UAVObjSetInstanceData(obj, DELTA_INST, base));
+    UAVTalkProcessInputBuffer(receiver, delta_sent.data, delta_sent.len);
+  }
+
+  bool instanceIs(uint32_t n) {
+    uint8_t data[TALK_OBJ_SIZE];
+    uint8_t expected[TALK_OBJ_SIZE];
+    value(n, expected);
+    UAVObjGetInstanceData(obj, DELTA_INST, data);
+    return memcmp(data, expected, TALK_OBJ_SIZE) == 0;
+  }
+
+  UAVObjHandle obj;
+  UAVTalkConnection sender;
+  UAVTalkConnection receiver;
+};
+
+TEST_F(UAVTalkDeltaTest, RoundTrip) {
+  uint8_t base[TALK_OBJ_SIZE];
+  uint32_t deltas = 0;
+
+  for (uint32_t n = 0; n < DELTA_UPDATES; n++) {
+    send(n);
+    value(n == 0 ? 0 : n - 1, base);
+
+    /* The first update and every one after a run of deltas goes out in full */
+    bool full = (n % (UAVTALK_DELTA_FULL_INTERVAL + 1)) == 0;
+    EXPECT_EQ(full ? UAVTALK_TYPE_OBJ : UAVTALK_TYPE_OBJ_DELTA, delta_sent.data[1]) << n;
+    if (!full) {
+      EXPECT_LT(delta_sent.len, 10U + TALK_OBJ_SIZE + 1) << n;
+      deltas++;
+    }
+
+    receive(base);
+    EXPECT_TRUE(instanceIs(n)) << n;
+  }
+  EXPECT_EQ(2U * UAVTALK_DELTA_FULL_INTERVAL, deltas);
+
+  UAVTalkStats stats;
+  UAVTalkGetStats(receiver, &stats);
+  EXPECT_EQ((uint32_t)DELTA_UPDATES, stats.rxObjects);
+  EXPECT_EQ(0U, stats.rxErrors);
+  EXPECT_EQ(0U, delta_replies.len);
+}
+
+TEST_F(UAVTalkDeltaTest, ByteByByte) {
+  uint8_t base[TALK_OBJ_SIZE];
+
+  send(0);
+  send(1);
+  ASSERT_EQ(UAVTALK_TYPE_OBJ_DELTA, delta_sent.data[1]);
+
+  value(0, base);
+  ASSERT_EQ(0, UAVObjSetInstanceData(obj, DELTA_INST, base));
+  for (uint32_t i = 0; i < delta_sent.len; i++)
+    UAVTalkProcessInputStream(receiver, delta_sent.data[i]);
+  EXPECT_TRUE(instanceIs(1));
+}
+
+TEST_F(UAVTalkDeltaTest, MismatchRequestsFullObject) {
+  uint8_t base[TALK_OBJ_SIZE];
+
+  send(0);
+  send(1);
+  ASSERT_EQ(UAVTALK_TYPE_OBJ_DELTA, delta_sent.data[1]);
+
+  /* The receiver missed update 0, the delta does not apply to what it has */
+  value(5, base);
+  receive(base);
+  EXPECT_TRUE(instanceIs(5));
+
+  UAVTalkStats stats;
+  UAVTalkGetStats(receiver, &stats);
+  EXPECT_EQ(1U, stats.rxErrors);
+
+  /* It asks for the whole object instead */
+  ASSERT_EQ(11U, delta_replies.len);
+  EXPECT_EQ(UAVTALK_TYPE_OBJ_REQ, delta_replies.data[1]);
+  EXPECT_EQ(DELTA_INST, delta_replies.data[8]);
+
+  /* Which the sender answers in full even though it has a valid base */
+  value(1, base);
+  ASSERT_EQ(0, UAVObjSetInstanceData(obj, DELTA_INST, base));
+  delta_sent.len = 0;
+  UAVTalkProcessInputBuffer(sender, delta_replies.data, delta_replies.len);
+  ASSERT_EQ(10U + TALK_OBJ_SIZE + 1, delta_sent.len);
+  EXPECT_EQ(UAVTALK_TYPE_OBJ, delta_sent.data[1]);
+
+  value(5, base);
+  receive(base);
+  EXPECT_TRUE(instanceIs(1));
+}
+
+TEST_F(UAVTalkDeltaTest, MalformedRunsIgnored) {
+  uint8_t base[TALK_OBJ_SIZE];
+
+  send(0);
+  send(1);
+  ASSERT_EQ(UAVTALK_TYPE_OBJ_DELTA, delta_sent.data[1]);
+
+  /* A run reaching past the end of the object, the frame checksum is still right */
+  delta_sent.data[10 + 2] = TALK_OBJ_SIZE - 1;
+  delta_sent.data[delta_sent.len - 1] = PIOS_CRC_updateCRC(0, delta_sent.data, delta_sent.len - 1);
+
+  value(0, base);
+  receive(base);
+  EXPECT_TRUE(instanceIs(0));
+  EXPECT_EQ(UAVTALK_TYPE_OBJ_REQ, delta_replies.data[1]);
+}
+
+TEST_F(UAVTalkDeltaTest, RelayedUnchanged) {
+  send(0);
+  send(1);
+  ASSERT_EQ(UAVTALK_TYPE_OBJ_DELTA, delta_sent.data[1]);
+
+  for (uint32_t i = 0; i < delta_sent.len; i++)
+    EXPECT_NE(UAVTALK_STATE_ERROR, UAVTalkRelayInputStream(receiver, delta_sent.data[i]));
+
+  ASSERT_EQ(delta_sent.len, delta_replies.len);
+  EXPECT_EQ(0, memcmp(delta_sent.data, delta_replies.data, delta_sent.len));
+}
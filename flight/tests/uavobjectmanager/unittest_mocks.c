@@ -0,0 +1,232 @@
+/*
+ * Minimal stand-ins for the FreeRTOS, event dispatcher and flash filesystem
+ * services used by the object manager and UAVTalk. The locks and semaphores
+ * are real as some of the tests run several threads.
+ */
+
+#include "openpilot.h"
+#include "pios_heap.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+uintptr_t pios_uavo_settings_fs_id;
+
+/* A real recursive mutex, the tests exercise the object manager from several threads */
+static pthread_mutex_t object_mutex;
+static pthread_once_t object_mutex_once = PTHREAD_ONCE_INIT;
+
+static void object_mutex_init(void)
+{
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&object_mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+xSemaphoreHandle xSemaphoreCreateRecursiveMutex(void)
+{
+	pthread_once(&object_mutex_once, object_mutex_init);
+	return &object_mutex;
+}
+
+int32_t xSemaphoreTakeRecursive(xSemaphoreHandle sema, uint32_t ticks)
+{
+	if (ticks == 0)
+		return pthread_mutex_trylock((pthread_mutex_t *) sema) == 0 ? pdTRUE : pdFALSE;
+
+	return pthread_mutex_lock((pthread_mutex_t *) sema) == 0 ? pdTRUE : pdFALSE;
+}
+
+int32_t xSemaphoreGiveRecursive(xSemaphoreHandle sema)
+{
+	return pthread_mutex_unlock((pthread_mutex_t *) sema) == 0 ? pdTRUE : pdFALSE;
+}
+
+/* Binary semaphores and ticks for the UAVTalk transactions */
+struct ut_semaphore {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int given;
+};
+
+xSemaphoreHandle ut_semaphore_create_binary(void)
+{
+	struct ut_semaphore *sema = malloc(sizeof(*sema));
+
+	if (sema == NULL)
+		return NULL;
+
+	pthread_mutex_init(&sema->lock, NULL);
+	pthread_cond_init(&sema->cond, NULL);
+
+	// FreeRTOS creates binary semaphores given
+	sema->given = 1;
+
+	return sema;
+}
+
+int32_t xSemaphoreTake(xSemaphoreHandle handle, portTickType ticks)
+{
+	struct ut_semaphore *sema = (struct ut_semaphore *) handle;
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += ticks / 1000;
+	deadline.tv_nsec += (ticks % 1000) * 1000000L;
+	if (deadline.tv_nsec >= 1000000000L) {
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000L;
+	}
+
+	pthread_mutex_lock(&sema->lock);
+	while (!sema->given) {
+		if (pthread_cond_timedwait(&sema->cond, &sema->lock, &deadline) == ETIMEDOUT)
+			break;
+	}
+	int32_t result = sema->given ? pdTRUE : pdFALSE;
+	sema->given = 0;
+	pthread_mutex_unlock(&sema->lock);
+
+	return result;
+}
+
+int32_t xSemaphoreGive(xSemaphoreHandle handle)
+{
+	struct ut_semaphore *sema = (struct ut_semaphore *) handle;
+
+	pthread_mutex_lock(&sema->lock);
+	int32_t result = sema->given ? pdFALSE : pdTRUE;
+	sema->given = 1;
+	pthread_cond_signal(&sema->cond);
+	pthread_mutex_unlock(&sema->lock);
+
+	return result;
+}
+
+portTickType xTaskGetTickCount(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/* Each thread stands in for a task */
+static __thread char current_task;
+
+xTaskHandle xTaskGetCurrentTaskHandle(void)
+{
+	return &current_task;
+}
+
+int32_t xQueueSend(xQueueHandle queue, const void * item, uint32_t ticks)
+{
+	return pdTRUE;
+}
+
+int32_t PIOS_IRQ_Disable(void)
+{
+	return 0;
+}
+
+int32_t PIOS_IRQ_Enable(void)
+{
+	return 0;
+}
+
+uint32_t PIOS_DELAY_GetRaw(void)
+{
+	return 0;
+}
+
+uint32_t PIOS_DELAY_DiffuS(uint32_t raw)
+{
+	return 0;
+}
+
+int32_t EventCallbackDispatch(UAVObjEvent * ev, UAVObjEventCallback cb)
+{
+	return pdTRUE;
+}
+
+/* A small in memory settings filesystem */
+#define MOCK_FLASH_SLOTS 8
+#define MOCK_FLASH_SLOT_SIZE 256
+
+static struct {
+	bool     used;
+	uint32_t obj_id;
+	uint16_t obj_inst_id;
+	uint16_t obj_size;
+	uint8_t  data[MOCK_FLASH_SLOT_SIZE];
+} mock_flash[MOCK_FLASH_SLOTS];
+
+/* Called in the middle of every save, lets a test act while the flash is busy */
+void (*mock_flash_save_hook)(void);
+
+static int mock_flash_find(uint32_t obj_id, uint16_t obj_inst_id)
+{
+	for (int i = 0; i < MOCK_FLASH_SLOTS; i++) {
+		if (mock_flash[i].used && mock_flash[i].obj_id == obj_id && mock_flash[i].obj_inst_id == obj_inst_id)
+			return i;
+	}
+	return -1;
+}
+
+int32_t PIOS_FLASHFS_ObjSave(uintptr_t fs_id, uint32_t obj_id, uint16_t obj_inst_id, uint8_t * obj_data, uint16_t obj_size)
+{
+	int slot = mock_flash_find(obj_id, obj_inst_id);
+	for (int i = 0; slot < 0 && i < MOCK_FLASH_SLOTS; i++) {
+		if (!mock_flash[i].used)
+			slot = i;
+	}
+	if (slot < 0 || obj_size > MOCK_FLASH_SLOT_SIZE)
+		return -1;
+
+	if (mock_flash_save_hook)
+		mock_flash_save_hook();
+
+	mock_flash[slot].used = true;
+	mock_flash[slot].obj_id = obj_id;
+	mock_flash[slot].obj_inst_id = obj_inst_id;
+	mock_flash[slot].obj_size = obj_size;
+	memcpy(mock_flash[slot].data, obj_data, obj_size);
+	return 0;
+}
+
+int32_t PIOS_FLASHFS_ObjLoad(uintptr_t fs_id, uint32_t obj_id, uint16_t obj_inst_id, uint8_t * obj_data, uint16_t obj_size)
+{
+	int slot = mock_flash_find(obj_id, obj_inst_id);
+	if (slot < 0 || mock_flash[slot].obj_size != obj_size)
+		return -1;
+
+	memcpy(obj_data, mock_flash[slot].data, obj_size);
+	return 0;
+}
+
+int32_t PIOS_FLASHFS_ObjDelete(uintptr_t fs_id, uint32_t obj_id, uint16_t obj_inst_id)
+{
+	int slot = mock_flash_find(obj_id, obj_inst_id);
+	if (slot < 0)
+		return -1;
+
+	mock_flash[slot].used = false;
+	return 0;
+}
+
+void * PIOS_malloc(size_t size)
+{
+	return malloc(size);
+}
+
+void * PIOS_malloc_no_dma(size_t size)
+{
+	return malloc(size);
+}
+
+void PIOS_free(void * buf)
+{
+	free(buf);
+}
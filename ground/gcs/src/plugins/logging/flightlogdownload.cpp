@@ -0,0 +1,141 @@
+/**
+ ******************************************************************************
+ *
+ * @file       flightlogdownload.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @brief      Downloads a log recorded by the onboard Logging module
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "flightlogdownload.h"
+#include <QDebug>
+
+FlightLogDownload::FlightLogDownload(UAVObjectManager *objMngr, QObject *parent) :
+    QObject(parent),
+    fileId(0),
+    sector(0),
+    retries(0),
+    active(false)
+{
+    loggingStats = LoggingStats::GetInstance(objMngr);
+    Q_ASSERT(loggingStats);
+
+    timer.setSingleShot(true);
+    connect(&timer, SIGNAL(timeout()), this, SLOT(timeout()));
+}
+
+/**
+ * Start downloading a file
+ * @param fileId id of the file on the board
+ * @param fileName local file to write
+ * @return false if the local file cannot be written
+ */
+bool FlightLogDownload::start(quint16 fileId, const QString &fileName)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    this->fileId = fileId;
+    sector = 0;
+    active = true;
+    connect(loggingStats, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(statsUpdated(UAVObject*)));
+    requestSector();
+    return true;
+}
+
+void FlightLogDownload::requestSector()
+{
+    retries = 0;
+    sendRequest();
+}
+
+void FlightLogDownload::sendRequest()
+{
+    LoggingStats::DataFields stats = loggingStats->getData();
+    stats.Operation = LoggingStats::OPERATION_DOWNLOAD;
+    stats.FileRequest = fileId;
+    stats.FileSectorNum = sector;
+    loggingStats->setData(stats);
+    loggingStats->updated();
+
+    timer.start(REQUEST_TIMEOUT_MS);
+}
+
+void FlightLogDownload::statsUpdated(UAVObject *obj)
+{
+    Q_UNUSED(obj);
+
+    LoggingStats::DataFields stats = loggingStats->getData();
+
+    // Ignore our own request and stale answers
+    if (!active || stats.Operation == LoggingStats::OPERATION_DOWNLOAD)
+        return;
+
+    if (stats.Operation != LoggingStats::OPERATION_COMPLETE) {
+        qDebug() << "Flight log download failed at sector" << sector;
+        finish(false);
+        return;
+    }
+
+    if (stats.FileRequest != fileId || stats.FileSectorNum != sector)
+        return;
+
+    timer.stop();
+    file.write((const char *) stats.FileSector, stats.FileSectorBytes);
+    emit progress(file.size());
+
+    // A short sector is the end of the file
+    if (stats.FileSectorBytes < LoggingStats::FILESECTOR_NUMELEM) {
+        finish(true);
+        return;
+    }
+
+    sector++;
+    requestSector();
+}
+
+void FlightLogDownload::timeout()
+{
+    if (++retries > MAX_RETRIES) {
+        qDebug() << "Flight log download timed out at sector" << sector;
+        finish(false);
+        return;
+    }
+
+    // Ask for the same sector again
+    sendRequest();
+}
+
+void FlightLogDownload::finish(bool success)
+{
+    active = false;
+    timer.stop();
+    disconnect(loggingStats, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(statsUpdated(UAVObject*)));
+    file.close();
+
+    // Let the logger return to idle
+    LoggingStats::DataFields stats = loggingStats->getData();
+    stats.Operation = LoggingStats::OPERATION_IDLE;
+    loggingStats->setData(stats);
+    loggingStats->updated();
+
+    emit finished(success);
+}
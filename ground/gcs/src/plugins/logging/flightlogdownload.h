@@ -0,0 +1,73 @@
+/**
+ ******************************************************************************
+ *
+ * @file       flightlogdownload.h
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @brief      Downloads a log recorded by the onboard Logging module
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef FLIGHTLOGDOWNLOAD_H
+#define FLIGHTLOGDOWNLOAD_H
+
+#include <QObject>
+#include <QFile>
+#include <QTimer>
+#include "uavobjectmanager.h"
+#include "loggingstats.h"
+
+/**
+ * Copies a file from the onboard log partition into a local file, one
+ * sector at a time through LoggingStats.  The file already is in the
+ * format of the GCS LogFile and can be replayed as is.
+ */
+class FlightLogDownload : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FlightLogDownload(UAVObjectManager *objMngr, QObject *parent = 0);
+    bool start(quint16 fileId, const QString &fileName);
+
+signals:
+    void progress(qint64 bytes);
+    void finished(bool success);
+
+private slots:
+    void statsUpdated(UAVObject *obj);
+    void timeout();
+
+private:
+    void requestSector();
+    void sendRequest();
+    void finish(bool success);
+
+    static const int REQUEST_TIMEOUT_MS = 500;
+    static const int MAX_RETRIES = 5;
+
+    LoggingStats *loggingStats;
+    QFile file;
+    QTimer timer;
+    quint16 fileId;
+    quint16 sector;
+    int retries;
+    bool active;
+};
+
+#endif // FLIGHTLOGDOWNLOAD_H
@@ -29,17 +29,79 @@
 #include <QDebug>
 #include <QtGlobal>
 #include <QTextStream>
- #include <QMessageBox>
+#include <string.h>
 
 // autogenerated version info string. MUST GO BEFORE coreconstants.h INCLUDE
 #include "../../../../../build/ground/gcs/gcsversioninfo.h"
 
 #include <coreplugin/coreconstants.h>
 
+/**
+ * Log files are a sequence of records, each made of a 32 bit timestamp,
+ * a 64 bit payload size and the payload.  Version 2 files group the records
+ * into blocks and append one more record holding an index of those blocks
+ * so that long logs can be opened and seeked without reading them. The
+ * index record ends with its own file offset and a magic string so it can
+ * be located from the end of the file.  Older readers simply see it as one
+ * more packet of garbage at the end of the log.
+ */
+#define LOG_RECORD_HEADER_SIZE  ((qint64)(sizeof(quint32) + sizeof(qint64)))
+#define LOG_INDEX_VERSION       2
+#define LOG_INDEX_ENTRY_SIZE    28
+#define LOG_INDEX_MAGIC         "TLLINDEX"
+#define LOG_INDEX_MAGIC_SIZE    8
+#define LOG_INDEX_BLOCK_SIZE    (64 * 1024)
+#define LOG_MAX_PACKET_SIZE     (1024 * 1024)
+
+/**
+ * Update a CRC32 (IEEE 802.3) with more data
+ */
+static quint32 updateCrc32(quint32 crc, const uchar *data, qint64 length)
+{
+    static quint32 table[256];
+    static bool tableValid = false;
+
+    if (!tableValid) {
+        for (quint32 i = 0; i < 256; i++) {
+            quint32 c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        tableValid = true;
+    }
+
+    crc = ~crc;
+    for (qint64 i = 0; i < length; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+template <typename T> static void appendRaw(QByteArray &buf, T value)
+{
+    buf.append((const char *) &value, sizeof(value));
+}
+
+template <typename T> static T readRaw(const uchar *data)
+{
+    T value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
 LogFile::LogFile(QObject *parent) :
     QIODevice(parent),
-    timestampBufferIdx(0)
+    dataBufferPos(0),
+    fileData(NULL),
+    fileDataSize(0),
+    dataStart(0),
+    dataEnd(0),
+    readPos(0),
+    currentBlock(0),
+    firstTimestamp(0),
+    lastWriteTimeStamp(0)
 {
+    writeBlock.count = 0;
     connect(&timer, SIGNAL(timeout()), this, SLOT(timerFired()));
 }
 
@@ -94,31 +156,25 @@ bool LogFile::open(OpenMode mode) {
         QString uavoHash = QString::fromLatin1(Core::Constants::UAVOSHA1_STR).replace("\"{ ", "").replace(" }\"", "").replace(",", "").replace("0x", ""); // See comment above for necessity for string replacements
 
         if(logUAVOHashString != uavoHash){
-            QMessageBox msgBox;
-            msgBox.setText("Likely log file incompatibility.");
-            msgBox.setInformativeText(QString("The log file was made with branch %1, UAVO hash %2. GCS will attempt to play the file.").arg(logGitHashString).arg(logUAVOHashString));
-            msgBox.exec();
+            emit replayWarning(tr("Likely log file incompatibility."),
+                               tr("The log file was made with branch %1, UAVO hash %2. GCS will attempt to play the file.").arg(logGitHashString).arg(logUAVOHashString));
         }
         else if(logGitHashString != gitHash){
-            QMessageBox msgBox;
-            msgBox.setText("Possible log file incompatibility.");
-            msgBox.setInformativeText(QString("The log file was made with branch %1. GCS will attempt to play the file.").arg(logGitHashString));
-            msgBox.exec();
+            emit replayWarning(tr("Possible log file incompatibility."),
+                               tr("The log file was made with branch %1. GCS will attempt to play the file.").arg(logGitHashString));
         }
 
-        QString tmpLine=file.readLine(); //Look for the header/body separation string.
+        QString tmpLine=file.readLine().trimmed(); //Look for the header/body separation string.
         int cnt=0;
-        while (tmpLine!="##\n" && cnt < 10 && !file.atEnd()){
+        while (tmpLine!="##" && cnt < 10 && !file.atEnd()){
             tmpLine=file.readLine().trimmed();
             cnt++;
         }
 
         //Check if we reached the end of the file before finding the separation string
-        if (cnt >=10 || file.atEnd()){
-            QMessageBox msgBox;
-            msgBox.setText("Corrupted file.");
-            msgBox.setInformativeText("GCS cannot find the separation byte. GCS will attempt to play the file."); //<--TODO: add hyperlink to webpage with better description.
-            msgBox.exec();
+        if (tmpLine!="##"){
+            emit replayWarning(tr("Corrupted file."),
+                               tr("GCS cannot find the separation byte. GCS will attempt to play the file.")); //<--TODO: add hyperlink to webpage with better description.
 
             //Since we could not find the file separator, we need to return to the beginning of the file
             file.seek(0);
@@ -144,6 +200,19 @@ void LogFile::close()
 
     if (timer.isActive())
         timer.stop();
+
+    // Finish the log with the block index
+    if (file.isOpen() && file.isWritable())
+        writeIndex();
+
+    if (fileData && fileDataFallback.isEmpty())
+        file.unmap(fileData);
+    fileData = NULL;
+    fileDataFallback.clear();
+    fileDataSize = 0;
+    blockIndex.clear();
+    blockVerified.clear();
+
     file.close();
     QIODevice::close();
 }
@@ -154,6 +223,14 @@ qint64 LogFile::writeData(const char * data, qint64 dataSize) {
 
     quint32 timeStamp = myTime.elapsed();
 
+    // Start a new index block
+    if (writeBlock.count == 0) {
+        writeBlock.timestamp = timeStamp;
+        writeBlock.offset = file.pos();
+        writeBlock.size = 0;
+        writeBlock.crc = 0;
+    }
+
     file.write((char *) &timeStamp,sizeof(timeStamp));
     file.write((char *) &dataSize, sizeof(dataSize));
 
@@ -161,144 +238,329 @@ qint64 LogFile::writeData(const char * data, qint64 dataSize) {
     if(written != -1)
         emit bytesWritten(written);
 
+    writeBlock.crc = updateCrc32(writeBlock.crc, (const uchar *) &timeStamp, sizeof(timeStamp));
+    writeBlock.crc = updateCrc32(writeBlock.crc, (const uchar *) &dataSize, sizeof(dataSize));
+    writeBlock.crc = updateCrc32(writeBlock.crc, (const uchar *) data, dataSize);
+    writeBlock.size += LOG_RECORD_HEADER_SIZE + dataSize;
+    writeBlock.count++;
+    lastWriteTimeStamp = timeStamp;
+
+    if (writeBlock.size >= LOG_INDEX_BLOCK_SIZE) {
+        writeBlocks.append(writeBlock);
+        writeBlock.count = 0;
+    }
+
     return dataSize;
 }
 
+/**
+ * Append the block index record to a log that is being written
+ */
+void LogFile::writeIndex()
+{
+    if (writeBlock.count > 0) {
+        writeBlocks.append(writeBlock);
+        writeBlock.count = 0;
+    }
+
+    QByteArray index;
+    appendRaw<quint32>(index, LOG_INDEX_VERSION);
+    appendRaw<quint32>(index, writeBlocks.size());
+    foreach (const IndexBlock &block, writeBlocks) {
+        appendRaw<quint32>(index, block.timestamp);
+        appendRaw<quint32>(index, block.count);
+        appendRaw<quint32>(index, block.crc);
+        appendRaw<qint64>(index, block.offset);
+        appendRaw<qint64>(index, block.size);
+    }
+    appendRaw<quint32>(index, updateCrc32(0, (const uchar *) index.constData(), index.size()));
+
+    qint64 recordOffset = file.pos();
+    appendRaw<qint64>(index, recordOffset);
+    index.append(LOG_INDEX_MAGIC, LOG_INDEX_MAGIC_SIZE);
+
+    qint64 dataSize = index.size();
+    file.write((char *) &lastWriteTimeStamp, sizeof(lastWriteTimeStamp));
+    file.write((char *) &dataSize, sizeof(dataSize));
+    file.write(index);
+
+    writeBlocks.clear();
+}
+
 qint64 LogFile::readData(char * data, qint64 maxSize) {
     QMutexLocker locker(&mutex);
-    qint64 toRead = qMin(maxSize,(qint64)dataBuffer.size());
-    memcpy(data,dataBuffer.data(),toRead);
-    dataBuffer.remove(0,toRead);
+    qint64 toRead = qMin(maxSize,(qint64)(dataBuffer.size() - dataBufferPos));
+    memcpy(data,dataBuffer.constData() + dataBufferPos,toRead);
+    dataBufferPos += toRead;
+
+    // Drop consumed data once it dominates the buffer, keeping reads O(1) on average
+    if (dataBufferPos == dataBuffer.size()) {
+        dataBuffer.clear();
+        dataBufferPos = 0;
+    } else if (dataBufferPos > 4096 && dataBufferPos > dataBuffer.size() / 2) {
+        dataBuffer.remove(0, dataBufferPos);
+        dataBufferPos = 0;
+    }
+
     return toRead;
 }
 
 qint64 LogFile::bytesAvailable() const
 {
-    return dataBuffer.size();
+    return dataBuffer.size() - dataBufferPos;
 }
 
-void LogFile::timerFired()
+/**
+ * Read the header of the record at a given file offset
+ * @return false if the record is truncated or corrupt
+ */
+bool LogFile::readRecordHeader(qint64 pos, quint32 &timeStamp, qint64 &dataSize) const
 {
-    qint64 dataSize;
+    if (pos + LOG_RECORD_HEADER_SIZE > dataEnd)
+        return false;
 
-    if(file.bytesAvailable() > 4)
-    {
+    timeStamp = readRaw<quint32>(fileData + pos);
+    dataSize = readRaw<qint64>(fileData + pos + sizeof(quint32));
 
-        int time;
-        time = myTime.elapsed();
+    if (dataSize < 1 || dataSize > LOG_MAX_PACKET_SIZE)
+        return false;
 
-        //Read packets
-        while ((lastPlayTime + ((time - lastPlayTimeOffset)* playbackSpeed) > (lastTimeStamp-firstTimestamp)))
-        {
-            lastPlayTime += ((time - lastPlayTimeOffset)* playbackSpeed);
-            if(file.bytesAvailable() < 4) {
-                stopReplay();
-                return;
-            }
+    return pos + LOG_RECORD_HEADER_SIZE + dataSize <= dataEnd;
+}
 
-            file.seek(lastTimeStampPos+sizeof(lastTimeStamp));
+/**
+ * Make the given index block the current one, checking its CRC the
+ * first time it is entered
+ * @return false if the block is corrupt
+ */
+bool LogFile::enterBlock(int block)
+{
+    currentBlock = block;
 
-            file.read((char *) &dataSize, sizeof(dataSize));
+    if (block >= blockIndex.size() || blockVerified[block])
+        return true;
 
-            if (dataSize<1 || dataSize>(1024*1024)) {
-                qDebug() << "Error: Logfile corrupted! Unlikely packet size: " << dataSize << "\n";
-                stopReplay();
-                return;
-            }
-            if(file.bytesAvailable() < dataSize) {
-                stopReplay();
-                return;
-            }
+    const IndexBlock &b = blockIndex[block];
+    if (updateCrc32(0, fileData + b.offset, b.size) != b.crc) {
+        qWarning() << "Logfile block" << block << "at offset" << b.offset << "is corrupted, skipping it";
+        return false;
+    }
 
-            mutex.lock();
-            dataBuffer.append(file.read(dataSize));
-            mutex.unlock();
-            emit readyRead();
+    blockVerified[block] = true;
+    return true;
+}
 
-            if(file.bytesAvailable() < 4) {
-                stopReplay();
-                return;
+void LogFile::timerFired()
+{
+    int time = myTime.elapsed();
+    lastPlayTime += (time - lastPlayTimeOffset) * playbackSpeed;
+    lastPlayTimeOffset = time;
+
+    bool newData = false;
+    bool corrupted = false;
+
+    //Read packets that are due
+    while (readPos < dataEnd) {
+        // Moving into the next block, skipping whatever lies between the two
+        const IndexBlock &block = blockIndex[currentBlock];
+        if (readPos >= block.offset + block.size) {
+            int next = currentBlock + 1;
+            if (next >= blockIndex.size()) {
+                readPos = dataEnd;
+                break;
             }
 
-            lastTimeStampPos = timestampPos[timestampBufferIdx];
-            lastTimeStamp = timestampBuffer[timestampBufferIdx];
-            timestampBufferIdx++;
-
-            lastPlayTimeOffset = time;
-            time = myTime.elapsed();
+            readPos = blockIndex[next].offset;
+            if (!enterBlock(next))
+                readPos += blockIndex[next].size;
+            continue;
+        }
 
+        quint32 timeStamp;
+        qint64 dataSize;
+        if (!readRecordHeader(readPos, timeStamp, dataSize)) {
+            qDebug() << "Error: Logfile corrupted at offset" << readPos;
+            corrupted = true;
+            break;
         }
-    } else {
-        stopReplay();
+
+        if ((double) timeStamp - firstTimestamp > lastPlayTime)
+            break;
+
+        mutex.lock();
+        dataBuffer.append((const char *) fileData + readPos + LOG_RECORD_HEADER_SIZE, dataSize);
+        mutex.unlock();
+        newData = true;
+
+        readPos += LOG_RECORD_HEADER_SIZE + dataSize;
     }
 
+    if (newData)
+        emit readyRead();
+
+    if (readPos >= dataEnd || corrupted)
+        stopReplay();
 }
 
-bool LogFile::startReplay() {
-    dataBuffer.clear();
-    myTime.restart();
-    lastPlayTimeOffset = 0;
-    lastPlayTime = 0;
-    playbackSpeed = 1;
+/**
+ * Load the block index stored at the end of a version 2 log
+ * @return false if there is no valid index
+ */
+bool LogFile::readIndex()
+{
+    const qint64 trailerSize = sizeof(qint64) + LOG_INDEX_MAGIC_SIZE;
 
-    //Read all log timestamps into array
-    timestampBuffer.clear(); //Save beginning of log for later use
-    timestampPos.clear();
-    quint64 logFileStartIdx = file.pos();
-    timestampBufferIdx = 0;
-    lastTimeStamp = 0;
+    if (fileDataSize - dataStart < LOG_RECORD_HEADER_SIZE + trailerSize)
+        return false;
 
-    while (!file.atEnd()){
-        qint64 dataSize;
+    if (memcmp(fileData + fileDataSize - LOG_INDEX_MAGIC_SIZE, LOG_INDEX_MAGIC, LOG_INDEX_MAGIC_SIZE) != 0)
+        return false;
 
-        //Get time stamp position
-        timestampPos.append(file.pos());
+    qint64 recordOffset = readRaw<qint64>(fileData + fileDataSize - trailerSize);
+    if (recordOffset < dataStart || recordOffset > fileDataSize - LOG_RECORD_HEADER_SIZE - trailerSize)
+        return false;
 
-        //Read timestamp and logfile packet size
-        file.read((char *) &lastTimeStamp, sizeof(lastTimeStamp));
-        file.read((char *) &dataSize, sizeof(dataSize));
+    qint64 indexSize = readRaw<qint64>(fileData + recordOffset + sizeof(quint32));
+    if (recordOffset + LOG_RECORD_HEADER_SIZE + indexSize != fileDataSize)
+        return false;
+
+    const uchar *index = fileData + recordOffset + LOG_RECORD_HEADER_SIZE;
+    quint32 version = readRaw<quint32>(index);
+    quint32 count = readRaw<quint32>(index + 4);
+    qint64 entriesSize = 8 + (qint64) count * LOG_INDEX_ENTRY_SIZE;
+    if (version != LOG_INDEX_VERSION || indexSize != entriesSize + 4 + trailerSize)
+        return false;
+
+    if (readRaw<quint32>(index + entriesSize) != updateCrc32(0, index, entriesSize))
+        return false;
+
+    blockIndex.resize(count);
+    const uchar *entry = index + 8;
+    qint64 nextOffset = dataStart;
+    for (quint32 i = 0; i < count; i++, entry += LOG_INDEX_ENTRY_SIZE) {
+        IndexBlock &b = blockIndex[i];
+        b.timestamp = readRaw<quint32>(entry);
+        b.count = readRaw<quint32>(entry + 4);
+        b.crc = readRaw<quint32>(entry + 8);
+        b.offset = readRaw<qint64>(entry + 12);
+        b.size = readRaw<qint64>(entry + 20);
+
+        // Blocks must be ordered and lie within the log data
+        if (b.offset < nextOffset || b.offset + b.size > recordOffset ||
+                (i > 0 && b.timestamp < blockIndex[i - 1].timestamp)) {
+            blockIndex.clear();
+            return false;
+        }
+        nextOffset = b.offset + b.size;
+    }
+
+    dataEnd = recordOffset;
+    blockVerified.fill(false, count);
+    return true;
+}
+
+/**
+ * Build the block index of a legacy log (or one that was not closed properly)
+ * by walking all of its records.
+ * @return false if no records were found
+ */
+bool LogFile::importLegacyIndex()
+{
+    bool warnedSequence = false;
+    qint64 pos = dataStart;
+    IndexBlock block;
+    block.count = 0;
+
+    dataEnd = fileDataSize;
+    blockIndex.clear();
+
+    while (pos + LOG_RECORD_HEADER_SIZE <= fileDataSize) {
+        quint32 timeStamp = readRaw<quint32>(fileData + pos);
+        qint64 dataSize = readRaw<qint64>(fileData + pos + sizeof(quint32));
 
         //Check if dataSize sync bytes are correct.
         //TODO: LIKELY AS NOT, THIS WILL FAIL TO RESYNC BECAUSE THERE IS TOO LITTLE INFORMATION IN THE STRING OF SIX 0x00
-        if ((dataSize & 0xFFFFFFFFFFFF0000)!=0){
-            qDebug() << "Wrong sync byte. At file location 0x"  << QString("%1").arg(file.pos(),0,16) << "Got 0x" << QString("%1").arg(dataSize & 0xFFFFFFFFFFFF0000,0,16) << ", but expected 0x""00"".";
-            file.seek(timestampPos.last()+1);
-            timestampPos.pop_back();
+        if ((dataSize & 0xFFFFFFFFFFFF0000) != 0 || dataSize < 1) {
+            qDebug() << "Wrong sync byte. At file location 0x"  << QString("%1").arg(pos,0,16) << "Got 0x" << QString("%1").arg(dataSize & 0xFFFFFFFFFFFF0000,0,16) << ", but expected 0x""00"".";
+            if (block.count > 0) {
+                blockIndex.append(block);
+                block.count = 0;
+            }
+            pos++;
             continue;
         }
 
-        //Check if timestamps are sequential.
-        if (!timestampBuffer.isEmpty() && lastTimeStamp < timestampBuffer.last()){
-            QMessageBox msgBox;
-            msgBox.setText("Corrupted file.");
-            msgBox.setInformativeText("Timestamps are not sequential. Playback may have unexpected behavior"); //<--TODO: add hyperlink to webpage with better description.
-            msgBox.exec();
+        if (pos + LOG_RECORD_HEADER_SIZE + dataSize > fileDataSize)
+            break;
+
+        // Keep block timestamps ordered so seeking can binary search them
+        if (!blockIndex.isEmpty() || block.count > 0) {
+            quint32 last = block.count > 0 ? block.timestamp : blockIndex.last().timestamp;
+            if (timeStamp < last) {
+                if (!warnedSequence)
+                    qWarning() << "Logfile timestamps are not sequential. Playback may have unexpected behavior";
+                warnedSequence = true;
+                timeStamp = last;
+            }
+        }
 
-            qDebug() << "Timestamp: " << timestampBuffer.last() << " " << lastTimeStamp;
+        if (block.count == 0) {
+            block.timestamp = timeStamp;
+            block.crc = 0;
+            block.offset = pos;
+            block.size = 0;
         }
+        block.size += LOG_RECORD_HEADER_SIZE + dataSize;
+        block.count++;
 
-        timestampBuffer.append(lastTimeStamp);
+        if (block.size >= LOG_INDEX_BLOCK_SIZE) {
+            blockIndex.append(block);
+            block.count = 0;
+        }
 
-        file.seek(timestampPos.last()+sizeof(lastTimeStamp)+sizeof(dataSize)+dataSize);
+        pos += LOG_RECORD_HEADER_SIZE + dataSize;
     }
 
-    //Check if any timestamps were successfully read
-    if (timestampBuffer.size() == 0){
-        QMessageBox msgBox;
-        msgBox.setText("Empty logfile.");
-        msgBox.setInformativeText("No log data can be found.");
-        msgBox.exec();
+    if (block.count > 0)
+        blockIndex.append(block);
+
+    // Nothing to check for blocks we have just walked
+    blockVerified.fill(true, blockIndex.size());
+    return !blockIndex.isEmpty();
+}
+
+bool LogFile::startReplay() {
+    dataBuffer.clear();
+    dataBufferPos = 0;
+    myTime.restart();
+    lastPlayTimeOffset = 0;
+    lastPlayTime = 0;
+    playbackSpeed = 1;
+
+    // Map the log, pages are only read in when replay gets to them
+    dataStart = file.pos();
+    fileDataSize = file.size();
+    fileData = file.map(0, fileDataSize);
+    if (!fileData) {
+        qDebug() << "Unable to map logfile, reading it into memory instead";
+        file.seek(0);
+        fileDataFallback = file.readAll();
+        fileData = (uchar *) fileDataFallback.data();
+        fileDataSize = fileDataFallback.size();
+    }
+
+    if (!readIndex() && !importLegacyIndex()) {
+        emit replayError(tr("Empty logfile."), tr("No log data can be found."));
 
         stopReplay();
         return false;
     }
 
     //Reset to log beginning.
-    file.seek(logFileStartIdx+sizeof(lastTimeStamp));
-    lastTimeStampPos = timestampPos[0];
-    lastTimeStamp = timestampBuffer[0];
-    firstTimestamp = timestampBuffer[0];
-    timestampBufferIdx = 1;
+    firstTimestamp = blockIndex[0].timestamp;
+    readPos = blockIndex[0].offset;
+    if (!enterBlock(0))
+        readPos += blockIndex[0].size;
 
     timer.setInterval(10);
     timer.start();
@@ -329,17 +591,42 @@ void LogFile::resumeReplay()
  */
 void LogFile::setReplayTime(double val)
 {
-    quint32 tmpIdx=0;
-    while(timestampBuffer[tmpIdx++] <= val*1000 && tmpIdx <= timestampBufferIdx){
+    if (blockIndex.isEmpty())
+        return;
+
+    quint32 target = firstTimestamp + (quint32)(val * 1000);
+
+    // Binary search for the last block starting at or before the requested time
+    int lo = 0;
+    int hi = blockIndex.size();
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (blockIndex[mid].timestamp <= target)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    int block = lo;
+
+    // Replay carries on from where it was
+    int previousBlock = currentBlock;
+    if (!enterBlock(block)) {
+        qWarning() << "Cannot seek into a corrupted part of the logfile";
+        currentBlock = previousBlock;
+        return;
     }
 
-    lastTimeStampPos=timestampPos[tmpIdx];
-    lastTimeStamp=timestampBuffer[tmpIdx];
-    timestampBufferIdx=tmpIdx;
+    // Walk the records of that block up to the requested time
+    qint64 pos = blockIndex[block].offset;
+    qint64 blockEnd = pos + blockIndex[block].size;
+    quint32 timeStamp = blockIndex[block].timestamp;
+    qint64 dataSize;
+    while (pos < blockEnd && readRecordHeader(pos, timeStamp, dataSize) && timeStamp < target)
+        pos += LOG_RECORD_HEADER_SIZE + dataSize;
 
+    readPos = pos;
     lastPlayTimeOffset = myTime.elapsed();
-    lastPlayTime=lastTimeStamp;
+    lastPlayTime = qMax(timeStamp, firstTimestamp) - firstTimestamp;
 
-    qDebug() << "Replaying at: " << lastTimeStamp << ", but requestion at" << val*1000;
+    qDebug() << "Replaying at: " << timeStamp << ", but requestion at" << val*1000;
 }
-
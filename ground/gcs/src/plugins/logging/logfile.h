@@ -34,6 +34,7 @@
 #include <QMutexLocker>
 #include <QDebug>
 #include <QBuffer>
+#include <QVector>
 #include "uavobjectmanager.h"
 #include <math.h>
 
@@ -66,14 +67,18 @@ signals:
     void readReady();
     void replayStarted();
     void replayFinished();
+    //! The log can be replayed but may not match this GCS
+    void replayWarning(const QString &text, const QString &informativeText);
+    //! The log cannot be replayed
+    void replayError(const QString &text, const QString &informativeText);
 
 protected:
     QByteArray dataBuffer;
+    int dataBufferPos;
     QTimer timer;
     QTime myTime;
     QFile file;
-    quint32 lastTimeStamp;
-    quint32 lastPlayTime;
+    double lastPlayTime;
     QMutex mutex;
 
 
@@ -81,11 +86,37 @@ protected:
     double playbackSpeed;
 
 private:
-    QList<quint32> timestampBuffer;
-    QList<quint32> timestampPos;
-    quint32 timestampBufferIdx;
-    quint32 lastTimeStampPos;
+    //! One block of consecutive log records, as stored in the file index
+    struct IndexBlock {
+        quint32 timestamp; //!< Timestamp of the first record in the block
+        quint32 count;     //!< Number of records in the block
+        quint32 crc;       //!< CRC32 over all bytes of the block
+        qint64 offset;     //!< File offset of the first record
+        qint64 size;       //!< Size of the block in bytes
+    };
+
+    bool readIndex();
+    bool importLegacyIndex();
+    bool readRecordHeader(qint64 pos, quint32 &timeStamp, qint64 &dataSize) const;
+    bool enterBlock(int block);
+    void writeIndex();
+
+    // Replay state, the file is memory mapped and read lazily
+    uchar *fileData;
+    QByteArray fileDataFallback;
+    qint64 fileDataSize;
+    qint64 dataStart;
+    qint64 dataEnd;
+    qint64 readPos;
+    QVector<IndexBlock> blockIndex;
+    QVector<bool> blockVerified;
+    int currentBlock;
     quint32 firstTimestamp;
+
+    // Index built while logging and appended when the file is closed
+    QVector<IndexBlock> writeBlocks;
+    IndexBlock writeBlock;
+    quint32 lastWriteTimeStamp;
 };
 
 #endif // LOGFILE_H
@@ -30,14 +30,17 @@
 #include "loggingplugin.h"
 #include "loggingdevice.h"
 #include "logginggadgetfactory.h"
+#include "flightlogdownload.h"
 #include <QDebug>
 #include <QtPlugin>
 #include <QThread>
 #include <QStringList>
 #include <QDir>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QList>
 #include <QErrorMessage>
+#include <QMessageBox>
 #include <QWriteLocker>
 
 #include <extensionsystem/pluginmanager.h>
@@ -325,7 +328,7 @@ bool LoggingPlugin::initialize(const QStringList& args, QString *errMsg)
     Q_UNUSED(errMsg);
 
     loggingThread = NULL;
-
+    flightLogDownload = NULL;
 
     // Add Menu entry
     Core::ActionManager* am = Core::ICore::instance()->actionManager();
@@ -345,6 +348,15 @@ bool LoggingPlugin::initialize(const QStringList& args, QString *errMsg)
 
     connect(cmd->action(), SIGNAL(triggered(bool)), this, SLOT(toggleLogging()));
 
+    // Command to copy a log off the onboard flash
+    Core::Command* downloadCmd = am->registerAction(new QAction(this),
+                                            "LoggingPlugin.DownloadFlightLog",
+                                            QList<int>() <<
+                                            Core::Constants::C_GLOBAL_ID);
+    downloadCmd->action()->setText("Download flight log...");
+    ac->addAction(downloadCmd, "Logging");
+    connect(downloadCmd->action(), SIGNAL(triggered(bool)), this, SLOT(downloadFlightLog()));
+
 
     mf = new LoggingGadgetFactory(this);
     addAutoReleasedObject(mf);
@@ -352,6 +364,8 @@ bool LoggingPlugin::initialize(const QStringList& args, QString *errMsg)
     // Map signal from end of replay to replay stopped
     connect(getLogfile(),SIGNAL(replayFinished()), this, SLOT(replayStopped()));
     connect(getLogfile(),SIGNAL(replayStarted()), this, SLOT(replayStarted()));
+    connect(getLogfile(),SIGNAL(replayWarning(QString,QString)), this, SLOT(showMessage(QString,QString)));
+    connect(getLogfile(),SIGNAL(replayError(QString,QString)), this, SLOT(showMessage(QString,QString)));
 
     return true;
 }
@@ -450,6 +464,63 @@ void LoggingPlugin::replayStarted()
     emit stateChanged("REPLAY");
 }
 
+/**
+  * Ask which log to copy off the board and where to save it, then start
+  * the download
+  */
+void LoggingPlugin::downloadFlightLog()
+{
+    if (flightLogDownload)
+        return;
+
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectManager *objMngr = pm->getObject<UAVObjectManager>();
+    LoggingStats::DataFields stats = LoggingStats::GetInstance(objMngr)->getData();
+
+    bool ok;
+    int fileId = QInputDialog::getInt(NULL, tr("Download flight log"), tr("Log on the board:"),
+                                      stats.MaxFileID, stats.MinFileID, stats.MaxFileID, 1, &ok);
+    if (!ok)
+        return;
+
+    QString fileName = QFileDialog::getSaveFileName(NULL, tr("Save flight log"),
+                                    tr("TauLabs-flight-%0.tll").arg(fileId),
+                                    tr("Tau Labs Log (*.tll)"));
+    if (fileName.isEmpty())
+        return;
+
+    flightLogDownload = new FlightLogDownload(objMngr, this);
+    connect(flightLogDownload, SIGNAL(finished(bool)), this, SLOT(flightLogDownloaded(bool)));
+    if (!flightLogDownload->start(fileId, fileName))
+        flightLogDownloaded(false);
+}
+
+/**
+  * Report the end of a flight log download
+  */
+void LoggingPlugin::flightLogDownloaded(bool success)
+{
+    flightLogDownload->deleteLater();
+    flightLogDownload = NULL;
+
+    if (success)
+        showMessage(tr("Flight log downloaded."), tr("The log can now be replayed."));
+    else
+        showMessage(tr("Flight log download failed."), tr("The board did not send the requested log."));
+}
+
+/**
+  * Show a message without blocking the replay or the download
+  */
+void LoggingPlugin::showMessage(const QString &text, const QString &informativeText)
+{
+    QMessageBox *msgBox = new QMessageBox();
+    msgBox->setAttribute(Qt::WA_DeleteOnClose);
+    msgBox->setText(text);
+    msgBox->setInformativeText(informativeText);
+    msgBox->show();
+}
+
 
 
 
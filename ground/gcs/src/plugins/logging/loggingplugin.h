@@ -44,6 +44,7 @@
 
 class LoggingPlugin;
 class LoggingGadgetFactory;
+class FlightLogDownload;
 
 /**
 *   Define a connection via the IConnection interface
@@ -147,10 +148,14 @@ private slots:
     void loggingStopped();
     void replayStarted();
     void replayStopped();
+    void showMessage(const QString &text, const QString &informativeText);
+    void downloadFlightLog();
+    void flightLogDownloaded(bool success);
 
 private:
     LoggingGadgetFactory *mf;
     Core::Command* cmd;
+    FlightLogDownload *flightLogDownload;
 
 };
 #endif /* LoggingPLUGIN_H_ */
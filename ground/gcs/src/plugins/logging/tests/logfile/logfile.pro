@@ -0,0 +1,17 @@
+# -------------------------------------------------
+# Block index, CRC checks, legacy import and seeking of LogFile,
+# built straight from the plugin sources.
+# -------------------------------------------------
+TEMPLATE = app
+TARGET = tst_logfile
+CONFIG += qtestlib console
+CONFIG -= app_bundle
+
+include(../../../../../gcs.pri)
+LIBS += -L$$GCS_PLUGIN_PATH/TauLabs
+include(../../../uavobjects/uavobjects.pri)
+INCLUDEPATH *= $$GCS_SOURCE_TREE/src/plugins ../..
+
+HEADERS += ../../logfile.h
+SOURCES += tst_logfile.cpp \
+    ../../logfile.cpp
@@ -0,0 +1,411 @@
+/**
+ ******************************************************************************
+ *
+ * @file       tst_logfile.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup LoggingGadgetPlugin Logging Gadget Plugin
+ * @{
+ * @brief      Tests the block index, seeking and error reporting of LogFile
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "logfile.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QTemporaryFile>
+#include <QtTest/QtTest>
+#include <string.h>
+
+// Every record is a 12 byte header followed by the payload, so 65 records
+// of this size fill one 64 KiB index block
+#define RECORD_SIZE         1000
+#define RECORD_HEADER_SIZE  12
+#define RECORDS_PER_BLOCK   65
+
+/**
+ * Collects the data a LogFile replays
+ */
+class ReplayReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayReader(LogFile *log) : log(log)
+    {
+        connect(log, SIGNAL(readyRead()), this, SLOT(read()));
+    }
+
+    QByteArray data;
+
+private slots:
+    void read() { data.append(log->readAll()); }
+
+private:
+    LogFile *log;
+};
+
+class tst_LogFile : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void footerIndex();
+    void corruptedBlockSkipped();
+    void corruptedIndexImported();
+    void legacyImport();
+    void legacyGapSkipped();
+    void setReplayTime();
+    void hashMismatchWarning();
+    void missingSeparatorWarning();
+    void emptyLogError();
+
+private:
+    static QByteArray payload(int n);
+    static void appendRecord(QByteArray &log, quint32 timeStamp, const QByteArray &data);
+    QByteArray writeIndexedLog(int records);
+    QByteArray legacyLog(int records, QByteArray &expected);
+    void writeFile(const QByteArray &content);
+    QByteArray readFile();
+    bool openReplay(LogFile &log);
+    bool waitFinished(QSignalSpy &finished);
+    QByteArray replayAll(LogFile &log);
+    QByteArray replayDue(LogFile &log, ReplayReader &reader);
+
+    QTemporaryFile *tmp;
+    QString fileName;
+    QByteArray header;
+};
+
+QByteArray tst_LogFile::payload(int n)
+{
+    QByteArray data(RECORD_SIZE, 0);
+    for (int i = 0; i < RECORD_SIZE; ++i)
+        data[i] = (char)(n * 31 + i);
+    return data;
+}
+
+void tst_LogFile::appendRecord(QByteArray &log, quint32 timeStamp, const QByteArray &data)
+{
+    qint64 dataSize = data.size();
+    log.append((const char *) &timeStamp, sizeof(timeStamp));
+    log.append((const char *) &dataSize, sizeof(dataSize));
+    log.append(data);
+}
+
+/**
+ * Write a log through LogFile, which appends the block index on close
+ * @return the payloads that were written
+ */
+QByteArray tst_LogFile::writeIndexedLog(int records)
+{
+    QByteArray expected;
+    LogFile writer;
+    writer.setFileName(fileName);
+    writer.open(QIODevice::WriteOnly);
+    for (int n = 0; n < records; ++n) {
+        QByteArray data = payload(n);
+        writer.write(data);
+        expected.append(data);
+    }
+    writer.close();
+    return expected;
+}
+
+/**
+ * Build a log without a block index, one record every 10 ms from 1 s on
+ */
+QByteArray tst_LogFile::legacyLog(int records, QByteArray &expected)
+{
+    QByteArray log = header;
+    expected.clear();
+    for (int n = 0; n < records; ++n) {
+        appendRecord(log, 1000 + n * 10, payload(n));
+        expected.append(payload(n));
+    }
+    return log;
+}
+
+void tst_LogFile::writeFile(const QByteArray &content)
+{
+    QFile file(fileName);
+    file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    file.write(content);
+    file.close();
+}
+
+QByteArray tst_LogFile::readFile()
+{
+    QFile file(fileName);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+/**
+ * Start replaying the log, paused so the test decides when data is due
+ */
+bool tst_LogFile::openReplay(LogFile &log)
+{
+    log.setFileName(fileName);
+    if (!log.open(QIODevice::ReadOnly) || !log.startReplay())
+        return false;
+
+    log.pauseReplay();
+    return true;
+}
+
+bool tst_LogFile::waitFinished(QSignalSpy &finished)
+{
+    for (int i = 0; i < 200 && finished.isEmpty(); ++i)
+        QTest::qWait(10);
+    return !finished.isEmpty();
+}
+
+/**
+ * Replay the rest of the log as fast as possible
+ * @return the replayed data, empty if replay did not finish
+ */
+QByteArray tst_LogFile::replayAll(LogFile &log)
+{
+    ReplayReader reader(&log);
+    QSignalSpy finished(&log, SIGNAL(replayFinished()));
+    log.setReplaySpeed(1e9);
+    log.resumeReplay();
+    return waitFinished(finished) ? reader.data : QByteArray();
+}
+
+/**
+ * Let replay run without advancing its clock
+ * @return the data that was due at the current replay time
+ */
+QByteArray tst_LogFile::replayDue(LogFile &log, ReplayReader &reader)
+{
+    reader.data.clear();
+    log.setReplaySpeed(0);
+    log.resumeReplay();
+    QTest::qWait(50);
+    log.pauseReplay();
+    return reader.data;
+}
+
+void tst_LogFile::initTestCase()
+{
+    tmp = new QTemporaryFile();
+    QVERIFY(tmp->open());
+    fileName = tmp->fileName();
+    tmp->close();
+
+    // Take the header this GCS writes from an empty log
+    writeIndexedLog(0);
+    QByteArray content = readFile();
+    int separator = content.indexOf("##\n");
+    QVERIFY(separator > 0);
+    header = content.left(separator + 3);
+    delete tmp;
+}
+
+void tst_LogFile::init()
+{
+    tmp = new QTemporaryFile();
+    QVERIFY(tmp->open());
+    fileName = tmp->fileName();
+    tmp->close();
+}
+
+void tst_LogFile::cleanup()
+{
+    delete tmp;
+}
+
+void tst_LogFile::footerIndex()
+{
+    QByteArray expected = writeIndexedLog(3 * RECORDS_PER_BLOCK + 5);
+
+    // The index record is found from the magic string at the end of the file
+    QByteArray content = readFile();
+    QVERIFY(content.endsWith("TLLINDEX"));
+    qint64 indexOffset;
+    memcpy(&indexOffset, content.constData() + content.size() - 16, sizeof(indexOffset));
+    QCOMPARE(indexOffset, (qint64)(header.size() + expected.size() + (3 * RECORDS_PER_BLOCK + 5) * RECORD_HEADER_SIZE));
+
+    // Version 2, one entry per 64 KiB block
+    quint32 version, count;
+    memcpy(&version, content.constData() + indexOffset + RECORD_HEADER_SIZE, sizeof(version));
+    memcpy(&count, content.constData() + indexOffset + RECORD_HEADER_SIZE + 4, sizeof(count));
+    QCOMPARE(version, (quint32)2);
+    QCOMPARE(count, (quint32)4);
+
+    // The index itself is not replayed
+    LogFile log;
+    QVERIFY(openReplay(log));
+    QCOMPARE(replayAll(log), expected);
+}
+
+void tst_LogFile::corruptedBlockSkipped()
+{
+    QByteArray expected = writeIndexedLog(3 * RECORDS_PER_BLOCK);
+
+    // Corrupt a payload byte in the second block, its record headers stay intact
+    QByteArray content = readFile();
+    content.data()[header.size() + RECORDS_PER_BLOCK * (RECORD_HEADER_SIZE + RECORD_SIZE) + RECORD_HEADER_SIZE + 5] ^= 0x55;
+    writeFile(content);
+    expected.remove(RECORDS_PER_BLOCK * RECORD_SIZE, RECORDS_PER_BLOCK * RECORD_SIZE);
+
+    LogFile log;
+    QVERIFY(openReplay(log));
+    QCOMPARE(replayAll(log), expected);
+}
+
+void tst_LogFile::corruptedIndexImported()
+{
+    QByteArray expected = writeIndexedLog(2 * RECORDS_PER_BLOCK);
+
+    // Corrupt the first index entry, the CRC of the index no longer matches
+    QByteArray content = readFile();
+    qint64 indexOffset;
+    memcpy(&indexOffset, content.constData() + content.size() - 16, sizeof(indexOffset));
+    content.data()[indexOffset + RECORD_HEADER_SIZE + 8] ^= 0x55;
+    writeFile(content);
+
+    // The log is walked instead, the index itself shows up as one more packet
+    LogFile log;
+    QVERIFY(openReplay(log));
+    QByteArray replayed = replayAll(log);
+    QVERIFY(replayed.startsWith(expected));
+    QCOMPARE(replayed.size(), (int)(content.size() - indexOffset - RECORD_HEADER_SIZE + expected.size()));
+}
+
+void tst_LogFile::legacyImport()
+{
+    QByteArray expected;
+    writeFile(legacyLog(4 * RECORDS_PER_BLOCK + 40, expected));
+
+    LogFile log;
+    QVERIFY(openReplay(log));
+    QCOMPARE(replayAll(log), expected);
+}
+
+void tst_LogFile::legacyGapSkipped()
+{
+    const int recordSize = RECORD_HEADER_SIZE + RECORD_SIZE;
+    QByteArray expected;
+    QByteArray content = legacyLog(3 * RECORDS_PER_BLOCK, expected);
+
+    // Garbage between two records in the middle of a block, and a whole
+    // record overwritten with garbage further on
+    content.insert(header.size() + 10 * recordSize, QByteArray(7, (char)0xAA));
+    int cut = header.size() + 7 + (RECORDS_PER_BLOCK + 20) * recordSize;
+    content.replace(cut, recordSize, QByteArray(RECORD_HEADER_SIZE + 100, (char)0xAA));
+    writeFile(content);
+    expected.remove((RECORDS_PER_BLOCK + 20) * RECORD_SIZE, RECORD_SIZE);
+
+    // Replay resynchronizes after each gap
+    LogFile log;
+    QSignalSpy errors(&log, SIGNAL(replayError(QString,QString)));
+    QVERIFY(openReplay(log));
+    QCOMPARE(replayAll(log), expected);
+    QCOMPARE(errors.count(), 0);
+}
+
+void tst_LogFile::setReplayTime()
+{
+    QByteArray expected;
+    writeFile(legacyLog(4 * RECORDS_PER_BLOCK, expected));
+
+    LogFile log;
+    QVERIFY(openReplay(log));
+    ReplayReader reader(&log);
+
+    // Lands on the first record at or after the requested time, only that
+    // record is due
+    log.setReplayTime(1.234);
+    QCOMPARE(replayDue(log, reader), payload(124));
+
+    // The first record of a block, half a millisecond keeps rounding out of it
+    log.setReplayTime(RECORDS_PER_BLOCK * 0.01 + 0.0005);
+    QCOMPARE(replayDue(log, reader), payload(RECORDS_PER_BLOCK));
+
+    // Back to the start
+    log.setReplayTime(0);
+    QCOMPARE(replayDue(log, reader), payload(0));
+
+    // Past the end the replay finishes
+    QSignalSpy finished(&log, SIGNAL(replayFinished()));
+    log.setReplayTime(100);
+    QVERIFY(replayDue(log, reader).isEmpty());
+    QCOMPARE(finished.count(), 1);
+}
+
+void tst_LogFile::hashMismatchWarning()
+{
+    QByteArray expected;
+    QByteArray log = legacyLog(10, expected);
+    log.replace(0, header.size(), "Tau Labs git hash:\nsomebranch\nsomehash\n##\n");
+    writeFile(log);
+
+    LogFile logFile;
+    QSignalSpy warnings(&logFile, SIGNAL(replayWarning(QString,QString)));
+    QSignalSpy errors(&logFile, SIGNAL(replayError(QString,QString)));
+    QVERIFY(openReplay(logFile));
+    QCOMPARE(warnings.count(), 1);
+    QCOMPARE(errors.count(), 0);
+
+    // The log is still replayed
+    QCOMPARE(replayAll(logFile), expected);
+}
+
+void tst_LogFile::missingSeparatorWarning()
+{
+    QByteArray expected;
+    QByteArray log = legacyLog(10, expected);
+    QByteArray noSeparator = header.left(header.size() - 3);
+    for (int n = 0; n < 12; ++n)
+        noSeparator.append("no separator\n");
+    log.replace(0, header.size(), noSeparator);
+    writeFile(log);
+
+    LogFile logFile;
+    QSignalSpy warnings(&logFile, SIGNAL(replayWarning(QString,QString)));
+    QVERIFY(openReplay(logFile));
+    QCOMPARE(warnings.count(), 1);
+
+    // Replay starts over from the beginning of the file and skips the text
+    QCOMPARE(replayAll(logFile), expected);
+}
+
+void tst_LogFile::emptyLogError()
+{
+    writeFile(header);
+
+    LogFile log;
+    QSignalSpy warnings(&log, SIGNAL(replayWarning(QString,QString)));
+    QSignalSpy errors(&log, SIGNAL(replayError(QString,QString)));
+    QSignalSpy finished(&log, SIGNAL(replayFinished()));
+    log.setFileName(fileName);
+    QVERIFY(log.open(QIODevice::ReadOnly));
+    QVERIFY(!log.startReplay());
+    QCOMPARE(warnings.count(), 0);
+    QCOMPARE(errors.count(), 1);
+    QCOMPARE(finished.count(), 1);
+}
+
+QTEST_MAIN(tst_LogFile)
+#include "tst_logfile.moc"
@@ -41,7 +41,6 @@
  * @param p_uavFieldName The plotted UAVO field name
  */
 Plot2dData::Plot2dData(QString p_uavObject, QString p_uavFieldName):
-    yDataHistory(0),
     dataUpdated(false)
 {
     uavObjectName = p_uavObject;
@@ -59,10 +58,6 @@ Plot2dData::Plot2dData(QString p_uavObject, QString p_uavFieldName):
         haveSubField = false;
     }
 
-    xData = new QVector<double>();
-    yData = new QVector<double>();
-    yDataHistory = new QVector<double>();
-
     scalePower = 0;
     meanSamples = 1;
     meanSum = 0.0f;
@@ -72,6 +67,8 @@ Plot2dData::Plot2dData(QString p_uavObject, QString p_uavFieldName):
     yMaximum = 120;
 
     m_xWindowSize = 0;
+
+    resolveField();
 }
 
 
@@ -98,8 +95,6 @@ Plot3dData::Plot3dData(QString p_uavObject, QString p_uavFieldName):
         haveSubField = false;
     }
 
-    xData = new QVector<double>();
-    yData = new QVector<double>();
     zData = new QVector<double>();
     zDataHistory = new QVector<double>();
     timeDataHistory = new QVector<double>();
@@ -115,26 +110,13 @@ Plot3dData::Plot3dData(QString p_uavObject, QString p_uavFieldName):
     yMaximum = 60;
     zMinimum = 0;
     zMaximum = 100;
-}
 
-
-Plot2dData::~Plot2dData()
-{
-    if (xData != NULL)
-        delete xData;
-    if (yData != NULL)
-        delete yData;
-    if (yDataHistory != NULL)
-        delete yDataHistory;
+    resolveField();
 }
 
 
 Plot3dData::~Plot3dData()
 {
-    if (xData != NULL)
-        delete xData;
-    if (yData != NULL)
-        delete yData;
     if (zData != NULL)
         delete zData;
     if (zDataHistory != NULL)
@@ -145,23 +127,58 @@ Plot3dData::~Plot3dData()
 
 
 /**
- * @brief valueAsDouble Fetch the value from the UAVO and return it as a double
- * @param obj UAVO
- * @param field UAVO field
- * @param haveSubField TRUE if UAVO has subfield. FALSE if not.
- * @param uavSubFieldName UAVO subfield, if it exists
- * @return
+ * @brief PlotData::resolveField Look up the plotted UAVO and the index of the
+ * subfield once, so that appending a sample does not compare any strings
+ */
+void PlotData::resolveField()
+{
+    haveObjectId = false;
+    objectId = 0;
+    subFieldIndex = 0;
+    boundObject = NULL;
+    boundField = NULL;
+
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
+    UAVObject* obj = objManager ? objManager->getObject(uavObjectName) : NULL;
+    if (obj == NULL)
+        return;
+
+    haveObjectId = true;
+    objectId = obj->getObjID();
+
+    UAVObjectField* field = obj->getField(uavFieldName);
+    if (field && haveSubField) {
+        int index = field->getElementIndex(uavSubFieldName);
+        // An unknown subfield reads past the last element, which plots as 0
+        subFieldIndex = (index < 0) ? field->getNumElements() : index;
+    }
+}
+
+/**
+ * @brief PlotData::bindField Get the plotted field of a UAVO
+ * @param obj UAVO with new data
+ * @return The field, or NULL if obj is not the plotted UAVO
  */
-double PlotData::valueAsDouble(UAVObject* obj, UAVObjectField* field, bool haveSubField, QString uavSubFieldName)
+UAVObjectField* PlotData::bindField(UAVObject* obj)
 {
-    Q_UNUSED(obj);
-    QVariant value;
+    if (!haveObjectId || obj->getObjID() != objectId)
+        return NULL;
 
-    if(haveSubField){
-        int indexOfSubField = field->getElementNames().indexOf(QRegExp(uavSubFieldName, Qt::CaseSensitive, QRegExp::FixedString));
-        value = field->getValue(indexOfSubField);
-    }else
-        value = field->getValue();
+    // Only changes when another instance of the UAVO comes in
+    if (obj != boundObject) {
+        boundObject = obj;
+        boundField = obj->getField(uavFieldName);
+    }
+    return boundField;
+}
 
-    return value.toDouble();
+/**
+ * @brief valueAsDouble Fetch the plotted element of a UAVO field as a double
+ * @param field UAVO field
+ * @return
+ */
+double PlotData::valueAsDouble(UAVObjectField* field)
+{
+    return field->getDouble(subFieldIndex);
 }
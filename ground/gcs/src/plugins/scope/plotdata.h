@@ -46,7 +46,8 @@ class PlotData : public QObject
 {
     Q_OBJECT
 public:
-    double valueAsDouble(UAVObject* obj, UAVObjectField* field, bool haveSubField, QString uavSubFieldName);
+    UAVObjectField* bindField(UAVObject* obj);
+    double valueAsDouble(UAVObjectField* field);
 
     //Setter functions
     void setXMinimum(double val){xMinimum=val;}
@@ -74,9 +75,6 @@ public:
     int getMeanSamples(){return meanSamples;}
     QString getMathFunction(){return mathFunction;}
 
-    QVector<double>* getXData(){return xData;}
-    QVector<double>* getYData(){return yData;}
-
     virtual bool append(UAVObject* obj) = 0;
     virtual void removeStaleData() = 0;
     virtual void setUpdatedFlagToTrue() = 0;
@@ -87,9 +85,6 @@ public:
     QwtScaleWidget *rightAxis;
 
 protected:
-    QVector<double>* xData;    //Data vector for plots
-    QVector<double>* yData;    //Used vector for plots
-
     double m_xWindowSize;
     double xMinimum;
     double xMaximum;
@@ -101,6 +96,13 @@ protected:
     QString uavSubFieldName;
     bool haveSubField;
 
+    // Resolved once when the scope is configured, see resolveField()
+    bool haveObjectId;
+    quint32 objectId;
+    quint32 subFieldIndex;
+    UAVObject* boundObject;
+    UAVObjectField* boundField;
+
     int scalePower; //This is the power to which each value must be raised
     unsigned int meanSamples;
     QString mathFunction;
@@ -109,6 +111,8 @@ protected:
     double correctionSum;
     int correctionCount;
 
+    void resolveField();
+
 private:
 
 };
@@ -34,6 +34,7 @@
 
 #include "vibrationanalysissettings.h"
 #include "vibrationanalysisoutput.h"
+#include "vibrationanalysispeak.h"
 
 #include "scopes2d/histogramscopeconfig.h"
 #include "scopes2d/scatterplotscopeconfig.h"
@@ -240,21 +241,39 @@ void ScopeGadgetOptionsPage::on_cmbSpectrogramSource_currentIndexChanged(QString
         options_page->cmbUAVObjectsSpectrogram->setCurrentIndex(options_page->cmbUAVObjectsSpectrogram->findText(vibrationAnalysisOutput->getName()));
         // Get the window size
         int fftWindowSize;
-        switch(vibrationAnalysisSettingsData.FFTWindowSize)
-        {
-        default:
-        case VibrationAnalysisSettings::FFTWINDOWSIZE_16 :
-            fftWindowSize = 16;
-            break;
-        case VibrationAnalysisSettings::FFTWINDOWSIZE_64 :
-            fftWindowSize = 64;
-            break;
-        case VibrationAnalysisSettings::FFTWINDOWSIZE_256 :
-            fftWindowSize = 256;
-            break;
-        case VibrationAnalysisSettings::FFTWINDOWSIZE_1024 :
-            fftWindowSize = 1024;
-            break;
+        double sampleFrequency;
+        if (vibrationAnalysisSettingsData.Source == VibrationAnalysisSettings::SOURCE_ACCELS) {
+            switch(vibrationAnalysisSettingsData.FFTWindowSize)
+            {
+            default:
+            case VibrationAnalysisSettings::FFTWINDOWSIZE_16 :
+                fftWindowSize = 16;
+                break;
+            case VibrationAnalysisSettings::FFTWINDOWSIZE_64 :
+                fftWindowSize = 64;
+                break;
+            case VibrationAnalysisSettings::FFTWINDOWSIZE_256 :
+                fftWindowSize = 256;
+                break;
+            case VibrationAnalysisSettings::FFTWINDOWSIZE_1024 :
+                fftWindowSize = 1024;
+                break;
+            }
+            sampleFrequency = 1000.0f/vibrationAnalysisSettingsData.SampleRate; // Sample rate is in ms
+        } else {
+            // The raw samples come at the sensor rate, which the flight side measures
+            switch(vibrationAnalysisSettingsData.RawFFTLength)
+            {
+            default:
+            case VibrationAnalysisSettings::RAWFFTLENGTH_128 :
+                fftWindowSize = 128;
+                break;
+            case VibrationAnalysisSettings::RAWFFTLENGTH_512 :
+                fftWindowSize = 512;
+                break;
+            }
+            VibrationAnalysisPeak* vibrationAnalysisPeak = VibrationAnalysisPeak::GetInstance(objManager);
+            sampleFrequency = vibrationAnalysisPeak->getSampleRate();
         }
 
         // Set spinbox range before setting value
@@ -262,7 +281,7 @@ void ScopeGadgetOptionsPage::on_cmbSpectrogramSource_currentIndexChanged(QString
 
         // Set values to UAVO
         options_page->sbSpectrogramWidth->setValue(fftWindowSize / 2);
-        options_page->sbSpectrogramFrequency->setValue(1000.0f/vibrationAnalysisSettingsData.SampleRate); // Sample rate is in ms
+        options_page->sbSpectrogramFrequency->setValue(sampleFrequency);
 
         options_page->sbSpectrogramFrequency->setEnabled(false);
         options_page->sbSpectrogramWidth->setEnabled(false);
@@ -0,0 +1,232 @@
+/**
+ ******************************************************************************
+ *
+ * @file       curvedata.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief The scope Gadget, graphically plots the states of UAVObjects
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "scopes2d/curvedata.h"
+
+//! Upper bound for rings that grow with the sample rate
+#define MAX_GROWABLE_CAPACITY (1 << 20)
+
+//! Only decimate when there are this many samples per pixel column
+#define DECIMATION_THRESHOLD 4
+
+
+SampleRing::SampleRing(int capacity):
+    head(0),
+    count(0)
+{
+    setCapacity(capacity);
+}
+
+/**
+ * @brief SampleRing::setCapacity Resize the ring, dropping its contents
+ */
+void SampleRing::setCapacity(int capacity)
+{
+    buffer.resize(qMax(capacity, 1));
+    clear();
+}
+
+/**
+ * @brief SampleRing::grow Enlarge the ring, keeping its contents
+ */
+void SampleRing::grow(int capacity)
+{
+    if (capacity <= buffer.size())
+        return;
+
+    QVector<double> larger(capacity);
+    for (int i = 0; i < count; ++i)
+        larger[i] = at(i);
+    buffer = larger;
+    head = 0;
+}
+
+void SampleRing::append(double value)
+{
+    int index = head + count;
+    if (index >= buffer.size())
+        index -= buffer.size();
+    buffer[index] = value;
+
+    if (count < buffer.size()) {
+        count++;
+    } else if (++head == buffer.size()) {
+        head = 0;
+    }
+}
+
+void SampleRing::removeFirst(int n)
+{
+    n = qMin(n, count);
+    head += n;
+    if (head >= buffer.size())
+        head -= buffer.size();
+    count -= n;
+}
+
+
+/**
+ * @brief CurveData::CurveData Empty curve
+ * @param indexedX TRUE if x is the sample number (series plots), FALSE if
+ * x is given with each sample (time series plots)
+ */
+CurveData::CurveData(bool indexedX):
+    indexedX(indexedX),
+    growable(false),
+    xData(indexedX ? 1 : 1024),
+    yData(1024),
+    decimatedCount(0),
+    useDecimated(false)
+{
+}
+
+/**
+ * @brief CurveData::setCapacity Set the number of samples kept, dropping the current ones
+ * @param growable TRUE to double the capacity instead of overwriting the oldest
+ * sample, for curves that are trimmed by removeOlderThan()
+ */
+void CurveData::setCapacity(int capacity, bool growable)
+{
+    this->growable = growable;
+    if (!indexedX)
+        xData.setCapacity(capacity);
+    yData.setCapacity(capacity);
+    useDecimated = false;
+}
+
+void CurveData::append(double x, double y)
+{
+    if (growable && yData.isFull() && yData.capacity() < MAX_GROWABLE_CAPACITY) {
+        int capacity = qMin(yData.capacity() * 2, MAX_GROWABLE_CAPACITY);
+        if (!indexedX)
+            xData.grow(capacity);
+        yData.grow(capacity);
+    }
+
+    if (!indexedX)
+        xData.append(x);
+    yData.append(y);
+}
+
+/**
+ * @brief CurveData::removeOlderThan Drop the samples with an x below the given one
+ */
+void CurveData::removeOlderThan(double x)
+{
+    if (indexedX)
+        return;
+
+    int stale = 0;
+    while (stale < xData.size() && xData.at(stale) < x)
+        stale++;
+    xData.removeFirst(stale);
+    yData.removeFirst(stale);
+}
+
+void CurveData::clear()
+{
+    xData.clear();
+    yData.clear();
+    useDecimated = false;
+}
+
+/**
+ * @brief CurveData::update Prepare the samples for drawing and compute the
+ * bounding rectangle. Called before each replot with new data.
+ * @param pixels Width of the canvas
+ */
+void CurveData::update(int pixels)
+{
+    int n = yData.size();
+    if (n == 0) {
+        useDecimated = false;
+        d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+        return;
+    }
+
+    double minX = xAt(0), maxX = minX;
+    double minY = yData.at(0), maxY = minY;
+
+    useDecimated = pixels > 0 && n > DECIMATION_THRESHOLD * pixels;
+    if (!useDecimated) {
+        for (int i = 1; i < n; ++i) {
+            double x = xAt(i);
+            double y = yData.at(i);
+            minX = qMin(minX, x);
+            maxX = qMax(maxX, x);
+            minY = qMin(minY, y);
+            maxY = qMax(maxY, y);
+        }
+    } else {
+        // Keep the extremes of each column, in the order they were sampled
+        if (decimated.size() < 2 * pixels)
+            decimated.resize(2 * pixels);
+        decimatedCount = 0;
+        for (int column = 0; column < pixels; ++column) {
+            int start = (int)((qint64)column * n / pixels);
+            int end = (int)((qint64)(column + 1) * n / pixels);
+            int minIndex = start;
+            int maxIndex = start;
+            for (int i = start + 1; i < end; ++i) {
+                double y = yData.at(i);
+                if (y < yData.at(minIndex))
+                    minIndex = i;
+                else if (y > yData.at(maxIndex))
+                    maxIndex = i;
+            }
+            int firstIndex = qMin(minIndex, maxIndex);
+            int lastIndex = qMax(minIndex, maxIndex);
+            decimated[decimatedCount++] = QPointF(xAt(firstIndex), yData.at(firstIndex));
+            if (lastIndex != firstIndex)
+                decimated[decimatedCount++] = QPointF(xAt(lastIndex), yData.at(lastIndex));
+
+            minY = qMin(minY, yData.at(minIndex));
+            maxY = qMax(maxY, yData.at(maxIndex));
+        }
+        minX = qMin(xAt(0), xAt(n - 1));
+        maxX = qMax(xAt(0), xAt(n - 1));
+    }
+
+    d_boundingRect = QRectF(minX, minY, maxX - minX, maxY - minY);
+}
+
+size_t CurveData::size() const
+{
+    return useDecimated ? decimatedCount : yData.size();
+}
+
+QPointF CurveData::sample(size_t i) const
+{
+    if (useDecimated)
+        return decimated[i];
+    return QPointF(xAt(i), yData.at(i));
+}
+
+QRectF CurveData::boundingRect() const
+{
+    return d_boundingRect;
+}
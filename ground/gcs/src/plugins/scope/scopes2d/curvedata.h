@@ -0,0 +1,115 @@
+/**
+ ******************************************************************************
+ *
+ * @file       curvedata.h
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief The scope Gadget, graphically plots the states of UAVObjects
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef CURVEDATA_H
+#define CURVEDATA_H
+
+#include "qwt/src/qwt_series_data.h"
+
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+
+
+/**
+ * @brief The SampleRing class A fixed capacity ring of doubles. Appending to
+ * a full ring overwrites the oldest sample, so nothing is ever shifted.
+ */
+class SampleRing
+{
+public:
+    SampleRing(int capacity = 0);
+
+    void setCapacity(int capacity);
+    void grow(int capacity);
+    void clear(){head = 0; count = 0;}
+
+    void append(double value);
+    void removeFirst(int n = 1);
+
+    int capacity() const {return buffer.size();}
+    int size() const {return count;}
+    bool isEmpty() const {return count == 0;}
+    bool isFull() const {return count == buffer.size();}
+
+    //! Sample i, counted from the oldest one
+    double at(int i) const
+    {
+        int index = head + i;
+        if (index >= buffer.size())
+            index -= buffer.size();
+        return buffer[index];
+    }
+    double first() const {return buffer[head];}
+    double last() const {return at(count - 1);}
+
+private:
+    QVector<double> buffer;
+    int head;
+    int count;
+};
+
+
+/**
+ * @brief The CurveData class Samples of a scope curve, handed to Qwt without
+ * copying. When there are more samples than pixels, update() reduces them
+ * to the minimum and maximum of each pixel column.
+ */
+class CurveData : public QwtSeriesData<QPointF>
+{
+public:
+    CurveData(bool indexedX);
+
+    void setCapacity(int capacity, bool growable);
+    int capacity() const {return yData.capacity();}
+    int count() const {return yData.size();}
+    double lastX() const {return xAt(count() - 1);}
+
+    void append(double x, double y);
+    void removeOlderThan(double x);
+    void clear();
+
+    void update(int pixels);
+
+    virtual size_t size() const;
+    virtual QPointF sample(size_t i) const;
+    virtual QRectF boundingRect() const;
+
+private:
+    double xAt(int i) const {return indexedX ? i : xData.at(i);}
+
+    bool indexedX; //!< X is the sample number, only y is stored
+    bool growable;
+    SampleRing xData;
+    SampleRing yData;
+
+    QVector<QPointF> decimated;
+    int decimatedCount;
+    bool useDecimated;
+};
+
+#endif // CURVEDATA_H
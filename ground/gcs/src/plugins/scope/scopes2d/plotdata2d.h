@@ -29,6 +29,7 @@
 #define PLOTDATA2D_H
 
 #include "plotdata.h"
+#include "scopes2d/curvedata.h"
 
 #include <QTimer>
 #include <QTime>
@@ -44,9 +45,8 @@ class Plot2dData : public PlotData
 
 public:
     Plot2dData(QString uavObject, QString uavField);
-    ~Plot2dData();
 
-    QVector<double>* yDataHistory; //Used for scatterplots
+    SampleRing yDataHistory; //Used for scatterplot math
 
     virtual void setUpdatedFlagToTrue(){dataUpdated = true;}
     virtual bool readAndResetUpdatedFlag(){bool tmp = dataUpdated; dataUpdated = false; return tmp;}
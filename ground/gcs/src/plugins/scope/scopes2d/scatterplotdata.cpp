@@ -37,6 +37,7 @@
 #include "qwt/src/qwt.h"
 #include "qwt/src/qwt_plot.h"
 #include "qwt/src/qwt_plot_curve.h"
+#include "qwt/src/qwt_plot_canvas.h"
 
 
 /**
@@ -47,11 +48,10 @@ void TimeSeriesPlotData::plotNewData(PlotData *plot2dData, ScopeConfig *scopeCon
 {
     Q_UNUSED(plot2dData);
     Q_UNUSED(scopeConfig);
-    Q_UNUSED(scopeGadgetWidget);
 
     //Plot new data
     if (readAndResetUpdatedFlag() == true)
-        curve->setSamples(*xData, *yData);
+        curveData->update(scopeGadgetWidget->canvas()->width());
 
     QDateTime NOW = QDateTime::currentDateTime();
     double toTime = NOW.toTime_t();
@@ -69,11 +69,58 @@ void SeriesPlotData::plotNewData(PlotData *plot2dData, ScopeConfig *scopeConfig,
 {
     Q_UNUSED(plot2dData);
     Q_UNUSED(scopeConfig);
-    Q_UNUSED(scopeGadgetWidget);
 
     //Plot new data
     if (readAndResetUpdatedFlag() == true)
-        curve->setSamples(*xData, *yData);
+        curveData->update(scopeGadgetWidget->canvas()->width());
+}
+
+
+/**
+ * @brief ScatterplotData::applyMath Perform scope math, if necessary
+ * @param currentValue The newest sample
+ * @return The value to plot
+ */
+double ScatterplotData::applyMath(double currentValue)
+{
+    if (mathFunction != QLatin1String("Boxcar average") && mathFunction != QLatin1String("Standard deviation"))
+        return currentValue;
+
+    // The history only holds the averaged window
+    if (yDataHistory.capacity() != (int)meanSamples) {
+        yDataHistory.setCapacity(meanSamples);
+        meanSum = 0.0f;
+        correctionSum = 0.0f;
+        correctionCount = 0;
+    }
+
+    // calculate average value, the oldest value drops out of a full window
+    if (yDataHistory.isFull())
+        meanSum -= yDataHistory.first();
+    yDataHistory.append( currentValue );
+    meanSum += currentValue;
+
+    // make sure to correct the sum every meanSamples steps to prevent it
+    // from running away due to floating point rounding errors
+    correctionSum+=currentValue;
+    if (++correctionCount >= (int)meanSamples) {
+        meanSum = correctionSum;
+        correctionSum = 0.0f;
+        correctionCount = 0;
+    }
+
+    double boxcarAvg=meanSum/yDataHistory.size();
+
+    if ( mathFunction == QLatin1String("Standard deviation") ){
+        //Calculate square of sample standard deviation, with Bessel's correction
+        double stdSum=0;
+        for (int i=0; i < yDataHistory.size(); i++){
+            stdSum+= pow(yDataHistory.at(i)- boxcarAvg,2)/(meanSamples-1);
+        }
+        return sqrt(stdSum);
+    }
+
+    return boxcarAvg;
 }
 
 
@@ -84,64 +131,21 @@ void SeriesPlotData::plotNewData(PlotData *plot2dData, ScopeConfig *scopeConfig,
  */
 bool SeriesPlotData::append(UAVObject* obj)
 {
-    if (uavObjectName == obj->getName()) {
-
-        //Get the field of interest
-        UAVObjectField* field =  obj->getField(uavFieldName);
-
-        if (field) {
-
-            double currentValue = valueAsDouble(obj, field, haveSubField, uavSubFieldName) * pow(10, scalePower);
-
-            //Perform scope math, if necessary
-            if (mathFunction  == "Boxcar average" || mathFunction  == "Standard deviation"){
-                //Put the new value at the front
-                yDataHistory->append( currentValue );
-
-                // calculate average value
-                meanSum += currentValue;
-                if(yDataHistory->size() > (int)meanSamples) {
-                    meanSum -= yDataHistory->first();
-                    yDataHistory->pop_front();
-                }
-
-                // make sure to correct the sum every meanSamples steps to prevent it
-                // from running away due to floating point rounding errors
-                correctionSum+=currentValue;
-                if (++correctionCount >= (int)meanSamples) {
-                    meanSum = correctionSum;
-                    correctionSum = 0.0f;
-                    correctionCount = 0;
-                }
-
-                double boxcarAvg=meanSum/yDataHistory->size();
-
-                if ( mathFunction  == "Standard deviation" ){
-                    //Calculate square of sample standard deviation, with Bessel's correction
-                    double stdSum=0;
-                    for (int i=0; i < yDataHistory->size(); i++){
-                        stdSum+= pow(yDataHistory->at(i)- boxcarAvg,2)/(meanSamples-1);
-                    }
-                    yData->append(sqrt(stdSum));
-                }
-                else  {
-                    yData->append(boxcarAvg);
-                }
-            }
-            else{
-                yData->append( currentValue );
-            }
-
-            if (yData->size() > getXWindowSize()) { //If new data overflows the window, remove old data...
-                yData->pop_front();
-            } else //...otherwise, add a new y point at position xData
-                xData->insert(xData->size(), xData->size());
-
-            return true;
-        }
-    }
+    //Get the field of interest
+    UAVObjectField* field = bindField(obj);
+    if (field == NULL)
+        return false;
+
+    double currentValue = valueAsDouble(field) * pow(10, scalePower);
+
+    // The window is a number of samples, so once full the oldest one is overwritten
+    int windowSize = qMax((int)getXWindowSize(), 1);
+    if (curveData->capacity() != windowSize)
+        curveData->setCapacity(windowSize, false);
 
-    return false;
+    curveData->append(0, applyMath(currentValue));
+
+    return true;
 }
 
 
@@ -152,63 +156,21 @@ bool SeriesPlotData::append(UAVObject* obj)
  */
 bool TimeSeriesPlotData::append(UAVObject* obj)
 {
-    if (uavObjectName == obj->getName()) {
-        //Get the field of interest
-        UAVObjectField* field =  obj->getField(uavFieldName);
-
-        if (field) {
-            QDateTime NOW = QDateTime::currentDateTime(); //THINK ABOUT REIMPLEMENTING THIS TO SHOW UAVO TIME, NOT SYSTEM TIME
-            double currentValue = valueAsDouble(obj, field, haveSubField, uavSubFieldName) * pow(10, scalePower);
-
-            //Perform scope math, if necessary
-            if (mathFunction  == "Boxcar average" || mathFunction  == "Standard deviation"){
-                //Put the new value at the back
-                yDataHistory->append( currentValue );
-
-                // calculate average value
-                meanSum += currentValue;
-                if(yDataHistory->size() > (int)meanSamples) {
-                    meanSum -= yDataHistory->first();
-                    yDataHistory->pop_front();
-                }
-                // make sure to correct the sum every meanSamples steps to prevent it
-                // from running away due to floating point rounding errors
-                correctionSum+=currentValue;
-                if (++correctionCount >= (int)meanSamples) {
-                    meanSum = correctionSum;
-                    correctionSum = 0.0f;
-                    correctionCount = 0;
-                }
-
-                double boxcarAvg=meanSum/yDataHistory->size();
-
-                if ( mathFunction  == "Standard deviation" ){
-                    //Calculate square of sample standard deviation, with Bessel's correction
-                    double stdSum=0;
-                    for (int i=0; i < yDataHistory->size(); i++){
-                        stdSum+= pow(yDataHistory->at(i)- boxcarAvg,2)/(meanSamples-1);
-                    }
-                    yData->append(sqrt(stdSum));
-                }
-                else  {
-                    yData->append(boxcarAvg);
-                }
-            }
-            else{
-                yData->append( currentValue );
-            }
-
-            double valueX = NOW.toTime_t() + NOW.time().msec() / 1000.0;
-            xData->append(valueX);
-
-            //Remove stale data
-            removeStaleData();
-
-            return true;
-        }
-    }
+    //Get the field of interest
+    UAVObjectField* field = bindField(obj);
+    if (field == NULL)
+        return false;
 
-    return false;
+    QDateTime NOW = QDateTime::currentDateTime(); //THINK ABOUT REIMPLEMENTING THIS TO SHOW UAVO TIME, NOT SYSTEM TIME
+    double currentValue = valueAsDouble(field) * pow(10, scalePower);
+
+    double valueX = NOW.toTime_t() + NOW.time().msec() / 1000.0;
+    curveData->append(valueX, applyMath(currentValue));
+
+    //Remove stale data
+    removeStaleData();
+
+    return true;
 }
 
 
@@ -217,22 +179,10 @@ bool TimeSeriesPlotData::append(UAVObject* obj)
  */
 void TimeSeriesPlotData::removeStaleData()
 {
-    double newestValue;
-    double oldestValue;
+    if (curveData->count() == 0)
+        return;
 
-    while (1) {
-        if (xData->size() == 0)
-            break;
-
-        newestValue = xData->last();
-        oldestValue = xData->first();
-
-        if (newestValue - oldestValue > getXWindowSize()) {
-            yData->pop_front();
-            xData->pop_front();
-        } else
-            break;
-    }
+    curveData->removeOlderThan(curveData->lastX() - getXWindowSize());
 }
 
 
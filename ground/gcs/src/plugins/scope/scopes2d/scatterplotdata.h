@@ -29,6 +29,7 @@
 #define SCATTERPLOTDATA_H
 
 #include "scopes2d/plotdata2d.h"
+#include "scopes2d/curvedata.h"
 #include "uavobject.h"
 #include "qwt/src/qwt_plot_curve.h"
 
@@ -44,16 +45,20 @@ class ScatterplotData : public Plot2dData
 {
     Q_OBJECT
 public:
-    ScatterplotData(QString uavObject, QString uavField):
-        Plot2dData(uavObject, uavField){curve = 0;}
-    ~ScatterplotData(){}
+    ScatterplotData(QString uavObject, QString uavField, bool indexedX):
+        Plot2dData(uavObject, uavField){curve = 0; curveData = new CurveData(indexedX);}
+    ~ScatterplotData(){if (curve == 0) delete curveData;}
 
     virtual void clearPlots(PlotData *);
 
-    void setCurve(QwtPlotCurve *val){curve = val;}
+    //! The curve takes ownership of the samples
+    void setCurve(QwtPlotCurve *val){curve = val; curve->setData(curveData);}
 
 protected:
+    double applyMath(double currentValue);
+
     QwtPlotCurve* curve;
+    CurveData* curveData;
 };
 
 
@@ -67,7 +72,7 @@ class SeriesPlotData : public ScatterplotData
     Q_OBJECT
 public:
     SeriesPlotData(QString uavObject, QString uavField)
-            : ScatterplotData(uavObject, uavField) {}
+            : ScatterplotData(uavObject, uavField, true) {}
     ~SeriesPlotData() {}
 
     /*!
@@ -93,8 +98,10 @@ class TimeSeriesPlotData : public ScatterplotData
     Q_OBJECT
 public:
     TimeSeriesPlotData(QString uavObject, QString uavField)
-            : ScatterplotData(uavObject, uavField) {
+            : ScatterplotData(uavObject, uavField, false) {
         scalePower = 1;
+        // Trimmed by age, so the ring grows to fit the sample rate
+        curveData->setCapacity(1024, true);
     }
     ~TimeSeriesPlotData() {
     }
@@ -84,6 +84,9 @@ private:
     double timeHorizon;
     unsigned int windowWidth;
     double autoscaleValueUpdated;
+
+    // The plotted field of every instance of the UAVO, bound on the first full row
+    QVector<UAVObjectField*> instanceFields;
 };
 
 #endif // SPECTROGRAMDATA_H
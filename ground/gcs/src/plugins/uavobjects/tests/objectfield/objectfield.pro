@@ -0,0 +1,14 @@
+# -------------------------------------------------
+# Typed and bulk accessors of UAVObjectField checked against getValue(),
+# run against the full set of generated objects.
+# -------------------------------------------------
+TEMPLATE = app
+TARGET = tst_uavobjectfield
+CONFIG += qtestlib console
+CONFIG -= app_bundle
+
+include(../../../../../gcs.pri)
+LIBS += -L$$GCS_PLUGIN_PATH/TauLabs
+include(../../uavobjects.pri)
+
+SOURCES += tst_uavobjectfield.cpp
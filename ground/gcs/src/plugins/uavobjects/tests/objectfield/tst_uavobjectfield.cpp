@@ -0,0 +1,215 @@
+/**
+ ******************************************************************************
+ *
+ * @file       tst_uavobjectfield.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief      Tests the typed accessors of UAVObjectField
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "uavobjectmanager.h"
+#include "uavobjectsinit.h"
+#include "actuatorcommand.h"
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+class tst_UAVObjectField : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void getDoubleMatchesGetValue();
+    void packedMatchesObject();
+    void readAllAsDouble();
+    void elementIndex();
+    void generatedUnpack();
+    void benchmarkGetValue();
+    void benchmarkGetDouble();
+    void benchmarkReadAll();
+
+private:
+    void fillObjects();
+    static bool sameDouble(double a, double b);
+
+    UAVObjectManager* objMngr;
+};
+
+void tst_UAVObjectField::initTestCase()
+{
+    objMngr = new UAVObjectManager();
+    UAVObjectsInitialize(objMngr);
+    QVERIFY(objMngr->getDataObjects().size() > 0);
+    fillObjects();
+}
+
+void tst_UAVObjectField::cleanupTestCase()
+{
+    delete objMngr;
+}
+
+/**
+ * Load every object with arbitrary bytes, including out of range enums
+ */
+void tst_UAVObjectField::fillObjects()
+{
+    qsrand(1234);
+    foreach (QVector<UAVDataObject*> list, objMngr->getDataObjects()) {
+        foreach (UAVDataObject* obj, list) {
+            QByteArray data(obj->getNumBytes(), 0);
+            for (int i = 0; i < data.size(); ++i)
+                data[i] = (char)(qrand() & 0xFF);
+            obj->unpack((const quint8*)data.constData());
+        }
+    }
+}
+
+bool tst_UAVObjectField::sameDouble(double a, double b)
+{
+    return (qIsNaN(a) && qIsNaN(b)) || a == b;
+}
+
+void tst_UAVObjectField::getDoubleMatchesGetValue()
+{
+    foreach (QVector<UAVDataObject*> list, objMngr->getDataObjects()) {
+        foreach (UAVObjectField* field, list[0]->getFields()) {
+            for (quint32 i = 0; i < field->getNumElements(); ++i) {
+                double expected = field->getValue(i).toDouble();
+                if (!sameDouble(field->getDouble(i), expected))
+                    QFAIL(qPrintable(QString("%1.%2[%3]").arg(list[0]->getName()).arg(field->getName()).arg(i)));
+            }
+            // Out of range elements read as zero, as before
+            QCOMPARE(field->getDouble(field->getNumElements()), 0.0);
+        }
+    }
+}
+
+void tst_UAVObjectField::packedMatchesObject()
+{
+    foreach (QVector<UAVDataObject*> list, objMngr->getDataObjects()) {
+        UAVDataObject* obj = list[0];
+        QByteArray packed(obj->getNumBytes(), 0);
+        obj->pack((quint8*)packed.data());
+        foreach (UAVObjectField* field, obj->getFields()) {
+            for (quint32 i = 0; i < field->getNumElements(); ++i) {
+                if (!sameDouble(field->getDouble(i, (const quint8*)packed.constData()), field->getDouble(i)))
+                    QFAIL(qPrintable(QString("%1.%2[%3]").arg(obj->getName()).arg(field->getName()).arg(i)));
+            }
+        }
+    }
+}
+
+void tst_UAVObjectField::readAllAsDouble()
+{
+    foreach (QVector<UAVDataObject*> list, objMngr->getDataObjects()) {
+        UAVDataObject* obj = list[0];
+        QByteArray packed(obj->getNumBytes(), 0);
+        obj->pack((quint8*)packed.data());
+        foreach (UAVObjectField* field, obj->getFields()) {
+            QVector<double> values(field->getNumElements() + 1, -1);
+            QVector<double> unpacked(field->getNumElements(), -1);
+            QCOMPARE(field->readAllAsDouble(values.data(), values.size()), field->getNumElements());
+            QCOMPARE(field->readAllAsDouble(unpacked.data(), unpacked.size(), (const quint8*)packed.constData()),
+                     field->getNumElements());
+            for (quint32 i = 0; i < field->getNumElements(); ++i) {
+                QVERIFY(sameDouble(values[i], field->getDouble(i)));
+                QVERIFY(sameDouble(unpacked[i], values[i]));
+            }
+            // Nothing is written past the field
+            QCOMPARE(values.last(), -1.0);
+        }
+    }
+
+    // A short destination is not overrun
+    UAVObjectField* channel = ActuatorCommand::GetInstance(objMngr)->getField("Channel");
+    double values[3] = { -1, -1, -1 };
+    QCOMPARE(channel->readAllAsDouble(values, 2), (quint32)2);
+    QCOMPARE(values[2], -1.0);
+}
+
+void tst_UAVObjectField::elementIndex()
+{
+    foreach (QVector<UAVDataObject*> list, objMngr->getDataObjects()) {
+        foreach (UAVObjectField* field, list[0]->getFields()) {
+            QStringList names = field->getElementNames();
+            for (int i = 0; i < names.size(); ++i)
+                QCOMPARE(field->getElementIndex(names[i]), i);
+            QCOMPARE(field->getElementIndex("NoSuchElement"), -1);
+        }
+    }
+}
+
+void tst_UAVObjectField::generatedUnpack()
+{
+    ActuatorCommand* obj = ActuatorCommand::GetInstance(objMngr);
+    for (quint32 i = 0; i < ActuatorCommand::CHANNEL_NUMELEM; ++i)
+        obj->setChannel(i, 1000 + i);
+    obj->setMaxUpdateTime(1234);
+
+    QByteArray packed(obj->getNumBytes(), 0);
+    obj->pack((quint8*)packed.data());
+    const quint8* data = (const quint8*)packed.constData();
+    for (quint32 i = 0; i < ActuatorCommand::CHANNEL_NUMELEM; ++i)
+        QCOMPARE(ActuatorCommand::unpackChannel(data, i), (qint16)(1000 + i));
+    QCOMPARE(ActuatorCommand::unpackMaxUpdateTime(data), (quint16)1234);
+    QCOMPARE((quint32)ActuatorCommand::MAXUPDATETIME_OFFSET, obj->getField("MaxUpdateTime")->getDataOffset());
+}
+
+void tst_UAVObjectField::benchmarkGetValue()
+{
+    UAVObjectField* channel = ActuatorCommand::GetInstance(objMngr)->getField("Channel");
+    double sum = 0;
+    QBENCHMARK {
+        for (quint32 i = 0; i < channel->getNumElements(); ++i)
+            sum += channel->getValue(i).toDouble();
+    }
+    Q_UNUSED(sum);
+}
+
+void tst_UAVObjectField::benchmarkGetDouble()
+{
+    UAVObjectField* channel = ActuatorCommand::GetInstance(objMngr)->getField("Channel");
+    double sum = 0;
+    QBENCHMARK {
+        for (quint32 i = 0; i < channel->getNumElements(); ++i)
+            sum += channel->getDouble(i);
+    }
+    Q_UNUSED(sum);
+}
+
+void tst_UAVObjectField::benchmarkReadAll()
+{
+    UAVObjectField* channel = ActuatorCommand::GetInstance(objMngr)->getField("Channel");
+    double values[ActuatorCommand::CHANNEL_NUMELEM];
+    QBENCHMARK {
+        channel->readAllAsDouble(values, ActuatorCommand::CHANNEL_NUMELEM);
+    }
+}
+
+QTEST_MAIN(tst_UAVObjectField)
+#include "tst_uavobjectfield.moc"
+
+/**
+ * @}
+ * @}
+ */
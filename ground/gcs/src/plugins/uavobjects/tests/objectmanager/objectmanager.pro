@@ -0,0 +1,14 @@
+# -------------------------------------------------
+# Lookup correctness and benchmark for the UAVObjectManager,
+# run against the full set of generated objects.
+# -------------------------------------------------
+TEMPLATE = app
+TARGET = tst_uavobjectmanager
+CONFIG += qtestlib console
+CONFIG -= app_bundle
+
+include(../../../../../gcs.pri)
+LIBS += -L$$GCS_PLUGIN_PATH/TauLabs
+include(../../uavobjects.pri)
+
+SOURCES += tst_uavobjectmanager.cpp
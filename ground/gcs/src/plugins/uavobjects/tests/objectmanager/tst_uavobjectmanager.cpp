@@ -0,0 +1,260 @@
+/**
+ ******************************************************************************
+ *
+ * @file       tst_uavobjectmanager.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief      Tests and benchmarks the object lookups of the UAVObjectManager
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "uavobjectmanager.h"
+#include "uavobjectsinit.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QThread>
+#include <QtTest/QtTest>
+
+/**
+ * Looks up every object type by ID in a loop until stopped, counting
+ * lookups that fail. Used to hammer the manager while objects register.
+ */
+class LookupThread : public QThread
+{
+public:
+    LookupThread(UAVObjectManager* objMngr, const QVector<quint32>& ids) :
+        objMngr(objMngr), ids(ids), running(1), failures(0)
+    {
+    }
+
+    void stop() { running = 0; }
+    int getFailures() const { return failures; }
+
+protected:
+    void run()
+    {
+        while (running)
+        {
+            for (int i = 0; i < ids.size(); ++i)
+            {
+                if (objMngr->getObject(ids[i]) == NULL)
+                {
+                    ++failures;
+                }
+            }
+        }
+    }
+
+private:
+    UAVObjectManager* objMngr;
+    QVector<quint32> ids;
+    QAtomicInt running;
+    int failures;
+};
+
+class tst_UAVObjectManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void lookupById();
+    void lookupByName();
+    void lookupMissing();
+    void registerInstances();
+    void concurrentLookup();
+    void benchmarkLookupById();
+    void benchmarkLookupByName();
+    void benchmarkObjectInstances();
+
+private:
+    UAVDataObject* findMultiInstanceObject();
+
+    UAVObjectManager* objMngr;
+    QVector<quint32> ids;
+    QVector<QString> names;
+};
+
+void tst_UAVObjectManager::initTestCase()
+{
+    objMngr = new UAVObjectManager();
+    UAVObjectsInitialize(objMngr);
+
+    QVector< QVector<UAVObject*> > objects = objMngr->getObjects();
+    QVERIFY(objects.size() > 0);
+    for (int objidx = 0; objidx < objects.size(); ++objidx)
+    {
+        ids.append(objects[objidx][0]->getObjID());
+        names.append(objects[objidx][0]->getName());
+    }
+}
+
+void tst_UAVObjectManager::cleanupTestCase()
+{
+    delete objMngr;
+}
+
+void tst_UAVObjectManager::lookupById()
+{
+    QVector< QVector<UAVObject*> > objects = objMngr->getObjects();
+    for (int objidx = 0; objidx < objects.size(); ++objidx)
+    {
+        quint32 objId = objects[objidx][0]->getObjID();
+        QCOMPARE(objMngr->getNumInstances(objId), objects[objidx].size());
+        QCOMPARE(objMngr->getObjectInstances(objId), objects[objidx]);
+        for (int instidx = 0; instidx < objects[objidx].size(); ++instidx)
+        {
+            QCOMPARE(objMngr->getObject(objId, instidx), objects[objidx][instidx]);
+        }
+    }
+}
+
+void tst_UAVObjectManager::lookupByName()
+{
+    QVector< QVector<UAVObject*> > objects = objMngr->getObjects();
+    for (int objidx = 0; objidx < objects.size(); ++objidx)
+    {
+        QString name = objects[objidx][0]->getName();
+        QCOMPARE(objMngr->getNumInstances(name), objects[objidx].size());
+        QCOMPARE(objMngr->getObjectInstances(name), objects[objidx]);
+        QCOMPARE(objMngr->getObject(name), objects[objidx][0]);
+    }
+}
+
+void tst_UAVObjectManager::lookupMissing()
+{
+    quint32 unknownId = 0;
+    while (ids.contains(unknownId))
+    {
+        ++unknownId;
+    }
+    QVERIFY(objMngr->getObject(unknownId) == NULL);
+    QVERIFY(objMngr->getObject(QString("NoSuchObject")) == NULL);
+    QVERIFY(objMngr->getObject(ids[0], 1000) == NULL);
+    QCOMPARE(objMngr->getNumInstances(unknownId), -1);
+    QVERIFY(objMngr->getObjectInstances(QString("NoSuchObject")).isEmpty());
+}
+
+UAVDataObject* tst_UAVObjectManager::findMultiInstanceObject()
+{
+    QVector< QVector<UAVDataObject*> > objects = objMngr->getDataObjects();
+    for (int objidx = 0; objidx < objects.size(); ++objidx)
+    {
+        if (!objects[objidx][0]->isSingleInstance())
+        {
+            return objects[objidx][0];
+        }
+    }
+    return NULL;
+}
+
+void tst_UAVObjectManager::registerInstances()
+{
+    UAVDataObject* obj = findMultiInstanceObject();
+    if (obj == NULL)
+    {
+        QSKIP("No multi instance object in the object set", SkipAll);
+    }
+    quint32 objId = obj->getObjID();
+    qint32 numInstances = objMngr->getNumInstances(objId);
+
+    // Registering an instance past the end fills the gap
+    quint32 instId = numInstances + 3;
+    QVERIFY(objMngr->registerObject(obj->clone(instId)));
+    QCOMPARE(objMngr->getNumInstances(objId), (qint32)instId + 1);
+    for (quint32 i = 0; i <= instId; ++i)
+    {
+        UAVObject* inst = objMngr->getObject(objId, i);
+        QVERIFY(inst != NULL);
+        QCOMPARE(inst->getInstID(), i);
+        QCOMPARE(objMngr->getObject(obj->getName(), i), inst);
+    }
+
+    // Taken instance IDs are refused
+    UAVDataObject* conflict = obj->clone(1);
+    QVERIFY(!objMngr->registerObject(conflict));
+    delete conflict;
+}
+
+void tst_UAVObjectManager::concurrentLookup()
+{
+    UAVDataObject* obj = findMultiInstanceObject();
+    if (obj == NULL)
+    {
+        QSKIP("No multi instance object in the object set", SkipAll);
+    }
+
+    // Readers must never see a registered object disappear while the
+    // snapshots are swapped underneath them
+    LookupThread reader(objMngr, ids);
+    reader.start();
+    for (int i = 0; i < 100; ++i)
+    {
+        QVERIFY(objMngr->registerObject(obj->clone(0)));
+    }
+    reader.stop();
+    reader.wait();
+    QCOMPARE(reader.getFailures(), 0);
+}
+
+void tst_UAVObjectManager::benchmarkLookupById()
+{
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 0; i < ids.size(); ++i)
+        {
+            found += (objMngr->getObject(ids[i]) != NULL);
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+void tst_UAVObjectManager::benchmarkLookupByName()
+{
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 0; i < names.size(); ++i)
+        {
+            found += (objMngr->getObject(names[i]) != NULL);
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+void tst_UAVObjectManager::benchmarkObjectInstances()
+{
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 0; i < ids.size(); ++i)
+        {
+            found += objMngr->getObjectInstances(ids[i]).size();
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+QTEST_MAIN(tst_UAVObjectManager)
+#include "tst_uavobjectmanager.moc"
+
+/**
+ * @}
+ * @}
+ */
@@ -0,0 +1,216 @@
+/**
+ ******************************************************************************
+ *
+ * @file       tst_uavobjectupdatebus.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief      Tests the coalesced notifications of the UAVObjectUpdateBus
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "uavobjectmanager.h"
+#include "uavobjectupdatebus.h"
+#include "uavobjectsinit.h"
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+/**
+ * Counts the callbacks of the bus
+ */
+class Receiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    Receiver() : calls(0), dropped(0), obj(NULL) {}
+
+    int calls;
+    quint32 dropped;
+    UAVObject* obj;
+
+public slots:
+    void updated(UAVObject* obj, quint32 dropped)
+    {
+        ++calls;
+        this->dropped += dropped;
+        this->obj = obj;
+    }
+};
+
+class tst_UAVObjectUpdateBus : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void coalescesUpdates();
+    void limitsRate();
+    void ringKeepsSamples();
+    void ringOverrun();
+    void receiverDestroyed();
+
+private:
+    void update(int times);
+
+    UAVObjectManager* objMngr;
+    UAVObjectUpdateBus* bus;
+    UAVDataObject* obj;
+};
+
+void tst_UAVObjectUpdateBus::initTestCase()
+{
+    objMngr = new UAVObjectManager();
+    UAVObjectsInitialize(objMngr);
+    bus = new UAVObjectUpdateBus();
+
+    QVector< QVector<UAVDataObject*> > objects = objMngr->getDataObjects();
+    QVERIFY(objects.size() > 0);
+    obj = objects[0][0];
+}
+
+void tst_UAVObjectUpdateBus::cleanupTestCase()
+{
+    delete bus;
+    delete objMngr;
+}
+
+/**
+ * Feed the object its own data, as the telemetry would
+ */
+void tst_UAVObjectUpdateBus::update(int times)
+{
+    QByteArray data(obj->getNumBytes(), 0);
+    obj->pack((quint8*)data.data());
+    for (int i = 0; i < times; ++i)
+    {
+        obj->unpack((const quint8*)data.constData());
+    }
+}
+
+void tst_UAVObjectUpdateBus::coalescesUpdates()
+{
+    Receiver receiver;
+    int id = bus->subscribe(obj, &receiver, "updated", 0);
+    QVERIFY(id > 0);
+
+    // Nothing is delivered without an update
+    QTest::qWait(50);
+    QCOMPARE(receiver.calls, 0);
+
+    update(100);
+    QTest::qWait(50);
+    QCOMPARE(receiver.calls, 1);
+    QCOMPARE(receiver.dropped, (quint32)99);
+    QCOMPARE(receiver.obj, (UAVObject*)obj);
+
+    bus->unsubscribe(id);
+    update(10);
+    QTest::qWait(50);
+    QCOMPARE(receiver.calls, 1);
+}
+
+void tst_UAVObjectUpdateBus::limitsRate()
+{
+    Receiver receiver;
+    int id = bus->subscribe(obj, &receiver, "updated", 2);
+
+    // At 2 Hz there is one callback for the first update and then none for 500ms
+    QTime time;
+    time.start();
+    update(1);
+    QTest::qWait(50);
+    QCOMPARE(receiver.calls, 1);
+    while (time.elapsed() < 300)
+    {
+        update(1);
+        QTest::qWait(20);
+    }
+    QCOMPARE(receiver.calls, 1);
+    QTest::qWait(300);
+    QCOMPARE(receiver.calls, 2);
+
+    bus->unsubscribe(id);
+}
+
+void tst_UAVObjectUpdateBus::ringKeepsSamples()
+{
+    Receiver receiver;
+    int id = bus->subscribe(obj, &receiver, "updated", 0, 64);
+
+    update(40);
+    QTest::qWait(50);
+    QCOMPARE(receiver.calls, 1);
+    QCOMPARE(receiver.dropped, (quint32)0);
+
+    QVector<UAVObjectSample> samples;
+    QCOMPARE(bus->takeSamples(id, samples), 40);
+    QCOMPARE(samples.size(), 40);
+    for (int i = 0; i < samples.size(); ++i)
+    {
+        QCOMPARE((quint32)samples[i].data.size(), obj->getNumBytes());
+        if (i > 0)
+        {
+            QVERIFY(samples[i].timestamp >= samples[i - 1].timestamp);
+        }
+    }
+
+    // The ring is empty once taken
+    QCOMPARE(bus->takeSamples(id, samples), 0);
+    bus->unsubscribe(id);
+}
+
+void tst_UAVObjectUpdateBus::ringOverrun()
+{
+    Receiver receiver;
+    int id = bus->subscribe(obj, &receiver, "updated", 0, 16);
+
+    update(50);
+    QTest::qWait(50);
+    QCOMPARE(receiver.calls, 1);
+    QCOMPARE(receiver.dropped, (quint32)34);
+    QCOMPARE(bus->getOverruns(id), (quint32)34);
+
+    QVector<UAVObjectSample> samples;
+    QCOMPARE(bus->takeSamples(id, samples), 16);
+    bus->unsubscribe(id);
+}
+
+void tst_UAVObjectUpdateBus::receiverDestroyed()
+{
+    Receiver* receiver = new Receiver();
+    int id = bus->subscribe(obj, receiver, "updated", 0, 8);
+    delete receiver;
+
+    // The subscription went away with its receiver
+    update(10);
+    QTest::qWait(50);
+    QVector<UAVObjectSample> samples;
+    QCOMPARE(bus->takeSamples(id, samples), 0);
+}
+
+QTEST_MAIN(tst_UAVObjectUpdateBus)
+#include "tst_uavobjectupdatebus.moc"
+
+/**
+ * @}
+ * @}
+ */
@@ -0,0 +1,14 @@
+# -------------------------------------------------
+# Coalescing, rate limiting and sample rings of the UAVObjectUpdateBus,
+# run against the full set of generated objects.
+# -------------------------------------------------
+TEMPLATE = app
+TARGET = tst_uavobjectupdatebus
+CONFIG += qtestlib console
+CONFIG -= app_bundle
+
+include(../../../../../gcs.pri)
+LIBS += -L$$GCS_PLUGIN_PATH/TauLabs
+include(../../uavobjects.pri)
+
+SOURCES += tst_uavobjectupdatebus.cpp
@@ -280,14 +280,18 @@ qint32 UAVObject::pack(quint8* dataOut)
  */
 qint32 UAVObject::unpack(const quint8* dataIn)
 {
-    QMutexLocker locker(mutex);
-    qint32 offset = 0;
-    for (QList<UAVObjectField*>::iterator iter = fields.begin(); iter != fields.end(); ++iter)
     {
-        UAVObjectField *field = *iter;
-        field->unpack(&dataIn[offset]);
-        offset += field->getNumBytes();
+        QMutexLocker locker(mutex);
+        qint32 offset = 0;
+        for (QList<UAVObjectField*>::iterator iter = fields.begin(); iter != fields.end(); ++iter)
+        {
+            UAVObjectField *field = *iter;
+            field->unpack(&dataIn[offset]);
+            offset += field->getNumBytes();
+        }
     }
+    // Signal with the lock released, the telemetry thread unpacks while other
+    // threads read the object and slots connected directly run right here
     emit objectUnpacked(this); // trigger object updated event
     emit objectUpdated(this);
 
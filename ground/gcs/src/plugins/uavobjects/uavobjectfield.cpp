@@ -96,6 +96,10 @@ void UAVObjectField::constructorInitialize(const QString& name, const QString& u
     default:
         numBytesPerElement = 0;
     }
+    // Numeric value of each enum option, so getDouble() does not parse strings
+    optionValues.resize(this->options.length());
+    for (int n = 0; n < this->options.length(); ++n)
+        optionValues[n] = this->options[n].toDouble();
     limitsInitialize(limits);
 }
 
@@ -515,6 +519,16 @@ QStringList UAVObjectField::getElementNames()
     return elementNames;
 }
 
+/**
+ * Resolve an element name to its index, intended to be done once when
+ * a consumer is configured rather than for each sample.
+ * \return The element index or -1 if the name is unknown
+ */
+int UAVObjectField::getElementIndex(const QString& elementName)
+{
+    return elementNames.indexOf(elementName);
+}
+
 UAVObject* UAVObjectField::getObject()
 {
     return obj;
@@ -1034,9 +1048,124 @@ void UAVObjectField::setValue(const QVariant& value, quint32 index)
     }
 }
 
+/**
+ * Convert one element to a double without going through a QVariant. Gives
+ * the same result as getValue(index).toDouble().
+ * \param[in] fieldData Start of the field, in the object data or in packed data
+ * \param[in] index Element index, must be in range
+ * \param[in] packed True if fieldData is packed (little endian) object data
+ */
+double UAVObjectField::elementAsDouble(const quint8* fieldData, quint32 index, bool packed)
+{
+    switch (type)
+    {
+    case INT8:
+        return (qint8)fieldData[index];
+    case UINT8:
+        return fieldData[index];
+    case INT16:
+    {
+        if (packed)
+            return unpackElement<qint16>(fieldData, index);
+        qint16 value;
+        memcpy(&value, &fieldData[numBytesPerElement*index], sizeof(value));
+        return value;
+    }
+    case INT32:
+    {
+        if (packed)
+            return unpackElement<qint32>(fieldData, index);
+        qint32 value;
+        memcpy(&value, &fieldData[numBytesPerElement*index], sizeof(value));
+        return value;
+    }
+    case UINT16:
+    {
+        if (packed)
+            return unpackElement<quint16>(fieldData, index);
+        quint16 value;
+        memcpy(&value, &fieldData[numBytesPerElement*index], sizeof(value));
+        return value;
+    }
+    case UINT32:
+    {
+        if (packed)
+            return unpackElement<quint32>(fieldData, index);
+        quint32 value;
+        memcpy(&value, &fieldData[numBytesPerElement*index], sizeof(value));
+        return value;
+    }
+    case FLOAT32:
+    {
+        if (packed)
+            return unpackElement<float>(fieldData, index);
+        float value;
+        memcpy(&value, &fieldData[numBytesPerElement*index], sizeof(value));
+        return value;
+    }
+    case ENUM:
+    {
+        quint8 option = fieldData[index];
+        if (option >= optionValues.size())
+            return 0;
+        return optionValues[option];
+    }
+    case BITFIELD:
+        return (fieldData[index/8] >> (index % 8)) & 1;
+    case STRING:
+    {
+        const char* str = (const char*)fieldData;
+        return QString::fromLatin1(str, qstrnlen(str, numElements - 1)).toDouble();
+    }
+    }
+    return 0;
+}
+
 double UAVObjectField::getDouble(quint32 index)
 {
-    return getValue(index).toDouble();
+    QMutexLocker locker(obj->getMutex());
+    if (index >= numElements)
+        return 0;
+    return elementAsDouble(&data[offset], index, false);
+}
+
+/**
+ * Get one element from packed object data, e.g. a sample kept by the
+ * UAVObjectUpdateBus, instead of from the current object data.
+ * \param[in] packedObject Packed data of the whole object
+ */
+double UAVObjectField::getDouble(quint32 index, const quint8* packedObject)
+{
+    if (index >= numElements)
+        return 0;
+    return elementAsDouble(&packedObject[offset], index, true);
+}
+
+/**
+ * Read every element of the field as doubles, taking the object lock once.
+ * \param[out] values Destination, at least maxValues long
+ * \param[in] maxValues Capacity of values
+ * \return Number of elements written
+ */
+quint32 UAVObjectField::readAllAsDouble(double* values, quint32 maxValues)
+{
+    QMutexLocker locker(obj->getMutex());
+    quint32 count = qMin(numElements, maxValues);
+    for (quint32 index = 0; index < count; ++index)
+        values[index] = elementAsDouble(&data[offset], index, false);
+    return count;
+}
+
+/**
+ * Read every element of the field as doubles from packed object data.
+ * \param[in] packedObject Packed data of the whole object
+ */
+quint32 UAVObjectField::readAllAsDouble(double* values, quint32 maxValues, const quint8* packedObject)
+{
+    quint32 count = qMin(numElements, maxValues);
+    for (quint32 index = 0; index < count; ++index)
+        values[index] = elementAsDouble(&packedObject[offset], index, true);
+    return count;
 }
 
 void UAVObjectField::setDouble(double value, quint32 index)
@@ -32,8 +32,11 @@
 #include "uavobject.h"
 #include <QStringList>
 #include <QVariant>
+#include <QVector>
 #include <QList>
 #include <QMap>
+#include <QtEndian>
+#include <string.h>
 
 class UAVObject;
 
@@ -61,6 +64,7 @@ public:
     QString getUnits();
     quint32 getNumElements();
     QStringList getElementNames();
+    int getElementIndex(const QString& elementName);
     QStringList getOptions();
     qint32 pack(quint8* dataOut);
     qint32 unpack(const quint8* dataIn);
@@ -68,6 +72,9 @@ public:
     bool checkValue(const QVariant& data, quint32 index = 0);
     void setValue(const QVariant& data, quint32 index = 0);
     double getDouble(quint32 index = 0);
+    double getDouble(quint32 index, const quint8* packedObject);
+    quint32 readAllAsDouble(double* values, quint32 maxValues);
+    quint32 readAllAsDouble(double* values, quint32 maxValues, const quint8* packedObject);
     void setDouble(double value, quint32 index = 0);
     quint32 getDataOffset();
     quint32 getNumBytes();
@@ -78,6 +85,9 @@ public:
     bool isWithinLimits(QVariant var, quint32 index, int board=0);
     QVariant getMaxLimit(quint32 index, int board=0);
     QVariant getMinLimit(quint32 index, int board=0);
+
+    template <typename T>
+    static T unpackElement(const quint8* fieldData, quint32 index);
 signals:
     void fieldUpdated(UAVObjectField* field);
 
@@ -87,6 +97,7 @@ protected:
     FieldType type;
     QStringList elementNames;
     QStringList options;
+    QVector<double> optionValues;
     quint32 numElements;
     quint32 numBytesPerElement;
     quint32 offset;
@@ -96,8 +107,29 @@ protected:
     void clear();
     void constructorInitialize(const QString& name, const QString& units, FieldType type, const QStringList& elementNames, const QStringList& options, const QString &limits);
     void limitsInitialize(const QString &limits);
+    double elementAsDouble(const quint8* fieldData, quint32 index, bool packed);
 
 
 };
 
+/**
+ * Read one element of a field from packed (little endian) object data.
+ * \param[in] fieldData Start of the field inside the packed object
+ * \param[in] index Element index
+ */
+template <typename T>
+inline T UAVObjectField::unpackElement(const quint8* fieldData, quint32 index)
+{
+    return qFromLittleEndian<T>(&fieldData[sizeof(T)*index]);
+}
+
+template <>
+inline float UAVObjectField::unpackElement<float>(const quint8* fieldData, quint32 index)
+{
+    quint32 bits = qFromLittleEndian<quint32>(&fieldData[sizeof(quint32)*index]);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
 #endif // UAVOBJECTFIELD_H
@@ -30,16 +30,81 @@
 /**
  * Constructor
  */
-UAVObjectManager::UAVObjectManager()
+UAVObjectManager::UAVObjectManager() :
+    current(new Snapshot()),
+    readers(0),
+    numRetired(0)
 {
     mutex = new QMutex(QMutex::Recursive);
 }
 
 UAVObjectManager::~UAVObjectManager()
 {
+    delete (Snapshot*)current;
+    qDeleteAll(retired);
     delete mutex;
 }
 
+/**
+ * Get the current snapshot for reading. Every call must be paired with endRead()
+ * once the caller is done with the returned snapshot. This never blocks.
+ */
+const UAVObjectManager::Snapshot* UAVObjectManager::beginRead()
+{
+    // Announce the reader before loading the pointer, so that a writer which
+    // sees no readers knows nobody can still be looking at a retired snapshot
+    readers.ref();
+    return current;
+}
+
+void UAVObjectManager::endRead()
+{
+    if (!readers.deref() && numRetired != 0)
+    {
+        // Last reader out, free the old snapshots unless a writer is busy
+        if (mutex->tryLock())
+        {
+            reclaim();
+            mutex->unlock();
+        }
+    }
+}
+
+/**
+ * Get a private copy of the current snapshot to modify. Must be called with the
+ * mutex held, the copy is made visible to readers with publish().
+ */
+UAVObjectManager::Snapshot* UAVObjectManager::beginWrite()
+{
+    // The containers are implicitly shared, only what is modified gets copied
+    return new Snapshot(*(Snapshot*)current);
+}
+
+/**
+ * Make a snapshot the one seen by readers. Must be called with the mutex held.
+ */
+void UAVObjectManager::publish(Snapshot* next)
+{
+    retired.append(current.fetchAndStoreOrdered(next));
+    reclaim();
+}
+
+/**
+ * Free the snapshots which have been replaced, if no reader can still hold one.
+ * Must be called with the mutex held.
+ */
+void UAVObjectManager::reclaim()
+{
+    // A reader arriving after this check loads the current snapshot which is
+    // never in the retired list
+    if (readers == 0)
+    {
+        qDeleteAll(retired);
+        retired.clear();
+    }
+    numRetired = retired.size();
+}
+
 /**
  * Register an object with the manager. This function must be called for all newly created instances.
  * A new instance can be created directly by instantiating a new object or by calling clone() of
@@ -49,68 +114,62 @@ UAVObjectManager::~UAVObjectManager()
 bool UAVObjectManager::registerObject(UAVDataObject* obj)
 {
     QMutexLocker locker(mutex);
-    // Check if this object type is already in the list
+    // Check if this object type is already in the list. Only writers replace the
+    // snapshot and they hold the mutex, so it can be used directly here.
     quint32 objID = obj->getObjID();
-    for (int objidx = 0; objidx < objects.size(); ++objidx)
+    const Snapshot* snap = current;
+    int objidx = snap->idIndex.value(objID, -1);
+    if (objidx >= 0)
     {
-        // Check if the object ID is in the list
-        if (objects[objidx].size() > 0 && objects[objidx][0]->getObjID() == objID)
+        // Check if this is a single instance object, if yes we can not add a new instance
+        if (obj->isSingleInstance())
         {
-            // Check if this is a single instance object, if yes we can not add a new instance
-            if (obj->isSingleInstance())
-            {
-                return false;
-            }
-            // The object type has alredy been added, so now we need to initialize the new instance with the appropriate id
-            // There is a single metaobject for all object instances of this type, so no need to create a new one
-            // Get object type metaobject from existing instance
-            UAVDataObject* refObj = dynamic_cast<UAVDataObject*>(objects[objidx][0]);
-            if (refObj == NULL)
+            return false;
+        }
+        // The object type has alredy been added, so now we need to initialize the new instance with the appropriate id
+        // There is a single metaobject for all object instances of this type, so no need to create a new one
+        // Get object type metaobject from existing instance
+        UAVDataObject* refObj = dynamic_cast<UAVDataObject*>(snap->objects[objidx][0]);
+        if (refObj == NULL)
+        {
+            return false;
+        }
+        UAVMetaObject* mobj = refObj->getMetaObject();
+        quint32 numInstances = snap->objects[objidx].size();
+        // If the instance ID is specified and not at the default value (0) then we need to make sure
+        // that there are no gaps in the instance list. If gaps are found then then additional instances
+        // will be created.
+        if ( (obj->getInstID() > 0) && (obj->getInstID() < MAX_INSTANCES) )
+        {
+            // Instances are dense, so any ID below the count is already taken
+            if (obj->getInstID() < numInstances)
             {
+                // Instance conflict, do not add
                 return false;
             }
-            UAVMetaObject* mobj = refObj->getMetaObject();
-            // If the instance ID is specified and not at the default value (0) then we need to make sure
-            // that there are no gaps in the instance list. If gaps are found then then additional instances
-            // will be created.
-            if ( (obj->getInstID() > 0) && (obj->getInstID() < MAX_INSTANCES) )
-            {
-                for (int instidx = 0; instidx < objects[objidx].size(); ++instidx)
-                {
-                    if ( objects[objidx][instidx]->getInstID() == obj->getInstID() )
-                    {
-                        // Instance conflict, do not add
-                        return false;
-                    }
-                }
-                // Check if there are any gaps between the requested instance ID and the ones in the list,
-                // if any then create the missing instances.
-                for (quint32 instidx = objects[objidx].size(); instidx < obj->getInstID(); ++instidx)
-                {
-                    UAVDataObject* cobj = obj->clone(instidx);
-                    cobj->initialize(mobj);
-                    objects[objidx].append(cobj);
-                    getObject(cobj->getObjID())->emitNewInstance(cobj);
-                    emit newInstance(cobj);
-                }
-                // Finally, initialize the actual object instance
-                obj->initialize(mobj);
-            }
-            else if (obj->getInstID() == 0)
+            // Check if there are any gaps between the requested instance ID and the ones in the list,
+            // if any then create the missing instances.
+            for (quint32 instidx = numInstances; instidx < obj->getInstID(); ++instidx)
             {
-                // Assign the next available ID and initialize the object instance
-                obj->initialize(objects[objidx].size(), mobj);
+                UAVDataObject* cobj = obj->clone(instidx);
+                cobj->initialize(mobj);
+                addInstance(objidx, cobj);
             }
-            else
-            {
-                return false;
-            }
-            // Add the actual object instance in the list
-            objects[objidx].append(obj);
-            getObject(objID)->emitNewInstance(obj);
-            emit newInstance(obj);
-            return true;
+            // Finally, initialize the actual object instance
+            obj->initialize(mobj);
         }
+        else if (obj->getInstID() == 0)
+        {
+            // Assign the next available ID and initialize the object instance
+            obj->initialize(numInstances, mobj);
+        }
+        else
+        {
+            return false;
+        }
+        // Add the actual object instance in the list
+        addInstance(objidx, obj);
+        return true;
     }
     // If this point is reached then this is the first time this object type (ID) is added in the list
     // create a new list of the instances, add in the object collection and create the object's metaobject
@@ -129,19 +188,41 @@ bool UAVObjectManager::registerObject(UAVDataObject* obj)
 void UAVObjectManager::addObject(UAVObject* obj)
 {
     // Add to list
+    Snapshot* next = beginWrite();
     QVector<UAVObject*> list;
     list.append(obj);
-    objects.append(list);
+    // Lookups used to return the first match, keep it that way
+    if (!next->idIndex.contains(obj->getObjID()))
+    {
+        next->idIndex.insert(obj->getObjID(), next->objects.size());
+    }
+    if (!next->nameIndex.contains(obj->getName()))
+    {
+        next->nameIndex.insert(obj->getName(), next->objects.size());
+    }
+    next->objects.append(list);
+    publish(next);
     emit newObject(obj);
 }
 
+void UAVObjectManager::addInstance(int objidx, UAVObject* obj)
+{
+    Snapshot* next = beginWrite();
+    next->objects[objidx].append(obj);
+    publish(next);
+    next->objects[objidx][0]->emitNewInstance(obj);
+    emit newInstance(obj);
+}
+
 /**
  * Get all objects. A two dimentional QVector is returned. Objects are grouped by
  * instances of the same object type.
  */
 QVector< QVector<UAVObject*> > UAVObjectManager::getObjects()
 {
-    QMutexLocker locker(mutex);
+    const Snapshot* snap = beginRead();
+    QVector< QVector<UAVObject*> > objects = snap->objects;
+    endRead();
     return objects;
 }
 
@@ -150,7 +231,7 @@ QVector< QVector<UAVObject*> > UAVObjectManager::getObjects()
  */
 QVector< QVector<UAVDataObject*> > UAVObjectManager::getDataObjects()
 {
-    QMutexLocker locker(mutex);
+    QVector< QVector<UAVObject*> > objects = getObjects();
     QVector< QVector<UAVDataObject*> > dObjects;
 
     // Go through objects and copy to new list when types match
@@ -187,7 +268,7 @@ QVector< QVector<UAVDataObject*> > UAVObjectManager::getDataObjects()
  */
 QVector <QVector<UAVMetaObject*> > UAVObjectManager::getMetaObjects()
 {
-    QMutexLocker locker(mutex);
+    QVector< QVector<UAVObject*> > objects = getObjects();
     QVector< QVector<UAVMetaObject*> > mObjects;
 
     // Go through objects and copy to new list when types match
@@ -237,34 +318,40 @@ UAVObject* UAVObjectManager::getObject(quint32 objId, quint32 instId)
     return getObject(NULL, objId, instId);
 }
 
+/**
+ * Helper to find the index of an object type in a snapshot, by name if one is
+ * given otherwise by object ID.
+ * @returns The index in the snapshot objects or -1 if not found
+ */
+int UAVObjectManager::findType(const Snapshot* snap, const QString* name, quint32 objId)
+{
+    if (name != NULL)
+    {
+        return snap->nameIndex.value(*name, -1);
+    }
+    return snap->idIndex.value(objId, -1);
+}
+
 /**
  * Helper function for the public getObject() functions.
  */
 UAVObject* UAVObjectManager::getObject(const QString* name, quint32 objId, quint32 instId)
 {
-    QMutexLocker locker(mutex);
-    // Check if this object type is already in the list
-    for (int objidx = 0; objidx < objects.size(); ++objidx)
+    UAVObject* obj = NULL;
+    const Snapshot* snap = beginRead();
+    int objidx = findType(snap, name, objId);
+    if (objidx >= 0)
     {
-        // Check if the object ID is in the list
-        if (objects[objidx].size() > 0)
+        // Instances are dense so the instance ID is the index
+        const QVector<UAVObject*>& instances = snap->objects.at(objidx);
+        if (instId < (quint32)instances.size())
         {
-            if ( (name != NULL && objects[objidx][0]->getName().compare(name) == 0) || (name == NULL && objects[objidx][0]->getObjID() == objId) )
-            {
-                // Look for the requested instance ID
-                for (int instidx = 0; instidx < objects[objidx].size(); ++instidx)
-                {
-                    if (objects[objidx][instidx]->getInstID() == instId)
-                    {
-                        return objects[objidx][instidx];
-                    }
-                }
-            }
+            obj = instances.at(instId);
         }
     }
-    //qWarning("UAVObjectManager::getObject: Object not found.  Probably a bug or mismatched GCS/flight versions.");
-    // If this point is reached then the requested object could not be found
-    return NULL;
+    endRead();
+    //if (obj == NULL) qWarning("UAVObjectManager::getObject: Object not found.  Probably a bug or mismatched GCS/flight versions.");
+    return obj;
 }
 
 /**
@@ -288,22 +375,15 @@ QVector<UAVObject*> UAVObjectManager::getObjectInstances(quint32 objId)
  */
 QVector<UAVObject*> UAVObjectManager::getObjectInstances(const QString* name, quint32 objId)
 {
-    QMutexLocker locker(mutex);
-    // Check if this object type is already in the list
-    const QVector< QVector<UAVObject*> >::iterator objectsSize = objects.end();
-    for (QVector< QVector<UAVObject*> >::iterator iter = objects.begin(); iter != objectsSize; ++iter)
+    QVector<UAVObject*> instances;
+    const Snapshot* snap = beginRead();
+    int objidx = findType(snap, name, objId);
+    if (objidx >= 0)
     {
-        // Check if the object ID is in the list
-        if (iter->size() > 0)
-        {
-            if ( (name != NULL && (*iter)[0]->getName().compare(name) == 0) || (name == NULL && (*iter)[0]->getObjID() == objId) )
-            {
-                return (*iter);
-            }
-        }
+        instances = snap->objects.at(objidx);
     }
-    // If this point is reached then the requested object could not be found
-    return QVector<UAVObject*>();
+    endRead();
+    return instances;
 }
 
 /**
@@ -327,19 +407,13 @@ qint32 UAVObjectManager::getNumInstances(quint32 objId)
  */
 qint32 UAVObjectManager::getNumInstances(const QString* name, quint32 objId)
 {
-    QMutexLocker locker(mutex);
-    // Check if this object type is already in the list
-    for (int objidx = 0; objidx < objects.size(); ++objidx)
+    qint32 num = -1;
+    const Snapshot* snap = beginRead();
+    int objidx = findType(snap, name, objId);
+    if (objidx >= 0)
     {
-        // Check if the object ID is in the list
-        if (objects[objidx].size() > 0)
-        {
-            if ( (name != NULL && objects[objidx][0]->getName().compare(name) == 0) || (name == NULL && objects[objidx][0]->getObjID() == objId) )
-            {
-                return objects[objidx].size();
-            }
-        }
+        num = snap->objects.at(objidx).size();
     }
-    // If this point is reached then the requested object could not be found
-    return -1;
+    endRead();
+    return num;
 }
@@ -35,6 +35,10 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QVector>
+#include <QHash>
+#include <QList>
+#include <QAtomicInt>
+#include <QAtomicPointer>
 
 class UAVOBJECTS_EXPORT UAVObjectManager: public QObject
 {
@@ -62,10 +66,35 @@ signals:
 private:
     static const quint32 MAX_INSTANCES = 1000;
 
-    QVector< QVector<UAVObject*> > objects;
+    /**
+     * Immutable view of the registered objects. Instances of an object type are
+     * kept dense, so the instance ID is also the index in its vector. The hashes
+     * map object IDs and names to the index of the type in objects.
+     */
+    struct Snapshot
+    {
+        QVector< QVector<UAVObject*> > objects;
+        QHash<quint32, int> idIndex;
+        QHash<QString, int> nameIndex;
+    };
+
+    // Readers only ever see a published snapshot and never take the mutex.
+    // Registration copies the snapshot, modifies the copy and swaps it in.
+    QAtomicPointer<Snapshot> current;
+    QAtomicInt readers;
+    QList<Snapshot*> retired;
+    QAtomicInt numRetired;
     QMutex* mutex;
 
+    const Snapshot* beginRead();
+    void endRead();
+    Snapshot* beginWrite();
+    void publish(Snapshot* next);
+    void reclaim();
+
     void addObject(UAVObject* obj);
+    void addInstance(int objidx, UAVObject* obj);
+    int findType(const Snapshot* snap, const QString* name, quint32 objId);
     UAVObject* getObject(const QString* name, quint32 objId, quint32 instId);
     QVector<UAVObject*> getObjectInstances(const QString* name, quint32 objId);
     qint32 getNumInstances(const QString* name, quint32 objId);
@@ -27,6 +27,7 @@
  */
 #include "uavobjectsplugin.h"
 #include "uavobjectsinit.h"
+#include "uavobjectupdatebus.h"
 
 UAVObjectsPlugin::UAVObjectsPlugin()
 {
@@ -50,6 +51,8 @@ bool UAVObjectsPlugin::initialize(const QStringList & arguments, QString * error
     addAutoReleasedObject(objMngr);
     // Initialize UAVObjects
     UAVObjectsInitialize(objMngr);
+    // Coalesced update notifications for the gadgets which opt in
+    addAutoReleasedObject(new UAVObjectUpdateBus());
     // Done
     Q_UNUSED(arguments);
     Q_UNUSED(errorString);
@@ -74,6 +74,9 @@ $(DATAFIELDINFO)
 
 $(PROPERTY_GETTERS)
 
+    // Typed accessors for packed object data, no locking or conversion
+$(PACKED_GETTERS)
+
 public slots:
 $(PROPERTY_SETTERS)
 
@@ -0,0 +1,310 @@
+/**
+ ******************************************************************************
+ *
+ * @file       uavobjectupdatebus.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief      Coalesced, rate limited object update notifications
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+#include "uavobjectupdatebus.h"
+
+/**
+ * Constructor. The bus delivers from the event loop of the thread it lives in,
+ * which should be the GUI thread.
+ */
+UAVObjectUpdateBus::UAVObjectUpdateBus(QObject *parent) :
+    QObject(parent),
+    mutex(QMutex::Recursive),
+    nextId(1)
+{
+    clock.start();
+    frameTimer.setInterval(FRAME_PERIOD_MS);
+    connect(&frameTimer, SIGNAL(timeout()), this, SLOT(deliver()));
+}
+
+UAVObjectUpdateBus::~UAVObjectUpdateBus()
+{
+    qDeleteAll(subscriptions);
+}
+
+/**
+ * Milliseconds since the bus was created, the time base of the sample timestamps
+ */
+qint64 UAVObjectUpdateBus::now() const
+{
+    return clock.elapsed();
+}
+
+/**
+ * Subscribe to the updates of an object instance. Must be called from the thread of the bus.
+ * \param[in] obj The object instance
+ * \param[in] receiver The object to call back, the subscription goes away with it
+ * \param[in] member Name of the slot to call, taking (UAVObject*, quint32 dropped)
+ * \param[in] maxRate Maximum callback rate in Hz, 0 to be called every frame there is an update
+ * \param[in] ringSize Number of samples to keep for takeSamples(), 0 for the latest value only
+ * \return The subscription ID or -1 on error
+ */
+int UAVObjectUpdateBus::subscribe(UAVObject* obj, QObject* receiver, const char* member, double maxRate, int ringSize)
+{
+    if (obj == NULL || receiver == NULL || member == NULL || ringSize < 0)
+    {
+        return -1;
+    }
+
+    Subscription* sub = new Subscription();
+    sub->obj = obj;
+    sub->receiverKey = receiver;
+    sub->receiver = receiver;
+    sub->member = member;
+    sub->minInterval = (maxRate > 0) ? (qint64)(1000.0 / maxRate) : 0;
+    sub->lastDelivery = now() - sub->minInterval;
+    sub->pending = 0;
+    sub->ring.resize(ringSize);
+    sub->head = 0;
+    sub->count = 0;
+    sub->overruns = 0;
+    sub->reportedOverruns = 0;
+
+    QMutexLocker locker(&mutex);
+    sub->id = nextId++;
+    if (!byObject.contains(obj))
+    {
+        // Direct, so that every update is seen from whichever thread it comes
+        connect(obj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(objectUpdated(UAVObject*)), Qt::DirectConnection);
+    }
+    byObject[obj].append(sub);
+    subscriptions.insert(sub->id, sub);
+    connect(receiver, SIGNAL(destroyed(QObject*)), this, SLOT(receiverDestroyed(QObject*)), Qt::UniqueConnection);
+
+    if (!frameTimer.isActive())
+    {
+        frameTimer.start();
+    }
+    return sub->id;
+}
+
+/**
+ * Remove a subscription
+ */
+void UAVObjectUpdateBus::unsubscribe(int id)
+{
+    QMutexLocker locker(&mutex);
+    Subscription* sub = subscriptions.value(id, NULL);
+    if (sub != NULL)
+    {
+        removeSubscription(sub);
+    }
+}
+
+/**
+ * Remove all the subscriptions of a receiver
+ */
+void UAVObjectUpdateBus::unsubscribe(QObject* receiver)
+{
+    QMutexLocker locker(&mutex);
+    foreach (Subscription* sub, subscriptions.values())
+    {
+        if (sub->receiverKey == receiver)
+        {
+            removeSubscription(sub);
+        }
+    }
+}
+
+void UAVObjectUpdateBus::receiverDestroyed(QObject* receiver)
+{
+    unsubscribe(receiver);
+}
+
+/**
+ * Helper to drop a subscription, called with the mutex held
+ */
+void UAVObjectUpdateBus::removeSubscription(Subscription* sub)
+{
+    subscriptions.remove(sub->id);
+    QHash<UAVObject*, QList<Subscription*> >::iterator it = byObject.find(sub->obj);
+    if (it != byObject.end())
+    {
+        it.value().removeAll(sub);
+        if (it.value().isEmpty())
+        {
+            disconnect(sub->obj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(objectUpdated(UAVObject*)));
+            byObject.erase(it);
+        }
+    }
+    delete sub;
+
+    if (subscriptions.isEmpty())
+    {
+        frameTimer.stop();
+    }
+}
+
+/**
+ * Move the samples buffered for a subscription into a vector, oldest first
+ * \param[in] id The subscription
+ * \param[out] samples The samples are appended to this vector
+ * \return The number of samples appended
+ */
+int UAVObjectUpdateBus::takeSamples(int id, QVector<UAVObjectSample>& samples)
+{
+    QMutexLocker locker(&mutex);
+    Subscription* sub = subscriptions.value(id, NULL);
+    if (sub == NULL)
+    {
+        return 0;
+    }
+    int taken = sub->count;
+    samples.reserve(samples.size() + taken);
+    for (int i = 0; i < taken; ++i)
+    {
+        UAVObjectSample& sample = sub->ring[(sub->head + i) % sub->ring.size()];
+        samples.append(sample);
+        sample.data = QByteArray();
+    }
+    sub->head = 0;
+    sub->count = 0;
+    return taken;
+}
+
+/**
+ * Total number of samples a subscription lost because its ring was full
+ */
+quint32 UAVObjectUpdateBus::getOverruns(int id)
+{
+    QMutexLocker locker(&mutex);
+    Subscription* sub = subscriptions.value(id, NULL);
+    return (sub != NULL) ? sub->overruns : 0;
+}
+
+/**
+ * Called on every update of a subscribed object, on the thread which updated it.
+ * Only counts the update and stores a sample for the ring subscribers, the
+ * callbacks are left to the next frame.
+ */
+void UAVObjectUpdateBus::objectUpdated(UAVObject* obj)
+{
+    bool wantSamples = false;
+    {
+        QMutexLocker locker(&mutex);
+        foreach (Subscription* sub, byObject.value(obj))
+        {
+            wantSamples |= !sub->ring.isEmpty();
+        }
+    }
+
+    // Pack without holding the bus mutex, this takes the object lock
+    QByteArray data;
+    if (wantSamples)
+    {
+        data.resize(obj->getNumBytes());
+        obj->pack((quint8*)data.data());
+    }
+    qint64 timestamp = now();
+
+    QMutexLocker locker(&mutex);
+    QHash<UAVObject*, QList<Subscription*> >::iterator it = byObject.find(obj);
+    if (it == byObject.end())
+    {
+        return;
+    }
+    foreach (Subscription* sub, it.value())
+    {
+        sub->pending++;
+        if (sub->ring.isEmpty() || data.isEmpty())
+        {
+            continue;
+        }
+        int size = sub->ring.size();
+        int slot = (sub->head + sub->count) % size;
+        if (sub->count == size)
+        {
+            // Full, the oldest sample makes room
+            sub->head = (sub->head + 1) % size;
+            sub->overruns++;
+        }
+        else
+        {
+            sub->count++;
+        }
+        sub->ring[slot].timestamp = timestamp;
+        sub->ring[slot].data = data;
+    }
+}
+
+/**
+ * Called every frame, runs the callbacks which are due
+ */
+void UAVObjectUpdateBus::deliver()
+{
+    QList<Callback> callbacks;
+    qint64 time = now();
+
+    {
+        QMutexLocker locker(&mutex);
+        foreach (Subscription* sub, subscriptions.values())
+        {
+            if (sub->receiver.isNull())
+            {
+                removeSubscription(sub);
+                continue;
+            }
+            if (sub->pending == 0 || (time - sub->lastDelivery) < sub->minInterval)
+            {
+                continue;
+            }
+            Callback callback;
+            callback.receiver = sub->receiver;
+            callback.member = sub->member;
+            callback.obj = sub->obj;
+            if (sub->ring.isEmpty())
+            {
+                // Updates folded into this callback
+                callback.dropped = sub->pending - 1;
+            }
+            else
+            {
+                // Samples lost from the ring since the last callback
+                callback.dropped = sub->overruns - sub->reportedOverruns;
+                sub->reportedOverruns = sub->overruns;
+            }
+            sub->pending = 0;
+            sub->lastDelivery = time;
+            callbacks.append(callback);
+        }
+    }
+
+    // Call back without the mutex, receivers are free to read the object or
+    // change their subscriptions
+    foreach (const Callback& callback, callbacks)
+    {
+        if (!callback.receiver.isNull())
+        {
+            QMetaObject::invokeMethod(callback.receiver, callback.member.constData(),
+                                      Q_ARG(UAVObject*, callback.obj), Q_ARG(quint32, callback.dropped));
+        }
+    }
+}
+
+/**
+ * @}
+ * @}
+ */
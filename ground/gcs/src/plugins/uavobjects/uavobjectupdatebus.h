@@ -0,0 +1,132 @@
+/**
+ ******************************************************************************
+ *
+ * @file       uavobjectupdatebus.h
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief      Coalesced, rate limited object update notifications
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef UAVOBJECTUPDATEBUS_H
+#define UAVOBJECTUPDATEBUS_H
+
+#include "uavobjects_global.h"
+#include "uavobject.h"
+#include <QObject>
+#include <QPointer>
+#include <QMutex>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QByteArray>
+#include <QTimer>
+#include <QElapsedTimer>
+
+/**
+ * One update of an object as received, in its packed form.
+ */
+struct UAVObjectSample
+{
+    qint64 timestamp; //!< Milliseconds on the bus clock, see UAVObjectUpdateBus::now()
+    QByteArray data;  //!< Object data as produced by UAVObject::pack()
+};
+
+/**
+ * Opt-in alternative to connecting to UAVObject::objectUpdated.
+ *
+ * A subscriber is called back on the GUI thread at most once per frame, and no
+ * faster than the rate it asked for, however often the object was updated in the
+ * meantime. The callback is told how many updates were folded into it. The object
+ * already holds the latest value when the callback runs.
+ *
+ * Subscribers that need every sample, like plots and loggers, ask for a ring
+ * buffer. Each update is then also copied into the ring of the subscriber, and
+ * the samples are pulled with takeSamples() from the callback.
+ *
+ * The member given to subscribe() is invoked as
+ *     void member(UAVObject* obj, quint32 dropped)
+ * and has to be a slot or Q_INVOKABLE. For a latest value subscriber dropped is
+ * the number of updates folded into the callback, for a ring subscriber it is the
+ * number of samples lost since the last callback because the ring was full.
+ */
+class UAVOBJECTS_EXPORT UAVObjectUpdateBus : public QObject
+{
+    Q_OBJECT
+
+public:
+    UAVObjectUpdateBus(QObject *parent = 0);
+    ~UAVObjectUpdateBus();
+
+    int subscribe(UAVObject* obj, QObject* receiver, const char* member, double maxRate, int ringSize = 0);
+    void unsubscribe(int id);
+    void unsubscribe(QObject* receiver);
+
+    int takeSamples(int id, QVector<UAVObjectSample>& samples);
+    quint32 getOverruns(int id);
+
+    qint64 now() const;
+
+private slots:
+    void objectUpdated(UAVObject* obj);
+    void deliver();
+    void receiverDestroyed(QObject* receiver);
+
+private:
+    static const int FRAME_PERIOD_MS = 16;
+
+    struct Subscription
+    {
+        int id;
+        UAVObject* obj;
+        QObject* receiverKey;
+        QPointer<QObject> receiver;
+        QByteArray member;
+        qint64 minInterval;
+        qint64 lastDelivery;
+        quint32 pending;
+        // Ring of samples, empty when the subscriber only wants the latest value
+        QVector<UAVObjectSample> ring;
+        int head;
+        int count;
+        quint32 overruns;
+        quint32 reportedOverruns;
+    };
+
+    struct Callback
+    {
+        QPointer<QObject> receiver;
+        QByteArray member;
+        UAVObject* obj;
+        quint32 dropped;
+    };
+
+    void removeSubscription(Subscription* sub);
+
+    // Guards the subscriptions, objects are updated from the telemetry thread
+    QMutex mutex;
+    QHash<int, Subscription*> subscriptions;
+    QHash<UAVObject*, QList<Subscription*> > byObject;
+    int nextId;
+    QTimer frameTimer;
+    QElapsedTimer clock;
+};
+
+#endif // UAVOBJECTUPDATEBUS_H
@@ -36,38 +36,6 @@
 #include <stdlib.h>
 #include <QDebug>
 
-/**
- * @brief The TransactionKey class A key for the QMap to track transactions
- */
-class TransactionKey {
-public:
-    TransactionKey(quint32 objId, quint32 instId, bool req) {
-        this->objId = objId;
-        this->instId = instId;
-        this->req = req;
-    }
-
-    TransactionKey(UAVObject *obj, bool req) {
-        this->objId = obj->getObjID();
-        this->instId = obj->getInstID();
-        this->req = req;
-    }
-
-    // See if this is an equivalent transaction key
-    bool operator==(const TransactionKey & rhs) const {
-        return (rhs.objId == objId && rhs.instId == instId && rhs.req == req);
-    }
-
-    bool operator<(const TransactionKey & rhs) const {
-        return objId < rhs.objId || (objId == rhs.objId && instId < rhs.instId) ||
-                (objId == rhs.objId && instId == rhs.instId && req != rhs.req);
-    }
-
-    quint32 objId;
-    quint32 instId;
-    bool req;
-};
-
 /**
  * Constructor
  */
@@ -93,6 +61,7 @@ Telemetry::Telemetry(UAVTalk* utalk, UAVObjectManager* objMngr)
     gcsStatsObj = GCSTelemetryStats::GetInstance(objMngr);
     // Setup and start the periodic timer
     timeToNextUpdateMs = 0;
+    queueSeq = 0;
     updateTimer = new QTimer(this);
     connect(updateTimer, SIGNAL(timeout()), this, SLOT(processPeriodicUpdates()));
     updateTimer->start(1000);
@@ -397,38 +366,37 @@ void Telemetry::processObjectTransaction(ObjectTransactionInfo *transInfo)
 
 /**
  * Process the event received from an object we are following. This method
- * only enqueues objects for later processing
+ * only enqueues objects for later processing. An event that is already
+ * waiting for the same object covers the new one, as the object data is
+ * only read when the event is processed.
  */
 void Telemetry::processObjectUpdates(UAVObject* obj, EventMask event, bool allInstances, bool priority)
 {
+    ObjectQueue &queue = priority ? objPriorityQueue : objQueue;
+    QPair<UAVObject*, int> key(obj, event);
+
     // Push event into queue
-    ObjectQueueInfo objInfo;
-    objInfo.obj = obj;
-    objInfo.event = event;
-    objInfo.allInstances = allInstances;
-    if (priority)
+    if ( !queue.pending.contains(key) )
     {
-        if ( objPriorityQueue.length() < MAX_QUEUE_SIZE )
+        if ( queue.length() < MAX_QUEUE_SIZE )
         {
-            objPriorityQueue.enqueue(objInfo);
-        }
-        else
-        {
-            ++txErrors;
-            obj->emitTransactionCompleted(false);
-            qxtLog->warning(tr("Telemetry: priority event queue is full, event lost (%1)").arg(obj->getName()));
-        }
-    }
-    else
-    {
-        if ( objQueue.length() < MAX_QUEUE_SIZE )
-        {
-            objQueue.enqueue(objInfo);
+            ObjectQueueInfo objInfo;
+            objInfo.obj = obj;
+            objInfo.event = event;
+            objInfo.allInstances = allInstances;
+            objInfo.seq = queueSeq++;
+            if ( needsTransaction(objInfo) )
+                queue.transactions.enqueue(objInfo);
+            else
+                queue.others.enqueue(objInfo);
+            queue.pending.insert(key);
         }
         else
         {
             ++txErrors;
             obj->emitTransactionCompleted(false);
+            if (priority)
+                qxtLog->warning(tr("Telemetry: priority event queue is full, event lost (%1)").arg(obj->getName()));
         }
     }
     // Process the transaction queue
@@ -436,27 +404,79 @@ void Telemetry::processObjectUpdates(UAVObject* obj, EventMask event, bool allIn
 }
 
 /**
- * Process events from the object queue.
+ * Process events from the object queue. Transactions are started until
+ * MAX_OUTSTANDING_TRANSACTIONS are waiting for a response, each of them is
+ * retried on its own timer so one lost packet does not hold up the others.
  */
 void Telemetry::processObjectQueue()
 {
     if (objQueue.length() > 1)
         qDebug() << "[telemetry.cpp] **************** Object Queue above 1 in backlog ****************";
-    // Get object information from queue (first the priority and then the regular queue)
+
     ObjectQueueInfo objInfo;
-    if ( !objPriorityQueue.isEmpty() )
+    while (dequeueObject(objInfo))
     {
-        objInfo = objPriorityQueue.dequeue();
+        processObjectQueueItem(objInfo);
     }
-    else if ( !objQueue.isEmpty() )
+}
+
+/**
+ * Get the next event to process, first from the priority and then from the regular
+ * queue. When the transaction window is full only events that do not start a
+ * transaction are taken, so that the unpack events completing outstanding
+ * requests are not stuck behind new requests.
+ * @return false if there is nothing that can be processed now
+ */
+bool Telemetry::dequeueObject(ObjectQueueInfo &objInfo)
+{
+    bool windowFull = transMap.size() >= MAX_OUTSTANDING_TRANSACTIONS;
+
+    ObjectQueue *queues[] = { &objPriorityQueue, &objQueue };
+    for (int q = 0; q < 2; ++q)
     {
-        objInfo = objQueue.dequeue();
+        ObjectQueue &queue = *queues[q];
+
+        // The oldest event, unless it would start a transaction that does not fit
+        QQueue<ObjectQueueInfo> *next = queue.others.isEmpty() ? NULL : &queue.others;
+        if ( !windowFull && !queue.transactions.isEmpty() &&
+             ( next == NULL || (qint32)(queue.transactions.head().seq - next->head().seq) < 0 ) )
+        {
+            next = &queue.transactions;
+        }
+
+        if (next != NULL)
+        {
+            objInfo = next->dequeue();
+            queue.pending.remove(QPair<UAVObject*, int>(objInfo.obj, objInfo.event));
+            return true;
+        }
     }
-    else
+    return false;
+}
+
+/**
+ * Check whether processing this event waits for a response from the remote end
+ */
+bool Telemetry::needsTransaction(const ObjectQueueInfo &objInfo)
+{
+    UAVObject::Metadata metadata = objInfo.obj->getMetadata();
+    if ( objInfo.event == EV_UPDATE_REQ )
+    {
+        return true;
+    }
+    if ( objInfo.event == EV_UNPACKED ||
+         ( objInfo.event == EV_UPDATED_PERIODIC && UAVObject::GetGcsTelemetryUpdateMode(metadata) == UAVObject::UPDATEMODE_THROTTLED ) )
     {
-        return;
+        return false;
     }
+    return UAVObject::GetGcsTelemetryAcked(metadata);
+}
 
+/**
+ * Process one event taken from the object queue.
+ */
+void Telemetry::processObjectQueueItem(const ObjectQueueInfo &objInfo)
+{
     // Check if a connection has been established, only process GCSTelemetryStats updates
     // (used to establish the connection)
     GCSTelemetryStats::DataFields gcsStats = gcsStatsObj->getData();
@@ -522,9 +542,6 @@ void Telemetry::processObjectQueue()
         if (transMap.contains(TransactionKey(objInfo.obj, true))) {
             qDebug() << "[telemetry.cpp] EV_UNPACKED " << objInfo.obj->getName() << QString(QString("0x") + QString::number(objInfo.obj->getObjID(), 16).toUpper()) << " Instance: " << objInfo.obj->getInstID();
             transactionRequestCompleted(objInfo.obj);
-        } else
-        {
-            processObjectQueue();
         }
     }
 }
@@ -38,10 +38,42 @@
 #include <QTimer>
 #include <QQueue>
 #include <QMap>
+#include <QSet>
+#include <QPair>
 
-class TransactionKey;
+/**
+ * @brief The TransactionKey class A key for the QMap to track transactions
+ */
+class TransactionKey {
+public:
+    TransactionKey(quint32 objId, quint32 instId, bool req) {
+        this->objId = objId;
+        this->instId = instId;
+        this->req = req;
+    }
+
+    TransactionKey(UAVObject *obj, bool req) {
+        this->objId = obj->getObjID();
+        this->instId = obj->getInstID();
+        this->req = req;
+    }
+
+    // See if this is an equivalent transaction key
+    bool operator==(const TransactionKey & rhs) const {
+        return (rhs.objId == objId && rhs.instId == instId && rhs.req == req);
+    }
+
+    bool operator<(const TransactionKey & rhs) const {
+        return objId < rhs.objId || (objId == rhs.objId && instId < rhs.instId) ||
+                (objId == rhs.objId && instId == rhs.instId && req < rhs.req);
+    }
+
+    quint32 objId;
+    quint32 instId;
+    bool req;
+};
 
-class ObjectTransactionInfo: public QObject {
+class UAVTALK_EXPORT ObjectTransactionInfo: public QObject {
     Q_OBJECT
 
 public:
@@ -58,7 +90,7 @@ private slots:
     void timeout();
 };
 
-class Telemetry: public QObject
+class UAVTALK_EXPORT Telemetry: public QObject
 {
     Q_OBJECT
 
@@ -81,6 +113,10 @@ public:
     void resetStats();
     void transactionTimeout(ObjectTransactionInfo *info);
 
+    // Limits of the transaction window and of each event queue
+    static const int MAX_QUEUE_SIZE = 20;
+    static const int MAX_OUTSTANDING_TRANSACTIONS = 8;
+
 signals:
 
 private:
@@ -89,7 +125,6 @@ private:
     static const int MAX_RETRIES = 2;
     static const int MAX_UPDATE_PERIOD_MS = 1000;
     static const int MIN_UPDATE_PERIOD_MS = 1;
-    static const int MAX_QUEUE_SIZE = 20;
 
     // Types
     /**
@@ -114,15 +149,31 @@ private:
         UAVObject* obj;
         EventMask event;
         bool allInstances;
+        quint32 seq;                /** Order in which the events were queued */
     } ObjectQueueInfo;
 
+    /**
+     * Events waiting to be processed. Events that start a transaction are kept
+     * apart so they can be held back while the transaction window is full, and
+     * an event that is already waiting for an object is not queued again.
+     */
+    struct ObjectQueue {
+        QQueue<ObjectQueueInfo> transactions;
+        QQueue<ObjectQueueInfo> others;
+        QSet< QPair<UAVObject*, int> > pending;
+
+        int length() const { return pending.size(); }
+        void clear() { transactions.clear(); others.clear(); pending.clear(); }
+    };
+
     // Variables
     UAVObjectManager* objMngr;
     UAVTalk* utalk;
     GCSTelemetryStats* gcsStatsObj;
     QVector<ObjectTimeInfo> objList;
-    QQueue<ObjectQueueInfo> objQueue;
-    QQueue<ObjectQueueInfo> objPriorityQueue;
+    ObjectQueue objQueue;
+    ObjectQueue objPriorityQueue;
+    quint32 queueSeq;
     QMap<TransactionKey, ObjectTransactionInfo*>transMap;
     QMutex* mutex;
     QTimer* updateTimer;
@@ -140,6 +191,9 @@ private:
     void processObjectUpdates(UAVObject* obj, EventMask event, bool allInstances, bool priority);
     void processObjectTransaction(ObjectTransactionInfo *transInfo);
     void processObjectQueue();
+    bool dequeueObject(ObjectQueueInfo &objInfo);
+    bool needsTransaction(const ObjectQueueInfo &objInfo);
+    void processObjectQueueItem(const ObjectQueueInfo &objInfo);
     bool updateTransactionMap(UAVObject* obj, bool request);
 
 
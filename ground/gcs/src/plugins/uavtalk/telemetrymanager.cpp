@@ -27,13 +27,16 @@
 
 #include "telemetrymanager.h"
 #include <extensionsystem/pluginmanager.h>
-#include <coreplugin/icore.h>
-#include <coreplugin/threadmanager.h>
 
 TelemetryManager::TelemetryManager() :
     autopilotConnected(false)
 {
-    moveToThread(Core::ICore::instance()->threadManager()->getRealTimeThread());
+    // The link gets a thread of its own. UAVTalk, Telemetry and the monitor are
+    // created from onStart() so they live there too and parse, unpack and answer
+    // the autopilot without waiting on the GUI or the other real time users.
+    telemetryThread = new QThread();
+    telemetryThread->start(QThread::TimeCriticalPriority);
+    moveToThread(telemetryThread);
     // Get UAVObjectManager instance
     ExtensionSystem::PluginManager* pm = ExtensionSystem::PluginManager::instance();
     objMngr = pm->getObject<UAVObjectManager>();
@@ -45,6 +48,9 @@ TelemetryManager::TelemetryManager() :
 
 TelemetryManager::~TelemetryManager()
 {
+    telemetryThread->quit();
+    telemetryThread->wait();
+    delete telemetryThread;
 }
 
 bool TelemetryManager::isConnected()
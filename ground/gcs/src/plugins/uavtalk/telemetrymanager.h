@@ -35,6 +35,7 @@
 #include "uavobjectmanager.h"
 #include <QIODevice>
 #include <QObject>
+#include <QThread>
 
 class UAVTALK_EXPORT TelemetryManager: public QObject
 {
@@ -66,6 +67,7 @@ private:
     Telemetry* telemetry;
     TelemetryMonitor* telemetryMon;
     QIODevice *device;
+    QThread *telemetryThread;
     bool autopilotConnected;
 };
 
@@ -200,6 +200,8 @@ void TelemetryMonitor::processStatsUpdates()
     gcsStats.RxFailures += telStats.rxErrors;
     gcsStats.TxFailures += telStats.txErrors;
     gcsStats.TxRetries += telStats.txRetries;
+    // The UAVTalk parser decodes delta frames, let the flight side send them
+    gcsStats.DeltaCompression = GCSTelemetryStats::DELTACOMPRESSION_TRUE;
 
     // Check for a connection timeout
     bool connectionTimeout;
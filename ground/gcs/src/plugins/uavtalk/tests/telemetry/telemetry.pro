@@ -0,0 +1,15 @@
+# -------------------------------------------------
+# Transaction keys, the outstanding transaction window and the
+# event queues of Telemetry, run against the generated objects.
+# -------------------------------------------------
+TEMPLATE = app
+TARGET = tst_telemetry
+CONFIG += qtestlib console
+CONFIG -= app_bundle
+
+include(../../../../../gcs.pri)
+LIBS += -L$$GCS_PLUGIN_PATH/TauLabs
+include(../../uavtalk.pri)
+INCLUDEPATH *= ../..
+
+SOURCES += tst_telemetry.cpp
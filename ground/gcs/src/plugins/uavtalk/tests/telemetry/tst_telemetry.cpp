@@ -0,0 +1,285 @@
+/**
+ ******************************************************************************
+ *
+ * @file       tst_telemetry.cpp
+ * @author     Tau Labs, http://taulabs.org, Copyright (C) 2014
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVTalkPlugin UAVTalk Plugin
+ * @{
+ * @brief      Tests the transaction window and event queues of Telemetry
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "uavobjectmanager.h"
+#include "uavobjectsinit.h"
+#include "gcstelemetrystats.h"
+#include "oplinksettings.h"
+#include "objectpersistence.h"
+#include "telemetry.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QtEndian>
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+// Packet types as they go out on the link
+#define TYPE_OBJ        0x20
+#define TYPE_OBJ_REQ    0x21
+#define TYPE_OBJ_ACK    0x22
+
+class tst_Telemetry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+    void transactionKeyOrdering();
+    void transactionKeyMap();
+    void windowLimitsRequests();
+    void heldRequestsDoNotBlockOtherEvents();
+    void duplicateEventsCoalesced();
+    void queueLimit();
+
+private:
+    typedef QPair<int, UAVObject*> Packet;
+
+    void fillWindow();
+    void answerRequest(UAVObject* obj);
+    QList<Packet> sentPackets();
+
+    UAVObjectManager* objMngr;
+    QBuffer* link;
+    qint64 linkReadPos;
+    UAVTalk* utalk;
+    Telemetry* telemetry;
+    QList<UAVObject*> objs;
+    UAVObject* ackedObj;
+    UAVObject* unackedObj;
+};
+
+void tst_Telemetry::initTestCase()
+{
+    objMngr = new UAVObjectManager();
+    UAVObjectsInitialize(objMngr);
+
+    // Data objects not involved in setting up the link
+    QVector< QVector<UAVObject*> > all = objMngr->getObjects();
+    for (int n = 0; n < all.size(); ++n)
+    {
+        UAVObject* obj = all[n][0];
+        quint32 id = obj->getObjID();
+        if (dynamic_cast<UAVDataObject*>(obj) != NULL && id != GCSTelemetryStats::OBJID &&
+                id != OPLinkSettings::OBJID && id != ObjectPersistence::OBJID)
+        {
+            objs.append(obj);
+        }
+    }
+    QVERIFY(objs.size() > Telemetry::MAX_OUTSTANDING_TRANSACTIONS + Telemetry::MAX_QUEUE_SIZE + 10);
+
+    ackedObj = objs[Telemetry::MAX_OUTSTANDING_TRANSACTIONS + 2];
+    unackedObj = objs[Telemetry::MAX_OUTSTANDING_TRANSACTIONS + 3];
+    UAVObject::Metadata metadata = ackedObj->getMetadata();
+    UAVObject::SetGcsTelemetryAcked(metadata, 1);
+    ackedObj->setMetadata(metadata);
+    metadata = unackedObj->getMetadata();
+    UAVObject::SetGcsTelemetryAcked(metadata, 0);
+    unackedObj->setMetadata(metadata);
+
+    // Only a connected link processes updates of regular objects
+    GCSTelemetryStats* gcsStats = GCSTelemetryStats::GetInstance(objMngr);
+    GCSTelemetryStats::DataFields stats = gcsStats->getData();
+    stats.Status = GCSTelemetryStats::STATUS_CONNECTED;
+    gcsStats->setData(stats);
+}
+
+void tst_Telemetry::cleanupTestCase()
+{
+    delete objMngr;
+}
+
+void tst_Telemetry::init()
+{
+    // The event loop is never run, so no timers fire and nothing is read back
+    link = new QBuffer();
+    link->open(QIODevice::ReadWrite);
+    linkReadPos = 0;
+    utalk = new UAVTalk(link, objMngr);
+    telemetry = new Telemetry(utalk, objMngr);
+}
+
+void tst_Telemetry::cleanup()
+{
+    delete telemetry;
+    delete utalk;
+    delete link;
+}
+
+/**
+ * Occupy every transaction slot with an outstanding object request
+ */
+void tst_Telemetry::fillWindow()
+{
+    for (int n = 0; n < Telemetry::MAX_OUTSTANDING_TRANSACTIONS; ++n)
+        objs[n]->requestUpdate();
+    QCOMPARE(sentPackets().size(), (int)Telemetry::MAX_OUTSTANDING_TRANSACTIONS);
+}
+
+/**
+ * Act as if the remote end had sent the requested object
+ */
+void tst_Telemetry::answerRequest(UAVObject* obj)
+{
+    QByteArray data(obj->getNumBytes(), 0);
+    obj->pack((quint8*)data.data());
+    obj->unpack((const quint8*)data.constData());
+}
+
+/**
+ * Parse the packets written to the link since the last call
+ * @return the type and object of every packet
+ */
+QList<tst_Telemetry::Packet> tst_Telemetry::sentPackets()
+{
+    QList<Packet> packets;
+    const QByteArray &data = link->data();
+    while (linkReadPos + 8 <= data.size() && (quint8)data[(int)linkReadPos] == 0x3C)
+    {
+        const uchar *header = (const uchar*)data.constData() + linkReadPos;
+        quint16 length = qFromLittleEndian<quint16>(header + 2);
+        quint32 objId = qFromLittleEndian<quint32>(header + 4);
+        packets.append(Packet(header[1], objMngr->getObject(objId)));
+        linkReadPos += length + 1;
+    }
+    return packets;
+}
+
+void tst_Telemetry::transactionKeyOrdering()
+{
+    QList<TransactionKey> keys;
+    keys << TransactionKey(1, 0, false) << TransactionKey(1, 0, true)
+         << TransactionKey(1, 1, false) << TransactionKey(1, 1, true)
+         << TransactionKey(2, 0, false) << TransactionKey(2, 0, true);
+
+    // Strict weak ordering: irreflexive, asymmetric and matching the list order
+    for (int i = 0; i < keys.size(); ++i)
+    {
+        QVERIFY(!(keys[i] < keys[i]));
+        QVERIFY(keys[i] == keys[i]);
+        for (int j = i + 1; j < keys.size(); ++j)
+        {
+            QVERIFY(keys[i] < keys[j]);
+            QVERIFY(!(keys[j] < keys[i]));
+            QVERIFY(!(keys[i] == keys[j]));
+        }
+    }
+}
+
+void tst_Telemetry::transactionKeyMap()
+{
+    // A request and an update of the same instance are separate transactions
+    QMap<TransactionKey, int> map;
+    map.insert(TransactionKey(objs[0], true), 1);
+    map.insert(TransactionKey(objs[0], false), 2);
+    map.insert(TransactionKey(objs[1], true), 3);
+    QCOMPARE(map.size(), 3);
+    QCOMPARE(map.value(TransactionKey(objs[0], true)), 1);
+    QCOMPARE(map.value(TransactionKey(objs[0], false)), 2);
+    QCOMPARE(map.value(TransactionKey(objs[1], true)), 3);
+    QVERIFY(!map.contains(TransactionKey(objs[1], false)));
+}
+
+void tst_Telemetry::windowLimitsRequests()
+{
+    UAVObject* requested = objs[Telemetry::MAX_OUTSTANDING_TRANSACTIONS];
+    QSignalSpy completed(objs[0], SIGNAL(transactionCompleted(UAVObject*,bool)));
+
+    // Requests beyond the window wait for an answer to an outstanding one
+    fillWindow();
+    requested->requestUpdate();
+    QVERIFY(sentPackets().isEmpty());
+
+    answerRequest(objs[0]);
+    QCOMPARE(completed.count(), 1);
+    QCOMPARE(completed[0][1].toBool(), true);
+    QCOMPARE(sentPackets(), QList<Packet>() << Packet(TYPE_OBJ_REQ, requested));
+}
+
+void tst_Telemetry::heldRequestsDoNotBlockOtherEvents()
+{
+    UAVObject* requested = objs[Telemetry::MAX_OUTSTANDING_TRANSACTIONS];
+
+    fillWindow();
+    requested->requestUpdate();
+    ackedObj->updated();
+
+    // With the window full only events without a response go out
+    unackedObj->updated();
+    QCOMPARE(sentPackets(), QList<Packet>() << Packet(TYPE_OBJ, unackedObj));
+
+    // Each freed slot lets one held event follow, in their original order
+    answerRequest(objs[0]);
+    QCOMPARE(sentPackets(), QList<Packet>() << Packet(TYPE_OBJ_REQ, requested));
+    answerRequest(objs[1]);
+    QCOMPARE(sentPackets(), QList<Packet>() << Packet(TYPE_OBJ_ACK, ackedObj));
+    answerRequest(objs[2]);
+    QVERIFY(sentPackets().isEmpty());
+}
+
+void tst_Telemetry::duplicateEventsCoalesced()
+{
+    UAVObject* requested = objs[Telemetry::MAX_OUTSTANDING_TRANSACTIONS];
+
+    // Repeated requests while one is waiting take a single queue entry
+    fillWindow();
+    for (int n = 0; n < Telemetry::MAX_QUEUE_SIZE + 5; ++n)
+        requested->requestUpdate();
+    QCOMPARE(telemetry->getStats().txErrors, (quint32)0);
+
+    answerRequest(objs[0]);
+    answerRequest(objs[1]);
+    QCOMPARE(sentPackets(), QList<Packet>() << Packet(TYPE_OBJ_REQ, requested));
+}
+
+void tst_Telemetry::queueLimit()
+{
+    const int first = Telemetry::MAX_OUTSTANDING_TRANSACTIONS + 4;
+    const int count = Telemetry::MAX_QUEUE_SIZE + 5;
+    QSignalSpy failed(objs[first + count - 1], SIGNAL(transactionCompleted(UAVObject*,bool)));
+
+    // Requests of different objects stay queued while the window is full,
+    // the excess is dropped and reported as failed
+    fillWindow();
+    for (int n = first; n < first + count; ++n)
+        objs[n]->requestUpdate();
+    QCOMPARE(telemetry->getStats().txErrors, (quint32)5);
+    QCOMPARE(failed.count(), 1);
+    QCOMPARE(failed[0][1].toBool(), false);
+
+    // The queued ones go out as the window drains
+    for (int n = 0; n < Telemetry::MAX_OUTSTANDING_TRANSACTIONS; ++n)
+        answerRequest(objs[n]);
+    QList<Packet> packets = sentPackets();
+    QCOMPARE(packets.size(), (int)Telemetry::MAX_OUTSTANDING_TRANSACTIONS);
+    QCOMPARE(packets[0], Packet(TYPE_OBJ_REQ, objs[first]));
+}
+
+QTEST_MAIN(tst_Telemetry)
+#include "tst_telemetry.moc"
@@ -76,7 +76,9 @@ UAVTalk::UAVTalk(QIODevice* iodev, UAVObjectManager* objMngr)
 
     memset(&stats, 0, sizeof(ComStats));
 
-    connect(io, SIGNAL(readyRead()), this, SLOT(processInputStream()));
+    // The device usually lives on the GUI thread while we live on the telemetry
+    // thread, onReadyRead() takes care of handing the reads over
+    connect(io, SIGNAL(readyRead()), this, SLOT(onReadyRead()), Qt::DirectConnection);
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     Core::Internal::GeneralSettings * settings=pm->getObject<Core::Internal::GeneralSettings>();
     useUDPMirror=settings->useUDPMirror();
@@ -119,21 +121,76 @@ UAVTalk::ComStats UAVTalk::getStats()
 }
 
 /**
- * Called each time there are data in the input buffer
+ * Called from the thread of the device each time there are data in the input buffer.
+ * When that is not our thread the read is queued to our thread, and further readyRead
+ * signals are coalesced into it until it runs.
+ */
+void UAVTalk::onReadyRead()
+{
+    if (QThread::currentThread() == thread())
+    {
+        processInputStream();
+    }
+    else if (readPending.testAndSetOrdered(0, 1))
+    {
+        QMetaObject::invokeMethod(this, "processInputStream", Qt::QueuedConnection);
+    }
+}
+
+/**
+ * Read and parse everything available in the input buffer
  */
 void UAVTalk::processInputStream()
 {
-    quint8 tmp;
+    quint8 buf[RX_CHUNK_SIZE];
+
+    // Clear the flag before reading, data arriving from now on needs another pass
+    readPending = 0;
 
     if (io && io->isReadable()) {
         while (io->bytesAvailable() > 0)
         {
-            io->read((char*)&tmp, 1);
-            processInputByte(tmp);
+            qint64 len = io->read((char*)buf, sizeof(buf));
+            if (len <= 0)
+            {
+                break;
+            }
+            processInputBuffer(buf, len);
         }
     }
 }
 
+/**
+ * Process a block of bytes from the telemetry stream. This has the same effect as
+ * feeding them one by one to processInputByte(), except that object payloads are
+ * copied and checksummed in one go.
+ * \param[in] data Received bytes
+ * \param[in] length Number of bytes
+ */
+void UAVTalk::processInputBuffer(const quint8* data, qint64 length)
+{
+    qint64 i = 0;
+    while (i < length)
+    {
+        if (rxState == STATE_DATA && rxCount + 1 < rxLength)
+        {
+            // Take all but the last payload byte in bulk, the last one goes through
+            // the state machine so that it moves on to the checksum
+            qint32 count = qMin<qint64>(rxLength - rxCount - 1, length - i);
+            rxCS = updateCRC(rxCS, &data[i], count);
+            memcpy(&rxBuffer[rxCount], &data[i], count);
+            if(useUDPMirror)
+                rxDataArray.append((const char*)&data[i], count);
+            stats.rxBytes += count;
+            rxPacketLength += count;
+            rxCount += count;
+            i += count;
+            continue;
+        }
+        processInputByte(data[i++]);
+    }
+}
+
 void UAVTalk::dummyUDPRead()
 {
     QUdpSocket *socket=qobject_cast<QUdpSocket*>(sender());
@@ -327,6 +384,19 @@ bool UAVTalk::processInputByte(quint8 rxbyte)
                 {
                     rxLength = 0;
                 }
+                else if (rxType == TYPE_OBJ_DELTA)
+                {
+                    // Delta frames are as long as the changes they carry
+                    qint32 deltaLength = packetSize - rxPacketLength - (rxObj->isSingleInstance() ? 0 : 2);
+                    if (deltaLength < 2)
+                    {
+                        stats.rxErrors++;
+                        rxState = STATE_SYNC;
+                        UAVTALK_QXTLOG_DEBUG("UAVTalk: ObjID->Sync (short delta)");
+                        break;
+                    }
+                    rxLength = deltaLength;
+                }
                 else
                 {
                     rxLength = rxObj->getNumBytes();
@@ -469,7 +539,7 @@ bool UAVTalk::processInputByte(quint8 rxbyte)
 
 /**
  * Receive an object. This function process objects received through the telemetry stream.
- * \param[in] type Type of received message (TYPE_OBJ, TYPE_OBJ_REQ, TYPE_OBJ_ACK, TYPE_ACK, TYPE_NACK)
+ * \param[in] type Type of received message (TYPE_OBJ, TYPE_OBJ_REQ, TYPE_OBJ_ACK, TYPE_ACK, TYPE_NACK, TYPE_OBJ_DELTA)
  * \param[in] obj Handle of the received object
  * \param[in] instId The instance ID of UAVOBJ_ALL_INSTANCES for all instances.
  * \param[in] data Data buffer
@@ -478,7 +548,6 @@ bool UAVTalk::processInputByte(quint8 rxbyte)
  */
 bool UAVTalk::receiveObject(quint8 type, quint32 objId, quint16 instId, quint8* data, qint32 length)
 {
-    Q_UNUSED(length);
     UAVObject* obj = NULL;
     bool error = false;
     bool allInstances =  (instId == ALL_INSTANCES);
@@ -496,6 +565,33 @@ bool UAVTalk::receiveObject(quint8 type, quint32 objId, quint16 instId, quint8*
                 qDebug() << "[uavtalk.cpp  ] Received a UAVObject update for a UAVObject we don't know about";
                 error = true;
             }
+            else
+            {
+                storeDeltaBase(objId, instId, data, length);
+            }
+        }
+        else
+        {
+            error = true;
+        }
+        break;
+    case TYPE_OBJ_DELTA: // We have received the changes to an object since the last update
+        // All instances, not allowed for delta messages
+        if (!allInstances)
+        {
+            obj = updateObjectDelta(objId, instId, data, length);
+            if (obj == NULL)
+            {
+                // Lost an earlier update, ask for the whole object once
+                quint64 key = ((quint64)objId << 16) | instId;
+                UAVObject *reqObj = objMngr->getObject(objId, instId);
+                if (reqObj != NULL && !deltaResyncs.contains(key))
+                {
+                    deltaResyncs.insert(key);
+                    transmitObject(reqObj, TYPE_OBJ_REQ, false);
+                }
+                error = true;
+            }
         }
         else
         {
@@ -511,6 +607,7 @@ bool UAVTalk::receiveObject(quint8 type, quint32 objId, quint16 instId, quint8*
             // Transmit ACK
             if ( obj != NULL )
             {
+               storeDeltaBase(objId, instId, data, length);
                transmitObject(obj, TYPE_ACK, false);
             }
             else
@@ -637,6 +734,65 @@ UAVObject* UAVTalk::updateObject(quint32 objId, quint16 instId, quint8* data)
     }
 }
 
+/**
+ * Keep a copy of the full data received for an object, delta frames
+ * for it are applied to this copy.
+ */
+void UAVTalk::storeDeltaBase(quint32 objId, quint16 instId, const quint8* data, qint32 length)
+{
+    if (length < DELTA_MIN_LENGTH)
+        return;
+
+    quint64 key = ((quint64)objId << 16) | instId;
+    deltaBases.insert(key, QByteArray((const char*)data, length));
+    deltaResyncs.remove(key);
+}
+
+/**
+ * Apply a delta frame to the last data received for an object and update
+ * the object with the result.  The frame starts with the CRC16 of the data
+ * it was encoded against, followed by runs of a count of unchanged bytes,
+ * a count of changed bytes and the changed bytes XORed with the old data.
+ * \return The updated object or NULL if there is no matching copy to apply the frame to
+ */
+UAVObject* UAVTalk::updateObjectDelta(quint32 objId, quint16 instId, const quint8* data, qint32 length)
+{
+    quint64 key = ((quint64)objId << 16) | instId;
+    QHash<quint64, QByteArray>::iterator it = deltaBases.find(key);
+    if (it == deltaBases.end() || length < 2)
+        return NULL;
+
+    QByteArray next = it.value();
+    quint8 *bytes = (quint8*)next.data();
+    qint32 size = next.size();
+
+    // Make sure both ends agree on what the changes apply to
+    if (updateCRC16(0, bytes, size) != qFromLittleEndian<quint16>(data))
+    {
+        deltaBases.erase(it);
+        return NULL;
+    }
+
+    qint32 pos = 0;
+    for (qint32 i = 2; i < length; )
+    {
+        if (i + 2 > length)
+            return NULL;
+        pos += data[i];
+        qint32 count = data[i + 1];
+        i += 2;
+        if (pos + count > size || i + count > length)
+            return NULL;
+        for (qint32 n = 0; n < count; ++n)
+            bytes[pos++] ^= data[i++];
+    }
+
+    UAVObject *obj = updateObject(objId, instId, bytes);
+    if (obj != NULL)
+        deltaBases.insert(key, next);
+    return obj;
+}
+
 
 /**
  * Send an object through the telemetry link.
@@ -859,3 +1015,22 @@ quint8 UAVTalk::updateCRC(quint8 crc, const quint8* data, qint32 length)
         crc = crc_table[crc ^ *data++];
     return crc;
 }
+
+/**
+ * Update a 16 bit crc with new data, the same reflected HDLC polynomial
+ * the flight side uses (PIOS_CRC16_updateCRC).
+ * \param crc      The current crc value.
+ * \param data     Pointer to a buffer of \a data_len bytes.
+ * \param length   Number of bytes in the \a data buffer.
+ * \return         The updated crc value.
+ */
+quint16 UAVTalk::updateCRC16(quint16 crc, const quint8* data, qint32 length)
+{
+    while (length--)
+    {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 1) ? ((crc >> 1) ^ 0x8408) : (crc >> 1);
+    }
+    return crc;
+}
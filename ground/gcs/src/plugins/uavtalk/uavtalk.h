@@ -33,6 +33,8 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QSemaphore>
 #include "uavobjectmanager.h"
 #include "uavtalk_global.h"
@@ -62,6 +64,7 @@ public:
     void resetStats();
 
     bool processInputByte(quint8 rxbyte);
+    void processInputBuffer(const quint8* data, qint64 length);
 
 signals:
     // The only signals we send to the upper level are when we
@@ -70,6 +73,7 @@ signals:
     void nackReceived(UAVObject* obj);
 
 private slots:
+    void onReadyRead();
     void processInputStream(void);
     void dummyUDPRead();
 
@@ -83,6 +87,7 @@ protected:
     static const int TYPE_OBJ_ACK = (TYPE_VER | 0x02);
     static const int TYPE_ACK = (TYPE_VER | 0x03);
     static const int TYPE_NACK = (TYPE_VER | 0x04);
+    static const int TYPE_OBJ_DELTA = (TYPE_VER | 0x05);
 
     static const int MIN_HEADER_LENGTH = 8; // sync(1), type (1), size(2), object ID(4)
     static const int MAX_HEADER_LENGTH = 10; // sync(1), type (1), size(2), object ID (4), instance ID(2, not used in single objects)
@@ -96,7 +101,10 @@ protected:
     static const quint16 ALL_INSTANCES = 0xFFFF;
     static const quint16 OBJID_NOTFOUND = 0x0000;
 
+    static const int DELTA_MIN_LENGTH = 32; // smallest object the flight side sends as a delta frame
+
     static const int TX_BUFFER_SIZE = 2*1024;
+    static const int RX_CHUNK_SIZE = 4*1024;
     static const quint8 crc_table[256];
 
     // Types
@@ -106,6 +114,9 @@ protected:
     QPointer<QIODevice> io;
     UAVObjectManager* objMngr;
     QMutex* mutex;
+    // Set while a read of the device is queued on this thread, so that a burst of
+    // readyRead signals from the device thread results in a single read
+    QAtomicInt readPending;
     quint8 rxBuffer[MAX_PACKET_LENGTH];
     quint8 txBuffer[MAX_PACKET_LENGTH];
     // Variables used by the receive state machine
@@ -127,10 +138,17 @@ protected:
     QUdpSocket * udpSocketRx;
     QByteArray rxDataArray;
 
+    // Last full data received for each object instance, the base delta frames apply to
+    QHash<quint64, QByteArray> deltaBases;
+    QSet<quint64> deltaResyncs;
+
     // Methods
     bool objectTransaction(UAVObject* obj, quint8 type, bool allInstances);
     virtual bool receiveObject(quint8 type, quint32 objId, quint16 instId, quint8* data, qint32 length);
     UAVObject* updateObject(quint32 objId, quint16 instId, quint8* data);
+    void storeDeltaBase(quint32 objId, quint16 instId, const quint8* data, qint32 length);
+    UAVObject* updateObjectDelta(quint32 objId, quint16 instId, const quint8* data, qint32 length);
+    quint16 updateCRC16(quint16 crc, const quint8* data, qint32 length);
     bool transmitNack(quint32 objId);
     bool transmitObject(UAVObject* obj, quint8 type, bool allInstances);
     bool transmitSingleObject(UAVObject* obj, quint8 type, bool allInstances);
@@ -239,6 +239,27 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo* info)
     outCode.replace(QString("$(PROPERTIES_IMPL)"), propertiesImpl);
     outCode.replace(QString("$(NOTIFY_PROPERTIES_CHANGED)"), propertyNotificationsImpl);
 
+    // Replace the $(PACKED_GETTERS) tag, these read a field straight out of
+    // packed object data (e.g. samples kept by the UAVObjectUpdateBus)
+    QString packedGetters;
+    for (int n = 0; n < info->fields.length(); ++n)
+    {
+        FieldInfo *field = info->fields[n];
+        type = fieldTypeStrCPP[field->type];
+        if ( field->numElements > 1 ) {
+            packedGetters +=
+                    QString("    static %1 unpack%2(const quint8* packed, quint32 index) "
+                            "{ return UAVObjectField::unpackElement<%1>(&packed[%3_OFFSET], index); }\n")
+                    .arg(type).arg(field->name).arg(field->name.toUpper());
+        } else {
+            packedGetters +=
+                    QString("    static %1 unpack%2(const quint8* packed) "
+                            "{ return UAVObjectField::unpackElement<%1>(&packed[%3_OFFSET], 0); }\n")
+                    .arg(type).arg(field->name).arg(field->name.toUpper());
+        }
+    }
+    outInclude.replace(QString("$(PACKED_GETTERS)"), packedGetters);
+
     // Replace the $(FIELDSINIT) tag
     QString finit;
     for (int n = 0; n < info->fields.length(); ++n)
@@ -288,6 +309,8 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo* info)
     QString enums;
     // To be populated with the Q_ENUMS macro
     QString q_enums;
+    // Byte offset of each field in the packed object
+    int fieldOffset = 0;
     for (int n = 0; n < info->fields.length(); ++n)
     {
         if(!info->fields[n]->name.isEmpty())
@@ -336,6 +359,11 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo* info)
                           .arg( info->fields[n]->name.toUpper() )
                           .arg( info->fields[n]->numElements ) );
         }
+        enums.append(QString("    /* Byte offset of field %1 in the packed object */\n").arg(info->fields[n]->name));
+        enums.append( QString("    static const quint32 %1_OFFSET = %2;\n")
+                      .arg( info->fields[n]->name.toUpper() )
+                      .arg( fieldOffset ) );
+        fieldOffset += info->fields[n]->numBytes * info->fields[n]->numElements;
     }
     outInclude.replace(QString("$(DATAFIELDINFO)"), enums);
     outInclude.replace(QString("$(ENUMS)"),q_enums);
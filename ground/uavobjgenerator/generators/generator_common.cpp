@@ -70,6 +70,8 @@ void replaceCommonTags(QString& out, ObjectInfo* info)
     // Replace $(ISSINGLEINST) tag
     out.replace(QString("$(ISSINGLEINST)"), boolTo01String( info->isSingleInst ));
     out.replace(QString("$(ISSINGLEINSTTF)"), boolToTRUEFALSEString( info->isSingleInst ));
+    // Replace $(NUMINSTANCES) tag
+    out.replace(QString("$(NUMINSTANCES)"), QString().setNum(info->numInstances));
     // Replace $(ISSETTINGS) tag
     out.replace(QString("$(ISSETTINGS)"), boolTo01String( info->isSettings ));
     out.replace(QString("$(ISSETTINGSTF)"), boolToTRUEFALSEString( info->isSettings ));    
@@ -593,6 +593,20 @@ QString UAVObjectParser::processObjectAttributes(QDomNode& node, ObjectInfo* inf
     else
         return QString("Object:singleinstance attribute value is invalid");
 
+    // Get numinstances attribute if present. This is only a storage hint
+    // and does not affect the object ID.
+    info->numInstances = 1;
+    attr = attributes.namedItem("numinstances");
+    if ( !attr.isNull() )
+    {
+        bool ok;
+        info->numInstances = attr.nodeValue().toInt(&ok);
+        if ( !ok || info->numInstances < 1 )
+            return QString("Object:numinstances attribute value is invalid");
+        if ( info->isSingleInst && info->numInstances != 1 )
+            return QString("Object: Single instance objects can not have multiple instances");
+    }
+
     // Get settings attribute
     attr = attributes.namedItem("settings");
     if ( attr.isNull() )
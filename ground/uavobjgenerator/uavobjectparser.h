@@ -83,6 +83,7 @@ typedef struct  {
     QString filename;
     quint32 id;
     bool isSingleInst;
+    int numInstances; /** Number of instances to allocate storage for up front (multi instance objects only) **/
     bool isSettings;
     AccessMode gcsAccess;
     AccessMode flightAccess;